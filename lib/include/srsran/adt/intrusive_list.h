@@ -108,6 +108,23 @@ public:
     node        = node->next_node;
     return static_cast<T*>(ret);
   }
+  /// Inserts "t" after the node "pos", which must be part of the list
+  void insert_after(T* pos, T* t)
+  {
+    node_t* prev        = static_cast<node_t*>(pos);
+    node_t* new_node    = static_cast<node_t*>(t);
+    new_node->next_node = prev->next_node;
+    prev->next_node     = new_node;
+  }
+  /// Removes the node following "pos" from the list and returns it. "pos" must not be the last node
+  T* pop_after(T* pos)
+  {
+    node_t* prev    = static_cast<node_t*>(pos);
+    node_t* ret     = prev->next_node;
+    prev->next_node = ret->next_node;
+    ret->next_node  = nullptr;
+    return static_cast<T*>(ret);
+  }
   void clear()
   {
     while (node != nullptr) {
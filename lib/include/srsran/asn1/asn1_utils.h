@@ -22,6 +22,7 @@
 #ifndef SRSASN_COMMON_UTILS_H
 #define SRSASN_COMMON_UTILS_H
 
+#include "srsran/adt/pool/linear_allocator.h"
 #include "srsran/common/srsran_assert.h"
 #include "srsran/srslog/srslog.h"
 #include <algorithm>
@@ -186,6 +187,90 @@ public:
   SRSASN_CODE align_bytes_zero();
 };
 
+/*********************
+     arena memory
+*********************/
+
+/// Arena of the dyn_array and copy_ptr objects allocated by the calling thread, nullptr if they use the heap
+srsran::linear_allocator* get_arena();
+
+/**
+ * Sets a linear allocator as the memory source of the dyn_array, dyn_octstring and copy_ptr objects allocated by the
+ * calling thread until the scope ends, e.g. while unpacking one message. Allocations that do not fit in the arena fall
+ * back to the heap. The memory block of the allocator must outlive the objects allocated within the scope.
+ */
+class arena_scope
+{
+public:
+  explicit arena_scope(srsran::linear_allocator& arena);
+  arena_scope(const arena_scope&) = delete;
+  arena_scope& operator=(const arena_scope&) = delete;
+  ~arena_scope();
+
+private:
+  srsran::linear_allocator* prev_arena;
+};
+
+namespace detail {
+
+/// Creates an array of n default-initialized objects. arena is set to the allocator used, or nullptr for the heap
+template <class T>
+T* new_array(uint32_t n, srsran::linear_allocator*& arena)
+{
+  arena = get_arena();
+  if (arena != nullptr) {
+    T* data = static_cast<T*>(arena->allocate(n * sizeof(T), alignof(T)));
+    if (data != nullptr) {
+      for (uint32_t i = 0; i < n; ++i) {
+        new (&data[i]) T;
+      }
+      return data;
+    }
+    arena = nullptr;
+  }
+  return new T[n];
+}
+
+template <class T>
+void delete_array(T* data, uint32_t n, srsran::linear_allocator* arena)
+{
+  if (arena == nullptr) {
+    delete[] data;
+    return;
+  }
+  // Arena memory is reclaimed by its owner
+  for (uint32_t i = 0; i < n; ++i) {
+    data[i].~T();
+  }
+}
+
+/// Creates an object. arena is set to the allocator used, or nullptr for the heap
+template <class T, class... Args>
+T* new_object(srsran::linear_allocator*& arena, Args&&... args)
+{
+  arena = get_arena();
+  if (arena != nullptr) {
+    void* mem = arena->allocate(sizeof(T), alignof(T));
+    if (mem != nullptr) {
+      return new (mem) T(std::forward<Args>(args)...);
+    }
+    arena = nullptr;
+  }
+  return new T(std::forward<Args>(args)...);
+}
+
+template <class T>
+void delete_object(T* obj, srsran::linear_allocator* arena)
+{
+  if (arena == nullptr) {
+    delete obj;
+    return;
+  }
+  obj->~T();
+}
+
+} // namespace detail
+
 /*********************
   function helpers
 *********************/
@@ -198,19 +283,22 @@ public:
   using const_iterator = const T*;
 
   dyn_array() = default;
-  explicit dyn_array(uint32_t new_size) : size_(new_size), cap_(new_size) { data_ = new T[size_]; }
+  explicit dyn_array(uint32_t new_size) : size_(new_size), cap_(new_size)
+  {
+    data_ = detail::new_array<T>(size_, arena_);
+  }
   dyn_array(const dyn_array<T>& other) : dyn_array(&other[0], other.size_) {}
   dyn_array(const T* ptr, uint32_t nof_items)
   {
     size_ = nof_items;
     cap_  = nof_items;
-    data_ = new T[cap_];
+    data_ = detail::new_array<T>(cap_, arena_);
     std::copy(ptr, ptr + size_, data_);
   }
   ~dyn_array()
   {
     if (data_ != NULL) {
-      delete[] data_;
+      detail::delete_array(data_, cap_, arena_);
     }
   }
   uint32_t      size() const { return size_; }
@@ -235,19 +323,22 @@ public:
       size_ = new_size;
       return;
     }
-    T* old_data = data_;
-    cap_        = new_size > new_cap ? new_size : new_cap;
+    T*                        old_data  = data_;
+    uint32_t                  old_cap   = cap_;
+    srsran::linear_allocator* old_arena = arena_;
+    cap_                                = new_size > new_cap ? new_size : new_cap;
     if (cap_ > 0) {
-      data_ = new T[cap_];
+      data_ = detail::new_array<T>(cap_, arena_);
       if (old_data != NULL) {
         std::copy(&old_data[0], &old_data[size_], data_);
       }
     } else {
-      data_ = NULL;
+      data_  = NULL;
+      arena_ = nullptr;
     }
     size_ = new_size;
     if (old_data != NULL) {
-      delete[] old_data;
+      detail::delete_array(old_data, old_cap, old_arena);
     }
   }
   iterator erase(iterator it)
@@ -282,9 +373,10 @@ public:
   const_iterator end() const { return &data_[size()]; }
 
 private:
-  T*       data_ = nullptr;
-  uint32_t size_ = 0;
-  uint32_t cap_  = 0;
+  T*                        data_  = nullptr;
+  uint32_t                  size_  = 0;
+  uint32_t                  cap_   = 0;
+  srsran::linear_allocator* arena_ = nullptr;
 };
 
 template <class T, uint32_t MAX_N>
@@ -1148,21 +1240,29 @@ class copy_ptr
 public:
   copy_ptr() : ptr(nullptr) {}
   explicit copy_ptr(T* ptr_) : ptr(ptr_) {}
-  copy_ptr(copy_ptr<T>&& other) noexcept : ptr(other.ptr) { other.ptr = nullptr; }
-  copy_ptr(const copy_ptr<T>& other) { ptr = (other.ptr == nullptr) ? nullptr : new T(*other.ptr); }
+  copy_ptr(copy_ptr<T>&& other) noexcept { steal_(other); }
+  copy_ptr(const copy_ptr<T>& other)
+  {
+    if (other.ptr != nullptr) {
+      ptr = detail::new_object<T>(arena, *other.ptr);
+    }
+  }
   ~copy_ptr() { destroy_(); }
   copy_ptr<T>& operator=(const copy_ptr<T>& other)
   {
     if (this != &other) {
-      reset((other.ptr == nullptr) ? nullptr : new T(*other.ptr));
+      reset();
+      if (other.ptr != nullptr) {
+        ptr = detail::new_object<T>(arena, *other.ptr);
+      }
     }
     return *this;
   }
   copy_ptr<T>& operator=(copy_ptr<T>&& other) noexcept
   {
     if (this != &other) {
-      ptr       = other.ptr;
-      other.ptr = nullptr;
+      reset();
+      steal_(other);
     }
     return *this;
   }
@@ -1176,20 +1276,26 @@ public:
   T*       release()
   {
     T* ret = ptr;
-    ptr    = nullptr;
+    if (arena != nullptr) {
+      // The caller takes ownership of a heap object
+      ret = new T(std::move(*ptr));
+      destroy_();
+    }
+    ptr   = nullptr;
+    arena = nullptr;
     return ret;
   }
   void reset(T* ptr_ = nullptr)
   {
     destroy_();
-    ptr = ptr_;
+    ptr   = ptr_;
+    arena = nullptr;
   }
   void set_present(bool flag = true)
   {
+    reset();
     if (flag) {
-      reset(new T());
-    } else {
-      reset();
+      ptr = detail::new_object<T>(arena);
     }
   }
   bool is_present() const { return get() != nullptr; }
@@ -1198,10 +1304,24 @@ private:
   void destroy_()
   {
     if (ptr != NULL) {
-      delete ptr;
+      detail::delete_object(ptr, arena);
+    }
+  }
+  void steal_(copy_ptr<T>& other)
+  {
+    // Objects of another arena are not taken over, as it may be released before this pointer
+    if (other.ptr == nullptr or other.arena == nullptr or other.arena == get_arena()) {
+      ptr   = other.ptr;
+      arena = other.arena;
+    } else {
+      ptr = detail::new_object<T>(arena, std::move(*other.ptr));
+      other.destroy_();
     }
+    other.ptr   = nullptr;
+    other.arena = nullptr;
   }
-  T* ptr;
+  T*                        ptr   = nullptr;
+  srsran::linear_allocator* arena = nullptr;
 };
 
 template <class T>
@@ -337,6 +337,38 @@ liblte_security_milenage_f2345(uint8* k, uint8* op, uint8* rand, uint8* res, uin
 // Functions
 LIBLTE_ERROR_ENUM liblte_security_milenage_f5_star(uint8* k, uint8* op, uint8* rand, uint8* ak);
 
+/*********************************************************************
+    Name: liblte_security_milenage_batch
+
+    Description: Milenage security functions F1, F2, F3, F4 and F5
+                 for a batch of authentication vectors. Each vector
+                 may use a different key K and OPc. The AES blocks
+                 of several vectors are interleaved, using AES-NI
+                 when available.
+
+    Document Reference: 35.206 v10.0.0 Annex 3
+*********************************************************************/
+// Defines
+#define LIBLTE_SECURITY_MILENAGE_BATCH_SIZE 4
+// Enums
+// Structs
+typedef struct {
+  // Inputs
+  const uint8* k;
+  const uint8* op_c;
+  uint8        rand[16];
+  uint8        sqn[6];
+  uint8        amf[2];
+  // Outputs
+  uint8 mac_a[8];
+  uint8 res[8];
+  uint8 ck[16];
+  uint8 ik[16];
+  uint8 ak[6];
+} LIBLTE_SECURITY_MILENAGE_VECTOR_STRUCT;
+// Functions
+LIBLTE_ERROR_ENUM liblte_security_milenage_batch(LIBLTE_SECURITY_MILENAGE_VECTOR_STRUCT* vectors, uint32 nof_vectors);
+
 LIBLTE_ERROR_ENUM liblte_security_generate_k_nr_rrc(uint8*                                      k_gnb,
                                                     LIBLTE_SECURITY_CIPHERING_ALGORITHM_ID_ENUM enc_alg_id,
                                                     LIBLTE_SECURITY_INTEGRITY_ALGORITHM_ID_ENUM int_alg_id,
@@ -102,6 +102,10 @@ protected:
   virtual void write_pdu(pcap_pdu_t& pdu) = 0;
   void         run_thread() final;
 
+  // Called from the PHY worker context with the context filled in. By default the payload is copied into a byte
+  // buffer and queued for the writer thread.
+  virtual void queue_pdu(pcap_pdu_t& pdu, const uint8_t* payload, uint32_t payload_len);
+
   std::mutex                             mutex;
   srslog::basic_logger&                  logger;
   bool                                   running = false;
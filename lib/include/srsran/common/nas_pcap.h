@@ -23,6 +23,7 @@
 #define SRSRAN_NAS_PCAP_H
 
 #include "srsran/common/pcap.h"
+#include "srsran/common/pcap_writer.h"
 #include <string>
 
 namespace srsran {
@@ -30,21 +31,20 @@ namespace srsran {
 class nas_pcap
 {
 public:
-  nas_pcap()
+  nas_pcap() : writer("PCAP_WRITER_NAS")
   {
     enable_write = false;
     ue_id        = 0;
-    pcap_file    = NULL;
   }
   void enable();
-  uint32_t open(std::string filename_, uint32_t ue_id = 0);
+  uint32_t open(std::string filename_, uint32_t ue_id = 0, uint64_t rotate_bytes = 0);
   void close();
   void write_nas(uint8_t* pdu, uint32_t pdu_len_bytes);
 
 private:
   bool        enable_write;
   std::string filename;
-  FILE*       pcap_file;
+  pcap_writer writer;
   uint32_t    ue_id;
   void        pack_and_write(uint8_t* pdu, uint32_t pdu_len_bytes);
 };
@@ -173,6 +173,10 @@ private:
 using sctp_recv_callback_t =
     srsran::move_callback<void(srsran::unique_byte_buffer_t, const sockaddr_in&, const sctp_sndrcvinfo&, int)>;
 
+/// Function signature for the processing of SDU byte buffers received from SCTP socket that returns the deferred task
+using sctp_recv_preprocess_callback_t = srsran::move_callback<
+    srsran::move_task_t(srsran::unique_byte_buffer_t, const sockaddr_in&, const sctp_sndrcvinfo&, int)>;
+
 /// Function signature for SDU byte buffers received from any sockaddr_in-based socket
 using recvfrom_callback_t = srsran::move_callback<void(srsran::unique_byte_buffer_t, const sockaddr_in&)>;
 
@@ -190,6 +194,14 @@ using recvfrom_callback_t = srsran::move_callback<void(srsran::unique_byte_buffe
 socket_manager_itf::recv_callback_t
 make_sctp_sdu_handler(srslog::basic_logger& logger, srsran::task_queue_handle& queue, sctp_recv_callback_t rx_callback);
 
+/**
+ * Similar to make_sctp_sdu_handler, but rx_callback is called from the socket thread, e.g. to unpack the SDU, and the
+ * task it returns is the one dispatched into the "queue"
+ */
+socket_manager_itf::recv_callback_t make_sctp_sdu_preprocess_handler(srslog::basic_logger&           logger,
+                                                                     srsran::task_queue_handle&      queue,
+                                                                     sctp_recv_preprocess_callback_t rx_callback);
+
 /**
  * Similar to make_sctp_sdu_handler, but for any sockaddr_in-based socket type
  */
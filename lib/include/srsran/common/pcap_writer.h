@@ -0,0 +1,103 @@
+/**
+ * Copyright 2013-2021 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#ifndef SRSRAN_PCAP_WRITER_H
+#define SRSRAN_PCAP_WRITER_H
+
+#include "srsran/common/pcap.h"
+#include "srsran/common/threads.h"
+#include <atomic>
+#include <memory>
+#include <string>
+
+struct iovec;
+
+namespace srsran {
+
+/**
+ * Asynchronous PCAP file writer shared by the MAC, RLC, NAS and S1AP captures.
+ *
+ * Packets are serialized by the calling thread into a large multi-producer ring, reserving space with a single
+ * compare-and-swap, so writing never blocks or allocates. A writer thread drains the ring in batches with writev(),
+ * pointing straight at the queued records. When the ring is full packets are dropped and counted.
+ */
+class pcap_writer : protected srsran::thread
+{
+public:
+  static const uint32_t default_queue_size = 1U << 24U;
+
+  explicit pcap_writer(const std::string& thread_name = "PCAP_WRITER", uint32_t queue_size = default_queue_size);
+  ~pcap_writer();
+
+  /// Creates the file and starts the writer. With rotate_bytes > 0 the capture continues in filename.1, filename.2, ...
+  /// whenever the current file grows beyond rotate_bytes.
+  bool open(const std::string& filename, uint32_t dlt, uint64_t rotate_bytes = 0);
+
+  /// Writes all the queued packets and closes the file
+  void close();
+
+  bool is_open() const { return running.load(std::memory_order_relaxed); }
+
+  /// Queues a packet made of a header followed by a payload, timestamped now. Thread-safe and lock-free.
+  bool write(const uint8_t* header, uint32_t header_len, const uint8_t* payload, uint32_t payload_len);
+
+  const std::string& get_filename() const { return filename; }
+  uint64_t           get_nof_written() const { return nof_written.load(std::memory_order_relaxed); }
+  uint64_t           get_nof_dropped() const { return nof_dropped.load(std::memory_order_relaxed); }
+  uint32_t           get_nof_files() const { return file_idx + 1; }
+
+private:
+  // Ring record: state, length, then the PCAP record header, header and payload, padded to 8 bytes
+  struct record_t {
+    std::atomic<uint32_t> state;
+    uint32_t              len;
+  };
+  enum : uint32_t { record_empty = 0, record_ready, record_padding };
+
+  void run_thread() override;
+  bool open_file();
+  void close_file();
+  bool write_batch();
+  void write_records(struct iovec* iov, uint32_t nof_iov);
+
+  uint8_t* ring_at(uint64_t pos) { return reinterpret_cast<uint8_t*>(ring.get()) + (pos & (ring_size - 1)); }
+
+  const uint32_t              ring_size;
+  std::unique_ptr<uint64_t[]> ring;
+  std::atomic<uint64_t>       write_pos{0}; // Reserved by producers
+  std::atomic<uint64_t>       read_pos{0};  // Released by the writer thread
+
+  std::atomic<bool>     running{false};
+  std::atomic<uint64_t> nof_written{0};
+  std::atomic<uint64_t> nof_dropped{0};
+
+  // Writer thread only
+  std::string filename;
+  uint32_t    dlt          = 0;
+  uint64_t    rotate_bytes = 0;
+  uint32_t    file_idx     = 0;
+  uint64_t    file_bytes   = 0;
+  int         fd           = -1;
+};
+
+} // namespace srsran
+
+#endif // SRSRAN_PCAP_WRITER_H
@@ -23,6 +23,7 @@
 #define RLCPCAP_H
 
 #include "srsran/common/pcap.h"
+#include "srsran/common/pcap_writer.h"
 #include "srsran/interfaces/rlc_interface_types.h"
 #include <stdint.h>
 
@@ -31,7 +32,7 @@ namespace srsran {
 class rlc_pcap
 {
 public:
-  rlc_pcap() {}
+  rlc_pcap() : writer("PCAP_WRITER_RLC") {}
   void enable(bool en);
   void open(const char* filename, rlc_config_t config);
   void close();
@@ -42,20 +43,20 @@ public:
   void write_ul_ccch(uint8_t* pdu, uint32_t pdu_len_bytes);
 
 private:
-  bool     enable_write = false;
-  FILE*    pcap_file    = nullptr;
-  uint32_t ue_id        = 0;
-  uint8_t  mode         = 0;
-  uint8_t  sn_length    = 0;
-  void     pack_and_write(uint8_t* pdu,
-                          uint32_t pdu_len_bytes,
-                          uint8_t  mode,
-                          uint8_t  direction,
-                          uint8_t  priority,
-                          uint8_t  seqnumberlength,
-                          uint16_t ueid,
-                          uint16_t channel_type,
-                          uint16_t channel_id);
+  bool        enable_write = false;
+  pcap_writer writer;
+  uint32_t    ue_id     = 0;
+  uint8_t     mode      = 0;
+  uint8_t     sn_length = 0;
+  void        pack_and_write(uint8_t* pdu,
+                             uint32_t pdu_len_bytes,
+                             uint8_t  mode,
+                             uint8_t  direction,
+                             uint8_t  priority,
+                             uint8_t  seqnumberlength,
+                             uint16_t ueid,
+                             uint16_t channel_type,
+                             uint16_t channel_id);
 };
 
 } // namespace srsran
@@ -23,25 +23,22 @@
 #define SRSRAN_S1AP_PCAP_H
 
 #include "srsran/common/pcap.h"
+#include "srsran/common/pcap_writer.h"
 
 namespace srsran {
 
 class s1ap_pcap
 {
 public:
-  s1ap_pcap()
-  {
-    enable_write = false;
-    pcap_file    = NULL;
-  }
+  s1ap_pcap() : writer("PCAP_WRITER_S1AP") { enable_write = false; }
   void enable();
-  void open(const char* filename);
+  void open(const char* filename, uint64_t rotate_bytes = 0);
   void close();
   void write_s1ap(uint8_t* pdu, uint32_t pdu_len_bytes);
 
 private:
-  bool  enable_write;
-  FILE* pcap_file;
+  bool        enable_write;
+  pcap_writer writer;
 };
 
 } // namespace srsran
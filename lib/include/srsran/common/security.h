@@ -27,6 +27,7 @@
  *****************************************************************************/
 
 #include "srsran/common/common.h"
+#include "srsran/common/liblte_security.h"
 
 namespace srsran {
 
@@ -201,5 +202,10 @@ security_milenage_f2345(uint8_t* k, uint8_t* op, uint8_t* rand, uint8_t* res, ui
 
 uint8_t security_milenage_f5_star(uint8_t* k, uint8_t* op, uint8_t* rand, uint8_t* ak);
 
+// F1-F5 of several authentication vectors at once, see liblte_security_milenage_batch()
+typedef LIBLTE_SECURITY_MILENAGE_VECTOR_STRUCT milenage_vector_t;
+
+uint8_t security_milenage_batch(milenage_vector_t* vectors, uint32_t nof_vectors);
+
 } // namespace srsran
 #endif // SRSRAN_SECURITY_H
@@ -32,10 +32,15 @@
 #include "srsran/adt/intrusive_list.h"
 #include "srsran/adt/move_callback.h"
 #include <algorithm>
+#include <array>
+#include <atomic>
 #include <cstdint>
 #include <deque>
 #include <limits>
+#include <memory>
 #include <mutex>
+#include <thread>
+#include <vector>
 
 namespace srsran {
 
@@ -54,28 +59,41 @@ public:
  *   This deque will only grow in size. Erased timers are just tagged in the deque as empty, and can be reused for the
  *   creation of new timers. To avoid unnecessary runtime allocations, the user can set an initial capacity.
  * - free_list - intrusive forward linked list to keep track of the empty timers and speed up new timer creation.
- * - A large circular vector of size WHEEL_SIZE which works as a time wheel, storing and circularly indexing the
- *   currently running timers by their respective timeout value.
- *   For a number of running timers N, and uniform distribution of timeout values, the step_all() complexity
- *   should be O(N/WHEEL_SIZE). Thus, the performance should improve with a larger WHEEL_SIZE, at the expense of more
- *   used memory.
+ * - A hierarchical time wheel of NOF_WHEEL_LEVELS levels of WHEEL_SIZE slots each. The level 0 slots store the timers
+ *   expiring in the next WHEEL_SIZE tics, and each slot of the upper levels stores the timers expiring in a range
+ *   WHEEL_SIZE times longer than the slots of the level below. When the time reaches the start of the range of an upper
+ *   level slot, its timers are cascaded to the lower levels. step_all() only visits the timers that expire or cascade,
+ *   independently of the number of running timers and of their timeouts.
+ * Threading:
+ * - The state of each timer is atomic, so run()/stop() take effect immediately from any thread.
+ * - Only the thread calling step_all() touches the time wheel. run()/stop() push the timer to a command queue of the
+ *   calling thread, which step_all() drains to relink the timer in the wheel according to its state.
  */
 class timer_handler
 {
-  using tic_diff_t                              = uint32_t;
-  using tic_t                                   = uint32_t;
-  constexpr static uint32_t   INVALID_ID        = std::numeric_limits<uint32_t>::max();
-  constexpr static tic_diff_t INVALID_TIME_DIFF = std::numeric_limits<tic_diff_t>::max();
-  constexpr static size_t     WHEEL_SHIFT       = 16U;
-  constexpr static size_t     WHEEL_SIZE        = 1U << WHEEL_SHIFT;
-  constexpr static size_t     WHEEL_MASK        = WHEEL_SIZE - 1U;
+  using tic_diff_t                               = uint32_t;
+  using tic_t                                    = uint32_t;
+  constexpr static uint32_t   INVALID_ID         = std::numeric_limits<uint32_t>::max();
+  constexpr static tic_diff_t INVALID_TIME_DIFF  = std::numeric_limits<tic_diff_t>::max();
+  constexpr static tic_diff_t MAX_TIMER_DURATION = std::numeric_limits<int32_t>::max();
+  constexpr static size_t     WHEEL_SHIFT        = 8U;
+  constexpr static size_t     WHEEL_SIZE         = 1U << WHEEL_SHIFT;
+  constexpr static size_t     WHEEL_MASK         = WHEEL_SIZE - 1U;
+  constexpr static size_t     NOF_WHEEL_LEVELS   = 4U; // covers the whole tic_t range
+  constexpr static uint16_t   INVALID_WHEEL_POS  = std::numeric_limits<uint16_t>::max();
+  constexpr static size_t     CMD_QUEUE_SIZE     = 1024U;
+  constexpr static size_t     MAX_CMD_QUEUES     = 32U;
 
   struct timer_impl : public intrusive_double_linked_list_element<>, public intrusive_forward_list_element<> {
+    enum state_t : uint8_t { empty, stopped, running, expired };
+
     timer_handler& parent;
     const uint32_t id;
-    tic_diff_t     duration                                          = INVALID_TIME_DIFF;
-    tic_t          timeout                                           = 0;
-    enum state_t : int8_t { empty, stopped, running, expired } state = empty;
+    tic_diff_t     duration  = INVALID_TIME_DIFF;
+    uint16_t       wheel_pos = INVALID_WHEEL_POS; ///< only accessed by the thread calling step_all()
+    /// state and absolute timeout, updated together
+    std::atomic<uint64_t>                 ctrl{pack(empty, 0)};
+    std::atomic<bool>                     cmd_pending{false}; ///< timer is already in a command queue
     srsran::move_callback<void(uint32_t)> callback;
 
     explicit timer_impl(timer_handler& parent_, uint32_t id_) : parent(parent_), id(id_) {}
@@ -84,21 +102,36 @@ class timer_handler
     timer_impl& operator=(const timer_impl&) = delete;
     timer_impl& operator=(timer_impl&&) = delete;
 
-    bool       is_empty() const { return state == empty; }
-    bool       is_running() const { return state == running; }
-    bool       is_expired() const { return state == expired; }
-    tic_diff_t time_left() const { return is_running() ? timeout - parent.cur_time : (is_expired() ? 0 : duration); }
-    uint32_t   time_elapsed() const { return duration - time_left(); }
+    static uint64_t pack(state_t state, tic_t timeout) { return (static_cast<uint64_t>(timeout) << 8U) | state; }
+    static state_t  state_of(uint64_t ctrl_) { return static_cast<state_t>(ctrl_ & 0xffU); }
+    static tic_t    timeout_of(uint64_t ctrl_) { return static_cast<tic_t>(ctrl_ >> 8U); }
+
+    state_t    state() const { return state_of(ctrl.load(std::memory_order_acquire)); }
+    bool       is_empty() const { return state() == empty; }
+    bool       is_running() const { return state() == running; }
+    bool       is_expired() const { return state() == expired; }
+    tic_diff_t time_left() const
+    {
+      uint64_t c = ctrl.load(std::memory_order_acquire);
+      if (state_of(c) == running) {
+        tic_diff_t left = timeout_of(c) - parent.cur_time.load(std::memory_order_relaxed);
+        // a timer started concurrently with step_all() may be one tic late
+        return left > MAX_TIMER_DURATION ? 0 : left;
+      }
+      return state_of(c) == expired ? 0 : duration;
+    }
+    uint32_t time_elapsed() const { return duration - time_left(); }
 
     bool set(uint32_t duration_)
     {
-      duration = std::max(duration_, 1U); // the next step will be one place ahead of current one
+      // the next step will be one place ahead of current one
+      duration = std::max(duration_, 1U);
+      duration = duration > MAX_TIMER_DURATION ? MAX_TIMER_DURATION : duration;
       if (is_running()) {
         // if already running, just extends timer lifetime
         run();
       } else {
-        state   = stopped;
-        timeout = 0;
+        parent.set_state_(*this, stopped, 0);
       }
       return true;
     }
@@ -114,20 +147,50 @@ class timer_handler
 
     void run()
     {
-      std::lock_guard<std::mutex> lock(parent.mutex);
-      parent.start_run_(*this);
+      parent.set_state_(*this, running, parent.cur_time.load(std::memory_order_relaxed) + duration);
+      parent.push_cmd_(this);
     }
 
     void stop()
     {
-      std::lock_guard<std::mutex> lock(parent.mutex);
       // does not call callback
-      parent.stop_timer_(*this, false);
+      if (parent.stop_timer_(*this)) {
+        parent.push_cmd_(this);
+      }
     }
 
     void deallocate() { parent.dealloc_timer(*this); }
   };
 
+  /// Single-producer single-consumer queue of the timers run/stopped by one thread, drained by step_all()
+  struct cmd_queue {
+    std::thread::id                         thread_id;
+    std::atomic<uint32_t>                   head{0}, tail{0};
+    std::array<timer_impl*, CMD_QUEUE_SIZE> timers;
+
+    bool try_push(timer_impl* timer)
+    {
+      uint32_t t = tail.load(std::memory_order_relaxed);
+      if (t - head.load(std::memory_order_acquire) == CMD_QUEUE_SIZE) {
+        return false;
+      }
+      timers[t % CMD_QUEUE_SIZE] = timer;
+      tail.store(t + 1, std::memory_order_release);
+      return true;
+    }
+
+    template <typename F>
+    void drain(const F& func)
+    {
+      uint32_t h = head.load(std::memory_order_relaxed);
+      uint32_t t = tail.load(std::memory_order_acquire);
+      for (; h != t; ++h) {
+        func(*timers[h % CMD_QUEUE_SIZE]);
+      }
+      head.store(h, std::memory_order_release);
+    }
+  };
+
 public:
   class unique_timer
   {
@@ -197,9 +260,9 @@ public:
     timer_impl* handle = nullptr;
   };
 
-  explicit timer_handler(uint32_t capacity = 64)
+  explicit timer_handler(uint32_t capacity = 64) : instance_id(next_instance_id())
   {
-    time_wheel.resize(WHEEL_SIZE);
+    time_wheel.resize(NOF_WHEEL_LEVELS * WHEEL_SIZE);
     // Pre-reserve timers
     while (timer_list.size() < capacity) {
       timer_list.emplace_back(*this, timer_list.size());
@@ -213,27 +276,41 @@ public:
 
   void step_all()
   {
-    std::unique_lock<std::mutex> lock(mutex);
-    cur_time++;
-    auto& wheel_list = time_wheel[cur_time & WHEEL_MASK];
+    tic_t now = cur_time.load(std::memory_order_relaxed) + 1;
+    cur_time.store(now, std::memory_order_relaxed);
 
+    // Cascade the upper level slots whose range starts now
+    for (size_t level = NOF_WHEEL_LEVELS - 1; level > 0; --level) {
+      if ((now & ((1U << (level * WHEEL_SHIFT)) - 1U)) == 0) {
+        cascade_(level, (now >> (level * WHEEL_SHIFT)) & WHEEL_MASK);
+      }
+    }
+
+    // Apply the run/stop commands of all threads
+    drain_cmds_();
+
+    auto& wheel_list = time_wheel[now & WHEEL_MASK];
     for (auto it = wheel_list.begin(); it != wheel_list.end();) {
-      timer_impl& timer = timer_list[it->id];
+      timer_impl& timer = *it;
       ++it;
-      if (timer.timeout == cur_time) {
-        // stop timer (callback has to see the timer has already expired)
-        stop_timer_(timer, true);
-
-        // Call callback if configured
-        if (not timer.callback.is_empty()) {
-          // unlock mutex. It can happen that the callback tries to run a timer too
-          lock.unlock();
+      uint64_t c = timer.ctrl.load(std::memory_order_acquire);
+      if (timer_impl::state_of(c) != timer_impl::running or not is_due_(timer_impl::timeout_of(c), now)) {
+        // modified after it was linked. Its pending command will relink it
+        continue;
+      }
+      unlink_(timer);
 
-          timer.callback(timer.id);
+      // stop timer (callback has to see the timer has already expired)
+      if (not timer.ctrl.compare_exchange_strong(
+              c, timer_impl::pack(timer_impl::expired, timer_impl::timeout_of(c)), std::memory_order_acq_rel)) {
+        // restarted or stopped concurrently
+        continue;
+      }
+      nof_timers_running_.fetch_sub(1, std::memory_order_relaxed);
 
-          // Lock again to keep protecting the wheel
-          lock.lock();
-        }
+      // Call callback if configured
+      if (not timer.callback.is_empty()) {
+        timer.callback(timer.id);
       }
     }
   }
@@ -243,7 +320,9 @@ public:
     std::lock_guard<std::mutex> lock(mutex);
     // does not call callback
     for (timer_impl& timer : timer_list) {
-      stop_timer_(timer, false);
+      if (stop_timer_(timer)) {
+        push_cmd_(&timer);
+      }
     }
   }
 
@@ -255,11 +334,7 @@ public:
     return timer_list.size() - nof_free_timers;
   }
 
-  uint32_t nof_running_timers() const
-  {
-    std::lock_guard<std::mutex> lock(mutex);
-    return nof_timers_running_;
-  }
+  uint32_t nof_running_timers() const { return nof_timers_running_.load(std::memory_order_relaxed); }
 
   template <typename F>
   void defer_callback(uint32_t duration, const F& func)
@@ -292,7 +367,7 @@ private:
       timer_list.emplace_back(*this, timer_list.size());
       t = &timer_list.back();
     }
-    t->state = timer_impl::stopped;
+    set_state_(*t, timer_impl::stopped, 0);
     return *t;
   }
 
@@ -303,57 +378,178 @@ private:
       // already deallocated
       return;
     }
-    stop_timer_(timer, false);
-    timer.state    = timer_impl::empty;
+    if (set_state_(timer, timer_impl::empty, 0) == timer_impl::running) {
+      push_cmd_(&timer);
+    }
     timer.duration = INVALID_TIME_DIFF;
-    timer.timeout  = 0;
     timer.callback = srsran::move_callback<void(uint32_t)>();
+    // the timer can be reused right away, as its position in the wheel only depends on its state
     free_list.push_front(&timer);
     nof_free_timers++;
     // leave id unchanged.
   }
 
-  void start_run_(timer_impl& timer)
+  /// Sets the timer state and timeout, and returns its previous state
+  timer_impl::state_t set_state_(timer_impl& timer, timer_impl::state_t state, tic_t timeout)
+  {
+    timer_impl::state_t prev =
+        timer_impl::state_of(timer.ctrl.exchange(timer_impl::pack(state, timeout), std::memory_order_acq_rel));
+    if (prev == timer_impl::running and state != timer_impl::running) {
+      nof_timers_running_.fetch_sub(1, std::memory_order_relaxed);
+    } else if (prev != timer_impl::running and state == timer_impl::running) {
+      nof_timers_running_.fetch_add(1, std::memory_order_relaxed);
+    }
+    return prev;
+  }
+
+  /// called when user manually stops timer (as an alternative to expiry). Returns false if it was not running
+  bool stop_timer_(timer_impl& timer)
   {
-    uint32_t timeout       = cur_time + timer.duration;
-    size_t   new_wheel_pos = timeout & WHEEL_MASK;
-    if (timer.is_running() and (timer.timeout & WHEEL_MASK) == new_wheel_pos) {
-      // If no change in timer wheel position. Just update absolute timeout
-      timer.timeout = timeout;
+    uint64_t c = timer.ctrl.load(std::memory_order_acquire);
+    do {
+      if (timer_impl::state_of(c) != timer_impl::running) {
+        return false;
+      }
+    } while (not timer.ctrl.compare_exchange_weak(
+        c, timer_impl::pack(timer_impl::stopped, timer_impl::timeout_of(c)), std::memory_order_acq_rel));
+    nof_timers_running_.fetch_sub(1, std::memory_order_relaxed);
+    return true;
+  }
+
+  static bool is_due_(tic_t timeout, tic_t now) { return now - timeout <= MAX_TIMER_DURATION; }
+
+  /****** Time wheel. Only accessed by the thread calling step_all() ******/
+
+  void unlink_(timer_impl& timer)
+  {
+    if (timer.wheel_pos != INVALID_WHEEL_POS) {
+      time_wheel[timer.wheel_pos].pop(&timer);
+      timer.wheel_pos = INVALID_WHEEL_POS;
+    }
+  }
+
+  /// (Re)links the timer in the wheel, according to its current state and timeout
+  void place_(timer_impl& timer)
+  {
+    unlink_(timer);
+    uint64_t c = timer.ctrl.load(std::memory_order_acquire);
+    if (timer_impl::state_of(c) != timer_impl::running) {
       return;
     }
+    tic_t      now     = cur_time.load(std::memory_order_relaxed);
+    tic_t      timeout = timer_impl::timeout_of(c);
+    tic_diff_t delta   = timeout - now;
+    if (delta > MAX_TIMER_DURATION) {
+      // started concurrently with the previous step_all(). Expire it now
+      timeout = now;
+      delta   = 0;
+    }
+    size_t level = 0;
+    while (level < NOF_WHEEL_LEVELS - 1 and delta >= (1U << ((level + 1) * WHEEL_SHIFT))) {
+      level++;
+    }
+    timer.wheel_pos = static_cast<uint16_t>(level * WHEEL_SIZE + ((timeout >> (level * WHEEL_SHIFT)) & WHEEL_MASK));
+    time_wheel[timer.wheel_pos].push_front(&timer);
+  }
 
-    // Stop timer if it was running, removing it from wheel in the process
-    stop_timer_(timer, false);
+  void cascade_(size_t level, size_t slot)
+  {
+    auto& wheel_list = time_wheel[level * WHEEL_SIZE + slot];
+    while (not wheel_list.empty()) {
+      place_(wheel_list.front());
+    }
+  }
 
-    // Insert timer in wheel
-    time_wheel[new_wheel_pos].push_front(&timer);
-    timer.timeout = timeout;
-    timer.state   = timer_impl::running;
-    nof_timers_running_++;
+  void drain_cmds_()
+  {
+    auto place_func = [this](timer_impl& timer) {
+      timer.cmd_pending.exchange(false, std::memory_order_acq_rel);
+      place_(timer);
+    };
+    uint32_t nof_queues = nof_cmd_queues.load(std::memory_order_acquire);
+    for (uint32_t i = 0; i < nof_queues; ++i) {
+      cmd_queues[i]->drain(place_func);
+    }
+    std::vector<timer_impl*> overflow;
+    {
+      std::lock_guard<std::mutex> lock(cmd_mutex);
+      overflow.swap(cmd_overflow);
+    }
+    for (timer_impl* timer : overflow) {
+      place_func(*timer);
+    }
   }
 
-  /// called when user manually stops timer (as an alternative to expiry)
-  void stop_timer_(timer_impl& timer, bool expiry)
+  /****** Command queues ******/
+
+  void push_cmd_(timer_impl* timer)
   {
-    if (not timer.is_running()) {
+    // placement reads the latest state, so one pending command per timer is enough
+    if (timer->cmd_pending.exchange(true, std::memory_order_acq_rel)) {
       return;
     }
+    cmd_queue* q = get_cmd_queue_();
+    if (q == nullptr or not q->try_push(timer)) {
+      std::lock_guard<std::mutex> lock(cmd_mutex);
+      cmd_overflow.push_back(timer);
+    }
+  }
 
-    // If already running, need to disconnect it from previous wheel
-    time_wheel[timer.timeout & WHEEL_MASK].pop(&timer);
+  /// Finds the command queue of the calling thread, or creates it. Returns nullptr if there are no queues left
+  cmd_queue* get_cmd_queue_()
+  {
+    struct cache_entry {
+      uint64_t   instance_id;
+      cmd_queue* queue;
+    };
+    static thread_local std::array<cache_entry, 4> cache      = {};
+    static thread_local uint32_t                   next_entry = 0;
+    for (const cache_entry& e : cache) {
+      if (e.instance_id == instance_id) {
+        return e.queue;
+      }
+    }
+
+    std::lock_guard<std::mutex> lock(cmd_mutex);
+    std::thread::id             thread_id  = std::this_thread::get_id();
+    uint32_t                    nof_queues = nof_cmd_queues.load(std::memory_order_relaxed);
+    cmd_queue*                  q          = nullptr;
+    for (uint32_t i = 0; i < nof_queues and q == nullptr; ++i) {
+      if (cmd_queues[i]->thread_id == thread_id) {
+        q = cmd_queues[i].get();
+      }
+    }
+    if (q == nullptr and nof_queues < MAX_CMD_QUEUES) {
+      cmd_queues[nof_queues].reset(new cmd_queue);
+      q            = cmd_queues[nof_queues].get();
+      q->thread_id = thread_id;
+      nof_cmd_queues.store(nof_queues + 1, std::memory_order_release);
+    }
+    cache[next_entry] = {instance_id, q};
+    next_entry        = (next_entry + 1) % cache.size();
+    return q;
+  }
 
-    timer.state = expiry ? timer_impl::expired : timer_impl::stopped;
-    nof_timers_running_--;
+  static uint64_t next_instance_id()
+  {
+    static std::atomic<uint64_t> counter{0};
+    return ++counter;
   }
 
-  tic_t  cur_time            = 0;
-  size_t nof_timers_running_ = 0, nof_free_timers = 0;
+  const uint64_t        instance_id;
+  std::atomic<tic_t>    cur_time{0};
+  std::atomic<uint32_t> nof_timers_running_{0};
+  size_t                nof_free_timers = 0;
   // using a deque to maintain reference validity on emplace_back. Also, this deque will only grow.
   std::deque<timer_impl>                                         timer_list;
   srsran::intrusive_forward_list<timer_impl>                     free_list;
   std::vector<srsran::intrusive_double_linked_list<timer_impl> > time_wheel;
-  mutable std::mutex                                             mutex; // Protect priority queue
+  mutable std::mutex                                             mutex; // Protect timer allocation
+
+  std::array<std::unique_ptr<cmd_queue>, MAX_CMD_QUEUES> cmd_queues;
+  std::atomic<uint32_t>                                  nof_cmd_queues{0};
+  std::vector<timer_impl*>                               cmd_overflow;
+  std::mutex                                             cmd_mutex; // Protect command queue creation and overflow
 };
 
 using unique_timer = timer_handler::unique_timer;
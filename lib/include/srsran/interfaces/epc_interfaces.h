@@ -94,9 +94,9 @@ public:
 class mme_interface_nas // NAS -> MME
 {
 public:
-  virtual bool add_nas_timer(int timer_fd, enum nas_timer_type type, uint64_t imsi) = 0;
-  virtual bool is_nas_timer_running(enum nas_timer_type type, uint64_t imsi)        = 0;
-  virtual bool remove_nas_timer(enum nas_timer_type type, uint64_t imsi)            = 0;
+  virtual bool add_nas_timer(uint32_t timeout_ms, enum nas_timer_type type, uint64_t imsi) = 0;
+  virtual bool is_nas_timer_running(enum nas_timer_type type, uint64_t imsi)              = 0;
+  virtual bool remove_nas_timer(enum nas_timer_type type, uint64_t imsi)                  = 0;
 };
 
 class s1ap_interface_mme // MME -> S1AP
@@ -24,6 +24,7 @@
 
 #include "srsran/common/byte_buffer.h"
 #include "srsran/common/common.h"
+#include "srsran/common/interfaces_common.h"
 #include "srsran/config.h"
 #include "srsran/srslog/srslog.h"
 #include <memory>
@@ -143,6 +144,8 @@ public:
   // Add SDU or CEs to PDU
   // All functions will return SRSRAN_SUCCESS on success, and SRSRAN_ERROR otherwise
   uint32_t add_sdu(const uint32_t lcid_, const uint8_t* payload_, const uint32_t len_);
+  /// Lets sdu_itf write an SDU of up to max_len_ bytes straight into the PDU, returns its length or SRSRAN_ERROR
+  int32_t add_sdu(const uint32_t lcid_, const uint32_t max_len_, read_pdu_interface* sdu_itf_);
   uint32_t add_crnti_ce(const uint16_t crnti_);
   uint32_t add_se_phr_ce(const uint8_t phr_, const uint8_t pcmax_);
   uint32_t add_sbsr_ce(const mac_sch_subpdu_nr::lcg_bsr_t bsr_);
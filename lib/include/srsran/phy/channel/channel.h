@@ -29,8 +29,12 @@
 #include "rlf.h"
 #include "srsran/phy/common/phy_common.h"
 #include "srsran/srslog/srslog.h"
+#include <condition_variable>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
+#include <vector>
 
 namespace srsran {
 
@@ -67,6 +71,9 @@ public:
     bool     rlf_enable   = false;
     uint32_t rlf_t_on_ms  = 10000;
     uint32_t rlf_t_off_ms = 2000;
+
+    // Process each channel in a separate thread
+    bool parallel_enable = true;
   } args_t;
 
   channel(const args_t& channel_args, uint32_t _nof_channels, srslog::basic_logger& logger);
@@ -76,18 +83,35 @@ public:
   void run(cf_t* in[SRSRAN_MAX_CHANNELS], cf_t* out[SRSRAN_MAX_CHANNELS], uint32_t len, const srsran_timestamp_t& t);
 
 private:
+  void run_channel(uint32_t i);
+  void run_worker(uint32_t i);
+
   srslog::basic_logger&    logger;
   float                    hst_init_phase              = 0.0f;
   srsran_channel_fading_t* fading[SRSRAN_MAX_CHANNELS] = {};
   srsran_channel_delay_t*  delay[SRSRAN_MAX_CHANNELS]  = {};
-  srsran_channel_awgn_t*   awgn                        = nullptr;
+  srsran_channel_awgn_t*   awgn[SRSRAN_MAX_CHANNELS]   = {};
   srsran_channel_hst_t*    hst                         = nullptr;
   srsran_channel_rlf_t*    rlf                         = nullptr;
-  cf_t*                    buffer_in                   = nullptr;
-  cf_t*                    buffer_out                  = nullptr;
   uint32_t                 nof_channels                = 0;
   uint32_t                 current_srate               = 0;
   args_t                   args                        = {};
+
+  // Arguments of the current run() call, shared with the workers
+  cf_t**             run_in    = nullptr;
+  cf_t**             run_out   = nullptr;
+  uint32_t           run_len   = 0;
+  srsran_timestamp_t run_ts    = {};
+  cf_t               run_phase = 1.0f;
+
+  // Workers processing the channels other than the first one, in parallel with the caller
+  std::vector<std::thread> workers;
+  std::mutex               workers_mutex;
+  std::condition_variable  cvar_start;
+  std::condition_variable  cvar_done;
+  uint64_t                 run_count    = 0;
+  uint32_t                 nof_pending  = 0;
+  bool                     workers_quit = false;
 };
 
 typedef std::unique_ptr<channel> channel_ptr;
@@ -30,6 +30,7 @@
 
 #define SRSRAN_CHANNEL_FADING_MAXTAPS 9
 #define SRSRAN_CHANNEL_FADING_NTERMS 16
+#define SRSRAN_CHANNEL_FADING_BATCH 4 // FFT size, in multiples of the minimum size that fits the impulse response
 
 typedef enum {
   srsran_channel_fading_model_none = 0,
@@ -47,7 +48,7 @@ typedef struct {
   // Internal tap parametrisation
   uint32_t N;          // FFT size
   uint32_t path_delay; // Path delay
-  uint32_t state_len;  // Length of the impulse response saved in the state
+  uint32_t state_len;  // Overlap between consecutive segments, bounds the length of the impulse response
 
   float coeff_alpha[SRSRAN_CHANNEL_FADING_MAXTAPS][SRSRAN_CHANNEL_FADING_NTERMS]; // Angle of arrival
   float coeff_a[SRSRAN_CHANNEL_FADING_MAXTAPS][SRSRAN_CHANNEL_FADING_NTERMS];     // Random phase
@@ -63,7 +64,7 @@ typedef struct {
   float             sin_table[1024]; // Table of sinus values
 
   // State variables
-  cf_t* state; // To save impulse response of the filter
+  cf_t* state; // Last state_len input samples
 } srsran_channel_fading_t;
 
 #ifdef __cplusplus
@@ -0,0 +1,127 @@
+/**
+ * Copyright 2013-2021 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+/******************************************************************************
+ *  File:         fading_mimo.h
+ *
+ *  Description:  Multi-link MIMO fading channel. Every link is an independent
+ *                nof_tx x nof_rx channel following one of the 36.104 multi-path
+ *                models, with the spatial correlation of 36.101 Annex B.2.3.
+ *
+ *                The Jakes processes of all links, taps and antenna pairs are
+ *                sums of complex sinusoids. Their phasors are advanced by
+ *                precomputed per-segment rotations, so the tap gains of every
+ *                link are generated with a single vector product.
+ *
+ *  Reference:    3GPP TS 36.101 version 10.0.0 Release 10 Annex B.2.3
+ *****************************************************************************/
+
+#ifndef SRSRAN_FADING_MIMO_H
+#define SRSRAN_FADING_MIMO_H
+
+#include "srsran/config.h"
+#include "srsran/phy/channel/fading.h"
+#include "srsran/phy/dft/dft.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+#define SRSRAN_CHANNEL_FADING_MIMO_MAX_PORTS 4
+#define SRSRAN_CHANNEL_FADING_MIMO_MAX_PATHS (SRSRAN_CHANNEL_FADING_MIMO_MAX_PORTS * SRSRAN_CHANNEL_FADING_MIMO_MAX_PORTS)
+
+typedef enum {
+  srsran_channel_fading_corr_low = 0,
+  srsran_channel_fading_corr_medium,
+  srsran_channel_fading_corr_high,
+} srsran_channel_fading_corr_t;
+
+typedef struct {
+  // Configuration parameters
+  float                         srate;     // Sampling rate
+  srsran_channel_fading_model_t model;     // None, EPA, EVA, ETU
+  float                         doppler;   // Maximum doppler
+  srsran_channel_fading_corr_t  corr;      // Spatial correlation level
+  uint32_t                      nof_links; // Number of independent links
+  uint32_t                      nof_tx;    // Transmit antennas per link
+  uint32_t                      nof_rx;    // Receive antennas per link
+  uint32_t                      nof_paths; // nof_tx * nof_rx, path p = tx * nof_rx + rx
+  uint32_t                      nof_taps;  // Taps of the multi-path model
+
+  // Internal tap parametrisation
+  uint32_t N;          // FFT size
+  uint32_t path_delay; // Path delay
+  uint32_t state_len;  // Overlap between consecutive segments, bounds the length of the impulse response
+  float    corr_sqrt[SRSRAN_CHANNEL_FADING_MIMO_MAX_PATHS * SRSRAN_CHANNEL_FADING_MIMO_MAX_PATHS]; // Cholesky factor
+  cf_t*    h_tap[SRSRAN_CHANNEL_FADING_MAXTAPS]; // Static tap signal in frequency domain, FFT-shifted
+
+  // Jakes processes, one for each link, tap and path, SRSRAN_CHANNEL_FADING_NTERMS sinusoids each
+  uint32_t nof_processes;
+  cf_t*    phasor;           // Current phasor of every sinusoid
+  float*   omega;            // Doppler shift of every sinusoid, radians per sample
+  cf_t*    rotation;         // Phasor rotation over a full segment
+  cf_t*    rotation_partial; // Phasor rotation over the last partial segment
+  uint32_t partial_len;      // Length of the partial segment rotation_partial was computed for
+  uint32_t nof_rotations;    // Rotations since the phasors were normalised
+  cf_t*    gain;             // Correlated tap gains, indexed [link][tap][path]
+
+  // Utils
+  srsran_dft_plan_t fft;    // DFT to frequency domain
+  srsran_dft_plan_t ifft;   // DFT to time domain
+  cf_t*             temp;   // Temporal buffer, length fft_size
+  cf_t*             h_freq; // Channel frequency response of a path, length fft_size
+  cf_t*             x_freq; // Transmitted signals in frequency domain, length nof_tx * fft_size
+  cf_t*             y_freq; // Received signal in frequency domain, length fft_size
+
+  // State variables
+  cf_t* state; // Last state_len input samples of every link and transmit antenna
+} srsran_channel_fading_mimo_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+SRSRAN_API int srsran_channel_fading_mimo_init(srsran_channel_fading_mimo_t* q,
+                                               double                        srate,
+                                               const char*                   model,
+                                               srsran_channel_fading_corr_t  corr,
+                                               bool                          enb_tx,
+                                               uint32_t                      nof_links,
+                                               uint32_t                      nof_tx,
+                                               uint32_t                      nof_rx,
+                                               uint32_t                      seed);
+
+SRSRAN_API void srsran_channel_fading_mimo_free(srsran_channel_fading_mimo_t* q);
+
+/**
+ * Filters the signals of all links. in[link * nof_tx + tx] and out[link * nof_rx + rx] hold nof_samples each. Input
+ * and output buffers of the same link may be the same.
+ */
+SRSRAN_API int srsran_channel_fading_mimo_execute(srsran_channel_fading_mimo_t* q,
+                                                  cf_t**                        in,
+                                                  cf_t**                        out,
+                                                  uint32_t                      nof_samples);
+
+SRSRAN_API int srsran_channel_fading_corr_parse(const char* str, srsran_channel_fading_corr_t* corr);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SRSRAN_FADING_MIMO_H
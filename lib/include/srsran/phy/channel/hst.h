@@ -49,6 +49,11 @@ SRSRAN_API int srsran_channel_hst_init(srsran_channel_hst_t* q, float fd_hz, flo
 
 SRSRAN_API void srsran_channel_hst_update_srate(srsran_channel_hst_t* q, uint32_t srate);
 
+/**
+ * Updates the doppler shift for the given timestamp, without applying it
+ */
+SRSRAN_API void srsran_channel_hst_update(srsran_channel_hst_t* q, const srsran_timestamp_t* ts);
+
 SRSRAN_API void
 srsran_channel_hst_execute(srsran_channel_hst_t* q, cf_t* in, cf_t* out, uint32_t len, const srsran_timestamp_t* ts);
 
@@ -47,16 +47,24 @@ SRSRAN_API void srsran_sequence_state_gen_f(srsran_sequence_state_t* s, float va
 
 SRSRAN_API void srsran_sequence_state_advance(srsran_sequence_state_t* s, uint32_t length);
 
+/**
+ * Stored pseudo-random sequence. Only the packed bits are kept (MSB first, the srsran_bit_pack_vector layout); the
+ * scrambling functions expand them into signs on the fly.
+ */
 typedef struct SRSRAN_API {
-  uint8_t* c;
   uint8_t* c_bytes;
-  float*   c_float;
-  short*   c_short;
-  int8_t*  c_char;
   uint32_t cur_len;
   uint32_t max_len;
 } srsran_sequence_t;
 
+/**
+ * Returns bit i of a stored sequence
+ */
+static inline uint8_t srsran_sequence_get_bit(const srsran_sequence_t* q, uint32_t i)
+{
+  return (uint8_t)((q->c_bytes[i / 8] >> (7U - i % 8U)) & 1U);
+}
+
 SRSRAN_API int srsran_sequence_init(srsran_sequence_t* q, uint32_t len);
 
 SRSRAN_API void srsran_sequence_free(srsran_sequence_t* q);
@@ -44,6 +44,11 @@ typedef struct SRSRAN_API {
   uint64_t crcmask;
   uint64_t crchighbit;
   uint32_t srsran_crc_out;
+
+  // Slicing-by-8 tables, the CRC register is left-aligned to 32 bits so every order shares the same engine
+  uint32_t table8[8][256];
+  // Folding constants x^k mod P(x) * x^(32-order) for k = 128, 192, 512 and 576
+  uint64_t fold[4];
 } srsran_crc_t;
 
 SRSRAN_API int srsran_crc_init(srsran_crc_t* h, uint32_t srsran_crc_poly, int srsran_crc_order);
@@ -51,17 +51,6 @@ typedef enum {
                                    (AVX512 version). */
 } srsran_ldpc_decoder_type_t;
 
-/*!
- * \brief Describes the LDPC decoder configuration arguments.
- */
-typedef struct {
-  srsran_ldpc_decoder_type_t type;         /*!< \brief Type of LDPC decoder. */
-  srsran_basegraph_t         bg;           /*!< \brief The desired base graph (BG1 or BG2). */
-  uint16_t                   ls;           /*!< \brief The desired lifting size. */
-  float                      scaling_fctr; /*!< \brief Scaling factor of the normalized min-sum algorithm.*/
-  uint32_t                   max_nof_iter; /*!< \brief Maximum number of iterations, set to 0 for default value. */
-} srsran_ldpc_decoder_args_t;
-
 /*!
  * \brief Describes an LDPC decoder.
  */
@@ -80,8 +69,12 @@ typedef struct SRSRAN_API {
 
   int8_t (*var_indices)[MAX_CNCT]; /*!< \brief Pointer to lists of variable indices connected to a given check node. */
 
+  bool pcm_is_shared; /*!< \brief True if \b pcm and \b var_indices belong to another decoder. */
+
   float scaling_fctr; /*!< \brief Scaling factor for the normalized min-sum algorithm. */
 
+  uint8_t* hard_bits; /*!< \brief Hard decisions of the codeword, followed by the syndrome of one layer. */
+
   void (*free)(void*); /*!< \brief Pointer to a "destructor". */
 
   int (*decode_f)(void*,
@@ -101,6 +94,20 @@ typedef struct SRSRAN_API {
                   srsran_crc_t*); /*!< \brief Pointer to the decoding function (16-bit version). */
 } srsran_ldpc_decoder_t;
 
+/*!
+ * \brief Describes the LDPC decoder configuration arguments.
+ */
+typedef struct {
+  srsran_ldpc_decoder_type_t type;         /*!< \brief Type of LDPC decoder. */
+  srsran_basegraph_t         bg;           /*!< \brief The desired base graph (BG1 or BG2). */
+  uint16_t                   ls;           /*!< \brief The desired lifting size. */
+  float                      scaling_fctr; /*!< \brief Scaling factor of the normalized min-sum algorithm.*/
+  uint32_t                   max_nof_iter; /*!< \brief Maximum number of iterations, set to 0 for default value. */
+
+  const srsran_ldpc_decoder_t* pcm_owner; /*!< \brief %Decoder with the same base graph and lifting size whose parity
+                                           check matrix is reused, NULL to create a new one. */
+} srsran_ldpc_decoder_args_t;
+
 /*!
  * Initializes all the LDPC decoder variables according to the given base graph
  * and lifting size.
@@ -125,6 +132,8 @@ SRSRAN_API void srsran_ldpc_decoder_free(srsran_ldpc_decoder_t* q);
  * \param[out] message The message (uncoded bits) resulting from the decoding
  *    operation.
  * \param[in] cdwd_rm_length The number of bits forming the codeword (after rate matching).
+ * \return -1 if an error occurred, the number of used iterations otherwise. The decoding stops as soon as the
+ *    syndrome of the hard decisions is zero.
  */
 SRSRAN_API int
 srsran_ldpc_decoder_decode_f(srsran_ldpc_decoder_t* q, const float* llrs, uint8_t* message, uint32_t cdwd_rm_length);
@@ -140,6 +149,8 @@ srsran_ldpc_decoder_decode_f(srsran_ldpc_decoder_t* q, const float* llrs, uint8_
  * \param[out] message The message (uncoded bits) resulting from the decoding
  *    operation.
  * \param[in] cdwd_rm_length The number of bits forming the codeword (after rate matching).
+ * \return -1 if an error occurred, the number of used iterations otherwise. The decoding stops as soon as the
+ *    syndrome of the hard decisions is zero.
  */
 SRSRAN_API int
 srsran_ldpc_decoder_decode_s(srsran_ldpc_decoder_t* q, const int16_t* llrs, uint8_t* message, uint32_t cdwd_rm_length);
@@ -155,6 +166,8 @@ srsran_ldpc_decoder_decode_s(srsran_ldpc_decoder_t* q, const int16_t* llrs, uint
  * \param[out] message The message (uncoded bits) resulting from the decoding
  *    operation.
  * \param[in] cdwd_rm_length The number of bits forming the codeword (after rate matching).
+ * \return -1 if an error occurred, the number of used iterations otherwise. The decoding stops as soon as the
+ *    syndrome of the hard decisions is zero.
  */
 SRSRAN_API int
 srsran_ldpc_decoder_decode_c(srsran_ldpc_decoder_t* q, const int8_t* llrs, uint8_t* message, uint32_t cdwd_rm_length);
@@ -170,7 +183,8 @@ srsran_ldpc_decoder_decode_c(srsran_ldpc_decoder_t* q, const int8_t* llrs, uint8
  * \param[out] message The message (uncoded bits) resulting from the decoding
  *    operation.
  * \param[in] cdwd_rm_length The number of bits forming the codeword (after rate matching).
- * \param[in,out] crc Code-block CRC object for early stop. Set for NULL to disable check
+ * \param[in,out] crc Code-block CRC object for early stop, only checked once the syndrome of the hard decisions is
+ *    zero. Set for NULL to stop on a zero syndrome alone
  * \return -1 if an error occurred, the number of used iterations, and 0 if CRC is provided and did not match
  */
 SRSRAN_API int srsran_ldpc_decoder_decode_crc_c(srsran_ldpc_decoder_t* q,
@@ -32,25 +32,44 @@
 #define SRSRAN_SOFTBUFFER_H
 
 #include "srsran/config.h"
+#include <pthread.h>
+#include <stdbool.h>
 #include <stdint.h>
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+/* Code block storage shared by the softbuffers of many HARQ processes. A pooled softbuffer only holds the code blocks
+ * of the TB in flight: they are leased from the pool for every new TB and given back once it is no longer needed. */
 typedef struct SRSRAN_API {
-  uint32_t  max_cb;
-  uint32_t  max_cb_size;
-  int16_t** buffer_f;
-  uint8_t** data;
-  bool*     cb_crc;
-  bool      tb_crc;
+  uint32_t        max_cb_size;
+  uint32_t        cb_nof_bytes;  // Storage for one code block
+  uint32_t        max_nof_cb;    // Code blocks the pool may allocate, 0 for no limit
+  uint32_t        nof_cb;        // Code blocks allocated so far
+  uint32_t        nof_free;      // Code blocks in the free list
+  uint32_t        free_capacity; // Size of the free list
+  uint8_t**       free_list;
+  pthread_mutex_t mutex;
+} srsran_softbuffer_pool_t;
+
+typedef struct SRSRAN_API {
+  uint32_t                  max_cb;
+  uint32_t                  max_cb_size;
+  int16_t**                 buffer_f;
+  uint8_t**                 data;
+  bool*                     cb_crc;
+  bool                      tb_crc;
+  srsran_softbuffer_pool_t* pool;        // Code block storage is leased from this pool, NULL if owned
+  uint32_t                  pool_max_cb; // Code blocks the buffer tables have room for when pooled
 } srsran_softbuffer_rx_t;
 
 typedef struct SRSRAN_API {
-  uint32_t  max_cb;
-  uint32_t  max_cb_size;
-  uint8_t** buffer_b;
+  uint32_t                  max_cb;
+  uint32_t                  max_cb_size;
+  uint8_t**                 buffer_b;
+  srsran_softbuffer_pool_t* pool;        // Code block storage is leased from this pool, NULL if owned
+  uint32_t                  pool_max_cb; // Code blocks the buffer table has room for when pooled
 } srsran_softbuffer_tx_t;
 
 #define SOFTBUFFER_SIZE 18600
@@ -93,6 +112,83 @@ SRSRAN_API void srsran_softbuffer_tx_reset_cb(srsran_softbuffer_tx_t* q, uint32_
 
 SRSRAN_API void srsran_softbuffer_tx_free(srsran_softbuffer_tx_t* p);
 
+/**
+ * @brief Initialises a pool of Rx code block storage
+ * @param q The pool pointer
+ * @param nof_prb Cell bandwidth, sets the code block size
+ * @param nof_prealloc_cb Number of code blocks to allocate upfront
+ * @param max_nof_cb Maximum number of code blocks the pool may allocate, 0 for no limit
+ * @return It returns SRSRAN_SUCCESS if the pool is initialised succesfully, otherwise it returns SRSRAN_ERROR code
+ */
+SRSRAN_API int srsran_softbuffer_pool_rx_init(srsran_softbuffer_pool_t* q,
+                                              uint32_t                  nof_prb,
+                                              uint32_t                  nof_prealloc_cb,
+                                              uint32_t                  max_nof_cb);
+
+/**
+ * @brief Initialises a pool of Tx code block storage, see srsran_softbuffer_pool_rx_init()
+ */
+SRSRAN_API int srsran_softbuffer_pool_tx_init(srsran_softbuffer_pool_t* q,
+                                              uint32_t                  nof_prb,
+                                              uint32_t                  nof_prealloc_cb,
+                                              uint32_t                  max_nof_cb);
+
+/**
+ * @brief Frees the pool storage. All the softbuffers using the pool must have been freed before
+ */
+SRSRAN_API void srsran_softbuffer_pool_free(srsran_softbuffer_pool_t* q);
+
+/**
+ * @brief Number of code blocks allocated by the pool, leased or free
+ */
+SRSRAN_API uint32_t srsran_softbuffer_pool_nof_allocated(srsran_softbuffer_pool_t* q);
+
+/**
+ * @brief Number of code blocks currently leased to softbuffers
+ */
+SRSRAN_API uint32_t srsran_softbuffer_pool_nof_leased(srsran_softbuffer_pool_t* q);
+
+/**
+ * @brief Initialises a Rx soft-buffer that takes its code block storage from a pool. It holds no storage until
+ * srsran_softbuffer_rx_lease() is called, max_cb is zero meanwhile
+ * @param q The Rx soft-buffer pointer
+ * @param pool The Rx code block pool
+ * @param nof_prb Cell bandwidth, sets the maximum number of code blocks
+ * @return It returns SRSRAN_SUCCESS if it initialises the soft-buffer succesfully, otherwise it returns SRSRAN_ERROR
+ */
+SRSRAN_API int
+srsran_softbuffer_rx_init_pool(srsran_softbuffer_rx_t* q, srsran_softbuffer_pool_t* pool, uint32_t nof_prb);
+
+/**
+ * @brief Gives back the storage of a pooled Rx soft-buffer and leases, zeroed, the code blocks of a new TB
+ * @param q The Rx soft-buffer pointer
+ * @param tbs Transport block size in bits
+ * @return It returns SRSRAN_SUCCESS if the storage was leased, otherwise SRSRAN_ERROR and the soft-buffer is empty
+ */
+SRSRAN_API int srsran_softbuffer_rx_lease(srsran_softbuffer_rx_t* q, uint32_t tbs);
+
+/**
+ * @brief Gives the storage of a pooled Rx soft-buffer back to its pool
+ */
+SRSRAN_API void srsran_softbuffer_rx_release(srsran_softbuffer_rx_t* q);
+
+/**
+ * @brief Initialises a Tx soft-buffer that takes its code block storage from a pool, see
+ * srsran_softbuffer_rx_init_pool()
+ */
+SRSRAN_API int
+srsran_softbuffer_tx_init_pool(srsran_softbuffer_tx_t* q, srsran_softbuffer_pool_t* pool, uint32_t nof_prb);
+
+/**
+ * @brief Gives back the storage of a pooled Tx soft-buffer and leases, zeroed, the code blocks of a new TB
+ */
+SRSRAN_API int srsran_softbuffer_tx_lease(srsran_softbuffer_tx_t* q, uint32_t tbs);
+
+/**
+ * @brief Gives the storage of a pooled Tx soft-buffer back to its pool
+ */
+SRSRAN_API void srsran_softbuffer_tx_release(srsran_softbuffer_tx_t* q);
+
 #ifdef __cplusplus
 }
 #endif
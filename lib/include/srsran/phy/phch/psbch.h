@@ -77,9 +77,6 @@ typedef struct SRSRAN_API {
   uint8_t* codeword_bytes;
   int16_t* llr;
 
-  // interleaving
-  uint32_t* interleaver_lut;
-
   // scrambling
   srsran_sequence_t seq;
 
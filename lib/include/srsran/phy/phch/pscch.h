@@ -68,9 +68,8 @@ typedef struct SRSRAN_API {
   uint32_t nof_symbols;
 
   // interleaving
-  uint32_t* interleaver_lut;
-  uint8_t*  codeword;
-  uint8_t*  codeword_bytes;
+  uint8_t* codeword;
+  uint8_t* codeword_bytes;
 
   // scrambling
   srsran_sequence_t seq;
@@ -93,10 +93,9 @@ typedef struct SRSRAN_API {
   int16_t* llr;
 
   // interleaving
-  uint8_t*  f;
-  uint8_t*  f_bytes;
-  int16_t*  f_16;
-  uint32_t* interleaver_lut;
+  uint8_t* f;
+  uint8_t* f_bytes;
+  int16_t* f_16;
 
   // scrambling
   srsran_sequence_t scrambling_seq;
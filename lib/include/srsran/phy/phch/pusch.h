@@ -85,10 +85,19 @@ typedef struct SRSRAN_API {
   srsran_uci_value_t uci;
   bool               crc;
   float              avg_iterations_block;
+  uint32_t           nof_shed_iterations;
   float              evm;
   float              epre_dbfs;
 } srsran_pusch_res_t;
 
+/**
+ * PUSCH decoding against a deadline. Retransmissions and PUSCH carrying UCI are decoded first, the others are shed when
+ * the learnt decoding time says they do not fit before the deadline anymore.
+ */
+typedef struct SRSRAN_API {
+  float ns_per_bit; ///< Average PUSCH decoding time, 0 until a PUSCH has been decoded
+} srsran_pusch_deadline_t;
+
 SRSRAN_API int srsran_pusch_init_ue(srsran_pusch_t* q, uint32_t max_prb);
 
 SRSRAN_API int srsran_pusch_init_enb(srsran_pusch_t* q, uint32_t max_prb);
@@ -136,4 +145,29 @@ SRSRAN_API uint32_t srsran_pusch_rx_info(srsran_pusch_cfg_t*    cfg,
                                          char*                  str,
                                          uint32_t               str_len);
 
+/**
+ * Orders the PUSCH of a subframe for decoding against a deadline: priority PUSCH first, in scheduling order otherwise
+ * @param priority Whether each PUSCH is a retransmission or carries UCI
+ * @param nof_pusch Number of PUSCH
+ * @param order Indexes of the PUSCH in decoding order
+ */
+SRSRAN_API void srsran_pusch_deadline_order(const bool* priority, uint32_t nof_pusch, uint32_t* order);
+
+/**
+ * Tells whether a PUSCH has to be shed, that is, not decoded at all. Priority PUSCH are never shed, the others when
+ * their expected decoding time does not fit before the deadline
+ * @param now_ns Current CLOCK_MONOTONIC time
+ * @param deadline_ns CLOCK_MONOTONIC time by which the subframe must be decoded
+ */
+SRSRAN_API bool srsran_pusch_deadline_shed(const srsran_pusch_deadline_t* q,
+                                           bool                           priority,
+                                           uint32_t                       nof_bits,
+                                           int64_t                        now_ns,
+                                           int64_t                        deadline_ns);
+
+/**
+ * Learns the decoding time from a decoded PUSCH
+ */
+SRSRAN_API void srsran_pusch_deadline_learn(srsran_pusch_deadline_t* q, uint32_t nof_bits, int64_t elapsed_ns);
+
 #endif // SRSRAN_PUSCH_H
@@ -25,6 +25,7 @@
 #include "srsran/phy/fec/softbuffer.h"
 #include "srsran/phy/phch/ra.h"
 #include "srsran/phy/phch/uci_cfg.h"
+#include <time.h>
 
 typedef struct SRSRAN_API {
   uint32_t I_offset_cqi;
@@ -83,6 +84,9 @@ typedef struct SRSRAN_API {
   bool meas_ta_en;
   bool meas_evm_en;
 
+  bool            deadline_en; ///< Cut turbo decoder iterations so that the TB is decoded before the deadline
+  struct timespec deadline;    ///< CLOCK_MONOTONIC time
+
 } srsran_pusch_cfg_t;
 
 #endif // SRSRAN_PUSCH_CFG_H
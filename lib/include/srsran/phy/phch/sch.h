@@ -54,6 +54,11 @@ typedef struct SRSRAN_API {
   uint32_t max_iterations;
   float    avg_iterations;
 
+  /* Deadline-aware decoding, code blocks share the time left and stop iterating when it runs out */
+  bool            deadline_en;
+  struct timespec deadline;
+  uint32_t        shed_iterations;
+
   bool llr_is_8bit;
 
   /* buffers */
@@ -61,7 +66,6 @@ typedef struct SRSRAN_API {
   uint8_t*         parity_bits;
   void*            e;
   uint8_t*         temp_g_bits;
-  uint32_t*        ul_interleaver;
   srsran_uci_bit_t ack_ri_bits[57600]; // 4*M_sc*Qm_max for RI and ACK
 
   srsran_tcod_t encoder;
@@ -81,6 +85,12 @@ SRSRAN_API void srsran_sch_set_max_noi(srsran_sch_t* q, uint32_t max_iterations)
 
 SRSRAN_API float srsran_sch_last_noi(srsran_sch_t* q);
 
+/**
+ * Sets the CLOCK_MONOTONIC time by which the next decoded transport block must be ready. Every code block still gets at
+ * least one turbo decoder iteration. NULL disables the deadline.
+ */
+SRSRAN_API void srsran_sch_set_deadline(srsran_sch_t* q, const struct timespec* deadline);
+
 SRSRAN_API int srsran_dlsch_encode(srsran_sch_t* q, srsran_pdsch_cfg_t* cfg, uint8_t* data, uint8_t* e_bits);
 
 SRSRAN_API int srsran_dlsch_encode2(srsran_sch_t*       q,
@@ -124,6 +134,27 @@ SRSRAN_API uint32_t srsran_sch_find_Ioffset_cqi(float beta);
 
 SRSRAN_API uint32_t srsran_sch_find_Ioffset_ri(float beta);
 
+///< PUSCH Interleaver, leaves the positions of ri_bits for RI. ri_present is a zeroed scratch buffer of
+///< H_prime_total * Qm bytes which is zeroed again on return
+SRSRAN_API void srsran_ulsch_interleave(uint8_t*          g_bits,
+                                        uint32_t          Qm,
+                                        uint32_t          H_prime_total,
+                                        uint32_t          N_pusch_symbs,
+                                        uint8_t*          q_bits,
+                                        srsran_uci_bit_t* ri_bits,
+                                        uint32_t          nof_ri_bits,
+                                        uint8_t*          ri_present);
+
+///< PUSCH Deinterleaver, skips the positions of ri_bits. Same ri_present requirements as the interleaver
+SRSRAN_API void srsran_ulsch_deinterleave(int16_t*          q_bits,
+                                          uint32_t          Qm,
+                                          uint32_t          H_prime_total,
+                                          uint32_t          N_pusch_symbs,
+                                          int16_t*          g_bits,
+                                          srsran_uci_bit_t* ri_bits,
+                                          uint32_t          nof_ri_bits,
+                                          uint8_t*          ri_present);
+
 ///< Sidelink uses PUSCH Interleaver in all channels
 SRSRAN_API void srsran_sl_ulsch_interleave(uint8_t* g_bits,
                                            uint32_t Qm,
@@ -132,11 +163,10 @@ SRSRAN_API void srsran_sl_ulsch_interleave(uint8_t* g_bits,
                                            uint8_t* q_bits);
 
 ///< Sidelink uses PUSCH Deinterleaver in all channels
-SRSRAN_API void srsran_sl_ulsch_deinterleave(int16_t*  q_bits,
-                                             uint32_t  Qm,
-                                             uint32_t  H_prime_total,
-                                             uint32_t  N_pusch_symbs,
-                                             int16_t*  g_bits,
-                                             uint32_t* inteleaver_lut);
+SRSRAN_API void srsran_sl_ulsch_deinterleave(int16_t* q_bits,
+                                             uint32_t Qm,
+                                             uint32_t H_prime_total,
+                                             uint32_t N_pusch_symbs,
+                                             int16_t* g_bits);
 
 #endif // SRSRAN_SCH_H
\ No newline at end of file
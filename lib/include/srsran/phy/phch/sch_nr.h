@@ -72,6 +72,9 @@ typedef struct SRSRAN_API {
   /// LDPC Rate matcher
   srsran_ldpc_rm_t tx_rm;
   srsran_ldpc_rm_t rx_rm;
+
+  /// Code block decoding coworkers, NULL if code blocks are decoded in the calling thread
+  void* coworker_ptr;
 } srsran_sch_nr_t;
 
 /**
@@ -81,7 +84,8 @@ typedef struct SRSRAN_API {
   bool     disable_simd;
   bool     decoder_use_flooded;
   float    decoder_scaling_factor;
-  uint32_t max_nof_iter; ///< Maximum number of LDPC iterations
+  uint32_t max_nof_iter;  ///< Maximum number of LDPC iterations
+  uint32_t nof_coworkers; ///< Number of extra threads decoding code blocks in parallel, set to 0 for none
 } srsran_sch_nr_args_t;
 
 /**
@@ -105,6 +105,84 @@ SRSRAN_API void srsran_resampler_fft_run(srsran_resampler_fft_t* q, const cf_t*
  */
 SRSRAN_API void srsran_resampler_fft_free(srsran_resampler_fft_t* q);
 
+/**
+ * Polyphase rational resampler internal buffers. The output rate is L/M times the input rate.
+ */
+typedef struct {
+  uint32_t L;         ///< Interpolation factor
+  uint32_t M;         ///< Decimation factor
+  uint32_t nof_taps;  ///< Taps of each polyphase branch
+  float*   bank;      ///< L branches of 2 x nof_taps time-reversed coefficients, each duplicated for I and Q
+  cf_t*    history;   ///< Last nof_taps - 1 input samples followed by the first samples of the current block
+  uint32_t phase;     ///< Polyphase branch of the next output sample
+  uint32_t next_in;   ///< Index of the newest input sample under the filter for the next output, in the next block
+} srsran_resampler_poly_t;
+
+/**
+ * Initialise a polyphase resampler for the rational ratio L/M, which is reduced internally. A Kaiser windowed sinc
+ * prototype filter is designed with its cut-off at the lowest of the input and output Nyquist frequencies.
+ * @param q Object pointer
+ * @param L Interpolation factor
+ * @param M Decimation factor
+ * @return SRSRAN_SUCCES if no error, otherwise an SRSRAN error code
+ */
+SRSRAN_API int srsran_resampler_poly_init(srsran_resampler_poly_t* q, uint32_t L, uint32_t M);
+
+/**
+ * @brief resets internal re-sampler state
+ * @param q Object pointer
+ */
+SRSRAN_API void srsran_resampler_poly_reset_state(srsran_resampler_poly_t* q);
+
+/**
+ * Get delay from the polyphase resampler.
+ * @param q Object pointer
+ * @return the delay in number of output samples
+ */
+SRSRAN_API uint32_t srsran_resampler_poly_get_delay(srsran_resampler_poly_t* q);
+
+/**
+ * Get the number of input samples that produce nof_output samples from the current state. It is exact when the
+ * output block ends on an input sample, e.g. whole subframes; otherwise the outputs sharing the last input sample are
+ * produced in the next block.
+ * @param q Object pointer
+ * @param nof_output Number of output samples
+ * @return the number of input samples
+ */
+SRSRAN_API uint32_t srsran_resampler_poly_nof_input(srsran_resampler_poly_t* q, uint32_t nof_output);
+
+/**
+ * Get the number of output samples that nof_input samples produce from the current state
+ * @param q Object pointer
+ * @param nof_input Number of input samples
+ * @return the number of output samples
+ */
+SRSRAN_API uint32_t srsran_resampler_poly_nof_output(srsran_resampler_poly_t* q, uint32_t nof_input);
+
+/**
+ * @brief Run the polyphase resampler on a block of samples, keeping the filter state across blocks.
+ *
+ * @note Setting the input to NULL is equivalent of feeding zeroes
+ * @note Setting the output to NULL is equivalent of dropping output samples
+ * @note It does not run in place, the output buffer must not overlap the input
+ *
+ * @param q Object pointer, make sure it has been initialised
+ * @param input Points at the input complex buffer
+ * @param output Points at the output complex buffer, at least srsran_resampler_poly_nof_output() long
+ * @param nsamples Number of input samples
+ * @return the number of output samples
+ */
+SRSRAN_API uint32_t srsran_resampler_poly_run(srsran_resampler_poly_t* q,
+                                              const cf_t*              input,
+                                              cf_t*                    output,
+                                              uint32_t                 nsamples);
+
+/**
+ * Free polyphase resampler buffers
+ * @param q  Object pointer
+ */
+SRSRAN_API void srsran_resampler_poly_free(srsran_resampler_poly_t* q);
+
 #ifdef __cplusplus
 }
 #endif
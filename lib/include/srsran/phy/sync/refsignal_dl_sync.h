@@ -35,6 +35,12 @@ typedef struct {
   cf_t*                correlation;
   srsran_conv_fft_cc_t conv_fft_cc;
 
+  // Frequency domain correlation windows shared by all the cells measured over the same buffer
+  cf_t*       input_fft[SRSRAN_NOF_SF_X_FRAME];
+  const cf_t* input_fft_buffer;
+  uint32_t    input_fft_nsamples;
+  uint32_t    input_fft_sf_len;
+
   // Results
   bool     found;
   float    rsrp_dBfs;
@@ -50,6 +56,20 @@ SRSRAN_API int srsran_refsignal_dl_sync_set_cell(srsran_refsignal_dl_sync_t* q,
 
 SRSRAN_API void srsran_refsignal_dl_sync_free(srsran_refsignal_dl_sync_t* q);
 
+/**
+ * Transforms the correlation windows of a base-band buffer into frequency domain and keeps them in the object, so
+ * consecutive srsran_refsignal_dl_sync_run() calls over the same buffer, and with the same bandwidth, skip the input FFT
+ * for every cell. The cell bandwidth shall be set before loading. The buffer must be loaded again every time its content
+ * changes, or unloaded with srsran_refsignal_dl_sync_unload_buffer().
+ * @param q Object
+ * @param buffer Base-band buffer that will be measured
+ * @param nsamples Number of samples in the buffer
+ * @return SRSRAN_SUCCESS if the buffer is loaded, SRSRAN_ERROR code otherwise
+ */
+SRSRAN_API int srsran_refsignal_dl_sync_load_buffer(srsran_refsignal_dl_sync_t* q, const cf_t* buffer, uint32_t nsamples);
+
+SRSRAN_API void srsran_refsignal_dl_sync_unload_buffer(srsran_refsignal_dl_sync_t* q);
+
 SRSRAN_API void srsran_refsignal_dl_sync_run(srsran_refsignal_dl_sync_t* q, cf_t* buffer, uint32_t nsamples);
 
 SRSRAN_API void srsran_refsignal_dl_sync_measure_sf(srsran_refsignal_dl_sync_t* q,
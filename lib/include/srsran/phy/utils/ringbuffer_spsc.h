@@ -0,0 +1,103 @@
+/**
+ * Copyright 2013-2021 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+/******************************************************************************
+ *  File:         ringbuffer_spsc.h
+ *
+ *  Description:  Lock-free single-producer single-consumer ring buffer.
+ *
+ *                The buffer memory is mapped twice in a row, so any region of
+ *                up to capacity bytes is contiguous across the wrap-around and
+ *                can be accessed in place with peek/release and
+ *                write_begin/write_commit. Readers and writers only sleep, on
+ *                a futex, when the buffer is empty or full respectively.
+ *
+ *                Only one thread may write and only one thread may read at a
+ *                time. Reset and resize must not run concurrently with them.
+ *****************************************************************************/
+
+#ifndef SRSRAN_RINGBUFFER_SPSC_H
+#define SRSRAN_RINGBUFFER_SPSC_H
+
+#include "srsran/config.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+typedef struct {
+  uint8_t* buffer;   // Mapped twice, 2 * capacity bytes of address space
+  uint32_t capacity; // Rounded up to a multiple of the page size
+  bool     active;
+
+  // Positions only grow, the producer owns wpos and the consumer rpos
+  uint64_t wpos;
+  uint64_t rpos;
+
+  // Futex words, incremented whenever the other side is waiting and the position it waits on changes
+  uint32_t write_seq;
+  uint32_t read_seq;
+  uint32_t reader_waiting;
+  uint32_t writer_waiting;
+} srsran_ringbuffer_spsc_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+SRSRAN_API int srsran_ringbuffer_spsc_init(srsran_ringbuffer_spsc_t* q, int capacity);
+
+SRSRAN_API void srsran_ringbuffer_spsc_free(srsran_ringbuffer_spsc_t* q);
+
+SRSRAN_API void srsran_ringbuffer_spsc_reset(srsran_ringbuffer_spsc_t* q);
+
+SRSRAN_API int srsran_ringbuffer_spsc_resize(srsran_ringbuffer_spsc_t* q, int capacity);
+
+SRSRAN_API int srsran_ringbuffer_spsc_status(srsran_ringbuffer_spsc_t* q);
+
+SRSRAN_API int srsran_ringbuffer_spsc_space(srsran_ringbuffer_spsc_t* q);
+
+// Copies nof_bytes into the buffer, zeros if ptr is NULL. A timeout_ms of 0 writes what fits and drops the rest, a
+// negative one blocks until there is enough space
+SRSRAN_API int
+srsran_ringbuffer_spsc_write(srsran_ringbuffer_spsc_t* q, const void* ptr, int nof_bytes, int32_t timeout_ms);
+
+// Waits for nof_bytes of space and returns where to write them in place, NULL on timeout or stop. A timeout_ms <= 0
+// blocks until there is enough space
+SRSRAN_API void* srsran_ringbuffer_spsc_write_begin(srsran_ringbuffer_spsc_t* q, int nof_bytes, int32_t timeout_ms);
+
+// Publishes nof_bytes written in place after srsran_ringbuffer_spsc_write_begin()
+SRSRAN_API void srsran_ringbuffer_spsc_write_commit(srsran_ringbuffer_spsc_t* q, int nof_bytes);
+
+// Waits for nof_bytes and copies them out, a timeout_ms <= 0 blocks until they are available
+SRSRAN_API int srsran_ringbuffer_spsc_read(srsran_ringbuffer_spsc_t* q, void* ptr, int nof_bytes, int32_t timeout_ms);
+
+// Waits for nof_bytes and points p at them, they stay valid until srsran_ringbuffer_spsc_release()
+SRSRAN_API int srsran_ringbuffer_spsc_peek(srsran_ringbuffer_spsc_t* q, void** p, int nof_bytes, int32_t timeout_ms);
+
+SRSRAN_API void srsran_ringbuffer_spsc_release(srsran_ringbuffer_spsc_t* q, int nof_bytes);
+
+// Wakes up any blocked read or write, they return 0 bytes
+SRSRAN_API void srsran_ringbuffer_spsc_stop(srsran_ringbuffer_spsc_t* q);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SRSRAN_RINGBUFFER_SPSC_H
@@ -0,0 +1,69 @@
+/**
+ * Copyright 2013-2021 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+/******************************************************************************
+ *  File:         simd_isa.h
+ *
+ *  Description:  Run-time SIMD instruction set selection.
+ *
+ *                By default the SIMD width is fixed at compile time by the
+ *                LV_HAVE_* flags. When the library is built with
+ *                ENABLE_SIMD_DISPATCH, the baseline is SSE4.1 and the vector
+ *                kernels are additionally built for AVX, AVX2 and AVX512, the
+ *                LDPC kernels for AVX2 and AVX512 and the turbo, polar and
+ *                Viterbi kernels for AVX2. The vector kernels are bound to the
+ *                best ISA the CPU supports when the library is loaded, the FEC
+ *                kernels are selected when their encoder/decoder is created.
+ *****************************************************************************/
+
+#ifndef SRSRAN_SIMD_ISA_H
+#define SRSRAN_SIMD_ISA_H
+
+#include "srsran/config.h"
+#include <stdbool.h>
+
+typedef enum {
+  SRSRAN_SIMD_ISA_NONE = 0,
+  SRSRAN_SIMD_ISA_NEON,
+  SRSRAN_SIMD_ISA_SSE,
+  SRSRAN_SIMD_ISA_AVX,
+  SRSRAN_SIMD_ISA_AVX2,
+  SRSRAN_SIMD_ISA_AVX512,
+  SRSRAN_SIMD_ISA_NOF
+} srsran_simd_isa_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// True if the library contains kernels for the ISA and the CPU can run them
+SRSRAN_API bool srsran_simd_isa_available(srsran_simd_isa_t isa);
+
+// ISA used by the srsran_vec_* kernels
+SRSRAN_API srsran_simd_isa_t srsran_vec_simd_isa(void);
+
+SRSRAN_API const char* srsran_simd_isa_to_str(srsran_simd_isa_t isa);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SRSRAN_SIMD_ISA_H
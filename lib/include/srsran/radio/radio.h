@@ -111,6 +111,17 @@ private:
   std::array<srsran_resampler_fft_t, SRSRAN_MAX_CHANNELS> decimators    = {};
   bool decimator_busy = false; ///< Indicates the decimator is changing the rate
 
+  // Rational rate adapters, used instead of the decimators and interpolators when the fixed sampling rate is not an
+  // integer multiple of the requested one
+  std::array<srsran_resampler_poly_t, SRSRAN_MAX_CHANNELS> rx_rate_adapters = {};
+  std::array<srsran_resampler_poly_t, SRSRAN_MAX_CHANNELS> tx_rate_adapters = {};
+  bool                                                     rx_rate_adapt    = false;
+  bool                                                     tx_rate_adapt    = false;
+  // Rx rate adapter outputs. Whole input samples may give more outputs than requested, those are delivered first in
+  // the next reception
+  std::array<std::vector<cf_t>, SRSRAN_MAX_CHANNELS> rx_adapt_buffer;
+  uint32_t                                           rx_adapt_pending = 0;
+
   rf_timestamp_t end_of_burst_time  = {};
   bool           is_start_of_burst  = false;
   uint32_t       tx_adv_nsamples    = 0;
@@ -192,6 +203,20 @@ private:
    */
   bool rx_dev(const uint32_t& device_idx, const rf_buffer_interface& buffer, srsran_timestamp_t* rxd_time);
 
+  /**
+   * Initialises the rate adapters if the device sampling rate is not an integer multiple of the requested one
+   *
+   * @param adapters Rate adapter of each channel
+   * @param dev_srate Device sampling rate in Hz
+   * @param srate Requested sampling rate in Hz
+   * @param tx Set for transmission, the adapters go from the requested to the device rate
+   * @return true if the rate adapters shall be used, false otherwise
+   */
+  bool init_rate_adapters(std::array<srsran_resampler_poly_t, SRSRAN_MAX_CHANNELS>& adapters,
+                          double                                                    dev_srate,
+                          double                                                    srate,
+                          bool                                                      tx);
+
   /**
    * Helper method for mapping logical channels into physical radio buffers.
    *
@@ -23,102 +23,199 @@
  * @file byte_buffer_queue.h
  *
  * @brief Queue of unique pointers to byte buffers used in PDCP and RLC TX queues.
- *        Uses a blocking queue with bounded capacity to block higher layers
- *        when pushing uplink traffic
+ *        Bounded lock-free single-producer/single-consumer ring. The producer (PDCP/stack thread) writes and
+ *        discards SDUs, while the consumer (MAC read_pdu) reads them, without either side blocking the other.
+ *        The byte and SDU counters used for the BSR are updated atomically by both sides.
+ *        Operations of the consumer side issued from other threads (e.g. clearing the queue in RLC stop()) must be
+ *        serialized with the consumer by the caller.
  */
 
 #ifndef SRSRAN_BYTE_BUFFERQUEUE_H
 #define SRSRAN_BYTE_BUFFERQUEUE_H
 
-#include "srsran/adt/circular_buffer.h"
-#include "srsran/common/block_queue.h"
+#include "srsran/adt/expected.h"
 #include "srsran/common/byte_buffer.h"
 #include "srsran/common/common.h"
-#include <functional>
-#include <pthread.h>
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <unistd.h>
 
 namespace srsran {
 
 class byte_buffer_queue
 {
 public:
-  byte_buffer_queue(int capacity = 128) :
-    queue(capacity, push_callback(unread_bytes, n_sdus), pop_callback(unread_bytes, n_sdus))
-  {}
+  explicit byte_buffer_queue(uint32_t capacity = 128) { resize(capacity); }
 
-  void write(unique_byte_buffer_t msg) { queue.push_blocking(std::move(msg)); }
+  /// Blocking write. Waits until there is space in the queue
+  void write(unique_byte_buffer_t msg)
+  {
+    for (uint32_t count = 0; is_full(); ++count) {
+      wait_(count);
+    }
+    push_(std::move(msg));
+  }
 
   srsran::error_type<unique_byte_buffer_t> try_write(unique_byte_buffer_t&& msg)
   {
-    return queue.try_push(std::move(msg));
+    if (is_full()) {
+      return std::move(msg);
+    }
+    push_(std::move(msg));
+    return {};
   }
 
-  unique_byte_buffer_t read() { return queue.pop_blocking(); }
-
-  bool try_read(unique_byte_buffer_t* msg) { return queue.try_pop(*msg); }
+  /// Blocking read. Waits until there is an SDU in the queue. Returns nullptr if all the remaining SDUs were discarded
+  unique_byte_buffer_t read()
+  {
+    for (uint32_t count = 0; head.load(std::memory_order_relaxed) == tail.load(std::memory_order_acquire); ++count) {
+      wait_(count);
+    }
+    unique_byte_buffer_t msg;
+    pop_(&msg);
+    return msg;
+  }
 
-  void     resize(uint32_t capacity) { queue.set_size(capacity); }
-  uint32_t size() { return (uint32_t)queue.size(); }
-  uint32_t get_n_sdus() { return n_sdus; }
+  bool try_read(unique_byte_buffer_t* msg) { return pop_(msg); }
 
-  uint32_t size_bytes() { return unread_bytes; }
+  /// Discards the first queued SDU with the given PDCP SN. Must be called from the producer side
+  bool discard(uint32_t pdcp_sn)
+  {
+    uint32_t t = tail.load(std::memory_order_relaxed);
+    for (uint32_t i = head.load(std::memory_order_acquire); i != t; ++i) {
+      slot_t& slot = slots[i % capacity];
+      if (slot.pdcp_sn != pdcp_sn) {
+        continue;
+      }
+      uint8_t expected = slot_t::queued;
+      if (slot.state.compare_exchange_strong(expected, slot_t::discarded, std::memory_order_acq_rel)) {
+        // the consumer will skip it and release the buffer
+        unread_bytes.fetch_sub(slot.nof_bytes, std::memory_order_relaxed);
+        n_sdus.fetch_sub(1, std::memory_order_relaxed);
+        return true;
+      }
+    }
+    return false;
+  }
 
-  uint32_t size_tail_bytes()
+  /// Sets the queue capacity, keeping the queued SDUs that fit. Must not be called concurrently with other operations
+  void resize(uint32_t capacity_)
   {
-    uint32_t size_next = 0;
-    queue.try_call_on_front([&size_next](const unique_byte_buffer_t& front_val) {
-      if (front_val != nullptr) {
-        size_next += front_val->N_bytes;
+    std::unique_ptr<slot_t[]> new_slots(new slot_t[capacity_]);
+    uint32_t                  n = 0, bytes = 0;
+    for (uint32_t i = head.load(std::memory_order_relaxed); i != tail.load(std::memory_order_relaxed); ++i) {
+      slot_t& slot = slots[i % capacity];
+      if (slot.state.load(std::memory_order_relaxed) == slot_t::queued and n < capacity_) {
+        new_slots[n].msg       = std::move(slot.msg);
+        new_slots[n].pdcp_sn   = slot.pdcp_sn;
+        new_slots[n].nof_bytes = slot.nof_bytes;
+        new_slots[n].state.store(slot_t::queued, std::memory_order_relaxed);
+        bytes += slot.nof_bytes;
+        n++;
       }
-    });
-    return size_next;
+    }
+    slots    = std::move(new_slots);
+    capacity = capacity_;
+    head.store(0, std::memory_order_relaxed);
+    tail.store(n, std::memory_order_relaxed);
+    unread_bytes.store(bytes, std::memory_order_relaxed);
+    n_sdus.store(n, std::memory_order_relaxed);
   }
 
-  // This is a hack to reset N_bytes counter when queue is corrupted (see line 89)
-  void reset() { unread_bytes = 0; }
+  /// Releases all the SDUs in the queue. Must be called from the consumer side
+  void clear()
+  {
+    unique_byte_buffer_t msg;
+    while (pop_(&msg)) {
+    }
+  }
 
-  bool is_empty() { return queue.empty(); }
+  /// Number of occupied slots, including the discarded SDUs not yet released
+  uint32_t size() { return tail.load(std::memory_order_acquire) - head.load(std::memory_order_acquire); }
+  uint32_t get_n_sdus() { return n_sdus.load(std::memory_order_relaxed); }
 
-  bool is_full() { return queue.full(); }
+  uint32_t size_bytes() { return unread_bytes.load(std::memory_order_relaxed); }
 
-  template <typename F>
-  bool apply_first(const F& func)
+  /// Size of the next SDU to be read. Must be called from the consumer side
+  uint32_t size_tail_bytes()
   {
-    return queue.apply_first(func);
+    uint32_t t = tail.load(std::memory_order_acquire);
+    for (uint32_t i = head.load(std::memory_order_relaxed); i != t; ++i) {
+      const slot_t& slot = slots[i % capacity];
+      if (slot.state.load(std::memory_order_acquire) == slot_t::queued) {
+        return slot.nof_bytes;
+      }
+    }
+    return 0;
   }
 
+  bool is_empty() { return get_n_sdus() == 0; }
+
+  bool is_full() { return size() >= capacity; }
+
 private:
-  struct push_callback {
-    explicit push_callback(uint32_t& unread_bytes_, uint32_t& n_sdus_) : unread_bytes(&unread_bytes_), n_sdus(&n_sdus_)
-    {}
-    void operator()(const unique_byte_buffer_t& msg)
-    {
-      *unread_bytes += msg->N_bytes;
-      (*n_sdus)++;
-    }
-    uint32_t* unread_bytes;
-    uint32_t* n_sdus;
+  struct slot_t {
+    enum state_t : uint8_t { queued, taken, discarded };
+    unique_byte_buffer_t msg;
+    // copies of the SDU fields, so that the producer does not access a buffer that the consumer may be releasing
+    uint32_t             pdcp_sn   = 0;
+    uint32_t             nof_bytes = 0;
+    std::atomic<uint8_t> state{taken};
   };
-  struct pop_callback {
-    explicit pop_callback(uint32_t& unread_bytes_, uint32_t& n_sdus_) : unread_bytes(&unread_bytes_), n_sdus(&n_sdus_)
-    {}
-    void operator()(const unique_byte_buffer_t& msg)
-    {
-      if (msg == nullptr) {
-        return;
+
+  /// Called by the producer, once it checked there is space in the queue
+  void push_(unique_byte_buffer_t msg)
+  {
+    uint32_t t     = tail.load(std::memory_order_relaxed);
+    slot_t&  slot  = slots[t % capacity];
+    uint32_t bytes = msg != nullptr ? msg->N_bytes : 0;
+    slot.pdcp_sn   = msg != nullptr ? msg->md.pdcp_sn : 0;
+    slot.nof_bytes = bytes;
+    slot.msg       = std::move(msg);
+    slot.state.store(slot_t::queued, std::memory_order_relaxed);
+    // counters are incremented before the SDU is visible, so that the consumer never makes them negative
+    unread_bytes.fetch_add(bytes, std::memory_order_relaxed);
+    n_sdus.fetch_add(1, std::memory_order_relaxed);
+    tail.store(t + 1, std::memory_order_release);
+  }
+
+  /// Called by the consumer. Skips and releases the discarded SDUs
+  bool pop_(unique_byte_buffer_t* msg)
+  {
+    uint32_t h = head.load(std::memory_order_relaxed);
+    uint32_t t = tail.load(std::memory_order_acquire);
+    for (; h != t; ++h) {
+      slot_t& slot     = slots[h % capacity];
+      uint8_t expected = slot_t::queued;
+      if (slot.state.compare_exchange_strong(expected, slot_t::taken, std::memory_order_acq_rel)) {
+        *msg = std::move(slot.msg);
+        unread_bytes.fetch_sub(slot.nof_bytes, std::memory_order_relaxed);
+        n_sdus.fetch_sub(1, std::memory_order_relaxed);
+        head.store(h + 1, std::memory_order_release);
+        return true;
       }
-      *unread_bytes -= std::min(msg->N_bytes, *unread_bytes);
-      *n_sdus = std::max(0, (int32_t)(*n_sdus) - 1);
+      slot.msg.reset();
+      head.store(h + 1, std::memory_order_release);
     }
-    uint32_t* unread_bytes;
-    uint32_t* n_sdus;
-  };
+    return false;
+  }
 
-  uint32_t unread_bytes = 0;
-  uint32_t n_sdus       = 0;
+  static void wait_(uint32_t count)
+  {
+    if (count < 64) {
+      std::this_thread::yield();
+    } else {
+      usleep(100);
+    }
+  }
 
-public:
-  dyn_blocking_queue<unique_byte_buffer_t, push_callback, pop_callback> queue;
+  std::unique_ptr<slot_t[]> slots;
+  uint32_t                  capacity = 0;
+  std::atomic<uint32_t>     head{0}; ///< only written by the consumer
+  std::atomic<uint32_t>     tail{0}; ///< only written by the producer
+  std::atomic<uint32_t>     unread_bytes{0};
+  std::atomic<uint32_t>     n_sdus{0};
 };
 
 } // namespace srsran
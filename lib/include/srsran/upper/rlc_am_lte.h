@@ -35,6 +35,8 @@
 #include "srsran/upper/byte_buffer_queue.h"
 #include "srsran/upper/rlc_am_base.h"
 #include "srsran/upper/rlc_common.h"
+#include "srsran/upper/rlc_sdu_gather_list.h"
+#include <atomic>
 #include <deque>
 #include <list>
 #include <map>
@@ -98,10 +100,74 @@ struct rlc_amd_rx_pdu {
   explicit rlc_amd_rx_pdu(uint32_t rlc_sn_) : rlc_sn(rlc_sn_) {}
 };
 
-struct rlc_amd_rx_pdu_segments_t {
-  std::list<rlc_amd_rx_pdu> segments;
+/// RLC AM PDU segment received, linked either to the segment list of its SN or to the free list of the pool
+struct rlc_amd_rx_pdu_segment : public rlc_amd_rx_pdu, public intrusive_forward_list_element<> {};
+
+/// Pool of RX PDU segments. Segments are allocated on first use and recycled afterwards, so that the reception of
+/// segments does not allocate in steady state
+class rlc_am_rx_segment_pool
+{
+public:
+  const static size_t MAX_POOL_SIZE = RLC_AM_WINDOW_SIZE * 4;
+
+  rlc_am_rx_segment_pool()                              = default;
+  rlc_am_rx_segment_pool(const rlc_am_rx_segment_pool&) = delete;
+  rlc_am_rx_segment_pool& operator=(const rlc_am_rx_segment_pool&) = delete;
+
+  /// Returns an empty segment, or nullptr if the pool is exhausted
+  rlc_amd_rx_pdu_segment* allocate();
+  void                    deallocate(rlc_amd_rx_pdu_segment* segment);
+  size_t                  capacity() const { return segments.size(); }
+
+private:
+  intrusive_forward_list<rlc_amd_rx_pdu_segment>       free_list;
+  std::vector<std::unique_ptr<rlc_amd_rx_pdu_segment>> segments;
+};
+
+/// List of the received segments of a RLC PDU, sorted by segment offset
+class rlc_amd_rx_pdu_segments_t
+{
+  using list_type = intrusive_forward_list<rlc_amd_rx_pdu_segment>;
+
+public:
+  using iterator       = typename list_type::iterator;
+  using const_iterator = typename list_type::const_iterator;
+
+  explicit rlc_amd_rx_pdu_segments_t(rlc_am_rx_segment_pool& pool_) : pool(&pool_) {}
+  rlc_amd_rx_pdu_segments_t(const rlc_amd_rx_pdu_segments_t&) = delete;
+  rlc_amd_rx_pdu_segments_t(rlc_amd_rx_pdu_segments_t&& other) noexcept;
+  rlc_amd_rx_pdu_segments_t& operator=(const rlc_amd_rx_pdu_segments_t&) = delete;
+  rlc_amd_rx_pdu_segments_t& operator=(rlc_amd_rx_pdu_segments_t&& other) noexcept;
+  ~rlc_amd_rx_pdu_segments_t() { clear(); }
+
+  /// Inserts the segment sorted by SO. If a segment with the same SO exists, the bigger one is kept
+  void insert(rlc_amd_rx_pdu_segment* segment);
+  /// Removes the segment following "pos", or the first one if "pos" is nullptr, and returns it to the pool
+  void erase_after(rlc_amd_rx_pdu_segment* pos);
+  void clear();
+
+  rlc_amd_rx_pdu_segment&       front() { return list.front(); }
+  const rlc_amd_rx_pdu_segment& front() const { return list.front(); }
+  rlc_amd_rx_pdu_segment&       back() { return *last; }
+  const rlc_amd_rx_pdu_segment& back() const { return *last; }
+  size_t                        size() const { return count; }
+  bool                          empty() const { return count == 0; }
+
+  iterator       begin() { return list.begin(); }
+  iterator       end() { return list.end(); }
+  const_iterator begin() const { return list.begin(); }
+  const_iterator end() const { return list.end(); }
+
+private:
+  rlc_am_rx_segment_pool* pool  = nullptr;
+  list_type               list;
+  rlc_amd_rx_pdu_segment* last  = nullptr;
+  size_t                  count = 0;
 };
 
+/// Segment lists of the RLC PDUs pending reassembly, indexed by SN
+using rlc_amd_rx_segment_window_t = static_circular_map<uint32_t, rlc_amd_rx_pdu_segments_t, RLC_AM_WINDOW_SIZE>;
+
 /// Class that contains the parameters and state (e.g. segments) of a RLC PDU
 class rlc_amd_tx_pdu
 {
@@ -425,7 +491,10 @@ private:
     byte_buffer_queue    tx_sdu_queue;
     unique_byte_buffer_t tx_sdu;
 
-    bool tx_enabled = false;
+    // SDU fragments of the data PDU being built
+    rlc_sdu_gather_list pdu_gather;
+
+    std::atomic<bool> tx_enabled{false};
 
     /****************************************************************************
      * State variables and counters
@@ -502,7 +571,7 @@ private:
     bool inside_rx_window(const int16_t sn);
     void debug_state();
     void print_rx_segments();
-    bool add_segment_and_check(rlc_amd_rx_pdu_segments_t* pdu, rlc_amd_rx_pdu* segment);
+    bool add_segment_and_check(rlc_amd_rx_pdu_segments_t* pdu, rlc_amd_rx_pdu_segment* segment);
 
     rlc_am_lte*           parent = nullptr;
     byte_buffer_pool*     pool   = nullptr;
@@ -533,8 +602,9 @@ private:
     std::mutex mutex;
 
     // Rx windows
-    rlc_ringbuffer_t<rlc_amd_rx_pdu>              rx_window;
-    std::map<uint32_t, rlc_amd_rx_pdu_segments_t> rx_segments;
+    rlc_ringbuffer_t<rlc_amd_rx_pdu> rx_window;
+    rlc_am_rx_segment_pool           rx_segment_pool;
+    rlc_amd_rx_segment_window_t      rx_segments;
 
     bool poll_received = false;
     bool do_status     = false;
@@ -0,0 +1,105 @@
+/**
+ * Copyright 2013-2021 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#ifndef SRSRAN_RLC_SDU_GATHER_LIST_H
+#define SRSRAN_RLC_SDU_GATHER_LIST_H
+
+#include "srsran/common/byte_buffer.h"
+#include <string.h>
+#include <vector>
+
+namespace srsran {
+
+/**
+ * Scatter-gather list of the SDU fragments that compose the payload of a RLC data PDU.
+ *
+ * While the PDU header is being built, SDU bytes are only referenced. Once the header is known, the fragments are
+ * gathered straight into the MAC PDU payload, so each SDU byte is copied once. SDUs whose last byte has been referenced
+ * are held by the list until the fragments are gathered, keeping the referenced memory valid.
+ * The internal storage is reused between PDUs, so it does not allocate once it has grown to the maximum number of
+ * SDUs per PDU.
+ */
+class rlc_sdu_gather_list
+{
+public:
+  /// References the next "len" bytes of the SDU and advances its read pointer. Takes ownership of the SDU if emptied
+  void add_fragment(unique_byte_buffer_t& sdu, uint32_t len)
+  {
+    fragments.push_back(fragment_t{sdu->msg, len});
+    nof_bytes_ += len;
+    sdu->msg += len;
+    sdu->N_bytes -= len;
+    if (sdu->N_bytes == 0) {
+      held_sdus.push_back(std::move(sdu));
+    }
+  }
+
+  /// Copies all the referenced fragments to "dst", releases the held SDUs and returns the number of copied bytes
+  uint32_t gather(uint8_t* dst)
+  {
+    uint32_t n = 0;
+    for (const fragment_t& f : fragments) {
+      memcpy(dst + n, f.ptr, f.len);
+      n += f.len;
+    }
+    clear();
+    return n;
+  }
+
+  /// If the PDU consists of a single fragment that ends its SDU, returns that SDU trimmed to the fragment, so the caller
+  /// can keep it instead of a copy of the PDU data. Returns nullptr otherwise. The fragment is still gathered
+  unique_byte_buffer_t take_single_sdu()
+  {
+    if (fragments.size() != 1 || held_sdus.size() != 1) {
+      return nullptr;
+    }
+    unique_byte_buffer_t sdu = std::move(held_sdus.back());
+    held_sdus.pop_back();
+    sdu->msg     = const_cast<uint8_t*>(fragments.front().ptr);
+    sdu->N_bytes = fragments.front().len;
+    return sdu;
+  }
+
+  void clear()
+  {
+    fragments.clear();
+    held_sdus.clear();
+    nof_bytes_ = 0;
+  }
+
+  uint32_t nof_bytes() const { return nof_bytes_; }
+  size_t   nof_fragments() const { return fragments.size(); }
+  bool     empty() const { return fragments.empty(); }
+
+private:
+  struct fragment_t {
+    const uint8_t* ptr;
+    uint32_t       len;
+  };
+
+  std::vector<fragment_t>           fragments;
+  std::vector<unique_byte_buffer_t> held_sdus;
+  uint32_t                          nof_bytes_ = 0;
+};
+
+} // namespace srsran
+
+#endif // SRSRAN_RLC_SDU_GATHER_LIST_H
@@ -116,7 +116,8 @@ protected:
     srsran::rolling_average<double> mean_pdu_latency_us;
 #endif
 
-    virtual int build_data_pdu(unique_byte_buffer_t pdu, uint8_t* payload, uint32_t nof_bytes) = 0;
+    // Writes the PDU header and gathers the SDU bytes straight into the MAC payload
+    virtual int build_data_pdu_in_place(uint8_t* payload, uint32_t nof_bytes) = 0;
 
     // helper functions
     virtual void debug_state() = 0;
@@ -25,6 +25,7 @@
 #include "srsran/common/buffer_pool.h"
 #include "srsran/common/common.h"
 #include "srsran/upper/byte_buffer_queue.h"
+#include "srsran/upper/rlc_sdu_gather_list.h"
 #include "srsran/upper/rlc_um_base.h"
 #include <map>
 #include <mutex>
@@ -57,12 +58,16 @@ private:
     rlc_um_lte_tx(rlc_um_base* parent_);
 
     bool     configure(const rlc_config_t& cfg, std::string rb_name);
-    int      build_data_pdu(unique_byte_buffer_t pdu, uint8_t* payload, uint32_t nof_bytes);
+    int      build_data_pdu_in_place(uint8_t* payload, uint32_t nof_bytes);
     uint32_t get_buffer_state();
     bool     sdu_queue_is_full();
 
   private:
     void reset();
+    void log_sdu_scheduled();
+
+    // SDU fragments of the PDU being built
+    rlc_sdu_gather_list pdu_gather;
 
     /****************************************************************************
      * State variables and counters
@@ -127,6 +132,7 @@ void rlc_um_read_data_pdu_header(uint8_t*              payload,
                                  rlc_umd_sn_size_t     sn_size,
                                  rlc_umd_pdu_header_t* header);
 void rlc_um_write_data_pdu_header(rlc_umd_pdu_header_t* header, byte_buffer_t* pdu);
+uint32_t rlc_um_write_data_pdu_header(rlc_umd_pdu_header_t* header, uint8_t* payload);
 
 uint32_t rlc_um_packed_length(rlc_umd_pdu_header_t* header);
 bool     rlc_um_start_aligned(uint8_t fi);
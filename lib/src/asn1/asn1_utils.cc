@@ -20,6 +20,7 @@
  */
 
 #include "srsran/asn1/asn1_utils.h"
+#include <endian.h>
 
 namespace asn1 {
 
@@ -109,6 +110,27 @@ map_enum_number<const int64_t>(const int64_t* array, uint32_t nof_types, uint32_
 template const float
 map_enum_number<const float>(const float* array, uint32_t nof_types, uint32_t enum_val, const char* enum_type);
 
+/*********************
+     arena memory
+*********************/
+
+static thread_local srsran::linear_allocator* current_arena = nullptr;
+
+srsran::linear_allocator* get_arena()
+{
+  return current_arena;
+}
+
+arena_scope::arena_scope(srsran::linear_allocator& arena) : prev_arena(current_arena)
+{
+  current_arena = &arena;
+}
+
+arena_scope::~arena_scope()
+{
+  current_arena = prev_arena;
+}
+
 /*********************
        bit_ref
 *********************/
@@ -139,12 +161,36 @@ int bit_ref_impl<Ptr>::distance_bytes() const
   return ((int)(ptr - start_ptr)) + ((offset) ? 1 : 0);
 }
 
+/// Load/store of the 8 bytes at p as a big-endian word, so that the first bit of the buffer is the word MSB
+static inline uint64_t load_be64(const uint8_t* p)
+{
+  uint64_t w;
+  memcpy(&w, p, sizeof(w));
+  return be64toh(w);
+}
+static inline void store_be64(uint8_t* p, uint64_t w)
+{
+  w = htobe64(w);
+  memcpy(p, &w, sizeof(w));
+}
+
 SRSASN_CODE bit_ref::pack(uint64_t val, uint32_t n_bits)
 {
   if (n_bits >= 64) {
     log_error("This method only supports packing up to 64 bits");
     return SRSASN_ERROR_ENCODE_FAIL;
   }
+  // Fast path: write the whole field with a single word store. Like the byte loop below, the bits that follow the
+  // field are zeroed, here up to the end of the word, as they are not part of the encoded message yet
+  uint32_t total_bits = offset + n_bits;
+  if (n_bits > 0 and total_bits <= 64 and max_ptr - ptr >= 8) {
+    uint64_t keep = (offset > 0) ? ((uint64_t)(*ptr & (uint8_t)(0xffu << (8u - offset))) << 56u) : 0;
+    val &= (1ul << n_bits) - 1ul;
+    store_be64(ptr, keep | (val << (64u - total_bits)));
+    ptr += total_bits / 8;
+    offset = total_bits % 8;
+    return SRSASN_SUCCESS;
+  }
   uint64_t mask;
   while (n_bits > 0) {
     if (ptr >= max_ptr) {
@@ -178,6 +224,14 @@ SRSASN_CODE unpack_bits(T& val, Ptr& ptr, uint8_t& offset, const uint8_t* max_pt
     return SRSASN_ERROR_DECODE_FAIL;
   }
   val = 0;
+  // Fast path: extract the whole field from a single word load
+  uint32_t total_bits = offset + n_bits;
+  if (n_bits > 0 and total_bits <= 64 and max_ptr - ptr >= 8) {
+    val = static_cast<T>((load_be64(ptr) << offset) >> (64u - n_bits));
+    ptr += total_bits / 8;
+    offset = total_bits % 8;
+    return SRSASN_SUCCESS;
+  }
   while (n_bits > 0) {
     if (ptr >= max_ptr) {
       log_error("Buffer size limit was achieved");
@@ -190,7 +244,7 @@ SRSASN_CODE unpack_bits(T& val, Ptr& ptr, uint8_t& offset, const uint8_t* max_pt
       n_bits = 0;
     } else {
       auto mask = static_cast<uint8_t>((1u << (8u - offset)) - 1u);
-      val += ((uint32_t)((*ptr) & mask)) << (n_bits - 8 + offset);
+      val += ((uint64_t)((*ptr) & mask)) << (n_bits - 8 + offset);
       n_bits -= 8 - offset;
       offset = 0;
       ptr++;
@@ -250,9 +304,15 @@ SRSASN_CODE bit_ref_impl<Ptr>::unpack_bytes(uint8_t* buf, uint32_t n_bytes)
     memcpy(buf, ptr, n_bytes);
     ptr += n_bytes;
   } else {
-    for (uint32_t i = 0; i < n_bytes; ++i) {
-      HANDLE_CODE(unpack(buf[i], 8));
+    // Unaligned case. Each output byte borrows the leading bits of the next input byte, which is within the buffer
+    uint32_t i = 0;
+    for (; i + 8 <= n_bytes; i += 8) {
+      store_be64(buf + i, (load_be64(ptr + i) << offset) | (ptr[i + 8] >> (8u - offset)));
+    }
+    for (; i < n_bytes; ++i) {
+      buf[i] = static_cast<uint8_t>((ptr[i] << offset) | (ptr[i + 1] >> (8u - offset)));
     }
+    ptr += n_bytes;
   }
   return SRSASN_SUCCESS;
 }
@@ -313,9 +373,20 @@ SRSASN_CODE bit_ref::pack_bytes(const uint8_t* buf, uint32_t n_bytes)
     memcpy(ptr, buf, n_bytes);
     ptr += n_bytes;
   } else {
-    for (uint32_t i = 0; i < n_bytes; ++i) {
-      pack(buf[i], 8);
+    // Unaligned case. The trailing bits of each input byte are carried over to the next output byte
+    auto     carry = static_cast<uint8_t>(ptr[0] & (uint8_t)(0xffu << (8u - offset)));
+    uint32_t i     = 0;
+    for (; i + 8 <= n_bytes; i += 8) {
+      uint64_t word = load_be64(buf + i);
+      store_be64(ptr + i, ((uint64_t)carry << 56u) | (word >> offset));
+      carry = static_cast<uint8_t>(word << (8u - offset));
+    }
+    for (; i < n_bytes; ++i) {
+      ptr[i] = carry | static_cast<uint8_t>(buf[i] >> offset);
+      carry  = static_cast<uint8_t>(buf[i] << (8u - offset));
     }
+    ptr[n_bytes] = carry;
+    ptr += n_bytes;
   }
   return SRSASN_SUCCESS;
 }
@@ -21,6 +21,10 @@
 #include "srsran/common/ssl.h"
 #include "srsran/common/zuc.h"
 
+#ifdef __AES__
+#include <wmmintrin.h>
+#endif // __AES__
+
 /*******************************************************************************
                               LOCAL FUNCTION PROTOTYPES
 *******************************************************************************/
@@ -1258,6 +1262,174 @@ LIBLTE_ERROR_ENUM liblte_security_milenage_f5_star(uint8* k, uint8* op_c, uint8*
   return (err);
 }
 
+/*********************************************************************
+    Name: milenage_set_key, milenage_encrypt
+
+    Description: AES-128 helpers for the batched Milenage. Block i
+                 of the batch is encrypted with key
+                 i / blocks_per_key. With AES-NI the rounds of all
+                 blocks are interleaved, so that the latency of
+                 AESENC is hidden.
+
+    Document Reference: -
+*********************************************************************/
+#ifdef __AES__
+typedef struct {
+  __m128i rk[11];
+} milenage_key_t;
+
+static inline __m128i milenage_key_exp(__m128i key, __m128i keygened)
+{
+  keygened = _mm_shuffle_epi32(keygened, _MM_SHUFFLE(3, 3, 3, 3));
+  key      = _mm_xor_si128(key, _mm_slli_si128(key, 4));
+  key      = _mm_xor_si128(key, _mm_slli_si128(key, 4));
+  key      = _mm_xor_si128(key, _mm_slli_si128(key, 4));
+  return _mm_xor_si128(key, keygened);
+}
+
+#define MILENAGE_KEY_EXP(rk, i, rcon) rk[i] = milenage_key_exp(rk[i - 1], _mm_aeskeygenassist_si128(rk[i - 1], rcon))
+
+static void milenage_set_key(milenage_key_t* key, const uint8* k)
+{
+  key->rk[0] = _mm_loadu_si128((const __m128i*)k);
+  MILENAGE_KEY_EXP(key->rk, 1, 0x01);
+  MILENAGE_KEY_EXP(key->rk, 2, 0x02);
+  MILENAGE_KEY_EXP(key->rk, 3, 0x04);
+  MILENAGE_KEY_EXP(key->rk, 4, 0x08);
+  MILENAGE_KEY_EXP(key->rk, 5, 0x10);
+  MILENAGE_KEY_EXP(key->rk, 6, 0x20);
+  MILENAGE_KEY_EXP(key->rk, 7, 0x40);
+  MILENAGE_KEY_EXP(key->rk, 8, 0x80);
+  MILENAGE_KEY_EXP(key->rk, 9, 0x1b);
+  MILENAGE_KEY_EXP(key->rk, 10, 0x36);
+}
+
+static void milenage_encrypt(milenage_key_t* keys, uint32 nof_blocks, uint32 blocks_per_key, uint8 (*blocks)[16])
+{
+  __m128i state[4 * LIBLTE_SECURITY_MILENAGE_BATCH_SIZE];
+  uint32  i;
+  uint32  r;
+
+  for (i = 0; i < nof_blocks; i++) {
+    state[i] = _mm_xor_si128(_mm_loadu_si128((const __m128i*)blocks[i]), keys[i / blocks_per_key].rk[0]);
+  }
+  for (r = 1; r < 10; r++) {
+    for (i = 0; i < nof_blocks; i++) {
+      state[i] = _mm_aesenc_si128(state[i], keys[i / blocks_per_key].rk[r]);
+    }
+  }
+  for (i = 0; i < nof_blocks; i++) {
+    _mm_storeu_si128((__m128i*)blocks[i], _mm_aesenclast_si128(state[i], keys[i / blocks_per_key].rk[10]));
+  }
+}
+#else  // __AES__
+typedef aes_context milenage_key_t;
+
+static void milenage_set_key(milenage_key_t* key, const uint8* k)
+{
+  aes_setkey_enc(key, k, 128);
+}
+
+static void milenage_encrypt(milenage_key_t* keys, uint32 nof_blocks, uint32 blocks_per_key, uint8 (*blocks)[16])
+{
+  uint32 i;
+
+  for (i = 0; i < nof_blocks; i++) {
+    aes_crypt_ecb(&keys[i / blocks_per_key], AES_ENCRYPT, blocks[i], blocks[i]);
+  }
+}
+#endif // __AES__
+
+/*********************************************************************
+    Name: liblte_security_milenage_batch
+
+    Description: Milenage security functions F1, F2, F3, F4 and F5
+                 for a batch of authentication vectors.
+
+    Document Reference: 35.206 v10.0.0 Annex 3
+*********************************************************************/
+LIBLTE_ERROR_ENUM liblte_security_milenage_batch(LIBLTE_SECURITY_MILENAGE_VECTOR_STRUCT* vectors, uint32 nof_vectors)
+{
+  milenage_key_t keys[LIBLTE_SECURITY_MILENAGE_BATCH_SIZE];
+  uint8          temp[LIBLTE_SECURITY_MILENAGE_BATCH_SIZE][16];
+  uint8          out[4 * LIBLTE_SECURITY_MILENAGE_BATCH_SIZE][16];
+  uint32         n;
+  uint32         v;
+  uint32         i;
+
+  if (vectors == NULL) {
+    return LIBLTE_ERROR_INVALID_INPUTS;
+  }
+  for (v = 0; v < nof_vectors; v++) {
+    if (vectors[v].k == NULL || vectors[v].op_c == NULL) {
+      return LIBLTE_ERROR_INVALID_INPUTS;
+    }
+  }
+
+  for (n = 0; n < nof_vectors; n += LIBLTE_SECURITY_MILENAGE_BATCH_SIZE) {
+    LIBLTE_SECURITY_MILENAGE_VECTOR_STRUCT* batch      = &vectors[n];
+    uint32                                  batch_size = nof_vectors - n;
+    if (batch_size > LIBLTE_SECURITY_MILENAGE_BATCH_SIZE) {
+      batch_size = LIBLTE_SECURITY_MILENAGE_BATCH_SIZE;
+    }
+
+    // Initialize the round keys and compute temp
+    for (v = 0; v < batch_size; v++) {
+      milenage_set_key(&keys[v], batch[v].k);
+      for (i = 0; i < 16; i++) {
+        temp[v][i] = batch[v].rand[i] ^ batch[v].op_c[i];
+      }
+    }
+    milenage_encrypt(keys, batch_size, 1, temp);
+
+    // Inputs of out1 (F1), out2 (F2, F5), out3 (F3) and out4 (F4), they only depend on temp
+    for (v = 0; v < batch_size; v++) {
+      const uint8* op_c = batch[v].op_c;
+      uint8*       in   = out[4 * v];
+      uint8        in1[16];
+
+      for (i = 0; i < 6; i++) {
+        in1[i]     = batch[v].sqn[i];
+        in1[i + 8] = batch[v].sqn[i];
+      }
+      for (i = 0; i < 2; i++) {
+        in1[i + 6]  = batch[v].amf[i];
+        in1[i + 14] = batch[v].amf[i];
+      }
+      for (i = 0; i < 16; i++) {
+        in[(i + 8) % 16] = in1[i] ^ op_c[i];
+      }
+      for (i = 0; i < 16; i++) {
+        in[i] ^= temp[v][i];
+        out[4 * v + 1][i]             = temp[v][i] ^ op_c[i];
+        out[4 * v + 2][(i + 12) % 16] = temp[v][i] ^ op_c[i];
+        out[4 * v + 3][(i + 8) % 16]  = temp[v][i] ^ op_c[i];
+      }
+      out[4 * v + 1][15] ^= 1;
+      out[4 * v + 2][15] ^= 2;
+      out[4 * v + 3][15] ^= 4;
+    }
+    milenage_encrypt(keys, 4 * batch_size, 4, out);
+
+    for (v = 0; v < batch_size; v++) {
+      const uint8* op_c = batch[v].op_c;
+      for (i = 0; i < 16; i++) {
+        out[4 * v][i] ^= op_c[i];
+        out[4 * v + 1][i] ^= op_c[i];
+        out[4 * v + 2][i] ^= op_c[i];
+        out[4 * v + 3][i] ^= op_c[i];
+      }
+      memcpy(batch[v].mac_a, &out[4 * v][0], 8);
+      memcpy(batch[v].res, &out[4 * v + 1][8], 8);
+      memcpy(batch[v].ak, &out[4 * v + 1][0], 6);
+      memcpy(batch[v].ck, out[4 * v + 2], 16);
+      memcpy(batch[v].ik, out[4 * v + 3], 16);
+    }
+  }
+
+  return LIBLTE_SUCCESS;
+}
+
 /*********************************************************************
     Name: liblte_compute_opc
 
@@ -22,81 +22,82 @@
 #include "srsran/common/mac_pcap.h"
 #include "srsran/common/standard_streams.h"
 #include "srsran/common/threads.h"
+#include <inttypes.h>
 
 namespace srsran {
-mac_pcap::mac_pcap() : mac_pcap_base() {}
+mac_pcap::mac_pcap() : mac_pcap_base(), writer("PCAP_WRITER_MAC") {}
 
 mac_pcap::~mac_pcap()
 {
   close();
 }
 
-uint32_t mac_pcap::open(std::string filename_, uint32_t ue_id_)
+uint32_t mac_pcap::open(std::string filename_, uint32_t ue_id_, uint64_t rotate_bytes)
 {
   std::lock_guard<std::mutex> lock(mutex);
-  if (pcap_file != nullptr) {
+  if (writer.is_open()) {
     logger.error("PCAP writer for %s already running. Close first.", filename_.c_str());
     return SRSRAN_ERROR;
   }
 
   // set DLT for selected RAT
-  dlt       = UDP_DLT;
-  pcap_file = LTE_PCAP_Open(dlt, filename_.c_str());
-  if (pcap_file == nullptr) {
+  dlt = UDP_DLT;
+  if (not writer.open(filename_, dlt, rotate_bytes)) {
     logger.error("Couldn't open %s to write PCAP", filename_.c_str());
     return SRSRAN_ERROR;
   }
 
-  filename = filename_;
-  ue_id    = ue_id_;
-  running  = true;
-
-  // start writer thread
-  start();
+  ue_id   = ue_id_;
+  running = true;
 
   return SRSRAN_SUCCESS;
 }
 
 uint32_t mac_pcap::close()
 {
-  {
-    std::lock_guard<std::mutex> lock(mutex);
-    if (running == false || pcap_file == nullptr) {
-      return SRSRAN_ERROR;
-    }
-
-    // tell writer thread to stop
-    running        = false;
-    pcap_pdu_t pdu = {};
-    queue.push_blocking(std::move(pdu));
+  std::lock_guard<std::mutex> lock(mutex);
+  if (running == false || not writer.is_open()) {
+    return SRSRAN_ERROR;
   }
+  running = false;
 
-  wait_thread_finish();
-
-  // close file handle
-  {
-    std::lock_guard<std::mutex> lock(mutex);
-    srsran::console("Saving MAC PCAP (DLT=%d) to %s\n", dlt, filename.c_str());
-    LTE_PCAP_Close(pcap_file);
-    pcap_file = nullptr;
+  // writes the pending PDUs before closing the file
+  writer.close();
+  srsran::console("Saving MAC PCAP (DLT=%d) to %s\n", dlt, writer.get_filename().c_str());
+  if (writer.get_nof_dropped() > 0) {
+    logger.warning("Dropped %" PRIu64 " PDUs in MAC PCAP. Write queue full.", writer.get_nof_dropped());
   }
 
   return SRSRAN_SUCCESS;
 }
 
+// Packs the headers straight into the writer queue, called from PHY worker context
+void mac_pcap::queue_pdu(pcap_pdu_t& pdu, const uint8_t* payload, uint32_t payload_len)
+{
+  uint8_t header[PCAP_CONTEXT_HEADER_MAX];
+  int     header_len = SRSRAN_ERROR;
+  switch (pdu.rat) {
+    case srsran_rat_t::lte:
+      header_len = LTE_PCAP_PACK_MAC_UDP_HEADER(&pdu.context, payload_len, header, sizeof(header));
+      break;
+    case srsran_rat_t::nr:
+      header_len = NR_PCAP_PACK_MAC_UDP_HEADER(&pdu.context_nr, payload_len, header, sizeof(header));
+      break;
+    default:
+      logger.error("Error writing PDU to PCAP. Unsupported RAT selected.");
+  }
+  if (header_len < 0) {
+    return;
+  }
+  if (not writer.write(header, header_len, payload, payload_len)) {
+    logger.debug("Dropping PDU (%d B) in PCAP. Write queue full.", payload_len);
+  }
+}
+
 void mac_pcap::write_pdu(srsran::mac_pcap_base::pcap_pdu_t& pdu)
 {
   if (pdu.pdu != nullptr) {
-    switch (pdu.rat) {
-      case srsran_rat_t::lte:
-        LTE_PCAP_MAC_UDP_WritePDU(pcap_file, &pdu.context, pdu.pdu->msg, pdu.pdu->N_bytes);
-        break;
-      case srsran_rat_t::nr:
-        NR_PCAP_MAC_UDP_WritePDU(pcap_file, &pdu.context_nr, pdu.pdu->msg, pdu.pdu->N_bytes);
-        break;
-      default:
-        logger.error("Error writing PDU to PCAP. Unsupported RAT selected.");
-    }
+    queue_pdu(pdu, pdu.pdu->msg, pdu.pdu->N_bytes);
   }
 }
 
@@ -31,11 +31,10 @@ void nas_pcap::enable()
   enable_write = true;
 }
 
-uint32_t nas_pcap::open(std::string filename_, uint32_t ue_id_)
+uint32_t nas_pcap::open(std::string filename_, uint32_t ue_id_, uint64_t rotate_bytes)
 {
-  filename  = filename_;
-  pcap_file = LTE_PCAP_Open(NAS_LTE_DLT, filename.c_str());
-  if (pcap_file == nullptr) {
+  filename = filename_;
+  if (not writer.open(filename, NAS_LTE_DLT, rotate_bytes)) {
     return SRSRAN_ERROR;
   }
   ue_id        = ue_id_;
@@ -46,15 +45,15 @@ uint32_t nas_pcap::open(std::string filename_, uint32_t ue_id_)
 void nas_pcap::close()
 {
   fprintf(stdout, "Saving NAS PCAP file (DLT=%d) to %s \n", NAS_LTE_DLT, filename.c_str());
-  LTE_PCAP_Close(pcap_file);
+  enable_write = false;
+  writer.close();
 }
 
 void nas_pcap::write_nas(uint8_t* pdu, uint32_t pdu_len_bytes)
 {
   if (enable_write) {
-    NAS_Context_Info_t context;
     if (pdu) {
-      LTE_PCAP_NAS_WritePDU(pcap_file, &context, pdu, pdu_len_bytes);
+      writer.write(nullptr, 0, pdu, pdu_len_bytes);
     }
   }
 }
@@ -541,6 +541,29 @@ void socket_manager::run_thread()
  *                 Rx Multisocket Task Types
  **************************************************************/
 
+/// Reads one SDU and its metadata from a SCTP socket. Returns nullptr if there was nothing to read
+static srsran::unique_byte_buffer_t
+sctp_recvmsg_sdu(srslog::basic_logger& logger, int fd, sockaddr_in* from, sctp_sndrcvinfo* sri, int* flags)
+{
+  srsran::unique_byte_buffer_t pdu = srsran::make_byte_buffer();
+  if (pdu == nullptr) {
+    logger.error("Unable to allocate byte buffer");
+    return nullptr;
+  }
+  socklen_t fromlen = sizeof(*from);
+  ssize_t   n_recv  = sctp_recvmsg(fd, pdu->msg, pdu->get_tailroom(), (struct sockaddr*)from, &fromlen, sri, flags);
+  if (n_recv == -1 and errno != EAGAIN) {
+    logger.error("Error reading from SCTP socket: %s", strerror(errno));
+    return nullptr;
+  }
+  if (n_recv == -1 and errno == EAGAIN) {
+    logger.debug("Socket timeout reached");
+    return nullptr;
+  }
+  pdu->N_bytes = static_cast<uint32_t>(n_recv);
+  return pdu;
+}
+
 class sctp_recvmsg_pdu_task
 {
 public:
@@ -553,34 +576,20 @@ public:
   bool operator()(int fd)
   {
     // inside rx_sockets thread. Read socket
-    srsran::unique_byte_buffer_t pdu = srsran::make_byte_buffer();
+    sockaddr_in                  from  = {};
+    sctp_sndrcvinfo              sri   = {};
+    int                          flags = 0;
+    srsran::unique_byte_buffer_t pdu   = sctp_recvmsg_sdu(logger, fd, &from, &sri, &flags);
     if (pdu == nullptr) {
-      logger.error("Unable to allocate byte buffer");
-      return true;
-    }
-    sockaddr_in     from    = {};
-    socklen_t       fromlen = sizeof(from);
-    sctp_sndrcvinfo sri     = {};
-    int             flags   = 0;
-    ssize_t n_recv = sctp_recvmsg(fd, pdu->msg, pdu->get_tailroom(), (struct sockaddr*)&from, &fromlen, &sri, &flags);
-    if (n_recv == -1 and errno != EAGAIN) {
-      logger.error("Error reading from SCTP socket: %s", strerror(errno));
       return true;
     }
-    if (n_recv == -1 and errno == EAGAIN) {
-      logger.debug("Socket timeout reached");
-      return true;
-    }
-
-    bool ret     = true;
-    pdu->N_bytes = static_cast<uint32_t>(n_recv);
 
     // Defer handling of received packet to provided queue
     // SCTP notifications handled in callback.
     queue.push(std::bind(
         [this, from, sri, flags](srsran::unique_byte_buffer_t& sdu) { func(std::move(sdu), from, sri, flags); },
         std::move(pdu)));
-    return ret;
+    return true;
   }
 
 private:
@@ -595,6 +604,45 @@ make_sctp_sdu_handler(srslog::basic_logger& logger, srsran::task_queue_handle& q
   return socket_manager_itf::recv_callback_t(sctp_recvmsg_pdu_task(logger, queue, std::move(rx_callback)));
 }
 
+class sctp_recvmsg_preprocess_task
+{
+public:
+  using callback_t = sctp_recv_preprocess_callback_t;
+
+  explicit sctp_recvmsg_preprocess_task(srslog::basic_logger&      logger,
+                                        srsran::task_queue_handle& queue_,
+                                        callback_t                 func_) :
+    logger(logger), queue(queue_), func(std::move(func_))
+  {}
+
+  bool operator()(int fd)
+  {
+    sockaddr_in                  from  = {};
+    sctp_sndrcvinfo              sri   = {};
+    int                          flags = 0;
+    srsran::unique_byte_buffer_t pdu   = sctp_recvmsg_sdu(logger, fd, &from, &sri, &flags);
+    if (pdu == nullptr) {
+      return true;
+    }
+
+    // Process the packet inside the rx_sockets thread, and defer the resulting task to provided queue
+    queue.push(func(std::move(pdu), from, sri, flags));
+    return true;
+  }
+
+private:
+  srslog::basic_logger&      logger;
+  srsran::task_queue_handle& queue;
+  callback_t                 func;
+};
+
+socket_manager_itf::recv_callback_t make_sctp_sdu_preprocess_handler(srslog::basic_logger&           logger,
+                                                                     srsran::task_queue_handle&      queue,
+                                                                     sctp_recv_preprocess_callback_t rx_callback)
+{
+  return socket_manager_itf::recv_callback_t(sctp_recvmsg_preprocess_task(logger, queue, std::move(rx_callback)));
+}
+
 /**
  * Description: Functor for the case the received data is
  * in the form of unique_byte_buffer, and a recvfrom(...) call is used
@@ -0,0 +1,288 @@
+/**
+ * Copyright 2013-2021 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "srsran/common/pcap_writer.h"
+#include "srsran/common/srsran_assert.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/time.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#ifndef IOV_MAX
+#define IOV_MAX 1024
+#endif
+
+namespace srsran {
+
+static inline uint32_t align_record(uint32_t len)
+{
+  return (len + 7U) & ~7U;
+}
+
+pcap_writer::pcap_writer(const std::string& thread_name, uint32_t queue_size) :
+  thread(thread_name), ring_size(queue_size)
+{
+  srsran_assert((ring_size & (ring_size - 1)) == 0 && ring_size >= 4096, "The PCAP queue size must be a power of 2");
+}
+
+pcap_writer::~pcap_writer()
+{
+  close();
+}
+
+bool pcap_writer::open(const std::string& filename_, uint32_t dlt_, uint64_t rotate_bytes_)
+{
+  if (is_open()) {
+    return false;
+  }
+
+  // The ring is allocated on first use as most PCAP objects are never enabled
+  if (ring == nullptr) {
+    ring = std::unique_ptr<uint64_t[]>(new uint64_t[ring_size / sizeof(uint64_t)]());
+  } else {
+    memset(ring.get(), 0, ring_size);
+  }
+  write_pos.store(0, std::memory_order_relaxed);
+  read_pos.store(0, std::memory_order_relaxed);
+  nof_written.store(0, std::memory_order_relaxed);
+  nof_dropped.store(0, std::memory_order_relaxed);
+
+  filename     = filename_;
+  dlt          = dlt_;
+  rotate_bytes = rotate_bytes_;
+  file_idx     = 0;
+  if (not open_file()) {
+    return false;
+  }
+
+  running.store(true, std::memory_order_release);
+  start(-1);
+  return true;
+}
+
+void pcap_writer::close()
+{
+  if (not running.exchange(false)) {
+    return;
+  }
+  wait_thread_finish();
+  close_file();
+}
+
+bool pcap_writer::open_file()
+{
+  std::string name = file_idx == 0 ? filename : filename + "." + std::to_string(file_idx);
+
+  fd = ::open(name.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  if (fd < 0) {
+    printf("Failed to open file \"%s\" for writing\n", name.c_str());
+    return false;
+  }
+
+  pcap_hdr_t file_header = {
+      0xa1b2c3d4, /* magic number */
+      2,
+      4,     /* version number is 2.4 */
+      0,     /* timezone */
+      0,     /* sigfigs - apparently all tools do this */
+      65535, /* snaplen - this should be long enough */
+      dlt    /* Data Link Type (DLT) */
+  };
+  if (::write(fd, &file_header, sizeof(file_header)) != (ssize_t)sizeof(file_header)) {
+    printf("Failed to write PCAP header to \"%s\"\n", name.c_str());
+    close_file();
+    return false;
+  }
+  file_bytes = sizeof(file_header);
+  return true;
+}
+
+void pcap_writer::close_file()
+{
+  if (fd >= 0) {
+    ::close(fd);
+    fd = -1;
+  }
+}
+
+bool pcap_writer::write(const uint8_t* header, uint32_t header_len, const uint8_t* payload, uint32_t payload_len)
+{
+  if (not running.load(std::memory_order_relaxed)) {
+    return false;
+  }
+
+  uint32_t data_len = sizeof(pcaprec_hdr_t) + header_len + payload_len;
+  uint32_t rec_len  = align_record(sizeof(record_t) + data_len);
+
+  // Reserve a contiguous region, preceded by a padding record if the record does not fit before the end of the ring
+  uint64_t pos = write_pos.load(std::memory_order_relaxed);
+  uint32_t pad_len;
+  while (true) {
+    uint32_t contiguous = ring_size - (uint32_t)(pos & (ring_size - 1));
+    pad_len             = rec_len > contiguous ? contiguous : 0;
+    uint64_t read       = read_pos.load(std::memory_order_acquire);
+    if (read > pos) {
+      // The writer thread consumed past our stale copy of the write position, take a fresh one
+      pos = write_pos.load(std::memory_order_relaxed);
+      continue;
+    }
+    if (pos + pad_len + rec_len - read > ring_size) {
+      nof_dropped.fetch_add(1, std::memory_order_relaxed);
+      return false;
+    }
+    if (write_pos.compare_exchange_weak(pos, pos + pad_len + rec_len, std::memory_order_relaxed)) {
+      break;
+    }
+  }
+
+  if (pad_len > 0) {
+    record_t* pad = reinterpret_cast<record_t*>(ring_at(pos));
+    pad->len      = pad_len - sizeof(record_t);
+    pad->state.store(record_padding, std::memory_order_release);
+    pos += pad_len;
+  }
+
+  record_t* rec = reinterpret_cast<record_t*>(ring_at(pos));
+  uint8_t*  ptr = reinterpret_cast<uint8_t*>(rec + 1);
+
+  struct timeval t;
+  gettimeofday(&t, nullptr);
+  pcaprec_hdr_t packet_header;
+  packet_header.ts_sec   = t.tv_sec;
+  packet_header.ts_usec  = t.tv_usec;
+  packet_header.incl_len = header_len + payload_len;
+  packet_header.orig_len = header_len + payload_len;
+  memcpy(ptr, &packet_header, sizeof(pcaprec_hdr_t));
+  ptr += sizeof(pcaprec_hdr_t);
+  if (header_len > 0) {
+    memcpy(ptr, header, header_len);
+    ptr += header_len;
+  }
+  if (payload_len > 0) {
+    memcpy(ptr, payload, payload_len);
+  }
+
+  rec->len = data_len;
+  rec->state.store(record_ready, std::memory_order_release);
+  return true;
+}
+
+// Writes the records published so far, up to IOV_MAX per call. Returns false if the ring was empty.
+bool pcap_writer::write_batch()
+{
+  struct iovec iov[IOV_MAX];
+  uint32_t     nof_iov     = 0;
+  uint32_t     nof_records = 0;
+  uint64_t     batch_bytes = 0;
+  bool         rotate      = false;
+
+  uint64_t start = read_pos.load(std::memory_order_relaxed);
+  uint64_t pos   = start;
+  // A full ring holds published records all the way round, up to the one at the read position
+  while (nof_iov < IOV_MAX && pos - start < ring_size) {
+    record_t* rec   = reinterpret_cast<record_t*>(ring_at(pos));
+    uint32_t  state = rec->state.load(std::memory_order_acquire);
+    if (state == record_empty) {
+      break;
+    }
+    if (state == record_ready) {
+      if (fd >= 0 && rotate_bytes > 0 && file_bytes + batch_bytes + rec->len > rotate_bytes &&
+          file_bytes + batch_bytes > sizeof(pcap_hdr_t)) {
+        rotate = true;
+        break;
+      }
+      iov[nof_iov].iov_base = rec + 1;
+      iov[nof_iov].iov_len  = rec->len;
+      nof_iov++;
+      nof_records++;
+      batch_bytes += rec->len;
+    }
+    pos += align_record(sizeof(record_t) + rec->len);
+  }
+
+  if (pos != start) {
+    write_records(iov, nof_iov);
+    file_bytes += batch_bytes;
+    nof_written.fetch_add(nof_records, std::memory_order_relaxed);
+
+    // Clear the consumed region so that stale bytes are never taken as a record header, then hand it back
+    uint32_t offset = (uint32_t)(start & (ring_size - 1));
+    uint64_t len    = pos - start;
+    if (offset + len > ring_size) {
+      memset(ring_at(start), 0, ring_size - offset);
+      memset(ring_at(0), 0, len - (ring_size - offset));
+    } else {
+      memset(ring_at(start), 0, len);
+    }
+    read_pos.store(pos, std::memory_order_release);
+  }
+
+  if (rotate) {
+    close_file();
+    file_idx++;
+    open_file();
+  }
+  return pos != start || rotate;
+}
+
+void pcap_writer::write_records(struct iovec* iov, uint32_t nof_iov)
+{
+  // writev() may return early, resume from the first incomplete buffer
+  struct iovec* next = iov;
+  while (nof_iov > 0 && fd >= 0) {
+    ssize_t n = ::writev(fd, next, (int)nof_iov);
+    if (n < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      printf("Error writing PCAP file \"%s\": %s\n", filename.c_str(), strerror(errno));
+      break;
+    }
+    while (nof_iov > 0 && (size_t)n >= next->iov_len) {
+      n -= next->iov_len;
+      next++;
+      nof_iov--;
+    }
+    if (nof_iov > 0) {
+      next->iov_base = (uint8_t*)next->iov_base + n;
+      next->iov_len -= n;
+    }
+  }
+}
+
+void pcap_writer::run_thread()
+{
+  while (running.load(std::memory_order_acquire)) {
+    if (not write_batch()) {
+      usleep(1000);
+    }
+  }
+
+  // write remainder of the queue
+  while (write_batch()) {
+  }
+}
+
+} // namespace srsran
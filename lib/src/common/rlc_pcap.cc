@@ -34,8 +34,7 @@ void rlc_pcap::enable(bool en)
 void rlc_pcap::open(const char* filename, rlc_config_t config)
 {
   fprintf(stdout, "Opening RLC PCAP with DLT=%d\n", UDP_DLT);
-  pcap_file    = LTE_PCAP_Open(UDP_DLT, filename);
-  enable_write = true;
+  enable_write = writer.open(filename, UDP_DLT);
 
   if (config.rlc_mode == rlc_mode_t::am) {
     mode      = RLC_AM_MODE;
@@ -54,7 +53,8 @@ void rlc_pcap::open(const char* filename, rlc_config_t config)
 void rlc_pcap::close()
 {
   fprintf(stdout, "Saving RLC PCAP file\n");
-  LTE_PCAP_Close(pcap_file);
+  enable_write = false;
+  writer.close();
 }
 
 void rlc_pcap::set_ue_id(uint16_t ue_id_)
@@ -83,7 +83,11 @@ void rlc_pcap::pack_and_write(uint8_t* pdu,
     context.channelId            = channel_id;
     context.pduLength            = pdu_len_bytes;
     if (pdu) {
-      LTE_PCAP_RLC_WritePDU(pcap_file, &context, pdu, pdu_len_bytes);
+      uint8_t header[PCAP_CONTEXT_HEADER_MAX];
+      int     header_len = LTE_PCAP_PACK_RLC_HEADER(&context, pdu_len_bytes, header, sizeof(header));
+      if (header_len >= 0) {
+        writer.write(header, header_len, pdu, pdu_len_bytes);
+      }
     }
   }
 }
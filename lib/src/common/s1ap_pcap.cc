@@ -30,23 +30,22 @@ void s1ap_pcap::enable()
 {
   enable_write = true;
 }
-void s1ap_pcap::open(const char* filename)
+void s1ap_pcap::open(const char* filename, uint64_t rotate_bytes)
 {
-  pcap_file    = LTE_PCAP_Open(S1AP_LTE_DLT, filename);
-  enable_write = true;
+  enable_write = writer.open(filename, S1AP_LTE_DLT, rotate_bytes);
 }
 void s1ap_pcap::close()
 {
   fprintf(stdout, "Saving S1AP PCAP file\n");
-  LTE_PCAP_Close(pcap_file);
+  enable_write = false;
+  writer.close();
 }
 
 void s1ap_pcap::write_s1ap(uint8_t* pdu, uint32_t pdu_len_bytes)
 {
   if (enable_write) {
-    S1AP_Context_Info_t context;
     if (pdu) {
-      LTE_PCAP_S1AP_WritePDU(pcap_file, &context, pdu, pdu_len_bytes);
+      writer.write(nullptr, 0, pdu, pdu_len_bytes);
     }
   }
 }
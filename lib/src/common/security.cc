@@ -251,4 +251,9 @@ uint8_t security_milenage_f5_star(uint8_t* k, uint8_t* op, uint8_t* rand, uint8_
   return liblte_security_milenage_f5_star(k, op, rand, ak);
 }
 
+uint8_t security_milenage_batch(milenage_vector_t* vectors, uint32_t nof_vectors)
+{
+  return liblte_security_milenage_batch(vectors, nof_vectors);
+}
+
 } // namespace srsran
@@ -170,9 +170,11 @@ uint32_t mac_sch_subpdu_nr::write_subpdu(const uint8_t* start_)
     logger->error("Error while packing PDU. Unsupported header length (%d)", header_length);
   }
 
-  // copy SDU payload
+  // copy SDU payload, unless it has been written in place
   if (sdu) {
-    memcpy(ptr, sdu, sdu_length);
+    if (sdu != ptr) {
+      memcpy(ptr, sdu, sdu_length);
+    }
   } else {
     // clear memory
     memset(ptr, 0, sdu_length);
@@ -392,6 +394,41 @@ uint32_t mac_sch_pdu_nr::add_sdu(const uint32_t lcid_, const uint8_t* payload_,
   return add_sudpdu(sch_pdu);
 }
 
+int32_t mac_sch_pdu_nr::add_sdu(const uint32_t lcid_, const uint32_t max_len_, read_pdu_interface* sdu_itf_)
+{
+  // Leave room for the subheader of the largest SDU that fits, so the SDU is read at its final position
+  uint32_t header_size = size_header_sdu(lcid_, max_len_);
+  if (header_size + max_len_ > remaining_len) {
+    logger.error("Header and SDU exceed space in PDU (%d + %d > %d)", header_size, max_len_, remaining_len);
+    return SRSRAN_ERROR;
+  }
+
+  uint8_t* sdu_ptr = buffer->msg + buffer->N_bytes + header_size;
+  int      sdu_len = sdu_itf_->read_pdu(lcid_, sdu_ptr, max_len_);
+  if (sdu_len <= 0) {
+    return sdu_len;
+  }
+  if (sdu_len > static_cast<int>(max_len_)) {
+    logger.error("SDU exceeds requested size (%d > %d)", sdu_len, max_len_);
+    return SRSRAN_ERROR;
+  }
+
+  // A short SDU needs a smaller subheader, close the gap left in front of it
+  uint32_t final_header_size = size_header_sdu(lcid_, sdu_len);
+  if (final_header_size < header_size) {
+    uint8_t* final_sdu_ptr = buffer->msg + buffer->N_bytes + final_header_size;
+    memmove(final_sdu_ptr, sdu_ptr, sdu_len);
+    sdu_ptr = final_sdu_ptr;
+  }
+
+  mac_sch_subpdu_nr sch_pdu(this);
+  sch_pdu.set_sdu(lcid_, sdu_ptr, sdu_len);
+  if (add_sudpdu(sch_pdu) != SRSRAN_SUCCESS) {
+    return SRSRAN_ERROR;
+  }
+  return sdu_len;
+}
+
 uint32_t mac_sch_pdu_nr::add_crnti_ce(const uint16_t crnti)
 {
   mac_sch_subpdu_nr ce(this);
@@ -106,8 +106,10 @@ int srsran_refsignal_cs_set_cell(srsran_refsignal_t* q, srsran_cell_t cell)
               uint32_t idx = SRSRAN_REFSIGNAL_PILOT_IDX(i, (ns % 2) * nsymbols + l, q->cell);
               mp           = i + SRSRAN_MAX_PRB - cell.nof_prb;
               /* save signal */
-              __real__ q->pilots[p][ns / 2][idx] = (1 - 2 * (float)seq.c[2 * mp + 0]) * M_SQRT1_2;
-              __imag__ q->pilots[p][ns / 2][idx] = (1 - 2 * (float)seq.c[2 * mp + 1]) * M_SQRT1_2;
+              __real__ q->pilots[p][ns / 2][idx] =
+                  (1 - 2 * (float)srsran_sequence_get_bit(&seq, 2 * mp + 0)) * M_SQRT1_2;
+              __imag__ q->pilots[p][ns / 2][idx] =
+                  (1 - 2 * (float)srsran_sequence_get_bit(&seq, 2 * mp + 1)) * M_SQRT1_2;
             }
           }
         }
@@ -406,8 +408,8 @@ int srsran_refsignal_mbsfn_gen_seq(srsran_refsignal_t* q, srsran_cell_t cell, ui
         for (i = 0; i < 6 * q->cell.nof_prb; i++) {
           uint32_t idx                   = SRSRAN_REFSIGNAL_PILOT_IDX_MBSFN(i, l, q->cell);
           mp                             = i + 3 * (SRSRAN_MAX_PRB - cell.nof_prb);
-          __real__ q->pilots[p][ns][idx] = (1 - 2 * (float)seq_mbsfn.c[2 * mp + 0]) * M_SQRT1_2;
-          __imag__ q->pilots[p][ns][idx] = (1 - 2 * (float)seq_mbsfn.c[2 * mp + 1]) * M_SQRT1_2;
+          __real__ q->pilots[p][ns][idx] = (1 - 2 * (float)srsran_sequence_get_bit(&seq_mbsfn, 2 * mp + 0)) * M_SQRT1_2;
+          __imag__ q->pilots[p][ns][idx] = (1 - 2 * (float)srsran_sequence_get_bit(&seq_mbsfn, 2 * mp + 1)) * M_SQRT1_2;
         }
       }
     }
@@ -162,8 +162,8 @@ int srsran_refsignal_dl_nbiot_set_cell(srsran_refsignal_dl_nbiot_t* q, srsran_nb
                   i,
                   nsymbols,
                   l);
-            __real__ q->pilots[p][ns / 2][idx] = (1 - 2 * (float)seq.c[2 * mp + 0]) * M_SQRT1_2;
-            __imag__ q->pilots[p][ns / 2][idx] = (1 - 2 * (float)seq.c[2 * mp + 1]) * M_SQRT1_2;
+            __real__ q->pilots[p][ns / 2][idx] = (1 - 2 * (float)srsran_sequence_get_bit(&seq, 2 * mp + 0)) * M_SQRT1_2;
+            __imag__ q->pilots[p][ns / 2][idx] = (1 - 2 * (float)srsran_sequence_get_bit(&seq, 2 * mp + 1)) * M_SQRT1_2;
           }
         }
       }
@@ -106,7 +106,7 @@ static int generate_n_prs(srsran_refsignal_ul_t* q)
     for (uint32_t ns = 0; ns < SRSRAN_NSLOTS_X_FRAME; ns++) {
       uint32_t n_prs = 0;
       for (int i = 0; i < 8; i++) {
-        n_prs += (seq.c[8 * SRSRAN_CP_NSYMB(q->cell.cp) * ns + i] << i);
+        n_prs += (srsran_sequence_get_bit(&seq, 8 * SRSRAN_CP_NSYMB(q->cell.cp) * ns + i) << i);
       }
       q->n_prs_pusch[delta_ss][ns] = n_prs;
     }
@@ -126,7 +126,7 @@ static int generate_srsran_sequence_hopping_v(srsran_refsignal_ul_t* q)
       if (srsran_sequence_LTE_pr(&seq, 20, ((q->cell.id / 30) << 5) + ((q->cell.id % 30) + delta_ss) % 30)) {
         return SRSRAN_ERROR;
       }
-      q->v_pusch[ns][delta_ss] = seq.c[ns];
+      q->v_pusch[ns][delta_ss] = srsran_sequence_get_bit(&seq, ns);
     }
   }
   srsran_sequence_free(&seq);
@@ -28,9 +28,8 @@ using namespace srsran;
 channel::channel(const channel::args_t& channel_args, uint32_t _nof_channels, srslog::basic_logger& logger) :
   logger(logger)
 {
-  int      ret         = SRSRAN_SUCCESS;
-  uint32_t srate_max   = (uint32_t)srsran_symbol_sz(SRSRAN_MAX_PRB) * 15000;
-  uint32_t buffer_size = (uint32_t)SRSRAN_SF_LEN_PRB(SRSRAN_MAX_PRB) * 5; // be safe, 5 Subframes
+  int      ret       = SRSRAN_SUCCESS;
+  uint32_t srate_max = (uint32_t)srsran_symbol_sz(SRSRAN_MAX_PRB) * 15000;
 
   if (_nof_channels > SRSRAN_MAX_CHANNELS) {
     fprintf(stderr,
@@ -43,13 +42,6 @@ channel::channel(const channel::args_t& channel_args, uint32_t _nof_channels, sr
   // Copy args
   args = channel_args;
 
-  // Allocate internal buffers
-  buffer_in  = srsran_vec_cf_malloc(buffer_size);
-  buffer_out = srsran_vec_cf_malloc(buffer_size);
-  if (!buffer_out || !buffer_in) {
-    ret = SRSRAN_ERROR;
-  }
-
   nof_channels = _nof_channels;
   for (uint32_t i = 0; i < nof_channels; i++) {
     // Create fading channel
@@ -73,13 +65,13 @@ channel::channel(const channel::args_t& channel_args, uint32_t _nof_channels, sr
     } else {
       delay[i] = nullptr;
     }
-  }
 
-  // Create AWGN channnel
-  if (channel_args.awgn_enable && ret == SRSRAN_SUCCESS) {
-    awgn = (srsran_channel_awgn_t*)calloc(sizeof(srsran_channel_awgn_t), 1);
-    ret  = srsran_channel_awgn_init(awgn, 1234);
-    srsran_channel_awgn_set_n0(awgn, args.awgn_signal_power_dBfs - args.awgn_snr_dB);
+    // Create AWGN channnel, one per channel so that they can run in parallel
+    if (channel_args.awgn_enable && ret == SRSRAN_SUCCESS) {
+      awgn[i] = (srsran_channel_awgn_t*)calloc(sizeof(srsran_channel_awgn_t), 1);
+      ret     = srsran_channel_awgn_init(awgn[i], 1234 + i);
+      srsran_channel_awgn_set_n0(awgn[i], args.awgn_signal_power_dBfs - args.awgn_snr_dB);
+    }
   }
 
   // Create high speed train
@@ -94,6 +86,13 @@ channel::channel(const channel::args_t& channel_args, uint32_t _nof_channels, sr
     srsran_channel_rlf_init(rlf, channel_args.rlf_t_on_ms, channel_args.rlf_t_off_ms);
   }
 
+  // Create workers for the channels other than the first one, which is processed by the caller
+  if (channel_args.parallel_enable && nof_channels > 1 && ret == SRSRAN_SUCCESS) {
+    for (uint32_t i = 1; i < nof_channels; i++) {
+      workers.emplace_back(&channel::run_worker, this, i);
+    }
+  }
+
   if (ret != SRSRAN_SUCCESS) {
     fprintf(stderr, "Error: Creating channel\n\n");
   }
@@ -101,17 +100,13 @@ channel::channel(const channel::args_t& channel_args, uint32_t _nof_channels, sr
 
 channel::~channel()
 {
-  if (buffer_in) {
-    free(buffer_in);
+  {
+    std::lock_guard<std::mutex> lock(workers_mutex);
+    workers_quit = true;
   }
-
-  if (buffer_out) {
-    free(buffer_out);
-  }
-
-  if (awgn) {
-    srsran_channel_awgn_free(awgn);
-    free(awgn);
+  cvar_start.notify_all();
+  for (std::thread& t : workers) {
+    t.join();
   }
 
   if (hst) {
@@ -134,6 +129,11 @@ channel::~channel()
       srsran_channel_delay_free(delay[i]);
       free(delay[i]);
     }
+
+    if (awgn[i]) {
+      srsran_channel_awgn_free(awgn[i]);
+      free(awgn[i]);
+    }
   }
 }
 
@@ -157,51 +157,32 @@ void channel::run(cf_t*                     in[SRSRAN_MAX_CHANNELS],
     return;
   }
 
-  // For each channel
-  for (uint32_t i = 0; i < nof_channels; i++) {
-    // Skip iteration if any buffer is null
-    if (in[i] == nullptr || out[i] == nullptr) {
-      continue;
-    }
-
-    // If sampling rate is not set, copy input and skip rest of channel
-    if (current_srate == 0) {
-      if (in[i] != out[i]) {
-        srsran_vec_cf_copy(out[i], in[i], len);
-      }
-      continue;
-    }
-
-    // Copy input buffer
-    srsran_vec_cf_copy(buffer_in, in[i], len);
-
-    if (hst) {
-      srsran_channel_hst_execute(hst, buffer_in, buffer_out, len, &t);
-      srsran_vec_sc_prod_ccc(buffer_out, local_cexpf(hst_init_phase), buffer_in, len);
-    }
-
-    if (awgn) {
-      srsran_channel_awgn_run_c(awgn, buffer_in, buffer_out, len);
-      srsran_vec_cf_copy(buffer_in, buffer_out, len);
-    }
+  run_in  = in;
+  run_out = out;
+  run_len = len;
+  run_ts  = t;
+  if (hst) {
+    // The doppler shift is common to all channels
+    srsran_channel_hst_update(hst, &t);
+    run_phase = local_cexpf(hst_init_phase);
+  }
 
-    if (fading[i]) {
-      srsran_channel_fading_execute(fading[i], buffer_in, buffer_out, len, t.full_secs + t.frac_secs);
-      srsran_vec_cf_copy(buffer_in, buffer_out, len);
+  if (not workers.empty()) {
+    {
+      std::lock_guard<std::mutex> lock(workers_mutex);
+      nof_pending = (uint32_t)workers.size();
+      run_count++;
     }
-
-    if (delay[i]) {
-      srsran_channel_delay_execute(delay[i], buffer_in, buffer_out, len, &t);
-      srsran_vec_cf_copy(buffer_in, buffer_out, len);
+    cvar_start.notify_all();
+    run_channel(0);
+    std::unique_lock<std::mutex> lock(workers_mutex);
+    while (nof_pending > 0) {
+      cvar_done.wait(lock);
     }
-
-    if (rlf) {
-      srsran_channel_rlf_execute(rlf, buffer_in, buffer_out, len, &t);
-      srsran_vec_cf_copy(buffer_in, buffer_out, len);
+  } else {
+    for (uint32_t i = 0; i < nof_channels; i++) {
+      run_channel(i);
     }
-
-    // Copy output buffer
-    srsran_vec_cf_copy(out[i], buffer_in, len);
   }
 
   if (hst) {
@@ -231,6 +212,75 @@ void channel::run(cf_t*                     in[SRSRAN_MAX_CHANNELS],
   logger.debug("%s", str.str().c_str());
 }
 
+void channel::run_channel(uint32_t i)
+{
+  // Skip channel if any buffer is null
+  if (run_in[i] == nullptr || run_out[i] == nullptr) {
+    return;
+  }
+
+  // The first enabled stage reads the input buffer, the following ones process the output buffer in place
+  const cf_t* src = run_in[i];
+  cf_t*       dst = run_out[i];
+  uint32_t    len = run_len;
+
+  // If sampling rate is not set, copy input and skip rest of channel
+  if (current_srate != 0) {
+    if (hst) {
+      srsran_vec_apply_cfo(src, -hst->fs_hz / hst->srate_hz, dst, len);
+      srsran_vec_sc_prod_ccc(dst, run_phase, dst, len);
+      src = dst;
+    }
+
+    if (awgn[i]) {
+      srsran_channel_awgn_run_c(awgn[i], src, dst, len);
+      src = dst;
+    }
+
+    if (fading[i]) {
+      srsran_channel_fading_execute(fading[i], src, dst, len, run_ts.full_secs + run_ts.frac_secs);
+      src = dst;
+    }
+
+    if (delay[i]) {
+      srsran_channel_delay_execute(delay[i], src, dst, len, &run_ts);
+      src = dst;
+    }
+
+    if (rlf) {
+      srsran_channel_rlf_execute(rlf, src, dst, len, &run_ts);
+      src = dst;
+    }
+  }
+
+  if (src != dst) {
+    srsran_vec_cf_copy(dst, src, len);
+  }
+}
+
+void channel::run_worker(uint32_t i)
+{
+  uint64_t                     last_run = 0;
+  std::unique_lock<std::mutex> lock(workers_mutex);
+  while (true) {
+    while (not workers_quit && run_count == last_run) {
+      cvar_start.wait(lock);
+    }
+    if (workers_quit) {
+      return;
+    }
+    last_run = run_count;
+
+    lock.unlock();
+    run_channel(i);
+    lock.lock();
+
+    if (--nof_pending == 0) {
+      cvar_done.notify_one();
+    }
+  }
+}
+
 void channel::set_srate(uint32_t srate)
 {
   if (current_srate != srate) {
@@ -257,7 +307,9 @@ void channel::set_srate(uint32_t srate)
 
 void channel::set_signal_power_dBfs(float power_dBfs)
 {
-  if (awgn != nullptr) {
-    srsran_channel_awgn_set_n0(awgn, power_dBfs - args.awgn_snr_dB);
+  for (uint32_t i = 0; i < nof_channels; i++) {
+    if (awgn[i] != nullptr) {
+      srsran_channel_awgn_set_n0(awgn[i], power_dBfs - args.awgn_snr_dB);
+    }
   }
 }
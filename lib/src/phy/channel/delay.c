@@ -120,6 +120,17 @@ void srsran_channel_delay_execute(srsran_channel_delay_t*   q,
     srsran_ringbuffer_read(&q->rb, q->zero_buffer, sizeof(cf_t) * (available_nsamples - q->delay_nsamples));
   }
 
+  if (in == out) {
+    // In-place: save the tail of the input before it is overwritten. It is never longer than the delay
+    srsran_vec_cf_copy(q->zero_buffer, &in[copy_nsamples], read_nsamples);
+    if (copy_nsamples) {
+      memmove(&out[read_nsamples], in, sizeof(cf_t) * copy_nsamples);
+    }
+    srsran_ringbuffer_read(&q->rb, out, sizeof(cf_t) * read_nsamples);
+    srsran_ringbuffer_write(&q->rb, q->zero_buffer, sizeof(cf_t) * read_nsamples);
+    return;
+  }
+
   // Read buffered samples
   srsran_ringbuffer_read(&q->rb, out, sizeof(cf_t) * read_nsamples);
 
@@ -20,6 +20,7 @@
  */
 
 #include "srsran/phy/channel/fading.h"
+#include "fading_models.h"
 #include "srsran/phy/utils/random.h"
 #include "srsran/phy/utils/vector.h"
 #include <math.h>
@@ -45,29 +46,29 @@ const static float relative_power_db[4][SRSRAN_CHANNEL_FADING_MAXTAPS] = {
     /* ETU  */ {-1.0f, -1.0f, -1.0f, +0.0f, +0.0f, +0.0f, -3.0f, -5.0f, -7.0f},
 };
 
-static inline int parse_model(srsran_channel_fading_t* q, const char* str)
+int srsran_channel_fading_model_parse(const char* str, srsran_channel_fading_model_t* model, float* doppler)
 {
   int      ret    = SRSRAN_SUCCESS;
   uint32_t offset = 3;
 
   if (strncmp("none", str, 4) == 0) {
-    q->model = srsran_channel_fading_model_none;
-    offset   = 4;
+    *model = srsran_channel_fading_model_none;
+    offset = 4;
   } else if (strncmp("epa", str, 3) == 0) {
-    q->model = srsran_channel_fading_model_epa;
+    *model = srsran_channel_fading_model_epa;
   } else if (strncmp("eva", str, 3) == 0) {
-    q->model = srsran_channel_fading_model_eva;
+    *model = srsran_channel_fading_model_eva;
   } else if (strncmp("etu", str, 3) == 0) {
-    q->model = srsran_channel_fading_model_etu;
+    *model = srsran_channel_fading_model_etu;
   } else {
     ret = SRSRAN_ERROR;
   }
 
   if (ret == SRSRAN_SUCCESS) {
     if (strlen(str) > offset) {
-      q->doppler = (float)strtod(&str[offset], NULL);
-      if (isnan(q->doppler) || isinf(q->doppler)) {
-        q->doppler = 0.0f;
+      *doppler = (float)strtod(&str[offset], NULL);
+      if (isnan(*doppler) || isinf(*doppler)) {
+        *doppler = 0.0f;
       }
     } else {
       ret = SRSRAN_ERROR;
@@ -77,6 +78,24 @@ static inline int parse_model(srsran_channel_fading_t* q, const char* str)
   return ret;
 }
 
+uint32_t srsran_channel_fading_model_nof_taps(srsran_channel_fading_model_t model)
+{
+  return nof_taps[model];
+}
+
+void srsran_channel_fading_model_size(srsran_channel_fading_model_t model,
+                                      float                         srate,
+                                      uint32_t*                     N,
+                                      uint32_t*                     path_delay,
+                                      uint32_t*                     state_len)
+{
+  uint32_t fft_min_pow = (uint32_t)round(log2(excess_tap_delay_ns[model][nof_taps[model] - 1] * 1e-9 * srate)) + 3;
+  uint32_t N_min       = SRSRAN_MAX(1U << fft_min_pow, (uint32_t)(srate / (15e3f * 4.0f)));
+  *path_delay          = N_min / 4;
+  *state_len           = N_min / 2; // longer than the channel impulse response, including the path delay
+  *N                   = N_min * SRSRAN_CHANNEL_FADING_BATCH;
+}
+
 #ifdef LV_HAVE_SSE
 #include <immintrin.h>
 static inline __m128 _sine(const float* table, __m128 arg)
@@ -89,7 +108,8 @@ static inline __m128 _sine(const float* table, __m128 arg)
       _mm_round_ps(_mm_mul_ps(arg, _mm_set1_ps(1.0f / (2.0f * (float)M_PI))), (_MM_FROUND_TO_ZERO + _MM_FROUND_NO_EXC));
   __m128  argmod   = _mm_sub_ps(arg, _mm_mul_ps(turns, _mm_set1_ps(2.0f * (float)M_PI)));
   __m128  indexps  = _mm_mul_ps(argmod, _mm_set1_ps(1024.0f / (2.0f * (float)M_PI)));
-  __m128i indexi32 = _mm_abs_epi32(_mm_cvtps_epi32(indexps));
+  // The rounding may give an index of 1024 for arguments close to 2 * pi, wrap it around the table
+  __m128i indexi32 = _mm_and_si128(_mm_abs_epi32(_mm_cvtps_epi32(indexps)), _mm_set1_epi32(1023));
   _mm_store_si128((__m128i*)idx, indexi32);
 
   for (int i = 0; i < 4; i++) {
@@ -153,10 +173,15 @@ get_doppler_dispersion(srsran_channel_fading_t* q, float t, float F_d, float* al
 #endif /*LV_HAVE_SSE*/
 }
 
-static inline void generate_tap(float delay_ns, float power_db, float srate, cf_t* buf, uint32_t N, uint32_t path_delay)
+void srsran_channel_fading_model_tap_response(srsran_channel_fading_model_t model,
+                                              uint32_t                      tap,
+                                              float                         srate,
+                                              uint32_t                      N,
+                                              uint32_t                      path_delay,
+                                              cf_t*                         buf)
 {
-  float amplitude = srsran_convert_dB_to_power(power_db);
-  float O         = (delay_ns * 1e-9f * srate + path_delay) / (float)N;
+  float amplitude = srsran_convert_dB_to_power(relative_power_db[model][tap]);
+  float O         = (excess_tap_delay_ns[model][tap] * 1e-9f * srate + path_delay) / (float)N;
   cf_t  a0        = amplitude / N;
 
   srsran_vec_gen_sine(a0, -O, buf, N);
@@ -187,9 +212,14 @@ static inline void generate_taps(srsran_channel_fading_t* q, float time)
 
 static inline void filter_segment(srsran_channel_fading_t* q, const cf_t* input, cf_t* output, uint32_t nsamples)
 {
-  // Fill Input vector
-  srsran_vec_cf_copy(q->temp, input, nsamples);
-  srsran_vec_cf_zero(&q->temp[nsamples], q->N - nsamples);
+  // Overlap-save: the previous input samples are followed by the new ones. The input is fully consumed before the
+  // output is written, so input and output can be the same buffer
+  srsran_vec_cf_copy(q->temp, q->state, q->state_len);
+  srsran_vec_cf_copy(&q->temp[q->state_len], input, nsamples);
+  srsran_vec_cf_zero(&q->temp[q->state_len + nsamples], q->N - q->state_len - nsamples);
+
+  // Save the last input samples for the next segment
+  srsran_vec_cf_copy(q->state, &q->temp[nsamples], q->state_len);
 
   // Do FFT
   srsran_dft_run_c_zerocopy(&q->fft, q->temp, q->y_freq);
@@ -200,15 +230,8 @@ static inline void filter_segment(srsran_channel_fading_t* q, const cf_t* input,
   // Do iFFT
   srsran_dft_run_c_zerocopy(&q->ifft, q->y_freq, q->temp);
 
-  // Add state
-  srsran_vec_sum_ccc(q->temp, q->state, q->temp, q->state_len);
-
-  // Copy the first nsamples into the output
-  srsran_vec_cf_copy(output, q->temp, nsamples);
-
-  // Copy the rest of the samples into the state
-  q->state_len = q->N - nsamples;
-  srsran_vec_cf_copy(q->state, &q->temp[nsamples], q->state_len);
+  // The first state_len samples are corrupted by the circular convolution, discard them
+  srsran_vec_cf_copy(output, &q->temp[q->state_len], nsamples);
 }
 
 int srsran_channel_fading_init(srsran_channel_fading_t* q, double srate, const char* model, uint32_t seed)
@@ -217,7 +240,7 @@ int srsran_channel_fading_init(srsran_channel_fading_t* q, double srate, const c
 
   if (q) {
     // Parse model
-    if (parse_model(q, model) != SRSRAN_SUCCESS) {
+    if (srsran_channel_fading_model_parse(model, &q->model, &q->doppler) != SRSRAN_SUCCESS) {
       fprintf(stderr, "Error: invalid channel model '%s'\n", model);
       goto clean_exit;
     }
@@ -226,11 +249,7 @@ int srsran_channel_fading_init(srsran_channel_fading_t* q, double srate, const c
     q->srate = (float)srate;
 
     // Populate internal parameters
-    uint32_t fft_min_pow =
-        (uint32_t)round(log2(excess_tap_delay_ns[q->model][nof_taps[q->model] - 1] * 1e-9 * srate)) + 3;
-    q->N          = SRSRAN_MAX(1U << fft_min_pow, (uint32_t)(srate / (15e3f * 4.0f)));
-    q->path_delay = q->N / 4;
-    q->state_len  = 0;
+    srsran_channel_fading_model_size(q->model, q->srate, &q->N, &q->path_delay, &q->state_len);
 
     // Initialise random number
     srsran_random_t* random = srsran_random_init(seed);
@@ -248,8 +267,7 @@ int srsran_channel_fading_init(srsran_channel_fading_t* q, double srate, const c
       q->h_tap[i] = srsran_vec_cf_malloc(q->N);
 
       // Generate tap frequency response
-      generate_tap(
-          excess_tap_delay_ns[q->model][i], relative_power_db[q->model][i], q->srate, q->h_tap[i], q->N, q->path_delay);
+      srsran_channel_fading_model_tap_response(q->model, i, q->srate, q->N, q->path_delay, q->h_tap[i]);
     }
 
     // Generate sine Table
@@ -348,8 +366,8 @@ double srsran_channel_fading_execute(srsran_channel_fading_t* q,
       // Generate taps
       generate_taps(q, (float)init_time);
 
-      // Do not process more than N/2 samples
-      uint32_t n = SRSRAN_MIN(q->N / 2, nsamples - counter);
+      // Do not process more samples than the FFT size minus the overlap
+      uint32_t n = SRSRAN_MIN(q->N - q->state_len, nsamples - counter);
 
       // Execute
       filter_segment(q, &in[counter], &out[counter], n);
@@ -0,0 +1,402 @@
+/**
+ * Copyright 2013-2021 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "srsran/phy/channel/fading_mimo.h"
+#include "fading_models.h"
+#include "srsran/phy/utils/random.h"
+#include "srsran/phy/utils/vector.h"
+#include <complex.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Accumulated rounding errors slowly change the phasor amplitudes, normalise them every so many rotations
+#define FADING_MIMO_NORM_PERIOD 1024
+
+/*
+ * Correlation between antennas of the eNodeB (alpha) and the UE (beta), 36.101 Table B.2.3.2-1
+ */
+const static float corr_alpha[3] = {0.0f, 0.3f, 0.9f};
+const static float corr_beta[3]  = {0.0f, 0.9f, 0.9f};
+
+/*
+ * Diagonal loading of the 4x4 correlation matrices, 36.101 Table B.2.3.2-3, keeps them positive definite
+ */
+const static float corr_loading[3] = {0.0f, 0.00012f, 0.00001f};
+
+int srsran_channel_fading_corr_parse(const char* str, srsran_channel_fading_corr_t* corr)
+{
+  if (strcmp("low", str) == 0) {
+    *corr = srsran_channel_fading_corr_low;
+  } else if (strcmp("medium", str) == 0) {
+    *corr = srsran_channel_fading_corr_medium;
+  } else if (strcmp("high", str) == 0) {
+    *corr = srsran_channel_fading_corr_high;
+  } else {
+    return SRSRAN_ERROR;
+  }
+  return SRSRAN_SUCCESS;
+}
+
+// Correlation between two of nof_ports antennas, 36.101 Table B.2.3.1-1
+static inline double port_corr(double a, uint32_t nof_ports, uint32_t i, uint32_t j)
+{
+  if (i == j || nof_ports < 2) {
+    return 1.0;
+  }
+  double d = fabs((double)i - (double)j) / (double)(nof_ports - 1);
+  return pow(a, d * d);
+}
+
+// Computes the lower triangular square root of R_spat = R_tx (x) R_rx
+static int corr_init(srsran_channel_fading_mimo_t* q, bool enb_tx)
+{
+  double   R[SRSRAN_CHANNEL_FADING_MIMO_MAX_PATHS][SRSRAN_CHANNEL_FADING_MIMO_MAX_PATHS];
+  double   a_tx = enb_tx ? corr_alpha[q->corr] : corr_beta[q->corr];
+  double   a_rx = enb_tx ? corr_beta[q->corr] : corr_alpha[q->corr];
+  double   load = (q->nof_tx == 4 && q->nof_rx == 4) ? corr_loading[q->corr] : 0.0;
+  uint32_t P    = q->nof_paths;
+
+  for (uint32_t i = 0; i < P; i++) {
+    for (uint32_t j = 0; j < P; j++) {
+      R[i][j] = port_corr(a_tx, q->nof_tx, i / q->nof_rx, j / q->nof_rx) *
+                port_corr(a_rx, q->nof_rx, i % q->nof_rx, j % q->nof_rx);
+      if (i == j) {
+        R[i][j] = (R[i][j] + load) / (1.0 + load);
+      } else {
+        R[i][j] = R[i][j] / (1.0 + load);
+      }
+    }
+  }
+
+  // Cholesky decomposition, R = C * C^T
+  double C[SRSRAN_CHANNEL_FADING_MIMO_MAX_PATHS][SRSRAN_CHANNEL_FADING_MIMO_MAX_PATHS] = {};
+  for (uint32_t i = 0; i < P; i++) {
+    for (uint32_t j = 0; j <= i; j++) {
+      double acc = R[i][j];
+      for (uint32_t k = 0; k < j; k++) {
+        acc -= C[i][k] * C[j][k];
+      }
+      if (i == j) {
+        if (acc <= 0.0) {
+          return SRSRAN_ERROR;
+        }
+        C[i][i] = sqrt(acc);
+      } else {
+        C[i][j] = acc / C[j][j];
+      }
+    }
+  }
+
+  for (uint32_t i = 0; i < P; i++) {
+    for (uint32_t j = 0; j < P; j++) {
+      q->corr_sqrt[i * P + j] = (float)C[i][j];
+    }
+  }
+
+  return SRSRAN_SUCCESS;
+}
+
+static void rotation_init(srsran_channel_fading_mimo_t* q, cf_t* rotation, uint32_t nof_samples)
+{
+  uint32_t len = q->nof_processes * SRSRAN_CHANNEL_FADING_NTERMS;
+  for (uint32_t i = 0; i < len; i++) {
+    float arg = q->omega[i] * (float)nof_samples;
+    __real__ rotation[i] = cosf(arg);
+    __imag__ rotation[i] = sinf(arg);
+  }
+}
+
+static inline void generate_gains(srsran_channel_fading_mimo_t* q)
+{
+  const float recN = 1.0f / sqrtf(SRSRAN_CHANNEL_FADING_NTERMS);
+  uint32_t    P    = q->nof_paths;
+  cf_t        z[SRSRAN_CHANNEL_FADING_MIMO_MAX_PATHS];
+
+  for (uint32_t i = 0; i < q->nof_processes; i += P) {
+    // Uncorrelated gains of all the paths of a tap
+    for (uint32_t p = 0; p < P; p++) {
+      z[p] = srsran_vec_acc_cc(&q->phasor[(i + p) * SRSRAN_CHANNEL_FADING_NTERMS], SRSRAN_CHANNEL_FADING_NTERMS) * recN;
+    }
+
+    // Apply the spatial correlation
+    for (uint32_t p = 0; p < P; p++) {
+      cf_t g = 0;
+      for (uint32_t k = 0; k <= p; k++) {
+        g += q->corr_sqrt[p * P + k] * z[k];
+      }
+      q->gain[i + p] = g;
+    }
+  }
+}
+
+static inline void advance_phasors(srsran_channel_fading_mimo_t* q, uint32_t nof_samples)
+{
+  uint32_t len = q->nof_processes * SRSRAN_CHANNEL_FADING_NTERMS;
+
+  if (nof_samples == q->N - q->state_len) {
+    srsran_vec_prod_ccc(q->phasor, q->rotation, q->phasor, len);
+  } else {
+    // Every call ends with a partial segment, usually of the same length
+    if (nof_samples != q->partial_len) {
+      rotation_init(q, q->rotation_partial, nof_samples);
+      q->partial_len = nof_samples;
+    }
+    srsran_vec_prod_ccc(q->phasor, q->rotation_partial, q->phasor, len);
+  }
+
+  if (++q->nof_rotations == FADING_MIMO_NORM_PERIOD) {
+    for (uint32_t i = 0; i < len; i++) {
+      q->phasor[i] /= cabsf(q->phasor[i]);
+    }
+    q->nof_rotations = 0;
+  }
+}
+
+static inline void filter_link(srsran_channel_fading_mimo_t* q,
+                               uint32_t                      link,
+                               cf_t**                        input,
+                               cf_t**                        output,
+                               uint32_t                      offset,
+                               uint32_t                      nsamples)
+{
+  // Overlap-save of every transmit antenna. All the inputs are transformed before any output is written, so input and
+  // output can be the same buffers
+  for (uint32_t tx = 0; tx < q->nof_tx; tx++) {
+    cf_t* state = &q->state[(link * q->nof_tx + tx) * q->state_len];
+
+    srsran_vec_cf_copy(q->temp, state, q->state_len);
+    srsran_vec_cf_copy(&q->temp[q->state_len], &input[link * q->nof_tx + tx][offset], nsamples);
+    srsran_vec_cf_zero(&q->temp[q->state_len + nsamples], q->N - q->state_len - nsamples);
+    srsran_vec_cf_copy(state, &q->temp[nsamples], q->state_len);
+
+    srsran_dft_run_c_zerocopy(&q->fft, q->temp, &q->x_freq[tx * q->N]);
+  }
+
+  const cf_t* gain = &q->gain[link * q->nof_taps * q->nof_paths];
+  for (uint32_t rx = 0; rx < q->nof_rx; rx++) {
+    for (uint32_t tx = 0; tx < q->nof_tx; tx++) {
+      uint32_t path = tx * q->nof_rx + rx;
+
+      // Frequency response of the path
+      srsran_vec_sc_prod_ccc(q->h_tap[0], gain[path], q->h_freq, q->N);
+      for (uint32_t i = 1; i < q->nof_taps; i++) {
+        srsran_vec_sc_prod_ccc(q->h_tap[i], gain[i * q->nof_paths + path], q->temp, q->N);
+        srsran_vec_sum_ccc(q->h_freq, q->temp, q->h_freq, q->N);
+      }
+
+      // Apply it and combine with the other transmit antennas
+      if (tx) {
+        srsran_vec_prod_ccc(&q->x_freq[tx * q->N], q->h_freq, q->temp, q->N);
+        srsran_vec_sum_ccc(q->y_freq, q->temp, q->y_freq, q->N);
+      } else {
+        srsran_vec_prod_ccc(&q->x_freq[tx * q->N], q->h_freq, q->y_freq, q->N);
+      }
+    }
+
+    srsran_dft_run_c_zerocopy(&q->ifft, q->y_freq, q->temp);
+
+    // The first state_len samples are corrupted by the circular convolution, discard them
+    srsran_vec_cf_copy(&output[link * q->nof_rx + rx][offset], &q->temp[q->state_len], nsamples);
+  }
+}
+
+int srsran_channel_fading_mimo_init(srsran_channel_fading_mimo_t* q,
+                                    double                        srate,
+                                    const char*                   model,
+                                    srsran_channel_fading_corr_t  corr,
+                                    bool                          enb_tx,
+                                    uint32_t                      nof_links,
+                                    uint32_t                      nof_tx,
+                                    uint32_t                      nof_rx,
+                                    uint32_t                      seed)
+{
+  if (q == NULL || nof_links == 0 || nof_tx == 0 || nof_tx > SRSRAN_CHANNEL_FADING_MIMO_MAX_PORTS || nof_rx == 0 ||
+      nof_rx > SRSRAN_CHANNEL_FADING_MIMO_MAX_PORTS || corr > srsran_channel_fading_corr_high) {
+    return SRSRAN_ERROR_INVALID_INPUTS;
+  }
+
+  memset(q, 0, sizeof(srsran_channel_fading_mimo_t));
+
+  if (srsran_channel_fading_model_parse(model, &q->model, &q->doppler) != SRSRAN_SUCCESS) {
+    fprintf(stderr, "Error: invalid channel model '%s'\n", model);
+    return SRSRAN_ERROR;
+  }
+
+  q->srate         = (float)srate;
+  q->corr          = corr;
+  q->nof_links     = nof_links;
+  q->nof_tx        = nof_tx;
+  q->nof_rx        = nof_rx;
+  q->nof_paths     = nof_tx * nof_rx;
+  q->nof_taps      = srsran_channel_fading_model_nof_taps(q->model);
+  q->nof_processes = nof_links * q->nof_taps * q->nof_paths;
+  srsran_channel_fading_model_size(q->model, q->srate, &q->N, &q->path_delay, &q->state_len);
+
+  if (corr_init(q, enb_tx) != SRSRAN_SUCCESS) {
+    fprintf(stderr, "Error: spatial correlation matrix is not positive definite\n");
+    return SRSRAN_ERROR;
+  }
+
+  // Allocate memory
+  uint32_t nof_terms  = q->nof_processes * SRSRAN_CHANNEL_FADING_NTERMS;
+  q->phasor           = srsran_vec_cf_malloc(nof_terms);
+  q->omega            = srsran_vec_f_malloc(nof_terms);
+  q->rotation         = srsran_vec_cf_malloc(nof_terms);
+  q->rotation_partial = srsran_vec_cf_malloc(nof_terms);
+  q->gain             = srsran_vec_cf_malloc(q->nof_processes);
+  q->temp             = srsran_vec_cf_malloc(q->N);
+  q->h_freq           = srsran_vec_cf_malloc(q->N);
+  q->x_freq           = srsran_vec_cf_malloc(q->N * nof_tx);
+  q->y_freq           = srsran_vec_cf_malloc(q->N);
+  q->state            = srsran_vec_cf_malloc(q->state_len * nof_links * nof_tx);
+  if (!q->phasor || !q->omega || !q->rotation || !q->rotation_partial || !q->gain || !q->temp || !q->h_freq ||
+      !q->x_freq || !q->y_freq || !q->state) {
+    fprintf(stderr, "Error: allocating memory\n");
+    srsran_channel_fading_mimo_free(q);
+    return SRSRAN_ERROR;
+  }
+  srsran_vec_cf_zero(q->state, q->state_len * nof_links * nof_tx);
+
+  // Tap frequency responses, FFT-shifted once here rather than every segment
+  for (uint32_t i = 0; i < q->nof_taps; i++) {
+    q->h_tap[i] = srsran_vec_cf_malloc(q->N);
+    if (!q->h_tap[i]) {
+      fprintf(stderr, "Error: allocating memory\n");
+      srsran_channel_fading_mimo_free(q);
+      return SRSRAN_ERROR;
+    }
+    srsran_channel_fading_model_tap_response(q->model, i, q->srate, q->N, q->path_delay, q->temp);
+    srsran_vec_cf_copy(q->h_tap[i], &q->temp[q->N / 2], q->N / 2);
+    srsran_vec_cf_copy(&q->h_tap[i][q->N / 2], q->temp, q->N / 2);
+  }
+
+  // Sum of sinusoids with random angles of arrival and phases, every process is independent
+  srsran_random_t random = srsran_random_init(seed);
+  for (uint32_t i = 0; i < q->nof_processes; i++) {
+    float theta = srsran_random_uniform_real_dist(random, -(float)M_PI, (float)M_PI);
+    for (uint32_t j = 0; j < SRSRAN_CHANNEL_FADING_NTERMS; j++) {
+      float alpha = (2.0f * (float)M_PI * (float)j - (float)M_PI + theta) / SRSRAN_CHANNEL_FADING_NTERMS;
+      float phi   = srsran_random_uniform_real_dist(random, 0, 2.0f * (float)M_PI);
+
+      q->omega[i * SRSRAN_CHANNEL_FADING_NTERMS + j] = 2.0f * (float)M_PI * q->doppler * cosf(alpha) / q->srate;
+      __real__ q->phasor[i * SRSRAN_CHANNEL_FADING_NTERMS + j] = cosf(phi);
+      __imag__ q->phasor[i * SRSRAN_CHANNEL_FADING_NTERMS + j] = sinf(phi);
+    }
+  }
+  srsran_random_free(random);
+
+  // Doppler tables: phasor rotation over a full segment
+  rotation_init(q, q->rotation, q->N - q->state_len);
+
+  // Plan FFT
+  if (srsran_dft_plan_c(&q->fft, q->N, SRSRAN_DFT_FORWARD) != SRSRAN_SUCCESS) {
+    fprintf(stderr, "Error: planning fft\n");
+    srsran_channel_fading_mimo_free(q);
+    return SRSRAN_ERROR;
+  }
+
+  // Plan iFFT
+  if (srsran_dft_plan_c(&q->ifft, q->N, SRSRAN_DFT_BACKWARD) != SRSRAN_SUCCESS) {
+    fprintf(stderr, "Error: planning ifft\n");
+    srsran_channel_fading_mimo_free(q);
+    return SRSRAN_ERROR;
+  }
+
+  return SRSRAN_SUCCESS;
+}
+
+void srsran_channel_fading_mimo_free(srsran_channel_fading_mimo_t* q)
+{
+  if (q) {
+    srsran_dft_plan_free(&q->fft);
+    srsran_dft_plan_free(&q->ifft);
+
+    for (uint32_t i = 0; i < SRSRAN_CHANNEL_FADING_MAXTAPS; i++) {
+      if (q->h_tap[i]) {
+        free(q->h_tap[i]);
+      }
+    }
+
+    if (q->phasor) {
+      free(q->phasor);
+    }
+    if (q->omega) {
+      free(q->omega);
+    }
+    if (q->rotation) {
+      free(q->rotation);
+    }
+    if (q->rotation_partial) {
+      free(q->rotation_partial);
+    }
+    if (q->gain) {
+      free(q->gain);
+    }
+    if (q->temp) {
+      free(q->temp);
+    }
+    if (q->h_freq) {
+      free(q->h_freq);
+    }
+    if (q->x_freq) {
+      free(q->x_freq);
+    }
+    if (q->y_freq) {
+      free(q->y_freq);
+    }
+    if (q->state) {
+      free(q->state);
+    }
+
+    memset(q, 0, sizeof(srsran_channel_fading_mimo_t));
+  }
+}
+
+int srsran_channel_fading_mimo_execute(srsran_channel_fading_mimo_t* q,
+                                       cf_t**                        in,
+                                       cf_t**                        out,
+                                       uint32_t                      nof_samples)
+{
+  if (q == NULL || in == NULL || out == NULL) {
+    return SRSRAN_ERROR_INVALID_INPUTS;
+  }
+
+  uint32_t counter = 0;
+  while (counter < nof_samples) {
+    // Do not process more samples than the FFT size minus the overlap
+    uint32_t n = SRSRAN_MIN(q->N - q->state_len, nof_samples - counter);
+
+    // Tap gains of all links at the beginning of the segment
+    generate_gains(q);
+
+    for (uint32_t link = 0; link < q->nof_links; link++) {
+      filter_link(q, link, in, out, counter, n);
+    }
+
+    advance_phasors(q, n);
+
+    counter += n;
+  }
+
+  return SRSRAN_SUCCESS;
+}
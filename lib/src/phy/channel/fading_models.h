@@ -0,0 +1,50 @@
+/**
+ * Copyright 2013-2021 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#ifndef SRSRAN_FADING_MODELS_H
+#define SRSRAN_FADING_MODELS_H
+
+#include "srsran/phy/channel/fading.h"
+
+/*
+ * Multi-path model tables shared by the SISO and the multi-link fading engines
+ */
+
+int srsran_channel_fading_model_parse(const char* str, srsran_channel_fading_model_t* model, float* doppler);
+
+uint32_t srsran_channel_fading_model_nof_taps(srsran_channel_fading_model_t model);
+
+// Overlap-save dimensions: FFT size, path delay and overlap, all in samples
+void srsran_channel_fading_model_size(srsran_channel_fading_model_t model,
+                                      float                         srate,
+                                      uint32_t*                     N,
+                                      uint32_t*                     path_delay,
+                                      uint32_t*                     state_len);
+
+// Frequency response of a tap, length N, not FFT-shifted
+void srsran_channel_fading_model_tap_response(srsran_channel_fading_model_t model,
+                                              uint32_t                      tap,
+                                              float                         srate,
+                                              uint32_t                      N,
+                                              uint32_t                      path_delay,
+                                              cf_t*                         buf);
+
+#endif // SRSRAN_FADING_MODELS_H
@@ -48,7 +48,9 @@ void srsran_channel_rlf_execute(srsran_channel_rlf_t*     q,
 
   // Decide whether enables or disables channel
   if (time_ms < q->t_on_ms) {
-    srsran_vec_sc_prod_cfc(in, 1.0f, out, nsamples);
+    if (in != out) {
+      srsran_vec_cf_copy(out, in, nsamples);
+    }
   } else {
     srsran_vec_sc_prod_cfc(in, 0.0f, out, nsamples);
   }
@@ -0,0 +1,224 @@
+/**
+ * Copyright 2013-2021 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "srsran/common/test_common.h"
+#include "srsran/phy/channel/channel.h"
+#include "srsran/phy/utils/vector.h"
+#include <chrono>
+#include <getopt.h>
+#include <memory>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string>
+
+static std::string model        = "epa5";
+static uint32_t    nof_prb      = 25;
+static uint32_t    nof_channels = 1;
+static uint32_t    nof_sf       = 100;
+
+static void usage(char* prog)
+{
+  printf("Usage: %s [mpat]\n", prog);
+  printf("\t-m Fading model: epa5, eva70, etu300, etc [Default %s]\n", model.c_str());
+  printf("\t-p Number of PRB [Default %d]\n", nof_prb);
+  printf("\t-a Number of antennas [Default %d]\n", nof_channels);
+  printf("\t-t Number of subframes [Default %d]\n", nof_sf);
+}
+
+static void parse_args(int argc, char** argv)
+{
+  int opt;
+  while ((opt = getopt(argc, argv, "mpat")) != -1) {
+    switch (opt) {
+      case 'm':
+        model = argv[optind];
+        break;
+      case 'p':
+        nof_prb = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      case 'a':
+        nof_channels = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      case 't':
+        nof_sf = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      default:
+        usage(argv[0]);
+        exit(-1);
+    }
+  }
+}
+
+// One subframe per antenna
+struct sf_buffers {
+  cf_t* ant[SRSRAN_MAX_CHANNELS] = {};
+
+  sf_buffers()
+  {
+    for (uint32_t i = 0; i < nof_channels; i++) {
+      ant[i] = srsran_vec_cf_malloc(SRSRAN_SF_LEN_PRB(nof_prb));
+    }
+  }
+  ~sf_buffers()
+  {
+    for (uint32_t i = 0; i < nof_channels; i++) {
+      free(ant[i]);
+    }
+  }
+  void copy_from(const sf_buffers& other)
+  {
+    for (uint32_t i = 0; i < nof_channels; i++) {
+      srsran_vec_cf_copy(ant[i], other.ant[i], SRSRAN_SF_LEN_PRB(nof_prb));
+    }
+  }
+  bool operator==(const sf_buffers& other) const
+  {
+    for (uint32_t i = 0; i < nof_channels; i++) {
+      if (memcmp(ant[i], other.ant[i], sizeof(cf_t) * SRSRAN_SF_LEN_PRB(nof_prb)) != 0) {
+        return false;
+      }
+    }
+    return true;
+  }
+};
+
+// All stages enabled, so that every one of them is run in place
+static std::unique_ptr<srsran::channel> make_channel(bool parallel)
+{
+  srsran::channel::args_t args = {};
+  args.enable                  = true;
+  args.awgn_enable             = true;
+  args.awgn_snr_dB             = 20.0f;
+  args.fading_enable           = true;
+  args.fading_model            = model;
+  args.delay_enable            = true;
+  args.delay_period_s          = 1.0f;
+  args.hst_enable              = true;
+  args.parallel_enable         = parallel;
+
+  std::unique_ptr<srsran::channel> c(new srsran::channel(args, nof_channels, srslog::fetch_basic_logger("CHAN")));
+  c->set_srate((uint32_t)srsran_sampling_freq_hz(nof_prb));
+  return c;
+}
+
+static void fill_input(sf_buffers& in, uint32_t sf)
+{
+  for (uint32_t i = 0; i < nof_channels; i++) {
+    for (uint32_t j = 0; j < (uint32_t)SRSRAN_SF_LEN_PRB(nof_prb); j++) {
+      __real__ in.ant[i][j] = ((j * 7 + i + sf) % 13) / 13.0f - 0.5f;
+      __imag__ in.ant[i][j] = ((j * 11 + i + sf) % 17) / 17.0f - 0.5f;
+    }
+  }
+}
+
+static srsran_timestamp_t sf_timestamp(uint32_t sf)
+{
+  srsran_timestamp_t ts = {};
+  srsran_timestamp_init(&ts, 0, sf * 1e-3);
+  return ts;
+}
+
+int test_in_place()
+{
+  std::unique_ptr<srsran::channel> out_of_place = make_channel(false);
+  std::unique_ptr<srsran::channel> in_place     = make_channel(false);
+
+  sf_buffers in, out, inout;
+  for (uint32_t sf = 0; sf < nof_sf; sf++) {
+    fill_input(in, sf);
+    inout.copy_from(in);
+    out_of_place->run(in.ant, out.ant, SRSRAN_SF_LEN_PRB(nof_prb), sf_timestamp(sf));
+    in_place->run(inout.ant, inout.ant, SRSRAN_SF_LEN_PRB(nof_prb), sf_timestamp(sf));
+
+    // TEST: running in place gives the same output as running out of place
+    TESTASSERT(out == inout);
+    for (uint32_t i = 0; i < nof_channels; i++) {
+      TESTASSERT(std::isnormal(srsran_vec_avg_power_cf(out.ant[i], SRSRAN_SF_LEN_PRB(nof_prb))));
+    }
+  }
+  return SRSRAN_SUCCESS;
+}
+
+int test_parallel()
+{
+  std::unique_ptr<srsran::channel> serial   = make_channel(false);
+  std::unique_ptr<srsran::channel> parallel = make_channel(true);
+
+  sf_buffers in, out_serial, out_parallel;
+  for (uint32_t sf = 0; sf < nof_sf; sf++) {
+    fill_input(in, sf);
+    serial->run(in.ant, out_serial.ant, SRSRAN_SF_LEN_PRB(nof_prb), sf_timestamp(sf));
+    parallel->run(in.ant, out_parallel.ant, SRSRAN_SF_LEN_PRB(nof_prb), sf_timestamp(sf));
+
+    // TEST: the antennas processed by the workers match the serial emulator bit by bit
+    TESTASSERT(out_serial == out_parallel);
+  }
+  return SRSRAN_SUCCESS;
+}
+
+// Reports how much of the 1 ms subframe is left once the emulator has run
+int test_realtime_margin()
+{
+  std::unique_ptr<srsran::channel> serial   = make_channel(false);
+  std::unique_ptr<srsran::channel> parallel = make_channel(true);
+
+  sf_buffers               in, buffer;
+  std::chrono::nanoseconds serial_ns(0), parallel_ns(0);
+  for (uint32_t sf = 0; sf < nof_sf; sf++) {
+    fill_input(in, sf);
+    auto t0 = std::chrono::steady_clock::now();
+    serial->run(in.ant, buffer.ant, SRSRAN_SF_LEN_PRB(nof_prb), sf_timestamp(sf));
+    auto t1 = std::chrono::steady_clock::now();
+    buffer.copy_from(in);
+    auto t2 = std::chrono::steady_clock::now();
+    parallel->run(buffer.ant, buffer.ant, SRSRAN_SF_LEN_PRB(nof_prb), sf_timestamp(sf));
+    auto t3 = std::chrono::steady_clock::now();
+    serial_ns += t1 - t0;
+    parallel_ns += t3 - t2;
+  }
+
+  double serial_us   = serial_ns.count() / 1e3 / nof_sf;
+  double parallel_us = parallel_ns.count() / 1e3 / nof_sf;
+  printf("model=%s; nof_prb=%d; nof_antennas=%d; serial=%.1f us/sf (margin %.1f%%); parallel in place=%.1f us/sf "
+         "(margin %.1f%%);\n",
+         model.c_str(),
+         nof_prb,
+         nof_channels,
+         serial_us,
+         100.0 * (1000.0 - serial_us) / 1000.0,
+         parallel_us,
+         100.0 * (1000.0 - parallel_us) / 1000.0);
+  return SRSRAN_SUCCESS;
+}
+
+int main(int argc, char** argv)
+{
+  parse_args(argc, argv);
+  TESTASSERT(nof_channels > 0 and nof_channels <= SRSRAN_MAX_CHANNELS);
+
+  srslog::fetch_basic_logger("CHAN", false).set_level(srslog::basic_levels::warning);
+  srslog::init();
+
+  TESTASSERT(test_in_place() == SRSRAN_SUCCESS);
+  TESTASSERT(test_parallel() == SRSRAN_SUCCESS);
+  TESTASSERT(test_realtime_margin() == SRSRAN_SUCCESS);
+  return SRSRAN_SUCCESS;
+}
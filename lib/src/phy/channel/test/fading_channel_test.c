@@ -20,6 +20,7 @@
  */
 
 #include "srsran/phy/channel/fading.h"
+#include "srsran/phy/utils/random.h"
 #include "srsran/phy/utils/vector.h"
 #include <complex.h>
 #include <math.h>
@@ -46,6 +47,9 @@ static uint32_t random_seed     = 0x12345678; // Default seed, deterministic cha
 
 #define INPUT_TYPE 0 /* 0: Dirac Delta; Otherwise: Random*/
 
+#define ACCURACY_SRATE 100e6        /* All the tap delays are multiples of 10 ns, the impulse response is exact */
+#define ACCURACY_MAX_ERROR_DB -60.0 /* Maximum error power of the filter relative to the direct convolution */
+
 static void usage(char* prog)
 {
   printf("Usage: %s [mts]\n", prog);
@@ -87,6 +91,97 @@ static void parse_args(int argc, char** argv)
   }
 }
 
+/*
+ * Filters random samples through the selected model without Doppler, so that the channel is static, and compares the
+ * overlap-save output against a direct convolution with the impulse response of the channel frequency response
+ */
+static int test_accuracy(void)
+{
+  int                     ret         = SRSRAN_ERROR;
+  srsran_channel_fading_t q           = {};
+  srsran_dft_plan_t       ifft        = {};
+  cf_t*                   input       = NULL;
+  cf_t*                   output      = NULL;
+  cf_t*                   h           = NULL;
+  srsran_random_t         random      = srsran_random_init(random_seed);
+  uint32_t                nsamples    = 0;
+  uint32_t                count       = 0;
+  double                  ref_power   = 0.0;
+  double                  error_power = 0.0;
+
+  if (strncmp(model, "none", 4) == 0) {
+    ret = SRSRAN_SUCCESS;
+    goto clean_exit;
+  }
+
+  // The model without the Doppler frequency, e.g. "epa0" for "epa5"
+  char static_model[8];
+  snprintf(static_model, sizeof(static_model), "%.3s0", model);
+  if (srsran_channel_fading_init(&q, ACCURACY_SRATE, static_model, random_seed)) {
+    fprintf(stderr, "Error: initialising fading channel. model=%s, srate=%.0f\n", static_model, ACCURACY_SRATE);
+    goto clean_exit;
+  }
+
+  nsamples = 2 * q.N;
+  input    = srsran_vec_cf_malloc(nsamples);
+  output   = srsran_vec_cf_malloc(nsamples);
+  h        = srsran_vec_cf_malloc(q.N);
+  if (!input || !output || !h || srsran_dft_plan_c(&ifft, q.N, SRSRAN_DFT_BACKWARD)) {
+    fprintf(stderr, "Error: allocating accuracy test buffers\n");
+    goto clean_exit;
+  }
+
+  for (uint32_t i = 0; i < nsamples; i++) {
+    input[i] = srsran_random_uniform_complex_dist(random, -1.0f, 1.0f);
+  }
+
+  // The first call spans several segments, the next ones carry the overlap over between calls
+  while (count < nsamples) {
+    uint32_t n = SRSRAN_MIN(nsamples - count, count == 0 ? q.N + 1 : q.N / 4);
+    srsran_channel_fading_execute(&q, &input[count], &output[count], n, (double)count / ACCURACY_SRATE);
+    count += n;
+  }
+
+  // The frequency response does not change without Doppler, the filter applies its inverse DFT as impulse response
+  srsran_dft_run_c(&ifft, q.h_freq, h);
+
+  for (uint32_t n = 0; n < nsamples; n++) {
+    double complex y = 0;
+    for (uint32_t k = 0; k <= q.state_len && k <= n; k++) {
+      y += h[k] * input[n - k];
+    }
+    ref_power += creal(y * conj(y));
+    error_power += creal((output[n] - y) * conj(output[n] - y));
+  }
+
+  double error_db = 10.0 * log10(error_power / ref_power);
+  printf("-- Overlap-save accuracy. model=%s; error=%.1fdB\n", static_model, error_db);
+  if (error_db > ACCURACY_MAX_ERROR_DB) {
+    fprintf(stderr,
+            "Error: the filter output is %.1fdB away from the direct convolution (max %.1fdB)\n",
+            error_db,
+            ACCURACY_MAX_ERROR_DB);
+    goto clean_exit;
+  }
+
+  ret = SRSRAN_SUCCESS;
+
+clean_exit:
+  if (input) {
+    free(input);
+  }
+  if (output) {
+    free(output);
+  }
+  if (h) {
+    free(h);
+  }
+  srsran_dft_plan_free(&ifft);
+  srsran_random_free(random);
+  srsran_channel_fading_free(&q);
+  return ret;
+}
+
 int main(int argc, char** argv)
 {
   int            ret           = SRSRAN_ERROR;
@@ -151,6 +246,10 @@ int main(int argc, char** argv)
   }
 #endif /* ENABLE_GUI */
 
+  if (test_accuracy() != SRSRAN_SUCCESS) {
+    goto clean_exit;
+  }
+
   // Initialise channel
   if (srsran_channel_fading_init(&channel_fading, srate, model, 0x12345678)) {
     fprintf(stderr, "Error: initialising fading channel. model=%s, srate=%d\n", model, srate);
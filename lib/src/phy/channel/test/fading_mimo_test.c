@@ -0,0 +1,291 @@
+/**
+ * Copyright 2013-2021 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "srsran/phy/channel/fading_mimo.h"
+#include "srsran/phy/utils/debug.h"
+#include "srsran/phy/utils/random.h"
+#include "srsran/phy/utils/vector.h"
+#include <complex.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+static char     default_model[] = "eva70";
+static char     default_corr[]  = "medium";
+static char*    model           = default_model;
+static char*    corr_str        = default_corr;
+static uint32_t nof_links       = 16;
+static uint32_t nof_tx          = 2;
+static uint32_t nof_rx          = 2;
+static uint32_t duration_ms     = 100;
+static uint32_t srate           = (uint32_t)7.68e6;
+
+static void usage(char* prog)
+{
+  printf("Usage: %s [mcltrds]\n", prog);
+  printf("\t-m Channel model: epa5, eva70, etu300 [Default %s]\n", model);
+  printf("\t-c Spatial correlation: low, medium, high [Default %s]\n", corr_str);
+  printf("\t-l Number of links [Default %d]\n", nof_links);
+  printf("\t-t Transmit antennas per link [Default %d]\n", nof_tx);
+  printf("\t-r Receive antennas per link [Default %d]\n", nof_rx);
+  printf("\t-d Simulation time in ms [Default %d]\n", duration_ms);
+  printf("\t-s Sampling rate in Hz [Default %d]\n", srate);
+}
+
+static void parse_args(int argc, char** argv)
+{
+  int opt;
+  while ((opt = getopt(argc, argv, "mcltrds")) != -1) {
+    switch (opt) {
+      case 'm':
+        model = argv[optind];
+        break;
+      case 'c':
+        corr_str = argv[optind];
+        break;
+      case 'l':
+        nof_links = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      case 't':
+        nof_tx = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      case 'r':
+        nof_rx = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      case 'd':
+        duration_ms = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      case 's':
+        srate = (uint32_t)strtof(argv[optind], NULL);
+        break;
+      default:
+        usage(argv[0]);
+        exit(-1);
+    }
+  }
+}
+
+// Expected correlation between two paths for the eNodeB transmitting, 36.101 Annex B.2.3
+static double expected_corr(srsran_channel_fading_corr_t corr, uint32_t p, uint32_t q)
+{
+  const double alpha[3] = {0.0, 0.3, 0.9};
+  const double beta[3]  = {0.0, 0.9, 0.9};
+
+  double   r     = 1.0;
+  uint32_t d_tx  = abs((int)(p / nof_rx) - (int)(q / nof_rx));
+  uint32_t d_rx  = abs((int)(p % nof_rx) - (int)(q % nof_rx));
+  double   e_tx  = (nof_tx > 1) ? (double)d_tx / (nof_tx - 1) : 0.0;
+  double   e_rx  = (nof_rx > 1) ? (double)d_rx / (nof_rx - 1) : 0.0;
+  if (d_tx) {
+    r *= pow(alpha[corr], e_tx * e_tx);
+  }
+  if (d_rx) {
+    r *= pow(beta[corr], e_rx * e_rx);
+  }
+  return r;
+}
+
+int main(int argc, char** argv)
+{
+  int                          ret         = SRSRAN_ERROR;
+  uint32_t                     sf_len      = 0;
+  srsran_channel_fading_corr_t corr        = srsran_channel_fading_corr_low;
+  srsran_channel_fading_mimo_t fading      = {};
+  srsran_channel_fading_mimo_t inplace     = {};
+  srsran_random_t              random      = NULL;
+  cf_t**                       input       = NULL;
+  cf_t**                       output      = NULL;
+  cf_t**                       buffer      = NULL;
+  cf_t**                       inplace_in  = NULL;
+  cf_t**                       inplace_out = NULL;
+  cf_t*                        cov         = NULL;
+  struct timeval               t[3]        = {};
+  uint64_t                     time_usec   = 0;
+
+  parse_args(argc, argv);
+  sf_len = srate / 1000;
+
+  if (srsran_channel_fading_corr_parse(corr_str, &corr) != SRSRAN_SUCCESS) {
+    fprintf(stderr, "Error: invalid correlation '%s'\n", corr_str);
+    goto clean_exit;
+  }
+
+  if (srsran_channel_fading_mimo_init(&fading, srate, model, corr, true, nof_links, nof_tx, nof_rx, 0x12345678) ||
+      srsran_channel_fading_mimo_init(&inplace, srate, model, corr, true, nof_links, nof_tx, nof_rx, 0x12345678)) {
+    fprintf(stderr, "Error: initialising fading channel. model=%s, srate=%d\n", model, srate);
+    goto clean_exit;
+  }
+
+  // Allocate buffers, the in-place channel processes buffers holding a copy of the input
+  uint32_t nof_ports = SRSRAN_MAX(nof_tx, nof_rx);
+  input              = calloc(nof_links * nof_tx, sizeof(cf_t*));
+  output             = calloc(nof_links * nof_rx, sizeof(cf_t*));
+  buffer             = calloc(nof_links * nof_ports, sizeof(cf_t*));
+  inplace_in         = calloc(nof_links * nof_tx, sizeof(cf_t*));
+  inplace_out        = calloc(nof_links * nof_rx, sizeof(cf_t*));
+  cov                = srsran_vec_cf_malloc(fading.nof_paths * fading.nof_paths);
+  if (!input || !output || !buffer || !inplace_in || !inplace_out || !cov) {
+    fprintf(stderr, "Error: allocating buffers\n");
+    goto clean_exit;
+  }
+  random = srsran_random_init(1234);
+  for (uint32_t i = 0; i < nof_links * nof_tx; i++) {
+    input[i] = srsran_vec_cf_malloc(sf_len);
+    if (!input[i]) {
+      goto clean_exit;
+    }
+    srsran_random_uniform_complex_dist_vector(random, input[i], sf_len, -1.0f, +1.0f);
+  }
+  for (uint32_t i = 0; i < nof_links * nof_rx; i++) {
+    output[i] = srsran_vec_cf_malloc(sf_len);
+    if (!output[i]) {
+      goto clean_exit;
+    }
+  }
+  for (uint32_t i = 0; i < nof_links * nof_ports; i++) {
+    buffer[i] = srsran_vec_cf_malloc(sf_len);
+    if (!buffer[i]) {
+      goto clean_exit;
+    }
+  }
+
+  // The in-place channel reads and writes the same buffers for each link
+  for (uint32_t l = 0; l < nof_links; l++) {
+    for (uint32_t tx = 0; tx < nof_tx; tx++) {
+      inplace_in[l * nof_tx + tx] = buffer[l * nof_ports + tx];
+    }
+    for (uint32_t rx = 0; rx < nof_rx; rx++) {
+      inplace_out[l * nof_rx + rx] = buffer[l * nof_ports + rx];
+    }
+  }
+  srsran_vec_cf_zero(cov, fading.nof_paths * fading.nof_paths);
+
+  printf("-- Starting MIMO fading channel. srate=%.2fMHz; model=%s; corr=%s; links=%d; %dx%d; duration=%dms\n",
+         (double)srate / 1e6,
+         model,
+         corr_str,
+         nof_links,
+         nof_tx,
+         nof_rx,
+         duration_ms);
+
+  for (uint32_t i = 0; i < duration_ms; i++) {
+    for (uint32_t l = 0; l < nof_links; l++) {
+      for (uint32_t tx = 0; tx < nof_tx; tx++) {
+        srsran_vec_cf_copy(buffer[l * nof_ports + tx], input[l * nof_tx + tx], sf_len);
+      }
+    }
+
+    gettimeofday(&t[1], NULL);
+    srsran_channel_fading_mimo_execute(&fading, input, output, sf_len);
+    gettimeofday(&t[2], NULL);
+    get_time_interval(t);
+    time_usec += (uint64_t)(t->tv_sec * 1e6 + t->tv_usec);
+
+    // Accumulate the covariance of the tap gains of all links and taps
+    for (uint32_t j = 0; j < fading.nof_processes; j += fading.nof_paths) {
+      for (uint32_t p = 0; p < fading.nof_paths; p++) {
+        for (uint32_t q = 0; q < fading.nof_paths; q++) {
+          cov[p * fading.nof_paths + q] += fading.gain[j + p] * conjf(fading.gain[j + q]);
+        }
+      }
+    }
+
+    // Processing in place must give the same result
+    srsran_channel_fading_mimo_execute(&inplace, inplace_in, inplace_out, sf_len);
+    for (uint32_t l = 0; l < nof_links; l++) {
+      for (uint32_t rx = 0; rx < nof_rx; rx++) {
+        if (memcmp(buffer[l * nof_ports + rx], output[l * nof_rx + rx], sizeof(cf_t) * sf_len) != 0) {
+          fprintf(stderr, "Error: in-place output mismatch in ms %d, link %d, rx %d\n", i, l, rx);
+          goto clean_exit;
+        }
+        for (uint32_t k = 0; k < sf_len; k++) {
+          if (!isfinite(crealf(output[l * nof_rx + rx][k])) || !isfinite(cimagf(output[l * nof_rx + rx][k]))) {
+            fprintf(stderr, "Error: invalid output sample in ms %d, link %d, rx %d\n", i, l, rx);
+            goto clean_exit;
+          }
+        }
+      }
+    }
+  }
+
+  // Measured correlation coefficients must match the spatial correlation matrix
+  double max_err = 0.0;
+  for (uint32_t p = 0; p < fading.nof_paths; p++) {
+    for (uint32_t q = 0; q < fading.nof_paths; q++) {
+      double r = crealf(cov[p * fading.nof_paths + q]) /
+                 sqrt(crealf(cov[p * fading.nof_paths + p]) * crealf(cov[q * fading.nof_paths + q]));
+      max_err = SRSRAN_MAX(max_err, fabs(r - expected_corr(corr, p, q)));
+    }
+  }
+
+  double realtime_ratio = (double)duration_ms * 1000.0 / (double)time_usec;
+  printf("Execution time: %ld us; %.2f links/core in real time; max corr error: %.3f\n",
+         time_usec,
+         nof_links * realtime_ratio,
+         max_err);
+
+  // Every link and tap is an independent realisation, allow three times the standard deviation of the estimate
+  if (max_err > 3.0 / sqrt(nof_links * fading.nof_taps)) {
+    fprintf(stderr, "Error: measured correlation does not match 36.101 Annex B.2.3\n");
+    goto clean_exit;
+  }
+
+  ret = SRSRAN_SUCCESS;
+
+clean_exit:
+  srsran_channel_fading_mimo_free(&fading);
+  srsran_channel_fading_mimo_free(&inplace);
+  srsran_random_free(random);
+  if (input) {
+    for (uint32_t i = 0; i < nof_links * nof_tx; i++) {
+      free(input[i]);
+    }
+    free(input);
+  }
+  if (output) {
+    for (uint32_t i = 0; i < nof_links * nof_rx; i++) {
+      free(output[i]);
+    }
+    free(output);
+  }
+  if (buffer) {
+    for (uint32_t i = 0; i < nof_links * SRSRAN_MAX(nof_tx, nof_rx); i++) {
+      free(buffer[i]);
+    }
+    free(buffer);
+  }
+  if (inplace_in) {
+    free(inplace_in);
+  }
+  if (inplace_out) {
+    free(inplace_out);
+  }
+  if (cov) {
+    free(cov);
+  }
+
+  printf("Test %s\n", ret == SRSRAN_SUCCESS ? "Passed" : "Failed");
+  return ret;
+}
@@ -480,7 +480,7 @@ int srsran_group_hopping_f_gh(uint32_t f_gh[SRSRAN_NSLOTS_X_FRAME], uint32_t cel
   for (uint32_t ns = 0; ns < SRSRAN_NSLOTS_X_FRAME; ns++) {
     f_gh[ns] = 0;
     for (int i = 0; i < 8; i++) {
-      f_gh[ns] += (((uint32_t)seq.c[8 * ns + i]) << i);
+      f_gh[ns] += (((uint32_t)srsran_sequence_get_bit(&seq, 8 * ns + i)) << i);
     }
   }
 
@@ -20,7 +20,6 @@
  */
 
 #include "srsran/phy/common/sequence.h"
-#include "srsran/phy/utils/bit.h"
 #include "srsran/phy/utils/debug.h"
 #include "srsran/phy/utils/vector.h"
 
@@ -180,40 +179,6 @@ static uint32_t sequence_get_x2_init(uint32_t seed)
   return x2;
 }
 
-static void sequence_gen_LTE_pr(uint8_t* pr, uint32_t len, uint32_t seed)
-{
-  int      n  = 0;
-  uint32_t x1 = sequence_x1_init;           // X1 initial state is fix
-  uint32_t x2 = sequence_get_x2_init(seed); // loads x2 initial state
-
-  // Parallel stage
-  if (len >= SEQUENCE_PAR_BITS) {
-    for (; n < len - (SEQUENCE_PAR_BITS - 1); n += SEQUENCE_PAR_BITS) {
-      // XOR x1 and x2
-      uint32_t c = (uint32_t)(x1 ^ x2);
-
-      // Save state
-      for (uint32_t i = 0; i < SEQUENCE_PAR_BITS; i++) {
-        pr[n + i] = (uint8_t)((c >> i) & 1U);
-      }
-
-      // Parallel step
-      x1 = sequence_gen_LTE_pr_memless_step_par_x1(x1);
-      x2 = sequence_gen_LTE_pr_memless_step_par_x2(x2);
-    }
-  }
-
-  // Single step
-  for (; n < len; n++) {
-    // Save current state
-    pr[n] = (uint8_t)((x1 ^ x2) & 1U);
-
-    // Single step
-    x1 = sequence_gen_LTE_pr_memless_step_x1(x1);
-    x2 = sequence_gen_LTE_pr_memless_step_x2(x2);
-  }
-}
-
 void srsran_sequence_state_init(srsran_sequence_state_t* s, uint32_t seed)
 {
   s->x1 = sequence_x1_init;
@@ -299,74 +264,13 @@ int srsran_sequence_set_LTE_pr(srsran_sequence_t* q, uint32_t len, uint32_t seed
     return SRSRAN_ERROR;
   }
 
-  sequence_gen_LTE_pr(q->c, len, seed);
+  // Packed generation XORs in place, start from all zeros
+  srsran_vec_u8_zero(q->c_bytes, (len + 7) / 8);
+  srsran_sequence_apply_packed(q->c_bytes, q->c_bytes, len, seed);
 
   return SRSRAN_SUCCESS;
 }
 
-static inline void
-sequence_generate_signed(const uint8_t* c_unpacked, int8_t* c_char, int16_t* c_short, float* c_float, uint32_t len)
-{
-  int i = 0;
-
-#ifdef LV_HAVE_SSE
-  __m128i* sse_c       = (__m128i*)c_unpacked;
-  __m128i* sse_c_char  = (__m128i*)c_char;
-  __m128i* sse_c_short = (__m128i*)c_short;
-  float*   sse_c_float = c_float;
-
-  if (len >= 16) {
-    for (; i < len - 15; i += 16) {
-      // Get bit mask
-      __m128i m8 = _mm_cmpgt_epi8(_mm_load_si128(sse_c), _mm_set1_epi8(0));
-      sse_c++;
-
-      // Generate blend masks
-      __m128i m16_1 = _mm_unpacklo_epi8(m8, m8);
-      __m128i m16_2 = _mm_unpackhi_epi8(m8, m8);
-      __m128  m32_1 = (__m128)_mm_unpacklo_epi8(m16_1, m16_1);
-      __m128  m32_2 = (__m128)_mm_unpackhi_epi8(m16_1, m16_1);
-      __m128  m32_3 = (__m128)_mm_unpacklo_epi8(m16_2, m16_2);
-      __m128  m32_4 = (__m128)_mm_unpackhi_epi8(m16_2, m16_2);
-
-      // Generate int8 values
-      const __m128i bp = _mm_set1_epi8(+1);
-      const __m128i bn = _mm_set1_epi8(-1);
-      _mm_storeu_si128(sse_c_char, _mm_blendv_epi8(bp, bn, m8));
-      sse_c_char++;
-
-      // Generate int16 values
-      const __m128i sp = _mm_set1_epi16(+1);
-      const __m128i sn = _mm_set1_epi16(-1);
-      _mm_store_si128(sse_c_short++, _mm_blendv_epi8(sp, sn, m16_1));
-      _mm_store_si128(sse_c_short++, _mm_blendv_epi8(sp, sn, m16_2));
-
-      // Generate float values
-      const __m128 fp = _mm_set1_ps(+1);
-      const __m128 fn = _mm_set1_ps(-1);
-      _mm_store_ps(sse_c_float, _mm_blendv_ps(fp, fn, (__m128)m32_1));
-      sse_c_float += 4;
-      _mm_store_ps(sse_c_float, _mm_blendv_ps(fp, fn, (__m128)m32_2));
-      sse_c_float += 4;
-      _mm_store_ps(sse_c_float, _mm_blendv_ps(fp, fn, (__m128)m32_3));
-      sse_c_float += 4;
-      _mm_store_ps(sse_c_float, _mm_blendv_ps(fp, fn, (__m128)m32_4));
-      sse_c_float += 4;
-    }
-  }
-#endif /* LV_HAVE_SSE */
-
-  for (; i < len; i++) {
-    // Load signed
-    int8_t tt = (int8_t)(c_unpacked[i] ? -1 : +1);
-
-    // TYpecast conversion for each type
-    c_char[i]  = tt;
-    c_short[i] = (int16_t)tt;
-    c_float[i] = (float)tt;
-  }
-}
-
 int srsran_sequence_LTE_pr(srsran_sequence_t* q, uint32_t len, uint32_t seed)
 {
   if (srsran_sequence_init(q, len)) {
@@ -375,43 +279,20 @@ int srsran_sequence_LTE_pr(srsran_sequence_t* q, uint32_t len, uint32_t seed)
   q->cur_len = len;
 
   // Generate sequence
-  srsran_sequence_set_LTE_pr(q, len, seed);
-
-  // Pack PR sequence
-  srsran_bit_pack_vector(q->c, q->c_bytes, len);
-
-  // Generate signed type values
-  sequence_generate_signed(q->c, q->c_char, q->c_short, q->c_float, len);
-
-  return SRSRAN_SUCCESS;
+  return srsran_sequence_set_LTE_pr(q, len, seed);
 }
 
 int srsran_sequence_init(srsran_sequence_t* q, uint32_t len)
 {
-  if (q->c && len > q->max_len) {
+  if (q->c_bytes && len > q->max_len) {
     srsran_sequence_free(q);
   }
-  if (!q->c) {
-    q->c = srsran_vec_u8_malloc(len);
-    if (!q->c) {
-      return SRSRAN_ERROR;
-    }
+  if (!q->c_bytes) {
+    // The extra bytes let the scrambling kernels load 64 bits at any bit offset
     q->c_bytes = srsran_vec_u8_malloc(len / 8 + 8);
     if (!q->c_bytes) {
       return SRSRAN_ERROR;
     }
-    q->c_float = srsran_vec_f_malloc(len);
-    if (!q->c_float) {
-      return SRSRAN_ERROR;
-    }
-    q->c_short = srsran_vec_i16_malloc(len);
-    if (!q->c_short) {
-      return SRSRAN_ERROR;
-    }
-    q->c_char = srsran_vec_i8_malloc(len);
-    if (!q->c_char) {
-      return SRSRAN_ERROR;
-    }
     q->max_len = len;
   }
   return SRSRAN_SUCCESS;
@@ -419,21 +300,9 @@ int srsran_sequence_init(srsran_sequence_t* q, uint32_t len)
 
 void srsran_sequence_free(srsran_sequence_t* q)
 {
-  if (q->c) {
-    free(q->c);
-  }
   if (q->c_bytes) {
     free(q->c_bytes);
   }
-  if (q->c_float) {
-    free(q->c_float);
-  }
-  if (q->c_short) {
-    free(q->c_short);
-  }
-  if (q->c_char) {
-    free(q->c_char);
-  }
   bzero(q, sizeof(srsran_sequence_t));
 }
 
@@ -747,7 +616,8 @@ void srsran_sequence_apply_packed(const uint8_t* in, uint8_t* out, uint32_t leng
     out[i] = in[i] ^ reverse_lut[buffer & ((1U << rem8) - 1U) & 255U];
   }
 #else  // SEQUENCE_PAR_BITS % 8 == 0
-  while (i < (length / 8 - (SEQUENCE_PAR_BITS - 1) / 8)) {
+  // Whole words only, written so that lengths below two words do not wrap the bound
+  while (i + (SEQUENCE_PAR_BITS - 1) / 8 < length / 8) {
     uint32_t c = (uint32_t)(x1 ^ x2);
 
     for (uint32_t j = 0; j < SEQUENCE_PAR_BITS / 8; j++) {
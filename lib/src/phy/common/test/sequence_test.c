@@ -36,6 +36,9 @@ static int8_t  c_char[Nc + MAX_SEQ_LEN + 31];
 static uint8_t c_packed_gold[MAX_SEQ_LEN / 8];
 static uint8_t c_packed[MAX_SEQ_LEN / 8];
 static uint8_t c_unpacked[MAX_SEQ_LEN];
+static float   seq_float[MAX_SEQ_LEN];
+static int16_t seq_short[MAX_SEQ_LEN];
+static int8_t  seq_char[MAX_SEQ_LEN];
 
 static float   ones_float[Nc + MAX_SEQ_LEN + 31];
 static int16_t ones_short[Nc + MAX_SEQ_LEN + 31];
@@ -85,56 +88,46 @@ static int test_sequence(srsran_sequence_t* sequence, uint32_t seed, uint32_t le
 
   srsran_bit_pack_vector(c, c_packed_gold, length);
 
-  if (memcmp(c, sequence->c, length) != 0) {
-    ERROR("Unmatched c");
-    ret = SRSRAN_ERROR;
-  }
-
-  // Check Float sequence
-  if (memcmp(c_float, sequence->c_float, length * sizeof(float)) != 0) {
-    ERROR("Unmatched c_float");
-    ret = SRSRAN_ERROR;
+  for (uint32_t n = 0; n < length; n++) {
+    if (srsran_sequence_get_bit(sequence, n) != c[n]) {
+      ERROR("Unmatched c");
+      ret = SRSRAN_ERROR;
+      break;
+    }
   }
 
   // Test in-place Float XOR
   gettimeofday(&t[1], NULL);
   for (uint32_t r = 0; r < repetitions; r++) {
-    srsran_sequence_apply_f(ones_float, sequence->c_float, length, seed);
+    srsran_sequence_apply_f(ones_float, seq_float, length, seed);
   }
   gettimeofday(&t[2], NULL);
   get_time_interval(t);
   interval_xor_float_us = t->tv_sec * 1000000UL + t->tv_usec;
 
-  // Check Short Sequence
-  if (memcmp(c_short, sequence->c_short, length * sizeof(int16_t)) != 0) {
-    ERROR("Unmatched XOR c_short");
+  if (memcmp(c_float, seq_float, length * sizeof(float)) != 0) {
+    ERROR("Unmatched XOR c_float");
     ret = SRSRAN_ERROR;
   }
 
   // Test in-place Short XOR
   gettimeofday(&t[1], NULL);
   for (uint32_t r = 0; r < repetitions; r++) {
-    srsran_sequence_apply_s(ones_short, sequence->c_short, length, seed);
+    srsran_sequence_apply_s(ones_short, seq_short, length, seed);
   }
   gettimeofday(&t[2], NULL);
   get_time_interval(t);
   interval_xor_short_us = t->tv_sec * 1000000UL + t->tv_usec;
 
-  if (memcmp(c_short, sequence->c_short, length * sizeof(int16_t)) != 0) {
+  if (memcmp(c_short, seq_short, length * sizeof(int16_t)) != 0) {
     ERROR("Unmatched XOR c_short");
     ret = SRSRAN_ERROR;
   }
 
-  // Check Char Sequence
-  if (memcmp(c_char, sequence->c_char, length * sizeof(int8_t)) != 0) {
-    ERROR("Unmatched c_char");
-    ret = SRSRAN_ERROR;
-  }
-
   // Test in-place Char XOR
   gettimeofday(&t[1], NULL);
   for (uint32_t r = 0; r < repetitions; r++) {
-    srsran_sequence_apply_c(ones_char, sequence->c_char, length, seed);
+    srsran_sequence_apply_c(ones_char, seq_char, length, seed);
   }
   gettimeofday(&t[2], NULL);
   get_time_interval(t);
@@ -158,7 +151,7 @@ static int test_sequence(srsran_sequence_t* sequence, uint32_t seed, uint32_t le
   get_time_interval(t);
   interval_xor_packed_us = t->tv_sec * 1000000UL + t->tv_usec;
 
-  if (memcmp(c_char, sequence->c_char, length * sizeof(int8_t)) != 0) {
+  if (memcmp(c_char, seq_char, length * sizeof(int8_t)) != 0) {
     ERROR("Unmatched XOR c_char");
     ret = SRSRAN_ERROR;
   }
@@ -189,7 +182,7 @@ static int test_sequence(srsran_sequence_t* sequence, uint32_t seed, uint32_t le
          (double)(length * repetitions) / (double)interval_xor_packed_us,
          ret == SRSRAN_SUCCESS ? 'y' : 'n');
 
-  return SRSRAN_SUCCESS;
+  return ret;
 }
 
 int main(int argc, char** argv)
@@ -229,13 +222,22 @@ int main(int argc, char** argv)
          "XOR Pack",
          "Passed");
 
-  for (uint32_t length = min_length; length <= max_length; length = (length * 5) / 4) {
-    test_sequence(&sequence, (uint32_t)srsran_random_uniform_int_dist(random_gen, 1, INT32_MAX), length, repetitions);
+  int ret = SRSRAN_SUCCESS;
+
+  // Sequences shorter than the parallel generator word, such as PHICH
+  for (uint32_t length = 1; length < min_length && ret == SRSRAN_SUCCESS; length++) {
+    uint32_t seed = (uint32_t)srsran_random_uniform_int_dist(random_gen, 1, INT32_MAX);
+    ret           = test_sequence(&sequence, seed, length, repetitions);
+  }
+
+  for (uint32_t length = min_length; length <= max_length && ret == SRSRAN_SUCCESS; length = (length * 5) / 4) {
+    uint32_t seed = (uint32_t)srsran_random_uniform_int_dist(random_gen, 1, INT32_MAX);
+    ret           = test_sequence(&sequence, seed, length, repetitions);
   }
 
   // Free sequence object
   srsran_sequence_free(&sequence);
   srsran_random_free(random_gen);
 
-  return SRSRAN_SUCCESS;
+  return ret;
 }
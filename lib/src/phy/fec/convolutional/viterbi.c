@@ -29,6 +29,7 @@
 #include "parity.h"
 #include "srsran/phy/fec/convolutional/viterbi.h"
 #include "srsran/phy/utils/debug.h"
+#include "srsran/phy/utils/simd_isa.h"
 #include "srsran/phy/utils/vector.h"
 #include "viterbi37.h"
 
@@ -493,14 +494,15 @@ int srsran_viterbi_init(srsran_viterbi_t*     q,
 #ifdef LV_HAVE_SSE
 
 #ifdef LV_HAVE_AVX2
+      if (srsran_simd_isa_available(SRSRAN_SIMD_ISA_AVX2)) {
 #ifdef VITERBI_16
-      return init37_avx2_16bit(q, poly, max_frame_length, tail_bitting);
+        return init37_avx2_16bit(q, poly, max_frame_length, tail_bitting);
 #else
-      return init37_avx2(q, poly, max_frame_length, tail_bitting);
+        return init37_avx2(q, poly, max_frame_length, tail_bitting);
 #endif
-#else
-      return init37_sse(q, poly, max_frame_length, tail_bitting);
+      }
 #endif
+      return init37_sse(q, poly, max_frame_length, tail_bitting);
 #else
 #ifdef HAVE_NEON
       return init37_neon(q, poly, max_frame_length, tail_bitting);
@@ -532,6 +534,10 @@ int srsran_viterbi_init_avx2(srsran_viterbi_t*     q,
                              uint32_t              max_frame_length,
                              bool                  tail_bitting)
 {
+  if (!srsran_simd_isa_available(SRSRAN_SIMD_ISA_AVX2)) {
+    ERROR("Viterbi AVX2 decoder is not supported by this CPU");
+    return -1;
+  }
   return init37_avx2(q, poly, max_frame_length, tail_bitting);
 }
 #endif
@@ -565,12 +571,13 @@ int srsran_viterbi_decode_f(srsran_viterbi_t* q, float* symbols, uint8_t* data,
       }
     }
 #ifdef VITERBI_16
-    srsran_vec_quant_fus(symbols, q->symbols_us, q->gain_quant / max, 32767.5, 65535, len);
-    return srsran_viterbi_decode_us(q, q->symbols_us, data, frame_length);
-#else
+    if (q->decode_s) {
+      srsran_vec_quant_fus(symbols, q->symbols_us, q->gain_quant / max, 32767.5, 65535, len);
+      return srsran_viterbi_decode_us(q, q->symbols_us, data, frame_length);
+    }
+#endif
     srsran_vec_quant_fuc(symbols, q->symbols_uc, q->gain_quant / max, 127.5, 255, len);
     return srsran_viterbi_decode_uc(q, q->symbols_uc, data, frame_length);
-#endif
   } else {
     return q->decode_f(q, symbols, data, frame_length);
   }
@@ -597,12 +604,13 @@ int srsran_viterbi_decode_s(srsran_viterbi_t* q, int16_t* symbols, uint8_t* data
     }
   }
 #ifdef VITERBI_16
-  srsran_vec_quant_sus(symbols, q->symbols_us, 1, (float)INT16_MAX, UINT16_MAX, len);
-  return srsran_viterbi_decode_us(q, q->symbols_us, data, frame_length);
-#else
+  if (q->decode_s) {
+    srsran_vec_quant_sus(symbols, q->symbols_us, 1, (float)INT16_MAX, UINT16_MAX, len);
+    return srsran_viterbi_decode_us(q, q->symbols_us, data, frame_length);
+  }
+#endif
   srsran_vec_quant_suc(symbols, q->symbols_uc, (float)q->gain_quant / max, 127, 255, len);
   return srsran_viterbi_decode_uc(q, q->symbols_uc, data, frame_length);
-#endif
 }
 
 int srsran_viterbi_decode_us(srsran_viterbi_t* q, uint16_t* symbols, uint8_t* data, uint32_t frame_length)
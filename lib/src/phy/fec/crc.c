@@ -19,14 +19,24 @@
  *
  */
 
+#include <string.h>
+
 #include "srsran/phy/fec/crc.h"
 #include "srsran/phy/utils/bit.h"
 #include "srsran/phy/utils/debug.h"
+#include "srsran/phy/utils/vector.h"
 
 #ifdef LV_HAVE_SSE
 #include <immintrin.h>
 #endif // LV_HAVE_SSE
 
+// Inputs of at least this number of bytes are folded with carry-less multiplications before the table reduction
+#define CRC_CLMUL_MIN_BYTES 64
+
+// Bit-unpacked inputs are packed in chunks of this number of bytes, shorter inputs are packed byte by byte
+#define CRC_PACK_CHUNK_BYTES 512
+#define CRC_PACK_MIN_BYTES 16
+
 static void gen_crc_table(srsran_crc_t* h)
 {
   uint32_t pad        = (h->order < 8) ? (8 - h->order) : 0;
@@ -47,17 +57,144 @@ static void gen_crc_table(srsran_crc_t* h)
   }
 }
 
-uint64_t reversecrcbit(uint32_t crc, int nbits, srsran_crc_t* h)
+// CRC polynomial without its highest term, left-aligned to 32 bits
+static inline uint32_t crc_poly32(const srsran_crc_t* h)
 {
-  uint64_t m, rmask = 0x1;
+  return (uint32_t)((uint64_t)h->polynom << (32U - h->order));
+}
+
+static void gen_crc_table8(srsran_crc_t* h)
+{
+  uint32_t poly = crc_poly32(h);
+
+  for (uint32_t i = 0; i < 256; i++) {
+    uint32_t crc = i << 24U;
+    for (uint32_t j = 0; j < 8; j++) {
+      crc = (crc & 0x80000000U) ? (crc << 1U) ^ poly : (crc << 1U);
+    }
+    h->table8[0][i] = crc;
+  }
 
-  for (m = 0; m < nbits; m++) {
-    if ((rmask & crc) == 0x01)
-      crc = (crc ^ h->polynom) >> 1;
-    else
-      crc = crc >> 1;
+  for (uint32_t k = 1; k < 8; k++) {
+    for (uint32_t i = 0; i < 256; i++) {
+      uint32_t crc    = h->table8[k - 1][i];
+      h->table8[k][i] = (crc << 8U) ^ h->table8[0][crc >> 24U];
+    }
   }
-  return (crc & h->crcmask);
+}
+
+// Computes x^k mod P(x) * x^(32-order) for the folding constants
+static uint64_t crc_xpow_mod(const srsran_crc_t* h, uint32_t k)
+{
+  uint32_t poly = crc_poly32(h);
+  uint64_t r    = 1;
+  for (uint32_t i = 0; i < k; i++) {
+    r <<= 1U;
+    if (r & 0x100000000UL) {
+      r = (r & 0xffffffffUL) ^ poly;
+    }
+  }
+  return r;
+}
+
+static inline uint32_t crc_load_be32(const uint8_t* data)
+{
+  uint32_t word;
+  memcpy(&word, data, sizeof(uint32_t));
+  return __builtin_bswap32(word);
+}
+
+// Slicing-by-8: the CRC register advances 8 bytes per iteration
+static uint32_t crc_bytes_table(const srsran_crc_t* h, uint32_t crc, const uint8_t* data, uint32_t nof_bytes)
+{
+  const uint32_t(*t)[256] = h->table8;
+
+  for (; nof_bytes >= 8; nof_bytes -= 8, data += 8) {
+    uint32_t a = crc ^ crc_load_be32(data);
+    uint32_t b = crc_load_be32(data + 4);
+    crc        = t[7][a >> 24U] ^ t[6][(a >> 16U) & 0xffU] ^ t[5][(a >> 8U) & 0xffU] ^ t[4][a & 0xffU] ^
+          t[3][b >> 24U] ^ t[2][(b >> 16U) & 0xffU] ^ t[1][(b >> 8U) & 0xffU] ^ t[0][b & 0xffU];
+  }
+
+  for (; nof_bytes > 0; nof_bytes--, data++) {
+    crc = (crc << 8U) ^ t[0][(crc >> 24U) ^ *data];
+  }
+
+  return crc;
+}
+
+#ifdef LV_HAVE_PCLMUL
+// Multiplies the two halves of x by x^(k+64) and x^k, both reduced in k, and adds them
+static inline __m128i crc_fold_clmul(__m128i x, __m128i k)
+{
+  return _mm_xor_si128(_mm_clmulepi64_si128(x, k, 0x11), _mm_clmulepi64_si128(x, k, 0x00));
+}
+
+// Folds 128-bit blocks into a 128-bit remainder congruent to the input, which the tables reduce to the CRC
+static uint32_t crc_bytes_clmul(const srsran_crc_t* h, uint32_t crc, const uint8_t* data, uint32_t nof_bytes)
+{
+  // The first bit of the input is the highest order coefficient
+  const __m128i bswap = _mm_setr_epi8(15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0);
+  const __m128i k128  = _mm_set_epi64x((long long)h->fold[1], (long long)h->fold[0]);
+  const __m128i k512  = _mm_set_epi64x((long long)h->fold[3], (long long)h->fold[2]);
+
+  __m128i x0 = _mm_shuffle_epi8(_mm_loadu_si128((__m128i*)data), bswap);
+  x0         = _mm_xor_si128(x0, _mm_set_epi32((int)crc, 0, 0, 0));
+  data += 16;
+  nof_bytes -= 16;
+
+  // Four independent remainders hide the multiplication latency
+  if (nof_bytes >= 48) {
+    __m128i x1 = _mm_shuffle_epi8(_mm_loadu_si128((__m128i*)(data + 0)), bswap);
+    __m128i x2 = _mm_shuffle_epi8(_mm_loadu_si128((__m128i*)(data + 16)), bswap);
+    __m128i x3 = _mm_shuffle_epi8(_mm_loadu_si128((__m128i*)(data + 32)), bswap);
+    data += 48;
+    nof_bytes -= 48;
+
+    for (; nof_bytes >= 64; nof_bytes -= 64, data += 64) {
+      x0 = _mm_xor_si128(crc_fold_clmul(x0, k512), _mm_shuffle_epi8(_mm_loadu_si128((__m128i*)(data + 0)), bswap));
+      x1 = _mm_xor_si128(crc_fold_clmul(x1, k512), _mm_shuffle_epi8(_mm_loadu_si128((__m128i*)(data + 16)), bswap));
+      x2 = _mm_xor_si128(crc_fold_clmul(x2, k512), _mm_shuffle_epi8(_mm_loadu_si128((__m128i*)(data + 32)), bswap));
+      x3 = _mm_xor_si128(crc_fold_clmul(x3, k512), _mm_shuffle_epi8(_mm_loadu_si128((__m128i*)(data + 48)), bswap));
+    }
+
+    x0 = _mm_xor_si128(crc_fold_clmul(x0, k128), x1);
+    x0 = _mm_xor_si128(crc_fold_clmul(x0, k128), x2);
+    x0 = _mm_xor_si128(crc_fold_clmul(x0, k128), x3);
+  }
+
+  for (; nof_bytes >= 16; nof_bytes -= 16, data += 16) {
+    x0 = _mm_xor_si128(crc_fold_clmul(x0, k128), _mm_shuffle_epi8(_mm_loadu_si128((__m128i*)data), bswap));
+  }
+
+  uint8_t remainder[16];
+  _mm_storeu_si128((__m128i*)remainder, _mm_shuffle_epi8(x0, bswap));
+  crc = crc_bytes_table(h, 0, remainder, 16);
+
+  return crc_bytes_table(h, crc, data, nof_bytes);
+}
+#endif // LV_HAVE_PCLMUL
+
+static inline uint8_t crc_pack_byte(uint8_t* bits)
+{
+#ifdef LV_HAVE_SSE
+  __m128i mask = _mm_cmpgt_epi8(_mm_loadl_epi64((__m128i*)bits), _mm_setzero_si128());
+  mask         = _mm_shuffle_epi8(mask, _mm_setr_epi8(7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8));
+  return (uint8_t)_mm_movemask_epi8(mask);
+#else  /* LV_HAVE_SSE */
+  return (uint8_t)(srsran_bit_pack(&bits, 8) & 0xFF);
+#endif /* LV_HAVE_SSE */
+}
+
+// Advances the left-aligned CRC register over whole bytes
+static uint32_t crc_bytes(const srsran_crc_t* h, uint32_t crc, const uint8_t* data, uint32_t nof_bytes)
+{
+#ifdef LV_HAVE_PCLMUL
+  if (nof_bytes >= CRC_CLMUL_MIN_BYTES) {
+    return crc_bytes_clmul(h, crc, data, nof_bytes);
+  }
+#endif // LV_HAVE_PCLMUL
+  return crc_bytes_table(h, crc, data, nof_bytes);
 }
 
 int srsran_crc_set_init(srsran_crc_t* crc_par, uint64_t crc_init_value)
@@ -86,59 +223,46 @@ int srsran_crc_init(srsran_crc_t* h, uint32_t crc_poly, int crc_order)
     return -1;
   }
 
-  // generate lookup table
+  // generate lookup tables and folding constants
   gen_crc_table(h);
+  gen_crc_table8(h);
+  h->fold[0] = crc_xpow_mod(h, 128);
+  h->fold[1] = crc_xpow_mod(h, 128 + 64);
+  h->fold[2] = crc_xpow_mod(h, 512);
+  h->fold[3] = crc_xpow_mod(h, 512 + 64);
 
   return 0;
 }
 
 uint32_t srsran_crc_checksum(srsran_crc_t* h, uint8_t* data, int len)
 {
-  int      i, k, len8, res8, a = 0;
-  uint32_t crc = 0;
-  uint8_t* pter;
-
-  srsran_crc_set_init(h, 0);
-
-  // Pack bits into bytes
-  len8 = (len >> 3);
-  res8 = (len - (len8 << 3));
-  if (res8 > 0) {
-    a = 1;
-  }
-
-  // Calculate CRC
-  for (i = 0; i < len8 + a; i++) {
-    pter = (uint8_t*)(data + 8 * i);
-    uint8_t byte;
-    if (i == len8) {
-      byte = 0x00;
-      for (k = 0; k < res8; k++) {
-        byte |= ((uint8_t) * (pter + k)) << (7 - k);
-      }
-    } else {
-#ifdef LV_HAVE_SSE
-      // Get 8 Bit
-      __m64 mask = _mm_cmpgt_pi8(*((__m64*)pter), _mm_set1_pi8(0));
+  uint8_t  packed[CRC_PACK_CHUNK_BYTES];
+  uint32_t crc  = 0;
+  uint32_t poly = crc_poly32(h);
 
-      // Reverse
-      mask = _mm_shuffle_pi8(mask, _mm_set_pi8(0, 1, 2, 3, 4, 5, 6, 7));
-
-      // Get mask and write
-      byte = (uint8_t)_mm_movemask_pi8(mask);
-#else  /* LV_HAVE_SSE */
-      byte = (uint8_t)(srsran_bit_pack(&pter, 8) & 0xFF);
-#endif /* LV_HAVE_SSE */
+  // Pack whole bytes in chunks
+  uint32_t nof_bytes = (uint32_t)len / 8;
+  if (nof_bytes < CRC_PACK_MIN_BYTES) {
+    for (uint32_t i = 0; i < nof_bytes; i++) {
+      crc = (crc << 8U) ^ h->table8[0][(crc >> 24U) ^ crc_pack_byte(&data[8 * i])];
+    }
+  } else {
+    for (uint32_t i = 0; i < nof_bytes; i += CRC_PACK_CHUNK_BYTES) {
+      uint32_t n = SRSRAN_MIN(CRC_PACK_CHUNK_BYTES, nof_bytes - i);
+      srsran_bit_pack_vector(&data[8 * i], packed, (int)(8 * n));
+      crc = crc_bytes(h, crc, packed, n);
     }
-    srsran_crc_checksum_put_byte(h, byte);
   }
-  crc = (uint32_t)srsran_crc_checksum_get(h);
 
-  // Reverse CRC res8 positions
-  if (a == 1) {
-    crc = reversecrcbit(crc, 8 - res8, h);
+  // The remaining bits go one by one
+  for (uint32_t i = 8 * nof_bytes; i < (uint32_t)len; i++) {
+    uint32_t bit = (crc >> 31U) ^ (data[i] & 1U);
+    crc          = (crc << 1U) ^ (bit ? poly : 0);
   }
 
+  crc        = crc >> (32U - h->order);
+  h->crcinit = crc;
+
   // Return CRC value
   return crc;
 }
@@ -146,16 +270,8 @@ uint32_t srsran_crc_checksum(srsran_crc_t* h, uint8_t* data, int len)
 // len is multiple of 8
 uint32_t srsran_crc_checksum_byte(srsran_crc_t* h, const uint8_t* data, int len)
 {
-  int      i;
-  uint32_t crc = 0;
-
-  srsran_crc_set_init(h, 0);
-
-  // Calculate CRC
-  for (i = 0; i < len / 8; i++) {
-    srsran_crc_checksum_put_byte(h, data[i]);
-  }
-  crc = (uint32_t)srsran_crc_checksum_get(h);
+  uint32_t crc = crc_bytes(h, 0, data, (uint32_t)len / 8) >> (32U - h->order);
+  h->crcinit   = crc;
 
   return crc;
 }
@@ -37,10 +37,60 @@
 #include "srsran/phy/fec/ldpc/base_graph.h"
 #include "srsran/phy/fec/ldpc/ldpc_decoder.h"
 #include "srsran/phy/utils/debug.h"
+#include "srsran/phy/utils/simd_isa.h"
 #include "srsran/phy/utils/vector.h"
 
 #define LDPC_DECODER_DEFAULT_MAX_NOF_ITER 10 /*!< \brief Default maximum number of iterations of the BP algorithm. */
 
+/*!
+ * Checks the parity equations of the first \b n_layers layers on the hard decisions stored in \b q->hard_bits.
+ * \param[in] q        The LDPC decoder.
+ * \param[in] n_layers Number of layers (lifted check nodes) used by the current rate-matched codeword.
+ * \return True if all the parity checks are satisfied (zero syndrome), false otherwise.
+ */
+static bool check_syndrome(const srsran_ldpc_decoder_t* q, uint8_t n_layers)
+{
+  uint8_t* syndrome = q->hard_bits + q->liftN;
+
+  for (int i_layer = 0; i_layer < n_layers; i_layer++) {
+    const uint16_t* this_pcm          = q->pcm + i_layer * q->bgN;
+    const int8_t*   these_var_indices = q->var_indices[i_layer];
+
+    srsran_vec_u8_zero(syndrome, q->ls);
+
+    // The check node t of the layer is connected to the bit (t + shift) % ls of every variable node
+    for (int i = 0; (i < MAX_CNCT) && (these_var_indices[i] != -1); i++) {
+      const uint8_t* bits  = q->hard_bits + these_var_indices[i] * q->ls;
+      uint16_t       shift = this_pcm[these_var_indices[i]] % q->ls;
+
+      srsran_vec_xor_bbb(syndrome, bits + shift, syndrome, q->ls - shift);
+      srsran_vec_xor_bbb(syndrome + q->ls - shift, bits, syndrome + q->ls - shift, shift);
+    }
+
+    for (int t = 0; t < q->ls; t++) {
+      if (syndrome[t]) {
+        return false;
+      }
+    }
+  }
+
+  return true;
+}
+
+/*! Frees the parity check matrix of the decoder, unless it belongs to another decoder. */
+static void free_pcm(srsran_ldpc_decoder_t* q)
+{
+  if (q->pcm_is_shared) {
+    return;
+  }
+  if (q->var_indices) {
+    free(q->var_indices);
+  }
+  if (q->pcm) {
+    free(q->pcm);
+  }
+}
+
 #define LDPC_DECODER_TEMPLATE(LLR_TYPE, SUFFIX)                                                                        \
   static int decode_##SUFFIX(                                                                                          \
       void* o, const LLR_TYPE* llrs, uint8_t* message, uint32_t cdwd_rm_length, srsran_crc_t* crc)                     \
@@ -84,22 +134,26 @@
         update_ldpc_soft_bits_##SUFFIX(q->ptr, i_layer, these_var_indices);                                            \
       }                                                                                                                \
                                                                                                                        \
-      if (crc != NULL) {                                                                                               \
-        extract_ldpc_message_##SUFFIX(q->ptr, message, q->liftK);                                                      \
+      /* Stop as soon as the hard decisions form a valid codeword. With a CRC, it must also match, otherwise the */    \
+      /* decoder keeps iterating. */                                                                                   \
+      extract_ldpc_message_##SUFFIX(q->ptr, q->hard_bits, (q->bgK + n_layers) * q->ls);                                \
                                                                                                                        \
-        if (srsran_crc_match(crc, message, q->liftK - crc->order)) {                                                   \
+      if (check_syndrome(q, n_layers)) {                                                                               \
+        srsran_vec_u8_copy(message, q->hard_bits, q->liftK);                                                           \
+                                                                                                                       \
+        if (crc == NULL || srsran_crc_match(crc, message, q->liftK - crc->order)) {                                    \
           return i_iteration + 1;                                                                                      \
         }                                                                                                              \
       }                                                                                                                \
     }                                                                                                                  \
                                                                                                                        \
-    /* If reached here, and CRC is being checked, it has failed */                                                     \
+    /* Extract the last hard decisions. If reached here, and CRC is being checked, it has failed */                    \
+    extract_ldpc_message_##SUFFIX(q->ptr, message, q->liftK);                                                          \
     if (crc != NULL) {                                                                                                 \
       return 0;                                                                                                        \
     }                                                                                                                  \
                                                                                                                        \
-    /* Without CRC, extract message and return the maximum number of iterations */                                     \
-    extract_ldpc_message_##SUFFIX(q->ptr, message, q->liftK);                                                          \
+    /* Without CRC, return the maximum number of iterations */                                                         \
     return q->max_nof_iter;                                                                                            \
   }
 #define LDPC_DECODER_TEMPLATE_FLOOD(LLR_TYPE, SUFFIX)                                                                  \
@@ -147,22 +201,26 @@
                                                                                                                        \
       update_ldpc_soft_bits_##SUFFIX(q->ptr, q->var_indices);                                                          \
                                                                                                                        \
-      if (crc != NULL) {                                                                                               \
-        extract_ldpc_message_##SUFFIX(q->ptr, message, q->liftK);                                                      \
+      /* Stop as soon as the hard decisions form a valid codeword. With a CRC, it must also match, otherwise the */    \
+      /* decoder keeps iterating. */                                                                                   \
+      extract_ldpc_message_##SUFFIX(q->ptr, q->hard_bits, (q->bgK + n_layers) * q->ls);                                \
                                                                                                                        \
-        if (srsran_crc_match(crc, message, q->liftK - crc->order)) {                                                   \
+      if (check_syndrome(q, n_layers)) {                                                                               \
+        srsran_vec_u8_copy(message, q->hard_bits, q->liftK);                                                           \
+                                                                                                                       \
+        if (crc == NULL || srsran_crc_match(crc, message, q->liftK - crc->order)) {                                    \
           return i_iteration + 1;                                                                                      \
         }                                                                                                              \
       }                                                                                                                \
     }                                                                                                                  \
                                                                                                                        \
-    /* If reached here, and CRC is being checked, it has failed */                                                     \
+    /* Extract the last hard decisions. If reached here, and CRC is being checked, it has failed */                    \
+    extract_ldpc_message_##SUFFIX(q->ptr, message, q->liftK);                                                          \
     if (crc != NULL) {                                                                                                 \
       return 0;                                                                                                        \
     }                                                                                                                  \
                                                                                                                        \
-    /* Without CRC, extract message and return the maximum number of iterations */                                     \
-    extract_ldpc_message_##SUFFIX(q->ptr, message, q->liftK);                                                          \
+    /* Without CRC, return the maximum number of iterations */                                                         \
                                                                                                                        \
     return q->max_nof_iter;                                                                                            \
   }
@@ -171,12 +229,7 @@
 static void free_dec_f(void* o)
 {
   srsran_ldpc_decoder_t* q = o;
-  if (q->var_indices) {
-    free(q->var_indices);
-  }
-  if (q->pcm) {
-    free(q->pcm);
-  }
+  free_pcm(q);
   delete_ldpc_dec_f(q->ptr);
 }
 
@@ -203,12 +256,7 @@ static int init_f(srsran_ldpc_decoder_t* q)
 static void free_dec_s(void* o)
 {
   srsran_ldpc_decoder_t* q = o;
-  if (q->var_indices) {
-    free(q->var_indices);
-  }
-  if (q->pcm) {
-    free(q->pcm);
-  }
+  free_pcm(q);
   delete_ldpc_dec_s(q->ptr);
 }
 
@@ -235,12 +283,7 @@ static int init_s(srsran_ldpc_decoder_t* q)
 static void free_dec_c(void* o)
 {
   srsran_ldpc_decoder_t* q = o;
-  if (q->var_indices) {
-    free(q->var_indices);
-  }
-  if (q->pcm) {
-    free(q->pcm);
-  }
+  free_pcm(q);
   delete_ldpc_dec_c(q->ptr);
 }
 
@@ -267,12 +310,7 @@ static int init_c(srsran_ldpc_decoder_t* q)
 static void free_dec_c_flood(void* o)
 {
   srsran_ldpc_decoder_t* q = o;
-  if (q->var_indices) {
-    free(q->var_indices);
-  }
-  if (q->pcm) {
-    free(q->pcm);
-  }
+  free_pcm(q);
   delete_ldpc_dec_c_flood(q->ptr);
 }
 
@@ -300,12 +338,7 @@ static int init_c_flood(srsran_ldpc_decoder_t* q)
 static void free_dec_c_avx2(void* o)
 {
   srsran_ldpc_decoder_t* q = o;
-  if (q->var_indices) {
-    free(q->var_indices);
-  }
-  if (q->pcm) {
-    free(q->pcm);
-  }
+  free_pcm(q);
   delete_ldpc_dec_c_avx2(q->ptr);
 }
 
@@ -333,12 +366,7 @@ static int init_c_avx2(srsran_ldpc_decoder_t* q)
 static void free_dec_c_avx2long(void* o)
 {
   srsran_ldpc_decoder_t* q = o;
-  if (q->var_indices) {
-    free(q->var_indices);
-  }
-  if (q->pcm) {
-    free(q->pcm);
-  }
+  free_pcm(q);
   delete_ldpc_dec_c_avx2long(q->ptr);
 }
 
@@ -366,12 +394,7 @@ static int init_c_avx2long(srsran_ldpc_decoder_t* q)
 static void free_dec_c_avx2_flood(void* o)
 {
   srsran_ldpc_decoder_t* q = o;
-  if (q->var_indices) {
-    free(q->var_indices);
-  }
-  if (q->pcm) {
-    free(q->pcm);
-  }
+  free_pcm(q);
   delete_ldpc_dec_c_avx2_flood(q->ptr);
 }
 
@@ -399,12 +422,7 @@ static int init_c_avx2_flood(srsran_ldpc_decoder_t* q)
 static void free_dec_c_avx2long_flood(void* o)
 {
   srsran_ldpc_decoder_t* q = o;
-  if (q->var_indices) {
-    free(q->var_indices);
-  }
-  if (q->pcm) {
-    free(q->pcm);
-  }
+  free_pcm(q);
   delete_ldpc_dec_c_avx2long_flood(q->ptr);
 }
 
@@ -439,12 +457,7 @@ static int init_c_avx2long_flood(srsran_ldpc_decoder_t* q)
 static void free_dec_c_avx512(void* o)
 {
   srsran_ldpc_decoder_t* q = o;
-  if (q->var_indices) {
-    free(q->var_indices);
-  }
-  if (q->pcm) {
-    free(q->pcm);
-  }
+  free_pcm(q);
   delete_ldpc_dec_c_avx512(q->ptr);
 }
 
@@ -472,12 +485,7 @@ static int init_c_avx512(srsran_ldpc_decoder_t* q)
 static void free_dec_c_avx512long(void* o)
 {
   srsran_ldpc_decoder_t* q = o;
-  if (q->var_indices) {
-    free(q->var_indices);
-  }
-  if (q->pcm) {
-    free(q->pcm);
-  }
+  free_pcm(q);
   delete_ldpc_dec_c_avx512long(q->ptr);
 }
 
@@ -505,12 +513,7 @@ static int init_c_avx512long(srsran_ldpc_decoder_t* q)
 static void free_dec_c_avx512long_flood(void* o)
 {
   srsran_ldpc_decoder_t* q = o;
-  if (q->var_indices) {
-    free(q->var_indices);
-  }
-  if (q->pcm) {
-    free(q->pcm);
-  }
+  free_pcm(q);
   delete_ldpc_dec_c_avx512long_flood(q->ptr);
 }
 
@@ -537,6 +540,69 @@ static int init_c_avx512long_flood(srsran_ldpc_decoder_t* q)
 
 #endif // LV_HAVE_AVX512
 
+/*! Checks that the decoder kernel of the given type has been built and can run on this CPU. */
+static bool type_available(srsran_ldpc_decoder_type_t type)
+{
+  switch (type) {
+    case SRSRAN_LDPC_DECODER_C_AVX2:
+    case SRSRAN_LDPC_DECODER_C_AVX2_FLOOD:
+      return srsran_simd_isa_available(SRSRAN_SIMD_ISA_AVX2);
+    case SRSRAN_LDPC_DECODER_C_AVX512:
+    case SRSRAN_LDPC_DECODER_C_AVX512_FLOOD:
+      return srsran_simd_isa_available(SRSRAN_SIMD_ISA_AVX512);
+    default:
+      return true;
+  }
+}
+
+/*! Initializes the decoder kernel of the given type. */
+static int init_type(srsran_ldpc_decoder_t* q, srsran_ldpc_decoder_type_t type)
+{
+  if (!type_available(type)) {
+    ERROR("LDPC decoder type %d is not supported by this build or CPU", type);
+    return -1;
+  }
+
+  switch (type) {
+    case SRSRAN_LDPC_DECODER_F:
+      return init_f(q);
+    case SRSRAN_LDPC_DECODER_S:
+      return init_s(q);
+    case SRSRAN_LDPC_DECODER_C:
+      return init_c(q);
+    case SRSRAN_LDPC_DECODER_C_FLOOD:
+      return init_c_flood(q);
+#ifdef LV_HAVE_AVX2
+    case SRSRAN_LDPC_DECODER_C_AVX2:
+      if (q->ls <= SRSRAN_AVX2_B_SIZE) {
+        return init_c_avx2(q);
+      } else {
+        return init_c_avx2long(q);
+      }
+    case SRSRAN_LDPC_DECODER_C_AVX2_FLOOD:
+      if (q->ls <= SRSRAN_AVX2_B_SIZE) {
+        return init_c_avx2_flood(q);
+      } else {
+        return init_c_avx2long_flood(q);
+      }
+#endif // LV_HAVE_AVX2
+#ifdef LV_HAVE_AVX512
+    case SRSRAN_LDPC_DECODER_C_AVX512:
+      if (q->ls <= SRSRAN_AVX512_B_SIZE) {
+        return init_c_avx512(q);
+      } else {
+        return init_c_avx512long(q);
+      }
+    case SRSRAN_LDPC_DECODER_C_AVX512_FLOOD:
+      return init_c_avx512long_flood(q);
+#endif // LV_HAVE_AVX2
+
+    default:
+      ERROR("Unknown decoder.");
+      return -1;
+  }
+}
+
 int srsran_ldpc_decoder_init(srsran_ldpc_decoder_t* q, const srsran_ldpc_decoder_args_t* args)
 {
   if (q == NULL || args == NULL) {
@@ -578,72 +644,58 @@ int srsran_ldpc_decoder_init(srsran_ldpc_decoder_t* q, const srsran_ldpc_decoder
 
   q->max_nof_iter = (args->max_nof_iter == 0) ? LDPC_DECODER_DEFAULT_MAX_NOF_ITER : args->max_nof_iter;
 
-  q->pcm = srsran_vec_u16_malloc(q->bgM * q->bgN);
-  if (!q->pcm) {
-    perror("malloc");
-    return -1;
-  }
+  if (args->pcm_owner != NULL) {
+    if (args->pcm_owner->bg != bg || args->pcm_owner->ls != ls) {
+      ERROR("The shared parity check matrix is for BG%d and lifting size %d",
+            args->pcm_owner->bg + 1,
+            args->pcm_owner->ls);
+      return -1;
+    }
+    q->pcm           = args->pcm_owner->pcm;
+    q->var_indices   = args->pcm_owner->var_indices;
+    q->pcm_is_shared = true;
+  } else {
+    q->pcm = srsran_vec_u16_malloc(q->bgM * q->bgN);
+    if (!q->pcm) {
+      perror("malloc");
+      return -1;
+    }
 
-  q->var_indices = srsran_vec_malloc(q->bgM * sizeof(int8_t[MAX_CNCT]));
-  if (!q->var_indices) {
-    free(q->pcm);
-    perror("malloc");
-    return -1;
-  }
+    q->var_indices = srsran_vec_malloc(q->bgM * sizeof(int8_t[MAX_CNCT]));
+    if (!q->var_indices) {
+      free(q->pcm);
+      perror("malloc");
+      return -1;
+    }
+    q->pcm_is_shared = false;
 
-  if (create_compact_pcm(q->pcm, q->var_indices, q->bg, q->ls) != 0) {
-    perror("Create PCM");
-    free(q->var_indices);
-    free(q->pcm);
-    return -1;
+    if (create_compact_pcm(q->pcm, q->var_indices, q->bg, q->ls) != 0) {
+      perror("Create PCM");
+      free_pcm(q);
+      return -1;
+    }
   }
 
   if ((scaling_fctr <= 0) || (scaling_fctr > 1)) {
     perror("The scaling factor of the min-sum algorithm should be larger than 0 and not larger than 1.");
-    free(q->var_indices);
-    free(q->pcm);
+    free_pcm(q);
     return -1;
   }
   q->scaling_fctr = scaling_fctr;
 
-  switch (type) {
-    case SRSRAN_LDPC_DECODER_F:
-      return init_f(q);
-    case SRSRAN_LDPC_DECODER_S:
-      return init_s(q);
-    case SRSRAN_LDPC_DECODER_C:
-      return init_c(q);
-    case SRSRAN_LDPC_DECODER_C_FLOOD:
-      return init_c_flood(q);
-#ifdef LV_HAVE_AVX2
-    case SRSRAN_LDPC_DECODER_C_AVX2:
-      if (ls <= SRSRAN_AVX2_B_SIZE) {
-        return init_c_avx2(q);
-      } else {
-        return init_c_avx2long(q);
-      }
-    case SRSRAN_LDPC_DECODER_C_AVX2_FLOOD:
-      if (ls <= SRSRAN_AVX2_B_SIZE) {
-        return init_c_avx2_flood(q);
-      } else {
-        return init_c_avx2long_flood(q);
-      }
-#endif // LV_HAVE_AVX2
-#ifdef LV_HAVE_AVX512
-    case SRSRAN_LDPC_DECODER_C_AVX512:
-      if (ls <= SRSRAN_AVX512_B_SIZE) {
-        return init_c_avx512(q);
-      } else {
-        return init_c_avx512long(q);
-      }
-    case SRSRAN_LDPC_DECODER_C_AVX512_FLOOD:
-      return init_c_avx512long_flood(q);
-#endif // LV_HAVE_AVX2
+  if (init_type(q, type) != 0) {
+    return -1;
+  }
 
-    default:
-      ERROR("Unknown decoder.");
-      return -1;
+  // Hard decisions of the whole codeword followed by the syndrome of one layer
+  q->hard_bits = srsran_vec_u8_malloc(q->liftN + q->ls);
+  if (!q->hard_bits) {
+    perror("malloc");
+    srsran_ldpc_decoder_free(q);
+    return -1;
   }
+
+  return 0;
 }
 
 void srsran_ldpc_decoder_free(srsran_ldpc_decoder_t* q)
@@ -651,6 +703,9 @@ void srsran_ldpc_decoder_free(srsran_ldpc_decoder_t* q)
   if (q->free) {
     q->free(q);
   }
+  if (q->hard_bits) {
+    free(q->hard_bits);
+  }
   bzero(q, sizeof(srsran_ldpc_decoder_t));
 }
 
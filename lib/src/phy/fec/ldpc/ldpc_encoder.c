@@ -37,6 +37,7 @@
 #include "srsran/phy/fec/ldpc/base_graph.h"
 #include "srsran/phy/fec/ldpc/ldpc_encoder.h"
 #include "srsran/phy/utils/debug.h"
+#include "srsran/phy/utils/simd_isa.h"
 #include "srsran/phy/utils/vector.h"
 
 /*! Carries out the actual destruction of the memory allocated to the encoder. */
@@ -544,6 +545,12 @@ int srsran_ldpc_encoder_init(srsran_ldpc_encoder_t*     q,
     return -1;
   }
 
+  if ((type == SRSRAN_LDPC_ENCODER_AVX2 && !srsran_simd_isa_available(SRSRAN_SIMD_ISA_AVX2)) ||
+      (type == SRSRAN_LDPC_ENCODER_AVX512 && !srsran_simd_isa_available(SRSRAN_SIMD_ISA_AVX512))) {
+    ERROR("LDPC encoder type %d is not supported by this build or CPU", type);
+    return -1;
+  }
+
   switch (type) {
     case SRSRAN_LDPC_ENCODER_C:
       return init_c(q);
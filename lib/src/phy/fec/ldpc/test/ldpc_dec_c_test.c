@@ -26,6 +26,8 @@
  * It decodes a batch of example codewords and compares the resulting messages
  * with the expected ones. Reference messages and codewords are provided in
  * files **examplesBG1.dat** and **examplesBG2.dat**.
+ * Since the codewords are noiseless, it also checks that the decoder stops before
+ * reaching the maximum number of iterations.
  *
  * Synopsis: **ldpc_dec_c_test [options]**
  *
@@ -213,7 +215,11 @@ int main(int argc, char** argv)
   gettimeofday(&t[1], NULL);
   for (j = 0; j < NOF_MESSAGES; j++) {
     printf("  codeword %d\n", j);
-    srsran_ldpc_decoder_decode_c(&decoder, symbols + j * finalN, messages_sim + j * finalK, finalN);
+    int n_iter = srsran_ldpc_decoder_decode_c(&decoder, symbols + j * finalN, messages_sim + j * finalK, finalN);
+    if (n_iter < 1 || n_iter >= (int)decoder.max_nof_iter) {
+      printf("Error: codeword %d stopped after %d iterations, clean codewords must stop early\n", j, n_iter);
+      exit(-1);
+    }
   }
   gettimeofday(&t[2], NULL);
   get_time_interval(t);
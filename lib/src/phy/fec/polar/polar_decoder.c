@@ -43,6 +43,7 @@
 #include "polar_decoder_ssc_s.h"
 #include "srsran/phy/fec/polar/polar_decoder.h"
 #include "srsran/phy/utils/debug.h"
+#include "srsran/phy/utils/simd_isa.h"
 
 /*! SSC Polar decoder with float LLR inputs. */
 static int decode_ssc_f(void*           o,
@@ -215,6 +216,10 @@ int srsran_polar_decoder_init(srsran_polar_decoder_t* q, srsran_polar_decoder_ty
       return init_ssc_c(q);
 #ifdef LV_HAVE_AVX2
     case SRSRAN_POLAR_DECODER_SSC_C_AVX2:
+      if (!srsran_simd_isa_available(SRSRAN_SIMD_ISA_AVX2)) {
+        ERROR("Polar decoder type %d is not supported by this CPU", type);
+        return -1;
+      }
       return init_ssc_c_avx2(q);
 #endif
     default:
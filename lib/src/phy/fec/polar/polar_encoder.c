@@ -33,6 +33,8 @@
 #include "srsran/phy/fec/polar/polar_encoder.h"
 #include "polar_encoder_avx2.h"
 #include "polar_encoder_pipelined.h"
+#include "srsran/phy/utils/debug.h"
+#include "srsran/phy/utils/simd_isa.h"
 #include <inttypes.h>
 #include <stdio.h>
 #include <stdlib.h>
@@ -105,6 +107,10 @@ int srsran_polar_encoder_init(srsran_polar_encoder_t* q, srsran_polar_encoder_ty
       return init_pipelined(q, code_size_log);
 #ifdef LV_HAVE_AVX2
     case SRSRAN_POLAR_ENCODER_AVX2:
+      if (!srsran_simd_isa_available(SRSRAN_SIMD_ISA_AVX2)) {
+        ERROR("Polar encoder type %d is not supported by this CPU", type);
+        return -1;
+      }
       return init_avx2(q, code_size_log);
 #endif // LV_HAVE_AVX2
     default:
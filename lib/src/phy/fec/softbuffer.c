@@ -29,21 +29,39 @@
 #include "srsran/phy/fec/softbuffer.h"
 #include "srsran/phy/fec/turbo/turbodecoder_gen.h"
 #include "srsran/phy/phch/ra.h"
+#include "srsran/phy/utils/debug.h"
 #include "srsran/phy/utils/vector.h"
 
 #define MAX_PDSCH_RE(cp) (2 * SRSRAN_CP_NSYMB(cp) * 12)
 
-int srsran_softbuffer_rx_init(srsran_softbuffer_rx_t* q, uint32_t nof_prb)
+// Rx code block storage is the soft bits followed by the decoded bits, each 64-byte aligned
+#define RX_CB_DATA_OFFSET(max_cb_size) (SRSRAN_CEIL((max_cb_size) * sizeof(int16_t), 64) * 64)
+#define RX_CB_NOF_BYTES(max_cb_size) (RX_CB_DATA_OFFSET(max_cb_size) + SRSRAN_CEIL((max_cb_size) / 8, 64) * 64)
+
+// Maximum number of code blocks of a TB in the given bandwidth
+static int max_cb_from_prb(uint32_t nof_prb)
 {
   int ret = srsran_ra_tbs_from_idx(SRSRAN_RA_NOF_TBS_IDX - 1, nof_prb);
+  if (ret == SRSRAN_ERROR) {
+    return SRSRAN_ERROR;
+  }
+  return ret / (SRSRAN_TCOD_MAX_LEN_CB - 24) + 1;
+}
 
+// Upper bound of the number of code blocks of a TB
+static uint32_t nof_cb_from_tbs(uint32_t tbs)
+{
+  return (tbs + 24) / (SRSRAN_TCOD_MAX_LEN_CB - 24) + 1;
+}
+
+int srsran_softbuffer_rx_init(srsran_softbuffer_rx_t* q, uint32_t nof_prb)
+{
+  int ret = max_cb_from_prb(nof_prb);
   if (ret == SRSRAN_ERROR) {
     return SRSRAN_ERROR;
   }
-  uint32_t max_cb      = (uint32_t)ret / (SRSRAN_TCOD_MAX_LEN_CB - 24) + 1;
-  uint32_t max_cb_size = SOFTBUFFER_SIZE;
 
-  return srsran_softbuffer_rx_init_guru(q, max_cb, max_cb_size);
+  return srsran_softbuffer_rx_init_guru(q, (uint32_t)ret, SOFTBUFFER_SIZE);
 }
 
 int srsran_softbuffer_rx_init_guru(srsran_softbuffer_rx_t* q, uint32_t max_cb, uint32_t max_cb_size)
@@ -112,6 +130,10 @@ clean_exit:
 void srsran_softbuffer_rx_free(srsran_softbuffer_rx_t* q)
 {
   if (q) {
+    // Pooled storage goes back to the pool, only the tables are freed
+    if (q->pool) {
+      srsran_softbuffer_rx_release(q);
+    }
     if (q->buffer_f) {
       for (uint32_t i = 0; i < q->max_cb; i++) {
         if (q->buffer_f[i]) {
@@ -138,8 +160,7 @@ void srsran_softbuffer_rx_free(srsran_softbuffer_rx_t* q)
 
 void srsran_softbuffer_rx_reset_tbs(srsran_softbuffer_rx_t* q, uint32_t tbs)
 {
-  uint32_t nof_cb = (tbs + 24) / (SRSRAN_TCOD_MAX_LEN_CB - 24) + 1;
-  srsran_softbuffer_rx_reset_cb(q, SRSRAN_MIN(nof_cb, q->max_cb));
+  srsran_softbuffer_rx_reset_cb(q, SRSRAN_MIN(nof_cb_from_tbs(tbs), q->max_cb));
 }
 
 void srsran_softbuffer_rx_reset(srsran_softbuffer_rx_t* q)
@@ -170,14 +191,12 @@ void srsran_softbuffer_rx_reset_cb(srsran_softbuffer_rx_t* q, uint32_t nof_cb)
 
 int srsran_softbuffer_tx_init(srsran_softbuffer_tx_t* q, uint32_t nof_prb)
 {
-  int ret = srsran_ra_tbs_from_idx(SRSRAN_RA_NOF_TBS_IDX - 1, nof_prb);
+  int ret = max_cb_from_prb(nof_prb);
   if (ret == SRSRAN_ERROR) {
     return SRSRAN_ERROR;
   }
-  uint32_t max_cb      = (uint32_t)ret / (SRSRAN_TCOD_MAX_LEN_CB - 24) + 1;
-  uint32_t max_cb_size = SOFTBUFFER_SIZE;
 
-  return srsran_softbuffer_tx_init_guru(q, max_cb, max_cb_size);
+  return srsran_softbuffer_tx_init_guru(q, (uint32_t)ret, SOFTBUFFER_SIZE);
 }
 
 int srsran_softbuffer_tx_init_guru(srsran_softbuffer_tx_t* q, uint32_t max_cb, uint32_t max_cb_size)
@@ -218,6 +237,10 @@ int srsran_softbuffer_tx_init_guru(srsran_softbuffer_tx_t* q, uint32_t max_cb, u
 void srsran_softbuffer_tx_free(srsran_softbuffer_tx_t* q)
 {
   if (q) {
+    // Pooled storage goes back to the pool, only the table is freed
+    if (q->pool) {
+      srsran_softbuffer_tx_release(q);
+    }
     if (q->buffer_b) {
       for (uint32_t i = 0; i < q->max_cb; i++) {
         if (q->buffer_b[i]) {
@@ -232,8 +255,7 @@ void srsran_softbuffer_tx_free(srsran_softbuffer_tx_t* q)
 
 void srsran_softbuffer_tx_reset_tbs(srsran_softbuffer_tx_t* q, uint32_t tbs)
 {
-  uint32_t nof_cb = (tbs + 24) / (SRSRAN_TCOD_MAX_LEN_CB - 24) + 1;
-  srsran_softbuffer_tx_reset_cb(q, nof_cb);
+  srsran_softbuffer_tx_reset_cb(q, nof_cb_from_tbs(tbs));
 }
 
 void srsran_softbuffer_tx_reset(srsran_softbuffer_tx_t* q)
@@ -254,3 +276,269 @@ void srsran_softbuffer_tx_reset_cb(srsran_softbuffer_tx_t* q, uint32_t nof_cb)
     }
   }
 }
+
+// Allocates nof_cb new code blocks into the free list, the caller holds the mutex
+static int softbuffer_pool_grow(srsran_softbuffer_pool_t* q, uint32_t nof_cb)
+{
+  if (q->max_nof_cb > 0 && q->nof_cb + nof_cb > q->max_nof_cb) {
+    return SRSRAN_ERROR;
+  }
+
+  // The free list must be able to hold every allocated code block
+  if (q->nof_cb + nof_cb > q->free_capacity) {
+    uint32_t  capacity  = SRSRAN_MAX(SRSRAN_MAX(2 * q->free_capacity, q->nof_cb + nof_cb), 16);
+    uint8_t** free_list = realloc(q->free_list, sizeof(uint8_t*) * capacity);
+    if (!free_list) {
+      perror("realloc");
+      return SRSRAN_ERROR;
+    }
+    q->free_list     = free_list;
+    q->free_capacity = capacity;
+  }
+
+  for (uint32_t i = 0; i < nof_cb; i++) {
+    uint8_t* cb = srsran_vec_u8_malloc(q->cb_nof_bytes);
+    if (!cb) {
+      perror("malloc");
+      return SRSRAN_ERROR;
+    }
+    q->free_list[q->nof_free++] = cb;
+    q->nof_cb++;
+  }
+
+  return SRSRAN_SUCCESS;
+}
+
+// Takes nof_cb code blocks from the pool, either all of them or none
+static int softbuffer_pool_lease(srsran_softbuffer_pool_t* q, uint8_t** cb, uint32_t nof_cb)
+{
+  int ret = SRSRAN_SUCCESS;
+
+  pthread_mutex_lock(&q->mutex);
+  if (nof_cb > q->nof_free) {
+    ret = softbuffer_pool_grow(q, nof_cb - q->nof_free);
+  }
+  if (ret == SRSRAN_SUCCESS) {
+    for (uint32_t i = 0; i < nof_cb; i++) {
+      cb[i] = q->free_list[--q->nof_free];
+    }
+  }
+  pthread_mutex_unlock(&q->mutex);
+
+  return ret;
+}
+
+static void softbuffer_pool_give_back(srsran_softbuffer_pool_t* q, uint8_t* cb)
+{
+  pthread_mutex_lock(&q->mutex);
+  q->free_list[q->nof_free++] = cb;
+  pthread_mutex_unlock(&q->mutex);
+}
+
+static int softbuffer_pool_init(srsran_softbuffer_pool_t* q,
+                                uint32_t                  nof_prb,
+                                uint32_t                  cb_nof_bytes,
+                                uint32_t                  nof_prealloc_cb,
+                                uint32_t                  max_nof_cb)
+{
+  if (q == NULL || max_cb_from_prb(nof_prb) == SRSRAN_ERROR) {
+    return SRSRAN_ERROR_INVALID_INPUTS;
+  }
+
+  SRSRAN_MEM_ZERO(q, srsran_softbuffer_pool_t, 1);
+  q->max_cb_size  = SOFTBUFFER_SIZE;
+  q->cb_nof_bytes = cb_nof_bytes;
+  q->max_nof_cb   = max_nof_cb;
+  if (pthread_mutex_init(&q->mutex, NULL)) {
+    return SRSRAN_ERROR;
+  }
+
+  if (max_nof_cb > 0) {
+    nof_prealloc_cb = SRSRAN_MIN(nof_prealloc_cb, max_nof_cb);
+  }
+  if (softbuffer_pool_grow(q, nof_prealloc_cb) < SRSRAN_SUCCESS) {
+    srsran_softbuffer_pool_free(q);
+    return SRSRAN_ERROR;
+  }
+
+  return SRSRAN_SUCCESS;
+}
+
+int srsran_softbuffer_pool_rx_init(srsran_softbuffer_pool_t* q,
+                                   uint32_t                  nof_prb,
+                                   uint32_t                  nof_prealloc_cb,
+                                   uint32_t                  max_nof_cb)
+{
+  return softbuffer_pool_init(q, nof_prb, RX_CB_NOF_BYTES(SOFTBUFFER_SIZE), nof_prealloc_cb, max_nof_cb);
+}
+
+int srsran_softbuffer_pool_tx_init(srsran_softbuffer_pool_t* q,
+                                   uint32_t                  nof_prb,
+                                   uint32_t                  nof_prealloc_cb,
+                                   uint32_t                  max_nof_cb)
+{
+  return softbuffer_pool_init(q, nof_prb, SOFTBUFFER_SIZE, nof_prealloc_cb, max_nof_cb);
+}
+
+void srsran_softbuffer_pool_free(srsran_softbuffer_pool_t* q)
+{
+  if (q) {
+    if (q->nof_free != q->nof_cb) {
+      ERROR("Freeing softbuffer pool with %d code blocks still leased", q->nof_cb - q->nof_free);
+    }
+    if (q->free_list) {
+      for (uint32_t i = 0; i < q->nof_free; i++) {
+        free(q->free_list[i]);
+      }
+      free(q->free_list);
+    }
+    pthread_mutex_destroy(&q->mutex);
+    SRSRAN_MEM_ZERO(q, srsran_softbuffer_pool_t, 1);
+  }
+}
+
+uint32_t srsran_softbuffer_pool_nof_allocated(srsran_softbuffer_pool_t* q)
+{
+  pthread_mutex_lock(&q->mutex);
+  uint32_t ret = q->nof_cb;
+  pthread_mutex_unlock(&q->mutex);
+  return ret;
+}
+
+uint32_t srsran_softbuffer_pool_nof_leased(srsran_softbuffer_pool_t* q)
+{
+  pthread_mutex_lock(&q->mutex);
+  uint32_t ret = q->nof_cb - q->nof_free;
+  pthread_mutex_unlock(&q->mutex);
+  return ret;
+}
+
+int srsran_softbuffer_rx_init_pool(srsran_softbuffer_rx_t* q, srsran_softbuffer_pool_t* pool, uint32_t nof_prb)
+{
+  if (q == NULL || pool == NULL) {
+    return SRSRAN_ERROR_INVALID_INPUTS;
+  }
+
+  int max_cb = max_cb_from_prb(nof_prb);
+  if (max_cb == SRSRAN_ERROR) {
+    return SRSRAN_ERROR;
+  }
+
+  SRSRAN_MEM_ZERO(q, srsran_softbuffer_rx_t, 1);
+  q->max_cb_size = pool->max_cb_size;
+  q->pool        = pool;
+  q->pool_max_cb = (uint32_t)max_cb;
+
+  q->buffer_f = SRSRAN_MEM_ALLOC(int16_t*, q->pool_max_cb);
+  q->data     = SRSRAN_MEM_ALLOC(uint8_t*, q->pool_max_cb);
+  q->cb_crc   = SRSRAN_MEM_ALLOC(bool, q->pool_max_cb);
+  if (!q->buffer_f || !q->data || !q->cb_crc) {
+    perror("malloc");
+    srsran_softbuffer_rx_free(q);
+    return SRSRAN_ERROR;
+  }
+  SRSRAN_MEM_ZERO(q->buffer_f, int16_t*, q->pool_max_cb);
+  SRSRAN_MEM_ZERO(q->data, uint8_t*, q->pool_max_cb);
+  SRSRAN_MEM_ZERO(q->cb_crc, bool, q->pool_max_cb);
+
+  return SRSRAN_SUCCESS;
+}
+
+int srsran_softbuffer_rx_lease(srsran_softbuffer_rx_t* q, uint32_t tbs)
+{
+  if (q == NULL || q->pool == NULL) {
+    return SRSRAN_ERROR_INVALID_INPUTS;
+  }
+
+  srsran_softbuffer_rx_release(q);
+
+  // The code blocks are leased into the decoded bits table and split afterwards
+  uint32_t nof_cb = SRSRAN_MIN(nof_cb_from_tbs(tbs), q->pool_max_cb);
+  if (softbuffer_pool_lease(q->pool, q->data, nof_cb) < SRSRAN_SUCCESS) {
+    SRSRAN_MEM_ZERO(q->data, uint8_t*, q->pool_max_cb);
+    return SRSRAN_ERROR;
+  }
+  for (uint32_t i = 0; i < nof_cb; i++) {
+    q->buffer_f[i] = (int16_t*)q->data[i];
+    q->data[i] += RX_CB_DATA_OFFSET(q->max_cb_size);
+  }
+  q->max_cb = nof_cb;
+
+  srsran_softbuffer_rx_reset(q);
+
+  return SRSRAN_SUCCESS;
+}
+
+void srsran_softbuffer_rx_release(srsran_softbuffer_rx_t* q)
+{
+  if (q == NULL || q->pool == NULL) {
+    return;
+  }
+
+  for (uint32_t i = 0; i < q->max_cb; i++) {
+    softbuffer_pool_give_back(q->pool, (uint8_t*)q->buffer_f[i]);
+    q->buffer_f[i] = NULL;
+    q->data[i]     = NULL;
+  }
+  q->max_cb = 0;
+  q->tb_crc = false;
+}
+
+int srsran_softbuffer_tx_init_pool(srsran_softbuffer_tx_t* q, srsran_softbuffer_pool_t* pool, uint32_t nof_prb)
+{
+  if (q == NULL || pool == NULL) {
+    return SRSRAN_ERROR_INVALID_INPUTS;
+  }
+
+  int max_cb = max_cb_from_prb(nof_prb);
+  if (max_cb == SRSRAN_ERROR) {
+    return SRSRAN_ERROR;
+  }
+
+  SRSRAN_MEM_ZERO(q, srsran_softbuffer_tx_t, 1);
+  q->max_cb_size = pool->max_cb_size;
+  q->pool        = pool;
+  q->pool_max_cb = (uint32_t)max_cb;
+
+  q->buffer_b = SRSRAN_MEM_ALLOC(uint8_t*, q->pool_max_cb);
+  if (!q->buffer_b) {
+    perror("malloc");
+    return SRSRAN_ERROR;
+  }
+  SRSRAN_MEM_ZERO(q->buffer_b, uint8_t*, q->pool_max_cb);
+
+  return SRSRAN_SUCCESS;
+}
+
+int srsran_softbuffer_tx_lease(srsran_softbuffer_tx_t* q, uint32_t tbs)
+{
+  if (q == NULL || q->pool == NULL) {
+    return SRSRAN_ERROR_INVALID_INPUTS;
+  }
+
+  srsran_softbuffer_tx_release(q);
+
+  uint32_t nof_cb = SRSRAN_MIN(nof_cb_from_tbs(tbs), q->pool_max_cb);
+  if (softbuffer_pool_lease(q->pool, q->buffer_b, nof_cb) < SRSRAN_SUCCESS) {
+    SRSRAN_MEM_ZERO(q->buffer_b, uint8_t*, q->pool_max_cb);
+    return SRSRAN_ERROR;
+  }
+  q->max_cb = nof_cb;
+
+  srsran_softbuffer_tx_reset(q);
+
+  return SRSRAN_SUCCESS;
+}
+
+void srsran_softbuffer_tx_release(srsran_softbuffer_tx_t* q)
+{
+  if (q == NULL || q->pool == NULL) {
+    return;
+  }
+
+  for (uint32_t i = 0; i < q->max_cb; i++) {
+    softbuffer_pool_give_back(q->pool, q->buffer_b[i]);
+    q->buffer_b[i] = NULL;
+  }
+  q->max_cb = 0;
+}
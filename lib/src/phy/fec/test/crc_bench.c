@@ -0,0 +1,186 @@
+/**
+ * Copyright 2013-2021 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <sys/time.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "srsran/common/test_common.h"
+#include "srsran/srsran.h"
+
+#define MAX_NOF_BITS 75376
+#define NOF_RANDOM_LENGTHS 200
+
+static uint32_t nof_reps = 1000;
+static uint32_t seed     = 0;
+
+static const struct {
+  uint32_t poly;
+  int      order;
+} crc_list[] = {{SRSRAN_LTE_CRC24A, 24},
+                {SRSRAN_LTE_CRC24B, 24},
+                {SRSRAN_LTE_CRC24C, 24},
+                {SRSRAN_LTE_CRC16, 16},
+                {SRSRAN_LTE_CRC11, 11},
+                {SRSRAN_LTE_CRC8, 8},
+                {SRSRAN_LTE_CRC6, 6}};
+
+// From the smallest DCI payload to the largest LTE TB
+static const uint32_t tbs_list[] = {16, 40, 104, 256, 1000, 6144, 8448, 25456, MAX_NOF_BITS};
+
+void usage(char* prog)
+{
+  printf("Usage: %s [rs]\n", prog);
+  printf("\t-r Number of benchmark repetitions [Default %d]\n", nof_reps);
+  printf("\t-s seed [Default 0=time]\n");
+}
+
+void parse_args(int argc, char** argv)
+{
+  int opt;
+  while ((opt = getopt(argc, argv, "rs")) != -1) {
+    switch (opt) {
+      case 'r':
+        nof_reps = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      case 's':
+        seed = (uint32_t)strtoul(argv[optind], NULL, 0);
+        break;
+      default:
+        usage(argv[0]);
+        exit(-1);
+    }
+  }
+}
+
+// Bit-serial polynomial division, the definition every optimised path must match
+static uint32_t crc_reference(uint32_t poly, int order, const uint8_t* bits, uint32_t nof_bits)
+{
+  uint64_t mask = ((uint64_t)1 << order) - 1;
+  uint64_t crc  = 0;
+  for (uint32_t i = 0; i < nof_bits; i++) {
+    uint64_t bit = ((crc >> (order - 1)) ^ bits[i]) & 1;
+    crc          = (crc << 1) & mask;
+    if (bit) {
+      crc ^= poly & mask;
+    }
+  }
+  return (uint32_t)crc;
+}
+
+static int test_crc(srsran_crc_t* crc, uint32_t poly, int order, uint8_t* bits, uint8_t* bytes, uint32_t nof_bits)
+{
+  uint32_t expected = crc_reference(poly, order, bits, nof_bits);
+  TESTASSERT(srsran_crc_checksum(crc, bits, nof_bits) == expected);
+
+  // Packed input only takes whole bytes
+  uint32_t nof_bits8 = nof_bits - nof_bits % 8;
+  srsran_bit_pack_vector(bits, bytes, nof_bits8);
+  TESTASSERT(srsran_crc_checksum_byte(crc, bytes, nof_bits8) == crc_reference(poly, order, bits, nof_bits8));
+
+  // The attached CRC matches
+  uint8_t saved[32];
+  memcpy(saved, &bits[nof_bits], order);
+  srsran_crc_attach(crc, bits, nof_bits);
+  TESTASSERT(srsran_crc_match(crc, bits, nof_bits));
+  memcpy(&bits[nof_bits], saved, order);
+
+  return SRSRAN_SUCCESS;
+}
+
+static double bench_mbps(srsran_crc_t* crc, uint8_t* data, uint32_t nof_bits, bool packed)
+{
+  struct timeval t[3];
+  uint32_t       dummy = 0;
+
+  // Short inputs repeat more to stay above the timer resolution
+  uint32_t reps = nof_reps * SRSRAN_MAX(1, 1024 / nof_bits);
+
+  gettimeofday(&t[1], NULL);
+  for (uint32_t r = 0; r < reps; r++) {
+    if (packed) {
+      dummy ^= srsran_crc_checksum_byte(crc, data, nof_bits);
+    } else {
+      dummy ^= srsran_crc_checksum(crc, data, nof_bits);
+    }
+  }
+  gettimeofday(&t[2], NULL);
+  get_time_interval(t);
+
+  // Keep the compiler from dropping the loop
+  if (dummy == 0xffffffff) {
+    printf(" ");
+  }
+
+  double us = t[0].tv_sec * 1e6 + t[0].tv_usec;
+  return (us > 0) ? (double)nof_bits * reps / us : 0.0;
+}
+
+int main(int argc, char** argv)
+{
+  srsran_crc_t crc;
+  parse_args(argc, argv);
+
+  if (!seed) {
+    seed = time(NULL);
+  }
+  srand(seed);
+
+  uint8_t* bits  = srsran_vec_u8_malloc(MAX_NOF_BITS + 32);
+  uint8_t* bytes = srsran_vec_u8_malloc(MAX_NOF_BITS / 8 + 4);
+  TESTASSERT(bits && bytes);
+  for (uint32_t i = 0; i < MAX_NOF_BITS + 32; i++) {
+    bits[i] = rand() % 2;
+  }
+
+  // Every polynomial against the bit-serial reference, including lengths that are not a multiple of 8
+  for (uint32_t c = 0; c < sizeof(crc_list) / sizeof(crc_list[0]); c++) {
+    TESTASSERT(srsran_crc_init(&crc, crc_list[c].poly, crc_list[c].order) == SRSRAN_SUCCESS);
+    for (uint32_t i = 0; i < sizeof(tbs_list) / sizeof(tbs_list[0]); i++) {
+      TESTASSERT(test_crc(&crc, crc_list[c].poly, crc_list[c].order, bits, bytes, tbs_list[i]) == SRSRAN_SUCCESS);
+    }
+    for (uint32_t i = 0; i < NOF_RANDOM_LENGTHS; i++) {
+      uint32_t nof_bits = 1 + rand() % 2048;
+      TESTASSERT(test_crc(&crc, crc_list[c].poly, crc_list[c].order, bits, bytes, nof_bits) == SRSRAN_SUCCESS);
+    }
+  }
+
+  // Throughput of the TB CRC
+  TESTASSERT(srsran_crc_init(&crc, SRSRAN_LTE_CRC24A, 24) == SRSRAN_SUCCESS);
+  srsran_bit_pack_vector(bits, bytes, MAX_NOF_BITS);
+  printf("%10s %20s %20s\n", "TBS (bits)", "unpacked (Mbps)", "packed (Mbps)");
+  for (uint32_t i = 0; i < sizeof(tbs_list) / sizeof(tbs_list[0]); i++) {
+    printf("%10d %20.1f %20.1f\n",
+           tbs_list[i],
+           bench_mbps(&crc, bits, tbs_list[i], false),
+           bench_mbps(&crc, bytes, tbs_list[i], true));
+  }
+
+  free(bits);
+  free(bytes);
+
+  printf("Ok!\n");
+  return SRSRAN_SUCCESS;
+}
@@ -0,0 +1,286 @@
+/**
+ * Copyright 2013-2021 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/time.h>
+
+#include "srsran/common/test_common.h"
+#include "srsran/phy/fec/softbuffer.h"
+#include "srsran/phy/phch/ra.h"
+#include "srsran/phy/utils/debug.h"
+#include "srsran/phy/utils/random.h"
+#include "srsran/phy/utils/simd.h"
+#include "srsran/phy/utils/vector.h"
+
+#define NOF_HARQ 8
+#define HARQ_RTT 4
+#define MAX_SAMPLE_UES 16
+
+#define NOF_GRANTS 8    // New DL and UL grants per TTI
+#define NOF_TTIS 1000   // Simulated TTIs
+#define BLER 0.1f       // Ratio of TBs that are not acknowledged
+#define EXPIRY_TTIS 256 // TTIs after which unacknowledged storage expires
+
+static srsran_random_t random_gen = NULL;
+
+static int test_lease_release(uint32_t nof_prb, uint32_t max_tbs)
+{
+  srsran_softbuffer_pool_t pool_rx, pool_tx;
+  srsran_softbuffer_rx_t   rx[2];
+  srsran_softbuffer_tx_t   tx;
+
+  TESTASSERT(srsran_softbuffer_pool_rx_init(&pool_rx, nof_prb, 1, 0) == SRSRAN_SUCCESS);
+  TESTASSERT(srsran_softbuffer_pool_tx_init(&pool_tx, nof_prb, 0, 0) == SRSRAN_SUCCESS);
+  TESTASSERT(srsran_softbuffer_pool_nof_allocated(&pool_rx) == 1);
+  TESTASSERT(srsran_softbuffer_rx_init_pool(&rx[0], &pool_rx, nof_prb) == SRSRAN_SUCCESS);
+  TESTASSERT(srsran_softbuffer_tx_init_pool(&tx, &pool_tx, nof_prb) == SRSRAN_SUCCESS);
+  TESTASSERT(rx[0].max_cb == 0 && tx.max_cb == 0);
+
+  // The largest TB leases as many code blocks as a worst-case softbuffer holds
+  TESTASSERT(srsran_softbuffer_rx_lease(&rx[0], max_tbs) == SRSRAN_SUCCESS);
+  TESTASSERT(srsran_softbuffer_tx_lease(&tx, max_tbs) == SRSRAN_SUCCESS);
+  uint32_t max_cb = rx[0].max_cb;
+  TESTASSERT(max_cb == rx[0].pool_max_cb && tx.max_cb == tx.pool_max_cb);
+  TESTASSERT(srsran_softbuffer_pool_nof_leased(&pool_rx) == max_cb);
+  TESTASSERT(srsran_softbuffer_pool_nof_leased(&pool_tx) == max_cb);
+
+  // Leased storage is zeroed and the soft and decoded bits of every code block are disjoint
+  for (uint32_t i = 0; i < max_cb; i++) {
+    TESTASSERT(SRSRAN_IS_ALIGNED(rx[0].buffer_f[i]) && SRSRAN_IS_ALIGNED(rx[0].data[i]));
+    TESTASSERT((uint8_t*)&rx[0].buffer_f[i][rx[0].max_cb_size] <= rx[0].data[i]);
+    for (uint32_t j = 0; j < rx[0].max_cb_size; j++) {
+      TESTASSERT(rx[0].buffer_f[i][j] == 0);
+      TESTASSERT(tx.buffer_b[i][j] == 0);
+    }
+    for (uint32_t j = 0; j < rx[0].max_cb_size / 8; j++) {
+      TESTASSERT(rx[0].data[i][j] == 0);
+    }
+    memset(rx[0].data[i], 0xff, rx[0].max_cb_size / 8);
+    TESTASSERT(rx[0].buffer_f[i][rx[0].max_cb_size - 1] == 0);
+    memset(tx.buffer_b[i], 0xff, tx.max_cb_size);
+  }
+
+  // A smaller TB gives back the storage it does not need
+  TESTASSERT(srsran_softbuffer_tx_lease(&tx, 100) == SRSRAN_SUCCESS);
+  TESTASSERT(tx.max_cb == 1 && srsran_softbuffer_pool_nof_leased(&pool_tx) == 1);
+  for (uint32_t j = 0; j < tx.max_cb_size; j++) {
+    TESTASSERT(tx.buffer_b[0][j] == 0);
+  }
+
+  srsran_softbuffer_rx_release(&rx[0]);
+  srsran_softbuffer_tx_release(&tx);
+  TESTASSERT(rx[0].max_cb == 0 && tx.max_cb == 0);
+  TESTASSERT(srsran_softbuffer_pool_nof_leased(&pool_rx) == 0);
+  TESTASSERT(srsran_softbuffer_pool_nof_leased(&pool_tx) == 0);
+  TESTASSERT(srsran_softbuffer_pool_nof_allocated(&pool_rx) == max_cb);
+
+  srsran_softbuffer_rx_free(&rx[0]);
+  srsran_softbuffer_tx_free(&tx);
+  srsran_softbuffer_pool_free(&pool_rx);
+  srsran_softbuffer_pool_free(&pool_tx);
+
+  // A lease that exceeds the pool limit takes nothing and leaves the softbuffer empty
+  TESTASSERT(srsran_softbuffer_pool_rx_init(&pool_rx, nof_prb, 0, max_cb) == SRSRAN_SUCCESS);
+  TESTASSERT(srsran_softbuffer_rx_init_pool(&rx[0], &pool_rx, nof_prb) == SRSRAN_SUCCESS);
+  TESTASSERT(srsran_softbuffer_rx_init_pool(&rx[1], &pool_rx, nof_prb) == SRSRAN_SUCCESS);
+  TESTASSERT(srsran_softbuffer_rx_lease(&rx[0], max_tbs) == SRSRAN_SUCCESS);
+  if (max_cb > 1) {
+    TESTASSERT(srsran_softbuffer_rx_lease(&rx[1], 100) == SRSRAN_ERROR);
+    TESTASSERT(rx[1].max_cb == 0);
+    TESTASSERT(srsran_softbuffer_pool_nof_leased(&pool_rx) == max_cb);
+  }
+
+  // Freeing a pooled softbuffer gives its storage back
+  srsran_softbuffer_rx_free(&rx[0]);
+  TESTASSERT(srsran_softbuffer_pool_nof_leased(&pool_rx) == 0);
+  TESTASSERT(srsran_softbuffer_rx_lease(&rx[1], max_tbs) == SRSRAN_SUCCESS);
+  TESTASSERT(srsran_softbuffer_pool_nof_allocated(&pool_rx) == max_cb);
+  srsran_softbuffer_rx_free(&rx[1]);
+  srsran_softbuffer_pool_free(&pool_rx);
+
+  return SRSRAN_SUCCESS;
+}
+
+// Bytes that the worst-case softbuffers of one UE allocate, as srsran_softbuffer_rx/tx_init() do
+static size_t worst_case_ue_bytes(uint32_t max_cb)
+{
+  size_t rx_cb = SOFTBUFFER_SIZE * sizeof(int16_t) + SOFTBUFFER_SIZE / 8;
+  size_t tx_cb = SOFTBUFFER_SIZE;
+  return NOF_HARQ * max_cb * (rx_cb + sizeof(int16_t*) + sizeof(uint8_t*) + sizeof(bool)) +
+         NOF_HARQ * SRSRAN_MAX_TB * max_cb * (tx_cb + sizeof(uint8_t*));
+}
+
+// Bytes of the per-UE tables of pooled softbuffers, the code block storage is accounted in the pool
+static size_t pooled_ue_bytes(uint32_t max_cb)
+{
+  return NOF_HARQ * max_cb * (sizeof(int16_t*) + sizeof(uint8_t*) + sizeof(bool)) +
+         NOF_HARQ * SRSRAN_MAX_TB * max_cb * sizeof(uint8_t*);
+}
+
+static int test_attach_and_traffic(uint32_t nof_prb, uint32_t nof_ues, uint32_t max_tbs)
+{
+  struct timeval           t[3];
+  srsran_softbuffer_pool_t pool_rx, pool_tx;
+
+  uint32_t                nof_rx     = nof_ues * NOF_HARQ;
+  uint32_t                nof_tx     = nof_ues * NOF_HARQ * SRSRAN_MAX_TB;
+  srsran_softbuffer_rx_t* rx         = SRSRAN_MEM_ALLOC(srsran_softbuffer_rx_t, nof_rx);
+  srsran_softbuffer_tx_t* tx         = SRSRAN_MEM_ALLOC(srsran_softbuffer_tx_t, nof_tx);
+  uint32_t*               rx_tti     = SRSRAN_MEM_ALLOC(uint32_t, nof_rx);
+  uint32_t*               tx_tti     = SRSRAN_MEM_ALLOC(uint32_t, nof_tx);
+  bool*                   rx_ack     = SRSRAN_MEM_ALLOC(bool, nof_rx);
+  bool*                   tx_ack     = SRSRAN_MEM_ALLOC(bool, nof_tx);
+  uint32_t                sample_ues = SRSRAN_MIN(nof_ues, MAX_SAMPLE_UES);
+  TESTASSERT(rx && tx && rx_tti && tx_tti && rx_ack && tx_ack);
+
+  // Worst case: every UE allocates the storage of the largest TB for every HARQ process on attach. Too large to hold
+  // for many UEs, so the attach time is sampled on a few UEs
+  gettimeofday(&t[1], NULL);
+  for (uint32_t i = 0; i < sample_ues * NOF_HARQ; i++) {
+    TESTASSERT(srsran_softbuffer_rx_init(&rx[i], nof_prb) == SRSRAN_SUCCESS);
+  }
+  for (uint32_t i = 0; i < sample_ues * NOF_HARQ * SRSRAN_MAX_TB; i++) {
+    TESTASSERT(srsran_softbuffer_tx_init(&tx[i], nof_prb) == SRSRAN_SUCCESS);
+  }
+  gettimeofday(&t[2], NULL);
+  get_time_interval(t);
+  double   worst_attach_us = (t[0].tv_sec * 1e6 + t[0].tv_usec) / sample_ues;
+  uint32_t max_cb          = rx[0].max_cb;
+  for (uint32_t i = 0; i < sample_ues * NOF_HARQ; i++) {
+    srsran_softbuffer_rx_free(&rx[i]);
+  }
+  for (uint32_t i = 0; i < sample_ues * NOF_HARQ * SRSRAN_MAX_TB; i++) {
+    srsran_softbuffer_tx_free(&tx[i]);
+  }
+
+  // Pooled: attaching only allocates the tables, storage is leased for the TBs in flight
+  TESTASSERT(srsran_softbuffer_pool_rx_init(&pool_rx, nof_prb, 0, 0) == SRSRAN_SUCCESS);
+  TESTASSERT(srsran_softbuffer_pool_tx_init(&pool_tx, nof_prb, 0, 0) == SRSRAN_SUCCESS);
+  gettimeofday(&t[1], NULL);
+  for (uint32_t i = 0; i < nof_rx; i++) {
+    TESTASSERT(srsran_softbuffer_rx_init_pool(&rx[i], &pool_rx, nof_prb) == SRSRAN_SUCCESS);
+  }
+  for (uint32_t i = 0; i < nof_tx; i++) {
+    TESTASSERT(srsran_softbuffer_tx_init_pool(&tx[i], &pool_tx, nof_prb) == SRSRAN_SUCCESS);
+  }
+  gettimeofday(&t[2], NULL);
+  get_time_interval(t);
+  double pooled_attach_us = (t[0].tv_sec * 1e6 + t[0].tv_usec) / nof_ues;
+
+  // Every TTI schedules new DL and UL TBs of random size in the HARQ process of the TTI. ACKed TBs give their storage
+  // back after a round trip, the rest when the HARQ process is reused or the storage expires
+  for (uint32_t tti = 0; tti < NOF_TTIS; tti++) {
+    uint32_t pid = tti % NOF_HARQ;
+    for (uint32_t g = 0; g < NOF_GRANTS; g++) {
+      uint32_t ue  = (uint32_t)srsran_random_uniform_int_dist(random_gen, 0, (int)nof_ues - 1);
+      uint32_t tbs = (uint32_t)srsran_random_uniform_int_dist(random_gen, 1, (int)max_tbs);
+      uint32_t idx = ue * NOF_HARQ + pid;
+      TESTASSERT(srsran_softbuffer_rx_lease(&rx[idx], tbs) == SRSRAN_SUCCESS);
+      rx_tti[idx] = tti;
+      rx_ack[idx] = !srsran_random_bool(random_gen, BLER);
+
+      tbs = (uint32_t)srsran_random_uniform_int_dist(random_gen, 1, (int)max_tbs);
+      idx = idx * SRSRAN_MAX_TB;
+      TESTASSERT(srsran_softbuffer_tx_lease(&tx[idx], tbs) == SRSRAN_SUCCESS);
+      tx_tti[idx] = tti;
+      tx_ack[idx] = !srsran_random_bool(random_gen, BLER);
+    }
+
+    for (uint32_t i = 0; i < nof_rx; i++) {
+      uint32_t age = tti - rx_tti[i];
+      if (rx[i].max_cb > 0 && ((rx_ack[i] && age == HARQ_RTT) || age > EXPIRY_TTIS)) {
+        srsran_softbuffer_rx_release(&rx[i]);
+      }
+    }
+    for (uint32_t i = 0; i < nof_tx; i++) {
+      uint32_t age = tti - tx_tti[i];
+      if (tx[i].max_cb > 0 && ((tx_ack[i] && age == HARQ_RTT) || age > EXPIRY_TTIS)) {
+        srsran_softbuffer_tx_release(&tx[i]);
+      }
+    }
+  }
+
+  // The pool never shrinks, what it allocated is the peak of the storage in flight
+  size_t worst_bytes  = worst_case_ue_bytes(max_cb) * nof_ues;
+  size_t pooled_bytes = pooled_ue_bytes(max_cb) * nof_ues +
+                        srsran_softbuffer_pool_nof_allocated(&pool_rx) * pool_rx.cb_nof_bytes +
+                        srsran_softbuffer_pool_nof_allocated(&pool_tx) * pool_tx.cb_nof_bytes;
+  printf("%7d | %7d | %9.1f MB %9.1f us | %9.1f MB %9.1f us | %7d / %7d\n",
+         nof_prb,
+         nof_ues,
+         worst_bytes / 1e6,
+         worst_attach_us,
+         pooled_bytes / 1e6,
+         pooled_attach_us,
+         srsran_softbuffer_pool_nof_allocated(&pool_rx),
+         srsran_softbuffer_pool_nof_allocated(&pool_tx));
+
+  for (uint32_t i = 0; i < nof_rx; i++) {
+    srsran_softbuffer_rx_free(&rx[i]);
+  }
+  for (uint32_t i = 0; i < nof_tx; i++) {
+    srsran_softbuffer_tx_free(&tx[i]);
+  }
+  TESTASSERT(srsran_softbuffer_pool_nof_leased(&pool_rx) == 0);
+  TESTASSERT(srsran_softbuffer_pool_nof_leased(&pool_tx) == 0);
+  srsran_softbuffer_pool_free(&pool_rx);
+  srsran_softbuffer_pool_free(&pool_tx);
+
+  free(rx);
+  free(tx);
+  free(rx_tti);
+  free(tx_tti);
+  free(rx_ack);
+  free(tx_ack);
+
+  return SRSRAN_SUCCESS;
+}
+
+int main(int argc, char** argv)
+{
+  random_gen = srsran_random_init(1234);
+
+  const uint32_t nof_prb_list[] = {6, 15, 25, 50, 75, 100};
+
+  for (uint32_t p = 0; p < sizeof(nof_prb_list) / sizeof(uint32_t); p++) {
+    int max_tbs = srsran_ra_tbs_from_idx(SRSRAN_RA_NOF_TBS_IDX - 1, nof_prb_list[p]);
+    TESTASSERT(max_tbs > 0);
+    TESTASSERT(test_lease_release(nof_prb_list[p], (uint32_t)max_tbs) == SRSRAN_SUCCESS);
+  }
+
+  // Memory and attach time of worst-case and pooled softbuffers on 5 and 20 MHz carriers. The code blocks are the peak
+  // that the pools allocated while the traffic ran
+  printf("nof_prb | nof_ues |      worst-case memory, attach |          pooled memory, attach | Rx / Tx code blocks\n");
+  const uint32_t bench_prb_list[] = {25, 100};
+  const uint32_t nof_ues_list[]   = {16, 100, 1000};
+  for (uint32_t p = 0; p < sizeof(bench_prb_list) / sizeof(uint32_t); p++) {
+    int max_tbs = srsran_ra_tbs_from_idx(SRSRAN_RA_NOF_TBS_IDX - 1, bench_prb_list[p]);
+    for (uint32_t u = 0; u < sizeof(nof_ues_list) / sizeof(uint32_t); u++) {
+      TESTASSERT(test_attach_and_traffic(bench_prb_list[p], nof_ues_list[u], (uint32_t)max_tbs) == SRSRAN_SUCCESS);
+    }
+  }
+
+  srsran_random_free(random_gen);
+
+  return SRSRAN_SUCCESS;
+}
@@ -25,6 +25,7 @@
 #include <strings.h>
 
 #include "srsran/phy/fec/turbo/turbodecoder.h"
+#include "srsran/phy/utils/simd_isa.h"
 #include "srsran/phy/utils/vector.h"
 #include "srsran/srsran.h"
 
@@ -60,16 +61,12 @@ srsran_tdec_16bit_impl_t sse16_win_impl = {tdec_winsse16_init,
                                            tdec_winsse16_decision_byte};
 #endif
 
-/* AVX window implementation */
-#ifdef LV_HAVE_AVX2
-#define WINIMP_IS_AVX16
-#include "srsran/phy/fec/turbo/turbodecoder_win.h"
-#undef WINIMP_IS_AVX16
-srsran_tdec_16bit_impl_t avx16_win_impl = {tdec_winavx16_init,
-                                           tdec_winavx16_free,
-                                           tdec_winavx16_dec,
-                                           tdec_winavx16_extract_input,
-                                           tdec_winavx16_decision_byte};
+/* AVX window implementation, built in turbodecoder_avx.c. Run-time dispatch builds contain it whatever the baseline
+ * ISA is and only use it if the CPU supports AVX2 */
+#if defined(LV_HAVE_AVX2) || defined(SRSRAN_SIMD_DISPATCH)
+#define TDEC_HAVE_AVX2
+extern srsran_tdec_16bit_impl_t avx16_win_impl;
+extern srsran_tdec_8bit_impl_t  avx8_win_impl;
 #endif
 
 /* SSE window implementation */
@@ -85,18 +82,6 @@ srsran_tdec_8bit_impl_t sse8_win_impl = {tdec_winsse8_init,
                                          tdec_winsse8_decision_byte};
 #endif
 
-/* AVX window implementation */
-#ifdef LV_HAVE_AVX2
-#define WINIMP_IS_AVX8
-#include "srsran/phy/fec/turbo/turbodecoder_win.h"
-#undef WINIMP_IS_AVX8
-srsran_tdec_8bit_impl_t avx8_win_impl = {tdec_winavx8_init,
-                                         tdec_winavx8_free,
-                                         tdec_winavx8_dec,
-                                         tdec_winavx8_extract_input,
-                                         tdec_winavx8_decision_byte};
-#endif
-
 #ifdef HAVE_NEON
 #define WINIMP_IS_NEON16
 #include "srsran/phy/fec/turbo/turbodecoder_win.h"
@@ -156,6 +141,14 @@ int srsran_tdec_init_manual(srsran_tdec_t* h, uint32_t max_long_cb, srsran_tdec_
 
   h->dec_type = dec_type;
 
+#ifdef TDEC_HAVE_AVX2
+  if ((dec_type == SRSRAN_TDEC_AVX_WINDOW || dec_type == SRSRAN_TDEC_AVX8_WINDOW) &&
+      !srsran_simd_isa_available(SRSRAN_SIMD_ISA_AVX2)) {
+    ERROR("Error decoder %d not supported by this CPU", dec_type);
+    goto clean_and_exit;
+  }
+#endif /* TDEC_HAVE_AVX2 */
+
   // Set manual
   switch (dec_type) {
     case SRSRAN_TDEC_AUTO:
@@ -185,7 +178,7 @@ int srsran_tdec_init_manual(srsran_tdec_t* h, uint32_t max_long_cb, srsran_tdec_
       h->current_llr_type = SRSRAN_TDEC_16;
       break;
 #endif /* HAVE_NEON */
-#ifdef LV_HAVE_AVX2
+#ifdef TDEC_HAVE_AVX2
     case SRSRAN_TDEC_AVX_WINDOW:
       h->dec16[0]         = &avx16_win_impl;
       h->current_llr_type = SRSRAN_TDEC_16;
@@ -194,7 +187,7 @@ int srsran_tdec_init_manual(srsran_tdec_t* h, uint32_t max_long_cb, srsran_tdec_
       h->dec8[0]          = &avx8_win_impl;
       h->current_llr_type = SRSRAN_TDEC_8;
       break;
-#endif /* LV_HAVE_AVX2 */
+#endif /* TDEC_HAVE_AVX2 */
     default:
       ERROR("Error decoder %d not supported", dec_type);
       goto clean_and_exit;
@@ -251,10 +244,12 @@ int srsran_tdec_init_manual(srsran_tdec_t* h, uint32_t max_long_cb, srsran_tdec_
     h->dec16[AUTO_16_SSE]    = &gen_impl;
     h->dec16[AUTO_16_SSEWIN] = &sse16_win_impl;
     h->dec8[AUTO_8_SSEWIN]   = &sse8_win_impl;
-#ifdef LV_HAVE_AVX2
-    h->dec16[AUTO_16_AVXWIN] = &avx16_win_impl;
-    h->dec8[AUTO_8_AVXWIN]   = &avx8_win_impl;
-#endif /* LV_HAVE_AVX2 */
+#ifdef TDEC_HAVE_AVX2
+    if (srsran_simd_isa_available(SRSRAN_SIMD_ISA_AVX2)) {
+      h->dec16[AUTO_16_AVXWIN] = &avx16_win_impl;
+      h->dec8[AUTO_8_AVXWIN]   = &avx8_win_impl;
+    }
+#endif /* TDEC_HAVE_AVX2 */
 #else  /* HAVE_NEON | LV_HAVE_SSE */
     h->dec16[AUTO_16_SSE]    = &gen_impl;
     h->dec16[AUTO_16_SSEWIN] = &gen_impl;
@@ -380,8 +375,8 @@ static void tdec_decision_byte(srsran_tdec_t* h, uint8_t* output)
 /* Returns number of subblocks in automatic mode for this long_cb */
 uint32_t srsran_tdec_autoimp_get_subblocks(uint32_t long_cb)
 {
-#ifdef LV_HAVE_AVX2
-  if (!(long_cb % 16) && long_cb > 800) {
+#ifdef TDEC_HAVE_AVX2
+  if (srsran_simd_isa_available(SRSRAN_SIMD_ISA_AVX2) && !(long_cb % 16) && long_cb > 800) {
     return 16;
   } else
 #endif
@@ -409,8 +404,8 @@ static int tdec_sb_idx(uint32_t long_cb)
 
 uint32_t srsran_tdec_autoimp_get_subblocks_8bit(uint32_t long_cb)
 {
-#ifdef LV_HAVE_AVX2
-  if (!(long_cb % 32) && long_cb > 2048) {
+#ifdef TDEC_HAVE_AVX2
+  if (srsran_simd_isa_available(SRSRAN_SIMD_ISA_AVX2) && !(long_cb % 32) && long_cb > 2048) {
     return 32;
   } else
 #endif
@@ -349,8 +349,8 @@ int srsran_npbch_rotate(srsran_npbch_t* q,
   DEBUG("%sotating NPBCH in SFN=%d", back ? "De-R" : "R", nf);
 
   for (int i = 0; i < num_samples; i++) {
-    int c_2i   = q->seq_r14[nf % 8].c[2 * i];
-    int c_2ip1 = q->seq_r14[nf % 8].c[2 * i + 1];
+    int c_2i   = srsran_sequence_get_bit(&q->seq_r14[nf % 8], 2 * i);
+    int c_2ip1 = srsran_sequence_get_bit(&q->seq_r14[nf % 8], 2 * i + 1);
 
 #if 1
     cf_t phi_f = 0;
@@ -143,13 +143,6 @@ int srsran_psbch_init(srsran_psbch_t* q, uint32_t nof_prb, uint32_t N_sl_id, srs
     return SRSRAN_ERROR;
   }
 
-  // Interleaving
-  q->interleaver_lut = srsran_vec_u32_malloc(q->E);
-  if (!q->interleaver_lut) {
-    ERROR("Error allocating memory");
-    return SRSRAN_ERROR;
-  }
-
   // Modulation QPSK
   if (srsran_modem_table_lte(&q->mod, SRSRAN_MOD_QPSK) != SRSRAN_SUCCESS) {
     ERROR("Error srsran_modem_table_lte");
@@ -275,7 +268,7 @@ int srsran_psbch_decode(srsran_psbch_t* q, cf_t* equalized_sf_syms, uint8_t* out
   srsran_scrambling_s(&q->seq, q->llr);
 
   // Deinterleaving
-  srsran_sl_ulsch_deinterleave(q->llr, q->Qm, q->nof_data_re, q->nof_data_symbols, q->e_16, q->interleaver_lut);
+  srsran_sl_ulsch_deinterleave(q->llr, q->Qm, q->nof_data_re, q->nof_data_symbols, q->e_16);
 
   // Rate match
   srsran_rm_conv_rx_s(q->e_16, q->E, q->d_16, q->sl_bch_encoded_len);
@@ -383,9 +376,6 @@ void srsran_psbch_free(srsran_psbch_t* q)
     if (q->e_16) {
       free(q->e_16);
     }
-    if (q->interleaver_lut) {
-      free(q->interleaver_lut);
-    }
     if (q->codeword) {
       free(q->codeword);
     }
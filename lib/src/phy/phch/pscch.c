@@ -99,12 +99,6 @@ int srsran_pscch_init(srsran_pscch_t* q, uint32_t max_prb)
       return SRSRAN_ERROR;
     }
 
-    q->interleaver_lut = srsran_vec_u32_malloc(E_max);
-    if (!q->interleaver_lut) {
-      ERROR("Error allocating memory");
-      return SRSRAN_ERROR;
-    }
-
     q->codeword = srsran_vec_u8_malloc(E_max);
     if (!q->codeword) {
       ERROR("Error allocating memory");
@@ -271,8 +265,7 @@ int srsran_pscch_decode(srsran_pscch_t* q, cf_t* equalized_sf_syms, uint8_t* sci
   srsran_scrambling_s(&q->seq, q->llr);
 
   // Deinterleaving
-  srsran_sl_ulsch_deinterleave(
-      q->llr, SRSRAN_PSCCH_QM, q->E / SRSRAN_PSCCH_QM, q->nof_symbols, q->e_16, q->interleaver_lut);
+  srsran_sl_ulsch_deinterleave(q->llr, SRSRAN_PSCCH_QM, q->E / SRSRAN_PSCCH_QM, q->nof_symbols, q->e_16);
 
   // Rate matching
   srsran_rm_conv_rx_s(q->e_16, q->E, q->d_16, (3 * (q->sci_len + SRSRAN_SCI_CRC_LEN)));
@@ -361,9 +354,6 @@ void srsran_pscch_free(srsran_pscch_t* q)
     if (q->e_bytes) {
       free(q->e_bytes);
     }
-    if (q->interleaver_lut) {
-      free(q->interleaver_lut);
-    }
     if (q->codeword) {
       free(q->codeword);
     }
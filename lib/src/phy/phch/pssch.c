@@ -152,12 +152,6 @@ int srsran_pssch_init(srsran_pssch_t*                       q,
     ERROR("Error allocating memory");
     return SRSRAN_ERROR;
   }
-  q->interleaver_lut = srsran_vec_u32_malloc(SRSRAN_MAX_CODEWORD_LEN);
-  if (!q->interleaver_lut) {
-    ERROR("Error allocating memory");
-    return SRSRAN_ERROR;
-  }
-  srsran_vec_u32_zero(q->interleaver_lut, SRSRAN_MAX_CODEWORD_LEN);
 
   // Scrambling
   q->codeword = srsran_vec_u8_malloc(SRSRAN_MAX_CODEWORD_LEN);
@@ -423,7 +417,7 @@ int srsran_pssch_decode(srsran_pssch_t* q, cf_t* equalized_sf_syms, uint8_t* out
   uint32_t gamma = Gp % q->cb_segm.C;
 
   // Deinterleaving
-  srsran_sl_ulsch_deinterleave(q->llr, q->Qm, q->G / q->Qm, q->nof_data_symbols, q->f_16, q->interleaver_lut);
+  srsran_sl_ulsch_deinterleave(q->llr, q->Qm, q->G / q->Qm, q->nof_data_symbols, q->f_16);
 
   for (int r = 0; r < q->cb_segm.C; r++) {
     // Code block segmentation
@@ -644,9 +638,6 @@ void srsran_pssch_free(srsran_pssch_t* q)
     if (q->llr) {
       free(q->llr);
     }
-    if (q->interleaver_lut) {
-      free(q->interleaver_lut);
-    }
     if (q->symbols) {
       free(q->symbols);
     }
@@ -1026,7 +1026,7 @@ int srsran_pucch_n_cs_cell(srsran_cell_t cell, uint32_t n_cs_cell[SRSRAN_NSLOTS_
     for (uint32_t l = 0; l < SRSRAN_CP_NSYMB(cell.cp); l++) {
       n_cs_cell[ns][l] = 0;
       for (uint32_t i = 0; i < 8; i++) {
-        n_cs_cell[ns][l] += seq.c[8 * SRSRAN_CP_NSYMB(cell.cp) * ns + 8 * l + i] << i;
+        n_cs_cell[ns][l] += srsran_sequence_get_bit(&seq, 8 * SRSRAN_CP_NSYMB(cell.cp) * ns + 8 * l + i) << i;
       }
     }
   }
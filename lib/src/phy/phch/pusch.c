@@ -448,6 +448,7 @@ int srsran_pusch_decode(srsran_pusch_t*        q,
 
     // Set max number of iterations
     srsran_sch_set_max_noi(&q->ul_sch, cfg->max_nof_iterations);
+    srsran_sch_set_deadline(&q->ul_sch, cfg->deadline_en ? &cfg->deadline : NULL);
 
     // Decode
     ret      = srsran_ulsch_decode(&q->ul_sch, cfg, q->q, q->g, c, out->data, &out->uci);
@@ -455,6 +456,7 @@ int srsran_pusch_decode(srsran_pusch_t*        q,
 
     // Save number of iterations
     out->avg_iterations_block = q->ul_sch.avg_iterations;
+    out->nof_shed_iterations  = q->ul_sch.shed_iterations;
 
     // Save O_cqi for power control
     cfg->last_O_cqi = srsran_cqi_size(&cfg->uci_cfg.cqi);
@@ -510,6 +512,10 @@ uint32_t srsran_pusch_rx_info(srsran_pusch_cfg_t*    cfg,
   len = srsran_print_check(
       str, str_len, len, ", crc=%s, avg_iter=%.1f", res->crc ? "OK" : "KO", res->avg_iterations_block);
 
+  if (cfg->deadline_en) {
+    len = srsran_print_check(str, str_len, len, ", shed_iter=%d", res->nof_shed_iterations);
+  }
+
   len += srsran_uci_data_info(&cfg->uci_cfg, &res->uci, &str[len], str_len - len);
 
   len = srsran_print_check(str, str_len, len, ", snr=%.1f dB", chest_res->snr_db);
@@ -539,3 +545,36 @@ uint32_t srsran_pusch_rx_info(srsran_pusch_cfg_t*    cfg,
   }
   return len;
 }
+
+void srsran_pusch_deadline_order(const bool* priority, uint32_t nof_pusch, uint32_t* order)
+{
+  uint32_t n = 0;
+  for (uint32_t i = 0; i < nof_pusch; i++) {
+    if (priority[i]) {
+      order[n++] = i;
+    }
+  }
+  for (uint32_t i = 0; i < nof_pusch; i++) {
+    if (!priority[i]) {
+      order[n++] = i;
+    }
+  }
+}
+
+bool srsran_pusch_deadline_shed(const srsran_pusch_deadline_t* q,
+                                bool                           priority,
+                                uint32_t                       nof_bits,
+                                int64_t                        now_ns,
+                                int64_t                        deadline_ns)
+{
+  return !priority && now_ns + (int64_t)(q->ns_per_bit * nof_bits) > deadline_ns;
+}
+
+void srsran_pusch_deadline_learn(srsran_pusch_deadline_t* q, uint32_t nof_bits, int64_t elapsed_ns)
+{
+  if (nof_bits == 0) {
+    return;
+  }
+  float ns_per_bit = (float)elapsed_ns / nof_bits;
+  q->ns_per_bit    = (q->ns_per_bit > 0) ? SRSRAN_VEC_EMA(ns_per_bit, q->ns_per_bit, 0.1f) : ns_per_bit;
+}
@@ -42,7 +42,7 @@ static int f_hop_sum(srsran_ra_ul_pusch_hopping_t* q, uint32_t i)
 {
   uint32_t sum = 0;
   for (uint32_t k = i * 10 + 1; k < i * 10 + 9; i++) {
-    sum += (q->seq_type2_fo.c[k] << (k - (i * 10 + 1)));
+    sum += (srsran_sequence_get_bit(&q->seq_type2_fo, k) << (k - (i * 10 + 1)));
   }
   return sum;
 }
@@ -71,7 +71,7 @@ static int f_m(srsran_ra_ul_pusch_hopping_t* q, srsran_pusch_hopping_cfg_t* hopp
       return i % 2;
     }
   } else {
-    return q->seq_type2_fo.c[i * 10];
+    return srsran_sequence_get_bit(&q->seq_type2_fo, i * 10);
   }
 }
 /* Computes PUSCH frequency hopping as defined in Section 8.4 of 36.213 */
@@ -31,6 +31,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include <strings.h>
+#include <time.h>
 
 #define SRSRAN_PDSCH_MAX_TDEC_ITERS 10
 
@@ -180,10 +181,6 @@ int srsran_sch_init(srsran_sch_t* q)
       goto clean;
     }
     bzero(q->temp_g_bits, SRSRAN_MAX_PRB * 12 * 12 * 12);
-    q->ul_interleaver = srsran_vec_u32_malloc(SCH_MAX_G_BITS);
-    if (!q->ul_interleaver) {
-      goto clean;
-    }
     if (srsran_uci_cqi_init(&q->uci_cqi)) {
       goto clean;
     }
@@ -210,9 +207,6 @@ void srsran_sch_free(srsran_sch_t* q)
   if (q->temp_g_bits) {
     free(q->temp_g_bits);
   }
-  if (q->ul_interleaver) {
-    free(q->ul_interleaver);
-  }
   srsran_tdec_free(&q->decoder);
   srsran_tcod_free(&q->encoder);
   srsran_uci_cqi_free(&q->uci_cqi);
@@ -233,6 +227,26 @@ float srsran_sch_last_noi(srsran_sch_t* q)
   return q->avg_iterations;
 }
 
+void srsran_sch_set_deadline(srsran_sch_t* q, const struct timespec* deadline)
+{
+  q->deadline_en = (deadline != NULL);
+  if (deadline) {
+    q->deadline = *deadline;
+  }
+}
+
+static inline int64_t sch_time_ns(const struct timespec* t)
+{
+  return (int64_t)t->tv_sec * 1000000000 + t->tv_nsec;
+}
+
+static inline int64_t sch_now_ns(void)
+{
+  struct timespec t;
+  clock_gettime(CLOCK_MONOTONIC, &t);
+  return sch_time_ns(&t);
+}
+
 /* Encode a transport block according to 36.212 5.3.2
  *
  */
@@ -384,7 +398,14 @@ bool decode_tb_cb(srsran_sch_t*           q,
     return false;
   }
 
-  q->avg_iterations = 0;
+  q->avg_iterations  = 0;
+  q->shed_iterations = 0;
+
+  // Code blocks left to decode, they share whatever time remains until the deadline
+  uint32_t nof_cb_pending = 0;
+  for (int cb_idx = 0; cb_idx < cb_segm->C; cb_idx++) {
+    nof_cb_pending += softbuffer->cb_crc[cb_idx] ? 0 : 1;
+  }
 
   for (int cb_idx = 0; cb_idx < cb_segm->C; cb_idx++) {
     /* Do not process blocks with CRC Ok */
@@ -419,8 +440,18 @@ bool decode_tb_cb(srsran_sch_t*           q,
 
       srsran_tdec_new_cb(&q->decoder, cb_len);
 
+      // Even share of the time left, so a block that stops early leaves more time to the next ones
+      int64_t t_ns           = 0;
+      int64_t cb_deadline_ns = 0;
+      if (q->deadline_en) {
+        t_ns           = sch_now_ns();
+        cb_deadline_ns = t_ns + (sch_time_ns(&q->deadline) - t_ns) / (int64_t)nof_cb_pending;
+      }
+      nof_cb_pending--;
+
       // Run iterations and use CRC for early stopping
       bool     early_stop = false;
+      bool     late       = false;
       uint32_t cb_noi     = 0;
       do {
         if (q->llr_is_8bit) {
@@ -451,9 +482,20 @@ bool decode_tb_cb(srsran_sch_t*           q,
           // Early stop the whole transport block.
         }
 
-      } while (cb_noi < q->max_iterations && !early_stop);
+        // Do not start an iteration that, taking as long as the last one, would finish past the deadline
+        if (q->deadline_en && !early_stop) {
+          int64_t now_ns = sch_now_ns();
+          late           = (2 * now_ns - t_ns) > cb_deadline_ns;
+          t_ns           = now_ns;
+        }
+
+      } while (cb_noi < q->max_iterations && !early_stop && !late);
 
-      INFO("CB %d: rp=%d, n_e=%d, cb_len=%d, CRC=%s, rlen=%d, iterations=%d/%d",
+      if (late && cb_noi < q->max_iterations) {
+        q->shed_iterations += q->max_iterations - cb_noi;
+      }
+
+      INFO("CB %d: rp=%d, n_e=%d, cb_len=%d, CRC=%s, rlen=%d, iterations=%d/%d%s",
            cb_idx,
            rp,
            n_e2,
@@ -461,7 +503,8 @@ bool decode_tb_cb(srsran_sch_t*           q,
            early_stop ? "OK" : "KO",
            rlen,
            cb_noi,
-           q->max_iterations);
+           q->max_iterations,
+           late ? " (late)" : "");
 
     } else {
       // Copy decoded data from previous transmissions
@@ -654,28 +697,80 @@ int srsran_dlsch_encode2(srsran_sch_t*       q,
                    e_bits);
 }
 
-/* Compute the interleaving function on-the-fly, because it depends on number of RI bits
- * Profiling show that the computation of this matrix is neglegible.
+static inline uint8_t ulsch_qm2_symbol(const uint8_t* g_bits, uint32_t e)
+{
+  return (g_bits[e / 4] >> (6 - 2 * (e % 4))) & (uint8_t)0x03;
+}
+
+static inline uint8_t ulsch_qm4_symbol(const uint8_t* g_bits, uint32_t e)
+{
+  return (g_bits[e / 2] >> (4 - 4 * (e % 2))) & (uint8_t)0x0f;
+}
+
+static inline uint8_t ulsch_qm6_symbol(const uint8_t* g_bits, uint32_t e)
+{
+  uint32_t read_byte_idx = (e * 6) / 8;
+
+  switch ((e * 6) % 8) {
+    case 0:
+      return g_bits[read_byte_idx] >> 2;
+    case 2:
+      return g_bits[read_byte_idx] & (uint8_t)0x3f;
+    case 4:
+      return ((g_bits[read_byte_idx] << 2) | (g_bits[read_byte_idx + 1] >> 6)) & (uint8_t)0x3f;
+    default:
+      return ((g_bits[read_byte_idx] << 4) | (g_bits[read_byte_idx + 1] >> 4)) & (uint8_t)0x3f;
+  }
+}
+
+/* Number of interleaver rows whose Qm-bit symbols fill a whole number of bytes in a column of q_bits */
+static inline uint32_t ulsch_interleave_row_group(uint32_t Qm)
+{
+  return (Qm == 4) ? 2 : 4;
+}
+
+/* Interleaves the rows [0, nof_rows) of the matrix, which must not contain RI bits. The output is generated column by
+ * column, so every byte of q_bits is assembled in a register and written once instead of or-ing one symbol at a time.
+ * The first byte of every column must be byte aligned and nof_rows a multiple of ulsch_interleave_row_group().
  */
-static void ulsch_interleave_gen(uint32_t  H_prime_total,
-                                 uint32_t  N_pusch_symbs,
-                                 uint32_t  Qm,
-                                 uint8_t*  ri_present,
-                                 uint32_t* interleaver_lut)
+static void ulsch_interleave_fast_rows(const uint8_t* g_bits,
+                                       uint32_t       Qm,
+                                       uint32_t       rows,
+                                       uint32_t       cols,
+                                       uint32_t       nof_rows,
+                                       uint8_t*       q_bits)
 {
-  uint32_t rows = H_prime_total / N_pusch_symbs;
-  uint32_t cols = N_pusch_symbs;
-  uint32_t idx  = 0;
-  for (uint32_t j = 0; j < rows; j++) {
-    for (uint32_t i = 0; i < cols; i++) {
-      for (uint32_t k = 0; k < Qm; k++) {
-        if (ri_present && ri_present[j * Qm + i * rows * Qm + k]) {
-          interleaver_lut[j * Qm + i * rows * Qm + k] = 0;
-        } else {
-          interleaver_lut[j * Qm + i * rows * Qm + k] = idx;
-          idx++;
+  for (uint32_t i = 0; i < cols; i++) {
+    uint8_t* q_ptr = &q_bits[(i * rows * Qm) / 8];
+
+    switch (Qm) {
+      case 2:
+        for (uint32_t j = 0; j < nof_rows; j += 4) {
+          uint32_t e = j * cols + i;
+          *(q_ptr++) = (ulsch_qm2_symbol(g_bits, e) << 6) | (ulsch_qm2_symbol(g_bits, e + cols) << 4) |
+                       (ulsch_qm2_symbol(g_bits, e + 2 * cols) << 2) | ulsch_qm2_symbol(g_bits, e + 3 * cols);
         }
-      }
+        break;
+      case 4:
+        for (uint32_t j = 0; j < nof_rows; j += 2) {
+          uint32_t e = j * cols + i;
+          *(q_ptr++) = (ulsch_qm4_symbol(g_bits, e) << 4) | ulsch_qm4_symbol(g_bits, e + cols);
+        }
+        break;
+      case 6:
+        for (uint32_t j = 0; j < nof_rows; j += 4) {
+          uint32_t e = j * cols + i;
+          uint32_t w = ((uint32_t)ulsch_qm6_symbol(g_bits, e) << 18) |
+                       ((uint32_t)ulsch_qm6_symbol(g_bits, e + cols) << 12) |
+                       ((uint32_t)ulsch_qm6_symbol(g_bits, e + 2 * cols) << 6) |
+                       (uint32_t)ulsch_qm6_symbol(g_bits, e + 3 * cols);
+          *(q_ptr++) = (uint8_t)(w >> 16);
+          *(q_ptr++) = (uint8_t)(w >> 8);
+          *(q_ptr++) = (uint8_t)w;
+        }
+        break;
+      default:
+        /* Do nothing */;
     }
   }
 }
@@ -684,12 +779,13 @@ static void ulsch_interleave_qm2(const uint8_t* g_bits,
                                  uint32_t       rows,
                                  uint32_t       cols,
                                  uint8_t*       q_bits,
+                                 uint32_t       first_row,
                                  uint32_t       ri_min_row,
                                  const uint8_t* ri_present)
 {
-  uint32_t bit_read_idx = 0;
+  uint32_t bit_read_idx = first_row * cols * 2;
 
-  for (uint32_t j = 0; j < ri_min_row; j++) {
+  for (uint32_t j = first_row; j < ri_min_row; j++) {
     for (uint32_t i = 0; i < cols; i++) {
       uint32_t k = (i * rows + j) * 2;
 
@@ -724,62 +820,18 @@ static void ulsch_interleave_qm2(const uint8_t* g_bits,
   }
 }
 
-static void ulsch_interleave_qm4(uint8_t*       g_bits,
+static void ulsch_interleave_qm4(const uint8_t* g_bits,
                                  uint32_t       rows,
                                  uint32_t       cols,
                                  uint8_t*       q_bits,
+                                 uint32_t       first_row,
                                  uint32_t       ri_min_row,
                                  const uint8_t* ri_present)
 {
-  uint32_t bit_read_idx = 0;
-
-  for (uint32_t j = 0; j < ri_min_row; j++) {
-    int32_t i = 0;
-
-#ifdef DOES_NOT_WORK
-#ifndef HAVE_NEON
-    __m128i  _counter = _mm_slli_epi32(_mm_add_epi32(_mm_mullo_epi32(_counter0, _rows), _mm_set1_epi32(j)), 2);
-    uint8_t* _g_bits  = &g_bits[bit_read_idx / 8];
-
-    /* First bits are aligned to byte */
-    if (0 == (bit_read_idx & 0x3)) {
-      for (; i < (cols - 3); i += 4) {
-        uint8_t w1 = *(_g_bits++);
-        uint8_t w2 = *(_g_bits++);
-
-        __m128i _write_byte_idx = _mm_srli_epi32(_counter, 3);
-        __m128i _write_bit_idx  = _mm_and_si128(_counter, _7);
-        __m128i _write_shift    = _mm_sub_epi32(_4, _write_bit_idx);
-
-        q_bits[_mm_extract_epi32(_write_byte_idx, 0)] |= (w1 >> 0x4) << _mm_extract_epi32(_write_shift, 0);
-        q_bits[_mm_extract_epi32(_write_byte_idx, 1)] |= (w1 & 0xf) << _mm_extract_epi32(_write_shift, 1);
-        q_bits[_mm_extract_epi32(_write_byte_idx, 2)] |= (w2 >> 0x4) << _mm_extract_epi32(_write_shift, 2);
-        q_bits[_mm_extract_epi32(_write_byte_idx, 3)] |= (w2 & 0xf) << _mm_extract_epi32(_write_shift, 3);
-        _counter = _mm_add_epi32(_counter, _inc);
-      }
-    } else {
-      for (; i < (cols - 3); i += 4) {
-        __m128i _write_byte_idx = _mm_srli_epi32(_counter, 3);
-        __m128i _write_bit_idx  = _mm_and_si128(_counter, _7);
-        __m128i _write_shift    = _mm_sub_epi32(_4, _write_bit_idx);
-
-        uint8_t w1 = *(_g_bits);
-        uint8_t w2 = *(_g_bits++);
-        uint8_t w3 = *(_g_bits++);
-        q_bits[_mm_extract_epi32(_write_byte_idx, 0)] |= (w1 & 0xf) << _mm_extract_epi32(_write_shift, 0);
-        q_bits[_mm_extract_epi32(_write_byte_idx, 1)] |= (w2 >> 0x4) << _mm_extract_epi32(_write_shift, 1);
-        q_bits[_mm_extract_epi32(_write_byte_idx, 2)] |= (w2 & 0xf) << _mm_extract_epi32(_write_shift, 2);
-        q_bits[_mm_extract_epi32(_write_byte_idx, 3)] |= (w3 >> 0x4) << _mm_extract_epi32(_write_shift, 3);
-
-        _counter = _mm_add_epi32(_counter, _inc);
-      }
-    }
-    bit_read_idx += i * 4;
-#endif /* HAVE_NEON */
-#endif /* LV_HAVE_SSE */
+  uint32_t bit_read_idx = first_row * cols * 4;
 
-    /* Spare bits */
-    for (; i < cols; i++) {
+  for (uint32_t j = first_row; j < ri_min_row; j++) {
+    for (uint32_t i = 0; i < cols; i++) {
       uint32_t k = (i * rows + j) * 4;
 
       uint32_t read_byte_idx  = bit_read_idx / 8;
@@ -818,90 +870,22 @@ static void ulsch_interleave_qm6(const uint8_t* g_bits,
                                  uint32_t       rows,
                                  uint32_t       cols,
                                  uint8_t*       q_bits,
+                                 uint32_t       first_row,
                                  uint32_t       ri_min_row,
                                  const uint8_t* ri_present)
 {
-  uint32_t bit_read_idx = 0;
+  uint32_t bit_read_idx = first_row * cols * 6;
 
-  for (uint32_t j = 0; j < ri_min_row; j++) {
+  for (uint32_t j = first_row; j < rows; j++) {
     for (uint32_t i = 0; i < cols; i++) {
       uint32_t k = (i * rows + j) * 6;
 
-      uint32_t read_byte_idx  = bit_read_idx / 8;
-      uint32_t read_bit_idx   = bit_read_idx % 8;
-      uint32_t write_byte_idx = k / 8;
-      uint32_t write_bit_idx  = k % 8;
-      uint8_t  w;
-
-      switch (read_bit_idx) {
-        case 0:
-          w = g_bits[read_byte_idx] >> 2;
-          break;
-        case 2:
-          w = g_bits[read_byte_idx] & (uint8_t)0x3f;
-          break;
-        case 4:
-          w = ((g_bits[read_byte_idx] << 2) | (g_bits[read_byte_idx + 1] >> 6)) & (uint8_t)0x3f;
-          break;
-        case 6:
-          w = ((g_bits[read_byte_idx] << 4) | (g_bits[read_byte_idx + 1] >> 4)) & (uint8_t)0x3f;
-          break;
-        default:
-          w = 0;
-      }
-
-      switch (write_bit_idx) {
-        case 0:
-          q_bits[write_byte_idx] |= w << 2;
-          break;
-        case 2:
-          q_bits[write_byte_idx] |= w;
-          break;
-        case 4:
-          q_bits[write_byte_idx] |= w >> 2;
-          q_bits[write_byte_idx + 1] |= w << 6;
-          break;
-        case 6:
-          q_bits[write_byte_idx] |= w >> 4;
-          q_bits[write_byte_idx + 1] |= w << 4;
-          break;
-        default:
-          /* Do nothing */;
-      }
-
-      bit_read_idx += 6;
-    }
-  }
-
-  for (uint32_t j = ri_min_row; j < rows; j++) {
-    for (uint32_t i = 0; i < cols; i++) {
-      uint32_t k = (i * rows + j) * 6;
-
-      if (ri_present[k]) {
+      if (j >= ri_min_row && ri_present[k]) {
         /* do nothing */
       } else {
-        uint32_t read_byte_idx  = bit_read_idx / 8;
-        uint32_t read_bit_idx   = bit_read_idx % 8;
         uint32_t write_byte_idx = k / 8;
         uint32_t write_bit_idx  = k % 8;
-        uint8_t  w;
-
-        switch (read_bit_idx) {
-          case 0:
-            w = g_bits[read_byte_idx] >> 2;
-            break;
-          case 2:
-            w = g_bits[read_byte_idx] & (uint8_t)0x3f;
-            break;
-          case 4:
-            w = ((g_bits[read_byte_idx] << 2) | (g_bits[read_byte_idx + 1] >> 6)) & (uint8_t)0x3f;
-            break;
-          case 6:
-            w = ((g_bits[read_byte_idx] << 4) | (g_bits[read_byte_idx + 1] >> 4)) & (uint8_t)0x3f;
-            break;
-          default:
-            w = 0;
-        }
+        uint8_t  w              = ulsch_qm6_symbol(g_bits, bit_read_idx / 6);
 
         switch (write_bit_idx) {
           case 0:
@@ -965,16 +949,26 @@ static void ulsch_interleave(uint8_t*          g_bits,
     }
   }
 
-  bzero(q_bits, nof_bits / 8);
+  // Rows above RI are written a byte at a time, provided every column starts at a byte boundary
+  uint32_t row_group = ulsch_interleave_row_group(Qm);
+  uint32_t fast_rows = 0;
+  if (rows % row_group == 0) {
+    fast_rows = ri_min_row - ri_min_row % row_group;
+  }
+
+  bzero(q_bits, SRSRAN_CEIL(nof_bits, 8));
   switch (Qm) {
     case 2:
-      ulsch_interleave_qm2(g_bits, rows, cols, q_bits, ri_min_row, ri_present);
+      ulsch_interleave_fast_rows(g_bits, Qm, rows, cols, fast_rows, q_bits);
+      ulsch_interleave_qm2(g_bits, rows, cols, q_bits, fast_rows, ri_min_row, ri_present);
       break;
     case 4:
-      ulsch_interleave_qm4(g_bits, rows, cols, q_bits, ri_min_row, ri_present);
+      ulsch_interleave_fast_rows(g_bits, Qm, rows, cols, fast_rows, q_bits);
+      ulsch_interleave_qm4(g_bits, rows, cols, q_bits, fast_rows, ri_min_row, ri_present);
       break;
     case 6:
-      ulsch_interleave_qm6(g_bits, rows, cols, q_bits, ri_min_row, ri_present);
+      ulsch_interleave_fast_rows(g_bits, Qm, rows, cols, fast_rows, q_bits);
+      ulsch_interleave_qm6(g_bits, rows, cols, q_bits, fast_rows, ri_min_row, ri_present);
       break;
     default:
       /* This line should never be reached */
@@ -989,27 +983,132 @@ static void ulsch_interleave(uint8_t*          g_bits,
   }
 }
 
+/* Deinterleaves the rows [0, nof_rows) of the matrix, which must not contain RI bits. Without RI the deinterleaver
+ * is a transpose of the column-major q_bits into the row-major g_bits, where each element holds the Qm soft bits of
+ * a modulation symbol.
+ */
+static void ulsch_deinterleave_transpose(const int16_t* q_bits,
+                                         uint32_t       Qm,
+                                         uint32_t       rows,
+                                         uint32_t       cols,
+                                         uint32_t       nof_rows,
+                                         int16_t*       g_bits)
+{
+  uint32_t j = 0;
+
+#ifdef LV_HAVE_SSE
+  if (Qm == 2) {
+    // 32-bit elements, transpose blocks of 4x4
+    for (; j + 3 < nof_rows; j += 4) {
+      uint32_t i = 0;
+      for (; i + 3 < cols; i += 4) {
+        __m128i c0 = _mm_loadu_si128((const __m128i*)&q_bits[((i + 0) * rows + j) * 2]);
+        __m128i c1 = _mm_loadu_si128((const __m128i*)&q_bits[((i + 1) * rows + j) * 2]);
+        __m128i c2 = _mm_loadu_si128((const __m128i*)&q_bits[((i + 2) * rows + j) * 2]);
+        __m128i c3 = _mm_loadu_si128((const __m128i*)&q_bits[((i + 3) * rows + j) * 2]);
+
+        __m128i t0 = _mm_unpacklo_epi32(c0, c1);
+        __m128i t1 = _mm_unpacklo_epi32(c2, c3);
+        __m128i t2 = _mm_unpackhi_epi32(c0, c1);
+        __m128i t3 = _mm_unpackhi_epi32(c2, c3);
+
+        _mm_storeu_si128((__m128i*)&g_bits[((j + 0) * cols + i) * 2], _mm_unpacklo_epi64(t0, t1));
+        _mm_storeu_si128((__m128i*)&g_bits[((j + 1) * cols + i) * 2], _mm_unpackhi_epi64(t0, t1));
+        _mm_storeu_si128((__m128i*)&g_bits[((j + 2) * cols + i) * 2], _mm_unpacklo_epi64(t2, t3));
+        _mm_storeu_si128((__m128i*)&g_bits[((j + 3) * cols + i) * 2], _mm_unpackhi_epi64(t2, t3));
+      }
+      for (; i < cols; i++) {
+        for (uint32_t r = 0; r < 4; r++) {
+          memcpy(&g_bits[((j + r) * cols + i) * 2], &q_bits[(i * rows + j + r) * 2], sizeof(int16_t) * 2);
+        }
+      }
+    }
+  } else if (Qm == 4) {
+    // 64-bit elements, transpose blocks of 2x2
+    for (; j + 1 < nof_rows; j += 2) {
+      uint32_t i = 0;
+      for (; i + 1 < cols; i += 2) {
+        __m128i c0 = _mm_loadu_si128((const __m128i*)&q_bits[((i + 0) * rows + j) * 4]);
+        __m128i c1 = _mm_loadu_si128((const __m128i*)&q_bits[((i + 1) * rows + j) * 4]);
+
+        _mm_storeu_si128((__m128i*)&g_bits[((j + 0) * cols + i) * 4], _mm_unpacklo_epi64(c0, c1));
+        _mm_storeu_si128((__m128i*)&g_bits[((j + 1) * cols + i) * 4], _mm_unpackhi_epi64(c0, c1));
+      }
+      for (; i < cols; i++) {
+        memcpy(&g_bits[((j + 0) * cols + i) * 4], &q_bits[(i * rows + j + 0) * 4], sizeof(int16_t) * 4);
+        memcpy(&g_bits[((j + 1) * cols + i) * 4], &q_bits[(i * rows + j + 1) * 4], sizeof(int16_t) * 4);
+      }
+    }
+  }
+#endif /* LV_HAVE_SSE */
+
+  // Constant size copies let the compiler inline the 64-QAM elements
+  if (Qm == 6) {
+    for (; j < nof_rows; j++) {
+      for (uint32_t i = 0; i < cols; i++) {
+        memcpy(&g_bits[(j * cols + i) * 6], &q_bits[(i * rows + j) * 6], sizeof(int16_t) * 6);
+      }
+    }
+  }
+
+  for (; j < nof_rows; j++) {
+    for (uint32_t i = 0; i < cols; i++) {
+      memcpy(&g_bits[(j * cols + i) * Qm], &q_bits[(i * rows + j) * Qm], sizeof(int16_t) * Qm);
+    }
+  }
+}
+
 /* UL-SCH channel deinterleaver according to 5.2.2.8 of 36.212 */
-void ulsch_deinterleave(int16_t*          q_bits,
-                        uint32_t          Qm,
-                        uint32_t          H_prime_total,
-                        uint32_t          N_pusch_symbs,
-                        int16_t*          g_bits,
-                        srsran_uci_bit_t* ri_bits,
-                        uint32_t          nof_ri_bits,
-                        uint8_t*          ri_present,
-                        uint32_t*         inteleaver_lut)
+static void ulsch_deinterleave(const int16_t*    q_bits,
+                               uint32_t          Qm,
+                               uint32_t          H_prime_total,
+                               uint32_t          N_pusch_symbs,
+                               int16_t*          g_bits,
+                               srsran_uci_bit_t* ri_bits,
+                               uint32_t          nof_ri_bits,
+                               uint8_t*          ri_present)
 {
+  if (N_pusch_symbs == 0 || Qm == 0 || H_prime_total == 0 || H_prime_total < N_pusch_symbs) {
+    ERROR("Invalid input: N_pusch_symbs=%d, Qm=%d, H_prime_total=%d, N_pusch_symbs=%d",
+          N_pusch_symbs,
+          Qm,
+          H_prime_total,
+          N_pusch_symbs);
+    return;
+  }
+
+  uint32_t rows       = H_prime_total / N_pusch_symbs;
+  uint32_t cols       = N_pusch_symbs;
+  uint32_t ri_min_row = rows;
+
   // Prepare ri_bits for fast search using temp_buffer
   if (nof_ri_bits > 0) {
     for (uint32_t i = 0; i < nof_ri_bits; i++) {
+      uint32_t ri_row = (ri_bits[i].position / Qm) % rows;
+
+      if (ri_row < ri_min_row) {
+        ri_min_row = ri_row;
+      }
+
       ri_present[ri_bits[i].position] = 1;
     }
   }
 
-  // Generate interleaver table and interleave samples
-  ulsch_interleave_gen(H_prime_total, N_pusch_symbs, Qm, ri_present, inteleaver_lut);
-  srsran_vec_lut_sis(q_bits, inteleaver_lut, g_bits, H_prime_total * Qm);
+  // Rows above RI are a plain transpose
+  ulsch_deinterleave_transpose(q_bits, Qm, rows, cols, ri_min_row, g_bits);
+
+  // Rows containing RI, skip the RI bits
+  uint32_t idx = ri_min_row * cols * Qm;
+  for (uint32_t j = ri_min_row; j < rows; j++) {
+    for (uint32_t i = 0; i < cols; i++) {
+      for (uint32_t k = 0; k < Qm; k++) {
+        uint32_t pos = (i * rows + j) * Qm + k;
+        if (!ri_present[pos]) {
+          g_bits[idx++] = q_bits[pos];
+        }
+      }
+    }
+  }
 
   // Reset temp_buffer because will be reused next time
   if (nof_ri_bits > 0) {
@@ -1156,8 +1255,7 @@ int srsran_ulsch_decode(srsran_sch_t*       q,
                      g_bits,
                      q->ack_ri_bits,
                      Q_prime_ri * Qm,
-                     q->temp_g_bits,
-                     q->ul_interleaver);
+                     q->temp_g_bits);
 
   // Decode CQI (multiplexed at the front of ULSCH)
   uint32_t Q_prime_cqi = 0;
@@ -1336,6 +1434,30 @@ int srsran_ulsch_encode(srsran_sch_t*       q,
   return nof_ri_ack_bits;
 }
 
+void srsran_ulsch_interleave(uint8_t*          g_bits,
+                             uint32_t          Qm,
+                             uint32_t          H_prime_total,
+                             uint32_t          N_pusch_symbs,
+                             uint8_t*          q_bits,
+                             srsran_uci_bit_t* ri_bits,
+                             uint32_t          nof_ri_bits,
+                             uint8_t*          ri_present)
+{
+  ulsch_interleave(g_bits, Qm, H_prime_total, N_pusch_symbs, q_bits, ri_bits, nof_ri_bits, ri_present);
+}
+
+void srsran_ulsch_deinterleave(int16_t*          q_bits,
+                               uint32_t          Qm,
+                               uint32_t          H_prime_total,
+                               uint32_t          N_pusch_symbs,
+                               int16_t*          g_bits,
+                               srsran_uci_bit_t* ri_bits,
+                               uint32_t          nof_ri_bits,
+                               uint8_t*          ri_present)
+{
+  ulsch_deinterleave(q_bits, Qm, H_prime_total, N_pusch_symbs, g_bits, ri_bits, nof_ri_bits, ri_present);
+}
+
 void srsran_sl_ulsch_interleave(uint8_t* g_bits,
                                 uint32_t Qm,
                                 uint32_t H_prime_total,
@@ -1345,12 +1467,11 @@ void srsran_sl_ulsch_interleave(uint8_t* g_bits,
   ulsch_interleave(g_bits, Qm, H_prime_total, N_pusch_symbs, q_bits, NULL, 0, false);
 }
 
-void srsran_sl_ulsch_deinterleave(int16_t*  q_bits,
-                                  uint32_t  Qm,
-                                  uint32_t  H_prime_total,
-                                  uint32_t  N_pusch_symbs,
-                                  int16_t*  g_bits,
-                                  uint32_t* inteleaver_lut)
+void srsran_sl_ulsch_deinterleave(int16_t* q_bits,
+                                  uint32_t Qm,
+                                  uint32_t H_prime_total,
+                                  uint32_t N_pusch_symbs,
+                                  int16_t* g_bits)
 {
-  ulsch_deinterleave(q_bits, Qm, H_prime_total, N_pusch_symbs, g_bits, NULL, 0, NULL, inteleaver_lut);
+  ulsch_deinterleave(q_bits, Qm, H_prime_total, N_pusch_symbs, g_bits, NULL, 0, NULL);
 }
@@ -27,11 +27,57 @@
 #include "srsran/phy/phch/ra_nr.h"
 #include "srsran/phy/utils/bit.h"
 #include "srsran/phy/utils/debug.h"
+#include "srsran/phy/utils/simd_isa.h"
 #include "srsran/phy/utils/vector.h"
+#include <pthread.h>
+#include <semaphore.h>
 
 #define SCH_INFO_TX(...) INFO("SCH Tx: " __VA_ARGS__)
 #define SCH_INFO_RX(...) INFO("SCH Rx: " __VA_ARGS__)
 
+/**
+ * @brief Rate dematched code block waiting to be decoded
+ */
+typedef struct {
+  uint32_t r;         ///< Code block index
+  int8_t*  rm_buffer; ///< Rate dematched LLRs
+  int      n_llr;     ///< Number of rate dematched LLRs
+  uint32_t n_iter;    ///< Number of LDPC iterations, set once the code block is decoded
+} sch_nr_cb_job_t;
+
+struct sch_nr_coworker_pool_s;
+
+typedef struct {
+  struct sch_nr_coworker_pool_s* pool;
+  pthread_t                      pthread;
+
+  /* Private decoder registers, CRC and temporal buffer, not thread safe. Parity check matrices are shared */
+  srsran_sch_nr_t sch;
+
+  /* Semaphores */
+  sem_t start;
+  sem_t finish;
+
+  /* Thread flags */
+  bool quit;
+} sch_nr_coworker_t;
+
+typedef struct sch_nr_coworker_pool_s {
+  /* Current transport block: it must be set before posting start semaphores */
+  const srsran_sch_nr_tb_info_t* cfg;
+  const srsran_sch_tb_t*         tb;
+  sch_nr_cb_job_t                jobs[SRSRAN_SCH_NR_MAX_NOF_CB_LDPC];
+  uint32_t                       nof_jobs;
+
+  /* Next job to decode and execution status, protected by mutex */
+  pthread_mutex_t mutex;
+  uint32_t        next_job;
+  int             ret_status;
+
+  sch_nr_coworker_t* workers;
+  uint32_t           nof_workers;
+} sch_nr_coworker_pool_t;
+
 srsran_basegraph_t srsran_sch_nr_select_basegraph(uint32_t tbs, double R)
 {
   // if A ≤ 292 , or if A ≤ 3824 and R ≤ 0.67 , or if R ≤ 0 . 25 , LDPC base graph 2 is used;
@@ -193,17 +239,13 @@ int srsran_sch_nr_init_tx(srsran_sch_nr_t* q, const srsran_sch_nr_args_t* args)
 
   srsran_ldpc_encoder_type_t encoder_type = SRSRAN_LDPC_ENCODER_C;
 
-#ifdef LV_HAVE_AVX512
-  if (!args->disable_simd) {
-    encoder_type = SRSRAN_LDPC_ENCODER_AVX512;
-  }
-#else // LV_HAVE_AVX512
-#ifdef LV_HAVE_AVX2
   if (!args->disable_simd) {
-    encoder_type = SRSRAN_LDPC_ENCODER_AVX2;
+    if (srsran_simd_isa_available(SRSRAN_SIMD_ISA_AVX512)) {
+      encoder_type = SRSRAN_LDPC_ENCODER_AVX512;
+    } else if (srsran_simd_isa_available(SRSRAN_SIMD_ISA_AVX2)) {
+      encoder_type = SRSRAN_LDPC_ENCODER_AVX2;
+    }
   }
-#endif // LV_HAVE_AVX2
-#endif // LV_HAVE_AVX612
 
   // Iterate over all possible lifting sizes
   for (uint16_t ls = 0; ls <= MAX_LIFTSIZE; ls++) {
@@ -248,27 +290,25 @@ int srsran_sch_nr_init_tx(srsran_sch_nr_t* q, const srsran_sch_nr_args_t* args)
   return SRSRAN_SUCCESS;
 }
 
-int srsran_sch_nr_init_rx(srsran_sch_nr_t* q, const srsran_sch_nr_args_t* args)
+/**
+ * @brief Initialises the LDPC decoders for all lifting sizes
+ * @param q SCH object
+ * @param args Decoder arguments
+ * @param shared Optional SCH object whose decoders provide the parity check matrices, NULL to create them
+ * @return SRSRAN_SUCCESS if the decoders are initialised, SRSRAN_ERROR code otherwise
+ */
+static int sch_nr_init_decoders(srsran_sch_nr_t* q, const srsran_sch_nr_args_t* args, const srsran_sch_nr_t* shared)
 {
-  int ret = sch_nr_init_common(q);
-  if (ret < SRSRAN_SUCCESS) {
-    return ret;
-  }
-
   srsran_ldpc_decoder_type_t decoder_type =
       args->decoder_use_flooded ? SRSRAN_LDPC_DECODER_C_FLOOD : SRSRAN_LDPC_DECODER_C;
 
-#ifdef LV_HAVE_AVX512
-  if (!args->disable_simd) {
-    decoder_type = args->decoder_use_flooded ? SRSRAN_LDPC_DECODER_C_AVX512_FLOOD : SRSRAN_LDPC_DECODER_C_AVX512;
-  }
-#else // LV_HAVE_AVX512
-#ifdef LV_HAVE_AVX2
   if (!args->disable_simd) {
-    decoder_type = args->decoder_use_flooded ? SRSRAN_LDPC_DECODER_C_AVX2_FLOOD : SRSRAN_LDPC_DECODER_C_AVX2;
+    if (srsran_simd_isa_available(SRSRAN_SIMD_ISA_AVX512)) {
+      decoder_type = args->decoder_use_flooded ? SRSRAN_LDPC_DECODER_C_AVX512_FLOOD : SRSRAN_LDPC_DECODER_C_AVX512;
+    } else if (srsran_simd_isa_available(SRSRAN_SIMD_ISA_AVX2)) {
+      decoder_type = args->decoder_use_flooded ? SRSRAN_LDPC_DECODER_C_AVX2_FLOOD : SRSRAN_LDPC_DECODER_C_AVX2;
+    }
   }
-#endif // LV_HAVE_AVX2
-#endif // LV_HAVE_AVX512
 
   // If the scaling factor is not provided use a default value that allows decoding all possible combinations of nPRB
   // and MCS indexes for all possible MCS tables
@@ -299,7 +339,8 @@ int srsran_sch_nr_init_rx(srsran_sch_nr_t* q, const srsran_sch_nr_args_t* args)
     }
     SRSRAN_MEM_ZERO(q->decoder_bg1[ls], srsran_ldpc_decoder_t, 1);
 
-    decoder_args.bg = BG1;
+    decoder_args.bg        = BG1;
+    decoder_args.pcm_owner = (shared != NULL) ? shared->decoder_bg1[ls] : NULL;
     if (srsran_ldpc_decoder_init(q->decoder_bg1[ls], &decoder_args) < SRSRAN_SUCCESS) {
       ERROR("Error: initialising BG1 LDPC decoder for ls=%d", ls);
       return SRSRAN_ERROR;
@@ -312,18 +353,118 @@ int srsran_sch_nr_init_rx(srsran_sch_nr_t* q, const srsran_sch_nr_args_t* args)
     }
     SRSRAN_MEM_ZERO(q->decoder_bg2[ls], srsran_ldpc_decoder_t, 1);
 
-    decoder_args.bg = BG2;
+    decoder_args.bg        = BG2;
+    decoder_args.pcm_owner = (shared != NULL) ? shared->decoder_bg2[ls] : NULL;
     if (srsran_ldpc_decoder_init(q->decoder_bg2[ls], &decoder_args) < SRSRAN_SUCCESS) {
       ERROR("Error: initialising BG2 LDPC decoder for ls=%d", ls);
       return SRSRAN_ERROR;
     }
   }
 
+  return SRSRAN_SUCCESS;
+}
+
+static void* sch_nr_coworker_thread(void* arg);
+
+static void sch_nr_disable_coworkers(srsran_sch_nr_t* q)
+{
+  sch_nr_coworker_pool_t* pool = (sch_nr_coworker_pool_t*)q->coworker_ptr;
+  if (pool == NULL) {
+    return;
+  }
+
+  for (uint32_t i = 0; i < pool->nof_workers; i++) {
+    sch_nr_coworker_t* w = &pool->workers[i];
+
+    /* Stop thread */
+    w->quit = true;
+    sem_post(&w->start);
+    pthread_join(w->pthread, NULL);
+
+    sem_destroy(&w->start);
+    sem_destroy(&w->finish);
+    srsran_sch_nr_free(&w->sch);
+  }
+
+  pthread_mutex_destroy(&pool->mutex);
+  free(pool->workers);
+  free(pool);
+
+  q->coworker_ptr = NULL;
+}
+
+static int sch_nr_enable_coworkers(srsran_sch_nr_t* q, const srsran_sch_nr_args_t* args)
+{
+  sch_nr_coworker_pool_t* pool = SRSRAN_MEM_ALLOC(sch_nr_coworker_pool_t, 1);
+  if (pool == NULL) {
+    ERROR("Error: malloc");
+    return SRSRAN_ERROR;
+  }
+  SRSRAN_MEM_ZERO(pool, sch_nr_coworker_pool_t, 1);
+  q->coworker_ptr = pool;
+
+  pool->workers = SRSRAN_MEM_ALLOC(sch_nr_coworker_t, args->nof_coworkers);
+  if (pool->workers == NULL) {
+    ERROR("Error: malloc");
+    sch_nr_disable_coworkers(q);
+    return SRSRAN_ERROR;
+  }
+  SRSRAN_MEM_ZERO(pool->workers, sch_nr_coworker_t, args->nof_coworkers);
+  pthread_mutex_init(&pool->mutex, NULL);
+
+  for (uint32_t i = 0; i < args->nof_coworkers; i++) {
+    sch_nr_coworker_t* w = &pool->workers[i];
+    w->pool              = pool;
+
+    // Coworkers only decode code blocks, their decoders reuse the parity check matrices of the calling thread
+    if (sch_nr_init_common(&w->sch) < SRSRAN_SUCCESS || sch_nr_init_decoders(&w->sch, args, q) < SRSRAN_SUCCESS) {
+      srsran_sch_nr_free(&w->sch);
+      sch_nr_disable_coworkers(q);
+      return SRSRAN_ERROR;
+    }
+
+    if (sem_init(&w->start, 0, 0) || sem_init(&w->finish, 0, 0)) {
+      ERROR("Error: creating semaphore");
+      srsran_sch_nr_free(&w->sch);
+      sch_nr_disable_coworkers(q);
+      return SRSRAN_ERROR;
+    }
+
+    if (pthread_create(&w->pthread, NULL, sch_nr_coworker_thread, w)) {
+      ERROR("Error: creating coworker thread");
+      sem_destroy(&w->start);
+      sem_destroy(&w->finish);
+      srsran_sch_nr_free(&w->sch);
+      sch_nr_disable_coworkers(q);
+      return SRSRAN_ERROR;
+    }
+    pool->nof_workers++;
+  }
+
+  return SRSRAN_SUCCESS;
+}
+
+int srsran_sch_nr_init_rx(srsran_sch_nr_t* q, const srsran_sch_nr_args_t* args)
+{
+  int ret = sch_nr_init_common(q);
+  if (ret < SRSRAN_SUCCESS) {
+    return ret;
+  }
+
+  if (sch_nr_init_decoders(q, args, NULL) < SRSRAN_SUCCESS) {
+    return SRSRAN_ERROR;
+  }
+
   if (srsran_ldpc_rm_rx_init_c(&q->rx_rm) < SRSRAN_SUCCESS) {
     ERROR("Error: initialising Rx LDPC Rate matching");
     return SRSRAN_ERROR;
   }
 
+  if (args->nof_coworkers > 0 && sch_nr_enable_coworkers(q, args) < SRSRAN_SUCCESS) {
+    ERROR("Error: initialising code block decoding coworkers");
+    return SRSRAN_ERROR;
+  }
+
   return SRSRAN_SUCCESS;
 }
 
@@ -345,6 +486,8 @@ void srsran_sch_nr_free(srsran_sch_nr_t* q)
     return;
   }
 
+  sch_nr_disable_coworkers(q);
+
   if (q->temp_cb) {
     free(q->temp_cb);
   }
@@ -519,6 +662,109 @@ static inline int sch_nr_encode(srsran_sch_nr_t*        q,
   return SRSRAN_SUCCESS;
 }
 
+static int sch_nr_decode_cb(srsran_sch_nr_t*               q,
+                            const srsran_sch_nr_tb_info_t* cfg,
+                            const srsran_sch_tb_t*         tb,
+                            uint32_t                       r,
+                            int8_t*                        rm_buffer,
+                            int                            n_llr,
+                            uint32_t*                      n_iter)
+{
+  srsran_ldpc_decoder_t* decoder = (cfg->bg == BG1) ? q->decoder_bg1[cfg->Z] : q->decoder_bg2[cfg->Z];
+
+  // Select CB or TB early stop CRC
+  srsran_crc_t* crc = (cfg->L_tb == 16) ? &q->crc_tb_16 : &q->crc_tb_24;
+  if (cfg->L_cb) {
+    crc = &q->crc_cb;
+  }
+
+  // Decode. if CRC=KO, then ret=0
+  int ret = srsran_ldpc_decoder_decode_crc_c(decoder, rm_buffer, q->temp_cb, n_llr, crc);
+  if (ret < SRSRAN_SUCCESS) {
+    ERROR("Error decoding CB");
+    return SRSRAN_ERROR;
+  }
+
+  // Compute number of iterations
+  uint32_t n_iter_cb = (ret == 0) ? decoder->max_nof_iter : (uint32_t)ret;
+  *n_iter            = n_iter_cb;
+
+  // Check if CB is all zeros
+  uint32_t cb_len    = cfg->Kp - cfg->L_cb;
+  bool     all_zeros = true;
+  for (uint32_t i = 0; i < cb_len && all_zeros; i++) {
+    all_zeros = (q->temp_cb[i] == 0);
+  }
+
+  tb->softbuffer.rx->cb_crc[r] = (ret != 0) && (!all_zeros);
+  SCH_INFO_RX("CB %d/%d iter=%d CRC=%s all_zeros=%s",
+              r,
+              cfg->C,
+              n_iter_cb,
+              tb->softbuffer.rx->cb_crc[r] ? "OK" : "KO",
+              all_zeros ? "yes" : "no");
+
+  // CB Debug trace
+  if (SRSRAN_DEBUG_ENABLED && srsran_verbose >= SRSRAN_VERBOSE_DEBUG && !handler_registered) {
+    DEBUG("CB %d/%d:", r, cfg->C);
+    srsran_vec_fprint_hex(stdout, q->temp_cb, cb_len);
+  }
+
+  // Pack only if CRC is match
+  if (tb->softbuffer.rx->cb_crc[r]) {
+    srsran_bit_pack_vector(q->temp_cb, tb->softbuffer.rx->data[r], cb_len);
+  }
+
+  return SRSRAN_SUCCESS;
+}
+
+/**
+ * @brief Decodes pending code blocks from the pool until there are none left
+ * @param pool Provides the code block jobs of the current transport block
+ * @param q SCH object of the calling thread, it provides the decoders, CRC and temporal buffer
+ */
+static void sch_nr_coworker_run(sch_nr_coworker_pool_t* pool, srsran_sch_nr_t* q)
+{
+  while (true) {
+    pthread_mutex_lock(&pool->mutex);
+    uint32_t i = pool->next_job;
+    if (i < pool->nof_jobs) {
+      pool->next_job++;
+    }
+    pthread_mutex_unlock(&pool->mutex);
+
+    if (i >= pool->nof_jobs) {
+      return;
+    }
+
+    sch_nr_cb_job_t* job = &pool->jobs[i];
+    if (sch_nr_decode_cb(q, pool->cfg, pool->tb, job->r, job->rm_buffer, job->n_llr, &job->n_iter) <
+        SRSRAN_SUCCESS) {
+      pthread_mutex_lock(&pool->mutex);
+      pool->ret_status = SRSRAN_ERROR;
+      pthread_mutex_unlock(&pool->mutex);
+    }
+  }
+}
+
+static void* sch_nr_coworker_thread(void* arg)
+{
+  sch_nr_coworker_t* w = (sch_nr_coworker_t*)arg;
+
+  sem_wait(&w->start);
+  while (!w->quit) {
+    sch_nr_coworker_run(w->pool, &w->sch);
+
+    /* Post finish semaphore */
+    sem_post(&w->finish);
+
+    /* Wait for next transport block */
+    sem_wait(&w->start);
+  }
+
+  return NULL;
+}
+
 static int sch_nr_decode(srsran_sch_nr_t*        q,
                          const srsran_sch_cfg_t* sch_cfg,
                          const srsran_sch_tb_t*  tb,
@@ -559,8 +805,10 @@ static int sch_nr_decode(srsran_sch_nr_t*        q,
     return SRSRAN_ERROR;
   }
 
-  // Counter of code blocks that have matched CRC
-  uint32_t cb_ok = 0;
+  sch_nr_coworker_pool_t* pool = (sch_nr_coworker_pool_t*)q->coworker_ptr;
+  if (pool != NULL) {
+    pool->nof_jobs = 0;
+  }
 
   // For each code block...
   uint32_t j = 0;
@@ -574,9 +822,6 @@ static int sch_nr_decode(srsran_sch_nr_t*        q,
 
     // Skip CB if mask indicates no transmission of the CB
     if (!cfg.mask[r]) {
-      if (decoded) {
-        cb_ok++;
-      }
       SCH_INFO_RX("RM CB %d: Disabled, CRC %s ... Skipping", r, decoded ? "OK" : "KO");
       continue;
     }
@@ -588,7 +833,6 @@ static int sch_nr_decode(srsran_sch_nr_t*        q,
     // Skip CB if it has a matched CRC
     if (decoded) {
       SCH_INFO_RX("RM CB %d: CRC OK ... Skipping", r);
-      cb_ok++;
       continue;
     }
 
@@ -609,51 +853,57 @@ static int sch_nr_decode(srsran_sch_nr_t*        q,
       return SRSRAN_ERROR;
     }
 
-    // Select CB or TB early stop CRC
-    srsran_crc_t* crc = (cfg.L_tb == 16) ? &q->crc_tb_16 : &q->crc_tb_24;
-    if (cfg.L_cb) {
-      crc = &q->crc_cb;
+    if (pool != NULL) {
+      // Defer decoding until all code blocks are rate dematched
+      sch_nr_cb_job_t* job = &pool->jobs[pool->nof_jobs++];
+      job->r               = r;
+      job->rm_buffer       = rm_buffer;
+      job->n_llr           = n_llr;
+    } else {
+      uint32_t n_iter_cb = 0;
+      if (sch_nr_decode_cb(q, &cfg, tb, r, rm_buffer, n_llr, &n_iter_cb) < SRSRAN_SUCCESS) {
+        return SRSRAN_ERROR;
+      }
+      nof_iter_sum += n_iter_cb;
     }
 
-    // Decode. if CRC=KO, then ret=0
-    int ret = srsran_ldpc_decoder_decode_crc_c(decoder, rm_buffer, q->temp_cb, n_llr, crc);
-    if (ret < SRSRAN_SUCCESS) {
-      ERROR("Error decoding CB");
-      return SRSRAN_ERROR;
+    input_ptr += E;
+  }
+
+  // Decode the deferred code blocks along with the coworkers
+  if (pool != NULL && pool->nof_jobs > 0) {
+    pool->cfg        = &cfg;
+    pool->tb         = tb;
+    pool->next_job   = 0;
+    pool->ret_status = SRSRAN_SUCCESS;
+
+    // The calling thread takes one of the jobs, no more coworkers than remaining jobs are needed
+    uint32_t nof_started = SRSRAN_MIN(pool->nof_workers, pool->nof_jobs - 1);
+    for (uint32_t i = 0; i < nof_started; i++) {
+      sem_post(&pool->workers[i].start);
     }
 
-    // Compute number of iterations
-    uint32_t n_iter_cb = (ret == 0) ? decoder->max_nof_iter : (uint32_t)ret;
-    nof_iter_sum += n_iter_cb;
+    sch_nr_coworker_run(pool, q);
 
-    // Check if CB is all zeros
-    uint32_t cb_len    = cfg.Kp - cfg.L_cb;
-    bool     all_zeros = true;
-    for (uint32_t i = 0; i < cb_len && all_zeros; i++) {
-      all_zeros = (q->temp_cb[i] == 0);
+    for (uint32_t i = 0; i < nof_started; i++) {
+      sem_wait(&pool->workers[i].finish);
     }
 
-    tb->softbuffer.rx->cb_crc[r] = (ret != 0) && (!all_zeros);
-    SCH_INFO_RX("CB %d/%d iter=%d CRC=%s all_zeros=%s",
-                r,
-                cfg.C,
-                n_iter_cb,
-                tb->softbuffer.rx->cb_crc[r] ? "OK" : "KO",
-                all_zeros ? "yes" : "no");
+    if (pool->ret_status < SRSRAN_SUCCESS) {
+      return SRSRAN_ERROR;
+    }
 
-    // CB Debug trace
-    if (SRSRAN_DEBUG_ENABLED && srsran_verbose >= SRSRAN_VERBOSE_DEBUG && !handler_registered) {
-      DEBUG("CB %d/%d:", r, cfg.C);
-      srsran_vec_fprint_hex(stdout, q->temp_cb, cb_len);
+    for (uint32_t i = 0; i < pool->nof_jobs; i++) {
+      nof_iter_sum += pool->jobs[i].n_iter;
     }
+  }
 
-    // Pack and count CRC OK only if CRC is match
+  // Count code blocks that have matched CRC
+  uint32_t cb_ok = 0;
+  for (uint32_t r = 0; r < cfg.C; r++) {
     if (tb->softbuffer.rx->cb_crc[r]) {
-      srsran_bit_pack_vector(q->temp_cb, tb->softbuffer.rx->data[r], cb_len);
       cb_ok++;
     }
-
-    input_ptr += E;
   }
 
   // Set average number of iterations
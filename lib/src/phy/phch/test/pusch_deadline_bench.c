@@ -0,0 +1,345 @@
+/**
+ * Copyright 2013-2021 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "srsran/common/test_common.h"
+#include "srsran/srsran.h"
+
+/*
+ * Overloads a PUSCH receiver with more grants per subframe than it can decode with full turbo iterations within the
+ * subframe budget. Every subframe is decoded twice on the same received signal: with a fixed number of iterations, in
+ * scheduling order, and with the decoding deadline, retransmissions and UCI first, as the eNb workers do.
+ */
+
+static srsran_cell_t cell = {
+    .nof_prb         = 100,               // nof_prb
+    .nof_ports       = 1,                 // nof_ports
+    .id              = 1,                 // cell_id
+    .cp              = SRSRAN_CP_NORM,    // cyclic prefix
+    .phich_length    = SRSRAN_PHICH_NORM, // PHICH length
+    .phich_resources = SRSRAN_PHICH_R_1_6 // PHICH resources
+};
+
+static uint32_t nof_ue      = 4;
+static uint32_t mcs_idx     = 24;
+static float    snr_db      = 17.0f;
+static uint32_t nof_sf      = 100;
+static float    load        = 1.5f;
+static uint32_t budget_us   = 0;
+static uint32_t max_iters   = 8;
+static uint32_t prio_period = 4;
+
+typedef struct {
+  srsran_pusch_cfg_t     cfg;
+  srsran_softbuffer_tx_t softbuffer_tx;
+  srsran_softbuffer_rx_t softbuffer_rx;
+  uint8_t*               data;
+  uint8_t*               data_rx;
+  cf_t*                  sf_tx;
+  cf_t*                  sf_rx;
+  bool                   priority; // Stands for a retransmission or a PUSCH carrying UCI
+} bench_ue_t;
+
+typedef struct {
+  uint32_t                nof_sf_on_time;
+  uint32_t                nof_tb;
+  uint32_t                nof_tb_ko;
+  uint32_t                nof_tb_lost; // KO, shed or in a subframe that missed the budget
+  uint32_t                nof_prio_tb;
+  uint32_t                nof_prio_tb_lost;
+  uint32_t                nof_tb_shed;
+  uint64_t                nof_iters_shed;
+  double                  sf_us;
+  srsran_pusch_deadline_t deadline; // Learns the PUSCH decoding time as the eNb workers do
+} bench_stats_t;
+
+void usage(char* prog)
+{
+  printf("Usage: %s [numSlbip]\n", prog);
+  printf("\t-n number of PRB [Default %d]\n", cell.nof_prb);
+  printf("\t-u number of PUSCH per subframe [Default %d]\n", nof_ue);
+  printf("\t-m MCS index [Default %d]\n", mcs_idx);
+  printf("\t-S SNR in dB [Default %.1f]\n", snr_db);
+  printf("\t-s number of subframes [Default %d]\n", nof_sf);
+  printf("\t-l load, full decoding time over the budget [Default %.1f]\n", load);
+  printf("\t-b subframe budget in us [Default 0=from load]\n");
+  printf("\t-i maximum turbo decoder iterations [Default %d]\n", max_iters);
+  printf("\t-p one PUSCH in p is a retransmission or carries UCI [Default %d]\n", prio_period);
+}
+
+void parse_args(int argc, char** argv)
+{
+  int opt;
+  while ((opt = getopt(argc, argv, "numSslbip")) != -1) {
+    switch (opt) {
+      case 'n':
+        cell.nof_prb = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      case 'u':
+        nof_ue = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      case 'm':
+        mcs_idx = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      case 'S':
+        snr_db = strtof(argv[optind], NULL);
+        break;
+      case 's':
+        nof_sf = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      case 'l':
+        load = strtof(argv[optind], NULL);
+        break;
+      case 'b':
+        budget_us = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      case 'i':
+        max_iters = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      case 'p':
+        prio_period = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      default:
+        usage(argv[0]);
+        exit(-1);
+    }
+  }
+}
+
+static int64_t now_ns(void)
+{
+  struct timespec t;
+  clock_gettime(CLOCK_MONOTONIC, &t);
+  return (int64_t)t.tv_sec * 1000000000 + t.tv_nsec;
+}
+
+// Decodes all the PUSCH of one subframe, returns the time it took in ns or a negative value on error
+static int64_t run_subframe(srsran_pusch_t*        pusch,
+                            srsran_ul_sf_cfg_t*    ul_sf,
+                            srsran_chest_ul_res_t* chest_res,
+                            bench_ue_t*            ues,
+                            bool                   deadline_en,
+                            int64_t                budget_ns,
+                            bench_stats_t*         stats)
+{
+  uint32_t order[SRSRAN_MAX_PRB]    = {};
+  bool     priority[SRSRAN_MAX_PRB] = {};
+  bool     crc[SRSRAN_MAX_PRB]      = {};
+
+  // Retransmissions and UCI first against a deadline
+  for (uint32_t u = 0; u < nof_ue; u++) {
+    priority[u] = deadline_en && ues[u].priority;
+  }
+  srsran_pusch_deadline_order(priority, nof_ue, order);
+
+  int64_t t0          = now_ns();
+  int64_t deadline_ns = t0 + budget_ns;
+  for (uint32_t k = 0; k < nof_ue; k++) {
+    bench_ue_t*        ue        = &ues[order[k]];
+    srsran_pusch_res_t pusch_res = {};
+    bool               shed      = false;
+    int64_t            t         = now_ns();
+
+    // New transmissions without UCI are shed when their expected decoding time no longer fits
+    ue->cfg.deadline_en = deadline_en;
+    if (deadline_en) {
+      ue->cfg.deadline.tv_sec  = deadline_ns / 1000000000;
+      ue->cfg.deadline.tv_nsec = deadline_ns % 1000000000;
+      shed = srsran_pusch_deadline_shed(&stats->deadline, ue->priority, ue->cfg.grant.tb.tbs, t, deadline_ns);
+    }
+
+    if (!shed) {
+      srsran_softbuffer_rx_reset_tbs(&ue->softbuffer_rx, ue->cfg.grant.tb.tbs);
+      ue->cfg.softbuffers.rx = &ue->softbuffer_rx;
+      pusch_res.data         = ue->data_rx;
+      if (srsran_pusch_decode(pusch, ul_sf, &ue->cfg, chest_res, ue->sf_rx, &pusch_res)) {
+        ERROR("Error decoding PUSCH");
+        return SRSRAN_ERROR;
+      }
+      crc[order[k]] = pusch_res.crc && memcmp(ue->data_rx, ue->data, ue->cfg.grant.tb.tbs / 8) == 0;
+      stats->nof_iters_shed += pusch_res.nof_shed_iterations;
+      srsran_pusch_deadline_learn(&stats->deadline, ue->cfg.grant.tb.tbs, now_ns() - t);
+    } else {
+      stats->nof_tb_shed++;
+    }
+  }
+  int64_t elapsed_ns = now_ns() - t0;
+  bool    on_time    = elapsed_ns <= budget_ns;
+
+  // A subframe late for transmission loses the HARQ feedback of all its PUSCH
+  stats->nof_sf_on_time += on_time ? 1 : 0;
+  for (uint32_t u = 0; u < nof_ue; u++) {
+    bool lost = !crc[u] || !on_time;
+    stats->nof_tb++;
+    stats->nof_tb_ko += crc[u] ? 0 : 1;
+    stats->nof_tb_lost += lost ? 1 : 0;
+    stats->nof_prio_tb += ues[u].priority ? 1 : 0;
+    stats->nof_prio_tb_lost += (ues[u].priority && lost) ? 1 : 0;
+  }
+  stats->sf_us += elapsed_ns / 1000.0;
+
+  return elapsed_ns;
+}
+
+static void print_stats(const char* mode, bench_stats_t* s)
+{
+  printf("%10s %10.1f %10.2f %10.2f %10.2f %10d %10.2f %10.1f\n",
+         mode,
+         100.0 * s->nof_sf_on_time / nof_sf,
+         100.0 * s->nof_tb_ko / s->nof_tb,
+         100.0 * s->nof_tb_lost / s->nof_tb,
+         s->nof_prio_tb ? 100.0 * s->nof_prio_tb_lost / s->nof_prio_tb : 0.0,
+         s->nof_tb_shed,
+         (double)s->nof_iters_shed / s->nof_tb,
+         s->sf_us / nof_sf);
+}
+
+int main(int argc, char** argv)
+{
+  srsran_pusch_t        pusch_tx  = {};
+  srsran_pusch_t        pusch_rx  = {};
+  srsran_chest_ul_res_t chest_res = {};
+  srsran_random_t       random_h  = srsran_random_init(0);
+  bench_ue_t*           ues       = NULL;
+  bench_stats_t         stats[2]  = {};
+
+  parse_args(argc, argv);
+  nof_ue = SRSRAN_MAX(1, SRSRAN_MIN(nof_ue, cell.nof_prb));
+
+  uint32_t nof_re = SRSRAN_NRE * cell.nof_prb * 2 * SRSRAN_CP_NSYMB(cell.cp);
+  uint32_t L_prb  = srsran_dft_precoding_get_valid_prb(cell.nof_prb / nof_ue);
+
+  TESTASSERT(srsran_pusch_init_ue(&pusch_tx, cell.nof_prb) == SRSRAN_SUCCESS);
+  TESTASSERT(srsran_pusch_set_cell(&pusch_tx, cell) == SRSRAN_SUCCESS);
+  TESTASSERT(srsran_pusch_init_enb(&pusch_rx, cell.nof_prb) == SRSRAN_SUCCESS);
+  TESTASSERT(srsran_pusch_set_cell(&pusch_rx, cell) == SRSRAN_SUCCESS);
+  TESTASSERT(srsran_chest_ul_res_init(&chest_res, cell.nof_prb) == SRSRAN_SUCCESS);
+  srsran_chest_ul_res_set_identity(&chest_res);
+  chest_res.noise_estimate = srsran_convert_dB_to_power(-snr_db);
+  float noise_std          = sqrtf(chest_res.noise_estimate / 2);
+
+  srsran_ul_sf_cfg_t         ul_sf      = {};
+  srsran_pusch_hopping_cfg_t ul_hopping = {.n_sb = 1, .hopping_offset = 0, .hop_mode = 1};
+
+  // Each UE transmits a fixed TB on its own PRB, the received signal only changes in noise
+  ues = calloc(nof_ue, sizeof(bench_ue_t));
+  TESTASSERT(ues != NULL);
+  for (uint32_t u = 0; u < nof_ue; u++) {
+    bench_ue_t*     ue  = &ues[u];
+    srsran_dci_ul_t dci = {};
+    dci.rnti            = (uint16_t)(0x46 + u);
+    dci.freq_hop_fl     = -1;
+    dci.type2_alloc.riv = srsran_ra_type2_to_riv(L_prb, u * L_prb, cell.nof_prb);
+    dci.tb.mcs_idx      = mcs_idx;
+    TESTASSERT(srsran_ra_ul_dci_to_grant(&cell, &ul_sf, &ul_hopping, &dci, &ue->cfg.grant) == SRSRAN_SUCCESS);
+    ue->cfg.grant.n_prb_tilde[0] = ue->cfg.grant.n_prb[0];
+    ue->cfg.grant.n_prb_tilde[1] = ue->cfg.grant.n_prb[1];
+    ue->cfg.rnti                 = dci.rnti;
+    ue->cfg.max_nof_iterations   = max_iters;
+    ue->priority                 = prio_period && (u % prio_period) == 0;
+
+    TESTASSERT(srsran_softbuffer_tx_init(&ue->softbuffer_tx, cell.nof_prb) == SRSRAN_SUCCESS);
+    TESTASSERT(srsran_softbuffer_rx_init(&ue->softbuffer_rx, cell.nof_prb) == SRSRAN_SUCCESS);
+    ue->data    = srsran_vec_u8_malloc(ue->cfg.grant.tb.tbs / 8 + 1);
+    ue->data_rx = srsran_vec_u8_malloc(ue->cfg.grant.tb.tbs / 8 + 3); // The decoder clears 3 bytes past the TB
+    ue->sf_tx   = srsran_vec_cf_malloc(nof_re);
+    ue->sf_rx   = srsran_vec_cf_malloc(nof_re);
+    TESTASSERT(ue->data && ue->data_rx && ue->sf_tx && ue->sf_rx);
+
+    for (uint32_t i = 0; i < (uint32_t)ue->cfg.grant.tb.tbs / 8; i++) {
+      ue->data[i] = (uint8_t)srsran_random_uniform_int_dist(random_h, 0, 255);
+    }
+    srsran_vec_cf_zero(ue->sf_tx, nof_re);
+    srsran_pusch_data_t pdata = {};
+    pdata.ptr                 = ue->data;
+    ue->cfg.softbuffers.tx    = &ue->softbuffer_tx;
+    TESTASSERT(srsran_pusch_encode(&pusch_tx, &ul_sf, &ue->cfg, &pdata, ue->sf_tx) == SRSRAN_SUCCESS);
+  }
+
+  // Without a given budget, take the full decoding time over the load
+  if (budget_us == 0) {
+    bench_stats_t calib     = {};
+    int64_t       total_ns  = 0;
+    uint32_t      nof_calib = SRSRAN_MAX(1, SRSRAN_MIN(nof_sf, 10));
+    for (uint32_t n = 0; n < nof_calib; n++) {
+      for (uint32_t u = 0; u < nof_ue; u++) {
+        srsran_ch_awgn_c(ues[u].sf_tx, ues[u].sf_rx, noise_std, nof_re);
+      }
+      int64_t t = run_subframe(&pusch_rx, &ul_sf, &chest_res, ues, false, INT64_MAX / 2, &calib);
+      TESTASSERT(t >= 0);
+      total_ns += t;
+    }
+    budget_us = (uint32_t)SRSRAN_MAX(1, total_ns / nof_calib / 1000 / load);
+  }
+
+  printf("%d PUSCH/subframe, %d PRB, TBS=%d, MCS=%d, SNR=%.1f dB, max %d iterations, budget %d us\n",
+         nof_ue,
+         L_prb,
+         ues[0].cfg.grant.tb.tbs,
+         mcs_idx,
+         snr_db,
+         max_iters,
+         budget_us);
+
+  for (uint32_t n = 0; n < nof_sf; n++) {
+    for (uint32_t u = 0; u < nof_ue; u++) {
+      srsran_ch_awgn_c(ues[u].sf_tx, ues[u].sf_rx, noise_std, nof_re);
+    }
+    TESTASSERT(run_subframe(&pusch_rx, &ul_sf, &chest_res, ues, false, budget_us * 1000, &stats[0]) >= 0);
+    TESTASSERT(run_subframe(&pusch_rx, &ul_sf, &chest_res, ues, true, budget_us * 1000, &stats[1]) >= 0);
+  }
+
+  // BLER only counts decoding failures, lost also counts shed PUSCH and all the PUSCH of late subframes
+  printf("%10s %10s %10s %10s %10s %10s %10s %10s\n",
+         "mode",
+         "on-time %",
+         "BLER %",
+         "lost %",
+         "prio lost %",
+         "shed TB",
+         "shed it/TB",
+         "sf (us)");
+  print_stats("fixed", &stats[0]);
+  print_stats("deadline", &stats[1]);
+
+  for (uint32_t u = 0; u < nof_ue; u++) {
+    srsran_softbuffer_tx_free(&ues[u].softbuffer_tx);
+    srsran_softbuffer_rx_free(&ues[u].softbuffer_rx);
+    free(ues[u].data);
+    free(ues[u].data_rx);
+    free(ues[u].sf_tx);
+    free(ues[u].sf_rx);
+  }
+  free(ues);
+  srsran_chest_ul_res_free(&chest_res);
+  srsran_pusch_free(&pusch_tx);
+  srsran_pusch_free(&pusch_rx);
+  srsran_random_free(random_h);
+
+  printf("Ok!\n");
+  return SRSRAN_SUCCESS;
+}
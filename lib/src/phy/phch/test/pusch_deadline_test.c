@@ -0,0 +1,93 @@
+/**
+ * Copyright 2013-2021 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "srsran/common/test_common.h"
+#include "srsran/srsran.h"
+#include <math.h>
+
+int test_order()
+{
+  const bool     priority[6] = {false, true, false, false, true, false};
+  const uint32_t expected[6] = {1, 4, 0, 2, 3, 5};
+  uint32_t       order[6]    = {};
+
+  // Priority PUSCH go first, both groups keep the scheduling order
+  srsran_pusch_deadline_order(priority, 6, order);
+  for (uint32_t i = 0; i < 6; i++) {
+    TESTASSERT(order[i] == expected[i]);
+  }
+
+  // Without priority PUSCH the scheduling order is kept
+  const bool none[3] = {};
+  srsran_pusch_deadline_order(none, 3, order);
+  for (uint32_t i = 0; i < 3; i++) {
+    TESTASSERT(order[i] == i);
+  }
+
+  return SRSRAN_SUCCESS;
+}
+
+int test_shed()
+{
+  srsran_pusch_deadline_t q = {};
+
+  // Nothing is shed until the decoding time has been learnt
+  TESTASSERT(!srsran_pusch_deadline_shed(&q, false, 10000, 1000, 1000));
+
+  // 10 ns per bit
+  srsran_pusch_deadline_learn(&q, 1000, 10000);
+
+  // A PUSCH is shed when it does not finish before the deadline
+  TESTASSERT(!srsran_pusch_deadline_shed(&q, false, 1000, 0, 10000));
+  TESTASSERT(srsran_pusch_deadline_shed(&q, false, 1001, 0, 10000));
+  TESTASSERT(srsran_pusch_deadline_shed(&q, false, 0, 10001, 10000));
+
+  // Priority PUSCH are decoded even when late
+  TESTASSERT(!srsran_pusch_deadline_shed(&q, true, 1001, 0, 10000));
+  TESTASSERT(!srsran_pusch_deadline_shed(&q, true, 1000, 20000, 10000));
+
+  return SRSRAN_SUCCESS;
+}
+
+int test_learn()
+{
+  srsran_pusch_deadline_t q = {};
+
+  // The first PUSCH sets the decoding time, the next ones are averaged
+  srsran_pusch_deadline_learn(&q, 1000, 10000);
+  TESTASSERT(fabsf(q.ns_per_bit - 10.0f) < 1e-3f);
+  srsran_pusch_deadline_learn(&q, 1000, 20000);
+  TESTASSERT(fabsf(q.ns_per_bit - 11.0f) < 1e-3f);
+
+  // Empty transport blocks are ignored
+  srsran_pusch_deadline_learn(&q, 0, 20000);
+  TESTASSERT(fabsf(q.ns_per_bit - 11.0f) < 1e-3f);
+
+  return SRSRAN_SUCCESS;
+}
+
+int main()
+{
+  TESTASSERT(test_order() == SRSRAN_SUCCESS);
+  TESTASSERT(test_shed() == SRSRAN_SUCCESS);
+  TESTASSERT(test_learn() == SRSRAN_SUCCESS);
+  return SRSRAN_SUCCESS;
+}
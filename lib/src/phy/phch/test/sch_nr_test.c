@@ -26,6 +26,7 @@
 #include "srsran/phy/utils/vector.h"
 #include <getopt.h>
 #include <srsran/phy/utils/random.h>
+#include <sys/time.h>
 
 static srsran_carrier_nr_t carrier = {
     1,                               // pci
@@ -41,11 +42,12 @@ static srsran_carrier_nr_t carrier = {
 static uint32_t            n_prb     = 0;  // Set to 0 for steering
 static uint32_t            mcs       = 30; // Set to 30 for steering
 static uint32_t            rv        = 4;  // Set to 30 for steering
+static uint32_t            coworkers = 0;
 static srsran_sch_cfg_nr_t pdsch_cfg = {};
 
 static void usage(char* prog)
 {
-  printf("Usage: %s [prTL] \n", prog);
+  printf("Usage: %s [prTLt] \n", prog);
   printf("\t-P Number of carrier PRB [Default %d]\n", carrier.nof_prb);
   printf("\t-p Number of grant PRB, set to 0 for steering [Default %d]\n", n_prb);
   printf("\t-r Redundancy version, set to 4 or higher for steering [Default %d]\n", rv);
@@ -53,13 +55,14 @@ static void usage(char* prog)
   printf("\t-T Provide MCS table (64qam, 256qam, 64qamLowSE) [Default %s]\n",
          srsran_mcs_table_to_str(pdsch_cfg.sch_cfg.mcs_table));
   printf("\t-L Provide number of layers [Default %d]\n", carrier.max_mimo_layers);
+  printf("\t-t Number of code block decoding coworker threads [Default %d]\n", coworkers);
   printf("\t-v [set srsran_verbose to debug, default none]\n");
 }
 
 int parse_args(int argc, char** argv)
 {
   int opt;
-  while ((opt = getopt(argc, argv, "PpmTLvr")) != -1) {
+  while ((opt = getopt(argc, argv, "PpmTLtvr")) != -1) {
     switch (opt) {
       case 'P':
         carrier.nof_prb = (uint32_t)strtol(argv[optind], NULL, 10);
@@ -79,6 +82,9 @@ int parse_args(int argc, char** argv)
       case 'L':
         carrier.max_mimo_layers = (uint32_t)strtol(argv[optind], NULL, 10);
         break;
+      case 't':
+        coworkers = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
       case 'v':
         srsran_verbose++;
         break;
@@ -119,6 +125,7 @@ int main(int argc, char** argv)
   args.decoder_use_flooded    = false;
   args.decoder_scaling_factor = 0.8;
   args.max_nof_iter           = 20;
+  args.nof_coworkers          = coworkers;
   if (srsran_sch_nr_init_tx(&sch_nr_tx, &args) < SRSRAN_SUCCESS) {
     ERROR("Error initiating SCH NR for Tx");
     goto clean_exit;
@@ -182,6 +189,11 @@ int main(int argc, char** argv)
     mcs_end   = SRSRAN_MIN(mcs + 1, mcs_end);
   }
 
+  uint32_t nof_cb     = 0;
+  uint32_t nof_slots  = 0;
+  uint64_t decode_us  = 0;
+  uint32_t max_dec_us = 0;
+
   for (n_prb = n_prb_start; n_prb < n_prb_end; n_prb++) {
     for (mcs = mcs_start; mcs < mcs_end; mcs++) {
       for (rv = rv_start; rv < rv_end; rv++) {
@@ -222,10 +234,25 @@ int main(int argc, char** argv)
 
         srsran_sch_tb_res_nr_t res = {};
         res.payload                = data_rx;
+        struct timeval t[3]        = {};
+        gettimeofday(&t[1], NULL);
         if (srsran_dlsch_nr_decode(&sch_nr_rx, &pdsch_cfg.sch_cfg, &tb, llr, &res) < SRSRAN_SUCCESS) {
           ERROR("Error encoding");
           goto clean_exit;
         }
+        gettimeofday(&t[2], NULL);
+        get_time_interval(t);
+
+        srsran_sch_nr_tb_info_t tb_info = {};
+        if (srsran_sch_nr_fill_tb_info(&carrier, &pdsch_cfg.sch_cfg, &tb, &tb_info) < SRSRAN_SUCCESS) {
+          ERROR("Error filling TB info");
+          goto clean_exit;
+        }
+        uint32_t slot_us = t[0].tv_sec * 1000000UL + t[0].tv_usec;
+        nof_cb += tb_info.Cp;
+        nof_slots++;
+        decode_us += slot_us;
+        max_dec_us = SRSRAN_MAX(max_dec_us, slot_us);
 
         if (rv == 0) {
           if (!res.crc) {
@@ -233,6 +260,12 @@ int main(int argc, char** argv)
             goto clean_exit;
           }
 
+          // Noiseless LLRs must stop on the syndrome and CRC well before the iteration limit
+          if (res.avg_iter >= (float)args.max_nof_iter) {
+            ERROR("Decoder did not stop early; n_prb=%d; mcs=%d; TBS=%d; iter=%.1f;", n_prb, mcs, tb.tbs, res.avg_iter);
+            goto clean_exit;
+          }
+
           if (memcmp(data_tx, data_rx, tb.tbs / 8) != 0) {
             ERROR("Failed to match Tx/Rx data; n_prb=%d; mcs=%d; TBS=%d;", n_prb, mcs, tb.tbs);
             printf("Tx data: ");
@@ -248,6 +281,16 @@ int main(int argc, char** argv)
     }
   }
 
+  if (nof_slots > 0 && decode_us > 0) {
+    printf("Decoded %d CB in %d slots with %d coworkers: %.1f CB/s; latency avg=%.1f us, max=%d us;\n",
+           nof_cb,
+           nof_slots,
+           coworkers,
+           (double)nof_cb * 1e6 / (double)decode_us,
+           (double)decode_us / (double)nof_slots,
+           max_dec_us);
+  }
+
   ret = SRSRAN_SUCCESS;
 
 clean_exit:
@@ -0,0 +1,202 @@
+/**
+ * Copyright 2013-2021 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "srsran/common/test_common.h"
+#include "srsran/phy/utils/random.h"
+#include "srsran/srsran.h"
+#include <string.h>
+#include <sys/time.h>
+
+#define MAX_ROWS (SRSRAN_MAX_PRB * SRSRAN_NRE)
+#define MAX_NOF_BITS (MAX_ROWS * SRSRAN_CP_NORM_NSYMB * 2 * 6)
+#define NOF_REPETITIONS 20
+
+static srsran_random_t random_gen = NULL;
+
+static uint8_t          g_bits[MAX_NOF_BITS];
+static uint8_t          g_bits_packed[MAX_NOF_BITS / 8];
+static uint8_t          q_bits[MAX_NOF_BITS];
+static uint8_t          q_bits_packed[MAX_NOF_BITS / 8];
+static uint8_t          q_bits_gold[MAX_NOF_BITS];
+static int16_t          q_soft[MAX_NOF_BITS];
+static int16_t          g_soft[MAX_NOF_BITS];
+static uint32_t         lut[MAX_NOF_BITS];
+static uint8_t          ri_mask[MAX_NOF_BITS];
+static uint8_t          ri_present[MAX_NOF_BITS];
+static srsran_uci_bit_t ri_bits[4 * MAX_ROWS * 6];
+static srsran_uci_bit_t ack_bits[4 * MAX_ROWS * 6];
+
+/* RI and ACK symbol positions according to 5.2.2.8 of 36.212, filled from the last row upwards */
+static void uci_positions(uint32_t          nof_uci_symbols,
+                          uint32_t          Qm,
+                          uint32_t          rows,
+                          const uint32_t*   column_set,
+                          srsran_uci_bit_t* bits)
+{
+  for (uint32_t i = 0; i < nof_uci_symbols; i++) {
+    uint32_t row = rows - 1 - i / 4;
+    uint32_t col = column_set[(3 * i) % 4];
+    for (uint32_t k = 0; k < Qm; k++) {
+      bits[i * Qm + k].position = (col * rows + row) * Qm + k;
+      bits[i * Qm + k].type     = (srsran_uci_bit_type_t)srsran_random_uniform_int_dist(random_gen, 0, 1);
+    }
+  }
+}
+
+/* Interleaver look-up table as the original implementation generated it: data bits are read row by row and
+ * written column by column, skipping the RI positions. Returns the number of data bits.
+ */
+static uint32_t interleaver_lut_gen(uint32_t Qm, uint32_t rows, uint32_t cols)
+{
+  uint32_t idx = 0;
+  for (uint32_t j = 0; j < rows; j++) {
+    for (uint32_t i = 0; i < cols; i++) {
+      for (uint32_t k = 0; k < Qm; k++) {
+        uint32_t pos = (i * rows + j) * Qm + k;
+        lut[pos]     = ri_mask[pos] ? UINT32_MAX : idx++;
+      }
+    }
+  }
+  return idx;
+}
+
+static int
+test_interleaver(uint32_t rows, uint32_t Qm, uint32_t nof_symbols, uint32_t nof_ri_symbols, uint32_t nof_ack_symbols)
+{
+  const uint32_t ri_column_set_norm[4]  = {1, 4, 7, 10};
+  const uint32_t ri_column_set_ext[4]   = {0, 3, 5, 8};
+  const uint32_t ack_column_set_norm[4] = {2, 3, 8, 9};
+  const uint32_t ack_column_set_ext[4]  = {1, 2, 6, 7};
+
+  uint32_t H_prime_total = rows * nof_symbols;
+  uint32_t nof_bits      = H_prime_total * Qm;
+  uint32_t nof_ri_bits   = nof_ri_symbols * Qm;
+  uint32_t nof_ack_bits  = nof_ack_symbols * Qm;
+
+  uci_positions(nof_ri_symbols, Qm, rows, nof_symbols > 10 ? ri_column_set_norm : ri_column_set_ext, ri_bits);
+  uci_positions(nof_ack_symbols, Qm, rows, nof_symbols > 10 ? ack_column_set_norm : ack_column_set_ext, ack_bits);
+
+  memset(ri_mask, 0, nof_bits);
+  for (uint32_t i = 0; i < nof_ri_bits; i++) {
+    ri_mask[ri_bits[i].position] = 1;
+  }
+  uint32_t nof_data_bits = interleaver_lut_gen(Qm, rows, nof_symbols);
+
+  for (uint32_t i = 0; i < nof_data_bits; i++) {
+    g_bits[i] = (uint8_t)srsran_random_uniform_int_dist(random_gen, 0, 1);
+  }
+  for (uint32_t i = 0; i < nof_bits; i++) {
+    q_soft[i] = (int16_t)srsran_random_uniform_int_dist(random_gen, INT16_MIN, INT16_MAX);
+  }
+  srsran_bit_pack_vector(g_bits, g_bits_packed, nof_data_bits);
+
+  // The encoder leaves the RI positions empty and punctures the ACK bits into the interleaved data
+  for (uint32_t i = 0; i < nof_bits; i++) {
+    q_bits_gold[i] = ri_mask[i] ? 0 : g_bits[lut[i]];
+  }
+  for (uint32_t i = 0; i < nof_ack_bits; i++) {
+    q_bits_gold[ack_bits[i].position] = (uint8_t)ack_bits[i].type;
+  }
+
+  // The decoder erases the ACK bits before deinterleaving
+  for (uint32_t i = 0; i < nof_ack_bits; i++) {
+    q_soft[ack_bits[i].position] = 0;
+  }
+
+  struct timeval t[3]            = {};
+  uint64_t       interleave_us   = 0;
+  uint64_t       deinterleave_us = 0;
+  for (uint32_t r = 0; r < NOF_REPETITIONS; r++) {
+    gettimeofday(&t[1], NULL);
+    srsran_ulsch_interleave(
+        g_bits_packed, Qm, H_prime_total, nof_symbols, q_bits_packed, ri_bits, nof_ri_bits, ri_present);
+    gettimeofday(&t[2], NULL);
+    get_time_interval(t);
+    interleave_us += t[0].tv_sec * 1000000UL + t[0].tv_usec;
+
+    gettimeofday(&t[1], NULL);
+    srsran_ulsch_deinterleave(q_soft, Qm, H_prime_total, nof_symbols, g_soft, ri_bits, nof_ri_bits, ri_present);
+    gettimeofday(&t[2], NULL);
+    get_time_interval(t);
+    deinterleave_us += t[0].tv_sec * 1000000UL + t[0].tv_usec;
+  }
+
+  // The scratch buffer is given back clean
+  for (uint32_t i = 0; i < nof_bits; i++) {
+    TESTASSERT(ri_present[i] == 0);
+  }
+
+  // The packed interleaver must match the look-up table
+  srsran_bit_unpack_vector(q_bits_packed, q_bits, nof_bits);
+  for (uint32_t i = 0; i < nof_ack_bits; i++) {
+    q_bits[ack_bits[i].position] = (uint8_t)ack_bits[i].type;
+  }
+  TESTASSERT(memcmp(q_bits, q_bits_gold, nof_bits) == 0);
+
+  // The deinterleaver must invert the same permutation, RI positions are not data
+  for (uint32_t i = 0; i < nof_bits; i++) {
+    if (!ri_mask[i]) {
+      TESTASSERT(g_soft[lut[i]] == q_soft[i]);
+    }
+  }
+
+  printf("rows=%4d; Qm=%d; nof_symbols=%2d; Q'_ri=%4d; Q'_ack=%4d; interleave=%6.1f ns/bit; "
+         "deinterleave=%6.1f ns/bit;\n",
+         rows,
+         Qm,
+         nof_symbols,
+         nof_ri_symbols,
+         nof_ack_symbols,
+         (double)interleave_us * 1000.0 / (NOF_REPETITIONS * nof_bits),
+         (double)deinterleave_us * 1000.0 / (NOF_REPETITIONS * nof_bits));
+
+  return SRSRAN_SUCCESS;
+}
+
+int main(int argc, char** argv)
+{
+  random_gen = srsran_random_init(1234);
+
+  // PUSCH allocations always have a multiple of 12 rows, the others check the unaligned paths
+  const uint32_t rows_list[]     = {12, 13, 14, 15, 72, 300, 1200};
+  const uint32_t Qm_list[]       = {2, 4, 6};
+  const uint32_t nof_symb_list[] = {9, 10, 11, 12};
+
+  for (uint32_t r = 0; r < sizeof(rows_list) / sizeof(uint32_t); r++) {
+    uint32_t rows = rows_list[r];
+
+    // Number of RI and ACK modulation symbols, from none up to their four columns filled
+    const uint32_t nof_uci_list[][2] = {{0, 0}, {1, 0}, {0, 1}, {2, 3}, {5, 7}, {4 * rows, 4 * rows}};
+
+    for (uint32_t m = 0; m < sizeof(Qm_list) / sizeof(uint32_t); m++) {
+      for (uint32_t s = 0; s < sizeof(nof_symb_list) / sizeof(uint32_t); s++) {
+        for (uint32_t u = 0; u < sizeof(nof_uci_list) / sizeof(nof_uci_list[0]); u++) {
+          TESTASSERT(test_interleaver(rows, Qm_list[m], nof_symb_list[s], nof_uci_list[u][0], nof_uci_list[u][1]) ==
+                     SRSRAN_SUCCESS);
+        }
+      }
+    }
+  }
+
+  srsran_random_free(random_gen);
+
+  return SRSRAN_SUCCESS;
+}
@@ -0,0 +1,284 @@
+/**
+ * Copyright 2013-2021 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "srsran/phy/resampling/resampler.h"
+#include "srsran/phy/utils/debug.h"
+#include "srsran/phy/utils/simd.h"
+#include "srsran/phy/utils/vector.h"
+#include <complex.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * Number of zero crossings of the prototype sinc, it sets the transition band width
+ */
+#define RESAMPLER_POLY_ZERO_CROSSINGS 32
+
+/**
+ * Kaiser window shape, around 80 dB of stop-band attenuation
+ */
+#define RESAMPLER_POLY_KAISER_BETA 8.0
+
+/**
+ * Upper bound of the reduced interpolation and decimation factors, it limits the filter bank size
+ */
+#define RESAMPLER_POLY_MAX_FACTOR 256
+
+/**
+ * Branch lengths are multiple of this so that the SIMD kernel never handles a tail
+ */
+#define RESAMPLER_POLY_TAPS_ALIGN 8
+
+static uint32_t resampler_poly_gcd(uint32_t a, uint32_t b)
+{
+  while (b != 0) {
+    uint32_t t = a % b;
+    a          = b;
+    b          = t;
+  }
+  return a;
+}
+
+// Zeroth order modified Bessel function of the first kind
+static double resampler_poly_bessel_i0(double x)
+{
+  double sum  = 1.0;
+  double term = 1.0;
+  for (uint32_t k = 1; k < 64 && term > 1e-12 * sum; k++) {
+    term *= (x / (2.0 * k)) * (x / (2.0 * k));
+    sum += term;
+  }
+  return sum;
+}
+
+int srsran_resampler_poly_init(srsran_resampler_poly_t* q, uint32_t L, uint32_t M)
+{
+  if (q == NULL || L == 0 || M == 0) {
+    return SRSRAN_ERROR_INVALID_INPUTS;
+  }
+
+  uint32_t g = resampler_poly_gcd(L, M);
+  L /= g;
+  M /= g;
+  if (L > RESAMPLER_POLY_MAX_FACTOR || M > RESAMPLER_POLY_MAX_FACTOR) {
+    ERROR("Resampling ratio %d/%d exceeds the maximum factor %d", L, M, RESAMPLER_POLY_MAX_FACTOR);
+    return SRSRAN_ERROR_OUT_OF_BOUNDS;
+  }
+
+  if (q->bank != NULL && q->L == L && q->M == M) {
+    srsran_resampler_poly_reset_state(q);
+    return SRSRAN_SUCCESS;
+  }
+
+  // Make sure resampler is freed
+  srsran_resampler_poly_free(q);
+
+  // The prototype runs at L times the input rate and spans the same number of zero crossings for any ratio
+  uint32_t max_factor = SRSRAN_MAX(L, M);
+  uint32_t nof_taps   = (RESAMPLER_POLY_ZERO_CROSSINGS * max_factor + L - 1) / L;
+  nof_taps            = SRSRAN_CEIL(nof_taps, RESAMPLER_POLY_TAPS_ALIGN) * RESAMPLER_POLY_TAPS_ALIGN;
+
+  q->L        = L;
+  q->M        = M;
+  q->nof_taps = nof_taps;
+  q->bank     = srsran_vec_f_malloc(2 * L * nof_taps);
+  q->history  = srsran_vec_cf_malloc(2 * nof_taps);
+  if (q->bank == NULL || q->history == NULL) {
+    srsran_resampler_poly_free(q);
+    return SRSRAN_ERROR;
+  }
+
+  // Kaiser windowed sinc with the cut-off at the lowest Nyquist frequency and a DC gain of L
+  uint32_t N      = L * nof_taps;
+  double   fc     = 0.5 / max_factor;
+  double   center = (N - 1) / 2.0;
+  double   i0     = resampler_poly_bessel_i0(RESAMPLER_POLY_KAISER_BETA);
+  for (uint32_t n = 0; n < N; n++) {
+    double t    = n - center;
+    double sinc = (fabs(t) < 1e-9) ? 1.0 : sin(2.0 * M_PI * fc * t) / (2.0 * M_PI * fc * t);
+    double r    = t / (center + 0.5);
+    double w    = resampler_poly_bessel_i0(RESAMPLER_POLY_KAISER_BETA * sqrt(SRSRAN_MAX(0.0, 1.0 - r * r))) / i0;
+    double h    = 2.0 * fc * L * sinc * w;
+
+    // Branch p holds h[p + j * L] in reverse order, so that it is applied to contiguous input samples
+    uint32_t p   = n % L;
+    uint32_t k   = nof_taps - 1 - n / L;
+    float*   row = &q->bank[2 * nof_taps * p];
+    row[2 * k]     = (float)h;
+    row[2 * k + 1] = (float)h;
+  }
+
+  srsran_resampler_poly_reset_state(q);
+
+  return SRSRAN_SUCCESS;
+}
+
+void srsran_resampler_poly_reset_state(srsran_resampler_poly_t* q)
+{
+  if (q == NULL || q->history == NULL) {
+    return;
+  }
+  srsran_vec_cf_zero(q->history, 2 * q->nof_taps);
+  q->phase   = 0;
+  q->next_in = 0;
+}
+
+uint32_t srsran_resampler_poly_get_delay(srsran_resampler_poly_t* q)
+{
+  if (q == NULL || q->M == 0) {
+    return UINT32_MAX;
+  }
+
+  // Prototype group delay in output samples
+  return (uint32_t)roundf((q->L * q->nof_taps - 1) / (2.0f * q->M));
+}
+
+uint32_t srsran_resampler_poly_nof_input(srsran_resampler_poly_t* q, uint32_t nof_output)
+{
+  if (q == NULL || q->L == 0) {
+    return 0;
+  }
+
+  // Input index of the first output which is not produced
+  return q->next_in + (uint32_t)(((uint64_t)q->phase + (uint64_t)nof_output * q->M) / q->L);
+}
+
+uint32_t srsran_resampler_poly_nof_output(srsran_resampler_poly_t* q, uint32_t nof_input)
+{
+  if (q == NULL || q->M == 0 || nof_input <= q->next_in) {
+    return 0;
+  }
+
+  // Outputs n for which next_in + (phase + n * M) / L < nof_input
+  uint64_t span = (uint64_t)(nof_input - q->next_in) * q->L - q->phase;
+  return (uint32_t)((span + q->M - 1) / q->M);
+}
+
+// Dot product between nof_taps complex samples and a branch, coefficients are duplicated for I and Q
+static inline cf_t resampler_poly_dot(const cf_t* x, const float* h, uint32_t nof_taps)
+{
+  const float* xf = (const float*)x;
+  uint32_t     i  = 0;
+  float        re = 0.0f;
+  float        im = 0.0f;
+
+#if SRSRAN_SIMD_F_SIZE
+  simd_f_t acc0 = srsran_simd_f_zero();
+  simd_f_t acc1 = srsran_simd_f_zero();
+  for (; i + 2 * SRSRAN_SIMD_F_SIZE <= 2 * nof_taps; i += 2 * SRSRAN_SIMD_F_SIZE) {
+    acc0 = srsran_simd_f_add(acc0, srsran_simd_f_mul(srsran_simd_f_loadu(&xf[i]), srsran_simd_f_load(&h[i])));
+    acc1 = srsran_simd_f_add(acc1,
+                             srsran_simd_f_mul(srsran_simd_f_loadu(&xf[i + SRSRAN_SIMD_F_SIZE]),
+                                               srsran_simd_f_load(&h[i + SRSRAN_SIMD_F_SIZE])));
+  }
+  for (; i + SRSRAN_SIMD_F_SIZE <= 2 * nof_taps; i += SRSRAN_SIMD_F_SIZE) {
+    acc0 = srsran_simd_f_add(acc0, srsran_simd_f_mul(srsran_simd_f_loadu(&xf[i]), srsran_simd_f_load(&h[i])));
+  }
+
+  // Even lanes accumulate I and odd lanes Q
+  srsran_simd_aligned float sum[SRSRAN_SIMD_F_SIZE];
+  srsran_simd_f_store(sum, srsran_simd_f_add(acc0, acc1));
+  for (uint32_t j = 0; j < SRSRAN_SIMD_F_SIZE; j += 2) {
+    re += sum[j];
+    im += sum[j + 1];
+  }
+#endif /* SRSRAN_SIMD_F_SIZE */
+
+  for (; i < 2 * nof_taps; i += 2) {
+    re += xf[i] * h[i];
+    im += xf[i + 1] * h[i + 1];
+  }
+
+  return re + I * im;
+}
+
+uint32_t srsran_resampler_poly_run(srsran_resampler_poly_t* q, const cf_t* input, cf_t* output, uint32_t nsamples)
+{
+  if (q == NULL || q->bank == NULL) {
+    return 0;
+  }
+
+  // Outputs are written while later windows still read the inputs they would overwrite
+  if (input != NULL && input == output) {
+    ERROR("The polyphase resampler cannot run in place");
+    return 0;
+  }
+
+  uint32_t T        = q->nof_taps;
+  uint32_t nof_head = SRSRAN_MIN(T - 1, nsamples);
+  uint32_t n        = 0;
+
+  // The first outputs need the previous block, history[k] holds input sample k - (T - 1)
+  if (input != NULL) {
+    srsran_vec_cf_copy(&q->history[T - 1], input, nof_head);
+  } else {
+    srsran_vec_cf_zero(&q->history[T - 1], nof_head);
+  }
+
+  while (q->next_in < nsamples) {
+    uint32_t i = q->next_in;
+    if (output != NULL) {
+      if (i < T - 1) {
+        output[n] = resampler_poly_dot(&q->history[i], &q->bank[2 * T * q->phase], T);
+      } else if (input != NULL) {
+        output[n] = resampler_poly_dot(&input[i - (T - 1)], &q->bank[2 * T * q->phase], T);
+      } else {
+        output[n] = 0.0f;
+      }
+    }
+    n++;
+
+    q->phase += q->M;
+    q->next_in += q->phase / q->L;
+    q->phase %= q->L;
+  }
+  q->next_in -= nsamples;
+
+  // Keep the last T - 1 input samples for the next block
+  if (nsamples >= T - 1) {
+    if (input != NULL) {
+      srsran_vec_cf_copy(q->history, &input[nsamples - (T - 1)], T - 1);
+    } else {
+      srsran_vec_cf_zero(q->history, T - 1);
+    }
+  } else {
+    memmove(q->history, &q->history[nsamples], (T - 1) * sizeof(cf_t));
+  }
+
+  return n;
+}
+
+void srsran_resampler_poly_free(srsran_resampler_poly_t* q)
+{
+  if (q == NULL) {
+    return;
+  }
+
+  if (q->bank) {
+    free(q->bank);
+  }
+  if (q->history) {
+    free(q->history);
+  }
+
+  memset(q, 0, sizeof(srsran_resampler_poly_t));
+}
@@ -0,0 +1,243 @@
+/**
+ * Copyright 2013-2021 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "srsran/common/test_common.h"
+#include "srsran/phy/resampling/resample_arb.h"
+#include "srsran/phy/resampling/resampler.h"
+#include "srsran/phy/utils/debug.h"
+#include "srsran/phy/utils/random.h"
+#include "srsran/phy/utils/vector.h"
+#include <complex.h>
+#include <getopt.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/time.h>
+
+static uint32_t L           = 3;
+static uint32_t M           = 4;
+static uint32_t buffer_size = 30720;
+static uint32_t repetitions = 100;
+
+static srsran_random_t random_gen = NULL;
+
+static void usage(char* prog)
+{
+  printf("Usage: %s [LMsr]\n", prog);
+  printf("\t-L Interpolation factor [Default %d]\n", L);
+  printf("\t-M Decimation factor [Default %d]\n", M);
+  printf("\t-s Input buffer size [Default %d]\n", buffer_size);
+  printf("\t-r Benchmark repetitions [Default %d]\n", repetitions);
+}
+
+static void parse_args(int argc, char** argv)
+{
+  int opt;
+
+  while ((opt = getopt(argc, argv, "LMsr")) != -1) {
+    switch (opt) {
+      case 'L':
+        L = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      case 'M':
+        M = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      case 's':
+        buffer_size = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      case 'r':
+        repetitions = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      default:
+        usage(argv[0]);
+        exit(-1);
+    }
+  }
+}
+
+// Resamples a tone of normalised frequency f (cycles per input sample) and returns the output error power relative
+// to the ideal delayed tone, or the output power if the tone is outside the output band
+static float tone_error(srsran_resampler_poly_t* q, cf_t* in, cf_t* out, float f)
+{
+  for (uint32_t i = 0; i < buffer_size; i++) {
+    in[i] = (cf_t)cexp(I * 2.0 * M_PI * f * i);
+  }
+
+  srsran_resampler_poly_reset_state(q);
+  uint32_t nof_out = srsran_resampler_poly_run(q, in, out, buffer_size);
+
+  // Group delay of the prototype, in input samples
+  double delay = (q->L * q->nof_taps - 1) / (2.0 * q->L);
+  bool   pass  = 2 * f * SRSRAN_MAX(L, M) < L;
+
+  // Skip the filter transients at both ends
+  uint32_t skip = 2 * q->nof_taps * L / M + 1;
+  double   err  = 0.0;
+  for (uint32_t m = skip; m < nof_out - skip; m++) {
+    cf_t expected = pass ? cexp(I * 2.0 * M_PI * f * ((double)m * M / L - delay)) : 0;
+    err += pow(cabsf(out[m] - expected), 2);
+  }
+  return (float)(err / (nof_out - 2 * skip));
+}
+
+// Processing in blocks of random length must be identical to processing at once
+static int test_blocks(srsran_resampler_poly_t* q, cf_t* in, cf_t* out, cf_t* out_blocks)
+{
+  srsran_random_uniform_complex_dist_vector(random_gen, in, buffer_size, -1.0f, 1.0f);
+
+  srsran_resampler_poly_reset_state(q);
+  uint32_t nof_out = srsran_resampler_poly_run(q, in, out, buffer_size);
+  TESTASSERT(nof_out == (buffer_size * L + M - 1) / M);
+  TESTASSERT(nof_out > 8 * q->nof_taps * L / M + 4);
+
+  srsran_resampler_poly_reset_state(q);
+  uint32_t nof_in = 0;
+  uint32_t n      = 0;
+  while (nof_in < buffer_size) {
+    uint32_t len = SRSRAN_MIN(buffer_size - nof_in, (uint32_t)srsran_random_uniform_int_dist(random_gen, 0, 100));
+    uint32_t expected = srsran_resampler_poly_nof_output(q, len);
+    uint32_t produced = srsran_resampler_poly_run(q, &in[nof_in], &out_blocks[n], len);
+    TESTASSERT(produced == expected);
+    nof_in += len;
+    n += produced;
+  }
+  TESTASSERT(n == nof_out);
+  TESTASSERT(!memcmp(out, out_blocks, sizeof(cf_t) * nof_out));
+
+  // A NULL input flushes the filter with zeros
+  uint32_t nof_flush = srsran_resampler_poly_run(q, NULL, out, q->nof_taps);
+  TESTASSERT(srsran_vec_avg_power_cf(&out[nof_flush / 2], nof_flush - nof_flush / 2) > 0);
+  nof_flush = srsran_resampler_poly_run(q, NULL, out, q->nof_taps);
+  TESTASSERT(srsran_vec_avg_power_cf(out, nof_flush) == 0);
+
+  // Running in place is refused
+  TESTASSERT(srsran_resampler_poly_run(q, out, out, q->nof_taps) == 0);
+  return SRSRAN_SUCCESS;
+}
+
+// srsran_resampler_poly_nof_input() gives the input length for a requested number of outputs, as the radio asks
+static int test_nof_input(srsran_resampler_poly_t* q, cf_t* in, cf_t* out)
+{
+  // Whole multiples of L outputs are produced exactly, as subframes are
+  srsran_resampler_poly_reset_state(q);
+  for (uint32_t i = 0; i < 100; i++) {
+    uint32_t nof_req = q->L * (uint32_t)srsran_random_uniform_int_dist(random_gen, 1, 2000 / q->L + 1);
+    uint32_t len     = srsran_resampler_poly_nof_input(q, nof_req);
+    TESTASSERT(len <= buffer_size);
+    TESTASSERT(srsran_resampler_poly_run(q, in, out, len) == nof_req);
+  }
+
+  // Otherwise the outputs sharing the last input sample are delayed to the next block
+  for (uint32_t i = 0; i < 100; i++) {
+    uint32_t nof_req = (uint32_t)srsran_random_uniform_int_dist(random_gen, 1, 2000);
+    uint32_t len     = srsran_resampler_poly_nof_input(q, nof_req);
+    uint32_t nof_out = srsran_resampler_poly_run(q, in, out, len);
+    TESTASSERT(nof_out <= nof_req && nof_req - nof_out < SRSRAN_CEIL(q->L, q->M));
+  }
+
+  // One more input completes them, the surplus outputs are what the radio carries to the next reception
+  for (uint32_t i = 0; i < 100; i++) {
+    uint32_t nof_req = (uint32_t)srsran_random_uniform_int_dist(random_gen, 1, 2000);
+    uint32_t len     = srsran_resampler_poly_nof_input(q, nof_req);
+    if (srsran_resampler_poly_nof_output(q, len) < nof_req) {
+      len++;
+    }
+    uint32_t nof_out = srsran_resampler_poly_run(q, in, out, len);
+    TESTASSERT(nof_out >= nof_req && nof_out - nof_req <= SRSRAN_CEIL(q->L, q->M));
+  }
+  return SRSRAN_SUCCESS;
+}
+
+int main(int argc, char** argv)
+{
+  struct timeval          t[3] = {};
+  srsran_resampler_poly_t q    = {};
+  srsran_resample_arb_t   arb  = {};
+
+  parse_args(argc, argv);
+
+  random_gen = srsran_random_init(0x1234);
+
+  uint32_t max_out    = (buffer_size * L) / M + 1;
+  cf_t*    in         = srsran_vec_cf_malloc(buffer_size);
+  cf_t*    out        = srsran_vec_cf_malloc(max_out + 1);
+  cf_t*    out_blocks = srsran_vec_cf_malloc(max_out + 1);
+
+  if (srsran_resampler_poly_init(&q, L, M)) {
+    return SRSRAN_ERROR;
+  }
+
+  if (test_blocks(&q, in, out, out_blocks) || test_nof_input(&q, in, out)) {
+    return SRSRAN_ERROR;
+  }
+
+  // Benchmark against the scalar arbitrary rate resampler
+  srsran_resampler_poly_reset_state(&q);
+  uint64_t nof_out = 0;
+  gettimeofday(&t[1], NULL);
+  for (uint32_t r = 0; r < repetitions; r++) {
+    nof_out += srsran_resampler_poly_run(&q, in, out, buffer_size);
+  }
+  gettimeofday(&t[2], NULL);
+  get_time_interval(t);
+  double poly_us = t[0].tv_sec * 1e6 + t[0].tv_usec;
+
+  srsran_resample_arb_init(&arb, (float)L / M, false);
+  gettimeofday(&t[1], NULL);
+  for (uint32_t r = 0; r < repetitions; r++) {
+    srsran_resample_arb_compute(&arb, in, out, buffer_size);
+  }
+  gettimeofday(&t[2], NULL);
+  get_time_interval(t);
+  double arb_us = t[0].tv_sec * 1e6 + t[0].tv_usec;
+
+  printf("Done %.1f Msps in, %.1f Msps out per core (resample_arb %.1f Msps in)\n",
+         (double)buffer_size * repetitions / poly_us,
+         (double)nof_out / poly_us,
+         (double)buffer_size * repetitions / arb_us);
+
+  // Pass band tone at 80% of the lowest Nyquist frequency
+  float pass_f   = 0.4f * SRSRAN_MIN(1.0f, (float)L / M);
+  float pass_err = tone_error(&q, in, out, pass_f);
+  printf("L=%d; M=%d; taps=%d; delay=%d; pass-band f=%.3f error=%.1f dB\n",
+         q.L,
+         q.M,
+         q.nof_taps,
+         srsran_resampler_poly_get_delay(&q),
+         pass_f,
+         srsran_convert_power_to_dB(pass_err));
+
+  // A tone half way between the output and input Nyquist frequencies would alias into the output band
+  float stop_err = 0;
+  if (4 * L <= 3 * M) {
+    float stop_f = 0.25f * (1.0f + (float)L / M);
+    stop_err     = tone_error(&q, in, out, stop_f);
+    printf("stop-band f=%.3f power=%.1f dB\n", stop_f, srsran_convert_power_to_dB(stop_err));
+  }
+
+  srsran_resampler_poly_free(&q);
+  srsran_random_free(random_gen);
+  free(in);
+  free(out);
+  free(out_blocks);
+
+  return (pass_err < 1e-5 && stop_err < 1e-5) ? SRSRAN_SUCCESS : SRSRAN_ERROR;
+}
@@ -20,10 +20,49 @@
  */
 
 #include "srsran/phy/scrambling/scrambling.h"
-#include "srsran/phy/utils/bit.h"
+#include "srsran/phy/utils/simd_isa.h"
 #include "srsran/phy/utils/vector.h"
+#include "scrambling_simd.h"
 #include <assert.h>
 
+#ifdef SRSRAN_SIMD_DISPATCH
+
+/*
+ * The kernels are built for SSE4.1, AVX2 and AVX512 (see scrambling_simd.c) and bound at load time, like the vector
+ * kernels in simd_isa.c. The resolvers run before relocations are complete, so they ask the CPU directly.
+ */
+static srsran_simd_isa_t scrambling_simd_isa(void)
+{
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512cd") && __builtin_cpu_supports("avx512bw") &&
+      __builtin_cpu_supports("avx512dq")) {
+    return SRSRAN_SIMD_ISA_AVX512;
+  }
+  if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+    return SRSRAN_SIMD_ISA_AVX2;
+  }
+  return SRSRAN_SIMD_ISA_SSE;
+}
+
+#define SCRAMBLING_SIMD_DISPATCH(NAME)                                                                                 \
+  extern __typeof__(NAME) NAME##_sse, NAME##_avx2, NAME##_avx512;                                                      \
+  static __typeof__(NAME)* NAME##_resolve(void)                                                                        \
+  {                                                                                                                    \
+    switch (scrambling_simd_isa()) {                                                                                   \
+      case SRSRAN_SIMD_ISA_AVX512:                                                                                     \
+        return NAME##_avx512;                                                                                          \
+      case SRSRAN_SIMD_ISA_AVX2:                                                                                       \
+        return NAME##_avx2;                                                                                            \
+      default:                                                                                                         \
+        return NAME##_sse;                                                                                             \
+    }                                                                                                                  \
+  }                                                                                                                    \
+  __typeof__(NAME) NAME __attribute__((ifunc(#NAME "_resolve")));
+
+SRSRAN_SCRAMBLING_SIMD_FOREACH(SCRAMBLING_SIMD_DISPATCH)
+
+#endif /* SRSRAN_SIMD_DISPATCH */
+
 void srsran_scrambling_f(srsran_sequence_t* s, float* data)
 {
   srsran_scrambling_f_offset(s, data, 0, s->cur_len);
@@ -32,7 +71,7 @@ void srsran_scrambling_f(srsran_sequence_t* s, float* data)
 void srsran_scrambling_f_offset(srsran_sequence_t* s, float* data, int offset, int len)
 {
   assert(len + offset <= s->cur_len);
-  srsran_vec_prod_fff(data, &s->c_float[offset], data, len);
+  srsran_scrambling_f_simd(s->c_bytes, offset, data, len);
 }
 
 void srsran_scrambling_s(srsran_sequence_t* s, short* data)
@@ -43,13 +82,13 @@ void srsran_scrambling_s(srsran_sequence_t* s, short* data)
 void srsran_scrambling_s_offset(srsran_sequence_t* s, short* data, int offset, int len)
 {
   assert(len + offset <= s->cur_len);
-  srsran_vec_neg_sss(data, &s->c_short[offset], data, len);
+  srsran_scrambling_s_simd(s->c_bytes, offset, data, len);
 }
 
 void srsran_scrambling_sb_offset(srsran_sequence_t* s, int8_t* data, int offset, int len)
 {
   assert(len + offset <= s->cur_len);
-  srsran_vec_neg_bbb(data, &s->c_char[offset], data, len);
+  srsran_scrambling_sb_simd(s->c_bytes, offset, data, len);
 }
 
 void srsran_scrambling_c(srsran_sequence_t* s, cf_t* data)
@@ -60,12 +99,7 @@ void srsran_scrambling_c(srsran_sequence_t* s, cf_t* data)
 void srsran_scrambling_c_offset(srsran_sequence_t* s, cf_t* data, int offset, int len)
 {
   assert(len + offset <= s->cur_len);
-  srsran_vec_prod_cfc(data, &s->c_float[offset], data, len);
-}
-
-static inline void scrambling_b(uint8_t* c, uint8_t* data, int len)
-{
-  srsran_vec_xor_bbb(c, data, data, len);
+  srsran_scrambling_c_simd(s->c_bytes, offset, data, len);
 }
 
 void srsran_scrambling_b(srsran_sequence_t* s, uint8_t* data)
@@ -75,17 +109,14 @@ void srsran_scrambling_b(srsran_sequence_t* s, uint8_t* data)
 
 void srsran_scrambling_b_offset(srsran_sequence_t* s, uint8_t* data, int offset, int len)
 {
-  scrambling_b(&s->c[offset], data, len);
+  srsran_scrambling_b_simd(s->c_bytes, offset, data, len);
 }
 
 void srsran_scrambling_bytes(srsran_sequence_t* s, uint8_t* data, int len)
 {
-  scrambling_b(s->c_bytes, data, len / 8);
-  // Scramble last bits
+  srsran_vec_xor_bbb(s->c_bytes, data, data, len / 8);
+  // Scramble last bits, they sit in the MSBs of the last byte
   if (len % 8) {
-    uint8_t tmp_bits[8];
-    srsran_bit_unpack_vector(&data[len / 8], tmp_bits, len % 8);
-    scrambling_b(&s->c[8 * (len / 8)], tmp_bits, len % 8);
-    srsran_bit_pack_vector(tmp_bits, &data[len / 8], len % 8);
+    data[len / 8] ^= s->c_bytes[len / 8] & (uint8_t)(0xff << (8 - len % 8));
   }
 }
@@ -0,0 +1,393 @@
+/**
+ * Copyright 2013-2021 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include <string.h>
+
+// With run-time dispatch this file is the SSE4.1 baseline, the wider builds include it with their own suffix
+#if defined(SRSRAN_SIMD_DISPATCH) && !defined(SRSRAN_SIMD_ISA)
+#define SRSRAN_SIMD_ISA sse
+#endif /* defined(SRSRAN_SIMD_DISPATCH) && !defined(SRSRAN_SIMD_ISA) */
+#include "scrambling_simd.h"
+
+#ifdef LV_HAVE_SSE
+#include <immintrin.h>
+#endif /* LV_HAVE_SSE */
+
+/*
+ * Sequences are stored packed, MSB first. The kernels expand the sequence bits into per-element sign masks in
+ * registers, so no expanded sequence is ever read from memory. The elements before the first whole sequence byte are
+ * done one by one, then the vector loops read whole bytes: 64 bits per step with AVX512 mask registers, 32 with AVX2
+ * and 16 with SSE.
+ */
+
+static inline uint8_t scrambling_get_bit(const uint8_t* c, uint32_t i)
+{
+  return (uint8_t)((c[i / 8] >> (7U - i % 8U)) & 1U);
+}
+
+// Number of elements before the first whole sequence byte
+static inline uint32_t scrambling_head(uint32_t offset, uint32_t len)
+{
+  uint32_t head = (8U - offset % 8U) % 8U;
+  return head < len ? head : len;
+}
+
+#ifdef LV_HAVE_AVX512
+// Loads 64 sequence bits as a mask, bit j of the mask for element j
+static inline uint64_t scrambling_mask64(const uint8_t* p)
+{
+  // Byte j of the shuffled word is sequence byte j / 8, tested against bit 7 - j % 8
+  const __m512i shuffle = _mm512_set_epi64(0x0707070707070707,
+                                           0x0606060606060606,
+                                           0x0505050505050505,
+                                           0x0404040404040404,
+                                           0x0303030303030303,
+                                           0x0202020202020202,
+                                           0x0101010101010101,
+                                           0x0000000000000000);
+  const __m512i bits    = _mm512_set1_epi64(0x0102040810204080);
+  int64_t       w;
+  memcpy(&w, p, sizeof(w));
+  return _mm512_test_epi8_mask(_mm512_shuffle_epi8(_mm512_set1_epi64(w), shuffle), bits);
+}
+#endif /* LV_HAVE_AVX512 */
+
+#ifdef LV_HAVE_AVX2
+// Byte j keeps only sequence bit j of the 32 bits at p, in its own position, so it is 0 or a power of two
+static inline __m256i scrambling_bits32_avx2(const uint8_t* p)
+{
+  const __m256i bits    = _mm256_set1_epi64x(0x0102040810204080);
+  const __m256i shuffle = _mm256_setr_epi8(
+      0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 1, 1, 1, 1, 2, 2, 2, 2, 2, 2, 2, 2, 3, 3, 3, 3, 3, 3, 3, 3);
+  int32_t w;
+  memcpy(&w, p, sizeof(w));
+  return _mm256_and_si256(_mm256_shuffle_epi8(_mm256_set1_epi32(w), shuffle), bits);
+}
+#endif /* LV_HAVE_AVX2 */
+
+#ifdef LV_HAVE_SSE
+// Byte j keeps only sequence bit j of the 16 bits at p, in its own position, so it is 0 or a power of two
+static inline __m128i scrambling_bits16_sse(const uint8_t* p)
+{
+  const __m128i bits    = _mm_set1_epi64x(0x0102040810204080);
+  const __m128i shuffle = _mm_setr_epi8(0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 1, 1, 1, 1);
+  uint16_t      w;
+  memcpy(&w, p, sizeof(w));
+  return _mm_and_si128(_mm_shuffle_epi8(_mm_cvtsi32_si128(w), shuffle), bits);
+}
+
+// Byte j is 0x80 where sequence bit j of the 16 bits at p is set, 0 otherwise
+static inline __m128i scrambling_signs16_sse(const uint8_t* p)
+{
+  const __m128i bits = _mm_set1_epi64x(0x0102040810204080);
+  return _mm_and_si128(_mm_cmpeq_epi8(scrambling_bits16_sse(p), bits), _mm_set1_epi8((char)0x80));
+}
+#endif /* LV_HAVE_SSE */
+
+void srsran_scrambling_f_simd(const uint8_t* c, uint32_t offset, float* data, uint32_t len)
+{
+  uint32_t head = scrambling_head(offset, len);
+  for (uint32_t i = 0; i < head; i++) {
+    ((uint32_t*)data)[i] ^= (uint32_t)scrambling_get_bit(c, offset + i) << 31U;
+  }
+  const uint8_t* p = &c[(offset + head) / 8];
+  data += head;
+  len -= head;
+  uint32_t i = 0;
+
+#ifdef LV_HAVE_AVX512
+  const __m512i sign_avx512 = _mm512_set1_epi32(INT32_MIN);
+  for (; i + 64 <= len; i += 64) {
+    uint64_t m = scrambling_mask64(&p[i / 8]);
+    float*   x = &data[i];
+    for (uint32_t k = 0; k < 4; k++) {
+      __m512i v = _mm512_loadu_si512(&x[16 * k]);
+      _mm512_storeu_si512(&x[16 * k], _mm512_mask_xor_epi32(v, (__mmask16)(m >> (16U * k)), v, sign_avx512));
+    }
+  }
+#endif /* LV_HAVE_AVX512 */
+
+#ifdef LV_HAVE_AVX2
+  // Lane j of shifts[k] moves bit 7 - j of byte k of a 32-bit word to the sign
+  const __m256i sign_avx2 = _mm256_set1_epi32(INT32_MIN);
+  const __m256i shifts[4] = {_mm256_setr_epi32(24, 25, 26, 27, 28, 29, 30, 31),
+                             _mm256_setr_epi32(16, 17, 18, 19, 20, 21, 22, 23),
+                             _mm256_setr_epi32(8, 9, 10, 11, 12, 13, 14, 15),
+                             _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7)};
+  for (; i + 32 <= len; i += 32) {
+    int32_t w;
+    memcpy(&w, &p[i / 8], sizeof(w));
+    __m256i b = _mm256_set1_epi32(w);
+    float*  x = &data[i];
+    for (uint32_t k = 0; k < 4; k++) {
+      __m256i m = _mm256_and_si256(_mm256_sllv_epi32(b, shifts[k]), sign_avx2);
+      _mm256_storeu_ps(&x[8 * k], _mm256_xor_ps(_mm256_loadu_ps(&x[8 * k]), _mm256_castsi256_ps(m)));
+    }
+  }
+#endif /* LV_HAVE_AVX2 */
+
+#ifdef LV_HAVE_SSE
+  // Moves sign byte 4k + j to the top byte of float j
+  __m128i shuffle[4];
+  for (uint32_t k = 0; k < 4; k++) {
+    shuffle[k] = _mm_setr_epi8(-1, -1, -1, 4 * k, -1, -1, -1, 4 * k + 1, -1, -1, -1, 4 * k + 2, -1, -1, -1, 4 * k + 3);
+  }
+  for (; i + 16 <= len; i += 16) {
+    __m128i m = scrambling_signs16_sse(&p[i / 8]);
+    float*  x = &data[i];
+    for (uint32_t k = 0; k < 4; k++) {
+      _mm_storeu_ps(&x[4 * k], _mm_xor_ps(_mm_loadu_ps(&x[4 * k]), _mm_castsi128_ps(_mm_shuffle_epi8(m, shuffle[k]))));
+    }
+  }
+#endif /* LV_HAVE_SSE */
+
+  for (; i < len; i++) {
+    ((uint32_t*)data)[i] ^= (uint32_t)scrambling_get_bit(p, i) << 31U;
+  }
+}
+
+void srsran_scrambling_c_simd(const uint8_t* c, uint32_t offset, cf_t* data, uint32_t len)
+{
+  uint32_t head = scrambling_head(offset, len);
+  for (uint32_t i = 0; i < head; i++) {
+    ((uint64_t*)data)[i] ^= (uint64_t)scrambling_get_bit(c, offset + i) * 0x8000000080000000ULL;
+  }
+  const uint8_t* p = &c[(offset + head) / 8];
+  data += head;
+  len -= head;
+  uint32_t i = 0;
+
+#ifdef LV_HAVE_AVX512
+  // One mask bit per complex, on the real and imaginary signs
+  const __m512i sign_avx512 = _mm512_set1_epi32(INT32_MIN);
+  for (; i + 64 <= len; i += 64) {
+    uint64_t m = scrambling_mask64(&p[i / 8]);
+    cf_t*    x = &data[i];
+    for (uint32_t k = 0; k < 8; k++) {
+      __m512i v = _mm512_loadu_si512(&x[8 * k]);
+      _mm512_storeu_si512(&x[8 * k], _mm512_mask_xor_epi64(v, (__mmask8)(m >> (8U * k)), v, sign_avx512));
+    }
+  }
+#endif /* LV_HAVE_AVX512 */
+
+#ifdef LV_HAVE_AVX2
+  // As for floats, each sequence bit goes to the real and imaginary parts
+  const __m256i sign_avx2 = _mm256_set1_epi32(INT32_MIN);
+  const __m256i shifts[8] = {_mm256_setr_epi32(24, 24, 25, 25, 26, 26, 27, 27),
+                             _mm256_setr_epi32(28, 28, 29, 29, 30, 30, 31, 31),
+                             _mm256_setr_epi32(16, 16, 17, 17, 18, 18, 19, 19),
+                             _mm256_setr_epi32(20, 20, 21, 21, 22, 22, 23, 23),
+                             _mm256_setr_epi32(8, 8, 9, 9, 10, 10, 11, 11),
+                             _mm256_setr_epi32(12, 12, 13, 13, 14, 14, 15, 15),
+                             _mm256_setr_epi32(0, 0, 1, 1, 2, 2, 3, 3),
+                             _mm256_setr_epi32(4, 4, 5, 5, 6, 6, 7, 7)};
+  for (; i + 32 <= len; i += 32) {
+    int32_t w;
+    memcpy(&w, &p[i / 8], sizeof(w));
+    __m256i b = _mm256_set1_epi32(w);
+    float*  x = (float*)&data[i];
+    for (uint32_t k = 0; k < 8; k++) {
+      __m256i m = _mm256_and_si256(_mm256_sllv_epi32(b, shifts[k]), sign_avx2);
+      _mm256_storeu_ps(&x[8 * k], _mm256_xor_ps(_mm256_loadu_ps(&x[8 * k]), _mm256_castsi256_ps(m)));
+    }
+  }
+#endif /* LV_HAVE_AVX2 */
+
+#ifdef LV_HAVE_SSE
+  // Moves sign byte 2k + j to the top byte of the real and imaginary parts of complex j
+  __m128i shuffle[8];
+  for (uint32_t k = 0; k < 8; k++) {
+    shuffle[k] = _mm_setr_epi8(-1, -1, -1, 2 * k, -1, -1, -1, 2 * k, -1, -1, -1, 2 * k + 1, -1, -1, -1, 2 * k + 1);
+  }
+  for (; i + 16 <= len; i += 16) {
+    __m128i m = scrambling_signs16_sse(&p[i / 8]);
+    float*  x = (float*)&data[i];
+    for (uint32_t k = 0; k < 8; k++) {
+      _mm_storeu_ps(&x[4 * k], _mm_xor_ps(_mm_loadu_ps(&x[4 * k]), _mm_castsi128_ps(_mm_shuffle_epi8(m, shuffle[k]))));
+    }
+  }
+#endif /* LV_HAVE_SSE */
+
+  for (; i < len; i++) {
+    ((uint64_t*)data)[i] ^= (uint64_t)scrambling_get_bit(p, i) * 0x8000000080000000ULL;
+  }
+}
+
+void srsran_scrambling_s_simd(const uint8_t* c, uint32_t offset, int16_t* data, uint32_t len)
+{
+  // Branchless, the sequence is random
+  uint32_t head = scrambling_head(offset, len);
+  for (uint32_t i = 0; i < head; i++) {
+    int16_t m = (int16_t)-scrambling_get_bit(c, offset + i);
+    data[i]   = (int16_t)((data[i] ^ m) - m);
+  }
+  const uint8_t* p = &c[(offset + head) / 8];
+  data += head;
+  len -= head;
+  uint32_t i = 0;
+
+#ifdef LV_HAVE_AVX512
+  const __m512i zero_avx512 = _mm512_setzero_si512();
+  for (; i + 64 <= len; i += 64) {
+    uint64_t m = scrambling_mask64(&p[i / 8]);
+    int16_t* x = &data[i];
+    for (uint32_t k = 0; k < 2; k++) {
+      __m512i v = _mm512_loadu_si512(&x[32 * k]);
+      _mm512_storeu_si512(&x[32 * k], _mm512_mask_sub_epi16(v, (__mmask32)(m >> (32U * k)), zero_avx512, v));
+    }
+  }
+#endif /* LV_HAVE_AVX512 */
+
+#ifdef LV_HAVE_AVX2
+  // Each 16-bit lane gets a sequence byte in its high half and 1 in its low half. Multiplying lane j by 2^j moves the
+  // sequence bit to the sign and leaves the lane non-zero, so _mm256_sign_epi16 negates exactly where the bit is set.
+  // Byte 2k of the word feeds the low 128-bit half of vector k, byte 2k + 1 the high one.
+  const __m256i ones_avx2  = _mm256_set1_epi8(1);
+  const __m256i mult_avx2  = _mm256_setr_epi16(1, 2, 4, 8, 16, 32, 64, 128, 1, 2, 4, 8, 16, 32, 64, 128);
+  const __m256i shuffle[2] = {
+      _mm256_setr_epi8(8, 0, 8, 0, 8, 0, 8, 0, 8, 0, 8, 0, 8, 0, 8, 0, 8, 1, 8, 1, 8, 1, 8, 1, 8, 1, 8, 1, 8, 1, 8, 1),
+      _mm256_setr_epi8(8, 2, 8, 2, 8, 2, 8, 2, 8, 2, 8, 2, 8, 2, 8, 2, 8, 3, 8, 3, 8, 3, 8, 3, 8, 3, 8, 3, 8, 3, 8, 3)};
+  for (; i + 32 <= len; i += 32) {
+    // Bytes 0 to 3 of each 128-bit half hold the sequence, bytes 8 to 15 hold ones
+    int32_t w;
+    memcpy(&w, &p[i / 8], sizeof(w));
+    __m256i  b = _mm256_unpacklo_epi64(_mm256_set1_epi32(w), ones_avx2);
+    int16_t* x = &data[i];
+    for (uint32_t k = 0; k < 2; k++) {
+      __m256i m = _mm256_mullo_epi16(_mm256_shuffle_epi8(b, shuffle[k]), mult_avx2);
+      _mm256_storeu_si256((__m256i*)&x[16 * k], _mm256_sign_epi16(_mm256_loadu_si256((__m256i*)&x[16 * k]), m));
+    }
+  }
+#endif /* LV_HAVE_AVX2 */
+
+#ifdef LV_HAVE_SSE
+  // Same multiply as above, byte k of the 16 bits feeds vector k
+  const __m128i ones_sse   = _mm_set1_epi8(1);
+  const __m128i mult_sse   = _mm_setr_epi16(1, 2, 4, 8, 16, 32, 64, 128);
+  const __m128i shuffle_lo = _mm_setr_epi8(8, 0, 8, 0, 8, 0, 8, 0, 8, 0, 8, 0, 8, 0, 8, 0);
+  const __m128i shuffle_hi = _mm_setr_epi8(8, 1, 8, 1, 8, 1, 8, 1, 8, 1, 8, 1, 8, 1, 8, 1);
+  for (; i + 16 <= len; i += 16) {
+    uint16_t w;
+    memcpy(&w, &p[i / 8], sizeof(w));
+    __m128i  b  = _mm_unpacklo_epi64(_mm_cvtsi32_si128(w), ones_sse);
+    __m128i* x  = (__m128i*)&data[i];
+    __m128i  m0 = _mm_mullo_epi16(_mm_shuffle_epi8(b, shuffle_lo), mult_sse);
+    __m128i  m1 = _mm_mullo_epi16(_mm_shuffle_epi8(b, shuffle_hi), mult_sse);
+    _mm_storeu_si128(&x[0], _mm_sign_epi16(_mm_loadu_si128(&x[0]), m0));
+    _mm_storeu_si128(&x[1], _mm_sign_epi16(_mm_loadu_si128(&x[1]), m1));
+  }
+#endif /* LV_HAVE_SSE */
+
+  for (; i < len; i++) {
+    int16_t m = (int16_t)-scrambling_get_bit(p, i);
+    data[i]   = (int16_t)((data[i] ^ m) - m);
+  }
+}
+
+/*
+ * For int8 the isolated sequence bits, 0 or a power of two up to 0x80, are turned into signs: adding 0x7f makes a byte
+ * negative exactly where the bit is set, and never zero, which is what _mm_sign_epi8 needs
+ */
+void srsran_scrambling_sb_simd(const uint8_t* c, uint32_t offset, int8_t* data, uint32_t len)
+{
+  uint32_t head = scrambling_head(offset, len);
+  for (uint32_t i = 0; i < head; i++) {
+    int8_t m = (int8_t)-scrambling_get_bit(c, offset + i);
+    data[i]  = (int8_t)((data[i] ^ m) - m);
+  }
+  const uint8_t* p = &c[(offset + head) / 8];
+  data += head;
+  len -= head;
+  uint32_t i = 0;
+
+#ifdef LV_HAVE_AVX512
+  const __m512i zero_avx512 = _mm512_setzero_si512();
+  for (; i + 64 <= len; i += 64) {
+    __m512i v = _mm512_loadu_si512(&data[i]);
+    _mm512_storeu_si512(&data[i], _mm512_mask_sub_epi8(v, scrambling_mask64(&p[i / 8]), zero_avx512, v));
+  }
+#endif /* LV_HAVE_AVX512 */
+
+#ifdef LV_HAVE_AVX2
+  const __m256i sign_avx2 = _mm256_set1_epi8(0x7f);
+  for (; i + 32 <= len; i += 32) {
+    __m256i* x = (__m256i*)&data[i];
+    __m256i  m = _mm256_add_epi8(scrambling_bits32_avx2(&p[i / 8]), sign_avx2);
+    _mm256_storeu_si256(x, _mm256_sign_epi8(_mm256_loadu_si256(x), m));
+  }
+#endif /* LV_HAVE_AVX2 */
+
+#ifdef LV_HAVE_SSE
+  const __m128i sign_sse = _mm_set1_epi8(0x7f);
+  for (; i + 16 <= len; i += 16) {
+    __m128i* x = (__m128i*)&data[i];
+    __m128i  m = _mm_add_epi8(scrambling_bits16_sse(&p[i / 8]), sign_sse);
+    _mm_storeu_si128(x, _mm_sign_epi8(_mm_loadu_si128(x), m));
+  }
+#endif /* LV_HAVE_SSE */
+
+  for (; i < len; i++) {
+    int8_t m = (int8_t)-scrambling_get_bit(p, i);
+    data[i]  = (int8_t)((data[i] ^ m) - m);
+  }
+}
+
+void srsran_scrambling_b_simd(const uint8_t* c, uint32_t offset, uint8_t* data, uint32_t len)
+{
+  uint32_t head = scrambling_head(offset, len);
+  for (uint32_t i = 0; i < head; i++) {
+    data[i] ^= scrambling_get_bit(c, offset + i);
+  }
+  const uint8_t* p = &c[(offset + head) / 8];
+  data += head;
+  len -= head;
+  uint32_t i = 0;
+
+#ifdef LV_HAVE_AVX512
+  const __m512i one_avx512 = _mm512_set1_epi8(1);
+  for (; i + 64 <= len; i += 64) {
+    __m512i m = _mm512_maskz_mov_epi8(scrambling_mask64(&p[i / 8]), one_avx512);
+    _mm512_storeu_si512(&data[i], _mm512_xor_si512(_mm512_loadu_si512(&data[i]), m));
+  }
+#endif /* LV_HAVE_AVX512 */
+
+#ifdef LV_HAVE_AVX2
+  const __m256i one_avx2 = _mm256_set1_epi8(1);
+  for (; i + 32 <= len; i += 32) {
+    __m256i* x = (__m256i*)&data[i];
+    __m256i  m = _mm256_min_epu8(scrambling_bits32_avx2(&p[i / 8]), one_avx2);
+    _mm256_storeu_si256(x, _mm256_xor_si256(_mm256_loadu_si256(x), m));
+  }
+#endif /* LV_HAVE_AVX2 */
+
+#ifdef LV_HAVE_SSE
+  const __m128i one_sse = _mm_set1_epi8(1);
+  for (; i + 16 <= len; i += 16) {
+    __m128i* x = (__m128i*)&data[i];
+    __m128i  m = _mm_min_epu8(scrambling_bits16_sse(&p[i / 8]), one_sse);
+    _mm_storeu_si128(x, _mm_xor_si128(_mm_loadu_si128(x), m));
+  }
+#endif /* LV_HAVE_SSE */
+
+  for (; i < len; i++) {
+    data[i] ^= scrambling_get_bit(p, i);
+  }
+}
@@ -0,0 +1,66 @@
+/**
+ * Copyright 2013-2021 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#ifndef SRSRAN_SCRAMBLING_SIMD_H
+#define SRSRAN_SCRAMBLING_SIMD_H
+
+#include "srsran/config.h"
+#include <stdint.h>
+
+/*
+ * Scrambling kernels on packed sequences. With SRSRAN_SIMD_DISPATCH, scrambling_simd.c is compiled once per ISA and
+ * SRSRAN_SIMD_ISA renames every kernel to <kernel>_<isa>. scrambling.c then binds the plain names at load time, as
+ * simd_isa.c does for the vector kernels.
+ */
+
+/* Applies F to the name of every kernel */
+#define SRSRAN_SCRAMBLING_SIMD_FOREACH(F)                                                                              \
+  F(srsran_scrambling_f_simd)                                                                                          \
+  F(srsran_scrambling_c_simd)                                                                                          \
+  F(srsran_scrambling_s_simd)                                                                                          \
+  F(srsran_scrambling_sb_simd)                                                                                         \
+  F(srsran_scrambling_b_simd)
+
+#ifdef SRSRAN_SIMD_ISA
+
+#define SRSRAN_SCRAMBLING_ISA_NAME_(NAME, ISA) NAME##_##ISA
+#define SRSRAN_SCRAMBLING_ISA_NAME(NAME, ISA) SRSRAN_SCRAMBLING_ISA_NAME_(NAME, ISA)
+
+#define srsran_scrambling_f_simd SRSRAN_SCRAMBLING_ISA_NAME(srsran_scrambling_f_simd, SRSRAN_SIMD_ISA)
+#define srsran_scrambling_c_simd SRSRAN_SCRAMBLING_ISA_NAME(srsran_scrambling_c_simd, SRSRAN_SIMD_ISA)
+#define srsran_scrambling_s_simd SRSRAN_SCRAMBLING_ISA_NAME(srsran_scrambling_s_simd, SRSRAN_SIMD_ISA)
+#define srsran_scrambling_sb_simd SRSRAN_SCRAMBLING_ISA_NAME(srsran_scrambling_sb_simd, SRSRAN_SIMD_ISA)
+#define srsran_scrambling_b_simd SRSRAN_SCRAMBLING_ISA_NAME(srsran_scrambling_b_simd, SRSRAN_SIMD_ISA)
+
+#endif /* SRSRAN_SIMD_ISA */
+
+/* Each kernel applies len bits of the sequence c, starting at bit offset, to data */
+void srsran_scrambling_f_simd(const uint8_t* c, uint32_t offset, float* data, uint32_t len);
+
+void srsran_scrambling_c_simd(const uint8_t* c, uint32_t offset, cf_t* data, uint32_t len);
+
+void srsran_scrambling_s_simd(const uint8_t* c, uint32_t offset, int16_t* data, uint32_t len);
+
+void srsran_scrambling_sb_simd(const uint8_t* c, uint32_t offset, int8_t* data, uint32_t len);
+
+void srsran_scrambling_b_simd(const uint8_t* c, uint32_t offset, uint8_t* data, uint32_t len);
+
+#endif // SRSRAN_SCRAMBLING_SIMD_H
@@ -0,0 +1,317 @@
+/**
+ * Copyright 2013-2021 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <sys/time.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "srsran/common/test_common.h"
+#include "srsran/srsran.h"
+
+// Largest LTE codeword: 100 PRB, 64QAM, 2 layers
+#define MAX_LEN (2 * 100 * 12 * 12 * 6)
+#define NOF_RANDOM_CASES 200
+
+static uint32_t nof_reps = 1000;
+static uint32_t seed     = 0;
+
+static const uint32_t len_list[] = {1, 12, 15, 20, 144, 576, 4608, 28800, MAX_LEN};
+
+void usage(char* prog)
+{
+  printf("Usage: %s [rs]\n", prog);
+  printf("\t-r Number of benchmark repetitions [Default %d]\n", nof_reps);
+  printf("\t-s seed [Default 0=time]\n");
+}
+
+void parse_args(int argc, char** argv)
+{
+  int opt;
+  while ((opt = getopt(argc, argv, "rs")) != -1) {
+    switch (opt) {
+      case 'r':
+        nof_reps = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      case 's':
+        seed = (uint32_t)strtoul(argv[optind], NULL, 0);
+        break;
+      default:
+        usage(argv[0]);
+        exit(-1);
+    }
+  }
+}
+
+// Every scrambling flavour against the bit accessor, at any offset and length
+static int test_scrambling(srsran_sequence_t* seq, uint32_t offset, uint32_t len)
+{
+  static float   f[MAX_LEN];
+  static cf_t    c[MAX_LEN];
+  static int16_t s[MAX_LEN];
+  static int8_t  b[MAX_LEN];
+  static uint8_t u[MAX_LEN];
+  static uint8_t p[MAX_LEN / 8 + 1];
+
+  for (uint32_t i = 0; i < len; i++) {
+    f[i] = (float)(rand() % 256 - 128);
+    c[i] = f[i] + I * (float)(rand() % 256 - 128);
+    s[i] = (int16_t)(rand() % 65536 - 32768);
+    b[i] = (int8_t)(rand() % 256 - 128);
+    u[i] = (uint8_t)(rand() % 2);
+  }
+  float   f0 = f[len / 2];
+  cf_t    c0 = c[len / 2];
+  int16_t s0 = s[len / 2];
+  int8_t  b0 = b[len / 2];
+  uint8_t u0 = u[len / 2];
+
+  srsran_scrambling_f_offset(seq, f, offset, len);
+  srsran_scrambling_c_offset(seq, c, offset, len);
+  srsran_scrambling_s_offset(seq, s, offset, len);
+  srsran_scrambling_sb_offset(seq, b, offset, len);
+  srsran_scrambling_b_offset(seq, u, offset, len);
+
+  uint8_t bit = srsran_sequence_get_bit(seq, offset + len / 2);
+  TESTASSERT(f[len / 2] == (bit ? -f0 : f0));
+  TESTASSERT(c[len / 2] == (bit ? -c0 : c0));
+  TESTASSERT(s[len / 2] == (int16_t)(bit ? -s0 : s0));
+  TESTASSERT(b[len / 2] == (int8_t)(bit ? -b0 : b0));
+  TESTASSERT(u[len / 2] == (u0 ^ bit));
+
+  // Scrambling twice is the identity
+  srsran_scrambling_f_offset(seq, f, offset, len);
+  srsran_scrambling_c_offset(seq, c, offset, len);
+  srsran_scrambling_s_offset(seq, s, offset, len);
+  srsran_scrambling_sb_offset(seq, b, offset, len);
+  srsran_scrambling_b_offset(seq, u, offset, len);
+  TESTASSERT(f[len / 2] == f0 && c[len / 2] == c0 && s[len / 2] == s0 && b[len / 2] == b0 && u[len / 2] == u0);
+
+  // Full check of every element on the unpacked bits
+  srsran_vec_u8_zero(u, len);
+  srsran_scrambling_b_offset(seq, u, offset, len);
+  for (uint32_t i = 0; i < len; i++) {
+    TESTASSERT(u[i] == srsran_sequence_get_bit(seq, offset + i));
+  }
+
+  // Packed bits always start at the beginning of the sequence
+  srsran_vec_u8_zero(p, len / 8 + 1);
+  srsran_scrambling_bytes(seq, p, (int)len);
+  srsran_bit_unpack_vector(p, u, len);
+  for (uint32_t i = 0; i < len; i++) {
+    TESTASSERT(u[i] == srsran_sequence_get_bit(seq, i));
+  }
+
+  return SRSRAN_SUCCESS;
+}
+
+// Every element of the signed types against the sequence sign
+static int test_signs(srsran_sequence_t* seq, uint32_t offset, uint32_t len)
+{
+  static float   f[MAX_LEN];
+  static cf_t    c[MAX_LEN];
+  static int16_t s[MAX_LEN];
+  static int8_t  b[MAX_LEN];
+
+  for (uint32_t i = 0; i < len; i++) {
+    f[i] = 1.0f;
+    c[i] = 1.0f + 2.0f * I;
+    s[i] = 1;
+    b[i] = 1;
+  }
+  srsran_scrambling_f_offset(seq, f, offset, len);
+  srsran_scrambling_c_offset(seq, c, offset, len);
+  srsran_scrambling_s_offset(seq, s, offset, len);
+  srsran_scrambling_sb_offset(seq, b, offset, len);
+
+  for (uint32_t i = 0; i < len; i++) {
+    int sign = srsran_sequence_get_bit(seq, offset + i) ? -1 : +1;
+    TESTASSERT(f[i] == (float)sign);
+    TESTASSERT(c[i] == (float)sign * (1.0f + 2.0f * I));
+    TESTASSERT(s[i] == sign);
+    TESTASSERT(b[i] == sign);
+  }
+
+  return SRSRAN_SUCCESS;
+}
+
+static double elapsed_us(struct timeval* t)
+{
+  get_time_interval(t);
+  return t[0].tv_sec * 1e6 + t[0].tv_usec;
+}
+
+int main(int argc, char** argv)
+{
+  srsran_sequence_t seq = {};
+  struct timeval    t[3];
+
+  parse_args(argc, argv);
+  if (!seed) {
+    seed = time(NULL);
+  }
+  srand(seed);
+
+  uint32_t seq_seed = (uint32_t)rand();
+  TESTASSERT(srsran_sequence_LTE_pr(&seq, MAX_LEN, seq_seed) == SRSRAN_SUCCESS);
+
+  // Short stored sequences (PHICH uses 12 bits) are a prefix of the long one
+  for (uint32_t len = 1; len < 16; len++) {
+    srsran_sequence_t short_seq = {};
+    TESTASSERT(srsran_sequence_LTE_pr(&short_seq, len, seq_seed) == SRSRAN_SUCCESS);
+    for (uint32_t i = 0; i < len; i++) {
+      TESTASSERT(srsran_sequence_get_bit(&short_seq, i) == srsran_sequence_get_bit(&seq, i));
+    }
+    TESTASSERT(test_signs(&short_seq, 0, len) == SRSRAN_SUCCESS);
+    TESTASSERT(test_scrambling(&short_seq, 0, len) == SRSRAN_SUCCESS);
+    srsran_sequence_free(&short_seq);
+  }
+
+  for (uint32_t i = 0; i < sizeof(len_list) / sizeof(len_list[0]); i++) {
+    TESTASSERT(test_signs(&seq, 0, len_list[i]) == SRSRAN_SUCCESS);
+    TESTASSERT(test_scrambling(&seq, 0, len_list[i]) == SRSRAN_SUCCESS);
+  }
+  for (uint32_t i = 0; i < NOF_RANDOM_CASES; i++) {
+    uint32_t len    = 1 + rand() % 4096;
+    uint32_t offset = rand() % (MAX_LEN - len + 1);
+    TESTASSERT(test_signs(&seq, offset, len) == SRSRAN_SUCCESS);
+    TESTASSERT(test_scrambling(&seq, offset, len) == SRSRAN_SUCCESS);
+  }
+
+  // Reference: the sign arrays the sequence used to store, applied with the vector kernels
+  float*   c_float = srsran_vec_f_malloc(MAX_LEN);
+  int16_t* c_short = srsran_vec_i16_malloc(MAX_LEN);
+  int8_t*  c_char  = srsran_vec_i8_malloc(MAX_LEN);
+  float*   f       = srsran_vec_f_malloc(MAX_LEN);
+  cf_t*    c       = srsran_vec_cf_malloc(MAX_LEN);
+  int16_t* s       = srsran_vec_i16_malloc(MAX_LEN);
+  int8_t*  b       = srsran_vec_i8_malloc(MAX_LEN);
+  TESTASSERT(c_float && c_short && c_char && f && c && s && b);
+  for (uint32_t i = 0; i < MAX_LEN; i++) {
+    int sign   = srsran_sequence_get_bit(&seq, i) ? -1 : +1;
+    c_float[i] = (float)sign;
+    c_short[i] = (int16_t)sign;
+    c_char[i]  = (int8_t)sign;
+    f[i]       = (float)(rand() % 256 - 128);
+    c[i]       = f[i];
+    s[i]       = (int16_t)(rand() % 256 - 128);
+    b[i]       = (int8_t)(rand() % 256 - 128);
+  }
+
+  // Unpacked bits, packed bits, float, int16 and int8 signs
+  printf("Sequence memory: %.3f bytes/bit expanded, %.3f bytes/bit packed\n",
+         1.0 + 1.0 / 8 + sizeof(float) + sizeof(int16_t) + sizeof(int8_t),
+         1.0 / 8);
+
+  printf("%8s %12s %12s %12s %12s %12s %12s %12s %12s\n",
+         "len",
+         "f expanded",
+         "f packed",
+         "cf expanded",
+         "cf packed",
+         "s expanded",
+         "s packed",
+         "b expanded",
+         "b packed");
+  for (uint32_t i = 0; i < sizeof(len_list) / sizeof(len_list[0]); i++) {
+    uint32_t len  = len_list[i];
+    uint32_t reps = nof_reps * SRSRAN_MAX(1, 4096 / len);
+    double   us[8];
+
+    gettimeofday(&t[1], NULL);
+    for (uint32_t r = 0; r < reps; r++) {
+      srsran_vec_prod_fff(f, c_float, f, len);
+    }
+    gettimeofday(&t[2], NULL);
+    us[0] = elapsed_us(t);
+
+    gettimeofday(&t[1], NULL);
+    for (uint32_t r = 0; r < reps; r++) {
+      srsran_scrambling_f_offset(&seq, f, 0, len);
+    }
+    gettimeofday(&t[2], NULL);
+    us[1] = elapsed_us(t);
+
+    gettimeofday(&t[1], NULL);
+    for (uint32_t r = 0; r < reps; r++) {
+      srsran_vec_prod_cfc(c, c_float, c, len);
+    }
+    gettimeofday(&t[2], NULL);
+    us[2] = elapsed_us(t);
+
+    gettimeofday(&t[1], NULL);
+    for (uint32_t r = 0; r < reps; r++) {
+      srsran_scrambling_c_offset(&seq, c, 0, len);
+    }
+    gettimeofday(&t[2], NULL);
+    us[3] = elapsed_us(t);
+
+    gettimeofday(&t[1], NULL);
+    for (uint32_t r = 0; r < reps; r++) {
+      srsran_vec_neg_sss(s, c_short, s, len);
+    }
+    gettimeofday(&t[2], NULL);
+    us[4] = elapsed_us(t);
+
+    gettimeofday(&t[1], NULL);
+    for (uint32_t r = 0; r < reps; r++) {
+      srsran_scrambling_s_offset(&seq, s, 0, len);
+    }
+    gettimeofday(&t[2], NULL);
+    us[5] = elapsed_us(t);
+
+    gettimeofday(&t[1], NULL);
+    for (uint32_t r = 0; r < reps; r++) {
+      srsran_vec_neg_bbb(b, c_char, b, len);
+    }
+    gettimeofday(&t[2], NULL);
+    us[6] = elapsed_us(t);
+
+    gettimeofday(&t[1], NULL);
+    for (uint32_t r = 0; r < reps; r++) {
+      srsran_scrambling_sb_offset(&seq, b, 0, len);
+    }
+    gettimeofday(&t[2], NULL);
+    us[7] = elapsed_us(t);
+
+    // Throughput in Msamples/s
+    printf("%8d", len);
+    for (uint32_t k = 0; k < 8; k++) {
+      printf(" %12.1f", (us[k] > 0) ? (double)len * reps / us[k] : 0.0);
+    }
+    printf("\n");
+  }
+
+  free(c_float);
+  free(c_short);
+  free(c_char);
+  free(f);
+  free(c);
+  free(s);
+  free(b);
+  srsran_sequence_free(&seq);
+
+  printf("Ok!\n");
+  return SRSRAN_SUCCESS;
+}
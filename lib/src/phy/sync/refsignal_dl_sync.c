@@ -82,11 +82,35 @@ static inline void refsignal_sf_prepare_correlation(srsran_refsignal_dl_sync_t*
   srsran_dft_run_c(&q->conv_fft_cc.filter_plan, ptr_filt, ptr_filt);
 }
 
-static inline void
-refsignal_sf_correlate(srsran_refsignal_dl_sync_t* q, cf_t* ptr_in, float* peak_value, uint32_t* peak_idx, float* rms)
+static inline uint32_t refsignal_nof_windows(uint32_t nsamples, uint32_t sf_len)
 {
-  // Correlate
-  srsran_corr_fft_cc_run_opt(&q->conv_fft_cc, ptr_in, q->conv_fft_cc.filter_fft, q->correlation);
+  // Limit correlate for a frame or less
+  nsamples = SRSRAN_MIN(nsamples - sf_len, SRSRAN_NOF_SF_X_FRAME * sf_len);
+
+  return SRSRAN_CEIL(nsamples, sf_len);
+}
+
+static inline bool refsignal_buffer_is_loaded(srsran_refsignal_dl_sync_t* q, const cf_t* buffer, uint32_t nsamples)
+{
+  return q->input_fft_buffer != NULL && q->input_fft_buffer == buffer && q->input_fft_nsamples == nsamples &&
+         q->input_fft_sf_len == q->ifft.sf_sz;
+}
+
+static inline void refsignal_sf_correlate(srsran_refsignal_dl_sync_t* q,
+                                          cf_t*                       ptr_in,
+                                          const cf_t*                 input_fft,
+                                          float*                      peak_value,
+                                          uint32_t*                   peak_idx,
+                                          float*                      rms)
+{
+  // Correlate, reuse the loaded input window transform if available
+  if (input_fft != NULL) {
+    srsran_vec_prod_conj_ccc(
+        input_fft, q->conv_fft_cc.filter_fft, q->conv_fft_cc.output_fft, q->conv_fft_cc.output_len);
+    srsran_dft_run_c(&q->conv_fft_cc.output_plan, q->conv_fft_cc.output_fft, q->correlation);
+  } else {
+    srsran_corr_fft_cc_run_opt(&q->conv_fft_cc, ptr_in, q->conv_fft_cc.filter_fft, q->correlation);
+  }
 
   // Find maximum, calculate RMS and peak
   uint32_t imax = srsran_vec_max_abs_ci(q->correlation, q->ifft.sf_sz);
@@ -294,10 +318,62 @@ void srsran_refsignal_dl_sync_free(srsran_refsignal_dl_sync_t* q)
       }
     }
 
+    for (int i = 0; i < SRSRAN_NOF_SF_X_FRAME; i++) {
+      if (q->input_fft[i]) {
+        free(q->input_fft[i]);
+      }
+    }
+
     srsran_conv_fft_cc_free(&q->conv_fft_cc);
   }
 }
 
+int srsran_refsignal_dl_sync_load_buffer(srsran_refsignal_dl_sync_t* q, const cf_t* buffer, uint32_t nsamples)
+{
+  if (q == NULL || buffer == NULL) {
+    return SRSRAN_ERROR_INVALID_INPUTS;
+  }
+
+  uint32_t sf_len = q->ifft.sf_sz;
+
+  // Invalidate any previous buffer
+  srsran_refsignal_dl_sync_unload_buffer(q);
+
+  if (nsamples <= sf_len) {
+    return SRSRAN_ERROR_INVALID_INPUTS;
+  }
+
+  uint32_t nof_windows = refsignal_nof_windows(nsamples, sf_len);
+  for (uint32_t i = 0; i < nof_windows; i++) {
+    // Allocate windows on demand, for the maximum bandwidth
+    if (q->input_fft[i] == NULL) {
+      q->input_fft[i] = srsran_vec_cf_malloc(SRSRAN_SF_LEN_MAX * 2);
+      if (q->input_fft[i] == NULL) {
+        perror("Allocating input_fft\n");
+        return SRSRAN_ERROR;
+      }
+    }
+
+    // Same transform that the correlation would apply on the window
+    srsran_dft_run_c(&q->conv_fft_cc.input_plan, &buffer[i * sf_len], q->input_fft[i]);
+  }
+
+  q->input_fft_buffer   = buffer;
+  q->input_fft_nsamples = nsamples;
+  q->input_fft_sf_len   = sf_len;
+
+  return SRSRAN_SUCCESS;
+}
+
+void srsran_refsignal_dl_sync_unload_buffer(srsran_refsignal_dl_sync_t* q)
+{
+  if (q) {
+    q->input_fft_buffer   = NULL;
+    q->input_fft_nsamples = 0;
+    q->input_fft_sf_len   = 0;
+  }
+}
+
 int srsran_refsignal_dl_sync_find_peak(srsran_refsignal_dl_sync_t* q, cf_t* buffer, uint32_t nsamples)
 {
   int      ret        = SRSRAN_ERROR;
@@ -305,6 +381,7 @@ int srsran_refsignal_dl_sync_find_peak(srsran_refsignal_dl_sync_t* q, cf_t* buff
   int      peak_idx   = 0;
   float    rms_avg    = 0;
   uint32_t sf_len     = q->ifft.sf_sz;
+  bool     loaded     = refsignal_buffer_is_loaded(q, buffer, nsamples);
 
   // Load correlation sequence and convert to frequency domain
   refsignal_sf_prepare_correlation(q);
@@ -313,12 +390,12 @@ int srsran_refsignal_dl_sync_find_peak(srsran_refsignal_dl_sync_t* q, cf_t* buff
   nsamples = SRSRAN_MIN(nsamples - sf_len, SRSRAN_NOF_SF_X_FRAME * sf_len);
 
   // Correlation
-  for (int n = 0; n < nsamples; n += sf_len) {
+  for (int n = 0, w = 0; n < nsamples; n += sf_len, w++) {
     // Correlate, find maximum, calculate RMS and peak
     uint32_t imax = 0;
     float    peak = 0.0f;
     float    rms  = 0.0f;
-    refsignal_sf_correlate(q, &buffer[n], &peak, &imax, &rms);
+    refsignal_sf_correlate(q, &buffer[n], loaded ? q->input_fft[w] : NULL, &peak, &imax, &rms);
 
     rms_avg += rms;
 
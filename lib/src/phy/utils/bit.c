@@ -738,26 +738,42 @@ void srsran_bit_unpack(uint32_t value, uint8_t** bits, int nof_bits)
 
 void srsran_bit_pack_vector(uint8_t* unpacked, uint8_t* packed, int nof_bits)
 {
-  uint32_t i, nbytes;
-  nbytes = nof_bits / 8;
+  uint32_t i = 0, nbytes;
+  nbytes     = nof_bits / 8;
+
+#ifdef LV_HAVE_AVX2
+  // The bytes of every 8 bits are reversed so that the mask holds the first bit in the MSB of each byte
+  const __m256i reverse_avx2 = _mm256_setr_epi8(
+      7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8);
+  for (; i + 4 <= nbytes; i += 4) {
+    __m256i mask = _mm256_cmpgt_epi8(_mm256_loadu_si256((__m256i*)unpacked), _mm256_setzero_si256());
+    unpacked += 32;
+
+    uint32_t word = (uint32_t)_mm256_movemask_epi8(_mm256_shuffle_epi8(mask, reverse_avx2));
+    memcpy(&packed[i], &word, sizeof(uint32_t));
+  }
+#endif /* LV_HAVE_AVX2 */
 
 #ifdef LV_HAVE_SSE
-  for (i = 0; i < nbytes; i++) {
-    // Get 8 Bit
-    __m64 mask = _mm_cmpgt_pi8(*((__m64*)unpacked), _mm_set1_pi8(0));
-    unpacked += 8;
+  const __m128i reverse_sse = _mm_setr_epi8(7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8);
+  for (; i + 2 <= nbytes; i += 2) {
+    __m128i mask = _mm_cmpgt_epi8(_mm_loadu_si128((__m128i*)unpacked), _mm_setzero_si128());
+    unpacked += 16;
 
-    // Reverse
-    mask = _mm_shuffle_pi8(mask, _mm_set_pi8(0, 1, 2, 3, 4, 5, 6, 7));
+    uint16_t word = (uint16_t)_mm_movemask_epi8(_mm_shuffle_epi8(mask, reverse_sse));
+    memcpy(&packed[i], &word, sizeof(uint16_t));
+  }
+  if (i < nbytes) {
+    __m128i mask = _mm_cmpgt_epi8(_mm_loadl_epi64((__m128i*)unpacked), _mm_setzero_si128());
+    unpacked += 8;
 
-    // Get mask and write
-    packed[i] = (uint8_t)_mm_movemask_pi8(mask);
+    packed[i++] = (uint8_t)_mm_movemask_epi8(_mm_shuffle_epi8(mask, reverse_sse));
   }
-#else  /* LV_HAVE_SSE */
-  for (i = 0; i < nbytes; i++) {
+#endif /* LV_HAVE_SSE */
+
+  for (; i < nbytes; i++) {
     packed[i] = srsran_bit_pack(&unpacked, 8);
   }
-#endif /* LV_HAVE_SSE */
 
   if (nof_bits % 8) {
     packed[i] = srsran_bit_pack(&unpacked, nof_bits % 8);
@@ -0,0 +1,330 @@
+/**
+ * Copyright 2013-2021 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include <errno.h>
+#include <linux/futex.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "srsran/phy/utils/debug.h"
+#include "srsran/phy/utils/ringbuffer_spsc.h"
+#include "srsran/phy/utils/vector.h"
+
+static int futex_wait(uint32_t* addr, uint32_t val, const struct timespec* deadline)
+{
+  struct timespec  rel  = {};
+  struct timespec* prel = NULL;
+
+  if (deadline != NULL) {
+    struct timespec now = {};
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    rel.tv_sec  = deadline->tv_sec - now.tv_sec;
+    rel.tv_nsec = deadline->tv_nsec - now.tv_nsec;
+    if (rel.tv_nsec < 0) {
+      rel.tv_sec--;
+      rel.tv_nsec += 1000000000L;
+    }
+    if (rel.tv_sec < 0) {
+      return ETIMEDOUT;
+    }
+    prel = &rel;
+  }
+
+  if (syscall(SYS_futex, addr, FUTEX_WAIT_PRIVATE, val, prel, NULL, 0) < 0 && errno == ETIMEDOUT) {
+    return ETIMEDOUT;
+  }
+  return SRSRAN_SUCCESS;
+}
+
+static void futex_wake(uint32_t* addr)
+{
+  syscall(SYS_futex, addr, FUTEX_WAKE_PRIVATE, INT32_MAX, NULL, NULL, 0);
+}
+
+// Notifies the other side after moving a position, if it announced it is waiting
+static inline void notify(uint32_t* waiting, uint32_t* seq)
+{
+  if (__atomic_load_n(waiting, __ATOMIC_SEQ_CST)) {
+    __atomic_add_fetch(seq, 1, __ATOMIC_SEQ_CST);
+    futex_wake(seq);
+  }
+}
+
+static inline bool is_active(srsran_ringbuffer_spsc_t* q)
+{
+  return __atomic_load_n(&q->active, __ATOMIC_SEQ_CST);
+}
+
+static inline uint64_t readable(srsran_ringbuffer_spsc_t* q)
+{
+  return __atomic_load_n(&q->wpos, __ATOMIC_SEQ_CST) - __atomic_load_n(&q->rpos, __ATOMIC_SEQ_CST);
+}
+
+static inline uint64_t writable(srsran_ringbuffer_spsc_t* q)
+{
+  return q->capacity - readable(q);
+}
+
+/*
+ * Waits until cond(q) >= nof_bytes. The waiting flag is raised before checking the condition a last time, so either
+ * this side sees the new position or the other side sees the flag and bumps the futex word.
+ */
+static int wait_for(srsran_ringbuffer_spsc_t* q,
+                    uint64_t (*cond)(srsran_ringbuffer_spsc_t*),
+                    uint64_t  nof_bytes,
+                    uint32_t* waiting,
+                    uint32_t* seq,
+                    int32_t   timeout_ms)
+{
+  struct timespec  deadline  = {};
+  struct timespec* pdeadline = NULL;
+
+  if (timeout_ms > 0) {
+    clock_gettime(CLOCK_MONOTONIC, &deadline);
+    deadline.tv_sec += timeout_ms / 1000;
+    deadline.tv_nsec += (timeout_ms % 1000) * 1000000L;
+    if (deadline.tv_nsec >= 1000000000L) {
+      deadline.tv_sec++;
+      deadline.tv_nsec -= 1000000000L;
+    }
+    pdeadline = &deadline;
+  }
+
+  while (cond(q) < nof_bytes) {
+    uint32_t val = __atomic_load_n(seq, __ATOMIC_SEQ_CST);
+    __atomic_store_n(waiting, 1, __ATOMIC_SEQ_CST);
+    if (!is_active(q)) {
+      __atomic_store_n(waiting, 0, __ATOMIC_SEQ_CST);
+      return SRSRAN_SUCCESS;
+    }
+    if (cond(q) >= nof_bytes) {
+      __atomic_store_n(waiting, 0, __ATOMIC_SEQ_CST);
+      break;
+    }
+    int ret = futex_wait(seq, val, pdeadline);
+    __atomic_store_n(waiting, 0, __ATOMIC_SEQ_CST);
+    if (ret == ETIMEDOUT) {
+      return SRSRAN_ERROR_TIMEOUT;
+    }
+  }
+
+  return is_active(q) ? (int)nof_bytes : SRSRAN_SUCCESS;
+}
+
+static int map_buffer(srsran_ringbuffer_spsc_t* q, int capacity)
+{
+  long     page_size = sysconf(_SC_PAGESIZE);
+  uint32_t size      = (uint32_t)((capacity + page_size - 1) / page_size * page_size);
+
+  // Back the buffer with an anonymous file so it can be mapped twice, one copy right after the other
+  int fd = (int)syscall(SYS_memfd_create, "srsran_ringbuffer", 0);
+  if (fd < 0) {
+    ERROR("Error creating ring buffer memory: %s", strerror(errno));
+    return SRSRAN_ERROR;
+  }
+  if (ftruncate(fd, size) < 0) {
+    ERROR("Error sizing ring buffer memory: %s", strerror(errno));
+    close(fd);
+    return SRSRAN_ERROR;
+  }
+
+  uint8_t* addr = mmap(NULL, 2 * (size_t)size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (addr == MAP_FAILED) {
+    ERROR("Error reserving ring buffer address space: %s", strerror(errno));
+    close(fd);
+    return SRSRAN_ERROR;
+  }
+  if (mmap(addr, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0) == MAP_FAILED ||
+      mmap(addr + size, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0) == MAP_FAILED) {
+    ERROR("Error mapping ring buffer memory: %s", strerror(errno));
+    munmap(addr, 2 * (size_t)size);
+    close(fd);
+    return SRSRAN_ERROR;
+  }
+  close(fd);
+
+  q->buffer   = addr;
+  q->capacity = size;
+  return SRSRAN_SUCCESS;
+}
+
+static void unmap_buffer(srsran_ringbuffer_spsc_t* q)
+{
+  if (q->buffer) {
+    munmap(q->buffer, 2 * (size_t)q->capacity);
+    q->buffer = NULL;
+  }
+  q->capacity = 0;
+}
+
+int srsran_ringbuffer_spsc_init(srsran_ringbuffer_spsc_t* q, int capacity)
+{
+  if (q == NULL || capacity <= 0) {
+    return SRSRAN_ERROR_INVALID_INPUTS;
+  }
+
+  memset(q, 0, sizeof(srsran_ringbuffer_spsc_t));
+  if (map_buffer(q, capacity) < SRSRAN_SUCCESS) {
+    return SRSRAN_ERROR;
+  }
+  q->active = true;
+
+  return SRSRAN_SUCCESS;
+}
+
+void srsran_ringbuffer_spsc_free(srsran_ringbuffer_spsc_t* q)
+{
+  if (q) {
+    srsran_ringbuffer_spsc_stop(q);
+    unmap_buffer(q);
+  }
+}
+
+void srsran_ringbuffer_spsc_reset(srsran_ringbuffer_spsc_t* q)
+{
+  __atomic_store_n(&q->wpos, 0, __ATOMIC_SEQ_CST);
+  __atomic_store_n(&q->rpos, 0, __ATOMIC_SEQ_CST);
+}
+
+int srsran_ringbuffer_spsc_resize(srsran_ringbuffer_spsc_t* q, int capacity)
+{
+  if (q == NULL || capacity <= 0) {
+    return SRSRAN_ERROR_INVALID_INPUTS;
+  }
+
+  unmap_buffer(q);
+  srsran_ringbuffer_spsc_reset(q);
+  if (map_buffer(q, capacity) < SRSRAN_SUCCESS) {
+    return SRSRAN_ERROR;
+  }
+  q->active = true;
+
+  return SRSRAN_SUCCESS;
+}
+
+int srsran_ringbuffer_spsc_status(srsran_ringbuffer_spsc_t* q)
+{
+  return (int)readable(q);
+}
+
+int srsran_ringbuffer_spsc_space(srsran_ringbuffer_spsc_t* q)
+{
+  return (int)writable(q);
+}
+
+void* srsran_ringbuffer_spsc_write_begin(srsran_ringbuffer_spsc_t* q, int nof_bytes, int32_t timeout_ms)
+{
+  if (q == NULL || q->buffer == NULL || nof_bytes < 0 || nof_bytes > (int)q->capacity) {
+    return NULL;
+  }
+
+  if (wait_for(q, writable, nof_bytes, &q->writer_waiting, &q->read_seq, timeout_ms) != nof_bytes) {
+    return NULL;
+  }
+
+  return &q->buffer[q->wpos % q->capacity];
+}
+
+void srsran_ringbuffer_spsc_write_commit(srsran_ringbuffer_spsc_t* q, int nof_bytes)
+{
+  __atomic_store_n(&q->wpos, q->wpos + nof_bytes, __ATOMIC_SEQ_CST);
+  notify(&q->reader_waiting, &q->write_seq);
+}
+
+int srsran_ringbuffer_spsc_write(srsran_ringbuffer_spsc_t* q, const void* ptr, int nof_bytes, int32_t timeout_ms)
+{
+  if (q == NULL || q->buffer == NULL || nof_bytes < 0) {
+    ERROR("Invalid inputs");
+    return SRSRAN_ERROR_INVALID_INPUTS;
+  }
+
+  int w_bytes = nof_bytes;
+  if (timeout_ms == 0) {
+    // Do not wait, write what fits
+    w_bytes = SRSRAN_MIN(nof_bytes, (int)writable(q));
+    if (w_bytes < nof_bytes) {
+      ERROR("Buffer overrun: lost %d bytes", nof_bytes - w_bytes);
+    }
+  } else if (nof_bytes > (int)q->capacity) {
+    return SRSRAN_ERROR_INVALID_INPUTS;
+  } else {
+    int ret = wait_for(q, writable, nof_bytes, &q->writer_waiting, &q->read_seq, timeout_ms);
+    if (ret != nof_bytes) {
+      return ret;
+    }
+  }
+  if (!is_active(q)) {
+    return SRSRAN_SUCCESS;
+  }
+
+  uint8_t* dst = &q->buffer[q->wpos % q->capacity];
+  if (ptr != NULL) {
+    memcpy(dst, ptr, w_bytes);
+  } else {
+    memset(dst, 0, w_bytes);
+  }
+  srsran_ringbuffer_spsc_write_commit(q, w_bytes);
+
+  return w_bytes;
+}
+
+int srsran_ringbuffer_spsc_peek(srsran_ringbuffer_spsc_t* q, void** p, int nof_bytes, int32_t timeout_ms)
+{
+  if (q == NULL || q->buffer == NULL || p == NULL || nof_bytes < 0 || nof_bytes > (int)q->capacity) {
+    ERROR("Invalid inputs");
+    return SRSRAN_ERROR_INVALID_INPUTS;
+  }
+
+  int ret = wait_for(q, readable, nof_bytes, &q->reader_waiting, &q->write_seq, timeout_ms);
+  if (ret == nof_bytes) {
+    *p = &q->buffer[q->rpos % q->capacity];
+  }
+  return ret;
+}
+
+void srsran_ringbuffer_spsc_release(srsran_ringbuffer_spsc_t* q, int nof_bytes)
+{
+  __atomic_store_n(&q->rpos, q->rpos + nof_bytes, __ATOMIC_SEQ_CST);
+  notify(&q->writer_waiting, &q->read_seq);
+}
+
+int srsran_ringbuffer_spsc_read(srsran_ringbuffer_spsc_t* q, void* ptr, int nof_bytes, int32_t timeout_ms)
+{
+  void* src = NULL;
+  int   ret = srsran_ringbuffer_spsc_peek(q, &src, nof_bytes, timeout_ms);
+  if (ret == nof_bytes && nof_bytes > 0) {
+    memcpy(ptr, src, nof_bytes);
+    srsran_ringbuffer_spsc_release(q, nof_bytes);
+  }
+  return ret;
+}
+
+void srsran_ringbuffer_spsc_stop(srsran_ringbuffer_spsc_t* q)
+{
+  __atomic_store_n(&q->active, false, __ATOMIC_SEQ_CST);
+  __atomic_add_fetch(&q->write_seq, 1, __ATOMIC_SEQ_CST);
+  __atomic_add_fetch(&q->read_seq, 1, __ATOMIC_SEQ_CST);
+  futex_wake(&q->write_seq);
+  futex_wake(&q->read_seq);
+}
@@ -0,0 +1,139 @@
+/**
+ * Copyright 2013-2021 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "srsran/phy/utils/simd_isa.h"
+#include "srsran/phy/utils/vector_simd.h"
+
+#include "vector_simd_isa.h"
+
+static const char* simd_isa_names[SRSRAN_SIMD_ISA_NOF] = {"none", "neon", "sse4.1", "avx", "avx2", "avx512"};
+
+// Kernels the library has been built with
+static bool simd_isa_built(srsran_simd_isa_t isa)
+{
+  switch (isa) {
+    case SRSRAN_SIMD_ISA_NONE:
+      return true;
+#ifdef HAVE_NEON
+    case SRSRAN_SIMD_ISA_NEON:
+      return true;
+#endif /* HAVE_NEON */
+#ifdef LV_HAVE_SSE
+    case SRSRAN_SIMD_ISA_SSE:
+      return true;
+#endif /* LV_HAVE_SSE */
+#if defined(SRSRAN_SIMD_DISPATCH) || defined(LV_HAVE_AVX)
+    case SRSRAN_SIMD_ISA_AVX:
+      return true;
+#endif /* SRSRAN_SIMD_DISPATCH || LV_HAVE_AVX */
+#if defined(SRSRAN_SIMD_DISPATCH) || defined(LV_HAVE_AVX2)
+    case SRSRAN_SIMD_ISA_AVX2:
+      return true;
+#endif /* SRSRAN_SIMD_DISPATCH || LV_HAVE_AVX2 */
+#if defined(SRSRAN_SIMD_DISPATCH) || defined(LV_HAVE_AVX512)
+    case SRSRAN_SIMD_ISA_AVX512:
+      return true;
+#endif /* SRSRAN_SIMD_DISPATCH || LV_HAVE_AVX512 */
+    default:
+      return false;
+  }
+}
+
+// Instruction sets the CPU and the OS support. It must not call anything outside this file, it runs from the ifunc
+// resolvers before relocations are complete
+static bool simd_isa_cpu_supports(srsran_simd_isa_t isa)
+{
+#if defined(__x86_64__) || defined(__i386__)
+  __builtin_cpu_init();
+  switch (isa) {
+    case SRSRAN_SIMD_ISA_NONE:
+      return true;
+    case SRSRAN_SIMD_ISA_SSE:
+      return __builtin_cpu_supports("sse4.1");
+    case SRSRAN_SIMD_ISA_AVX:
+      return __builtin_cpu_supports("avx");
+    case SRSRAN_SIMD_ISA_AVX2:
+      return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+    case SRSRAN_SIMD_ISA_AVX512:
+      return __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512cd") &&
+             __builtin_cpu_supports("avx512bw") && __builtin_cpu_supports("avx512dq");
+    default:
+      return false;
+  }
+#else  /* defined(__x86_64__) || defined(__i386__) */
+  return isa == SRSRAN_SIMD_ISA_NONE || isa == SRSRAN_SIMD_ISA_NEON;
+#endif /* defined(__x86_64__) || defined(__i386__) */
+}
+
+static srsran_simd_isa_t simd_isa_best(void)
+{
+  for (int isa = SRSRAN_SIMD_ISA_NOF - 1; isa > SRSRAN_SIMD_ISA_NONE; isa--) {
+    if (simd_isa_built((srsran_simd_isa_t)isa) && simd_isa_cpu_supports((srsran_simd_isa_t)isa)) {
+      return (srsran_simd_isa_t)isa;
+    }
+  }
+  return SRSRAN_SIMD_ISA_NONE;
+}
+
+bool srsran_simd_isa_available(srsran_simd_isa_t isa)
+{
+  return simd_isa_built(isa) && simd_isa_cpu_supports(isa);
+}
+
+srsran_simd_isa_t srsran_vec_simd_isa(void)
+{
+  return simd_isa_best();
+}
+
+const char* srsran_simd_isa_to_str(srsran_simd_isa_t isa)
+{
+  if (isa >= SRSRAN_SIMD_ISA_NOF) {
+    return "unknown";
+  }
+  return simd_isa_names[isa];
+}
+
+#ifdef SRSRAN_SIMD_DISPATCH
+
+/*
+ * Every kernel in vector_simd.h is an ifunc. The dynamic loader calls its resolver once, when the library is loaded,
+ * and binds the symbol to the implementation for the best ISA, so calls cost the same as any other external call.
+ */
+#define SIMD_ISA_DISPATCH(NAME)                                                                                        \
+  extern __typeof__(NAME) NAME##_sse, NAME##_avx, NAME##_avx2, NAME##_avx512;                                          \
+  static __typeof__(NAME)* NAME##_resolve(void)                                                                        \
+  {                                                                                                                    \
+    switch (simd_isa_best()) {                                                                                         \
+      case SRSRAN_SIMD_ISA_AVX512:                                                                                     \
+        return NAME##_avx512;                                                                                          \
+      case SRSRAN_SIMD_ISA_AVX2:                                                                                       \
+        return NAME##_avx2;                                                                                            \
+      case SRSRAN_SIMD_ISA_AVX:                                                                                        \
+        return NAME##_avx;                                                                                             \
+      default:                                                                                                         \
+        return NAME##_sse;                                                                                             \
+    }                                                                                                                  \
+  }                                                                                                                    \
+  __typeof__(NAME) NAME __attribute__((ifunc(#NAME "_resolve")));
+
+SRSRAN_VEC_SIMD_FOREACH(SIMD_ISA_DISPATCH)
+
+#endif /* SRSRAN_SIMD_DISPATCH */
@@ -0,0 +1,299 @@
+/**
+ * Copyright 2013-2021 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "srsran/common/test_common.h"
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+#include "srsran/phy/utils/debug.h"
+#include "srsran/phy/utils/ringbuffer.h"
+#include "srsran/phy/utils/ringbuffer_spsc.h"
+#include "srsran/phy/utils/vector.h"
+
+struct thread_args_t {
+  int                       len;
+  uint8_t*                  in;
+  uint8_t*                  out;
+  srsran_ringbuffer_t*      buf;
+  srsran_ringbuffer_spsc_t* spsc;
+  bool                      zero_copy;
+  int                       res;
+};
+
+int N = 23040 * 8; // One subframe of complex float samples at 23.04 MHz
+int M = 5000;
+int C = 4;
+
+void usage(char* prog)
+{
+  printf("Usage: %s\n", prog);
+  printf("\t-N size of blocks in bytes [Default %d]\n", N);
+  printf("\t-M Number of blocks [Default %d]\n", M);
+  printf("\t-C Capacity of the buffers in blocks [Default %d]\n", C);
+}
+
+void parse_args(int argc, char** argv)
+{
+  int opt;
+  while ((opt = getopt(argc, argv, "NMC")) != -1) {
+    switch (opt) {
+      case 'N':
+        N = (int)strtol(argv[optind], NULL, 10);
+        break;
+      case 'M':
+        M = (int)strtol(argv[optind], NULL, 10);
+        break;
+      case 'C':
+        C = (int)strtol(argv[optind], NULL, 10);
+        break;
+      default:
+        usage(argv[0]);
+        exit(-1);
+    }
+  }
+}
+
+int test_wrap_around(srsran_ringbuffer_spsc_t* q, uint8_t* in, uint8_t* out)
+{
+  int capacity = (int)q->capacity;
+
+  // Move the positions close to the end of the buffer
+  int offset = capacity - 100;
+  TESTASSERT(srsran_ringbuffer_spsc_write(q, in, offset, -1) == offset);
+  TESTASSERT(srsran_ringbuffer_spsc_read(q, out, offset, -1) == offset);
+  TESTASSERT(!memcmp(in, out, offset));
+
+  // A full buffer crossing the end is seen as a single contiguous region
+  TESTASSERT(srsran_ringbuffer_spsc_write(q, in, capacity, -1) == capacity);
+  TESTASSERT(srsran_ringbuffer_spsc_status(q) == capacity);
+  TESTASSERT(srsran_ringbuffer_spsc_space(q) == 0);
+  void* ptr = NULL;
+  TESTASSERT(srsran_ringbuffer_spsc_peek(q, &ptr, capacity, -1) == capacity);
+  TESTASSERT(!memcmp(in, ptr, capacity));
+  srsran_ringbuffer_spsc_release(q, capacity);
+  TESTASSERT(srsran_ringbuffer_spsc_status(q) == 0);
+
+  // Writing in place across the end
+  uint8_t* dst = srsran_ringbuffer_spsc_write_begin(q, 300, -1);
+  TESTASSERT(dst != NULL);
+  memcpy(dst, in, 300);
+  srsran_ringbuffer_spsc_write_commit(q, 300);
+  TESTASSERT(srsran_ringbuffer_spsc_read(q, out, 300, -1) == 300);
+  TESTASSERT(!memcmp(in, out, 300));
+
+  // Writing zeros
+  TESTASSERT(srsran_ringbuffer_spsc_write(q, NULL, 200, -1) == 200);
+  TESTASSERT(srsran_ringbuffer_spsc_read(q, out, 200, -1) == 200);
+  for (int i = 0; i < 200; i++) {
+    TESTASSERT(out[i] == 0);
+  }
+  return 0;
+}
+
+int test_timeout(srsran_ringbuffer_spsc_t* q, uint8_t* in, uint8_t* out)
+{
+  int capacity = (int)q->capacity;
+
+  // Without timeout the write drops what does not fit
+  TESTASSERT(srsran_ringbuffer_spsc_write(q, in, capacity - 10, 0) == capacity - 10);
+  TESTASSERT(srsran_ringbuffer_spsc_write(q, in, 20, 0) == 10);
+  TESTASSERT(srsran_ringbuffer_spsc_write(q, in, 20, 10) == SRSRAN_ERROR_TIMEOUT);
+  srsran_ringbuffer_spsc_reset(q);
+  TESTASSERT(srsran_ringbuffer_spsc_status(q) == 0);
+
+  // Reading times out when there is not enough data, and leaves the data in place
+  TESTASSERT(srsran_ringbuffer_spsc_write(q, in, 10, -1) == 10);
+  TESTASSERT(srsran_ringbuffer_spsc_read(q, out, 20, 10) == SRSRAN_ERROR_TIMEOUT);
+  TESTASSERT(srsran_ringbuffer_spsc_status(q) == 10);
+  return 0;
+}
+
+void* blocked_read_thread(void* args_)
+{
+  struct thread_args_t* args = (struct thread_args_t*)args_;
+  args->res                  = srsran_ringbuffer_spsc_read(args->spsc, args->out, args->len, -1);
+  return NULL;
+}
+
+int test_stop(struct thread_args_t* args)
+{
+  // Stopping wakes up a reader blocked on an empty buffer
+  pthread_t thread;
+  args->res = -1;
+  if (pthread_create(&thread, NULL, blocked_read_thread, args)) {
+    fprintf(stderr, "Error creating thread\n");
+    return SRSRAN_ERROR;
+  }
+  usleep(10000);
+  srsran_ringbuffer_spsc_stop(args->spsc);
+  if (pthread_join(thread, NULL)) {
+    fprintf(stderr, "Error joining thread\n");
+    return SRSRAN_ERROR;
+  }
+  TESTASSERT(args->res == 0);
+  return SRSRAN_SUCCESS;
+}
+
+void* write_thread(void* args_)
+{
+  struct thread_args_t* args = (struct thread_args_t*)args_;
+  for (int i = 0; i < M; i++) {
+    args->in[0] = (uint8_t)i;
+    if (args->spsc == NULL) {
+      if (srsran_ringbuffer_write_block(args->buf, args->in, args->len) != args->len) {
+        args->res = SRSRAN_ERROR;
+      }
+    } else if (args->zero_copy) {
+      uint8_t* dst = srsran_ringbuffer_spsc_write_begin(args->spsc, args->len, -1);
+      memcpy(dst, args->in, args->len);
+      srsran_ringbuffer_spsc_write_commit(args->spsc, args->len);
+    } else if (srsran_ringbuffer_spsc_write(args->spsc, args->in, args->len, -1) != args->len) {
+      args->res = SRSRAN_ERROR;
+    }
+  }
+  return NULL;
+}
+
+void* read_thread(void* args_)
+{
+  struct thread_args_t* args = (struct thread_args_t*)args_;
+  for (int i = 0; i < M; i++) {
+    uint8_t* block = args->out;
+    int      res   = 0;
+    if (args->spsc == NULL) {
+      res = srsran_ringbuffer_read(args->buf, block, args->len);
+    } else if (args->zero_copy) {
+      res = srsran_ringbuffer_spsc_peek(args->spsc, (void**)&block, args->len, -1);
+    } else {
+      res = srsran_ringbuffer_spsc_read(args->spsc, block, args->len, -1);
+    }
+    if (res != args->len || block[0] != (uint8_t)i || block[args->len - 1] != args->in[args->len - 1]) {
+      args->res = SRSRAN_ERROR;
+    }
+    if (args->spsc != NULL && args->zero_copy) {
+      srsran_ringbuffer_spsc_release(args->spsc, args->len);
+    }
+  }
+  return NULL;
+}
+
+// Streams M blocks from a writer to a reader thread, returns the throughput in MB/s or a negative value on error
+double threaded_throughput_test(struct thread_args_t* args)
+{
+  pthread_t      threads[2];
+  struct timeval t[3] = {};
+
+  args->res = SRSRAN_SUCCESS;
+  gettimeofday(&t[1], NULL);
+  if (pthread_create(&threads[0], NULL, write_thread, args) || pthread_create(&threads[1], NULL, read_thread, args)) {
+    fprintf(stderr, "Error creating thread\n");
+    return SRSRAN_ERROR;
+  }
+  for (int i = 0; i < 2; i++) {
+    if (pthread_join(threads[i], NULL)) {
+      fprintf(stderr, "Error joining thread\n");
+      return SRSRAN_ERROR;
+    }
+  }
+  gettimeofday(&t[2], NULL);
+  get_time_interval(t);
+
+  if (args->res < 0) {
+    return SRSRAN_ERROR;
+  }
+  return (double)args->len * M / (t[0].tv_sec * 1e6 + t[0].tv_usec);
+}
+
+int main(int argc, char** argv)
+{
+  int ret = SRSRAN_SUCCESS;
+  parse_args(argc, argv);
+  struct thread_args_t thread_in = {};
+
+  // The capacity is rounded up to whole pages
+  srsran_ringbuffer_spsc_t spsc;
+  srsran_ringbuffer_t      ring_buf;
+  if (srsran_ringbuffer_spsc_init(&spsc, N * C) || srsran_ringbuffer_init(&ring_buf, N * C)) {
+    printf("Error initialising the ring buffers\n");
+    return SRSRAN_ERROR;
+  }
+  TESTASSERT((int)spsc.capacity >= N * C && spsc.capacity % sysconf(_SC_PAGESIZE) == 0);
+  TESTASSERT(srsran_ringbuffer_spsc_space(&spsc) == (int)spsc.capacity);
+
+  uint8_t* in  = srsran_vec_u8_malloc(spsc.capacity);
+  uint8_t* out = srsran_vec_u8_malloc(spsc.capacity);
+  for (int i = 0; i < (int)spsc.capacity; i++) {
+    in[i] = (uint8_t)(i * 7 + 3);
+  }
+
+  thread_in.in  = in;
+  thread_in.out = out;
+  thread_in.buf = &ring_buf;
+  thread_in.len = N;
+
+  if (test_wrap_around(&spsc, in, out) < 0) {
+    printf("Wrap-around test failed\n");
+    ret = SRSRAN_ERROR;
+  }
+  srsran_ringbuffer_spsc_reset(&spsc);
+
+  if (test_timeout(&spsc, in, out) < 0) {
+    printf("Timeout test failed\n");
+    ret = SRSRAN_ERROR;
+  }
+  srsran_ringbuffer_spsc_reset(&spsc);
+
+  double mutex_mbps = threaded_throughput_test(&thread_in);
+  thread_in.spsc    = &spsc;
+  double spsc_mbps  = threaded_throughput_test(&thread_in);
+  srsran_ringbuffer_spsc_reset(&spsc);
+  thread_in.zero_copy   = true;
+  double zero_copy_mbps = threaded_throughput_test(&thread_in);
+  if (mutex_mbps < 0 || spsc_mbps < 0 || zero_copy_mbps < 0) {
+    printf("Error in multithreaded ringbuffer test\n");
+    ret = SRSRAN_ERROR;
+  } else {
+    printf("N=%d; M=%d; mutex=%.0f MB/s; spsc=%.0f MB/s; spsc zero-copy read=%.0f MB/s;\n",
+           N,
+           M,
+           mutex_mbps,
+           spsc_mbps,
+           zero_copy_mbps);
+  }
+  srsran_ringbuffer_spsc_reset(&spsc);
+
+  if (test_stop(&thread_in) < 0) {
+    printf("Stop test failed\n");
+    ret = SRSRAN_ERROR;
+  }
+
+  srsran_ringbuffer_stop(&ring_buf);
+  srsran_ringbuffer_free(&ring_buf);
+  srsran_ringbuffer_spsc_free(&spsc);
+  free(in);
+  free(out);
+  printf("Done\n");
+  return ret;
+}
@@ -0,0 +1,274 @@
+/**
+ * Copyright 2013-2021 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "srsran/phy/utils/random.h"
+#include "srsran/phy/utils/simd_isa.h"
+#include "srsran/phy/utils/vector_simd.h"
+#include "srsran/srsran.h"
+#include <stdlib.h>
+#include <sys/time.h>
+
+/*
+ * Runs a set of vector kernels with every ISA they have been built for and the CPU supports, checks that all of them
+ * match the SSE4.1 baseline and prints their throughput. Only built with ENABLE_SIMD_DISPATCH.
+ */
+
+#define MAX_ERROR (1e-4f)
+#define MAX_BLOCK_SIZE (1024 * 32)
+#define MAX_BLOCKS (16)
+
+static uint32_t        block_size      = 0;
+static uint32_t        nof_repetitions = 1;
+static srsran_random_t random_gen      = NULL;
+
+static cf_t*    x_cf = NULL;
+static cf_t*    y_cf = NULL;
+static cf_t*    z_cf = NULL;
+static float*   x_f  = NULL;
+static float*   z_f  = NULL;
+static int16_t* x_s  = NULL;
+static int16_t* y_s  = NULL;
+static int16_t* z_s  = NULL;
+
+#define KERNEL_ISA_TABLE(NAME)                                                                                         \
+  extern __typeof__(NAME) NAME##_sse, NAME##_avx, NAME##_avx2, NAME##_avx512;                                          \
+  static __typeof__(NAME)* NAME##_isa[SRSRAN_SIMD_ISA_NOF] = {                                                         \
+      [SRSRAN_SIMD_ISA_SSE]    = NAME##_sse,                                                                           \
+      [SRSRAN_SIMD_ISA_AVX]    = NAME##_avx,                                                                           \
+      [SRSRAN_SIMD_ISA_AVX2]   = NAME##_avx2,                                                                          \
+      [SRSRAN_SIMD_ISA_AVX512] = NAME##_avx512};
+
+KERNEL_ISA_TABLE(srsran_vec_prod_ccc_simd)
+KERNEL_ISA_TABLE(srsran_vec_prod_conj_ccc_simd)
+KERNEL_ISA_TABLE(srsran_vec_sc_prod_cfc_simd)
+KERNEL_ISA_TABLE(srsran_vec_dot_prod_ccc_simd)
+KERNEL_ISA_TABLE(srsran_vec_abs_square_cf_simd)
+KERNEL_ISA_TABLE(srsran_vec_max_fi_simd)
+KERNEL_ISA_TABLE(srsran_vec_convert_fi_simd)
+KERNEL_ISA_TABLE(srsran_vec_sum_sss_simd)
+
+typedef enum { OUTPUT_CF = 0, OUTPUT_F, OUTPUT_S } output_t;
+
+typedef struct {
+  const char* name;
+  output_t    output;
+  uint32_t    nof_outputs; // 0 for block_size
+  void (*run)(srsran_simd_isa_t isa);
+} kernel_t;
+
+// SRSRAN_SIMD_ISA_NONE runs the symbol the library has bound at load time
+static void run_prod_ccc(srsran_simd_isa_t isa)
+{
+  (isa ? srsran_vec_prod_ccc_simd_isa[isa] : srsran_vec_prod_ccc_simd)(x_cf, y_cf, z_cf, block_size);
+}
+
+static void run_prod_conj_ccc(srsran_simd_isa_t isa)
+{
+  (isa ? srsran_vec_prod_conj_ccc_simd_isa[isa] : srsran_vec_prod_conj_ccc_simd)(x_cf, y_cf, z_cf, block_size);
+}
+
+static void run_sc_prod_cfc(srsran_simd_isa_t isa)
+{
+  (isa ? srsran_vec_sc_prod_cfc_simd_isa[isa] : srsran_vec_sc_prod_cfc_simd)(x_cf, 0.7f, z_cf, block_size);
+}
+
+static void run_dot_prod_ccc(srsran_simd_isa_t isa)
+{
+  z_cf[0] = (isa ? srsran_vec_dot_prod_ccc_simd_isa[isa] : srsran_vec_dot_prod_ccc_simd)(x_cf, y_cf, block_size);
+}
+
+static void run_abs_square_cf(srsran_simd_isa_t isa)
+{
+  (isa ? srsran_vec_abs_square_cf_simd_isa[isa] : srsran_vec_abs_square_cf_simd)(x_cf, z_f, block_size);
+}
+
+static void run_max_fi(srsran_simd_isa_t isa)
+{
+  z_f[0] = (float)(isa ? srsran_vec_max_fi_simd_isa[isa] : srsran_vec_max_fi_simd)(x_f, block_size);
+}
+
+static void run_convert_fi(srsran_simd_isa_t isa)
+{
+  (isa ? srsran_vec_convert_fi_simd_isa[isa] : srsran_vec_convert_fi_simd)(x_f, z_s, 1000.0f, block_size);
+}
+
+static void run_sum_sss(srsran_simd_isa_t isa)
+{
+  (isa ? srsran_vec_sum_sss_simd_isa[isa] : srsran_vec_sum_sss_simd)(x_s, y_s, z_s, block_size);
+}
+
+static const kernel_t kernels[] = {{"prod_ccc", OUTPUT_CF, 0, run_prod_ccc},
+                                   {"prod_conj_ccc", OUTPUT_CF, 0, run_prod_conj_ccc},
+                                   {"sc_prod_cfc", OUTPUT_CF, 0, run_sc_prod_cfc},
+                                   {"dot_prod_ccc", OUTPUT_CF, 1, run_dot_prod_ccc},
+                                   {"abs_square_cf", OUTPUT_F, 0, run_abs_square_cf},
+                                   {"max_fi", OUTPUT_F, 1, run_max_fi},
+                                   {"convert_fi", OUTPUT_S, 0, run_convert_fi},
+                                   {"sum_sss", OUTPUT_S, 0, run_sum_sss}};
+
+#define NOF_KERNELS (sizeof(kernels) / sizeof(kernel_t))
+
+// Copies the kernel output as floats, so every output type can be compared the same way
+static void save_output(const kernel_t* k, float* out)
+{
+  uint32_t n = k->nof_outputs ? k->nof_outputs : block_size;
+  switch (k->output) {
+    case OUTPUT_CF:
+      memcpy(out, z_cf, sizeof(cf_t) * n);
+      break;
+    case OUTPUT_F:
+      memcpy(out, z_f, sizeof(float) * n);
+      break;
+    case OUTPUT_S:
+      srsran_vec_convert_if(z_s, 1.0f, out, n);
+      break;
+  }
+}
+
+static float max_error(const kernel_t* k, const float* a, const float* b)
+{
+  uint32_t n     = (k->nof_outputs ? k->nof_outputs : block_size) * (k->output == OUTPUT_CF ? 2 : 1);
+  float    err   = 0.0f;
+  float    scale = 1.0f;
+  for (uint32_t i = 0; i < n; i++) {
+    err   = SRSRAN_MAX(err, fabsf(a[i] - b[i]));
+    scale = SRSRAN_MAX(scale, fabsf(b[i]));
+  }
+  return err / scale;
+}
+
+// Compares the kernel of one ISA against the SSE4.1 one and times it
+static bool test_kernel_isa(const kernel_t* k, srsran_simd_isa_t isa, float* gold, float* out, double* timing)
+{
+  k->run(SRSRAN_SIMD_ISA_SSE);
+  save_output(k, gold);
+
+  struct timeval t[3] = {};
+  gettimeofday(&t[1], NULL);
+  for (uint32_t r = 0; r < nof_repetitions; r++) {
+    k->run(isa);
+  }
+  gettimeofday(&t[2], NULL);
+  get_time_interval(t);
+  *timing = t[0].tv_sec * 1e6 + t[0].tv_usec;
+
+  save_output(k, out);
+  return max_error(k, out, gold) < MAX_ERROR;
+}
+
+// The bound symbol must behave exactly as the kernel of the ISA it has been resolved to
+static bool test_bound_symbol(const kernel_t* k, float* gold, float* out)
+{
+  k->run(srsran_vec_simd_isa());
+  save_output(k, gold);
+  k->run(SRSRAN_SIMD_ISA_NONE);
+  save_output(k, out);
+  return max_error(k, out, gold) == 0.0f;
+}
+
+int main(int argc, char** argv)
+{
+  double   timings[NOF_KERNELS][SRSRAN_SIMD_ISA_NOF][MAX_BLOCKS];
+  bool     passed[NOF_KERNELS][SRSRAN_SIMD_ISA_NOF][MAX_BLOCKS];
+  uint32_t sizes[MAX_BLOCKS];
+  uint32_t size_count = 0;
+  bool     all_passed = true;
+
+  if (argc > 1) {
+    nof_repetitions = (uint32_t)strtol(argv[1], NULL, 10);
+  }
+
+  random_gen  = srsran_random_init(1234);
+  x_cf        = srsran_vec_cf_malloc(MAX_BLOCK_SIZE);
+  y_cf        = srsran_vec_cf_malloc(MAX_BLOCK_SIZE);
+  z_cf        = srsran_vec_cf_malloc(MAX_BLOCK_SIZE);
+  x_f         = srsran_vec_f_malloc(MAX_BLOCK_SIZE);
+  z_f         = srsran_vec_f_malloc(MAX_BLOCK_SIZE);
+  x_s         = srsran_vec_i16_malloc(MAX_BLOCK_SIZE);
+  y_s         = srsran_vec_i16_malloc(MAX_BLOCK_SIZE);
+  z_s         = srsran_vec_i16_malloc(MAX_BLOCK_SIZE);
+  float* gold = srsran_vec_f_malloc(2 * MAX_BLOCK_SIZE);
+  float* out  = srsran_vec_f_malloc(2 * MAX_BLOCK_SIZE);
+  for (uint32_t i = 0; i < MAX_BLOCK_SIZE; i++) {
+    x_cf[i] = srsran_random_uniform_complex_dist(random_gen, -1.0f, +1.0f);
+    y_cf[i] = srsran_random_uniform_complex_dist(random_gen, -1.0f, +1.0f);
+    x_f[i]  = srsran_random_uniform_real_dist(random_gen, -1.0f, +1.0f);
+    x_s[i]  = (int16_t)srsran_random_uniform_int_dist(random_gen, -8192, +8192);
+    y_s[i]  = (int16_t)srsran_random_uniform_int_dist(random_gen, -8192, +8192);
+  }
+
+  // Odd sizes, so that the scalar tail of every kernel is run too
+  for (block_size = 1; block_size < MAX_BLOCK_SIZE; block_size = 2 * block_size + 1) {
+    for (uint32_t k = 0; k < NOF_KERNELS; k++) {
+      for (int isa = SRSRAN_SIMD_ISA_SSE; isa < SRSRAN_SIMD_ISA_NOF; isa++) {
+        if (srsran_simd_isa_available((srsran_simd_isa_t)isa)) {
+          passed[k][isa][size_count] =
+              test_kernel_isa(&kernels[k], (srsran_simd_isa_t)isa, gold, out, &timings[k][isa][size_count]);
+          all_passed &= passed[k][isa][size_count];
+        }
+      }
+      if (!test_bound_symbol(&kernels[k], gold, out)) {
+        printf("%s: the bound symbol does not match the %s kernel\n",
+               kernels[k].name,
+               srsran_simd_isa_to_str(srsran_vec_simd_isa()));
+        all_passed = false;
+      }
+    }
+    sizes[size_count] = block_size;
+    size_count++;
+  }
+
+  printf("\nBound ISA: %s\n", srsran_simd_isa_to_str(srsran_vec_simd_isa()));
+  printf("%24s |", "Subroutine/MSps");
+  for (uint32_t i = 0; i < size_count; i++) {
+    printf(" %7d", sizes[i]);
+  }
+  printf("  |\n");
+
+  for (uint32_t k = 0; k < NOF_KERNELS; k++) {
+    for (int isa = SRSRAN_SIMD_ISA_SSE; isa < SRSRAN_SIMD_ISA_NOF; isa++) {
+      if (!srsran_simd_isa_available((srsran_simd_isa_t)isa)) {
+        continue;
+      }
+      printf("%16s %7s | ", kernels[k].name, srsran_simd_isa_to_str((srsran_simd_isa_t)isa));
+      for (uint32_t j = 0; j < size_count; j++) {
+        printf(" %s%7.1f\x1b[0m",
+               (passed[k][isa][j]) ? "" : "\x1B[31m",
+               (double)nof_repetitions * (double)sizes[j] / timings[k][isa][j]);
+      }
+      printf(" |\n");
+    }
+  }
+
+  free(x_cf);
+  free(y_cf);
+  free(z_cf);
+  free(x_f);
+  free(z_f);
+  free(x_s);
+  free(y_s);
+  free(z_s);
+  free(gold);
+  free(out);
+  srsran_random_free(random_gen);
+
+  return (all_passed) ? SRSRAN_SUCCESS : SRSRAN_ERROR;
+}
@@ -27,6 +27,12 @@
 #include <stdlib.h>
 #include <string.h>
 
+// With run-time dispatch this file is the SSE4.1 baseline, the wider builds include it with their own suffix
+#if defined(SRSRAN_SIMD_DISPATCH) && !defined(SRSRAN_SIMD_ISA)
+#define SRSRAN_SIMD_ISA sse
+#endif /* defined(SRSRAN_SIMD_DISPATCH) && !defined(SRSRAN_SIMD_ISA) */
+#include "vector_simd_isa.h"
+
 #include "srsran/phy/utils/simd.h"
 #include "srsran/phy/utils/vector_simd.h"
 
@@ -0,0 +1,137 @@
+/**
+ * Copyright 2013-2021 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#ifndef SRSRAN_VECTOR_SIMD_ISA_H
+#define SRSRAN_VECTOR_SIMD_ISA_H
+
+/*
+ * When the library is built with SRSRAN_SIMD_DISPATCH, vector_simd.c is compiled once per ISA. Each build defines
+ * SRSRAN_SIMD_ISA with the ISA suffix, which renames every kernel to <kernel>_<isa>. The plain kernel names are then
+ * resolved at load time to the best implementation the CPU supports (see simd_isa.c).
+ */
+
+#ifdef ENABLE_C16
+#define SRSRAN_VEC_SIMD_FOREACH_C16(F) F(srsran_vec_prod_ccc_c16_simd) F(srsran_vec_dot_prod_ccc_c16i_simd)
+#else /* ENABLE_C16 */
+#define SRSRAN_VEC_SIMD_FOREACH_C16(F)
+#endif /* ENABLE_C16 */
+
+/* Applies F to the name of every kernel declared in vector_simd.h */
+#define SRSRAN_VEC_SIMD_FOREACH(F)                                                                                     \
+  F(srsran_vec_xor_bbb_simd)                                                                                           \
+  F(srsran_vec_sum_sss_simd)                                                                                           \
+  F(srsran_vec_sub_sss_simd)                                                                                           \
+  F(srsran_vec_sub_bbb_simd)                                                                                           \
+  F(srsran_vec_acc_ff_simd)                                                                                            \
+  F(srsran_vec_acc_cc_simd)                                                                                            \
+  F(srsran_vec_add_fff_simd)                                                                                           \
+  F(srsran_vec_sub_fff_simd)                                                                                           \
+  F(srsran_vec_sc_prod_cfc_simd)                                                                                       \
+  F(srsran_vec_sc_prod_fcc_simd)                                                                                       \
+  F(srsran_vec_sc_prod_fff_simd)                                                                                       \
+  F(srsran_vec_sc_prod_ccc_simd)                                                                                       \
+  F(srsran_vec_sc_prod_ccc_simd2)                                                                                      \
+  F(srsran_vec_prod_ccc_split_simd)                                                                                    \
+  F(srsran_vec_prod_sss_simd)                                                                                          \
+  F(srsran_vec_neg_sss_simd)                                                                                           \
+  F(srsran_vec_neg_bbb_simd)                                                                                           \
+  F(srsran_vec_prod_cfc_simd)                                                                                          \
+  F(srsran_vec_prod_fff_simd)                                                                                          \
+  F(srsran_vec_prod_ccc_simd)                                                                                          \
+  F(srsran_vec_prod_conj_ccc_simd)                                                                                     \
+  F(srsran_vec_div_ccc_simd)                                                                                           \
+  F(srsran_vec_div_cfc_simd)                                                                                           \
+  F(srsran_vec_div_fff_simd)                                                                                           \
+  F(srsran_vec_dot_prod_conj_ccc_simd)                                                                                 \
+  F(srsran_vec_dot_prod_ccc_simd)                                                                                      \
+  F(srsran_vec_dot_prod_sss_simd)                                                                                      \
+  F(srsran_vec_abs_cf_simd)                                                                                            \
+  F(srsran_vec_abs_square_cf_simd)                                                                                     \
+  F(srsran_vec_lut_sss_simd)                                                                                           \
+  F(srsran_vec_lut_bbb_simd)                                                                                           \
+  F(srsran_vec_convert_if_simd)                                                                                        \
+  F(srsran_vec_convert_fi_simd)                                                                                        \
+  F(srsran_vec_convert_conj_cs_simd)                                                                                   \
+  F(srsran_vec_convert_fb_simd)                                                                                        \
+  F(srsran_vec_interleave_simd)                                                                                        \
+  F(srsran_vec_interleave_add_simd)                                                                                    \
+  F(srsran_vec_gen_sine_simd)                                                                                          \
+  F(srsran_vec_apply_cfo_simd)                                                                                         \
+  F(srsran_vec_estimate_frequency_simd)                                                                                \
+  F(srsran_vec_max_fi_simd)                                                                                            \
+  F(srsran_vec_max_abs_fi_simd)                                                                                        \
+  F(srsran_vec_max_ci_simd)                                                                                            \
+  SRSRAN_VEC_SIMD_FOREACH_C16(F)
+
+#ifdef SRSRAN_SIMD_ISA
+
+#define SRSRAN_SIMD_ISA_NAME_(NAME, ISA) NAME##_##ISA
+#define SRSRAN_SIMD_ISA_NAME(NAME, ISA) SRSRAN_SIMD_ISA_NAME_(NAME, ISA)
+
+#define srsran_vec_xor_bbb_simd SRSRAN_SIMD_ISA_NAME(srsran_vec_xor_bbb_simd, SRSRAN_SIMD_ISA)
+#define srsran_vec_sum_sss_simd SRSRAN_SIMD_ISA_NAME(srsran_vec_sum_sss_simd, SRSRAN_SIMD_ISA)
+#define srsran_vec_sub_sss_simd SRSRAN_SIMD_ISA_NAME(srsran_vec_sub_sss_simd, SRSRAN_SIMD_ISA)
+#define srsran_vec_sub_bbb_simd SRSRAN_SIMD_ISA_NAME(srsran_vec_sub_bbb_simd, SRSRAN_SIMD_ISA)
+#define srsran_vec_acc_ff_simd SRSRAN_SIMD_ISA_NAME(srsran_vec_acc_ff_simd, SRSRAN_SIMD_ISA)
+#define srsran_vec_acc_cc_simd SRSRAN_SIMD_ISA_NAME(srsran_vec_acc_cc_simd, SRSRAN_SIMD_ISA)
+#define srsran_vec_add_fff_simd SRSRAN_SIMD_ISA_NAME(srsran_vec_add_fff_simd, SRSRAN_SIMD_ISA)
+#define srsran_vec_sub_fff_simd SRSRAN_SIMD_ISA_NAME(srsran_vec_sub_fff_simd, SRSRAN_SIMD_ISA)
+#define srsran_vec_sc_prod_cfc_simd SRSRAN_SIMD_ISA_NAME(srsran_vec_sc_prod_cfc_simd, SRSRAN_SIMD_ISA)
+#define srsran_vec_sc_prod_fcc_simd SRSRAN_SIMD_ISA_NAME(srsran_vec_sc_prod_fcc_simd, SRSRAN_SIMD_ISA)
+#define srsran_vec_sc_prod_fff_simd SRSRAN_SIMD_ISA_NAME(srsran_vec_sc_prod_fff_simd, SRSRAN_SIMD_ISA)
+#define srsran_vec_sc_prod_ccc_simd SRSRAN_SIMD_ISA_NAME(srsran_vec_sc_prod_ccc_simd, SRSRAN_SIMD_ISA)
+#define srsran_vec_sc_prod_ccc_simd2 SRSRAN_SIMD_ISA_NAME(srsran_vec_sc_prod_ccc_simd2, SRSRAN_SIMD_ISA)
+#define srsran_vec_prod_ccc_split_simd SRSRAN_SIMD_ISA_NAME(srsran_vec_prod_ccc_split_simd, SRSRAN_SIMD_ISA)
+#define srsran_vec_prod_ccc_c16_simd SRSRAN_SIMD_ISA_NAME(srsran_vec_prod_ccc_c16_simd, SRSRAN_SIMD_ISA)
+#define srsran_vec_prod_sss_simd SRSRAN_SIMD_ISA_NAME(srsran_vec_prod_sss_simd, SRSRAN_SIMD_ISA)
+#define srsran_vec_neg_sss_simd SRSRAN_SIMD_ISA_NAME(srsran_vec_neg_sss_simd, SRSRAN_SIMD_ISA)
+#define srsran_vec_neg_bbb_simd SRSRAN_SIMD_ISA_NAME(srsran_vec_neg_bbb_simd, SRSRAN_SIMD_ISA)
+#define srsran_vec_prod_cfc_simd SRSRAN_SIMD_ISA_NAME(srsran_vec_prod_cfc_simd, SRSRAN_SIMD_ISA)
+#define srsran_vec_prod_fff_simd SRSRAN_SIMD_ISA_NAME(srsran_vec_prod_fff_simd, SRSRAN_SIMD_ISA)
+#define srsran_vec_prod_ccc_simd SRSRAN_SIMD_ISA_NAME(srsran_vec_prod_ccc_simd, SRSRAN_SIMD_ISA)
+#define srsran_vec_prod_conj_ccc_simd SRSRAN_SIMD_ISA_NAME(srsran_vec_prod_conj_ccc_simd, SRSRAN_SIMD_ISA)
+#define srsran_vec_div_ccc_simd SRSRAN_SIMD_ISA_NAME(srsran_vec_div_ccc_simd, SRSRAN_SIMD_ISA)
+#define srsran_vec_div_cfc_simd SRSRAN_SIMD_ISA_NAME(srsran_vec_div_cfc_simd, SRSRAN_SIMD_ISA)
+#define srsran_vec_div_fff_simd SRSRAN_SIMD_ISA_NAME(srsran_vec_div_fff_simd, SRSRAN_SIMD_ISA)
+#define srsran_vec_dot_prod_conj_ccc_simd SRSRAN_SIMD_ISA_NAME(srsran_vec_dot_prod_conj_ccc_simd, SRSRAN_SIMD_ISA)
+#define srsran_vec_dot_prod_ccc_simd SRSRAN_SIMD_ISA_NAME(srsran_vec_dot_prod_ccc_simd, SRSRAN_SIMD_ISA)
+#define srsran_vec_dot_prod_sss_simd SRSRAN_SIMD_ISA_NAME(srsran_vec_dot_prod_sss_simd, SRSRAN_SIMD_ISA)
+#define srsran_vec_abs_cf_simd SRSRAN_SIMD_ISA_NAME(srsran_vec_abs_cf_simd, SRSRAN_SIMD_ISA)
+#define srsran_vec_abs_square_cf_simd SRSRAN_SIMD_ISA_NAME(srsran_vec_abs_square_cf_simd, SRSRAN_SIMD_ISA)
+#define srsran_vec_lut_sss_simd SRSRAN_SIMD_ISA_NAME(srsran_vec_lut_sss_simd, SRSRAN_SIMD_ISA)
+#define srsran_vec_lut_bbb_simd SRSRAN_SIMD_ISA_NAME(srsran_vec_lut_bbb_simd, SRSRAN_SIMD_ISA)
+#define srsran_vec_convert_if_simd SRSRAN_SIMD_ISA_NAME(srsran_vec_convert_if_simd, SRSRAN_SIMD_ISA)
+#define srsran_vec_convert_fi_simd SRSRAN_SIMD_ISA_NAME(srsran_vec_convert_fi_simd, SRSRAN_SIMD_ISA)
+#define srsran_vec_convert_conj_cs_simd SRSRAN_SIMD_ISA_NAME(srsran_vec_convert_conj_cs_simd, SRSRAN_SIMD_ISA)
+#define srsran_vec_convert_fb_simd SRSRAN_SIMD_ISA_NAME(srsran_vec_convert_fb_simd, SRSRAN_SIMD_ISA)
+#define srsran_vec_interleave_simd SRSRAN_SIMD_ISA_NAME(srsran_vec_interleave_simd, SRSRAN_SIMD_ISA)
+#define srsran_vec_interleave_add_simd SRSRAN_SIMD_ISA_NAME(srsran_vec_interleave_add_simd, SRSRAN_SIMD_ISA)
+#define srsran_vec_gen_sine_simd SRSRAN_SIMD_ISA_NAME(srsran_vec_gen_sine_simd, SRSRAN_SIMD_ISA)
+#define srsran_vec_apply_cfo_simd SRSRAN_SIMD_ISA_NAME(srsran_vec_apply_cfo_simd, SRSRAN_SIMD_ISA)
+#define srsran_vec_estimate_frequency_simd SRSRAN_SIMD_ISA_NAME(srsran_vec_estimate_frequency_simd, SRSRAN_SIMD_ISA)
+#define srsran_vec_max_fi_simd SRSRAN_SIMD_ISA_NAME(srsran_vec_max_fi_simd, SRSRAN_SIMD_ISA)
+#define srsran_vec_max_abs_fi_simd SRSRAN_SIMD_ISA_NAME(srsran_vec_max_abs_fi_simd, SRSRAN_SIMD_ISA)
+#define srsran_vec_max_ci_simd SRSRAN_SIMD_ISA_NAME(srsran_vec_max_ci_simd, SRSRAN_SIMD_ISA)
+#define srsran_vec_dot_prod_ccc_c16i_simd SRSRAN_SIMD_ISA_NAME(srsran_vec_dot_prod_ccc_c16i_simd, SRSRAN_SIMD_ISA)
+
+#endif /* SRSRAN_SIMD_ISA */
+
+#endif // SRSRAN_VECTOR_SIMD_ISA_H
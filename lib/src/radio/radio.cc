@@ -23,6 +23,7 @@
 #include "srsran/common/standard_streams.h"
 #include "srsran/common/string_helpers.h"
 #include "srsran/config.h"
+#include <algorithm>
 #include <list>
 #include <string>
 #include <unistd.h>
@@ -59,6 +60,14 @@ radio::~radio()
   for (srsran_resampler_fft_t& q : decimators) {
     srsran_resampler_fft_free(&q);
   }
+
+  for (srsran_resampler_poly_t& q : rx_rate_adapters) {
+    srsran_resampler_poly_free(&q);
+  }
+
+  for (srsran_resampler_poly_t& q : tx_rate_adapters) {
+    srsran_resampler_poly_free(&q);
+  }
 }
 
 int radio::init(const rf_args_t& args, phy_interface_radio* phy_)
@@ -210,6 +219,9 @@ int radio::init(const rf_args_t& args, phy_interface_radio* phy_)
     for (auto& buf : tx_buffer) {
       buf.resize(resamp_buf_sz);
     }
+    for (auto& buf : rx_adapt_buffer) {
+      buf.resize(resamp_buf_sz);
+    }
   }
 
   // Frequency offset
@@ -293,24 +305,36 @@ bool radio::rx_now(rf_buffer_interface& buffer, rf_timestamp_interface& rxd_time
   // Extract decimation ratio. As the decimation may take some time to set a new ratio, deactivate the decimation and
   // keep receiving samples to avoid stalling the RX stream
   uint32_t ratio = 1; // No decimation by default
+  bool     adapt = false;
   if (decimator_busy) {
     lock.unlock();
+  } else if (rx_rate_adapt) {
+    adapt = true;
   } else if (decimators[0].ratio > 1) {
     ratio = decimators[0].ratio;
   }
+  bool resample = ratio > 1 or adapt;
 
   // Calculate number of samples, considering the decimation ratio
   uint32_t nof_samples = buffer.get_nof_samples() * ratio;
+  if (adapt) {
+    // Receive enough samples to complete the outputs left over from the previous reception
+    uint32_t nof_needed = buffer.get_nof_samples() - SRSRAN_MIN(rx_adapt_pending, buffer.get_nof_samples());
+    nof_samples         = srsran_resampler_poly_nof_input(&rx_rate_adapters[0], nof_needed);
+    if (srsran_resampler_poly_nof_output(&rx_rate_adapters[0], nof_samples) < nof_needed) {
+      nof_samples++;
+    }
+  }
 
   // Check decimation buffer protection
-  if (ratio > 1 && nof_samples > rx_buffer[0].size()) {
+  if (resample && nof_samples > rx_buffer[0].size()) {
     // This is a corner case that could happen during sample rate change transitions, as it does not have a negative
     // impact, log it as info.
     fmt::memory_buffer buff;
     fmt::format_to(buff,
                    "Rx number of samples ({}/{}) exceeds buffer size ({})",
                    buffer.get_nof_samples(),
-                   buffer.get_nof_samples() * ratio,
+                   nof_samples,
                    rx_buffer[0].size());
     logger.info("%s", to_c_str(buff));
 
@@ -324,7 +348,7 @@ bool radio::rx_now(rf_buffer_interface& buffer, rf_timestamp_interface& rxd_time
   // If the interpolator have been set, interpolate
   for (uint32_t ch = 0; ch < nof_channels; ch++) {
     // Use rx buffer if decimator is required
-    buffer_rx.set(ch, ratio > 1 ? rx_buffer[ch].data() : buffer.get(ch));
+    buffer_rx.set(ch, resample ? rx_buffer[ch].data() : buffer.get(ch));
   }
 
   if (not radio_is_streaming) {
@@ -354,6 +378,35 @@ bool radio::rx_now(rf_buffer_interface& buffer, rf_timestamp_interface& rxd_time
     }
   }
 
+  // Perform rate adaptation, all channels are run to keep their state aligned
+  if (adapt) {
+    uint32_t nof_out   = buffer.get_nof_samples();
+    uint32_t nof_avail = rx_adapt_pending;
+    for (uint32_t ch = 0; ch < nof_channels; ch++) {
+      std::vector<cf_t>& out    = rx_adapt_buffer[ch];
+      uint32_t           nof_rx = buffer_rx.get_nof_samples();
+
+      // Only grows during rate transitions, the buffer is sized for the maximum reception at init
+      uint32_t nof_max = rx_adapt_pending + srsran_resampler_poly_nof_output(&rx_rate_adapters[ch], nof_rx);
+      if (out.size() < nof_max) {
+        out.resize(nof_max);
+      }
+      nof_avail = rx_adapt_pending +
+                  srsran_resampler_poly_run(&rx_rate_adapters[ch], buffer_rx.get(ch), &out[rx_adapt_pending], nof_rx);
+
+      // Deliver the requested outputs and keep the rest at the front for the next reception
+      uint32_t nof_copy = SRSRAN_MIN(nof_avail, nof_out);
+      if (buffer.get(ch)) {
+        srsran_vec_cf_copy(buffer.get(ch), out.data(), nof_copy);
+        if (nof_copy < nof_out) {
+          srsran_vec_cf_zero(&buffer.get(ch)[nof_copy], nof_out - nof_copy);
+        }
+      }
+      std::copy(out.begin() + nof_copy, out.begin() + nof_avail, out.begin());
+    }
+    rx_adapt_pending = nof_avail - SRSRAN_MIN(nof_avail, nof_out);
+  }
+
   return ret;
 }
 
@@ -423,20 +476,25 @@ bool radio::tx(rf_buffer_interface& buffer, const rf_timestamp_interface& tx_tim
   // Get number of samples at the low rate
   uint32_t nof_samples = buffer.get_nof_samples();
 
+  // Number of samples at the device rate
+  uint32_t nof_dev_samples =
+      tx_rate_adapt ? srsran_resampler_poly_nof_output(&tx_rate_adapters[0], nof_samples) : nof_samples * ratio;
+
   // Check that number of the interpolated samples does not exceed the buffer size
-  if (ratio > 1 && nof_samples * ratio > tx_buffer[0].size()) {
+  if ((ratio > 1 || tx_rate_adapt) && nof_dev_samples > tx_buffer[0].size()) {
     // This is a corner case that could happen during sample rate change transitions, as it does not have a negative
     // impact, log it as info.
     fmt::memory_buffer buff;
     fmt::format_to(buff,
                    "Tx number of samples ({}/{}) exceeds buffer size ({})\n",
                    buffer.get_nof_samples(),
-                   buffer.get_nof_samples() * ratio,
+                   nof_dev_samples,
                    tx_buffer[0].size());
     logger.info("%s", to_c_str(buff));
 
     // Limit number of samples to transmit
-    nof_samples = tx_buffer[0].size() / ratio;
+    nof_samples = tx_rate_adapt ? srsran_resampler_poly_nof_input(&tx_rate_adapters[0], tx_buffer[0].size())
+                                : tx_buffer[0].size() / ratio;
   }
 
   // If the interpolator have been set, interpolate
@@ -451,6 +509,13 @@ bool radio::tx(rf_buffer_interface& buffer, const rf_timestamp_interface& tx_tim
 
     // Set buffer size after applying the interpolation
     buffer.set_nof_samples(nof_samples * ratio);
+  } else if (tx_rate_adapt) {
+    uint32_t nof_adapted = 0;
+    for (uint32_t ch = 0; ch < nof_channels; ch++) {
+      nof_adapted = srsran_resampler_poly_run(&tx_rate_adapters[ch], buffer.get(ch), tx_buffer[ch].data(), nof_samples);
+      buffer.set(ch, tx_buffer[ch].data());
+    }
+    buffer.set_nof_samples(nof_adapted);
   }
 
   for (uint32_t device_idx = 0; device_idx < (uint32_t)rf_devices.size(); device_idx++) {
@@ -684,6 +749,35 @@ void radio::set_rx_gain_th(const float& gain)
   }
 }
 
+bool radio::init_rate_adapters(std::array<srsran_resampler_poly_t, SRSRAN_MAX_CHANNELS>& adapters,
+                               double                                                    dev_srate,
+                               double                                                    srate,
+                               bool                                                      tx)
+{
+  // Integer ratios are handled by the FFT resamplers
+  double ratio = dev_srate / srate;
+  if (ratio >= 1.0 and std::abs(ratio - std::round(ratio)) < 1e-9 * ratio) {
+    return false;
+  }
+
+  // Reception goes from the device rate to the requested one, transmission the other way round
+  auto L = (uint32_t)std::round(tx ? dev_srate : srate);
+  auto M = (uint32_t)std::round(tx ? srate : dev_srate);
+  for (uint32_t ch = 0; ch < nof_channels; ch++) {
+    if (srsran_resampler_poly_init(&adapters[ch], L, M) < SRSRAN_SUCCESS) {
+      logger.error("Error initialising rate adapter from %.2f to %.2f MHz", dev_srate / 1e6, srate / 1e6);
+      return false;
+    }
+  }
+  logger.info("Adapting %s sampling rate from %.2f to %.2f MHz with ratio %d/%d",
+              tx ? "Tx" : "Rx",
+              (tx ? srate : dev_srate) / 1e6,
+              (tx ? dev_srate : srate) / 1e6,
+              adapters[0].L,
+              adapters[0].M);
+  return true;
+}
+
 void radio::set_rx_srate(const double& srate)
 {
   if (!is_initialized) {
@@ -701,8 +795,10 @@ void radio::set_rx_srate(const double& srate)
       }
     }
 
-    // Update decimators
-    uint32_t ratio = (uint32_t)ceil(cur_rx_srate / srate);
+    // Update decimators, or the rate adapters if the ratio is not an integer
+    rx_rate_adapt    = init_rate_adapters(rx_rate_adapters, cur_rx_srate, srate, false);
+    rx_adapt_pending = 0;
+    uint32_t ratio   = rx_rate_adapt ? 1 : (uint32_t)ceil(cur_rx_srate / srate);
     for (uint32_t ch = 0; ch < nof_channels; ch++) {
       srsran_resampler_fft_init(&decimators[ch], SRSRAN_RESAMPLER_MODE_DECIMATE, ratio);
     }
@@ -937,8 +1033,9 @@ void radio::set_tx_srate(const double& srate)
       }
     }
 
-    // Update interpolators
-    uint32_t ratio = (uint32_t)ceil(cur_tx_srate / srate);
+    // Update interpolators, or the rate adapters if the ratio is not an integer
+    tx_rate_adapt  = init_rate_adapters(tx_rate_adapters, cur_tx_srate, srate, true);
+    uint32_t ratio = tx_rate_adapt ? 1 : (uint32_t)ceil(cur_tx_srate / srate);
     for (uint32_t ch = 0; ch < nof_channels; ch++) {
       srsran_resampler_fft_init(&interpolators[ch], SRSRAN_RESAMPLER_MODE_INTERPOLATE, ratio);
     }
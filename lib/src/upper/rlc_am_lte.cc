@@ -112,6 +112,97 @@ bool rlc_am_pdu_segment_pool::make_segment(rlc_amd_tx_pdu& rlc_list, pdcp_pdu_in
   return true;
 }
 
+rlc_amd_rx_pdu_segment* rlc_am_rx_segment_pool::allocate()
+{
+  if (not free_list.empty()) {
+    return free_list.pop_front();
+  }
+  if (segments.size() >= MAX_POOL_SIZE) {
+    return nullptr;
+  }
+  segments.emplace_back(new rlc_amd_rx_pdu_segment());
+  return segments.back().get();
+}
+
+void rlc_am_rx_segment_pool::deallocate(rlc_amd_rx_pdu_segment* segment)
+{
+  segment->buf.reset();
+  free_list.push_front(segment);
+}
+
+rlc_amd_rx_pdu_segments_t::rlc_amd_rx_pdu_segments_t(rlc_amd_rx_pdu_segments_t&& other) noexcept :
+  pool(other.pool),
+  list(std::move(other.list)),
+  last(other.last),
+  count(other.count)
+{
+  other.last  = nullptr;
+  other.count = 0;
+}
+
+rlc_amd_rx_pdu_segments_t& rlc_amd_rx_pdu_segments_t::operator=(rlc_amd_rx_pdu_segments_t&& other) noexcept
+{
+  if (this != &other) {
+    clear();
+    pool        = other.pool;
+    list        = std::move(other.list);
+    last        = other.last;
+    count       = other.count;
+    other.last  = nullptr;
+    other.count = 0;
+  }
+  return *this;
+}
+
+void rlc_amd_rx_pdu_segments_t::insert(rlc_amd_rx_pdu_segment* segment)
+{
+  // Find segment insertion point in the list of segments
+  rlc_amd_rx_pdu_segment* prev = nullptr;
+  iterator                it   = list.begin();
+  while (it != list.end() && it->header.so < segment->header.so) {
+    prev = &(*it);
+    ++it;
+  }
+
+  if (it != list.end() && it->header.so == segment->header.so) {
+    // Same Segment offset, replace if the new one is bigger. Ignore otherwise
+    if (segment->buf->N_bytes > it->buf->N_bytes) {
+      static_cast<rlc_amd_rx_pdu&>(*it) = std::move(static_cast<rlc_amd_rx_pdu&>(*segment));
+    }
+    pool->deallocate(segment);
+    return;
+  }
+
+  if (prev == nullptr) {
+    list.push_front(segment);
+  } else {
+    list.insert_after(prev, segment);
+  }
+  if (prev == last) {
+    last = segment;
+  }
+  count++;
+}
+
+void rlc_amd_rx_pdu_segments_t::erase_after(rlc_amd_rx_pdu_segment* pos)
+{
+  rlc_amd_rx_pdu_segment* segment = (pos == nullptr) ? list.pop_front() : list.pop_after(pos);
+  if (segment == last) {
+    last = pos;
+  }
+  count--;
+  pool->deallocate(segment);
+}
+
+void rlc_amd_rx_pdu_segments_t::clear()
+{
+  while (not list.empty()) {
+    pool->deallocate(list.pop_front());
+  }
+  last  = nullptr;
+  count = 0;
+}
+
 void pdcp_pdu_info::ack_segment(rlc_am_pdu_segment& segment)
 {
   // remove from list
@@ -485,8 +576,7 @@ uint32_t rlc_am_lte::rlc_am_lte_tx::get_buffer_state()
 
 int rlc_am_lte::rlc_am_lte_tx::write_sdu(unique_byte_buffer_t sdu)
 {
-  std::lock_guard<std::mutex> lock(mutex);
-
+  // The SDU queue is lock-free, so writing SDUs does not contend with the MAC calling read_pdu()
   if (!tx_enabled) {
     return SRSRAN_ERROR;
   }
@@ -499,12 +589,11 @@ int rlc_am_lte::rlc_am_lte_tx::write_sdu(unique_byte_buffer_t sdu)
   // Get SDU info
   uint32_t sdu_pdcp_sn = sdu->md.pdcp_sn;
 
-  // Store SDU
-  uint8_t*                                 msg_ptr   = sdu->msg;
-  uint32_t                                 nof_bytes = sdu->N_bytes;
-  srsran::error_type<unique_byte_buffer_t> ret       = tx_sdu_queue.try_write(std::move(sdu));
+  // Store SDU. Once queued, the SDU may be popped and freed by the MAC thread, so it is only logged before
+  logger.info(sdu->msg, sdu->N_bytes, "%s Tx SDU (%d B)", RB_NAME, sdu->N_bytes);
+  srsran::error_type<unique_byte_buffer_t> ret = tx_sdu_queue.try_write(std::move(sdu));
   if (ret) {
-    logger.info(msg_ptr, nof_bytes, "%s Tx SDU (%d B, tx_sdu_queue_len=%d)", RB_NAME, nof_bytes, tx_sdu_queue.size());
+    logger.info("%s tx_sdu_queue_len=%d", RB_NAME, tx_sdu_queue.size());
   } else {
     // in case of fail, the try_write returns back the sdu
     logger.warning(ret.error()->msg,
@@ -525,13 +614,7 @@ void rlc_am_lte::rlc_am_lte_tx::discard_sdu(uint32_t discard_sn)
     return;
   }
 
-  bool discarded = tx_sdu_queue.apply_first([&discard_sn, this](unique_byte_buffer_t& sdu) {
-    if (sdu != nullptr && sdu->md.pdcp_sn == discard_sn) {
-      tx_sdu_queue.queue.pop_func(sdu);
-      sdu = nullptr;
-    }
-    return false;
-  });
+  bool discarded = tx_sdu_queue.discard(discard_sn);
 
   // Discard fails when the PDCP PDU is already in Tx window.
   logger.info("%s PDU with PDCP_SN=%d", discarded ? "Discarding" : "Couldn't discard", discard_sn);
@@ -1002,23 +1085,17 @@ int rlc_am_lte::rlc_am_lte_tx::build_data_pdu(uint8_t* payload, uint32_t nof_byt
   uint32_t to_move   = 0;
   uint32_t last_li   = 0;
   uint32_t pdu_space = SRSRAN_MIN(nof_bytes, pdu->get_tailroom());
-  uint8_t* pdu_ptr   = pdu->msg;
 
   logger.debug("%s Building PDU - pdu_space: %d, head_len: %d ", RB_NAME, pdu_space, head_len);
 
   // Check for SDU segment
   if (tx_sdu != nullptr) {
     to_move = ((pdu_space - head_len) >= tx_sdu->N_bytes) ? tx_sdu->N_bytes : pdu_space - head_len;
-    memcpy(pdu_ptr, tx_sdu->msg, to_move);
     last_li = to_move;
-    pdu_ptr += to_move;
-    pdu->N_bytes += to_move;
-    tx_sdu->N_bytes -= to_move;
-    tx_sdu->msg += to_move;
     if (undelivered_sdu_info_queue.has_pdcp_sn(tx_sdu->md.pdcp_sn)) {
       pdcp_pdu_info& pdcp_pdu = undelivered_sdu_info_queue[tx_sdu->md.pdcp_sn];
       segment_pool.make_segment(tx_pdu, pdcp_pdu);
-      if (tx_sdu->N_bytes == 0) {
+      if (tx_sdu->N_bytes == to_move) {
         pdcp_pdu.fully_txed = true;
       }
     } else {
@@ -1026,12 +1103,13 @@ int rlc_am_lte::rlc_am_lte_tx::build_data_pdu(uint8_t* payload, uint32_t nof_byt
       logger.warning("Couldn't find PDCP_SN=%d in SDU info queue (segment)", tx_sdu->md.pdcp_sn);
     }
 
-    if (tx_sdu->N_bytes == 0) {
+    if (tx_sdu->N_bytes == to_move) {
       logger.debug("%s Complete SDU scheduled for tx.", RB_NAME);
-      tx_sdu.reset();
     }
+    // Releases tx_sdu once it has been fully referenced
+    pdu_gather.add_fragment(tx_sdu, to_move);
     if (pdu_space > to_move) {
-      pdu_space -= SRSRAN_MIN(to_move, pdu->get_tailroom());
+      pdu_space -= to_move;
     } else {
       pdu_space = 0;
     }
@@ -1050,7 +1128,7 @@ int rlc_am_lte::rlc_am_lte_tx::build_data_pdu(uint8_t* payload, uint32_t nof_byt
   while (pdu_space > head_len && tx_sdu_queue.get_n_sdus() > 0 && header.N_li < RLC_AM_WINDOW_SIZE) {
     if (not segment_pool.has_segments()) {
       logger.info("Can't build a PDU segment - No segment resources available");
-      if (pdu_ptr != pdu->msg) {
+      if (not pdu_gather.empty()) {
         break; // continue with the segments created up to this point
       }
       tx_window.remove_pdu(tx_pdu.rlc_sn);
@@ -1090,21 +1168,13 @@ int rlc_am_lte::rlc_am_lte_tx::build_data_pdu(uint8_t* payload, uint32_t nof_byt
     pdcp_pdu_info& pdcp_pdu = undelivered_sdu_info_queue[tx_sdu->md.pdcp_sn];
 
     to_move = ((pdu_space - head_len) >= tx_sdu->N_bytes) ? tx_sdu->N_bytes : pdu_space - head_len;
-    memcpy(pdu_ptr, tx_sdu->msg, to_move);
     last_li = to_move;
-    pdu_ptr += to_move;
-    pdu->N_bytes += to_move;
-    tx_sdu->N_bytes -= to_move;
-    tx_sdu->msg += to_move;
     segment_pool.make_segment(tx_pdu, pdcp_pdu);
-    if (tx_sdu->N_bytes == 0) {
+    if (tx_sdu->N_bytes == to_move) {
       pdcp_pdu.fully_txed = true;
-    }
-
-    if (tx_sdu->N_bytes == 0) {
       logger.debug("%s Complete SDU scheduled for tx. PDCP SN=%d", RB_NAME, tx_sdu->md.pdcp_sn);
-      tx_sdu.reset();
     }
+    pdu_gather.add_fragment(tx_sdu, to_move);
     if (pdu_space > to_move) {
       pdu_space -= to_move;
     } else {
@@ -1119,7 +1189,7 @@ int rlc_am_lte::rlc_am_lte_tx::build_data_pdu(uint8_t* payload, uint32_t nof_byt
   }
 
   // Make sure, at least one SDU (segment) has been added until this point
-  if (pdu->N_bytes == 0) {
+  if (pdu_gather.empty()) {
     logger.error("Generated empty RLC PDU.");
   }
 
@@ -1129,7 +1199,7 @@ int rlc_am_lte::rlc_am_lte_tx::build_data_pdu(uint8_t* payload, uint32_t nof_byt
 
   // Set Poll bit
   pdu_without_poll++;
-  byte_without_poll += (pdu->N_bytes + head_len);
+  byte_without_poll += (pdu_gather.nof_bytes() + head_len);
   logger.debug("%s pdu_without_poll: %d", RB_NAME, pdu_without_poll);
   logger.debug("%s byte_without_poll: %d", RB_NAME, byte_without_poll);
   if (poll_required()) {
@@ -1146,15 +1216,24 @@ int rlc_am_lte::rlc_am_lte_tx::build_data_pdu(uint8_t* payload, uint32_t nof_byt
   // Update Tx window
   vt_s = (vt_s + 1) % MOD;
 
-  // Write final header and TX
-  tx_pdu.buf                      = std::move(pdu);
-  tx_pdu.header                   = header;
-  const byte_buffer_t* buffer_ptr = tx_pdu.buf.get();
-
+  // Write final header and gather the SDU fragments behind it
   uint8_t* ptr = payload;
   rlc_am_write_data_pdu_header(&header, &ptr);
-  memcpy(ptr, buffer_ptr->msg, buffer_ptr->N_bytes);
-  int total_len = (ptr - payload) + buffer_ptr->N_bytes;
+
+  // The Tx window keeps the PDU data for retransmissions. A PDU made of the last part of a single SDU keeps that SDU,
+  // otherwise the gathered data is copied to the PDU buffer
+  unique_byte_buffer_t sdu_pdu  = pdu_gather.take_single_sdu();
+  uint32_t             data_len = pdu_gather.gather(ptr);
+  if (sdu_pdu != nullptr) {
+    pdu = std::move(sdu_pdu);
+  } else {
+    memcpy(pdu->msg, ptr, data_len);
+    pdu->N_bytes = data_len;
+  }
+  tx_pdu.buf    = std::move(pdu);
+  tx_pdu.header = header;
+
+  int total_len = (ptr - payload) + data_len;
   logger.info(payload, total_len, "%s Tx PDU SN=%d (%d B)", RB_NAME, header.sn, total_len);
   log_rlc_amd_pdu_header_to_string(logger.debug, header);
   debug_state();
@@ -1588,8 +1667,6 @@ void rlc_am_lte::rlc_am_lte_rx::handle_data_pdu_segment(uint8_t*              pa
                                                         uint32_t              nof_bytes,
                                                         rlc_amd_pdu_header_t& header)
 {
-  std::map<uint32_t, rlc_amd_rx_pdu_segments_t>::iterator it;
-
   logger.info(payload,
               nof_bytes,
               "%s Rx data PDU segment of SN=%d (%d B), SO=%d, N_li=%d",
@@ -1610,9 +1687,14 @@ void rlc_am_lte::rlc_am_lte_rx::handle_data_pdu_segment(uint8_t*              pa
     return;
   }
 
-  rlc_amd_rx_pdu segment;
-  segment.buf = srsran::make_byte_buffer();
-  if (segment.buf == NULL) {
+  rlc_amd_rx_pdu_segment* segment = rx_segment_pool.allocate();
+  if (segment == nullptr) {
+    logger.warning("%s Dropping segment SN=%d, no RX segments available", RB_NAME, header.sn);
+    return;
+  }
+  segment->buf = srsran::make_byte_buffer();
+  if (segment->buf == NULL) {
+    rx_segment_pool.deallocate(segment);
 #ifdef RLC_AM_BUFFER_DEBUG
     srsran::console("Fatal Error: Couldn't allocate PDU in handle_data_pdu_segment().\n");
     exit(-1);
@@ -1622,17 +1704,18 @@ void rlc_am_lte::rlc_am_lte_rx::handle_data_pdu_segment(uint8_t*              pa
 #endif
   }
 
-  if (segment.buf->get_tailroom() < nof_bytes) {
+  if (segment->buf->get_tailroom() < nof_bytes) {
     logger.info("Dropping corrupted segment SN=%d, not enough space to fit %d B", header.sn, nof_bytes);
+    rx_segment_pool.deallocate(segment);
     return;
   }
 
-  memcpy(segment.buf->msg, payload, nof_bytes);
-  segment.buf->N_bytes = nof_bytes;
-  segment.header       = header;
+  memcpy(segment->buf->msg, payload, nof_bytes);
+  segment->buf->N_bytes = nof_bytes;
+  segment->header       = header;
 
   // Check if we already have a segment from the same PDU
-  it = rx_segments.find(header.sn);
+  rlc_amd_rx_segment_window_t::iterator it = rx_segments.find(header.sn);
   if (rx_segments.end() != it) {
     if (header.p) {
       logger.info("%s Status packet requested through polling bit", RB_NAME);
@@ -1640,16 +1723,15 @@ void rlc_am_lte::rlc_am_lte_rx::handle_data_pdu_segment(uint8_t*              pa
     }
 
     // Add segment to PDU list and check for complete
-    // NOTE: MAY MOVE. Preference would be to capture by value, and then move; but header is stack allocated
-    if (add_segment_and_check(&it->second, &segment)) {
-      rx_segments.erase(it);
+    if (add_segment_and_check(&it->second, segment)) {
+      rx_segments.erase(header.sn);
     }
 
   } else {
     // Create new PDU segment list and write to rx_segments
-    rlc_amd_rx_pdu_segments_t pdu;
-    pdu.segments.push_back(std::move(segment));
-    rx_segments[header.sn] = std::move(pdu);
+    rlc_amd_rx_pdu_segments_t pdu(rx_segment_pool);
+    pdu.insert(segment);
+    rx_segments.overwrite(header.sn, std::move(pdu));
 
     // Update vr_h
     if (RX_MOD_BASE(header.sn) >= RX_MOD_BASE(vr_h)) {
@@ -1799,19 +1881,17 @@ void rlc_am_lte::rlc_am_lte_rx::reassemble_rx_sdus()
     // Move the rx_window
     logger.debug("Erasing SN=%d.", vr_r);
     // also erase any segments of this SN
-    std::map<uint32_t, rlc_amd_rx_pdu_segments_t>::iterator it;
-    it = rx_segments.find(vr_r);
+    rlc_amd_rx_segment_window_t::iterator it = rx_segments.find(vr_r);
     if (rx_segments.end() != it) {
       logger.debug("Erasing segments of SN=%d", vr_r);
-      std::list<rlc_amd_rx_pdu>::iterator segit;
-      for (segit = it->second.segments.begin(); segit != it->second.segments.end(); ++segit) {
+      for (const rlc_amd_rx_pdu_segment& segment : it->second) {
         logger.debug(" Erasing segment of SN=%d SO=%d Len=%d N_li=%d",
-                     segit->header.sn,
-                     segit->header.so,
-                     segit->buf->N_bytes,
-                     segit->header.N_li);
+                     segment.header.sn,
+                     segment.header.so,
+                     segment.buf->N_bytes,
+                     segment.header.N_li);
       }
-      it->second.segments.clear();
+      rx_segments.erase(it);
     }
     rx_window.remove_pdu(vr_r);
     vr_r  = (vr_r + 1) % MOD;
@@ -1961,53 +2041,27 @@ int rlc_am_lte::rlc_am_lte_rx::get_status_pdu_length()
 
 void rlc_am_lte::rlc_am_lte_rx::print_rx_segments()
 {
-  std::map<uint32_t, rlc_amd_rx_pdu_segments_t>::iterator it;
-  std::stringstream                                       ss;
+  std::stringstream ss;
   ss << "rx_segments:" << std::endl;
-  for (it = rx_segments.begin(); it != rx_segments.end(); it++) {
-    std::list<rlc_amd_rx_pdu>::iterator segit;
-    for (segit = it->second.segments.begin(); segit != it->second.segments.end(); segit++) {
-      ss << "    SN=" << segit->header.sn << " SO:" << segit->header.so << " N:" << segit->buf->N_bytes
-         << " N_li: " << segit->header.N_li << std::endl;
+  for (auto& pdu : rx_segments) {
+    for (const rlc_amd_rx_pdu_segment& segment : pdu.second) {
+      ss << "    SN=" << segment.header.sn << " SO:" << segment.header.so << " N:" << segment.buf->N_bytes
+         << " N_li: " << segment.header.N_li << std::endl;
     }
   }
   logger.debug("%s", ss.str().c_str());
 }
 
-// NOTE: Preference would be to capture by value, and then move; but header is stack allocated
-bool rlc_am_lte::rlc_am_lte_rx::add_segment_and_check(rlc_amd_rx_pdu_segments_t* pdu, rlc_amd_rx_pdu* segment)
+bool rlc_am_lte::rlc_am_lte_rx::add_segment_and_check(rlc_amd_rx_pdu_segments_t* pdu, rlc_amd_rx_pdu_segment* segment)
 {
-  // Find segment insertion point in the list of segments
-  auto it1 = pdu->segments.begin();
-  while (it1 != pdu->segments.end() && (*it1).header.so < segment->header.so) {
-    // Increment iterator
-    it1++;
-  }
-
-  // Check if the insertion point was found
-  if (it1 != pdu->segments.end()) {
-    // Found insertion point
-    rlc_amd_rx_pdu& s = *it1;
-    if (s.header.so == segment->header.so) {
-      // Same Segment offset
-      if (segment->buf->N_bytes > s.buf->N_bytes) {
-        // replace if the new one is bigger
-        s = std::move(*segment);
-      } else {
-        // Ignore otherwise
-      }
-    } else if (s.header.so > segment->header.so) {
-      pdu->segments.insert(it1, std::move(*segment));
-    }
-  } else {
-    // Either the new segment is the latest or the only one, push back
-    pdu->segments.push_back(std::move(*segment));
-  }
+  // Insert segment sorted by segment offset, the list takes ownership of it
+  pdu->insert(segment);
 
   // Check for complete
-  uint32_t                            so = 0;
-  std::list<rlc_amd_rx_pdu>::iterator it, tmpit;
-  for (it = pdu->segments.begin(); it != pdu->segments.end(); /* Do not increment */) {
+  uint32_t                            so   = 0;
+  rlc_amd_rx_pdu_segment*             prev = nullptr;
+  rlc_amd_rx_pdu_segments_t::iterator it, tmpit;
+  for (it = pdu->begin(); it != pdu->end(); /* Do not increment */) {
     // Check that there is no gap between last segment and current; overlap allowed
     if (so < it->header.so) {
       // return
@@ -2017,16 +2071,18 @@ bool rlc_am_lte::rlc_am_lte_rx::add_segment_and_check(rlc_amd_rx_pdu_segments_t*
     // Check if segment is overlapped
     if (it->header.so + it->buf->N_bytes <= so) {
       // completely overlapped with previous segments, erase
-      it = pdu->segments.erase(it); // Returns next iterator
+      ++it;
+      pdu->erase_after(prev);
     } else {
       // Update segment offset it shall not go backwards
-      so = SRSRAN_MAX(so, it->header.so + it->buf->N_bytes);
-      it++; // Increments iterator
+      so   = SRSRAN_MAX(so, it->header.so + it->buf->N_bytes);
+      prev = &(*it);
+      ++it; // Increments iterator
     }
   }
 
   // Check for last segment flag available
-  if (!pdu->segments.back().header.lsf) {
+  if (!pdu->back().header.lsf) {
     return false;
   }
 
@@ -2036,23 +2092,23 @@ bool rlc_am_lte::rlc_am_lte_rx::add_segment_and_check(rlc_amd_rx_pdu_segments_t*
   header.rf   = 0;
   header.p    = 0;
   header.fi   = RLC_FI_FIELD_START_AND_END_ALIGNED;
-  header.sn   = pdu->segments.front().header.sn;
+  header.sn   = pdu->front().header.sn;
   header.lsf  = 0;
   header.so   = 0;
   header.N_li = 0;
 
   // Reconstruct fi field
-  header.fi |= (pdu->segments.front().header.fi & RLC_FI_FIELD_NOT_START_ALIGNED);
-  header.fi |= (pdu->segments.back().header.fi & RLC_FI_FIELD_NOT_END_ALIGNED);
+  header.fi |= (pdu->front().header.fi & RLC_FI_FIELD_NOT_START_ALIGNED);
+  header.fi |= (pdu->back().header.fi & RLC_FI_FIELD_NOT_END_ALIGNED);
 
-  logger.debug("Starting header reconstruction of %zd segments", pdu->segments.size());
+  logger.debug("Starting header reconstruction of %zd segments", pdu->size());
 
   // Reconstruct li fields
   uint16_t count          = 0;
   uint16_t carryover      = 0;
   uint16_t consumed_bytes = 0; // rolling sum of all allocated LIs during segment reconstruction
 
-  for (it = pdu->segments.begin(); it != pdu->segments.end(); ++it) {
+  for (it = pdu->begin(); it != pdu->end(); ++it) {
     logger.debug(" Handling %d PDU segments", it->header.N_li);
     for (uint32_t i = 0; i < it->header.N_li; i++) {
       // variable marks total offset of each _processed_ LI of this segment
@@ -2108,7 +2164,7 @@ bool rlc_am_lte::rlc_am_lte_rx::add_segment_and_check(rlc_amd_rx_pdu_segments_t*
     }
 
     tmpit = it;
-    if (rlc_am_end_aligned(it->header.fi) && ++tmpit != pdu->segments.end()) {
+    if (rlc_am_end_aligned(it->header.fi) && ++tmpit != pdu->end()) {
       logger.debug("Header is end-aligned, overwrite header.li[%d]=%d", header.N_li, carryover);
       header.li[header.N_li] = carryover;
       header.N_li++;
@@ -2121,7 +2177,7 @@ bool rlc_am_lte::rlc_am_lte_rx::add_segment_and_check(rlc_amd_rx_pdu_segments_t*
     header.p |= it->header.p;
   }
 
-  logger.debug("Finished header reconstruction of %zd segments", pdu->segments.size());
+  logger.debug("Finished header reconstruction of %zd segments", pdu->size());
 
   // Copy data
   unique_byte_buffer_t full_pdu = srsran::make_byte_buffer();
@@ -2134,7 +2190,7 @@ bool rlc_am_lte::rlc_am_lte_rx::add_segment_and_check(rlc_amd_rx_pdu_segments_t*
     return false;
 #endif
   }
-  for (it = pdu->segments.begin(); it != pdu->segments.end(); it++) {
+  for (it = pdu->begin(); it != pdu->end(); ++it) {
     // By default, the segment is not copied. It could be it is fully overlapped with previous segments
     uint32_t overlap = 0;
     uint32_t n       = 0;
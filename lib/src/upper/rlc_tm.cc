@@ -53,7 +53,6 @@ void rlc_tm::empty_queue()
   unique_byte_buffer_t buf;
   while (ul_queue.try_read(&buf)) {
   }
-  ul_queue.reset();
 }
 
 void rlc_tm::reestablish()
@@ -169,10 +168,6 @@ int rlc_tm::read_pdu(uint8_t* payload, uint32_t nof_bytes)
     return pdu_size;
   } else {
     logger.warning("Queue empty while trying to read");
-    if (ul_queue.size_bytes() > 0) {
-      logger.warning("Corrupted queue: empty but size_bytes > 0. Resetting queue");
-      ul_queue.reset();
-    }
     return 0;
   }
 }
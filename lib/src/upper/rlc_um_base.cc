@@ -294,7 +294,6 @@ bool rlc_um_base::rlc_um_base_tx::sdu_queue_is_full()
 
 int rlc_um_base::rlc_um_base_tx::build_data_pdu(uint8_t* payload, uint32_t nof_bytes)
 {
-  unique_byte_buffer_t pdu;
   {
     std::lock_guard<std::mutex> lock(mutex);
     logger.debug("MAC opportunity - %d bytes", nof_bytes);
@@ -303,14 +302,8 @@ int rlc_um_base::rlc_um_base_tx::build_data_pdu(uint8_t* payload, uint32_t nof_b
       logger.info("No data available to be sent");
       return 0;
     }
-
-    pdu = make_byte_buffer();
-    if (!pdu || pdu->N_bytes != 0) {
-      logger.error("Failed to allocate PDU buffer");
-      return 0;
-    }
   }
-  return build_data_pdu(std::move(pdu), payload, nof_bytes);
+  return build_data_pdu_in_place(payload, nof_bytes);
 }
 
 } // namespace srsran
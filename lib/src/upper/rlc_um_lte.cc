@@ -118,7 +118,7 @@ bool rlc_um_lte::rlc_um_lte_tx::configure(const rlc_config_t& cnfg_, std::string
   return true;
 }
 
-int rlc_um_lte::rlc_um_lte_tx::build_data_pdu(unique_byte_buffer_t pdu, uint8_t* payload, uint32_t nof_bytes)
+int rlc_um_lte::rlc_um_lte_tx::build_data_pdu_in_place(uint8_t* payload, uint32_t nof_bytes)
 {
   std::lock_guard<std::mutex> lock(mutex);
   rlc_umd_pdu_header_t        header;
@@ -129,10 +129,9 @@ int rlc_um_lte::rlc_um_lte_tx::build_data_pdu(unique_byte_buffer_t pdu, uint8_t*
 
   uint32_t to_move = 0;
   uint32_t last_li = 0;
-  uint8_t* pdu_ptr = pdu->msg;
 
   int head_len  = rlc_um_packed_length(&header);
-  int pdu_space = SRSRAN_MIN(nof_bytes, pdu->get_tailroom());
+  int pdu_space = nof_bytes;
 
   if (pdu_space <= head_len + 1) {
     logger.info("%s Cannot build a PDU - %d bytes available, %d bytes required for header",
@@ -148,26 +147,12 @@ int rlc_um_lte::rlc_um_lte_tx::build_data_pdu(unique_byte_buffer_t pdu, uint8_t*
     to_move        = space >= tx_sdu->N_bytes ? tx_sdu->N_bytes : space;
     logger.debug(
         "%s adding remainder of SDU segment - %d bytes of %d remaining", rb_name.c_str(), to_move, tx_sdu->N_bytes);
-    memcpy(pdu_ptr, tx_sdu->msg, to_move);
     last_li = to_move;
-    pdu_ptr += to_move;
-    pdu->N_bytes += to_move;
-    tx_sdu->N_bytes -= to_move;
-    tx_sdu->msg += to_move;
-    if (tx_sdu->N_bytes == 0) {
-#ifdef ENABLE_TIMESTAMP
-      auto latency_us = tx_sdu->get_latency_us().count();
-      mean_pdu_latency_us.push(latency_us);
-      logger.debug("%s Complete SDU scheduled for tx. Stack latency (last/average): %" PRIu64 "/%ld us",
-                   rb_name.c_str(),
-                   (uint64_t)latency_us,
-                   (long)mean_pdu_latency_us.value());
-#else
-      logger.debug("%s Complete SDU scheduled for tx.", rb_name.c_str());
-#endif
-      tx_sdu.reset();
+    if (to_move == tx_sdu->N_bytes) {
+      log_sdu_scheduled();
     }
-    pdu_space -= SRSRAN_MIN(to_move, pdu->get_tailroom());
+    pdu_gather.add_fragment(tx_sdu, to_move);
+    pdu_space -= to_move;
     header.fi |= RLC_FI_FIELD_NOT_START_ALIGNED; // First byte does not correspond to first byte of SDU
   }
 
@@ -187,25 +172,11 @@ int rlc_um_lte::rlc_um_lte_tx::build_data_pdu(unique_byte_buffer_t pdu, uint8_t*
     tx_sdu  = tx_sdu_queue.read();
     to_move = (space >= tx_sdu->N_bytes) ? tx_sdu->N_bytes : space;
     logger.debug("%s adding new SDU segment - %d bytes of %d remaining", rb_name.c_str(), to_move, tx_sdu->N_bytes);
-    memcpy(pdu_ptr, tx_sdu->msg, to_move);
     last_li = to_move;
-    pdu_ptr += to_move;
-    pdu->N_bytes += to_move;
-    tx_sdu->N_bytes -= to_move;
-    tx_sdu->msg += to_move;
-    if (tx_sdu->N_bytes == 0) {
-#ifdef ENABLE_TIMESTAMP
-      auto latency_us = tx_sdu->get_latency_us().count();
-      mean_pdu_latency_us.push(latency_us);
-      logger.debug("%s Complete SDU scheduled for tx. Stack latency (last/average): %" PRIu64 "/%ld us",
-                   rb_name.c_str(),
-                   (uint64_t)latency_us,
-                   (long)mean_pdu_latency_us.value());
-#else
-      logger.debug("%s Complete SDU scheduled for tx.", rb_name.c_str());
-#endif
-      tx_sdu.reset();
+    if (to_move == tx_sdu->N_bytes) {
+      log_sdu_scheduled();
     }
+    pdu_gather.add_fragment(tx_sdu, to_move);
     pdu_space -= to_move;
   }
 
@@ -217,15 +188,29 @@ int rlc_um_lte::rlc_um_lte_tx::build_data_pdu(unique_byte_buffer_t pdu, uint8_t*
   header.sn = vt_us;
   vt_us     = (vt_us + 1) % cfg.um.tx_mod;
 
-  // Add header and TX
-  rlc_um_write_data_pdu_header(&header, pdu.get());
-  memcpy(payload, pdu->msg, pdu->N_bytes);
+  // Add header and gather the SDU fragments behind it
+  uint32_t total_len = rlc_um_write_data_pdu_header(&header, payload);
+  total_len += pdu_gather.gather(payload + total_len);
 
-  logger.info(payload, pdu->N_bytes, "%s Tx PDU SN=%d (%d B)", rb_name.c_str(), header.sn, pdu->N_bytes);
+  logger.info(payload, total_len, "%s Tx PDU SN=%d (%d B)", rb_name.c_str(), header.sn, total_len);
 
   debug_state();
 
-  return pdu->N_bytes;
+  return total_len;
+}
+
+void rlc_um_lte::rlc_um_lte_tx::log_sdu_scheduled()
+{
+#ifdef ENABLE_TIMESTAMP
+  auto latency_us = tx_sdu->get_latency_us().count();
+  mean_pdu_latency_us.push(latency_us);
+  logger.debug("%s Complete SDU scheduled for tx. Stack latency (last/average): %" PRIu64 "/%ld us",
+               rb_name.c_str(),
+               (uint64_t)latency_us,
+               (long)mean_pdu_latency_us.value());
+#else
+  logger.debug("%s Complete SDU scheduled for tx.", rb_name.c_str());
+#endif
 }
 
 void rlc_um_lte::rlc_um_lte_tx::debug_state()
@@ -777,12 +762,17 @@ void rlc_um_read_data_pdu_header(uint8_t*              payload,
 
 void rlc_um_write_data_pdu_header(rlc_umd_pdu_header_t* header, byte_buffer_t* pdu)
 {
-  uint32_t i;
-  uint8_t  ext = (header->N_li > 0) ? 1 : 0;
   // Make room for the header
   uint32_t len = rlc_um_packed_length(header);
   pdu->msg -= len;
-  uint8_t* ptr = pdu->msg;
+  pdu->N_bytes += rlc_um_write_data_pdu_header(header, pdu->msg);
+}
+
+uint32_t rlc_um_write_data_pdu_header(rlc_umd_pdu_header_t* header, uint8_t* payload)
+{
+  uint32_t i;
+  uint8_t  ext = (header->N_li > 0) ? 1 : 0;
+  uint8_t* ptr = payload;
 
   // Fixed part
   if (header->sn_size == rlc_umd_sn_size_t::size5bits) {
@@ -822,7 +812,7 @@ void rlc_um_write_data_pdu_header(rlc_umd_pdu_header_t* header, byte_buffer_t* p
   if (header->N_li % 2 == 1)
     ptr++;
 
-  pdu->N_bytes += ptr - pdu->msg;
+  return ptr - payload;
 }
 
 uint32_t rlc_um_packed_length(rlc_umd_pdu_header_t* header)
@@ -124,7 +124,7 @@ bool rlc_um_nr::rlc_um_nr_tx::configure(const rlc_config_t& cnfg_, std::string r
   return true;
 }
 
-int rlc_um_nr::rlc_um_nr_tx::build_data_pdu(unique_byte_buffer_t pdu, uint8_t* payload, uint32_t nof_bytes)
+int rlc_um_nr::rlc_um_nr_tx::build_data_pdu_in_place(uint8_t* payload, uint32_t nof_bytes)
 {
   // Sanity check (we need at least 2B for a SDU)
   if (nof_bytes < 2) {
@@ -138,7 +138,7 @@ int rlc_um_nr::rlc_um_nr_tx::build_data_pdu(unique_byte_buffer_t pdu, uint8_t* p
   header.sn                          = TX_Next;
   header.sn_size                     = cfg.um_nr.sn_field_length;
 
-  uint32_t pdu_space = SRSRAN_MIN(nof_bytes, pdu->get_tailroom());
+  uint32_t pdu_space = nof_bytes;
 
   // Select segmentation information and header size
   if (tx_sdu == nullptr) {
@@ -179,11 +179,10 @@ int rlc_um_nr::rlc_um_nr_tx::build_data_pdu(unique_byte_buffer_t pdu, uint8_t* p
   // Log
   logger.debug("%s adding %s - (%d/%d)", rb_name.c_str(), to_string(header.si).c_str(), to_move, tx_sdu->N_bytes);
 
-  // Move data from SDU to PDU
-  uint8_t* pdu_ptr = pdu->msg;
-  memcpy(pdu_ptr, tx_sdu->msg, to_move);
-  pdu_ptr += to_move;
-  pdu->N_bytes += to_move;
+  // Write header and move data from SDU straight into the MAC PDU payload
+  uint32_t ret = rlc_um_nr_write_data_pdu_header(header, payload);
+  memcpy(payload + ret, tx_sdu->msg, to_move);
+  ret += to_move;
   tx_sdu->N_bytes -= to_move;
   tx_sdu->msg += to_move;
 
@@ -201,16 +200,11 @@ int rlc_um_nr::rlc_um_nr_tx::build_data_pdu(unique_byte_buffer_t pdu, uint8_t* p
     next_so = 0;
   }
 
-  // Add header and TX
-  rlc_um_nr_write_data_pdu_header(header, pdu.get());
-  memcpy(payload, pdu->msg, pdu->N_bytes);
-  uint32_t ret = pdu->N_bytes;
-
   // Assert number of bytes
   srsran_expect(
       ret <= nof_bytes, "Error while packing MAC PDU (more bytes written (%d) than expected (%d)!", ret, nof_bytes);
 
-  logger.info(payload, ret, "%s Tx PDU SN=%d (%d B)", rb_name.c_str(), header.sn, pdu->N_bytes);
+  logger.info(payload, ret, "%s Tx PDU SN=%d (%d B)", rb_name.c_str(), header.sn, ret);
 
   debug_state();
 
@@ -676,7 +670,14 @@ uint32_t rlc_um_nr_write_data_pdu_header(const rlc_um_nr_pdu_header_t& header, b
   // Make room for the header
   uint32_t len = rlc_um_nr_packed_length(header);
   pdu->msg -= len;
-  uint8_t* ptr = pdu->msg;
+  pdu->N_bytes += rlc_um_nr_write_data_pdu_header(header, pdu->msg);
+
+  return len;
+}
+
+uint32_t rlc_um_nr_write_data_pdu_header(const rlc_um_nr_pdu_header_t& header, uint8_t* payload)
+{
+  uint8_t* ptr = payload;
 
   // write SI field
   *ptr = (header.si & 0x03) << 6; // 2 bits SI
@@ -705,9 +706,7 @@ uint32_t rlc_um_nr_write_data_pdu_header(const rlc_um_nr_pdu_header_t& header, b
     }
   }
 
-  pdu->N_bytes += ptr - pdu->msg;
-
-  return len;
+  return ptr - payload;
 }
 
 } // namespace srsran
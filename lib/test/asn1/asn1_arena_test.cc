@@ -0,0 +1,261 @@
+/**
+ * Copyright 2013-2021 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "srsran/asn1/rrc.h"
+#include "srsran/asn1/s1ap.h"
+#include "srsran/common/test_common.h"
+#include <chrono>
+#include <new>
+
+using namespace asn1;
+
+/* Heap allocations of the thread under test */
+
+static thread_local bool count_allocs = false;
+static uint64_t          nof_allocs   = 0;
+
+void* operator new(size_t sz)
+{
+  if (count_allocs) {
+    nof_allocs++;
+  }
+  void* p = malloc(sz);
+  if (p == nullptr) {
+    throw std::bad_alloc();
+  }
+  return p;
+}
+
+void operator delete(void* p) noexcept
+{
+  free(p);
+}
+
+/* Messages */
+
+static const uint8_t s1ap_init_ctxt_setup_req[] = {
+    0x00, 0x09, 0x00, 0x80, 0xc6, 0x00, 0x00, 0x06, 0x00, 0x00, 0x00, 0x02, 0x00, 0x64, 0x00, 0x08, 0x00, 0x02, 0x00,
+    0x01, 0x00, 0x42, 0x00, 0x0a, 0x18, 0x3b, 0x9a, 0xca, 0x00, 0x60, 0x3b, 0x9a, 0xca, 0x00, 0x00, 0x18, 0x00, 0x78,
+    0x00, 0x00, 0x34, 0x00, 0x73, 0x45, 0x00, 0x09, 0x3c, 0x0f, 0x80, 0x0a, 0x00, 0x21, 0xf0, 0xb7, 0x36, 0x1c, 0x56,
+    0x64, 0x27, 0x3e, 0x5b, 0x04, 0xb7, 0x02, 0x07, 0x42, 0x02, 0x3e, 0x06, 0x00, 0x09, 0xf1, 0x07, 0x00, 0x07, 0x00,
+    0x37, 0x52, 0x66, 0xc1, 0x01, 0x09, 0x1b, 0x07, 0x74, 0x65, 0x73, 0x74, 0x31, 0x32, 0x33, 0x06, 0x6d, 0x6e, 0x63,
+    0x30, 0x37, 0x30, 0x06, 0x6d, 0x63, 0x63, 0x39, 0x30, 0x31, 0x04, 0x67, 0x70, 0x72, 0x73, 0x05, 0x01, 0xc0, 0xa8,
+    0x03, 0x02, 0x27, 0x0e, 0x80, 0x80, 0x21, 0x0a, 0x03, 0x00, 0x00, 0x0a, 0x81, 0x06, 0x08, 0x08, 0x08, 0x08, 0x50,
+    0x0b, 0xf6, 0x09, 0xf1, 0x07, 0x80, 0x01, 0x01, 0xf6, 0x7e, 0x72, 0x69, 0x13, 0x09, 0xf1, 0x07, 0x00, 0x01, 0x23,
+    0x05, 0xf4, 0xf6, 0x7e, 0x72, 0x69, 0x00, 0x6b, 0x00, 0x05, 0x18, 0x00, 0x0c, 0x00, 0x00, 0x00, 0x49, 0x00, 0x20,
+    0x45, 0x25, 0xe4, 0x9a, 0x77, 0xc8, 0xd5, 0xcf, 0x26, 0x33, 0x63, 0xeb, 0x5b, 0xb9, 0xc3, 0x43, 0x9b, 0x9e, 0xb3,
+    0x86, 0x1f, 0xa8, 0xa7, 0xcf, 0x43, 0x54, 0x07, 0xae, 0x42, 0x2b, 0x63, 0xb9};
+
+static const uint8_t rrc_conn_reconf[] = {
+    0x20, 0x02, 0x94, 0x08, 0x80, 0x81, 0x88, 0x0c, 0x02, 0x30, 0x31, 0x01, 0x58, 0x49, 0x41, 0x04, 0x3a, 0x74, 0x13,
+    0x90, 0x64, 0x12, 0x22, 0xe2, 0x05, 0x82, 0x01, 0x8e, 0x31, 0xbe, 0x82, 0x10, 0x76, 0x2d, 0xc0, 0xfd, 0x3b, 0xf8,
+    0xe0, 0xc6, 0x58, 0x06, 0x10, 0x88, 0xc1, 0x04, 0x1a, 0x70, 0x90, 0x83, 0x5b, 0xb0, 0x6e, 0xe3, 0x7a, 0x5a, 0x4e,
+    0x53, 0x30, 0x13, 0x49, 0xc6, 0xd6, 0x00, 0x00, 0x2f, 0x46, 0x32, 0x8d, 0x35, 0xfd, 0x23, 0xb8, 0x20, 0x10, 0x00,
+    0x01, 0x11, 0x41, 0xf9, 0x01, 0x0a, 0x80, 0x04, 0x00, 0x00, 0x44, 0x50, 0x00, 0x40, 0x20, 0xda, 0x14, 0x0d, 0x88,
+    0x85, 0x23, 0x01, 0x8c, 0xaa, 0x47, 0x1c, 0x8a, 0xc3, 0xb8, 0x40, 0x00, 0x05, 0xe9, 0xc3, 0x0c, 0xa3, 0x4c, 0xa9,
+    0x94, 0x02, 0xa9, 0x99, 0xab, 0x73, 0x80, 0x80, 0x02, 0x74, 0x83, 0x37, 0x12, 0x6e, 0x34, 0xdc, 0x79, 0xb9, 0x13,
+    0x76, 0x03, 0x2f, 0x82, 0x10, 0xa8, 0x0e, 0x80, 0x25, 0x00, 0x24, 0xfa, 0x10, 0x00, 0x09, 0xa1, 0x2e, 0x01, 0x93,
+    0x08, 0xcb, 0x11, 0x2f, 0x98, 0x7d, 0xdc, 0x40, 0x08, 0x00, 0x00, 0x88, 0xa0, 0xfc, 0x90, 0x85, 0x40, 0x02, 0x00,
+    0x00, 0x22, 0x28, 0x00, 0x24, 0x41, 0x2d, 0x0a, 0x06, 0xc4, 0x42, 0x91, 0x80, 0xc6, 0x55, 0x23, 0x8e, 0x45, 0x61,
+    0xd6, 0x54, 0x02, 0x47, 0xff, 0xff, 0xff, 0xff, 0xfc, 0x04, 0x00, 0x00, 0xb2, 0x70, 0xdc, 0x51, 0x08, 0x00, 0x07,
+    0x49, 0x59, 0x48, 0x3a, 0x12, 0xc8, 0x0f, 0x48, 0x0f, 0x48, 0x00, 0x01, 0x20, 0x00, 0xc8, 0xa0, 0x6c, 0x44, 0x30,
+    0x18, 0xc6, 0xa4, 0x32, 0x89, 0x90, 0xac, 0x11, 0x00, 0x1f, 0xf1, 0x14, 0x00, 0xe0, 0x02, 0x7f, 0xc8, 0x50, 0x03,
+    0x80, 0x21, 0x15, 0x8a, 0x00, 0x70, 0x05, 0x22, 0xb5, 0x40, 0x0e, 0x00, 0xc4, 0x96, 0xa8, 0x01, 0xc0, 0x41, 0x10,
+    0x04, 0x42, 0x42, 0x8c, 0x88, 0x53, 0x11, 0xc3, 0x2e, 0x22, 0x5f, 0x32, 0xa6, 0x50, 0x1a, 0xa6, 0x66, 0xad, 0xce,
+    0x02, 0x00, 0x09, 0xd2, 0x0c, 0xdc, 0x49, 0xb8, 0xd3, 0x71, 0xe6, 0xe4, 0x4d, 0xd8, 0x09, 0x8f, 0x4b, 0x33, 0x55,
+    0x54, 0x94, 0x1c, 0x00, 0x10, 0x40, 0xc2, 0x05, 0x0c, 0x1e, 0x9c, 0x40, 0x91, 0x42, 0xc6, 0x0d, 0x1c, 0x3f, 0xf0,
+    0x8e, 0x00, 0x20, 0xe8, 0x35, 0x40, 0x30, 0x21, 0x17, 0x39, 0xaa, 0x01, 0x82, 0x73, 0x84, 0x4d, 0x50, 0x0c, 0x1b,
+    0xa0, 0x20, 0x6a, 0x80, 0x61, 0x02, 0x0e, 0x83, 0x74, 0x03, 0x0a, 0x11, 0x73, 0x9b, 0xa0, 0x18, 0x67, 0x38, 0x44,
+    0xdd, 0x00, 0xc3, 0xba, 0x02, 0x06, 0xe8, 0x06, 0x20, 0x26, 0xe5, 0x61, 0x41, 0x89, 0x0a, 0x39, 0x18, 0x50, 0x62,
+    0x82, 0xae, 0x36, 0x14, 0x18, 0xb0, 0xb3, 0x89, 0x85, 0x06, 0x30, 0x2e, 0xe1, 0x61, 0x41, 0x8d, 0x0c, 0x38, 0x18,
+    0x50, 0x63, 0x83, 0x2d, 0xf6, 0x14, 0x18, 0xf6, 0xf8, 0x65, 0x85, 0x06, 0x41, 0xd0, 0x10, 0x21, 0x40, 0x35, 0x0e,
+    0x60, 0x93, 0x0a, 0x08, 0x12, 0x70, 0xc0, 0xa1, 0x08, 0x38, 0x9b, 0xc1, 0x84, 0x67, 0x3c, 0x8e, 0x92, 0x68, 0x29,
+    0x34, 0x10, 0x80, 0x0c, 0x10, 0xac, 0x62, 0x4d, 0xc8, 0x9b, 0xc7, 0xfe, 0xa3, 0x19, 0x4a, 0x52, 0x89, 0x42, 0xe0,
+    0x00, 0x10, 0xd8, 0x07, 0x04, 0xc0, 0x04, 0x20, 0xe3, 0xb0, 0x01, 0x80, 0x00, 0x00, 0x00, 0x04, 0xd4, 0x08, 0x90,
+    0xde, 0x90, 0x08, 0x02, 0x00, 0x00, 0x9a, 0x81, 0x12, 0x43, 0xd2, 0x02, 0x00, 0x40, 0x00, 0x13, 0x50, 0x22, 0x4d,
+    0x7a, 0x40, 0x60, 0x08, 0x00, 0x02, 0x6a, 0x04, 0x4a, 0x4f, 0x49, 0x84, 0x56, 0xaa, 0x2a, 0x02, 0x10, 0x00, 0x40,
+    0x42, 0x00, 0x38, 0x10, 0xf4, 0xb8, 0xa4, 0x02, 0x10, 0x20, 0x80, 0x0e, 0x04, 0x3d, 0x2e, 0x29, 0x01, 0x04, 0x04,
+    0x20, 0x03, 0x81, 0x0f, 0x4b, 0x8c, 0x40, 0x61, 0x02, 0x08, 0x00, 0xe0, 0x43, 0xd2, 0xe3, 0x10, 0xe1, 0x15, 0xaa,
+    0x00, 0x70, 0x21, 0xe9, 0x90, 0x00, 0x88, 0x01, 0x80, 0x00, 0x81, 0x01, 0x80, 0xe0, 0x0e, 0x01, 0xc1, 0x30, 0x00,
+    0xe0, 0x90, 0x00, 0x00, 0x00, 0x04, 0x00, 0x80, 0x03, 0x00, 0xa0, 0x1c, 0xc0, 0x50, 0x00, 0xc0, 0x37, 0x80, 0x80,
+    0x10, 0x43, 0x93, 0x0a, 0x83, 0xc6, 0xff, 0xff, 0x84, 0x1f, 0xe1, 0xe4, 0xb0, 0x01, 0x54, 0x00, 0x07, 0x94, 0x01,
+    0x39, 0x4c, 0xc5, 0x00, 0xc3, 0x23, 0x32, 0x07, 0x80, 0x81, 0x62, 0x68, 0x02, 0x01, 0x62, 0x20, 0x0a, 0x01, 0xf9,
+    0xe1, 0xc1, 0x20, 0x22, 0x30, 0xac, 0x23, 0x00, 0x20, 0x00, 0x00, 0x20, 0x02, 0xbc, 0x84, 0x20, 0xe4, 0x21, 0x06,
+    0xa0, 0x00, 0x00, 0xe2, 0x80, 0xa0, 0x3a, 0x6e, 0xc3, 0x0a, 0x00};
+
+/* TESTS */
+
+int test_dyn_array_arena()
+{
+  std::array<uint8_t, 256> buffer;
+  srsran::linear_allocator arena(buffer.data(), buffer.size());
+
+  {
+    arena_scope         scope(arena);
+    dyn_array<uint32_t> arena_array(4);
+    TESTASSERT(arena.nof_bytes_allocated() >= 4 * sizeof(uint32_t));
+    TESTASSERT((void*)arena_array.data() >= (void*)buffer.data());
+    TESTASSERT((void*)arena_array.data() < (void*)(buffer.data() + buffer.size()));
+
+    // Allocations that do not fit fall back to the heap
+    dyn_array<uint32_t> big_array(128);
+    TESTASSERT((void*)big_array.data() < (void*)buffer.data() or
+               (void*)big_array.data() >= (void*)(buffer.data() + buffer.size()));
+
+    // Growing past the capacity reallocates in the arena and keeps the content
+    for (uint32_t i = 0; i < 4; ++i) {
+      arena_array[i] = i;
+    }
+    arena_array.push_back(4);
+    TESTASSERT(arena_array.size() == 5);
+    for (uint32_t i = 0; i < 5; ++i) {
+      TESTASSERT(arena_array[i] == i);
+    }
+  }
+
+  // Arrays created outside the scope use the heap
+  dyn_array<uint32_t> other_array(4);
+  TESTASSERT((void*)other_array.data() < (void*)buffer.data() or
+             (void*)other_array.data() >= (void*)(buffer.data() + buffer.size()));
+
+  return SRSRAN_SUCCESS;
+}
+
+int test_copy_ptr_arena()
+{
+  std::array<uint8_t, 256> buffer;
+  srsran::linear_allocator arena(buffer.data(), buffer.size());
+  auto in_arena = [&buffer](const void* p) { return p >= buffer.data() and p < buffer.data() + buffer.size(); };
+
+  copy_ptr<dyn_octstring> escaped;
+  {
+    arena_scope             scope(arena);
+    copy_ptr<dyn_octstring> cptr;
+    cptr.set_present();
+    cptr->resize(2);
+    (*cptr)[0] = 0xab;
+    (*cptr)[1] = 0xcd;
+    TESTASSERT(in_arena(cptr.get()));
+    TESTASSERT(in_arena(cptr->data()));
+
+    // Moving within the scope keeps the arena object
+    copy_ptr<dyn_octstring> cptr2 = std::move(cptr);
+    TESTASSERT(not cptr.is_present());
+    TESTASSERT(in_arena(cptr2.get()));
+    escaped = std::move(cptr2);
+  }
+  TESTASSERT(escaped.is_present() and in_arena(escaped.get()));
+
+  // Moving out of the scope of the arena moves the object to the heap
+  copy_ptr<dyn_octstring> heap_cptr = std::move(escaped);
+  TESTASSERT(not in_arena(heap_cptr.get()));
+  TESTASSERT(heap_cptr->size() == 2 and (*heap_cptr)[0] == 0xab and (*heap_cptr)[1] == 0xcd);
+
+  // Released objects are always owned by the heap
+  {
+    arena_scope scope(arena);
+    escaped.set_present();
+    escaped->resize(1);
+    (*escaped)[0] = 0x12;
+    TESTASSERT(in_arena(escaped.get()));
+  }
+  dyn_octstring* raw = escaped.release();
+  TESTASSERT(not in_arena(raw));
+  TESTASSERT(raw->size() == 1 and (*raw)[0] == 0x12);
+  delete raw;
+
+  return SRSRAN_SUCCESS;
+}
+
+/// Unpacks the message with and without arena, and reports the throughput and number of heap allocations
+template <class Msg>
+int bench_unpack(const char* name, const uint8_t* msg, uint32_t msg_len, uint32_t nof_repetitions)
+{
+  std::unique_ptr<uint8_t[]> arena_buffer(new uint8_t[1024 * 1024]);
+  std::vector<uint8_t>       packed(msg_len);
+
+  for (bool use_arena : {false, true}) {
+    nof_allocs        = 0;
+    size_t arena_size = 0;
+    auto   tp         = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < nof_repetitions; ++i) {
+      srsran::linear_allocator arena(arena_buffer.get(), 1024 * 1024);
+      Msg                      pdu;
+      cbit_ref                 bref(msg, msg_len);
+
+      count_allocs = true;
+      if (use_arena) {
+        arena_scope scope(arena);
+        TESTASSERT(pdu.unpack(bref) == SRSASN_SUCCESS);
+        arena_size = arena.nof_bytes_allocated();
+      } else {
+        TESTASSERT(pdu.unpack(bref) == SRSASN_SUCCESS);
+      }
+      count_allocs = false;
+
+      // The decoded message is the same regardless of its memory
+      bit_ref bref2(packed.data(), packed.size());
+      TESTASSERT(pdu.pack(bref2) == SRSASN_SUCCESS);
+      TESTASSERT((uint32_t)bref2.distance_bytes() == msg_len);
+      TESTASSERT(memcmp(packed.data(), msg, msg_len) == 0);
+    }
+    auto   tp_end = std::chrono::steady_clock::now();
+    double secs   = std::chrono::duration_cast<std::chrono::duration<double> >(tp_end - tp).count();
+
+    printf("%s unpack (%s): %.0f msg/s; %.1f allocations/msg; %zd arena bytes/msg;\n",
+           name,
+           use_arena ? "arena" : "heap",
+           nof_repetitions / secs,
+           (double)nof_allocs / nof_repetitions,
+           arena_size);
+    if (use_arena) {
+      TESTASSERT(nof_allocs == 0);
+    }
+  }
+
+  return SRSRAN_SUCCESS;
+}
+
+int main(int argc, char** argv)
+{
+  uint32_t nof_repetitions = (argc > 1) ? (uint32_t)strtol(argv[1], nullptr, 10) : 1000;
+
+  auto& asn1_logger = srslog::fetch_basic_logger("ASN1", false);
+  asn1_logger.set_level(srslog::basic_levels::info);
+
+  // Start the log backend.
+  srslog::init();
+
+  TESTASSERT(test_dyn_array_arena() == SRSRAN_SUCCESS);
+  TESTASSERT(test_copy_ptr_arena() == SRSRAN_SUCCESS);
+  TESTASSERT(bench_unpack<s1ap::s1ap_pdu_c>("S1AP InitialContextSetupRequest",
+                                            s1ap_init_ctxt_setup_req,
+                                            sizeof(s1ap_init_ctxt_setup_req),
+                                            nof_repetitions) == SRSRAN_SUCCESS);
+  TESTASSERT(bench_unpack<rrc::dl_dcch_msg_s>(
+                 "RRC ConnectionReconfiguration", rrc_conn_reconf, sizeof(rrc_conn_reconf), nof_repetitions) ==
+             SRSRAN_SUCCESS);
+
+  srslog::flush();
+
+  printf("Success\n");
+  return SRSRAN_SUCCESS;
+}
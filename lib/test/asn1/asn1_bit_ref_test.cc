@@ -0,0 +1,358 @@
+/**
+ * Copyright 2013-2021 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "srsran/asn1/rrc.h"
+#include "srsran/common/test_common.h"
+#include <chrono>
+#include <random>
+
+using namespace asn1;
+using namespace asn1::rrc;
+
+static std::mt19937 rand_gen(1234);
+
+/* Bit by bit reference of the bit_ref packing and unpacking */
+
+struct ref_bit_ref {
+  uint8_t*       ptr;
+  uint8_t        offset;
+  const uint8_t* max_ptr;
+
+  ref_bit_ref(uint8_t* buf, uint32_t len) : ptr(buf), offset(0), max_ptr(buf + len) {}
+
+  SRSASN_CODE pack(uint64_t val, uint32_t n_bits)
+  {
+    for (uint32_t i = 0; i < n_bits; ++i) {
+      if (ptr >= max_ptr) {
+        return SRSASN_ERROR_ENCODE_FAIL;
+      }
+      uint8_t bit = (val >> (n_bits - 1 - i)) & 1u;
+      // Writing the first bit of a byte position clears the remaining bits of that byte
+      uint8_t keep = (uint8_t)(0xffu << (8u - offset));
+      *ptr         = (*ptr & keep) | (uint8_t)(bit << (7u - offset));
+      if (++offset == 8) {
+        offset = 0;
+        ptr++;
+      }
+    }
+    return SRSASN_SUCCESS;
+  }
+
+  SRSASN_CODE unpack(uint64_t& val, uint32_t n_bits)
+  {
+    val = 0;
+    for (uint32_t i = 0; i < n_bits; ++i) {
+      if (ptr >= max_ptr) {
+        return SRSASN_ERROR_DECODE_FAIL;
+      }
+      val = (val << 1u) | ((*ptr >> (7u - offset)) & 1u);
+      if (++offset == 8) {
+        offset = 0;
+        ptr++;
+      }
+    }
+    return SRSASN_SUCCESS;
+  }
+};
+
+int test_bit_exact_pack_unpack()
+{
+  std::uniform_int_distribution<uint32_t> len_dist(1, 48);
+  std::uniform_int_distribution<uint32_t> nbits_dist(0, 63);
+  std::uniform_int_distribution<uint32_t> nbytes_dist(0, 20);
+  std::uniform_int_distribution<uint32_t> op_dist(0, 3);
+  std::uniform_int_distribution<uint64_t> val_dist;
+
+  // Running out of buffer is expected
+  srslog::fetch_basic_logger("ASN1", false).set_level(srslog::basic_levels::none);
+
+  for (uint32_t trial = 0; trial < 20000; ++trial) {
+    uint32_t len = len_dist(rand_gen);
+    uint8_t  buf[64], ref_buf[64], bytes[32];
+    for (uint32_t i = 0; i < sizeof(buf); ++i) {
+      buf[i] = ref_buf[i] = (uint8_t)val_dist(rand_gen);
+    }
+    bit_ref     bref(buf, len);
+    ref_bit_ref ref(ref_buf, len);
+
+    // Pack a random sequence of fields, bytes and alignments until the buffer is exhausted
+    struct field_t {
+      uint32_t op;
+      uint32_t n;
+      uint64_t val;
+    };
+    std::vector<field_t> fields;
+    while (true) {
+      field_t f = {op_dist(rand_gen), nbits_dist(rand_gen), val_dist(rand_gen)};
+      if (f.op == 2) {
+        f.n = nbytes_dist(rand_gen);
+        for (uint32_t i = 0; i < f.n; ++i) {
+          bytes[i] = (uint8_t)(f.val >> (8 * (i % 8))) ^ (uint8_t)i;
+        }
+      }
+      SRSASN_CODE ret, ref_ret;
+      if (f.op == 2) {
+        ret = bref.pack_bytes(bytes, f.n);
+        // pack_bytes requires one spare byte beyond the packed bytes
+        ref_ret = (f.n > 0 and ref.ptr + f.n >= ref.max_ptr) ? SRSASN_ERROR_ENCODE_FAIL : SRSASN_SUCCESS;
+        for (uint32_t i = 0; i < f.n and ref_ret == SRSASN_SUCCESS; ++i) {
+          ref_ret = ref.pack(bytes[i], 8);
+        }
+      } else if (f.op == 3) {
+        ret     = bref.align_bytes_zero();
+        ref_ret = SRSASN_SUCCESS;
+        if (ref.offset != 0) {
+          ref_ret = ref.pack(0, 8 - ref.offset);
+        }
+      } else {
+        ret     = bref.pack(f.val, f.n);
+        ref_ret = ref.pack(f.val, f.n);
+      }
+      if (ret != SRSASN_SUCCESS) {
+        TESTASSERT(ref_ret != SRSASN_SUCCESS);
+        break;
+      }
+      TESTASSERT(ref_ret == SRSASN_SUCCESS);
+      TESTASSERT(bref.distance(buf) == (int)((ref.ptr - ref_buf) * 8 + ref.offset));
+      fields.push_back(f);
+    }
+    // The encoded bits match, while the bits that follow them are not defined
+    uint32_t nof_bits = bref.distance(buf);
+    TESTASSERT(memcmp(buf, ref_buf, nof_bits / 8) == 0);
+    if (nof_bits % 8 != 0) {
+      uint8_t mask = (uint8_t)(0xffu << (8u - nof_bits % 8));
+      TESTASSERT((buf[nof_bits / 8] & mask) == (ref_buf[nof_bits / 8] & mask));
+    }
+    memcpy(ref_buf + nof_bits / 8, buf + nof_bits / 8, len - nof_bits / 8);
+    // Nothing is written past the end of the buffer
+    TESTASSERT(memcmp(buf + len, ref_buf + len, sizeof(buf) - len) == 0);
+
+    // Unpack the same sequence
+    cbit_ref    cbref(buf, len);
+    ref_bit_ref uref(ref_buf, len);
+    for (const field_t& f : fields) {
+      if (f.op == 2) {
+        uint8_t out[32];
+        TESTASSERT(cbref.unpack_bytes(out, f.n) == SRSASN_SUCCESS);
+        for (uint32_t i = 0; i < f.n; ++i) {
+          uint64_t v;
+          TESTASSERT(uref.unpack(v, 8) == SRSASN_SUCCESS);
+          TESTASSERT(out[i] == (uint8_t)v);
+        }
+      } else if (f.op == 3) {
+        TESTASSERT(cbref.align_bytes() == SRSASN_SUCCESS);
+        uint64_t v;
+        TESTASSERT(uref.unpack(v, (8 - uref.offset) % 8) == SRSASN_SUCCESS);
+      } else {
+        uint64_t v, ref_v;
+        TESTASSERT(cbref.unpack(v, f.n) == SRSASN_SUCCESS);
+        TESTASSERT(uref.unpack(ref_v, f.n) == SRSASN_SUCCESS);
+        TESTASSERT(v == ref_v);
+      }
+      TESTASSERT(cbref.distance(buf) == (int)((uref.ptr - ref_buf) * 8 + uref.offset));
+    }
+
+    // Unpacking the remaining bits behaves as the reference, including at the end of the buffer
+    uint32_t n_bits = nbits_dist(rand_gen) % 33;
+    uint32_t v32;
+    uint64_t ref_v;
+    bool     ok = cbref.unpack(v32, n_bits) == SRSASN_SUCCESS;
+    TESTASSERT(ok == (uref.unpack(ref_v, n_bits) == SRSASN_SUCCESS));
+    TESTASSERT(not ok or v32 == ref_v);
+  }
+  srslog::fetch_basic_logger("ASN1", false).set_level(srslog::basic_levels::info);
+
+  return SRSRAN_SUCCESS;
+}
+
+/// Packs and unpacks a stream of fields with the size distribution of a PER encoded message
+int bench_fields(uint32_t nof_repetitions)
+{
+  std::vector<uint32_t> field_bits(8192), field_vals(8192);
+  std::vector<uint8_t>  buf(field_bits.size() * 4 + 8);
+  for (uint32_t i = 0; i < field_bits.size(); ++i) {
+    uint32_t r    = rand_gen() % 16;
+    field_bits[i] = (r < 8) ? 1 : (r < 13) ? (r - 6) : (r < 15) ? 8 : 32;
+    field_vals[i] = rand_gen();
+  }
+
+  auto tp = std::chrono::steady_clock::now();
+  for (uint32_t n = 0; n < nof_repetitions; ++n) {
+    bit_ref bref(buf.data(), buf.size());
+    for (uint32_t i = 0; i < field_bits.size(); ++i) {
+      bref.pack(field_vals[i], field_bits[i]);
+    }
+  }
+  auto   tp_pack   = std::chrono::steady_clock::now();
+  double pack_secs = std::chrono::duration_cast<std::chrono::duration<double> >(tp_pack - tp).count();
+
+  uint32_t checksum = 0;
+  for (uint32_t n = 0; n < nof_repetitions; ++n) {
+    cbit_ref bref(buf.data(), buf.size());
+    for (uint32_t i = 0; i < field_bits.size(); ++i) {
+      uint32_t val;
+      bref.unpack(val, field_bits[i]);
+      checksum += val;
+    }
+  }
+  auto   tp_unpack   = std::chrono::steady_clock::now();
+  double unpack_secs = std::chrono::duration_cast<std::chrono::duration<double> >(tp_unpack - tp_pack).count();
+
+  cbit_ref bref(buf.data(), buf.size());
+  for (uint32_t i = 0; i < field_bits.size(); ++i) {
+    uint32_t val;
+    TESTASSERT(bref.unpack(val, field_bits[i]) == SRSASN_SUCCESS);
+    TESTASSERT(val == (field_vals[i] & (uint32_t)((1ul << field_bits[i]) - 1)));
+  }
+
+  printf("Fields (%zd, checksum=%08x): pack=%.2f ns/field; unpack=%.2f ns/field;\n",
+         field_bits.size(),
+         checksum,
+         pack_secs * 1e9 / (nof_repetitions * field_bits.size()),
+         unpack_secs * 1e9 / (nof_repetitions * field_bits.size()));
+
+  return SRSRAN_SUCCESS;
+}
+
+/* Messages */
+
+static void fill_ue_eutra_cap(ue_eutra_cap_s& cap, uint32_t nof_bands)
+{
+  cap.access_stratum_release                    = access_stratum_release_e::rel8;
+  cap.ue_category                               = 4;
+  cap.pdcp_params.max_num_rohc_context_sessions = pdcp_params_s::max_num_rohc_context_sessions_opts::cs16;
+  cap.phy_layer_params.ue_specific_ref_sigs_supported = true;
+  cap.rf_params.supported_band_list_eutra.resize(nof_bands);
+  cap.meas_params.band_list_eutra.resize(nof_bands);
+  for (uint32_t i = 0; i < nof_bands; i++) {
+    cap.rf_params.supported_band_list_eutra[i].band_eutra  = i + 1;
+    cap.rf_params.supported_band_list_eutra[i].half_duplex = (i % 3) == 0;
+    cap.meas_params.band_list_eutra[i].inter_freq_band_list.resize(nof_bands);
+    for (uint32_t j = 0; j < nof_bands; j++) {
+      cap.meas_params.band_list_eutra[i].inter_freq_band_list[j].inter_freq_need_for_gaps = ((i + j) % 2) == 0;
+    }
+  }
+  cap.feature_group_inds_present = true;
+  cap.feature_group_inds.from_number(0xe6041c00);
+}
+
+/// Packs and unpacks the message, and reports the throughput of each
+template <class Msg>
+int bench_pack_unpack(const char* name, const Msg& msg, uint32_t nof_repetitions)
+{
+  std::vector<uint8_t> packed(16384), repacked(16384);
+
+  bit_ref bref(packed.data(), packed.size());
+  TESTASSERT(msg.pack(bref) == SRSASN_SUCCESS);
+  uint32_t msg_len = bref.distance_bytes();
+
+  auto tp = std::chrono::steady_clock::now();
+  for (uint32_t i = 0; i < nof_repetitions; ++i) {
+    bit_ref bref2(repacked.data(), repacked.size());
+    TESTASSERT(msg.pack(bref2) == SRSASN_SUCCESS);
+  }
+  auto   tp_pack   = std::chrono::steady_clock::now();
+  double pack_secs = std::chrono::duration_cast<std::chrono::duration<double> >(tp_pack - tp).count();
+
+  for (uint32_t i = 0; i < nof_repetitions; ++i) {
+    Msg      msg2;
+    cbit_ref bref2(packed.data(), msg_len);
+    TESTASSERT(msg2.unpack(bref2) == SRSASN_SUCCESS);
+  }
+  auto   tp_unpack   = std::chrono::steady_clock::now();
+  double unpack_secs = std::chrono::duration_cast<std::chrono::duration<double> >(tp_unpack - tp_pack).count();
+
+  // Round trip is bit-exact
+  Msg      msg2;
+  cbit_ref bref3(packed.data(), msg_len);
+  TESTASSERT(msg2.unpack(bref3) == SRSASN_SUCCESS);
+  bit_ref bref4(repacked.data(), repacked.size());
+  TESTASSERT(msg2.pack(bref4) == SRSASN_SUCCESS);
+  TESTASSERT((uint32_t)bref4.distance_bytes() == msg_len);
+  TESTASSERT(memcmp(packed.data(), repacked.data(), msg_len) == 0);
+
+  printf("%s (%d B): pack=%.2f us/msg; unpack=%.2f us/msg;\n",
+         name,
+         msg_len,
+         pack_secs * 1e6 / nof_repetitions,
+         unpack_secs * 1e6 / nof_repetitions);
+
+  return SRSRAN_SUCCESS;
+}
+
+int bench_ue_cap_info(uint32_t nof_repetitions)
+{
+  ue_eutra_cap_s cap;
+  fill_ue_eutra_cap(cap, 64);
+  TESTASSERT(bench_pack_unpack("UE-EUTRA-Capability", cap, nof_repetitions) == SRSRAN_SUCCESS);
+
+  uint8_t buf[4096];
+  bit_ref bref(buf, sizeof(buf));
+  TESTASSERT(cap.pack(bref) == SRSASN_SUCCESS);
+  bref.align_bytes_zero();
+
+  ul_dcch_msg_s ul_dcch_msg;
+  ul_dcch_msg.msg.set_c1().set_ue_cap_info().rrc_transaction_id = 0;
+  ue_cap_info_r8_ies_s& info = ul_dcch_msg.msg.c1().ue_cap_info().crit_exts.set_c1().set_ue_cap_info_r8();
+  info.ue_cap_rat_container_list.resize(1);
+  info.ue_cap_rat_container_list[0].rat_type = rat_type_e::eutra;
+  info.ue_cap_rat_container_list[0].ue_cap_rat_container.resize(bref.distance_bytes());
+  memcpy(info.ue_cap_rat_container_list[0].ue_cap_rat_container.data(), buf, bref.distance_bytes());
+  TESTASSERT(bench_pack_unpack("UECapabilityInformation", ul_dcch_msg, nof_repetitions) == SRSRAN_SUCCESS);
+
+  return SRSRAN_SUCCESS;
+}
+
+int bench_sib_list(uint32_t nof_repetitions)
+{
+  // SystemInformation with SIB2 and SIB3
+  uint8_t  rrc_msg[] = {0x00, 0x83, 0x09, 0x92, 0xB7, 0xEC, 0x93, 0x00, 0xA3, 0x42, 0x4B, 0x00, 0x0C,
+                       0x00, 0x05, 0x00, 0x20, 0x5D, 0x6A, 0xAA, 0xF0, 0x42, 0x00, 0xC0, 0x1D, 0xDC,
+                       0x80, 0x1C, 0x48, 0x80, 0x03, 0x00, 0x10, 0xA7, 0x13, 0x22, 0x85, 0x00};
+  cbit_ref bref(rrc_msg, sizeof(rrc_msg));
+
+  bcch_dl_sch_msg_s bcch_msg;
+  TESTASSERT(bcch_msg.unpack(bref) == SRSASN_SUCCESS);
+  TESTASSERT(bench_pack_unpack("SystemInformation", bcch_msg, nof_repetitions) == SRSRAN_SUCCESS);
+
+  return SRSRAN_SUCCESS;
+}
+
+int main(int argc, char** argv)
+{
+  uint32_t nof_repetitions = (argc > 1) ? (uint32_t)strtol(argv[1], nullptr, 10) : 1000;
+
+  auto& asn1_logger = srslog::fetch_basic_logger("ASN1", false);
+  asn1_logger.set_level(srslog::basic_levels::info);
+
+  // Start the log backend.
+  srslog::init();
+
+  TESTASSERT(test_bit_exact_pack_unpack() == SRSRAN_SUCCESS);
+  TESTASSERT(bench_fields(nof_repetitions) == SRSRAN_SUCCESS);
+  TESTASSERT(bench_ue_cap_info(nof_repetitions) == SRSRAN_SUCCESS);
+  TESTASSERT(bench_sib_list(nof_repetitions) == SRSRAN_SUCCESS);
+
+  srslog::flush();
+
+  printf("Success\n");
+  return SRSRAN_SUCCESS;
+}
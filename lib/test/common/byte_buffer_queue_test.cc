@@ -22,7 +22,10 @@
 #define NMSGS 1000000
 
 #include "srsran/common/buffer_pool.h"
+#include "srsran/common/test_common.h"
 #include "srsran/upper/byte_buffer_queue.h"
+#include <atomic>
+#include <chrono>
 #include <stdio.h>
 
 using namespace srsran;
@@ -80,7 +83,100 @@ int test_concurrent_writeread()
   return result;
 }
 
+int test_discard()
+{
+  byte_buffer_queue q(8);
+  for (uint32_t i = 0; i < 8; i++) {
+    unique_byte_buffer_t b = srsran::make_byte_buffer();
+    TESTASSERT(b != nullptr);
+    b->N_bytes    = 10 + i;
+    b->md.pdcp_sn = i;
+    TESTASSERT(q.try_write(std::move(b)));
+  }
+  TESTASSERT(q.is_full());
+  TESTASSERT(q.get_n_sdus() == 8 and q.size_bytes() == 8 * 10 + 28);
+
+  // discarded SDUs are accounted immediately, and skipped by the reader
+  TESTASSERT(q.discard(0));
+  TESTASSERT(q.discard(3));
+  TESTASSERT(not q.discard(3));
+  TESTASSERT(not q.discard(100));
+  TESTASSERT(q.get_n_sdus() == 6 and q.size_bytes() == 8 * 10 + 28 - 10 - 13);
+  TESTASSERT(q.size_tail_bytes() == 11);
+
+  unique_byte_buffer_t b;
+  TESTASSERT(q.try_read(&b) and b->md.pdcp_sn == 1);
+  TESTASSERT(q.try_read(&b) and b->md.pdcp_sn == 2);
+  TESTASSERT(q.try_read(&b) and b->md.pdcp_sn == 4);
+  TESTASSERT(q.get_n_sdus() == 3 and q.size() == 3);
+
+  // shrinking the queue keeps the SDUs that fit
+  q.resize(2);
+  TESTASSERT(q.get_n_sdus() == 2 and q.size_bytes() == 15 + 16 and q.is_full());
+  TESTASSERT(q.try_read(&b) and b->md.pdcp_sn == 5);
+  TESTASSERT(q.try_read(&b) and b->md.pdcp_sn == 6);
+  TESTASSERT(not q.try_read(&b));
+  TESTASSERT(q.is_empty() and q.size_bytes() == 0);
+  return SRSRAN_SUCCESS;
+}
+
+/// Producer/consumer stress test with discards and BSR queries, reporting the SDU rate in Gbps of 1500 B SDUs
+int test_concurrent_stress()
+{
+  const uint32_t        nof_sdus  = 1000000;
+  const uint32_t        sdu_bytes = 1500;
+  byte_buffer_queue     q(1024);
+  std::atomic<uint32_t> nof_discarded(0);
+
+  auto        t0 = std::chrono::steady_clock::now();
+  std::thread producer([&]() {
+    for (uint32_t i = 0; i < nof_sdus; i++) {
+      unique_byte_buffer_t b;
+      while ((b = srsran::make_byte_buffer()) == nullptr) {
+        std::this_thread::yield();
+      }
+      b->N_bytes    = sdu_bytes;
+      b->md.pdcp_sn = i;
+      q.write(std::move(b));
+      if (i % 16 == 15 and q.discard(i - 2)) {
+        nof_discarded++;
+      }
+    }
+  });
+
+  uint32_t nof_read = 0, last_sn = 0;
+  bool     in_order = true;
+  while (nof_read + nof_discarded < nof_sdus) {
+    unique_byte_buffer_t b;
+    if (not q.try_read(&b)) {
+      std::this_thread::yield();
+      continue;
+    }
+    in_order &= nof_read == 0 or b->md.pdcp_sn > last_sn;
+    last_sn = b->md.pdcp_sn;
+    nof_read++;
+  }
+  producer.join();
+  auto t1 = std::chrono::steady_clock::now();
+
+  TESTASSERT(in_order);
+  TESTASSERT(nof_read + nof_discarded == nof_sdus);
+  TESTASSERT(q.is_empty() and q.size_bytes() == 0);
+
+  double secs = std::chrono::duration<double>(t1 - t0).count();
+  printf("nof_sdus=%u; discarded=%u; %.2f Msdus/s; %.1f Gbps of %u B SDUs\n",
+         nof_sdus,
+         nof_discarded.load(),
+         nof_sdus / secs / 1e6,
+         (double)nof_sdus * sdu_bytes * 8 / secs / 1e9,
+         sdu_bytes);
+  return SRSRAN_SUCCESS;
+}
+
 int main()
 {
-  return test_concurrent_writeread();
+  TESTASSERT(test_concurrent_writeread() == SRSRAN_SUCCESS);
+  TESTASSERT(test_discard() == SRSRAN_SUCCESS);
+  TESTASSERT(test_concurrent_stress() == SRSRAN_SUCCESS);
+  return SRSRAN_SUCCESS;
 }
@@ -0,0 +1,262 @@
+/**
+ * Copyright 2013-2021 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "srsran/common/mac_pcap.h"
+#include "srsran/common/pcap_writer.h"
+#include "srsran/common/test_common.h"
+#include <getopt.h>
+#include <stdio.h>
+#include <string.h>
+#include <thread>
+#include <time.h>
+#include <unistd.h>
+#include <vector>
+
+static uint32_t nof_ttis = 1000;
+
+static const char* test_file = "/tmp/pcap_writer_test.pcap";
+
+struct test_header_t {
+  uint32_t thread_idx;
+  uint32_t seq;
+};
+
+// Payload of a record is fully determined by its header
+static uint32_t test_payload(uint32_t thread_idx, uint32_t seq, uint8_t* payload)
+{
+  uint32_t len = 1 + (thread_idx * 131 + seq * 17) % 1500;
+  for (uint32_t i = 0; i < len; i++) {
+    payload[i] = (uint8_t)(thread_idx + seq + i);
+  }
+  return len;
+}
+
+static bool read_file(const std::string& filename, std::vector<uint8_t>& data)
+{
+  FILE* f = fopen(filename.c_str(), "r");
+  if (f == nullptr) {
+    return false;
+  }
+  uint8_t buf[4096];
+  size_t  n;
+  while ((n = fread(buf, 1, sizeof(buf), f)) > 0) {
+    data.insert(data.end(), buf, buf + n);
+  }
+  fclose(f);
+  return true;
+}
+
+// Parses a file written by the test threads and checks the records of each thread are complete and in order
+static int check_file(const std::string& filename, uint32_t dlt, std::vector<uint32_t>& next_seq, uint32_t* nof_records)
+{
+  std::vector<uint8_t> data;
+  TESTASSERT(read_file(filename, data));
+  TESTASSERT(data.size() >= sizeof(pcap_hdr_t));
+
+  pcap_hdr_t file_header;
+  memcpy(&file_header, data.data(), sizeof(pcap_hdr_t));
+  TESTASSERT(file_header.magic_number == 0xa1b2c3d4);
+  TESTASSERT(file_header.version_major == 2 && file_header.version_minor == 4);
+  TESTASSERT(file_header.network == dlt);
+
+  uint8_t expected[1500];
+  size_t  offset = sizeof(pcap_hdr_t);
+  while (offset < data.size()) {
+    pcaprec_hdr_t rec;
+    TESTASSERT(offset + sizeof(pcaprec_hdr_t) <= data.size());
+    memcpy(&rec, &data[offset], sizeof(pcaprec_hdr_t));
+    offset += sizeof(pcaprec_hdr_t);
+    TESTASSERT(rec.incl_len == rec.orig_len && rec.incl_len > sizeof(test_header_t));
+    TESTASSERT(offset + rec.incl_len <= data.size());
+
+    test_header_t hdr;
+    memcpy(&hdr, &data[offset], sizeof(test_header_t));
+    TESTASSERT(hdr.thread_idx < next_seq.size());
+    TESTASSERT(hdr.seq == next_seq[hdr.thread_idx]);
+    next_seq[hdr.thread_idx]++;
+
+    uint32_t len = test_payload(hdr.thread_idx, hdr.seq, expected);
+    TESTASSERT(rec.incl_len == sizeof(test_header_t) + len);
+    TESTASSERT(memcmp(&data[offset + sizeof(test_header_t)], expected, len) == 0);
+    offset += rec.incl_len;
+    (*nof_records)++;
+  }
+  return SRSRAN_SUCCESS;
+}
+
+static void writer_thread(srsran::pcap_writer* writer, uint32_t thread_idx, uint32_t nof_records)
+{
+  uint8_t payload[1500];
+  for (uint32_t seq = 0; seq < nof_records; seq++) {
+    test_header_t hdr = {thread_idx, seq};
+    uint32_t      len = test_payload(thread_idx, seq, payload);
+    while (not writer->write((uint8_t*)&hdr, sizeof(hdr), payload, len)) {
+      usleep(100);
+    }
+  }
+}
+
+// Records of concurrent producers are written complete and in order, also across rotated files
+static int test_multi_thread(uint64_t rotate_bytes)
+{
+  const uint32_t nof_threads = 8;
+  const uint32_t nof_records = 2000;
+
+  srsran::pcap_writer writer("PCAP_TEST", 1U << 16U);
+  TESTASSERT(writer.open(test_file, UDP_DLT, rotate_bytes));
+  TESTASSERT(not writer.open(test_file, UDP_DLT)); // open again will fail
+
+  std::vector<std::thread> threads;
+  for (uint32_t i = 0; i < nof_threads; i++) {
+    threads.emplace_back(writer_thread, &writer, i, nof_records);
+  }
+  for (std::thread& t : threads) {
+    t.join();
+  }
+  writer.close();
+  TESTASSERT(writer.get_nof_written() == nof_threads * nof_records);
+
+  std::vector<uint32_t> next_seq(nof_threads, 0);
+  uint32_t              nof_read = 0;
+  for (uint32_t i = 0; i < writer.get_nof_files(); i++) {
+    std::string filename = i == 0 ? test_file : std::string(test_file) + "." + std::to_string(i);
+    TESTASSERT(check_file(filename, UDP_DLT, next_seq, &nof_read) == SRSRAN_SUCCESS);
+    unlink(filename.c_str());
+  }
+  TESTASSERT(nof_read == nof_threads * nof_records);
+  for (uint32_t i = 0; i < nof_threads; i++) {
+    TESTASSERT(next_seq[i] == nof_records);
+  }
+  if (rotate_bytes > 0) {
+    TESTASSERT(writer.get_nof_files() > 1);
+  }
+
+  printf("rotate_bytes=%" PRIu64 "; nof_files=%d; nof_records=%d;\n", rotate_bytes, writer.get_nof_files(), nof_read);
+  return SRSRAN_SUCCESS;
+}
+
+// A full queue drops and counts packets instead of blocking the caller
+static int test_queue_full()
+{
+  srsran::pcap_writer writer("PCAP_TEST", 4096);
+  TESTASSERT(writer.open(test_file, NAS_LTE_DLT));
+
+  uint8_t        payload[1000] = {};
+  const uint32_t nof_packets   = 100;
+  for (uint32_t i = 0; i < nof_packets; i++) {
+    writer.write(nullptr, 0, payload, sizeof(payload));
+  }
+  writer.close();
+  TESTASSERT(writer.get_nof_dropped() > 0);
+  TESTASSERT(writer.get_nof_written() + writer.get_nof_dropped() == nof_packets);
+  TESTASSERT(not writer.write(nullptr, 0, payload, sizeof(payload))); // closed
+
+  std::vector<uint8_t> data;
+  TESTASSERT(read_file(test_file, data));
+  TESTASSERT(data.size() == sizeof(pcap_hdr_t) + writer.get_nof_written() * (sizeof(pcaprec_hdr_t) + sizeof(payload)));
+  unlink(test_file);
+  return SRSRAN_SUCCESS;
+}
+
+static double thread_time_us()
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+  return ts.tv_sec * 1e6 + ts.tv_nsec / 1e3;
+}
+
+// MAC PCAP cost in the PHY worker for a 20 MHz full buffer cell, one DL and one UL transport block per TTI
+static int test_mac_pcap_cost()
+{
+  const uint32_t dl_tbs = 9422; // 100 PRB, MCS 28, 1 layer
+  const uint32_t ul_tbs = 6200; // 100 PRB, 64QAM
+
+  std::vector<uint8_t> dl_pdu(dl_tbs, 0xaa);
+  std::vector<uint8_t> ul_pdu(ul_tbs, 0x55);
+
+  srsran::mac_pcap pcap;
+  TESTASSERT(pcap.open(test_file) == SRSRAN_SUCCESS);
+
+  double worker_us = 0;
+  for (uint32_t tti = 0; tti < nof_ttis; tti++) {
+    double t0 = thread_time_us();
+    pcap.write_dl_crnti(dl_pdu.data(), dl_tbs, 0x46, true, tti % 10240, 0);
+    pcap.write_ul_crnti(ul_pdu.data(), ul_tbs, 0x46, 0, tti % 10240, 0);
+    worker_us += thread_time_us() - t0;
+
+    // Keep the real-time rate so the writer thread drains as it would in the eNB
+    usleep(1000);
+  }
+  TESTASSERT(pcap.close() == SRSRAN_SUCCESS);
+
+  std::vector<uint8_t> data;
+  TESTASSERT(read_file(test_file, data));
+  unlink(test_file);
+
+  double load = worker_us / (nof_ttis * 1000.0);
+  printf("nof_ttis=%d; file_size=%zd B; write cost=%.2f us/TTI; PHY worker load=%.2f%%;\n",
+         nof_ttis,
+         data.size(),
+         worker_us / nof_ttis,
+         load * 100.0);
+
+  // Nothing dropped, every PDU made it into the file
+  TESTASSERT(data.size() > sizeof(pcap_hdr_t) + nof_ttis * (dl_tbs + ul_tbs));
+  TESTASSERT(load < 0.02);
+  return SRSRAN_SUCCESS;
+}
+
+static void usage(char* prog)
+{
+  printf("Usage: %s [n]\n", prog);
+  printf("\t-n Number of TTIs in the MAC PCAP benchmark [Default %d]\n", nof_ttis);
+}
+
+static void parse_args(int argc, char** argv)
+{
+  int opt;
+  while ((opt = getopt(argc, argv, "n")) != -1) {
+    switch (opt) {
+      case 'n':
+        nof_ttis = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      default:
+        usage(argv[0]);
+        exit(-1);
+    }
+  }
+}
+
+int main(int argc, char** argv)
+{
+  parse_args(argc, argv);
+
+  srslog::init();
+
+  TESTASSERT(test_multi_thread(0) == SRSRAN_SUCCESS);
+  TESTASSERT(test_multi_thread(1U << 20U) == SRSRAN_SUCCESS);
+  TESTASSERT(test_queue_full() == SRSRAN_SUCCESS);
+  TESTASSERT(test_mac_pcap_cost() == SRSRAN_SUCCESS);
+
+  srslog::flush();
+  printf("Ok!\n");
+  return SRSRAN_SUCCESS;
+}
@@ -21,6 +21,8 @@
 
 #include "srsran/common/test_common.h"
 #include "srsran/common/timers.h"
+#include <atomic>
+#include <chrono>
 #include <iostream>
 #include <random>
 #include <srsran/common/tti_sync_cv.h>
@@ -450,6 +452,120 @@ int timers_test7()
   return SRSRAN_SUCCESS;
 }
 
+/**
+ * Tests specific to the hierarchical wheel:
+ * - timers with timeouts spanning several wheel levels expire exactly at their timeout, after being cascaded
+ * - restarting and stopping timers that are linked in the upper levels
+ */
+int timers_test8()
+{
+  timer_handler                           timers;
+  const uint32_t                          nof_timers   = 1000;
+  const uint32_t                          max_duration = 100000;
+  std::mt19937                            mt19937(8);
+  std::uniform_int_distribution<uint32_t> dur_dist(1, max_duration);
+  std::vector<unique_timer>               utimers(nof_timers);
+  std::vector<uint32_t>                   expiry(nof_timers, 0);
+  std::vector<uint32_t>                   expected(nof_timers, 0);
+  uint32_t                                now = 0;
+
+  for (uint32_t i = 0; i < nof_timers; ++i) {
+    utimers[i] = timers.get_unique_timer();
+    utimers[i].set(dur_dist(mt19937), [&expiry, &now, i](uint32_t tid) { expiry[i] = now; });
+    utimers[i].run();
+    expected[i] = utimers[i].duration();
+  }
+
+  for (uint32_t t = 0; t < 2 * max_duration; ++t) {
+    // restart or stop some timers
+    uint32_t i = mt19937() % nof_timers;
+    if (t < max_duration and t % 7 == 0) {
+      if (mt19937() % 4 == 0) {
+        // stopping an expired timer leaves it expired
+        if (utimers[i].is_running()) {
+          utimers[i].stop();
+          expected[i] = 0;
+          expiry[i]   = 0;
+        }
+      } else {
+        utimers[i].set(dur_dist(mt19937));
+        utimers[i].run();
+        expected[i] = now + utimers[i].duration();
+        expiry[i]   = 0;
+      }
+    }
+    now++;
+    timers.step_all();
+  }
+
+  for (uint32_t i = 0; i < nof_timers; ++i) {
+    TESTASSERT(expiry[i] == expected[i]);
+    TESTASSERT(utimers[i].is_expired() == (expected[i] != 0));
+  }
+  TESTASSERT(timers.nof_running_timers() == 0);
+
+  return SRSRAN_SUCCESS;
+}
+
+/**
+ * Benchmark of step_all() cost and run()/stop() latency, against the number of running timers and of threads
+ * starting/stopping them
+ */
+int timers_test9(uint32_t nof_running, uint32_t nof_threads)
+{
+  timer_handler             timers(nof_running);
+  const uint32_t            nof_steps = 1000;
+  std::vector<unique_timer> utimers;
+  for (uint32_t i = 0; i < nof_running; ++i) {
+    utimers.push_back(timers.get_unique_timer());
+    utimers.back().set(2 * nof_steps + i % 60000);
+    utimers.back().run();
+  }
+
+  // Each thread restarts and stops its share of timers while time advances
+  std::atomic<bool>        running(true);
+  std::atomic<uint32_t>    nof_started(0);
+  std::atomic<uint64_t>    nof_cmds(0), cmd_ns(0);
+  std::vector<std::thread> threads;
+  for (uint32_t n = 0; n < nof_threads; ++n) {
+    threads.emplace_back([&, n]() {
+      nof_started++;
+      uint64_t count = 0;
+      auto     t0    = std::chrono::steady_clock::now();
+      for (uint32_t i = n; running; i = (i + nof_threads) % nof_running) {
+        utimers[i].stop();
+        utimers[i].run();
+        count += 2;
+      }
+      auto t1 = std::chrono::steady_clock::now();
+      nof_cmds += count;
+      cmd_ns += std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count();
+    });
+  }
+
+  while (nof_started < nof_threads) {
+    std::this_thread::yield();
+  }
+  auto t0 = std::chrono::steady_clock::now();
+  for (uint32_t t = 0; t < nof_steps; ++t) {
+    timers.step_all();
+  }
+  auto t1 = std::chrono::steady_clock::now();
+  running = false;
+  for (std::thread& th : threads) {
+    th.join();
+  }
+  TESTASSERT(timers.nof_running_timers() == nof_running);
+
+  double step_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count() / (double)nof_steps;
+  printf("running timers=%6d; threads=%d; step_all=%8.1f ns; run/stop=%6.1f ns\n",
+         nof_running,
+         nof_threads,
+         step_ns,
+         nof_cmds > 0 ? cmd_ns / (double)nof_cmds : 0.0);
+  return SRSRAN_SUCCESS;
+}
+
 int main()
 {
   TESTASSERT(timers_test1() == SRSRAN_SUCCESS);
@@ -459,6 +575,12 @@ int main()
   TESTASSERT(timers_test5() == SRSRAN_SUCCESS);
   TESTASSERT(timers_test6() == SRSRAN_SUCCESS);
   TESTASSERT(timers_test7() == SRSRAN_SUCCESS);
+  TESTASSERT(timers_test8() == SRSRAN_SUCCESS);
+  for (uint32_t nof_running : {1000, 10000, 50000}) {
+    for (uint32_t nof_threads : {0, 1, 4}) {
+      TESTASSERT(timers_test9(nof_running, nof_threads) == SRSRAN_SUCCESS);
+    }
+  }
   printf("Success\n");
   return 0;
 }
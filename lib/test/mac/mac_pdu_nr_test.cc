@@ -658,6 +658,62 @@ int mac_ul_sch_pdu_unpack_test6()
   return SRSRAN_SUCCESS;
 }
 
+// Writes up to "sdu_len" bytes of a counter pattern, like RLC would
+class dummy_rlc : public srsran::read_pdu_interface
+{
+public:
+  explicit dummy_rlc(uint32_t sdu_len_) : sdu_len(sdu_len_) {}
+  int read_pdu(uint32_t lcid, uint8_t* payload, uint32_t requested_bytes) override
+  {
+    uint32_t len = SRSRAN_MIN(sdu_len, requested_bytes);
+    for (uint32_t i = 0; i < len; i++) {
+      payload[i] = i % 256;
+    }
+    return len;
+  }
+
+private:
+  uint32_t sdu_len;
+};
+
+int mac_ul_sch_pdu_pack_in_place_test7()
+{
+  // SDUs read straight into the PDU must result in the same PDU as SDUs copied into it, for both 8-bit and 16-bit L
+  // fields, also when the SDU is shorter than the space reserved for it
+  for (uint32_t sdu_len : {100, 255, 256, 512}) {
+    uint8_t sdu[512] = {};
+    for (uint32_t i = 0; i < sdu_len; i++) {
+      sdu[i] = i % 256;
+    }
+
+    byte_buffer_t          ref_buffer;
+    srsran::mac_sch_pdu_nr ref_pdu;
+    ref_pdu.init_tx(&ref_buffer, 1024, true);
+    TESTASSERT(ref_pdu.add_sdu(2, sdu, sdu_len) == SRSRAN_SUCCESS);
+    ref_pdu.pack();
+
+    byte_buffer_t          tx_buffer;
+    srsran::mac_sch_pdu_nr tx_pdu;
+    dummy_rlc              rlc(sdu_len);
+    tx_pdu.init_tx(&tx_buffer, 1024, true);
+    TESTASSERT(tx_pdu.add_sdu(2, 1021, &rlc) == (int32_t)sdu_len);
+    tx_pdu.pack();
+
+    TESTASSERT(tx_buffer.N_bytes == ref_buffer.N_bytes);
+    TESTASSERT(memcmp(tx_buffer.msg, ref_buffer.msg, ref_buffer.N_bytes) == 0);
+  }
+
+  // Nothing is added when RLC has no data
+  byte_buffer_t          tx_buffer;
+  srsran::mac_sch_pdu_nr tx_pdu;
+  dummy_rlc              rlc(0);
+  tx_pdu.init_tx(&tx_buffer, 1024, true);
+  TESTASSERT(tx_pdu.add_sdu(2, 1021, &rlc) == 0);
+  TESTASSERT(tx_pdu.get_remaing_len() == 1024);
+
+  return SRSRAN_SUCCESS;
+}
+
 int main(int argc, char** argv)
 {
 #if PCAP
@@ -751,6 +807,11 @@ int main(int argc, char** argv)
     return SRSRAN_ERROR;
   }
 
+  if (mac_ul_sch_pdu_pack_in_place_test7()) {
+    fprintf(stderr, "mac_ul_sch_pdu_pack_in_place_test7() failed.\n");
+    return SRSRAN_ERROR;
+  }
+
   if (pcap_handle) {
     pcap_handle->close();
   }
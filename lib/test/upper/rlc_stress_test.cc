@@ -561,25 +561,27 @@ void stress_test(stress_test_args_t args)
     pcap.close();
   }
 
+  // Prints the SDU and PDU reception rates of one direction of the link
+  auto print_rx_rates = [&args](const char* direction, int nof_rx_sdus, const rlc_bearer_metrics_t& bearer) {
+    printf("%s: received %d SDUs (%.2f/s) and %" PRIu32 " PDUs (%.2f/s) in %" PRIu32 "s, Tx=%" PRIu64
+           " B, Rx=%" PRIu64 " B\n",
+           direction,
+           nof_rx_sdus,
+           static_cast<double>(nof_rx_sdus) / args.test_duration_sec,
+           bearer.num_rx_pdus,
+           static_cast<double>(bearer.num_rx_pdus) / args.test_duration_sec,
+           args.test_duration_sec,
+           bearer.num_tx_pdu_bytes,
+           bearer.num_rx_pdu_bytes);
+    rlc_bearer_metrics_print(bearer);
+  };
+
   rlc_metrics_t metrics = {};
   rlc1.get_metrics(metrics, 1);
-
-  printf("RLC1 received %d SDUs in %ds (%.2f/s), Tx=%" PRIu64 " B, Rx=%" PRIu64 " B\n",
-         tester1.get_nof_rx_pdus(),
-         args.test_duration_sec,
-         static_cast<double>(tester1.get_nof_rx_pdus() / args.test_duration_sec),
-         metrics.bearer[lcid].num_tx_pdu_bytes,
-         metrics.bearer[lcid].num_rx_pdu_bytes);
-  rlc_bearer_metrics_print(metrics.bearer[lcid]);
+  print_rx_rates("RLC2 -> RLC1", tester1.get_nof_rx_pdus(), metrics.bearer[lcid]);
 
   rlc2.get_metrics(metrics, 1);
-  printf("RLC2 received %d SDUs in %ds (%.2f/s), Tx=%" PRIu64 " B, Rx=%" PRIu64 " B\n",
-         tester2.get_nof_rx_pdus(),
-         args.test_duration_sec,
-         static_cast<double>(tester2.get_nof_rx_pdus() / args.test_duration_sec),
-         metrics.bearer[lcid].num_tx_pdu_bytes,
-         metrics.bearer[lcid].num_rx_pdu_bytes);
-  rlc_bearer_metrics_print(metrics.bearer[lcid]);
+  print_rx_rates("RLC1 -> RLC2", tester2.get_nof_rx_pdus(), metrics.bearer[lcid]);
 }
 
 int main(int argc, char** argv)
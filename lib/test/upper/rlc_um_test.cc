@@ -21,7 +21,9 @@
 
 #include "rlc_test_common.h"
 #include "srsran/upper/rlc_um_lte.h"
+#include <chrono>
 #include <iostream>
+#include <random>
 
 #define TESTASSERT(cond)                                                                                               \
   {                                                                                                                    \
@@ -433,6 +435,159 @@ int pdu_pack_no_space_test()
   return SRSRAN_SUCCESS;
 }
 
+/* Segmented and concatenated PDUs built straight into the MAC payload, checked against known PDU bytes. The payload
+ * past the PDU must be left untouched
+ */
+int build_pdu_in_place_vector_test()
+{
+  srslog::basic_logger& logger = srslog::fetch_basic_logger("RLC_UM_IN_PLACE", false);
+  srsran::timer_handler timers(16);
+  rlc_um_tester         tester;
+  rlc_um_lte            rlc(logger, 3, &tester, &tester, &timers);
+  TESTASSERT(rlc.configure(rlc_config_t::default_rlc_um_config(10)));
+
+  const uint8_t sdus[][5]   = {{0x11, 0x22, 0x33}, {0x44, 0x55, 0x66, 0x77, 0x88}, {0x99, 0xaa}};
+  const uint8_t sdu_lens[]  = {3, 5, 2};
+  const uint8_t guard       = 0xa5;
+  uint8_t       payload[16] = {};
+  for (uint32_t i = 0; i < 3; i++) {
+    unique_byte_buffer_t sdu = srsran::make_byte_buffer();
+    TESTASSERT(sdu != nullptr);
+    memcpy(sdu->msg, sdus[i], sdu_lens[i]);
+    sdu->N_bytes = sdu_lens[i];
+    rlc.write_sdu(std::move(sdu));
+  }
+
+  // SN=0, FI=00, the 2nd SDU does not fit with its LI
+  const uint8_t pdu0[] = {0x00, 0x00, 0x11, 0x22, 0x33};
+  // SN=1, FI=01, first 4 bytes of the 2nd SDU
+  const uint8_t pdu1[] = {0x08, 0x01, 0x44, 0x55, 0x66, 0x77};
+  // SN=2, FI=10, E=1, LI=1 for the tail of the 2nd SDU, then the 3rd SDU
+  const uint8_t pdu2[] = {0x14, 0x02, 0x00, 0x10, 0x88, 0x99, 0xaa};
+
+  const uint8_t* pdus[]     = {pdu0, pdu1, pdu2};
+  const uint32_t pdu_lens[] = {sizeof(pdu0), sizeof(pdu1), sizeof(pdu2)};
+  const uint32_t grants[]   = {7, 6, 10};
+  for (uint32_t i = 0; i < 3; i++) {
+    memset(payload, guard, sizeof(payload));
+    int len = rlc.read_pdu(payload, grants[i]);
+    TESTASSERT(len == (int)pdu_lens[i]);
+    TESTASSERT(memcmp(payload, pdus[i], pdu_lens[i]) == 0);
+    for (uint32_t j = pdu_lens[i]; j < sizeof(payload); j++) {
+      TESTASSERT(payload[j] == guard);
+    }
+  }
+  TESTASSERT(rlc.get_buffer_state() == 0);
+
+  return SRSRAN_SUCCESS;
+}
+
+/* Random SDU and grant sizes, from many LIs per PDU to several PDUs per SDU, built in place and reassembled by a
+ * second RLC entity. Each SDU is filled with its own value, so a wrong boundary is caught by the tester
+ */
+int build_pdu_in_place_test(uint32_t sn_size)
+{
+  srslog::basic_logger& logger_tx = srslog::fetch_basic_logger("RLC_UM_1", false);
+  srslog::basic_logger& logger_rx = srslog::fetch_basic_logger("RLC_UM_2", false);
+  srsran::timer_handler timers(16);
+  rlc_um_tester         tester_tx, tester_rx;
+  rlc_um_lte            rlc_tx(logger_tx, 3, &tester_tx, &tester_tx, &timers);
+  rlc_um_lte            rlc_rx(logger_rx, 3, &tester_rx, &tester_rx, &timers);
+  rlc_config_t          cnfg = rlc_config_t::default_rlc_um_config(sn_size);
+  TESTASSERT(rlc_tx.configure(cnfg));
+  TESTASSERT(rlc_rx.configure(cnfg));
+  logger_tx.set_level(srslog::basic_levels::error);
+  logger_rx.set_level(srslog::basic_levels::error);
+
+  std::mt19937                            rng(sn_size);
+  std::uniform_int_distribution<uint32_t> sdu_len_dist(1, 1500);
+  std::uniform_int_distribution<uint32_t> small_sdu_len_dist(1, 10);
+  const uint32_t                          grant_sizes[] = {1, 3, 4, 7, 16, 100, 333, 1000, 1501, 4000};
+  const uint8_t                           guard         = 0xa5;
+
+  std::vector<uint8_t>  payload(4000 + 16);
+  std::vector<uint32_t> sdu_lens;
+  uint32_t              nof_pdus = 0;
+
+  for (uint32_t round = 0; round < 200; round++) {
+    for (uint32_t i = 0; i < 8; i++) {
+      uint32_t             len = (i % 2 == 0) ? small_sdu_len_dist(rng) : sdu_len_dist(rng);
+      unique_byte_buffer_t sdu = srsran::make_byte_buffer();
+      TESTASSERT(sdu != nullptr);
+      memset(sdu->msg, sdu_lens.size(), len);
+      sdu->N_bytes = len;
+      rlc_tx.write_sdu(std::move(sdu));
+      sdu_lens.push_back(len);
+    }
+
+    // Leave the last SDU half transmitted now and then, so the next round starts with a segment
+    uint32_t threshold = (round % 3 == 0 or round == 199) ? 0 : 500;
+    while (rlc_tx.get_buffer_state() > threshold) {
+      uint32_t grant = grant_sizes[nof_pdus % (sizeof(grant_sizes) / sizeof(grant_sizes[0]))];
+      std::fill(payload.begin(), payload.end(), guard);
+
+      int len = rlc_tx.read_pdu(payload.data(), grant);
+      TESTASSERT(len >= 0 and len <= (int)grant);
+      for (uint32_t i = len; i < payload.size(); i++) {
+        TESTASSERT(payload[i] == guard);
+      }
+      if (len > 0) {
+        rlc_rx.write_pdu(payload.data(), len);
+      }
+      nof_pdus++;
+    }
+  }
+
+  TESTASSERT(tester_rx.sdus.size() == sdu_lens.size());
+  for (uint32_t i = 0; i < sdu_lens.size(); i++) {
+    TESTASSERT(tester_rx.sdus[i]->N_bytes == sdu_lens[i]);
+    TESTASSERT(tester_rx.sdus[i]->msg[0] == (uint8_t)i);
+  }
+
+  return SRSRAN_SUCCESS;
+}
+
+/* Time per PDU byte of the in-place build, with 1500 byte SDUs and a full 20 MHz transport block per PDU */
+int build_pdu_in_place_benchmark()
+{
+  srslog::basic_logger& logger = srslog::fetch_basic_logger("RLC_UM_IN_PLACE", false);
+  srsran::timer_handler timers(16);
+  rlc_um_tester         tester;
+  rlc_um_lte            rlc(logger, 3, &tester, &tester, &timers);
+  TESTASSERT(rlc.configure(rlc_config_t::default_rlc_um_config(10)));
+
+  const uint32_t nof_pdus = 2000;
+  const uint32_t sdu_len  = 1500;
+  const uint32_t grant    = 75376 / 8; // Largest TBS with 100 PRB and one layer
+
+  std::vector<uint8_t> payload(grant);
+  uint64_t             nof_pdu_bytes = 0;
+  uint64_t             ns            = 0;
+
+  for (uint32_t n = 0; n < nof_pdus; n++) {
+    // Keep a PDU worth of SDUs queued
+    while (rlc.get_buffer_state() < 2 * grant) {
+      unique_byte_buffer_t sdu = srsran::make_byte_buffer();
+      TESTASSERT(sdu != nullptr);
+      memset(sdu->msg, n, sdu_len);
+      sdu->N_bytes = sdu_len;
+      rlc.write_sdu(std::move(sdu));
+    }
+
+    auto t0  = std::chrono::steady_clock::now();
+    int  len = rlc.read_pdu(payload.data(), grant);
+    auto t1  = std::chrono::steady_clock::now();
+    TESTASSERT(len > 0);
+
+    nof_pdu_bytes += len;
+    ns += std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count();
+  }
+
+  printf("RLC UM PDU build, %u B PDUs: %.3f ns per PDU byte\n", grant, (double)ns / nof_pdu_bytes);
+
+  return SRSRAN_SUCCESS;
+}
+
 int main(int argc, char** argv)
 {
   srslog::init();
@@ -458,4 +613,10 @@ int main(int argc, char** argv)
   }
 
   TESTASSERT(pdu_pack_no_space_test() == 0);
+
+  TESTASSERT(build_pdu_in_place_vector_test() == 0);
+  TESTASSERT(build_pdu_in_place_test(5) == 0);
+  TESTASSERT(build_pdu_in_place_test(10) == 0);
+
+  TESTASSERT(build_pdu_in_place_benchmark() == 0);
 }
@@ -55,7 +55,9 @@ public:
   int  read_pucch_d(cf_t* pusch_d);
   void start_plot();
 
-  void work_ul(const srsran_ul_sf_cfg_t& ul_sf, stack_interface_phy_lte::ul_sched_t& ul_grants);
+  void work_ul(const srsran_ul_sf_cfg_t&            ul_sf,
+               stack_interface_phy_lte::ul_sched_t& ul_grants,
+               const struct timespec&               rx_time);
   void work_dl(const srsran_dl_sf_cfg_t&            dl_sf_cfg,
                stack_interface_phy_lte::dl_sched_t& dl_grants,
                stack_interface_phy_lte::ul_sched_t& ul_grants,
@@ -71,8 +73,11 @@ private:
   int  encode_pmch(stack_interface_phy_lte::dl_sched_grant_t* grant, srsran_mbsfn_cfg_t* mbsfn_cfg);
   void decode_pusch_rnti(stack_interface_phy_lte::ul_sched_grant_t& ul_grant,
                          srsran_ul_cfg_t&                           ul_cfg,
-                         srsran_pusch_res_t&                        pusch_res);
+                         srsran_pusch_res_t&                        pusch_res,
+                         const struct timespec*                     deadline,
+                         bool                                       shed);
   void decode_pusch(stack_interface_phy_lte::ul_sched_grant_t* grants, uint32_t nof_pusch);
+  bool is_pusch_priority(const stack_interface_phy_lte::ul_sched_grant_t& ul_grant);
   int  encode_phich(stack_interface_phy_lte::ul_sched_ack_t* acks, uint32_t nof_acks);
   int  encode_pdcch_dl(stack_interface_phy_lte::dl_sched_grant_t* grants, uint32_t nof_grants);
   int  encode_pdcch_ul(stack_interface_phy_lte::ul_sched_grant_t* grants, uint32_t nof_grants);
@@ -95,6 +100,11 @@ private:
 
   srsran_softbuffer_tx_t temp_mbsfn_softbuffer = {};
 
+  // PUSCH decoding deadline for the current subframe in this carrier, CLOCK_MONOTONIC ns
+  bool                    ul_deadline_en = false;
+  int64_t                 ul_deadline_ns = 0;
+  srsran_pusch_deadline_t pusch_deadline = {}; ///< Learns the PUSCH decoding time, predicts whether a PUSCH still fits
+
   // Class to store user information
   class ue
   {
@@ -108,7 +118,8 @@ private:
 
     void     metrics_read(phy_metrics_t* metrics);
     void     metrics_dl(uint32_t mcs);
-    void     metrics_ul(uint32_t mcs, float rssi, float sinr, float turbo_iters);
+    void     metrics_ul(uint32_t mcs, float rssi, float sinr, float turbo_iters, uint32_t turbo_iters_shed);
+    void     metrics_ul_shed();
     void     metrics_ul_pucch(float sinr);
     uint32_t get_rnti() const { return rnti; }
 
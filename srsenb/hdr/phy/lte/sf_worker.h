@@ -72,6 +72,7 @@ private:
   uint32_t               t_rx = 0, t_tx_dl = 0, t_tx_ul = 0;
   uint32_t               tx_worker_cnt = 0;
   srsran::rf_timestamp_t tx_time       = {};
+  struct timespec        rx_time       = {}; ///< CLOCK_MONOTONIC time the subframe was handed to this worker
 
   std::vector<std::unique_ptr<cc_worker> > cc_workers;
 
@@ -63,6 +63,7 @@ struct phy_args_t {
   float       max_prach_offset_us = 10;
   int         pusch_max_its       = 10;
   bool        pusch_8bit_decoder  = false;
+  uint32_t    pusch_deadline_us   = 0;
   float       tx_amplitude        = 1.0f;
   uint32_t    nof_phy_threads     = 1;
   std::string equalizer_mode      = "mmse";
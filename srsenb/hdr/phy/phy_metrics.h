@@ -32,9 +32,11 @@ struct ul_metrics_t {
   float pucch_sinr;
   float rssi;
   float turbo_iters;
+  float turbo_iters_shed; ///< Turbo decoder iterations cut per PUSCH to meet the decoding deadline
   float mcs;
   int   n_samples;
   int   n_samples_pucch;
+  int   n_pusch_shed; ///< PUSCH left undecoded to meet the decoding deadline
 };
 
 struct dl_metrics_t {
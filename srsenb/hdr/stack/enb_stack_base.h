@@ -84,6 +84,7 @@ typedef struct {
   pcap_args_t      mac_pcap;
   pcap_net_args_t  mac_pcap_net;
   pcap_args_t      s1ap_pcap;
+  uint32_t         pcap_max_file_size; // Capture files continue in <filename>.1, .2, ... beyond this size (MB)
   stack_log_args_t log;
   embms_args_t     embms;
   core_less_args_t coreless;
@@ -193,6 +193,7 @@ private:
 
   // Softbuffer pool
   std::unique_ptr<srsran::obj_pool_itf<ue_cc_softbuffers> > softbuffer_pool;
+  std::shared_ptr<softbuffer_cb_pools>                      softbuffer_cb_pool;
 };
 
 } // namespace srsenb
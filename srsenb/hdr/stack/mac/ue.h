@@ -36,6 +36,7 @@
 #include "srsran/srslog/srslog.h"
 
 #include "ta.h"
+#include <memory>
 #include <pthread.h>
 #include <vector>
 
@@ -45,18 +46,42 @@ class rrc_interface_mac;
 class rlc_interface_mac;
 class phy_interface_stack_lte;
 
+/**
+ * Code block storage shared by the softbuffers of all UEs and carriers. Softbuffers lease storage for the TB in flight
+ * of a HARQ process only, so the memory follows the number of scheduled HARQ processes instead of the number of UEs
+ */
+struct softbuffer_cb_pools {
+  srsran_softbuffer_pool_t tx = {};
+  srsran_softbuffer_pool_t rx = {};
+
+  softbuffer_cb_pools(uint32_t nof_prb, uint32_t nof_prealloc_cb);
+  softbuffer_cb_pools(const softbuffer_cb_pools&) = delete;
+  softbuffer_cb_pools& operator=(const softbuffer_cb_pools&) = delete;
+  ~softbuffer_cb_pools();
+};
+
 struct ue_cc_softbuffers {
   // List of Tx softbuffers for all HARQ processes of one carrier
   using cc_softbuffer_tx_list_t = std::vector<srsran_softbuffer_tx_t>;
   // List of Rx softbuffers for all HARQ processes of one carrier
   using cc_softbuffer_rx_list_t = std::vector<srsran_softbuffer_rx_t>;
 
-  const uint32_t          nof_tx_harq_proc;
-  const uint32_t          nof_rx_harq_proc;
-  cc_softbuffer_tx_list_t softbuffer_tx_list;
-  cc_softbuffer_rx_list_t softbuffer_rx_list;
-
-  ue_cc_softbuffers(uint32_t nof_prb, uint32_t nof_tx_harq_proc_, uint32_t nof_rx_harq_proc_);
+  // Leased storage not released by an ACK or a CRC OK is reclaimed after this number of TTIs
+  static const uint32_t expiry_ttis = 32 * SRSRAN_FDD_NOF_HARQ;
+
+  const uint32_t                       nof_tx_harq_proc;
+  const uint32_t                       nof_rx_harq_proc;
+  std::shared_ptr<softbuffer_cb_pools> cb_pools;
+  cc_softbuffer_tx_list_t              softbuffer_tx_list;
+  cc_softbuffer_rx_list_t              softbuffer_rx_list;
+  std::vector<uint32_t>                tx_last_tti;
+  std::vector<uint32_t>                rx_last_tti;
+
+  // Without code block pools, every softbuffer allocates the storage for the largest TB upfront
+  ue_cc_softbuffers(uint32_t                             nof_prb,
+                    uint32_t                             nof_tx_harq_proc_,
+                    uint32_t                             nof_rx_harq_proc_,
+                    std::shared_ptr<softbuffer_cb_pools> cb_pools_ = nullptr);
   ue_cc_softbuffers(ue_cc_softbuffers&&) noexcept = default;
   ~ue_cc_softbuffers();
   void clear();
@@ -66,6 +91,15 @@ struct ue_cc_softbuffers {
     return softbuffer_tx_list.at(pid * SRSRAN_MAX_TB + tb_idx);
   }
   srsran_softbuffer_rx_t& get_rx(uint32_t tti) { return softbuffer_rx_list.at(tti % nof_rx_harq_proc); }
+
+  // A non-zero TBS starts a new TB, which leases (or resets) the storage. They return nullptr if the lease fails
+  srsran_softbuffer_tx_t* get_tx(uint32_t tti, uint32_t pid, uint32_t tb_idx, uint32_t tbs);
+  srsran_softbuffer_rx_t* get_rx(uint32_t tti, uint32_t tbs);
+
+  // Gives back the storage of the TB last transmitted (Tx) or received (Rx) in the given TTI
+  void release_tx(uint32_t tti, uint32_t tb_idx);
+  void release_rx(uint32_t tti);
+  void release_expired(uint32_t tti);
 };
 
 class cc_used_buffers_map
@@ -108,6 +142,7 @@ public:
   void deallocate_cc();
 
   bool                    empty() const { return cc_softbuffers == nullptr; }
+  ue_cc_softbuffers&      get_softbuffers() { return *cc_softbuffers; }
   srsran_softbuffer_tx_t& get_tx_softbuffer(uint32_t pid, uint32_t tb_idx)
   {
     return cc_softbuffers->get_tx(pid, tb_idx);
@@ -163,9 +198,14 @@ public:
   uint8_t*
   generate_mch_pdu(uint32_t harq_pid, sched_interface::dl_pdu_mch_t sched, uint32_t nof_pdu_elems, uint32_t grant_size);
 
-  srsran_softbuffer_tx_t*
-                          get_tx_softbuffer(const uint32_t ue_cc_idx, const uint32_t harq_process, const uint32_t tb_idx);
-  srsran_softbuffer_rx_t* get_rx_softbuffer(const uint32_t ue_cc_idx, const uint32_t tti);
+  srsran_softbuffer_tx_t* get_tx_softbuffer(const uint32_t ue_cc_idx,
+                                            const uint32_t harq_process,
+                                            const uint32_t tb_idx,
+                                            const uint32_t tti,
+                                            const uint32_t tbs);
+  srsran_softbuffer_rx_t* get_rx_softbuffer(const uint32_t ue_cc_idx, const uint32_t tti, const uint32_t tbs);
+  void                    release_tx_softbuffer(const uint32_t ue_cc_idx, const uint32_t tti, const uint32_t tb_idx);
+  void                    release_rx_softbuffer(const uint32_t ue_cc_idx, const uint32_t tti);
 
   bool     process_pdus();
   uint8_t* request_buffer(uint32_t tti, uint32_t ue_cc_idx, const uint32_t len);
@@ -224,6 +264,7 @@ private:
   // Mutexes
   std::mutex mutex;
   std::mutex rx_buffers_mutex;
+  std::mutex softbuffers_mutex;
 
   const uint8_t UL_CC_IDX = 0; ///< Passed to write CC index in PCAP (TODO: use actual CC idx)
 };
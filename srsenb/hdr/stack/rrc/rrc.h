@@ -174,8 +174,11 @@ private:
   // state
   std::unique_ptr<freq_res_common_list>          cell_res_list;
   std::map<uint16_t, unique_rnti_ptr<ue> >       users; // NOTE: has to have fixed addr
-  std::map<uint32_t, asn1::rrc::paging_record_s> pending_paging;
+  // Pending paging records and their UE identity index, grouped by paging occasion, i.e. by the subframe of the
+  // paging cycle in which they are sent. Each TTI only visits the records due in it
+  std::map<uint32_t, std::vector<std::pair<uint32_t, asn1::rrc::paging_record_s> > > pending_paging;
 
+  bool     get_paging_occasion(uint32_t ueid, uint32_t* occasion);
   void     process_release_complete(uint16_t rnti);
   void     rem_user(uint16_t rnti);
   uint32_t generate_sibs();
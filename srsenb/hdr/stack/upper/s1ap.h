@@ -35,6 +35,7 @@
 
 #include "s1ap_metrics.h"
 #include "srsran/adt/optional.h"
+#include "srsran/adt/pool/linear_allocator.h"
 #include "srsran/asn1/s1ap.h"
 #include "srsran/common/network_utils.h"
 #include "srsran/common/stack_procedure.h"
@@ -117,11 +118,35 @@ public:
   /// Section 8.4.3 - Handover Notification
   void send_ho_notify(uint16_t rnti, uint64_t target_eci) override;
 
+  /// S1AP PDU received from the MME. The PDU is unpacked into the arena of the message, so that it can be unpacked in
+  /// the socket thread and handled later in the stack thread
+  struct rx_pdu_t {
+    rx_pdu_t() : arena(arena_buffer.data(), arena_buffer.size()) {}
+    rx_pdu_t(const rx_pdu_t&) = delete;
+    rx_pdu_t& operator=(const rx_pdu_t&) = delete;
+
+    /// Allocations beyond the arena fall back to the heap
+    static const size_t arena_size = 4096;
+
+    std::array<uint8_t, arena_size> arena_buffer;
+    srsran::linear_allocator        arena;
+    srsran::unique_byte_buffer_t    buffer;
+    asn1::s1ap::s1ap_pdu_c          pdu;
+    bool                            unpacked = false;
+  };
+
   // Stack interface
   bool
        handle_mme_rx_msg(srsran::unique_byte_buffer_t pdu, const sockaddr_in& from, const sctp_sndrcvinfo& sri, int flags);
   void start_pcap(srsran::s1ap_pcap* pcap_);
 
+  // Split of handle_mme_rx_msg. Unpacking does not access the S1AP state, and can be called from any thread
+  std::unique_ptr<rx_pdu_t> unpack_mme_rx_msg(srsran::unique_byte_buffer_t pdu, int flags);
+  bool                      handle_mme_rx_pdu(std::unique_ptr<rx_pdu_t> rx_pdu,
+                                              const sockaddr_in&        from,
+                                              const sctp_sndrcvinfo&    sri,
+                                              int                       flags);
+
 private:
   static const int MME_PORT        = 36412;
   static const int ADDR_FAMILY     = AF_INET;
@@ -160,7 +185,7 @@ private:
   bool setup_s1();
   bool sctp_send_s1ap_pdu(const asn1::s1ap::s1ap_pdu_c& tx_pdu, uint32_t rnti, const char* procedure_name);
 
-  bool handle_s1ap_rx_pdu(srsran::byte_buffer_t* pdu);
+  bool handle_s1ap_rx_pdu(rx_pdu_t& rx_pdu);
   bool handle_initiatingmessage(const asn1::s1ap::init_msg_s& msg);
   bool handle_successfuloutcome(const asn1::s1ap::successful_outcome_s& msg);
   bool handle_unsuccessfuloutcome(const asn1::s1ap::unsuccessful_outcome_s& msg);
@@ -63,6 +63,8 @@ DECLARE_METRIC("ul_bitrate", metric_ul_bitrate, float, "");
 DECLARE_METRIC("ul_bler", metric_ul_bler, float, "");
 DECLARE_METRIC("ul_phr", metric_ul_phr, float, "");
 DECLARE_METRIC("ul_bsr", metric_bsr, uint32_t, "");
+DECLARE_METRIC("ul_pusch_shed", metric_ul_pusch_shed, uint32_t, "");
+DECLARE_METRIC("ul_turbo_iters_shed", metric_ul_turbo_iters_shed, float, "");
 DECLARE_METRIC_LIST("bearer_list", mlist_bearers, std::vector<mset_bearer_container>);
 DECLARE_METRIC_SET("ue_container",
                    mset_ue_container,
@@ -77,6 +79,8 @@ DECLARE_METRIC_SET("ue_container",
                    metric_ul_bler,
                    metric_ul_phr,
                    metric_bsr,
+                   metric_ul_pusch_shed,
+                   metric_ul_turbo_iters_shed,
                    mlist_bearers);
 
 /// Sector container metrics.
@@ -125,6 +129,10 @@ static void fill_ue_metrics(mset_ue_container& ue, const enb_metrics_t& m, unsig
   }
   ue.write<metric_ul_phr>(m.stack.mac.ues[i].phr);
   ue.write<metric_bsr>(m.stack.mac.ues[i].ul_buffer);
+  ue.write<metric_ul_pusch_shed>(m.phy[i].ul.n_pusch_shed);
+  if (!std::isnan(m.phy[i].ul.turbo_iters_shed)) {
+    ue.write<metric_ul_turbo_iters_shed>(m.phy[i].ul.turbo_iters_shed);
+  }
 
   // For each data bearer of this UE...
   auto& bearer_list = ue.get<mlist_bearers>();
@@ -93,8 +93,8 @@ void metrics_stdout::set_metrics(const enb_metrics_t& metrics, const uint32_t pe
   if (++n_reports > 10) {
     n_reports = 0;
     cout << endl;
-    cout << "------DL-------------------------------UL--------------------------------------------" << endl;
-    cout << "rnti cqi  ri mcs brate   ok  nok  (%)  pusch pucch phr mcs brate   ok  nok  (%)   bsr" << endl;
+    cout << "------DL-------------------------------UL------------------------------------------------------" << endl;
+    cout << "rnti cqi  ri mcs brate   ok  nok  (%)  pusch pucch phr mcs brate   ok  nok  (%)   bsr shed  cut" << endl;
   }
 
   for (size_t i = 0; i < metrics.stack.rrc.ues.size(); i++) {
@@ -170,6 +170,14 @@ void metrics_stdout::set_metrics(const enb_metrics_t& metrics, const uint32_t pe
       cout << float_to_string(0, 1, 4) << "%";
     }
     cout << float_to_eng_string(metrics.stack.mac.ues[i].ul_buffer, 2);
+
+    // PUSCH shed and turbo decoder iterations cut per PUSCH to meet the decoding deadline
+    cout << std::setw(5) << metrics.phy[i].ul.n_pusch_shed;
+    if (metrics.phy[i].ul.n_samples > 0 && not isnan(metrics.phy[i].ul.turbo_iters_shed)) {
+      cout << float_to_string(metrics.phy[i].ul.turbo_iters_shed, 1, 5);
+    } else {
+      cout << float_to_string(0, 1, 5);
+    }
     cout << endl;
   }
 
@@ -21,6 +21,7 @@
 
 #include "srsran/common/threads.h"
 #include "srsran/srsran.h"
+#include <array>
 
 #include "srsenb/hdr/phy/lte/cc_worker.h"
 
@@ -54,6 +55,26 @@ using namespace asn1::rrc;
 namespace srsenb {
 namespace lte {
 
+static int64_t timespec_to_ns(const struct timespec& t)
+{
+  return (int64_t)t.tv_sec * 1000000000 + t.tv_nsec;
+}
+
+static struct timespec ns_to_timespec(int64_t ns)
+{
+  struct timespec t = {};
+  t.tv_sec          = ns / 1000000000;
+  t.tv_nsec         = ns % 1000000000;
+  return t;
+}
+
+static int64_t monotonic_ns()
+{
+  struct timespec t = {};
+  clock_gettime(CLOCK_MONOTONIC, &t);
+  return timespec_to_ns(t);
+}
+
 cc_worker::cc_worker(srslog::basic_logger& logger) : logger(logger)
 {
   reset();
@@ -207,7 +228,9 @@ uint32_t cc_worker::get_nof_rnti()
   return ue_db.size();
 }
 
-void cc_worker::work_ul(const srsran_ul_sf_cfg_t& ul_sf_cfg, stack_interface_phy_lte::ul_sched_t& ul_grants)
+void cc_worker::work_ul(const srsran_ul_sf_cfg_t&            ul_sf_cfg,
+                        stack_interface_phy_lte::ul_sched_t& ul_grants,
+                        const struct timespec&               rx_time)
 {
   std::lock_guard<std::mutex> lock(mutex);
   ul_sf = ul_sf_cfg;
@@ -216,6 +239,15 @@ void cc_worker::work_ul(const srsran_ul_sf_cfg_t& ul_sf_cfg, stack_interface_phy
   // Process UL signal
   srsran_enb_ul_fft(&enb_ul);
 
+  // The decoding deadline counts from the subframe reception, this and the carriers after it share the time left
+  ul_deadline_en = (phy->params.pusch_deadline_us > 0);
+  if (ul_deadline_en) {
+    int64_t  now_ns      = monotonic_ns();
+    int64_t  deadline_ns = timespec_to_ns(rx_time) + 1000 * (int64_t)phy->params.pusch_deadline_us;
+    uint32_t nof_cc_left = SRSRAN_MAX(1, phy->get_nof_carriers_lte() - cc_idx);
+    ul_deadline_ns       = now_ns + (deadline_ns - now_ns) / (int64_t)nof_cc_left;
+  }
+
   // Decode pending UL grants for the tti they were scheduled
   decode_pusch(ul_grants.pusch, ul_grants.nof_grants);
 
@@ -266,7 +298,9 @@ void cc_worker::work_dl(const srsran_dl_sf_cfg_t&            dl_sf_cfg,
 
 void cc_worker::decode_pusch_rnti(stack_interface_phy_lte::ul_sched_grant_t& ul_grant,
                                   srsran_ul_cfg_t&                           ul_cfg,
-                                  srsran_pusch_res_t&                        pusch_res)
+                                  srsran_pusch_res_t&                        pusch_res,
+                                  const struct timespec*                     deadline,
+                                  bool                                       shed)
 {
   uint16_t rnti = ul_grant.dci.rnti;
 
@@ -318,10 +352,14 @@ void cc_worker::decode_pusch_rnti(stack_interface_phy_lte::ul_sched_grant_t& ul_
     Error("Error setting last UL TB for RNTI %x, CC %d, PID %d", rnti, cc_idx, ul_grant.pid);
   }
 
-  // Run PUSCH decoder
+  // Run PUSCH decoder, unless it was shed to meet the deadline. The CRC stays KO and the UE retransmits
   ul_cfg.pusch.softbuffers.rx = ul_grant.softbuffer_rx;
-  pusch_res.data              = ul_grant.data;
-  if (pusch_res.data) {
+  ul_cfg.pusch.deadline_en    = (deadline != nullptr);
+  if (deadline != nullptr) {
+    ul_cfg.pusch.deadline = *deadline;
+  }
+  pusch_res.data = ul_grant.data;
+  if (pusch_res.data and not shed) {
     if (srsran_enb_ul_get_pusch(&enb_ul, &ul_sf, &ul_cfg.pusch, &pusch_res)) {
       Error("Decoding PUSCH for RNTI %x", rnti);
       return;
@@ -334,7 +372,7 @@ void cc_worker::decode_pusch_rnti(stack_interface_phy_lte::ul_sched_grant_t& ul_
   float snr_db = enb_ul.chest_res.snr_db;
 
   // Notify MAC of RL status
-  if (snr_db >= PUSCH_RL_SNR_DB_TH) {
+  if (not shed and snr_db >= PUSCH_RL_SNR_DB_TH) {
     // Notify MAC UL channel quality
     phy->stack->snr_info(ul_sf.tti, rnti, cc_idx, snr_db, mac_interface_phy_lte::PUSCH);
 
@@ -352,23 +390,80 @@ void cc_worker::decode_pusch_rnti(stack_interface_phy_lte::ul_sched_grant_t& ul_
   // Save statistics only if data was provided
   if (ul_grant.data != nullptr) {
     // Save metrics stats
-    ue_db[rnti]->metrics_ul(ul_grant.dci.tb.mcs_idx, 0, enb_ul.chest_res.snr_db, pusch_res.avg_iterations_block);
+    if (shed) {
+      ue_db[rnti]->metrics_ul_shed();
+    } else {
+      ue_db[rnti]->metrics_ul(ul_grant.dci.tb.mcs_idx,
+                              0,
+                              enb_ul.chest_res.snr_db,
+                              pusch_res.avg_iterations_block,
+                              pusch_res.nof_shed_iterations);
+    }
   }
 }
 
+bool cc_worker::is_pusch_priority(const stack_interface_phy_lte::ul_sched_grant_t& ul_grant)
+{
+  // Losing a retransmission wastes the previous ones
+  if (ul_grant.current_tx_nb > 0) {
+    return true;
+  }
+
+  // Losing UCI costs DL HARQ retransmissions and CSI
+  srsran_uci_cfg_t uci_cfg = {};
+  return phy->ue_db.fill_uci_cfg(tti_rx, cc_idx, ul_grant.dci.rnti, ul_grant.dci.cqi_request, true, uci_cfg) > 0;
+}
+
 void cc_worker::decode_pusch(stack_interface_phy_lte::ul_sched_grant_t* grants, uint32_t nof_pusch)
 {
+  std::array<uint32_t, stack_interface_phy_lte::MAX_GRANTS> order    = {};
+  std::array<uint32_t, stack_interface_phy_lte::MAX_GRANTS> nof_bits = {};
+  std::array<bool, stack_interface_phy_lte::MAX_GRANTS>     priority = {};
+
+  nof_pusch = SRSRAN_MIN(nof_pusch, (uint32_t)stack_interface_phy_lte::MAX_GRANTS);
+
+  // Against a deadline, decode retransmissions and PUSCH carrying UCI first
+  if (ul_deadline_en) {
+    for (uint32_t i = 0; i < nof_pusch; i++) {
+      uint32_t L_crb = 0, RB_start = 0;
+      srsran_ra_type2_from_riv(
+          grants[i].dci.type2_alloc.riv, &L_crb, &RB_start, enb_ul.cell.nof_prb, enb_ul.cell.nof_prb);
+      int tbs_idx = srsran_ra_tbs_idx_from_mcs(grants[i].dci.tb.mcs_idx, false, true);
+      priority[i] = is_pusch_priority(grants[i]);
+      nof_bits[i] = (tbs_idx < 0) ? 0 : SRSRAN_MAX(0, srsran_ra_tbs_from_idx(tbs_idx, L_crb));
+    }
+  }
+  srsran_pusch_deadline_order(priority.data(), nof_pusch, order.data());
+
   // Iterate over all the grants, all the grants need to report MAC the CRC status
-  for (uint32_t i = 0; i < nof_pusch; i++) {
+  for (uint32_t k = 0; k < nof_pusch; k++) {
     // Get grant itself and RNTI
+    uint32_t                                   i        = order[k];
     stack_interface_phy_lte::ul_sched_grant_t& ul_grant = grants[i];
     uint16_t                                   rnti     = ul_grant.dci.rnti;
 
     srsran_pusch_res_t pusch_res = {};
     srsran_ul_cfg_t    ul_cfg    = {};
 
+    // New transmissions without UCI are not decoded at all if their expected decoding time does not fit anymore
+    struct timespec  deadline     = {};
+    struct timespec* deadline_ptr = nullptr;
+    bool             shed         = false;
+    int64_t          t_ns         = 0;
+    if (ul_deadline_en) {
+      t_ns         = monotonic_ns();
+      deadline     = ns_to_timespec(ul_deadline_ns);
+      deadline_ptr = &deadline;
+      shed         = srsran_pusch_deadline_shed(&pusch_deadline, priority[i], nof_bits[i], t_ns, ul_deadline_ns);
+    }
+
     // Decodes PUSCH for the given grant
-    decode_pusch_rnti(ul_grant, ul_cfg, pusch_res);
+    decode_pusch_rnti(ul_grant, ul_cfg, pusch_res, deadline_ptr, shed);
+
+    // Learn the decoding time from the PUSCH actually decoded
+    if (ul_deadline_en and not shed and ul_grant.data != nullptr and ul_cfg.pusch.grant.tb.tbs > 0) {
+      srsran_pusch_deadline_learn(&pusch_deadline, (uint32_t)ul_cfg.pusch.grant.tb.tbs, monotonic_ns() - t_ns);
+    }
 
     // Notify MAC new received data and HARQ Indication value
     if (ul_grant.data != nullptr) {
@@ -378,9 +473,13 @@ void cc_worker::decode_pusch(stack_interface_phy_lte::ul_sched_grant_t* grants,
       phy->stack->push_pdu(tti_rx, rnti, cc_idx, ul_cfg.pusch.grant.tb.tbs / 8, pusch_res.crc);
       // Logging
       if (logger.info.enabled()) {
-        char str[512];
-        srsran_pusch_rx_info(&ul_cfg.pusch, &pusch_res, &enb_ul.chest_res, str, sizeof(str));
-        logger.info("PUSCH: cc=%d, %s", cc_idx, str);
+        if (shed) {
+          logger.info("PUSCH: cc=%d, rnti=0x%x, shed to meet the decoding deadline", cc_idx, rnti);
+        } else {
+          char str[512];
+          srsran_pusch_rx_info(&ul_cfg.pusch, &pusch_res, &enb_ul.chest_res, str, sizeof(str));
+          logger.info("PUSCH: cc=%d, %s", cc_idx, str);
+        }
       }
     }
   }
@@ -647,15 +746,22 @@ void cc_worker::ue::metrics_dl(uint32_t mcs)
   metrics.dl.n_samples++;
 }
 
-void cc_worker::ue::metrics_ul(uint32_t mcs, float rssi, float sinr, float turbo_iters)
+void cc_worker::ue::metrics_ul(uint32_t mcs, float rssi, float sinr, float turbo_iters, uint32_t turbo_iters_shed)
 {
   metrics.ul.mcs         = SRSRAN_VEC_CMA((float)mcs, metrics.ul.mcs, metrics.ul.n_samples);
   metrics.ul.pusch_sinr  = SRSRAN_VEC_CMA((float)sinr, metrics.ul.pusch_sinr, metrics.ul.n_samples);
   metrics.ul.rssi        = SRSRAN_VEC_CMA((float)rssi, metrics.ul.rssi, metrics.ul.n_samples);
   metrics.ul.turbo_iters = SRSRAN_VEC_CMA((float)turbo_iters, metrics.ul.turbo_iters, metrics.ul.n_samples);
+  metrics.ul.turbo_iters_shed =
+      SRSRAN_VEC_CMA((float)turbo_iters_shed, metrics.ul.turbo_iters_shed, metrics.ul.n_samples);
   metrics.ul.n_samples++;
 }
 
+void cc_worker::ue::metrics_ul_shed()
+{
+  metrics.ul.n_pusch_shed++;
+}
+
 void cc_worker::ue::metrics_ul_pucch(float sinr)
 {
   metrics.ul.pucch_sinr = SRSRAN_VEC_CMA((float)sinr, metrics.ul.pucch_sinr, metrics.ul.n_samples_pucch);
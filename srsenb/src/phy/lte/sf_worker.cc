@@ -122,6 +122,7 @@ void sf_worker::set_time(uint32_t tti_, uint32_t tx_worker_cnt_, const srsran::r
 
   tx_worker_cnt = tx_worker_cnt_;
   tx_time.copy(tx_time_);
+  clock_gettime(CLOCK_MONOTONIC, &rx_time);
 
   for (auto& w : cc_workers) {
     w->set_tti(tti_);
@@ -199,7 +200,7 @@ void sf_worker::work_imp()
 
   // Process UL
   for (uint32_t cc = 0; cc < cc_workers.size(); cc++) {
-    cc_workers[cc]->work_ul(ul_sf, ul_grants[cc]);
+    cc_workers[cc]->work_ul(ul_sf, ul_grants[cc], rx_time);
   }
 
   // Get DL scheduling for the TX TTI from MAC
@@ -290,7 +291,10 @@ uint32_t sf_worker::get_metrics(std::vector<phy_metrics_t>& metrics)
       m->ul.mcs         = SRSRAN_VEC_PMA(m->ul.mcs, m->ul.n_samples, m_->ul.mcs, m_->ul.n_samples);
       m->ul.rssi        = SRSRAN_VEC_PMA(m->ul.rssi, m->ul.n_samples, m_->ul.rssi, m_->ul.n_samples);
       m->ul.turbo_iters = SRSRAN_VEC_PMA(m->ul.turbo_iters, m->ul.n_samples, m_->ul.turbo_iters, m_->ul.n_samples);
+      m->ul.turbo_iters_shed =
+          SRSRAN_VEC_PMA(m->ul.turbo_iters_shed, m->ul.n_samples, m_->ul.turbo_iters_shed, m_->ul.n_samples);
       m->ul.n_samples += m_->ul.n_samples;
+      m->ul.n_pusch_shed += m_->ul.n_pusch_shed;
       m->ul.n_samples_pucch += m_->ul.n_samples_pucch;
     }
   }
@@ -224,6 +224,8 @@ void phy::get_metrics(std::vector<phy_metrics_t>& metrics)
       metrics[j].ul.pusch_sinr += metrics_tmp[j].ul.n_samples * metrics_tmp[j].ul.pusch_sinr;
       metrics[j].ul.pucch_sinr += metrics_tmp[j].ul.n_samples_pucch * metrics_tmp[j].ul.pucch_sinr;
       metrics[j].ul.turbo_iters += metrics_tmp[j].ul.n_samples * metrics_tmp[j].ul.turbo_iters;
+      metrics[j].ul.turbo_iters_shed += metrics_tmp[j].ul.n_samples * metrics_tmp[j].ul.turbo_iters_shed;
+      metrics[j].ul.n_pusch_shed += metrics_tmp[j].ul.n_pusch_shed;
     }
   }
   for (uint32_t j = 0; j < metrics.size(); j++) {
@@ -234,6 +236,7 @@ void phy::get_metrics(std::vector<phy_metrics_t>& metrics)
     metrics[j].ul.pusch_sinr /= metrics[j].ul.n_samples;
     metrics[j].ul.pucch_sinr /= metrics[j].ul.n_samples_pucch;
     metrics[j].ul.turbo_iters /= metrics[j].ul.n_samples;
+    metrics[j].ul.turbo_iters_shed /= metrics[j].ul.n_samples;
   }
 }
 
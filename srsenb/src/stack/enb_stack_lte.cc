@@ -107,7 +107,7 @@ int enb_stack_lte::init(const stack_args_t& args_, const rrc_cfg_t& rrc_cfg_)
 
   // Set up pcap and trace
   if (args.mac_pcap.enable) {
-    mac_pcap.open(args.mac_pcap.filename.c_str());
+    mac_pcap.open(args.mac_pcap.filename.c_str(), 0, (uint64_t)args.pcap_max_file_size << 20U);
     mac.start_pcap(&mac_pcap);
   }
 
@@ -120,7 +120,7 @@ int enb_stack_lte::init(const stack_args_t& args_, const rrc_cfg_t& rrc_cfg_)
   }
 
   if (args.s1ap_pcap.enable) {
-    s1ap_pcap.open(args.s1ap_pcap.filename.c_str());
+    s1ap_pcap.open(args.s1ap_pcap.filename.c_str(), (uint64_t)args.pcap_max_file_size << 20U);
     s1ap.start_pcap(&s1ap_pcap);
   }
 
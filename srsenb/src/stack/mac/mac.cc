@@ -86,10 +86,12 @@ bool mac::init(const mac_args_t&        args_,
 
   reset();
 
-  // Initiate common pool of softbuffers
-  uint32_t nof_prb          = args.nof_prb;
-  auto     init_softbuffers = [nof_prb](void* ptr) {
-    new (ptr) ue_cc_softbuffers(nof_prb, SRSRAN_FDD_NOF_HARQ, SRSRAN_FDD_NOF_HARQ);
+  // Initiate common pool of softbuffers, their code block storage is leased on demand from a pool shared by all UEs
+  uint32_t nof_prb = args.nof_prb;
+  softbuffer_cb_pool.reset(new softbuffer_cb_pools(nof_prb, args.nof_prealloc_ues * SRSRAN_FDD_NOF_HARQ));
+  std::shared_ptr<softbuffer_cb_pools> cb_pools         = softbuffer_cb_pool;
+  auto                                 init_softbuffers = [nof_prb, cb_pools](void* ptr) {
+    new (ptr) ue_cc_softbuffers(nof_prb, SRSRAN_FDD_NOF_HARQ, SRSRAN_FDD_NOF_HARQ, cb_pools);
   };
   auto recycle_softbuffers = [](ue_cc_softbuffers& softbuffers) { softbuffers.clear(); };
   softbuffer_pool.reset(new srsran::background_obj_pool<ue_cc_softbuffers>(
@@ -312,6 +314,15 @@ int mac::ack_info(uint32_t tti_rx, uint16_t rnti, uint32_t enb_cc_idx, uint32_t
   int nof_bytes = scheduler.dl_ack_info(tti_rx, rnti, enb_cc_idx, tb_idx, ack);
   ue_db[rnti]->metrics_tx(ack, nof_bytes);
 
+  // An acknowledged TB needs no retransmission, give its softbuffer storage back. The TB is found by its FDD ACK
+  // timing, so in TDD, where the ACK delay depends on the subframe, the storage is only reclaimed when it expires
+  if (ack and enb_cc_idx < cell_config.size() and cell_config[enb_cc_idx].cell.frame_type == SRSRAN_FDD) {
+    std::array<int, SRSRAN_MAX_CARRIERS> enb_ue_cc_map = scheduler.get_enb_ue_cc_map(rnti);
+    if (enb_ue_cc_map[enb_cc_idx] >= 0) {
+      ue_db[rnti]->release_tx_softbuffer(enb_ue_cc_map[enb_cc_idx], TTI_SUB(tti_rx, FDD_HARQ_DELAY_DL_MS), tb_idx);
+    }
+  }
+
   rrc_h->set_radiolink_dl_state(rnti, ack);
 
   return SRSRAN_SUCCESS;
@@ -354,6 +365,7 @@ int mac::push_pdu(uint32_t tti_rx, uint16_t rnti, uint32_t enb_cc_idx, uint32_t
   if (crc) {
     logger.info("Pushing PDU rnti=0x%x, tti_rx=%d, nof_bytes=%d", rnti, tti_rx, nof_bytes);
     ue_db[rnti]->push_pdu(tti_rx, ue_cc_idx, nof_bytes);
+    ue_db[rnti]->release_rx_softbuffer(ue_cc_idx, tti_rx);
     stack_task_queue.push([this]() { process_pdus(); });
   } else {
     logger.debug("Discarting PDU rnti=0x%x, tti_rx=%d, nof_bytes=%d", rnti, tti_rx, nof_bytes);
@@ -630,8 +642,10 @@ int mac::get_dl_sched(uint32_t tti_tx_dl, dl_sched_list_t& dl_sched_res_list)
           dl_sched_res->pdsch[n].dci = sched_result.data[i].dci;
 
           for (uint32_t tb = 0; tb < SRSRAN_MAX_TB; tb++) {
-            dl_sched_res->pdsch[n].softbuffer_tx[tb] =
-                ue_db[rnti]->get_tx_softbuffer(sched_result.data[i].dci.ue_cc_idx, sched_result.data[i].dci.pid, tb);
+            // New transmissions lease the softbuffer storage of the TB
+            uint32_t tbs = sched_result.data[i].nof_pdu_elems[tb] > 0 ? sched_result.data[i].tbs[tb] * 8 : 0;
+            dl_sched_res->pdsch[n].softbuffer_tx[tb] = ue_db[rnti]->get_tx_softbuffer(
+                sched_result.data[i].dci.ue_cc_idx, sched_result.data[i].dci.pid, tb, tti_tx_dl, tbs);
 
             // If the Rx soft-buffer is not given, abort transmission
             if (dl_sched_res->pdsch[n].softbuffer_tx[tb] == nullptr) {
@@ -946,17 +960,15 @@ int mac::get_ul_sched(uint32_t tti_tx_ul, ul_sched_list_t& ul_sched_res_list)
             phy_ul_sched_res->pusch[n].pid           = TTI_RX(tti_tx_ul) % SRSRAN_FDD_NOF_HARQ;
             phy_ul_sched_res->pusch[n].needs_pdcch   = sched_result.pusch[i].needs_pdcch;
             phy_ul_sched_res->pusch[n].dci           = sched_result.pusch[i].dci;
+            // New transmissions lease (or reset) the softbuffer storage of the TB
+            uint32_t tbs = sched_result.pusch[i].current_tx_nb == 0 ? sched_result.pusch[i].tbs * 8 : 0;
             phy_ul_sched_res->pusch[n].softbuffer_rx =
-                ue_db[rnti]->get_rx_softbuffer(sched_result.pusch[i].dci.ue_cc_idx, tti_tx_ul);
+                ue_db[rnti]->get_rx_softbuffer(sched_result.pusch[i].dci.ue_cc_idx, tti_tx_ul, tbs);
 
             // If the Rx soft-buffer is not given, abort reception
             if (phy_ul_sched_res->pusch[n].softbuffer_rx == nullptr) {
               continue;
             }
-
-            if (sched_result.pusch[n].current_tx_nb == 0) {
-              srsran_softbuffer_rx_reset_tbs(phy_ul_sched_res->pusch[n].softbuffer_rx, sched_result.pusch[i].tbs * 8);
-            }
             phy_ul_sched_res->pusch[n].data =
                 ue_db[rnti]->request_buffer(tti_tx_ul, sched_result.pusch[i].dci.ue_cc_idx, sched_result.pusch[i].tbs);
             if (phy_ul_sched_res->pusch[n].data) {
@@ -32,20 +32,47 @@
 
 namespace srsenb {
 
-ue_cc_softbuffers::ue_cc_softbuffers(uint32_t nof_prb, uint32_t nof_tx_harq_proc_, uint32_t nof_rx_harq_proc_) :
-  nof_tx_harq_proc(nof_tx_harq_proc_), nof_rx_harq_proc(nof_rx_harq_proc_)
+softbuffer_cb_pools::softbuffer_cb_pools(uint32_t nof_prb, uint32_t nof_prealloc_cb)
+{
+  if (srsran_softbuffer_pool_tx_init(&tx, nof_prb, nof_prealloc_cb, 0) < SRSRAN_SUCCESS or
+      srsran_softbuffer_pool_rx_init(&rx, nof_prb, nof_prealloc_cb, 0) < SRSRAN_SUCCESS) {
+    srslog::fetch_basic_logger("MAC").error("Error initiating softbuffer code block pools");
+  }
+}
+
+softbuffer_cb_pools::~softbuffer_cb_pools()
+{
+  srsran_softbuffer_pool_free(&tx);
+  srsran_softbuffer_pool_free(&rx);
+}
+
+ue_cc_softbuffers::ue_cc_softbuffers(uint32_t                             nof_prb,
+                                     uint32_t                             nof_tx_harq_proc_,
+                                     uint32_t                             nof_rx_harq_proc_,
+                                     std::shared_ptr<softbuffer_cb_pools> cb_pools_) :
+  nof_tx_harq_proc(nof_tx_harq_proc_), nof_rx_harq_proc(nof_rx_harq_proc_), cb_pools(std::move(cb_pools_))
 {
   // Create and init Rx buffers
   softbuffer_rx_list.resize(nof_rx_harq_proc);
   for (srsran_softbuffer_rx_t& buffer : softbuffer_rx_list) {
-    srsran_softbuffer_rx_init(&buffer, nof_prb);
+    if (cb_pools != nullptr) {
+      srsran_softbuffer_rx_init_pool(&buffer, &cb_pools->rx, nof_prb);
+    } else {
+      srsran_softbuffer_rx_init(&buffer, nof_prb);
+    }
   }
+  rx_last_tti.resize(softbuffer_rx_list.size());
 
   // Create and init Tx buffers
   softbuffer_tx_list.resize(nof_tx_harq_proc * SRSRAN_MAX_TB);
   for (auto& buffer : softbuffer_tx_list) {
-    srsran_softbuffer_tx_init(&buffer, nof_prb);
+    if (cb_pools != nullptr) {
+      srsran_softbuffer_tx_init_pool(&buffer, &cb_pools->tx, nof_prb);
+    } else {
+      srsran_softbuffer_tx_init(&buffer, nof_prb);
+    }
   }
+  tx_last_tti.resize(softbuffer_tx_list.size());
 }
 
 ue_cc_softbuffers::~ue_cc_softbuffers()
@@ -63,14 +90,77 @@ ue_cc_softbuffers::~ue_cc_softbuffers()
 
 void ue_cc_softbuffers::clear()
 {
+  // Pooled softbuffers give their storage back until the next TB
   for (auto& buffer : softbuffer_rx_list) {
+    srsran_softbuffer_rx_release(&buffer);
     srsran_softbuffer_rx_reset(&buffer);
   }
   for (auto& buffer : softbuffer_tx_list) {
+    srsran_softbuffer_tx_release(&buffer);
     srsran_softbuffer_tx_reset(&buffer);
   }
 }
 
+srsran_softbuffer_tx_t* ue_cc_softbuffers::get_tx(uint32_t tti, uint32_t pid, uint32_t tb_idx, uint32_t tbs)
+{
+  uint32_t                idx    = pid * SRSRAN_MAX_TB + tb_idx;
+  srsran_softbuffer_tx_t& buffer = softbuffer_tx_list.at(idx);
+  if (tbs > 0 and buffer.pool != nullptr and srsran_softbuffer_tx_lease(&buffer, tbs) < SRSRAN_SUCCESS) {
+    return nullptr;
+  }
+  tx_last_tti[idx] = tti;
+  return &buffer;
+}
+
+srsran_softbuffer_rx_t* ue_cc_softbuffers::get_rx(uint32_t tti, uint32_t tbs)
+{
+  uint32_t                idx    = tti % nof_rx_harq_proc;
+  srsran_softbuffer_rx_t& buffer = softbuffer_rx_list[idx];
+  if (tbs > 0) {
+    if (buffer.pool == nullptr) {
+      srsran_softbuffer_rx_reset_tbs(&buffer, tbs);
+    } else if (srsran_softbuffer_rx_lease(&buffer, tbs) < SRSRAN_SUCCESS) {
+      return nullptr;
+    }
+  }
+  rx_last_tti[idx] = tti;
+  return &buffer;
+}
+
+void ue_cc_softbuffers::release_tx(uint32_t tti, uint32_t tb_idx)
+{
+  for (uint32_t pid = 0; pid < nof_tx_harq_proc; pid++) {
+    uint32_t idx = pid * SRSRAN_MAX_TB + tb_idx;
+    if (softbuffer_tx_list[idx].max_cb > 0 and tx_last_tti[idx] == tti) {
+      srsran_softbuffer_tx_release(&softbuffer_tx_list[idx]);
+    }
+  }
+}
+
+void ue_cc_softbuffers::release_rx(uint32_t tti)
+{
+  uint32_t idx = tti % nof_rx_harq_proc;
+  if (rx_last_tti[idx] == tti) {
+    srsran_softbuffer_rx_release(&softbuffer_rx_list[idx]);
+  }
+}
+
+void ue_cc_softbuffers::release_expired(uint32_t tti)
+{
+  for (uint32_t i = 0; i < softbuffer_tx_list.size(); i++) {
+    if (softbuffer_tx_list[i].pool != nullptr and softbuffer_tx_list[i].max_cb > 0 and
+        TTI_SUB(tti, tx_last_tti[i]) > expiry_ttis) {
+      srsran_softbuffer_tx_release(&softbuffer_tx_list[i]);
+    }
+  }
+  for (uint32_t i = 0; i < softbuffer_rx_list.size(); i++) {
+    if (softbuffer_rx_list[i].pool != nullptr and softbuffer_rx_list[i].max_cb > 0 and
+        TTI_SUB(tti, rx_last_tti[i]) > expiry_ttis) {
+      srsran_softbuffer_rx_release(&softbuffer_rx_list[i]);
+    }
+  }
+}
+
 cc_used_buffers_map::cc_used_buffers_map(srsran::pdu_queue& shared_pdu_queue_) :
   shared_pdu_queue(&shared_pdu_queue_), logger(&srslog::fetch_basic_logger("MAC"))
 {}
@@ -269,25 +359,54 @@ void ue::start_pcap(srsran::mac_pcap* pcap_)
   pcap = pcap_;
 }
 
-srsran_softbuffer_rx_t* ue::get_rx_softbuffer(const uint32_t ue_cc_idx, const uint32_t tti)
+srsran_softbuffer_rx_t* ue::get_rx_softbuffer(const uint32_t ue_cc_idx, const uint32_t tti, const uint32_t tbs)
 {
   if ((size_t)ue_cc_idx >= cc_buffers.size()) {
     ERROR("UE CC Index (%d/%zd) out-of-range", ue_cc_idx, cc_buffers.size());
     return nullptr;
   }
 
-  return &cc_buffers[ue_cc_idx].get_rx_softbuffer(tti);
+  std::lock_guard<std::mutex> lock(softbuffers_mutex);
+  srsran_softbuffer_rx_t*     softbuffer = cc_buffers[ue_cc_idx].get_softbuffers().get_rx(tti, tbs);
+  if (softbuffer == nullptr) {
+    logger.error("UE buffers: Leasing Rx softbuffer for rnti=0x%x tti=%d tbs=%d", rnti, tti, tbs);
+  }
+  return softbuffer;
 }
 
-srsran_softbuffer_tx_t*
-ue::get_tx_softbuffer(const uint32_t ue_cc_idx, const uint32_t harq_process, const uint32_t tb_idx)
+srsran_softbuffer_tx_t* ue::get_tx_softbuffer(const uint32_t ue_cc_idx,
+                                              const uint32_t harq_process,
+                                              const uint32_t tb_idx,
+                                              const uint32_t tti,
+                                              const uint32_t tbs)
 {
   if ((size_t)ue_cc_idx >= cc_buffers.size()) {
     ERROR("UE CC Index (%d/%zd) out-of-range", ue_cc_idx, cc_buffers.size());
     return nullptr;
   }
 
-  return &cc_buffers[ue_cc_idx].get_tx_softbuffer(harq_process, tb_idx);
+  std::lock_guard<std::mutex> lock(softbuffers_mutex);
+  srsran_softbuffer_tx_t*     softbuffer = cc_buffers[ue_cc_idx].get_softbuffers().get_tx(tti, harq_process, tb_idx, tbs);
+  if (softbuffer == nullptr) {
+    logger.error("UE buffers: Leasing Tx softbuffer for rnti=0x%x pid=%d tbs=%d", rnti, harq_process, tbs);
+  }
+  return softbuffer;
+}
+
+void ue::release_tx_softbuffer(const uint32_t ue_cc_idx, const uint32_t tti, const uint32_t tb_idx)
+{
+  std::lock_guard<std::mutex> lock(softbuffers_mutex);
+  if (ue_cc_idx < cc_buffers.size() and not cc_buffers[ue_cc_idx].empty()) {
+    cc_buffers[ue_cc_idx].get_softbuffers().release_tx(tti, tb_idx);
+  }
+}
+
+void ue::release_rx_softbuffer(const uint32_t ue_cc_idx, const uint32_t tti)
+{
+  std::lock_guard<std::mutex> lock(softbuffers_mutex);
+  if (ue_cc_idx < cc_buffers.size() and not cc_buffers[ue_cc_idx].empty()) {
+    cc_buffers[ue_cc_idx].get_softbuffers().release_rx(tti);
+  }
 }
 
 uint8_t* ue::request_buffer(uint32_t tti, uint32_t ue_cc_idx, const uint32_t len)
@@ -310,6 +429,14 @@ void ue::clear_old_buffers(uint32_t tti)
   for (auto& cc : cc_buffers) {
     cc.get_rx_used_buffers().clear_old_pdus(tti_point{tti});
   }
+
+  // give back the softbuffer storage of TBs that were never acknowledged
+  std::lock_guard<std::mutex> sb_lock(softbuffers_mutex);
+  for (auto& cc : cc_buffers) {
+    if (not cc.empty()) {
+      cc.get_softbuffers().release_expired(tti);
+    }
+  }
 }
 
 bool ue::process_pdus()
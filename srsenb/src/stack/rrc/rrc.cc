@@ -455,14 +455,45 @@ int rrc::modify_erab(uint16_t                                   rnti,
   than user map
 *******************************************************************************/
 
+// Described in Section 7 of 36.304. The occasion is the subframe of the paging cycle, i.e. (PF mod T) * 10 + PO
+bool rrc::get_paging_occasion(uint32_t ueid, uint32_t* occasion)
+{
+  constexpr static int sf_pattern[4][4] = {{9, 4, -1, 0}, {-1, 9, -1, 4}, {-1, -1, -1, 5}, {-1, -1, -1, 9}};
+
+  // Default paging cycle, should get DRX from user
+  uint32_t T  = cfg.sibs[1].sib2().rr_cfg_common.pcch_cfg.default_paging_cycle.to_number();
+  uint32_t Nb = T * cfg.sibs[1].sib2().rr_cfg_common.pcch_cfg.nb.to_number();
+
+  uint32_t N   = T < Nb ? T : Nb;
+  uint32_t Ns  = Nb / T > 1 ? Nb / T : 1;
+  uint32_t idx = ueid % 1024;
+  uint32_t i_s = (idx / N) % Ns;
+
+  int sf_idx = sf_pattern[i_s % 4][(Ns - 1) % 4];
+  if (sf_idx < 0) {
+    logger.error("SF pattern is N/A for Ns=%d, i_s=%d, imsi_decimal=%d", Ns, i_s, idx);
+    return false;
+  }
+  *occasion = (T / N) * (idx % N) * 10 + (uint32_t)sf_idx;
+  return true;
+}
+
 void rrc::add_paging_id(uint32_t ueid, const asn1::s1ap::ue_paging_id_c& ue_paging_id)
 {
-  std::lock_guard<std::mutex> lock(paging_mutex);
-  if (pending_paging.count(ueid) > 0) {
-    logger.warning("Received Paging for UEID=%d but not yet transmitted", ueid);
+  uint32_t occasion = 0;
+  if (not get_paging_occasion(ueid, &occasion)) {
     return;
   }
 
+  std::lock_guard<std::mutex> lock(paging_mutex);
+  auto&                       records = pending_paging[occasion];
+  for (const auto& item : records) {
+    if (item.first == ueid) {
+      logger.warning("Received Paging for UEID=%d but not yet transmitted", ueid);
+      return;
+    }
+  }
+
   paging_record_s paging_elem;
   if (ue_paging_id.type().value == asn1::s1ap::ue_paging_id_c::types_opts::imsi) {
     paging_elem.ue_id.set_imsi();
@@ -481,14 +512,12 @@ void rrc::add_paging_id(uint32_t ueid, const asn1::s1ap::ue_paging_id_c& ue_pagi
   }
   paging_elem.cn_domain = paging_record_s::cn_domain_e_::ps;
 
-  pending_paging.insert(std::make_pair(ueid, paging_elem));
+  records.push_back(std::make_pair(ueid, paging_elem));
 }
 
 // Described in Section 7 of 36.304
 bool rrc::is_paging_opportunity(uint32_t tti, uint32_t* payload_len)
 {
-  constexpr static int sf_pattern[4][4] = {{9, 4, -1, 0}, {-1, 9, -1, 4}, {-1, -1, -1, 5}, {-1, -1, -1, 9}};
-
   if (tti == paging_tti) {
     *payload_len = byte_buf_paging.N_bytes;
     logger.debug("Sending paging to extra carriers. Payload len=%d, TTI=%d", *payload_len, tti);
@@ -506,48 +535,29 @@ bool rrc::is_paging_opportunity(uint32_t tti, uint32_t* payload_len)
   paging_s* paging_rec = &pcch_msg.msg.c1().paging();
 
   // Default paging cycle, should get DRX from user
-  uint32_t T  = cfg.sibs[1].sib2().rr_cfg_common.pcch_cfg.default_paging_cycle.to_number();
-  uint32_t Nb = T * cfg.sibs[1].sib2().rr_cfg_common.pcch_cfg.nb.to_number();
-
-  uint32_t N   = T < Nb ? T : Nb;
-  uint32_t Ns  = Nb / T > 1 ? Nb / T : 1;
-  uint32_t sfn = tti / 10;
-
-  std::vector<uint32_t> ue_to_remove;
+  uint32_t T        = cfg.sibs[1].sib2().rr_cfg_common.pcch_cfg.default_paging_cycle.to_number();
+  uint32_t sfn      = tti / 10;
+  uint32_t occasion = (sfn % T) * 10 + tti % 10;
 
   {
     std::lock_guard<std::mutex> lock(paging_mutex);
 
-    int n = 0;
-    for (auto& item : pending_paging) {
-      if (n >= ASN1_RRC_MAX_PAGE_REC) {
-        break;
-      }
-      const asn1::rrc::paging_record_s& u    = item.second;
-      uint32_t                          ueid = ((uint32_t)item.first) % 1024;
-      uint32_t                          i_s  = (ueid / N) % Ns;
-
-      if ((sfn % T) != (T / N) * (ueid % N)) {
-        continue;
-      }
-
-      int sf_idx = sf_pattern[i_s % 4][(Ns - 1) % 4];
-      if (sf_idx < 0) {
-        logger.error("SF pattern is N/A for Ns=%d, i_s=%d, imsi_decimal=%d", Ns, i_s, ueid);
-        continue;
-      }
-
-      if ((uint32_t)sf_idx == (tti % 10)) {
-        paging_rec->paging_record_list_present = true;
-        paging_rec->paging_record_list.push_back(u);
-        ue_to_remove.push_back(ueid);
-        n++;
-        logger.info("Assembled paging for ue_id=%d, tti=%d", ueid, tti);
-      }
+    auto it = pending_paging.find(occasion);
+    if (it == pending_paging.end()) {
+      return false;
     }
 
-    for (unsigned int i : ue_to_remove) {
-      pending_paging.erase(i);
+    // All the records of the occasion are sent in one message, up to its maximum size
+    auto&    records = it->second;
+    uint32_t n       = std::min((uint32_t)records.size(), (uint32_t)ASN1_RRC_MAX_PAGE_REC);
+    for (uint32_t i = 0; i < n; i++) {
+      paging_rec->paging_record_list_present = true;
+      paging_rec->paging_record_list.push_back(records[i].second);
+      logger.info("Assembled paging for ue_id=%d, tti=%d", records[i].first % 1024, tti);
+    }
+    records.erase(records.begin(), records.begin() + n);
+    if (records.empty()) {
+      pending_paging.erase(it);
     }
   }
 
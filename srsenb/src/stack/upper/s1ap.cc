@@ -495,13 +495,18 @@ bool s1ap::connect_mme()
   logger.info("SCTP socket connected with MME. fd=%d", mme_socket.fd());
 
   // Assign a handler to rx MME packets
-  auto rx_callback =
-      [this](srsran::unique_byte_buffer_t pdu, const sockaddr_in& from, const sctp_sndrcvinfo& sri, int flags) {
-        // Defer the handling of MME packet to eNB stack main thread
-        handle_mme_rx_msg(std::move(pdu), from, sri, flags);
-      };
+  auto rx_callback = [this](srsran::unique_byte_buffer_t pdu,
+                            const sockaddr_in&           from,
+                            const sctp_sndrcvinfo&       sri,
+                            int                          flags) -> srsran::move_task_t {
+    // Unpack the MME packet in the socket thread, and defer its handling to eNB stack main thread
+    std::unique_ptr<rx_pdu_t> rx_pdu = unpack_mme_rx_msg(std::move(pdu), flags);
+    return std::bind([this, from, sri, flags](
+                         std::unique_ptr<rx_pdu_t>& msg) { handle_mme_rx_pdu(std::move(msg), from, sri, flags); },
+                     std::move(rx_pdu));
+  };
   rx_socket_handler->add_socket_handler(mme_socket.fd(),
-                                        srsran::make_sctp_sdu_handler(logger, mme_task_queue, rx_callback));
+                                        srsran::make_sctp_sdu_preprocess_handler(logger, mme_task_queue, rx_callback));
 
   logger.info("SCTP socket established with MME");
   return true;
@@ -552,6 +557,31 @@ bool s1ap::handle_mme_rx_msg(srsran::unique_byte_buffer_t pdu,
                              const sctp_sndrcvinfo&       sri,
                              int                          flags)
 {
+  return handle_mme_rx_pdu(unpack_mme_rx_msg(std::move(pdu), flags), from, sri, flags);
+}
+
+std::unique_ptr<s1ap::rx_pdu_t> s1ap::unpack_mme_rx_msg(srsran::unique_byte_buffer_t pdu, int flags)
+{
+  std::unique_ptr<rx_pdu_t> rx_pdu(new rx_pdu_t);
+  rx_pdu->buffer = std::move(pdu);
+  if ((flags & MSG_NOTIFICATION) or rx_pdu->buffer->N_bytes == 0) {
+    return rx_pdu;
+  }
+
+  // The PDU containers are allocated in the arena of the message
+  asn1::cbit_ref    bref(rx_pdu->buffer->msg, rx_pdu->buffer->N_bytes);
+  asn1::arena_scope scope(rx_pdu->arena);
+  rx_pdu->unpacked = rx_pdu->pdu.unpack(bref) == asn1::SRSASN_SUCCESS;
+  return rx_pdu;
+}
+
+bool s1ap::handle_mme_rx_pdu(std::unique_ptr<rx_pdu_t> rx_pdu,
+                             const sockaddr_in&        from,
+                             const sctp_sndrcvinfo&    sri,
+                             int                       flags)
+{
+  srsran::byte_buffer_t* pdu = rx_pdu->buffer.get();
+
   // Handle Notification Case
   if (flags & MSG_NOTIFICATION) {
     // Received notification
@@ -585,21 +615,21 @@ bool s1ap::handle_mme_rx_msg(srsran::unique_byte_buffer_t pdu,
     return false;
   }
 
-  handle_s1ap_rx_pdu(pdu.get());
+  handle_s1ap_rx_pdu(*rx_pdu);
   return true;
 }
 
-bool s1ap::handle_s1ap_rx_pdu(srsran::byte_buffer_t* pdu)
+bool s1ap::handle_s1ap_rx_pdu(rx_pdu_t& rx_msg)
 {
+  srsran::byte_buffer_t* pdu = rx_msg.buffer.get();
+
   // Save message to PCAP
   if (pcap != nullptr) {
     pcap->write_s1ap(pdu->msg, pdu->N_bytes);
   }
 
-  s1ap_pdu_c     rx_pdu;
-  asn1::cbit_ref bref(pdu->msg, pdu->N_bytes);
-
-  if (rx_pdu.unpack(bref) != asn1::SRSASN_SUCCESS) {
+  const s1ap_pdu_c& rx_pdu = rx_msg.pdu;
+  if (not rx_msg.unpacked) {
     logger.error(pdu->msg, pdu->N_bytes, "Failed to unpack received PDU");
     cause_c cause;
     cause.set_protocol().value = cause_protocol_opts::transfer_syntax_error;
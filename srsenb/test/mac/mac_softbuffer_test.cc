@@ -0,0 +1,155 @@
+/**
+ * Copyright 2013-2021 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "srsenb/hdr/stack/mac/ue.h"
+#include "srsran/common/test_common.h"
+
+namespace srsenb {
+
+const uint32_t nof_prb   = 25;
+const uint32_t large_tbs = 20000; // several code blocks
+const uint32_t small_tbs = 1000;  // one code block
+
+int test_tx_lease_release()
+{
+  auto              pools = std::make_shared<softbuffer_cb_pools>(nof_prb, 0);
+  ue_cc_softbuffers sb(nof_prb, SRSRAN_FDD_NOF_HARQ, SRSRAN_FDD_NOF_HARQ, pools);
+
+  // TEST: pooled softbuffers hold no storage until a new TB is scheduled
+  for (uint32_t pid = 0; pid < SRSRAN_FDD_NOF_HARQ; pid++) {
+    TESTASSERT(sb.get_tx(pid, 0).max_cb == 0);
+  }
+  TESTASSERT(srsran_softbuffer_pool_nof_leased(&pools->tx) == 0);
+
+  // TEST: new TBs lease storage sized to their TBS
+  srsran_softbuffer_tx_t* tb0 = sb.get_tx(10, 0, 0, large_tbs);
+  srsran_softbuffer_tx_t* tb1 = sb.get_tx(11, 1, 0, small_tbs);
+  TESTASSERT(tb0 != nullptr and tb1 != nullptr);
+  TESTASSERT(tb0->max_cb > 1 and tb1->max_cb == 1);
+  TESTASSERT(srsran_softbuffer_pool_nof_leased(&pools->tx) == tb0->max_cb + tb1->max_cb);
+
+  // TEST: an ACK only releases the TB last transmitted in its TTI and codeword
+  sb.release_tx(10, 1);
+  TESTASSERT(tb0->max_cb > 1);
+  sb.release_tx(10, 0);
+  TESTASSERT(tb0->max_cb == 0 and tb1->max_cb == 1);
+  TESTASSERT(srsran_softbuffer_pool_nof_leased(&pools->tx) == 1);
+
+  // TEST: a retransmission keeps the storage and moves the TTI its ACK refers to
+  TESTASSERT(sb.get_tx(19, 1, 0, 0) == tb1);
+  TESTASSERT(tb1->max_cb == 1);
+  sb.release_tx(11, 0);
+  TESTASSERT(tb1->max_cb == 1);
+  sb.release_tx(19, 0);
+  TESTASSERT(tb1->max_cb == 0);
+  TESTASSERT(srsran_softbuffer_pool_nof_leased(&pools->tx) == 0);
+
+  // TEST: released storage is recycled, the pool does not grow
+  uint32_t nof_allocated = srsran_softbuffer_pool_nof_allocated(&pools->tx);
+  TESTASSERT(sb.get_tx(20, 2, 0, large_tbs) != nullptr);
+  TESTASSERT(srsran_softbuffer_pool_nof_allocated(&pools->tx) == nof_allocated);
+
+  // TEST: clearing the carrier gives everything back
+  sb.clear();
+  TESTASSERT(srsran_softbuffer_pool_nof_leased(&pools->tx) == 0);
+
+  return SRSRAN_SUCCESS;
+}
+
+int test_rx_lease_release()
+{
+  auto              pools = std::make_shared<softbuffer_cb_pools>(nof_prb, 0);
+  ue_cc_softbuffers sb(nof_prb, SRSRAN_FDD_NOF_HARQ, SRSRAN_FDD_NOF_HARQ, pools);
+
+  srsran_softbuffer_rx_t* rx = sb.get_rx(100, large_tbs);
+  TESTASSERT(rx != nullptr and rx->max_cb > 1);
+
+  // TEST: a CRC of the same HARQ process but another TTI does not release the storage
+  sb.release_rx(100 + SRSRAN_FDD_NOF_HARQ);
+  TESTASSERT(rx->max_cb > 1);
+
+  // TEST: a retransmission keeps the storage
+  TESTASSERT(sb.get_rx(100 + SRSRAN_FDD_NOF_HARQ, 0) == rx);
+  TESTASSERT(rx->max_cb > 1);
+  sb.release_rx(100);
+  TESTASSERT(rx->max_cb > 1);
+
+  sb.release_rx(100 + SRSRAN_FDD_NOF_HARQ);
+  TESTASSERT(rx->max_cb == 0);
+  TESTASSERT(srsran_softbuffer_pool_nof_leased(&pools->rx) == 0);
+
+  return SRSRAN_SUCCESS;
+}
+
+int test_expiry()
+{
+  auto              pools = std::make_shared<softbuffer_cb_pools>(nof_prb, 0);
+  ue_cc_softbuffers sb(nof_prb, SRSRAN_FDD_NOF_HARQ, SRSRAN_FDD_NOF_HARQ, pools);
+
+  // Leased just before the TTI counter wraps
+  uint32_t                tti = 10235;
+  srsran_softbuffer_tx_t* tx  = sb.get_tx(tti, 3, 1, large_tbs);
+  srsran_softbuffer_rx_t* rx  = sb.get_rx(tti, large_tbs);
+  TESTASSERT(tx != nullptr and rx != nullptr);
+
+  // TEST: storage survives until it is older than the expiry
+  sb.release_expired(TTI_ADD(tti, ue_cc_softbuffers::expiry_ttis));
+  TESTASSERT(tx->max_cb > 0 and rx->max_cb > 0);
+
+  // TEST: never acknowledged TBs are reclaimed once they expire
+  sb.release_expired(TTI_ADD(tti, ue_cc_softbuffers::expiry_ttis + 1));
+  TESTASSERT(tx->max_cb == 0 and rx->max_cb == 0);
+  TESTASSERT(srsran_softbuffer_pool_nof_leased(&pools->tx) == 0);
+  TESTASSERT(srsran_softbuffer_pool_nof_leased(&pools->rx) == 0);
+
+  return SRSRAN_SUCCESS;
+}
+
+int test_no_pool()
+{
+  ue_cc_softbuffers sb(nof_prb, SRSRAN_FDD_NOF_HARQ, SRSRAN_FDD_NOF_HARQ);
+
+  // TEST: without pools the storage is allocated upfront and never released
+  srsran_softbuffer_tx_t* tx = sb.get_tx(0, 0, 0, small_tbs);
+  srsran_softbuffer_rx_t* rx = sb.get_rx(0, small_tbs);
+  TESTASSERT(tx != nullptr and rx != nullptr);
+  uint32_t tx_max_cb = tx->max_cb;
+  uint32_t rx_max_cb = rx->max_cb;
+  TESTASSERT(tx_max_cb > 1 and rx_max_cb > 1);
+
+  sb.release_tx(0, 0);
+  sb.release_rx(0);
+  sb.release_expired(ue_cc_softbuffers::expiry_ttis + 1);
+  TESTASSERT(tx->max_cb == tx_max_cb and rx->max_cb == rx_max_cb);
+
+  return SRSRAN_SUCCESS;
+}
+
+} // namespace srsenb
+
+int main()
+{
+  TESTASSERT(srsenb::test_tx_lease_release() == SRSRAN_SUCCESS);
+  TESTASSERT(srsenb::test_rx_lease_release() == SRSRAN_SUCCESS);
+  TESTASSERT(srsenb::test_expiry() == SRSRAN_SUCCESS);
+  TESTASSERT(srsenb::test_no_pool() == SRSRAN_SUCCESS);
+  printf("Success\n");
+}
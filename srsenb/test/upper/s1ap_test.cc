@@ -23,6 +23,7 @@
 #include "srsenb/test/common/dummy_classes.h"
 #include "srsran/common/network_utils.h"
 #include "srsran/common/test_common.h"
+#include <chrono>
 
 using namespace srsenb;
 
@@ -323,6 +324,87 @@ void test_s1ap_erab_setup(test_event event)
   TESTASSERT(erab_item.erab_id == 5);
 }
 
+/// Compares the time spent in the stack thread per received Paging, when the PDU is unpacked in the stack thread and
+/// when it is unpacked beforehand in the socket thread
+void test_s1ap_rx_paging_stack_time()
+{
+  srsran::task_scheduler task_sched;
+  srslog::basic_logger&  logger = srslog::fetch_basic_logger("S1AP");
+  dummy_socket_manager   rx_sockets;
+  s1ap                   s1ap_obj(&task_sched, logger, &rx_sockets);
+  rrc_tester             rrc;
+
+  const char*    mme_addr_str = "127.0.0.1";
+  const uint32_t MME_PORT     = 36412;
+  mme_dummy      mme(mme_addr_str, MME_PORT);
+
+  s1ap_args_t args   = {};
+  args.cell_id       = 0x01;
+  args.enb_id        = 0x19B;
+  args.mcc           = 907;
+  args.mnc           = 70;
+  args.s1c_bind_addr = "127.0.0.100";
+  args.tac           = 7;
+  args.gtp_bind_addr = "127.0.0.100";
+  args.mme_addr      = mme_addr_str;
+  args.enb_name      = "srsenb01";
+  TESTASSERT(s1ap_obj.init(args, &rrc) == SRSRAN_SUCCESS);
+  run_s1_setup(s1ap_obj, mme);
+
+  asn1::s1ap::s1ap_pdu_c paging_pdu;
+  paging_pdu.set_init_msg().load_info_obj(ASN1_S1AP_ID_PAGING);
+  auto& paging = paging_pdu.init_msg().value.paging().protocol_ies;
+  paging.ue_id_idx_value.value.from_number(123);
+  paging.ue_paging_id.value.set_s_tmsi().mmec[0] = 0x1a;
+  paging.ue_paging_id.value.s_tmsi().m_tmsi.from_number(0x12345678);
+  paging.cn_domain.value.value = asn1::s1ap::cn_domain_opts::ps;
+  paging.tai_list.value.resize(1);
+  paging.tai_list.value[0].load_info_obj(ASN1_S1AP_ID_TAI_ITEM);
+  paging.tai_list.value[0].value.tai_item().tai.tac.from_number(7);
+
+  uint8_t       paging_msg[256];
+  asn1::bit_ref bref(paging_msg, sizeof(paging_msg));
+  TESTASSERT(paging_pdu.pack(bref) == SRSRAN_SUCCESS);
+  uint32_t paging_len = bref.distance_bytes();
+
+  auto make_paging_sdu = [&paging_msg, paging_len]() {
+    srsran::unique_byte_buffer_t sdu = srsran::make_byte_buffer();
+    memcpy(sdu->msg, paging_msg, paging_len);
+    sdu->N_bytes = paging_len;
+    return sdu;
+  };
+
+  const uint32_t  nof_msgs = 10000;
+  sockaddr_in     mme_addr = {};
+  sctp_sndrcvinfo rcvinfo  = {};
+  int             flags    = 0;
+  logger.set_level(srslog::basic_levels::warning);
+
+  // Unpack and handle in the stack thread
+  std::chrono::nanoseconds stack_unpack_time{0};
+  for (uint32_t i = 0; i < nof_msgs; i++) {
+    srsran::unique_byte_buffer_t sdu = make_paging_sdu();
+    auto                         t0  = std::chrono::steady_clock::now();
+    TESTASSERT(s1ap_obj.handle_mme_rx_msg(std::move(sdu), mme_addr, rcvinfo, flags));
+    stack_unpack_time += std::chrono::steady_clock::now() - t0;
+  }
+
+  // Unpack in the socket thread, handle in the stack thread
+  std::chrono::nanoseconds socket_unpack_time{0};
+  for (uint32_t i = 0; i < nof_msgs; i++) {
+    std::unique_ptr<s1ap::rx_pdu_t> rx_pdu = s1ap_obj.unpack_mme_rx_msg(make_paging_sdu(), flags);
+    TESTASSERT(rx_pdu->unpacked);
+    auto t0 = std::chrono::steady_clock::now();
+    TESTASSERT(s1ap_obj.handle_mme_rx_pdu(std::move(rx_pdu), mme_addr, rcvinfo, flags));
+    socket_unpack_time += std::chrono::steady_clock::now() - t0;
+  }
+  logger.set_level(srslog::basic_levels::debug);
+
+  srsran::console("Stack thread time per Paging: unpacked in stack thread %.2f usec, in socket thread %.2f usec\n",
+                  stack_unpack_time.count() / 1000.0 / nof_msgs,
+                  socket_unpack_time.count() / 1000.0 / nof_msgs);
+}
+
 int main(int argc, char** argv)
 {
   // Setup logging.
@@ -337,4 +419,5 @@ int main(int argc, char** argv)
   test_s1ap_erab_setup(test_event::wrong_erabid_mod);
   test_s1ap_erab_setup(test_event::wrong_mme_s1ap_id);
   test_s1ap_erab_setup(test_event::repeated_erabid_mod);
+  test_s1ap_rx_paging_stack_time();
 }
\ No newline at end of file
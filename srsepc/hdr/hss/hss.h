@@ -30,11 +30,18 @@
 
 #include "srsran/common/buffer_pool.h"
 #include "srsran/common/standard_streams.h"
+#include "srsran/common/threads.h"
 #include "srsran/interfaces/epc_interfaces.h"
 #include "srsran/srslog/srslog.h"
+#include <condition_variable>
 #include <cstddef>
+#include <cstring>
+#include <deque>
 #include <fstream>
 #include <map>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
 
 #define LTE_FDD_ENB_IND_HE_N_BITS 5
 #define LTE_FDD_ENB_IND_HE_MASK 0x1FUL
@@ -47,10 +54,18 @@ typedef struct {
   std::string db_file;
   uint16_t    mcc;
   uint16_t    mnc;
+  uint32_t    auth_vector_cache;
 } hss_args_t;
 
 enum hss_auth_algo { HSS_ALGO_XOR, HSS_ALGO_MILENAGE };
 
+typedef struct {
+  uint8_t k_asme[32];
+  uint8_t autn[16];
+  uint8_t rand[16];
+  uint8_t xres[16];
+} hss_auth_vector_t;
+
 typedef struct {
   // Members
   std::string        name;
@@ -66,13 +81,19 @@ typedef struct {
   uint8_t            last_rand[16];
   std::string        static_ip_addr;
 
+  // Pre-generated authentication vectors (MILENAGE only), in SQN order. The SQN above is the one of the next vector
+  // to be generated. Protected by the mutex, as they are refilled by the HSS thread.
+  std::mutex                    mutex;
+  std::deque<hss_auth_vector_t> auth_vectors;
+  bool                          refill_pending = false;
+
   // Helper getters/setters
   void set_sqn(const uint8_t* sqn_);
   void set_last_rand(const uint8_t* rand_);
   void get_last_rand(uint8_t* rand_);
 } hss_ue_ctx_t;
 
-class hss : public hss_interface_nas
+class hss : public hss_interface_nas, public srsran::thread
 {
 public:
   static hss* get_instance(void);
@@ -92,19 +113,26 @@ private:
   virtual ~hss();
   static hss* m_instance;
 
-  std::map<uint64_t, std::unique_ptr<hss_ue_ctx_t> > m_imsi_to_ue_ctx;
+  std::unordered_map<uint64_t, std::unique_ptr<hss_ue_ctx_t> > m_imsi_to_ue_ctx;
 
   void gen_rand(uint8_t rand_[16]);
 
   void
        gen_auth_info_answer_milenage(hss_ue_ctx_t* ue_ctx, uint8_t* k_asme, uint8_t* autn, uint8_t* rand, uint8_t* xres);
+  void gen_auth_vectors_milenage(hss_ue_ctx_t* const* ue_ctxs, uint32_t nof_vectors, hss_auth_vector_t* vectors);
   void gen_auth_info_answer_xor(hss_ue_ctx_t* ue_ctx, uint8_t* k_asme, uint8_t* autn, uint8_t* rand, uint8_t* xres);
 
   void resync_sqn_milenage(hss_ue_ctx_t* ue_ctx, uint8_t* auts);
   void resync_sqn_xor(hss_ue_ctx_t* ue_ctx, uint8_t* auts);
 
-  std::vector<std::string> split_string(const std::string& str, char delimiter);
-  void                     get_uint_vec_from_hex_str(const std::string& key_str, uint8_t* key, uint len);
+  struct db_field_t {
+    const char* str;
+    size_t      len;
+    std::string to_string() const { return std::string(str, len); }
+    bool        operator==(const char* other) const { return strlen(other) == len && strncmp(str, other, len) == 0; }
+  };
+  uint32_t split_line(const char* line, const char* end, char delimiter, db_field_t* fields, uint32_t max_fields);
+  void     get_uint_vec_from_hex_str(const db_field_t& key_str, uint8_t* key, uint len);
 
   void increment_ue_sqn(hss_ue_ctx_t* ue_ctx);
   void increment_seq_after_resync(hss_ue_ctx_t* ue_ctx);
@@ -112,12 +140,34 @@ private:
 
   bool          set_auth_algo(std::string auth_algo);
   bool          read_db_file(std::string db_file);
+  bool          parse_db_line(const char* line, const char* end);
   bool          write_db_file(std::string db_file);
   hss_ue_ctx_t* get_ue_ctx(uint64_t imsi);
 
+  // SQN journal. Every SQN update is appended to it, so that it survives a crash of the EPC. The journal is folded
+  // back into the user database at startup and shutdown.
+  uint32_t replay_sqn_journal(const std::string& journal_file);
+  bool     open_sqn_journal(const std::string& journal_file, bool truncate);
+  void     journal_sqn(const hss_ue_ctx_t* ue_ctx);
+
   std::string hex_string(uint8_t* hex, int size);
 
+  // Authentication vector cache. When enabled, the HSS thread keeps up to auth_vector_cache vectors per subscriber,
+  // generated in batches across subscribers, so that the crypto is off the attach path.
+  void run_thread();
+  void request_auth_vectors(hss_ue_ctx_t* ue_ctx);
+  void refill_auth_vectors(const std::vector<hss_ue_ctx_t*>& ue_ctxs);
+  void stop_auth_vector_thread();
+
+  uint32_t                  auth_vector_cache   = 0;
+  bool                      auth_vector_running = false;
+  std::mutex                auth_vector_mutex;
+  std::condition_variable   auth_vector_cvar;
+  std::deque<hss_ue_ctx_t*> auth_vector_requests;
+
   std::string db_file;
+  std::string sqn_journal_file;
+  int         sqn_journal_fd = -1;
 
   /*Logs*/
   srslog::basic_logger& m_logger = srslog::fetch_basic_logger("HSS");
@@ -30,24 +30,26 @@
 
 #include "s1ap.h"
 #include "srsran/common/buffer_pool.h"
+#include "srsran/common/epoll_helper.h"
 #include "srsran/common/standard_streams.h"
+#include "srsran/common/thread_pool.h"
 #include "srsran/common/threads.h"
+#include <condition_variable>
 #include <cstddef>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <unordered_map>
 
 namespace srsepc {
 
 typedef struct {
   s1ap_args_t s1ap_args;
+  uint32_t    nof_workers;
   // diameter_args_t diameter_args;
   // gtpc_args_t gtpc_args;
 } mme_args_t;
 
-typedef struct {
-  int                 fd;
-  uint64_t            imsi;
-  enum nas_timer_type type;
-} mme_timer_t;
-
 class mme : public srsran::thread, public mme_interface_nas
 {
 public:
@@ -60,7 +62,7 @@ public:
   void run_thread();
 
   // Timer Methods
-  virtual bool add_nas_timer(int timer_fd, enum nas_timer_type type, uint64_t imsi);
+  virtual bool add_nas_timer(uint32_t timeout_ms, enum nas_timer_type type, uint64_t imsi);
   virtual bool is_nas_timer_running(enum nas_timer_type type, uint64_t imsi);
   virtual bool remove_nas_timer(enum nas_timer_type type, uint64_t imsi);
 
@@ -71,14 +73,40 @@ private:
   s1ap*       m_s1ap;
   mme_gtpc*   m_mme_gtpc;
 
-  bool   m_running;
-  fd_set m_set;
+  bool m_running;
+  int  m_epoll_fd;
+  int  m_timer_fd;
+
+  // Socket handling
+  void handle_s1mme_rx(int s1mme);
+  void handle_s11_rx(int s11);
+
+  // Workers. Each UE is served by a single worker, so that its messages are processed in order
+  struct s1ap_rx_task_t {
+    std::unique_ptr<s1ap_pdu_t> pdu;
+    struct sctp_sndrcvinfo      sri;
+  };
+  std::vector<std::unique_ptr<srsran::task_thread_pool> > m_workers;
+  std::mutex                                             m_pause_mutex;
+  std::condition_variable                                m_pause_cvar;
+  uint32_t                                               m_nof_paused_workers = 0;
+  bool                                                   m_resume_workers     = false;
+
+  void     dispatch_s1ap_pdu(srsran::unique_byte_buffer_t pdu, const struct sctp_sndrcvinfo& sri);
+  bool     get_s1ap_pdu_worker(const s1ap_pdu_t& pdu, const struct sctp_sndrcvinfo& sri, uint32_t* worker);
+  uint32_t get_ue_worker(uint64_t imsi);
+  void     run_with_workers_paused(const std::function<void()>& task);
 
-  // Timer map
-  std::vector<mme_timer_t> timers;
+  // Timers. NAS timers are indexed by IMSI and type, and ordered by their deadline in ms. The timer fd is armed at the
+  // earliest deadline, so the event loop only wakes up when a timer expires
+  std::mutex                                m_timers_mutex;
+  std::unordered_map<uint64_t, uint64_t>    m_nas_timers;
+  std::set<std::pair<uint64_t, uint64_t> > m_nas_timer_deadlines;
 
   // Timer Methods
-  void handle_timer_expire(int timer_fd);
+  void arm_timer_fd(uint64_t deadline_ms);
+  void handle_timer_fd();
+  void handle_timer_expire(enum nas_timer_type type, uint64_t imsi);
 
   // Logs
   srslog::basic_logger& m_s1ap_logger = srslog::fetch_basic_logger("S1AP");
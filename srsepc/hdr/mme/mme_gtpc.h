@@ -24,8 +24,10 @@
 #include "nas.h"
 #include "srsran/asn1/gtpc.h"
 #include "srsran/common/buffer_pool.h"
+#include <mutex>
 #include <sys/socket.h>
 #include <sys/un.h>
+#include <unordered_map>
 
 namespace srsepc {
 
@@ -47,6 +49,7 @@ public:
   bool init();
   bool send_s11_pdu(const srsran::gtpc_pdu& pdu);
   void handle_s11_pdu(srsran::byte_buffer_t* msg);
+  bool find_imsi_from_s11_pdu(const srsran::byte_buffer_t* msg, uint64_t* imsi);
 
   virtual bool send_create_session_request(uint64_t imsi);
   bool         handle_create_session_response(srsran::gtpc_pdu* cs_resp_pdu);
@@ -66,15 +69,19 @@ private:
   srslog::basic_logger& m_logger = srslog::fetch_basic_logger("MME GTPC");
   s1ap*                 m_s1ap;
 
-  uint32_t                            m_next_ctrl_teid;
-  std::map<uint32_t, uint64_t>        m_mme_ctr_teid_to_imsi;
-  std::map<uint64_t, struct gtpc_ctx> m_imsi_to_gtpc_ctx;
+  // Protects the GTP-C contexts, which are accessed by all MME workers
+  std::mutex                                    m_mutex;
+  uint32_t                                      m_next_ctrl_teid;
+  std::unordered_map<uint32_t, uint64_t>        m_mme_ctr_teid_to_imsi;
+  std::unordered_map<uint64_t, struct gtpc_ctx> m_imsi_to_gtpc_ctx;
 
   int                m_s11;
   struct sockaddr_un m_mme_addr, m_spgw_addr;
 
   bool     init_s11();
   uint32_t get_new_ctrl_teid();
+  bool     find_imsi_from_ctrl_teid(uint32_t mme_ctrl_teid, uint64_t* imsi);
+  bool     find_sgw_ctr_fteid(uint64_t imsi, srsran::gtp_fteid_t* sgw_ctr_fteid);
 };
 
 inline uint32_t mme_gtpc::get_new_ctrl_teid()
@@ -0,0 +1,88 @@
+/**
+ * Copyright 2013-2021 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+#ifndef SRSEPC_MME_UE_REGISTRY_H
+#define SRSEPC_MME_UE_REGISTRY_H
+
+#include "nas.h"
+#include "srsran/adt/intrusive_list.h"
+#include <functional>
+#include <unordered_map>
+
+namespace srsepc {
+
+/**
+ * Registry of the UE contexts of the MME. It keeps hashed indexes of the NAS contexts by IMSI and by MME-UE-S1AP-ID,
+ * the M-TMSI to IMSI and IMSI to MME-UE-S1AP-ID mappings and, for each eNB, the list of its ECM-connected UEs. The eNB
+ * lists are intrusive, so that adding and removing a UE is O(1) and releasing all the UEs of an eNB does not need any
+ * lookup.
+ * The registry is not thread-safe, the owner serializes the accesses.
+ */
+class mme_ue_registry
+{
+public:
+  void reserve(uint32_t nof_ues);
+  void clear();
+
+  // IMSI index. The registry owns the contexts in this index
+  bool     add_imsi(nas* nas_ctx);
+  nas*     find_imsi(uint64_t imsi) const;
+  nas*     remove_imsi(uint64_t imsi);
+  uint32_t nof_ues() const { return m_imsi_to_nas_ctx.size(); }
+  void     for_each_ue(const std::function<void(nas*)>& func);
+
+  // MME-UE-S1AP-ID index, only UEs in ECM-CONNECTED
+  bool add_mme_ue_s1ap_id(nas* nas_ctx);
+  nas* find_mme_ue_s1ap_id(uint32_t mme_ue_s1ap_id) const;
+  bool remove_mme_ue_s1ap_id(uint32_t mme_ue_s1ap_id);
+  // MME-UE-S1AP-ID the IMSI had when it was indexed, 0 if none. It does not read the NAS context, which its worker may
+  // be modifying
+  uint32_t find_imsi_mme_ue_s1ap_id(uint64_t imsi) const;
+
+  // M-TMSI index. Only the last M-TMSI allocated to an IMSI is kept
+  void     add_m_tmsi(uint32_t m_tmsi, uint64_t imsi);
+  uint64_t find_m_tmsi(uint32_t m_tmsi) const;
+
+  // UEs connected through each eNB, by SCTP association
+  void add_enb(int32_t enb_assoc);
+  bool has_enb(int32_t enb_assoc) const { return m_enb_assoc_to_ues.count(enb_assoc) > 0; }
+  void remove_enb(int32_t enb_assoc);
+  bool add_ue_to_enb(int32_t enb_assoc, nas* nas_ctx);
+  void remove_ue_from_enb(nas* nas_ctx);
+  // Unlinks all the UEs of the eNB and removes them from the MME-UE-S1AP-ID index, calling func on each of them
+  uint32_t release_enb_ues(int32_t enb_assoc, const std::function<void(nas*)>& func);
+
+private:
+  using enb_ue_list_t = srsran::intrusive_double_linked_list<nas>;
+
+  void erase_mme_ue_s1ap_id(uint32_t mme_ue_s1ap_id);
+
+  std::unordered_map<uint64_t, nas*>         m_imsi_to_nas_ctx;
+  std::unordered_map<uint32_t, nas*>         m_mme_ue_s1ap_id_to_nas_ctx;
+  std::unordered_map<uint32_t, uint64_t>     m_mme_ue_s1ap_id_to_imsi;
+  std::unordered_map<uint64_t, uint32_t>     m_imsi_to_mme_ue_s1ap_id;
+  std::unordered_map<uint32_t, uint64_t>     m_tmsi_to_imsi;
+  std::unordered_map<uint64_t, uint32_t>     m_imsi_to_tmsi;
+  std::unordered_map<int32_t, enb_ue_list_t> m_enb_assoc_to_ues;
+};
+
+} // namespace srsepc
+
+#endif // SRSEPC_MME_UE_REGISTRY_H
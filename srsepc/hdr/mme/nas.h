@@ -22,6 +22,7 @@
 #ifndef SRSEPC_NAS_H
 #define SRSEPC_NAS_H
 
+#include "srsran/adt/intrusive_list.h"
 #include "srsran/asn1/gtpc_ies.h"
 #include "srsran/asn1/liblte_mme.h"
 #include "srsran/common/buffer_pool.h"
@@ -150,12 +151,16 @@ typedef struct {
   mme_interface_nas*  mme;
 } nas_if_t;
 
-class nas
+class nas : public srsran::intrusive_double_linked_list_element<>
 {
 public:
   nas(const nas_init_t& args, const nas_if_t& itf);
   void reset();
 
+  // NAS contexts are allocated from a memory pool
+  void* operator new(size_t sz);
+  void  operator delete(void* p);
+
   /***********************
    * Initial UE messages *
    ***********************/
@@ -261,6 +266,9 @@ public:
   esm_ctx_t m_esm_ctx[MAX_ERABS_PER_UE] = {};
   sec_ctx_t m_sec_ctx                   = {};
 
+  // SCTP association of the eNB list the context is linked in, -1 if none. Managed by the mme_ue_registry
+  int32_t m_enb_list_assoc = -1;
+
 private:
   srslog::basic_logger& m_logger = srslog::fetch_basic_logger("NAS");
   gtpc_interface_nas*   m_gtpc   = nullptr;
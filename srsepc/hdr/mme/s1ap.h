@@ -22,6 +22,7 @@
 #define SRSEPC_S1AP_H
 
 #include "mme_gtpc.h"
+#include "mme_ue_registry.h"
 #include "nas.h"
 #include "s1ap_ctx_mngmt_proc.h"
 #include "s1ap_erab_mngmt_proc.h"
@@ -39,12 +40,13 @@
 #include "srsran/srslog/srslog.h"
 #include <arpa/inet.h>
 #include <map>
+#include <mutex>
 #include <netinet/sctp.h>
-#include <set>
 #include <strings.h>
 #include <sys/socket.h>
 #include <sys/types.h>
 #include <unistd.h>
+#include <unordered_map>
 
 namespace srsepc {
 
@@ -68,6 +70,8 @@ public:
 
   bool s1ap_tx_pdu(const s1ap_pdu_t& pdu, struct sctp_sndrcvinfo* enb_sri);
   void handle_s1ap_rx_pdu(srsran::byte_buffer_t* pdu, struct sctp_sndrcvinfo* enb_sri);
+  bool unpack_s1ap_rx_pdu(srsran::byte_buffer_t* pdu, s1ap_pdu_t* rx_pdu);
+  void handle_s1ap_rx_pdu(const s1ap_pdu_t& rx_pdu, struct sctp_sndrcvinfo* enb_sri);
   void handle_initiating_message(const asn1::s1ap::init_msg_s& msg, struct sctp_sndrcvinfo* enb_sri);
   void handle_successful_outcome(const asn1::s1ap::successful_outcome_s& msg);
 
@@ -82,12 +86,17 @@ public:
   void       add_new_enb_ctx(const enb_ctx_t& enb_ctx, const struct sctp_sndrcvinfo* enb_sri);
   void       get_enb_ctx(uint16_t sctp_stream);
 
+  // MME workers. The MME-UE-S1AP-IDs allocated by a worker are congruent to its index modulo the number of workers
+  void        set_nof_workers(uint32_t nof_workers);
+  static void set_worker_idx(uint32_t worker_idx);
+
   bool add_nas_ctx_to_imsi_map(nas* nas_ctx);
   bool add_nas_ctx_to_mme_ue_s1ap_id_map(nas* nas_ctx);
   bool add_ue_to_enb_set(int32_t enb_assoc, uint32_t mme_ue_s1ap_id);
 
   virtual nas* find_nas_ctx_from_imsi(uint64_t imsi);
   nas*         find_nas_ctx_from_mme_ue_s1ap_id(uint32_t mme_ue_s1ap_id);
+  uint32_t     find_mme_ue_s1ap_id_from_imsi(uint64_t imsi);
 
   bool         release_ue_ecm_ctx(uint32_t mme_ue_s1ap_id);
   void         release_ues_ecm_ctx_in_enb(int32_t enb_assoc);
@@ -105,7 +114,7 @@ public:
   s1ap_erab_mngmt_proc* m_s1ap_erab_mngmt_proc;
   s1ap_paging*          m_s1ap_paging;
 
-  std::map<uint32_t, uint64_t>   m_tmsi_to_imsi;
+  // The eNB contexts are only modified while the MME workers are paused
   std::map<uint16_t, enb_ctx_t*> m_active_enbs;
 
   // Interfaces
@@ -136,22 +145,26 @@ private:
 
   uint32_t m_plmn;
 
-  hss_interface_nas*                     m_hss;
-  int                                    m_s1mme;
-  std::map<int32_t, uint16_t>            m_sctp_to_enb_id;
-  std::map<int32_t, std::set<uint32_t> > m_enb_assoc_to_ue_ids;
+  hss_interface_nas*                    m_hss;
+  int                                   m_s1mme;
+  std::unordered_map<int32_t, uint16_t> m_sctp_to_enb_id;
 
-  std::map<uint64_t, nas*> m_imsi_to_nas_ctx;
-  std::map<uint32_t, nas*> m_mme_ue_s1ap_id_to_nas_ctx;
+  // UE contexts, indexed by IMSI, MME-UE-S1AP-ID, M-TMSI and eNB
+  mme_ue_registry m_ue_registry;
 
   uint32_t m_next_mme_ue_s1ap_id;
   uint32_t m_next_m_tmsi;
+  uint32_t m_nof_workers = 1;
+
+  // Protects the UE registries and ID counters, which are accessed by all MME workers
+  std::mutex m_ctx_mutex;
 
   // GTP-C Interface
   mme_gtpc* m_mme_gtpc;
 
   // PCAP
   bool              m_pcap_enable;
+  std::mutex        m_pcap_mutex;
   srsran::s1ap_pcap m_pcap;
 };
 
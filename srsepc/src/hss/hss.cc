@@ -20,27 +20,35 @@
  */
 #include "srsepc/hdr/hss/hss.h"
 #include "srsran/common/security.h"
+#include <algorithm>
 #include <arpa/inet.h>
+#include <fcntl.h>
 #include <inttypes.h> // for printing uint64_t
 #include <iomanip>
 #include <sstream>
 #include <stdlib.h> /* srand, rand */
 #include <string>
+#include <sys/mman.h>
+#include <sys/stat.h>
 #include <time.h>
+#include <unistd.h>
 
 namespace srsepc {
 
 hss*            hss::m_instance    = NULL;
 pthread_mutex_t hss_instance_mutex = PTHREAD_MUTEX_INITIALIZER;
 
-hss::hss()
+hss::hss() : thread("HSS")
 {
   return;
 }
 
 hss::~hss()
 {
-  return;
+  stop_auth_vector_thread();
+  if (sqn_journal_fd >= 0) {
+    close(sqn_journal_fd);
+  }
 }
 
 hss* hss::get_instance()
@@ -76,105 +84,174 @@ int hss::init(hss_args_t* hss_args)
   mcc = hss_args->mcc;
   mnc = hss_args->mnc;
 
-  db_file = hss_args->db_file;
+  db_file          = hss_args->db_file;
+  sqn_journal_file = db_file + ".sqn";
+
+  // Recover the SQN updates that were not written back to the user database, e.g. after a crash, and compact them
+  // into the database so that the journal starts empty
+  uint32_t nof_records = replay_sqn_journal(sqn_journal_file);
+  bool     compacted   = nof_records == 0 || write_db_file(db_file);
+  if (nof_records > 0) {
+    m_logger.info("Recovered %d SQN updates from %s", nof_records, sqn_journal_file.c_str());
+    srsran::console("Recovered %d SQN updates from %s\n", nof_records, sqn_journal_file.c_str());
+  }
+  if (!open_sqn_journal(sqn_journal_file, compacted)) {
+    srsran::console("Error opening SQN journal %s\n", sqn_journal_file.c_str());
+    return -1;
+  }
 
-  m_logger.info("HSS Initialized. DB file %s, MCC: %d, MNC: %d", hss_args->db_file.c_str(), mcc, mnc);
+  // Fill the authentication vector cache of all the subscribers in the background
+  auth_vector_cache = hss_args->auth_vector_cache;
+  if (auth_vector_cache > 0) {
+    auth_vector_running = true;
+    for (auto& ue : m_imsi_to_ue_ctx) {
+      request_auth_vectors(ue.second.get());
+    }
+    start();
+  }
+
+  m_logger.info("HSS Initialized. DB file %s, MCC: %d, MNC: %d, AUTH vector cache: %d",
+                hss_args->db_file.c_str(),
+                mcc,
+                mnc,
+                auth_vector_cache);
   srsran::console("HSS Initialized.\n");
   return 0;
 }
 
 void hss::stop()
 {
-  write_db_file(db_file);
-  return;
+  stop_auth_vector_thread();
+  if (write_db_file(db_file) && sqn_journal_fd >= 0) {
+    // All SQNs are in the user database now
+    if (ftruncate(sqn_journal_fd, 0) < 0) {
+      m_logger.error("Error truncating SQN journal %s: %s", sqn_journal_file.c_str(), strerror(errno));
+    }
+  }
+  if (sqn_journal_fd >= 0) {
+    close(sqn_journal_fd);
+    sqn_journal_fd = -1;
+  }
 }
 
 bool hss::read_db_file(std::string db_filename)
 {
-  std::ifstream m_db_file;
-
-  m_db_file.open(db_filename.c_str(), std::ifstream::in);
-  if (!m_db_file.is_open()) {
+  // The database is memory-mapped and parsed in place, which keeps startup fast for large numbers of users
+  int fd = open(db_filename.c_str(), O_RDONLY);
+  if (fd < 0) {
+    return false;
+  }
+  struct stat st = {};
+  if (fstat(fd, &st) < 0) {
+    close(fd);
     return false;
   }
   m_logger.info("Opened DB file: %s", db_filename.c_str());
+  if (st.st_size == 0) {
+    close(fd);
+    return true;
+  }
 
-  std::string line;
-  while (std::getline(m_db_file, line)) {
-    if (line[0] != '#' && line.length() > 0) {
-      uint                     column_size = 10;
-      std::vector<std::string> split       = split_string(line, ',');
-      if (split.size() != column_size) {
-        m_logger.error("Error parsing UE database. Wrong number of columns in .csv");
-        m_logger.error("Columns: %zd, Expected %d.", split.size(), column_size);
-
-        srsran::console("\nError parsing UE database. Wrong number of columns in user database CSV.\n");
-        srsran::console("Perhaps you are using an old user_db.csv?\n");
-        srsran::console("See 'srsepc/user_db.csv.example' for an example.\n\n");
-        return false;
-      }
-      std::unique_ptr<hss_ue_ctx_t> ue_ctx = std::unique_ptr<hss_ue_ctx_t>(new hss_ue_ctx_t);
-      ue_ctx->name                         = split[0];
-      if (split[1] == std::string("xor")) {
-        ue_ctx->algo = HSS_ALGO_XOR;
-      } else if (split[1] == std::string("mil")) {
-        ue_ctx->algo = HSS_ALGO_MILENAGE;
-      } else {
-        m_logger.error("Neither XOR nor MILENAGE configured.");
-        return false;
-      }
-      ue_ctx->imsi = strtoull(split[2].c_str(), nullptr, 10);
-      get_uint_vec_from_hex_str(split[3], ue_ctx->key, 16);
-      if (split[4] == std::string("op")) {
-        ue_ctx->op_configured = true;
-        get_uint_vec_from_hex_str(split[5], ue_ctx->op, 16);
-        srsran::compute_opc(ue_ctx->key, ue_ctx->op, ue_ctx->opc);
-      } else if (split[4] == std::string("opc")) {
-        ue_ctx->op_configured = false;
-        get_uint_vec_from_hex_str(split[5], ue_ctx->opc, 16);
-      } else {
-        m_logger.error("Neither OP nor OPc configured.");
-        return false;
-      }
-      get_uint_vec_from_hex_str(split[6], ue_ctx->amf, 2);
-      get_uint_vec_from_hex_str(split[7], ue_ctx->sqn, 6);
+  void* data = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (data == MAP_FAILED) {
+    m_logger.error("Error mapping DB file %s: %s", db_filename.c_str(), strerror(errno));
+    return false;
+  }
+  madvise(data, st.st_size, MADV_SEQUENTIAL);
 
-      m_logger.debug("Added user from DB, IMSI: %015" PRIu64 "", ue_ctx->imsi);
-      m_logger.debug(ue_ctx->key, 16, "User Key : ");
-      if (ue_ctx->op_configured) {
-        m_logger.debug(ue_ctx->op, 16, "User OP : ");
-      }
-      m_logger.debug(ue_ctx->opc, 16, "User OPc : ");
-      m_logger.debug(ue_ctx->amf, 2, "AMF : ");
-      m_logger.debug(ue_ctx->sqn, 6, "SQN : ");
-      ue_ctx->qci = (uint16_t)strtol(split[8].c_str(), nullptr, 10);
-      m_logger.debug("Default Bearer QCI: %d", ue_ctx->qci);
-
-      if (split[9] == std::string("dynamic")) {
-        ue_ctx->static_ip_addr = "0.0.0.0";
-      } else {
-        char buf[128] = {0};
-        if (inet_pton(AF_INET, split[9].c_str(), buf)) {
-          if (m_ip_to_imsi.insert(std::make_pair(split[9], ue_ctx->imsi)).second) {
-            ue_ctx->static_ip_addr = split[9];
-            m_logger.info("static ip addr %s", ue_ctx->static_ip_addr.c_str());
-          } else {
-            m_logger.info("duplicate static ip addr %s", split[9].c_str());
-            return false;
-          }
-        } else {
-          m_logger.info("invalid static ip addr %s, %s", split[9].c_str(), strerror(errno));
-          return false;
-        }
-      }
-      m_imsi_to_ue_ctx.insert(std::make_pair(ue_ctx->imsi, std::move(ue_ctx)));
+  // Rough estimate of the number of users, to avoid rehashing while loading
+  m_imsi_to_ue_ctx.reserve(st.st_size / 100);
+
+  bool        ret  = true;
+  const char* pos  = (const char*)data;
+  const char* end  = pos + st.st_size;
+  while (pos < end && ret) {
+    const char* eol = (const char*)memchr(pos, '\n', end - pos);
+    if (eol == nullptr) {
+      eol = end;
     }
+    const char* line_end = (eol > pos && eol[-1] == '\r') ? eol - 1 : eol;
+    if (line_end > pos && pos[0] != '#') {
+      ret = parse_db_line(pos, line_end);
+    }
+    pos = eol + 1;
   }
 
-  if (m_db_file.is_open()) {
-    m_db_file.close();
-  }
+  munmap(data, st.st_size);
+  return ret;
+}
 
+bool hss::parse_db_line(const char* line, const char* end)
+{
+  const uint32_t column_size = 10;
+  db_field_t     split[column_size + 1];
+  uint32_t       nof_columns = split_line(line, end, ',', split, column_size + 1);
+  if (nof_columns != column_size) {
+    m_logger.error("Error parsing UE database. Wrong number of columns in .csv");
+    m_logger.error("Columns: %d, Expected %d.", nof_columns, column_size);
+
+    srsran::console("\nError parsing UE database. Wrong number of columns in user database CSV.\n");
+    srsran::console("Perhaps you are using an old user_db.csv?\n");
+    srsran::console("See 'srsepc/user_db.csv.example' for an example.\n\n");
+    return false;
+  }
+  std::unique_ptr<hss_ue_ctx_t> ue_ctx = std::unique_ptr<hss_ue_ctx_t>(new hss_ue_ctx_t);
+  ue_ctx->name                         = split[0].to_string();
+  if (split[1] == "xor") {
+    ue_ctx->algo = HSS_ALGO_XOR;
+  } else if (split[1] == "mil") {
+    ue_ctx->algo = HSS_ALGO_MILENAGE;
+  } else {
+    m_logger.error("Neither XOR nor MILENAGE configured.");
+    return false;
+  }
+  ue_ctx->imsi = strtoull(split[2].to_string().c_str(), nullptr, 10);
+  get_uint_vec_from_hex_str(split[3], ue_ctx->key, 16);
+  if (split[4] == "op") {
+    ue_ctx->op_configured = true;
+    get_uint_vec_from_hex_str(split[5], ue_ctx->op, 16);
+    srsran::compute_opc(ue_ctx->key, ue_ctx->op, ue_ctx->opc);
+  } else if (split[4] == "opc") {
+    ue_ctx->op_configured = false;
+    get_uint_vec_from_hex_str(split[5], ue_ctx->opc, 16);
+  } else {
+    m_logger.error("Neither OP nor OPc configured.");
+    return false;
+  }
+  get_uint_vec_from_hex_str(split[6], ue_ctx->amf, 2);
+  get_uint_vec_from_hex_str(split[7], ue_ctx->sqn, 6);
+
+  m_logger.debug("Added user from DB, IMSI: %015" PRIu64 "", ue_ctx->imsi);
+  m_logger.debug(ue_ctx->key, 16, "User Key : ");
+  if (ue_ctx->op_configured) {
+    m_logger.debug(ue_ctx->op, 16, "User OP : ");
+  }
+  m_logger.debug(ue_ctx->opc, 16, "User OPc : ");
+  m_logger.debug(ue_ctx->amf, 2, "AMF : ");
+  m_logger.debug(ue_ctx->sqn, 6, "SQN : ");
+  ue_ctx->qci = (uint16_t)strtol(split[8].to_string().c_str(), nullptr, 10);
+  m_logger.debug("Default Bearer QCI: %d", ue_ctx->qci);
+
+  if (split[9] == "dynamic") {
+    ue_ctx->static_ip_addr = "0.0.0.0";
+  } else {
+    std::string ip_addr  = split[9].to_string();
+    char        buf[128] = {0};
+    if (inet_pton(AF_INET, ip_addr.c_str(), buf)) {
+      if (m_ip_to_imsi.insert(std::make_pair(ip_addr, ue_ctx->imsi)).second) {
+        ue_ctx->static_ip_addr = ip_addr;
+        m_logger.info("static ip addr %s", ue_ctx->static_ip_addr.c_str());
+      } else {
+        m_logger.info("duplicate static ip addr %s", ip_addr.c_str());
+        return false;
+      }
+    } else {
+      m_logger.info("invalid static ip addr %s, %s", ip_addr.c_str(), strerror(errno));
+      return false;
+    }
+  }
+  m_imsi_to_ue_ctx.insert(std::make_pair(ue_ctx->imsi, std::move(ue_ctx)));
   return true;
 }
 
@@ -188,11 +265,14 @@ bool hss::write_db_file(std::string db_filename)
 
   std::ofstream m_db_file;
 
-  m_db_file.open(db_filename.c_str(), std::ofstream::out);
+  // Write to a temporary file and rename it over the database, so that an interrupted write never leaves a truncated
+  // database behind
+  std::string tmp_filename = db_filename + ".tmp";
+  m_db_file.open(tmp_filename.c_str(), std::ofstream::out);
   if (!m_db_file.is_open()) {
     return false;
   }
-  m_logger.info("Opened DB file: %s", db_filename.c_str());
+  m_logger.info("Opened DB file: %s", tmp_filename.c_str());
 
   // Write comment info
   m_db_file << "#                                                                                           \n"
@@ -215,8 +295,16 @@ bool hss::write_db_file(std::string db_filename)
             << "#                                                                                           \n"
             << "# Note: Lines starting by '#' are ignored and will be overwritten                           \n";
 
-  std::map<uint64_t, std::unique_ptr<hss_ue_ctx_t> >::iterator it = m_imsi_to_ue_ctx.begin();
-  while (it != m_imsi_to_ue_ctx.end()) {
+  // Keep the rows ordered by IMSI, the lookup table itself is unordered
+  std::vector<uint64_t> imsis;
+  imsis.reserve(m_imsi_to_ue_ctx.size());
+  for (const auto& ue : m_imsi_to_ue_ctx) {
+    imsis.push_back(ue.first);
+  }
+  std::sort(imsis.begin(), imsis.end());
+
+  for (uint64_t imsi : imsis) {
+    auto it = m_imsi_to_ue_ctx.find(imsi);
     m_db_file << it->second->name;
     m_db_file << ",";
     m_db_file << (it->second->algo == HSS_ALGO_XOR ? "xor" : "mil");
@@ -244,11 +332,18 @@ bool hss::write_db_file(std::string db_filename)
     } else {
       m_db_file << ",dynamic";
     }
-    m_db_file << std::endl;
-    it++;
+    m_db_file << "\n";
   }
-  if (m_db_file.is_open()) {
-    m_db_file.close();
+  m_db_file.close();
+  if (m_db_file.fail()) {
+    m_logger.error("Error writing DB file %s", tmp_filename.c_str());
+    unlink(tmp_filename.c_str());
+    return false;
+  }
+  if (rename(tmp_filename.c_str(), db_filename.c_str()) < 0) {
+    m_logger.error("Error renaming %s to %s: %s", tmp_filename.c_str(), db_filename.c_str(), strerror(errno));
+    unlink(tmp_filename.c_str());
+    return false;
   }
   return true;
 }
@@ -264,15 +359,16 @@ bool hss::gen_auth_info_answer(uint64_t imsi, uint8_t* k_asme, uint8_t* autn, ui
     return false;
   }
 
+  std::lock_guard<std::mutex> lock(ue_ctx->mutex);
   switch (ue_ctx->algo) {
     case HSS_ALGO_XOR:
       gen_auth_info_answer_xor(ue_ctx, k_asme, autn, rand, xres);
+      increment_ue_sqn(ue_ctx);
       break;
     case HSS_ALGO_MILENAGE:
       gen_auth_info_answer_milenage(ue_ctx, k_asme, autn, rand, xres);
       break;
   }
-  increment_ue_sqn(ue_ctx);
   return true;
 }
 
@@ -282,58 +378,79 @@ void hss::gen_auth_info_answer_milenage(hss_ue_ctx_t* ue_ctx,
                                         uint8_t*      rand,
                                         uint8_t*      xres)
 {
-  // Get K, AMF, OPC and SQN
-  uint8_t* k   = ue_ctx->key;
-  uint8_t* amf = ue_ctx->amf;
-  uint8_t* opc = ue_ctx->opc;
-  uint8_t* sqn = ue_ctx->sqn;
-
-  // Temp variables
-  uint8_t ck[16];
-  uint8_t ik[16];
-  uint8_t ak[6];
-  uint8_t mac[8];
-
-  gen_rand(rand);
-
-  srsran::security_milenage_f2345(k, opc, rand, xres, ck, ik, ak);
-
-  m_logger.debug(k, 16, "User Key : ");
-  m_logger.debug(opc, 16, "User OPc : ");
-  m_logger.debug(rand, 16, "User Rand : ");
-  m_logger.debug(xres, 8, "User XRES: ");
-  m_logger.debug(ck, 16, "User CK: ");
-  m_logger.debug(ik, 16, "User IK: ");
-  m_logger.debug(ak, 6, "User AK: ");
-
-  srsran::security_milenage_f1(k, opc, rand, sqn, amf, mac);
-
-  m_logger.debug(sqn, 6, "User SQN : ");
-  m_logger.debug(mac, 8, "User MAC : ");
-
-  // Generate K_asme
-  srsran::security_generate_k_asme(ck, ik, ak, sqn, mcc, mnc, k_asme);
-
-  m_logger.debug("User MCC : %x  MNC : %x ", mcc, mnc);
-  m_logger.debug(k_asme, 32, "User k_asme : ");
-
-  // Generate AUTN (autn = sqn ^ ak |+| amf |+| mac)
-  for (int i = 0; i < 6; i++) {
-    autn[i] = sqn[i] ^ ak[i];
-  }
-  for (int i = 0; i < 2; i++) {
-    autn[6 + i] = amf[i];
-  }
-  for (int i = 0; i < 8; i++) {
-    autn[8 + i] = mac[i];
-  }
-  m_logger.debug(autn, 16, "User AUTN: ");
+  hss_auth_vector_t av;
+  if (not ue_ctx->auth_vectors.empty()) {
+    av = ue_ctx->auth_vectors.front();
+    ue_ctx->auth_vectors.pop_front();
+    m_logger.debug("Using cached AUTH vector, %zd left -- IMSI: %015" PRIu64 "",
+                   ue_ctx->auth_vectors.size(),
+                   ue_ctx->imsi);
+  } else {
+    gen_auth_vectors_milenage(&ue_ctx, 1, &av);
+  }
+  request_auth_vectors(ue_ctx);
+
+  memcpy(k_asme, av.k_asme, sizeof(av.k_asme));
+  memcpy(autn, av.autn, sizeof(av.autn));
+  memcpy(rand, av.rand, sizeof(av.rand));
+  memcpy(xres, av.xres, sizeof(av.xres));
 
   // Set last RAND
   ue_ctx->set_last_rand(rand);
   return;
 }
 
+void hss::gen_auth_vectors_milenage(hss_ue_ctx_t* const* ue_ctxs, uint32_t nof_vectors, hss_auth_vector_t* vectors)
+{
+  std::vector<srsran::milenage_vector_t> mil(nof_vectors);
+
+  // Each vector takes the next SQN of its UE. A UE may appear several times, its vectors get consecutive SQNs
+  for (uint32_t n = 0; n < nof_vectors; n++) {
+    hss_ue_ctx_t* ue_ctx = ue_ctxs[n];
+    mil[n].k             = ue_ctx->key;
+    mil[n].op_c          = ue_ctx->opc;
+    gen_rand(mil[n].rand);
+    memcpy(mil[n].sqn, ue_ctx->sqn, 6);
+    memcpy(mil[n].amf, ue_ctx->amf, 2);
+    increment_ue_sqn(ue_ctx);
+  }
+
+  srsran::security_milenage_batch(mil.data(), nof_vectors);
+
+  for (uint32_t n = 0; n < nof_vectors; n++) {
+    srsran::milenage_vector_t& v  = mil[n];
+    hss_auth_vector_t&         av = vectors[n];
+
+    m_logger.debug("Generated AUTH vector -- IMSI: %015" PRIu64 "", ue_ctxs[n]->imsi);
+    m_logger.debug(v.rand, 16, "User Rand : ");
+    m_logger.debug(v.res, 8, "User XRES: ");
+    m_logger.debug(v.ck, 16, "User CK: ");
+    m_logger.debug(v.ik, 16, "User IK: ");
+    m_logger.debug(v.ak, 6, "User AK: ");
+    m_logger.debug(v.sqn, 6, "User SQN : ");
+    m_logger.debug(v.mac_a, 8, "User MAC : ");
+
+    // Generate K_asme
+    srsran::security_generate_k_asme(v.ck, v.ik, v.ak, v.sqn, mcc, mnc, av.k_asme);
+
+    // Generate AUTN (autn = sqn ^ ak |+| amf |+| mac)
+    for (int i = 0; i < 6; i++) {
+      av.autn[i] = v.sqn[i] ^ v.ak[i];
+    }
+    for (int i = 0; i < 2; i++) {
+      av.autn[6 + i] = v.amf[i];
+    }
+    for (int i = 0; i < 8; i++) {
+      av.autn[8 + i] = v.mac_a[i];
+    }
+    memcpy(av.rand, v.rand, 16);
+    memcpy(av.xres, v.res, 8);
+    memset(&av.xres[8], 0, 8);
+    m_logger.debug(av.k_asme, 32, "User k_asme : ");
+    m_logger.debug(av.autn, 16, "User AUTN: ");
+  }
+}
+
 void hss::gen_auth_info_answer_xor(hss_ue_ctx_t* ue_ctx, uint8_t* k_asme, uint8_t* autn, uint8_t* rand, uint8_t* xres)
 {
   // Get K, AMF, OPC and SQN
@@ -431,7 +548,7 @@ void hss::gen_auth_info_answer_xor(hss_ue_ctx_t* ue_ctx, uint8_t* k_asme, uint8_
 
 bool hss::gen_update_loc_answer(uint64_t imsi, uint8_t* qci)
 {
-  std::map<uint64_t, std::unique_ptr<hss_ue_ctx_t> >::iterator ue_ctx_it = m_imsi_to_ue_ctx.find(imsi);
+  auto ue_ctx_it = m_imsi_to_ue_ctx.find(imsi);
   if (ue_ctx_it == m_imsi_to_ue_ctx.end()) {
     m_logger.info("User not found. IMSI: %015" PRIu64 "", imsi);
     srsran::console("User not found at HSS. IMSI: %015" PRIu64 "\n", imsi);
@@ -453,6 +570,7 @@ bool hss::resync_sqn(uint64_t imsi, uint8_t* auts)
     return false;
   }
 
+  std::lock_guard<std::mutex> lock(ue_ctx->mutex);
   switch (ue_ctx->algo) {
     case HSS_ALGO_XOR:
       resync_sqn_xor(ue_ctx, auts);
@@ -463,6 +581,13 @@ bool hss::resync_sqn(uint64_t imsi, uint8_t* auts)
   }
 
   increment_seq_after_resync(ue_ctx);
+  journal_sqn(ue_ctx);
+
+  // Cached vectors were generated with the old SQN
+  ue_ctx->auth_vectors.clear();
+  if (ue_ctx->algo == HSS_ALGO_MILENAGE) {
+    request_auth_vectors(ue_ctx);
+  }
   return true;
 }
 
@@ -531,6 +656,7 @@ void hss::increment_ue_sqn(hss_ue_ctx_t* ue_ctx)
   increment_sqn(ue_ctx->sqn, ue_ctx->sqn);
   m_logger.debug("Incremented SQN  -- IMSI: %015" PRIu64 "", ue_ctx->imsi);
   m_logger.debug(ue_ctx->sqn, 6, "SQN: ");
+  journal_sqn(ue_ctx);
 }
 
 void hss::increment_sqn(uint8_t* sqn, uint8_t* next_sqn)
@@ -593,6 +719,88 @@ void hss::increment_seq_after_resync(hss_ue_ctx_t* ue_ctx)
   return;
 }
 
+/* Authentication vector cache */
+void hss::request_auth_vectors(hss_ue_ctx_t* ue_ctx)
+{
+  // Called with the UE mutex held. Refill when the cache is half empty
+  if (auth_vector_cache == 0 || ue_ctx->algo != HSS_ALGO_MILENAGE || ue_ctx->refill_pending ||
+      ue_ctx->auth_vectors.size() > auth_vector_cache / 2) {
+    return;
+  }
+  ue_ctx->refill_pending = true;
+  {
+    std::lock_guard<std::mutex> lock(auth_vector_mutex);
+    auth_vector_requests.push_back(ue_ctx);
+  }
+  auth_vector_cvar.notify_one();
+}
+
+void hss::run_thread()
+{
+  // Subscribers refilled together, their vectors are generated in a single batch
+  const uint32_t             max_ues_per_batch = 16;
+  std::vector<hss_ue_ctx_t*> ue_ctxs;
+  ue_ctxs.reserve(max_ues_per_batch);
+
+  while (true) {
+    {
+      std::unique_lock<std::mutex> lock(auth_vector_mutex);
+      while (auth_vector_running && auth_vector_requests.empty()) {
+        auth_vector_cvar.wait(lock);
+      }
+      if (not auth_vector_running) {
+        break;
+      }
+      ue_ctxs.clear();
+      while (ue_ctxs.size() < max_ues_per_batch && not auth_vector_requests.empty()) {
+        ue_ctxs.push_back(auth_vector_requests.front());
+        auth_vector_requests.pop_front();
+      }
+    }
+    refill_auth_vectors(ue_ctxs);
+  }
+  m_logger.info("HSS thread stopped");
+}
+
+void hss::refill_auth_vectors(const std::vector<hss_ue_ctx_t*>& ue_ctxs)
+{
+  std::vector<hss_ue_ctx_t*>     vector_ue;
+  std::vector<hss_auth_vector_t> vectors;
+
+  // Only this thread holds more than one UE mutex at a time
+  for (hss_ue_ctx_t* ue_ctx : ue_ctxs) {
+    ue_ctx->mutex.lock();
+    for (uint32_t n = ue_ctx->auth_vectors.size(); n < auth_vector_cache; n++) {
+      vector_ue.push_back(ue_ctx);
+    }
+  }
+
+  vectors.resize(vector_ue.size());
+  gen_auth_vectors_milenage(vector_ue.data(), vector_ue.size(), vectors.data());
+
+  for (uint32_t n = 0; n < vectors.size(); n++) {
+    vector_ue[n]->auth_vectors.push_back(vectors[n]);
+  }
+  for (hss_ue_ctx_t* ue_ctx : ue_ctxs) {
+    ue_ctx->refill_pending = false;
+    ue_ctx->mutex.unlock();
+  }
+  m_logger.debug("Generated %zd AUTH vectors for %zd UEs", vectors.size(), ue_ctxs.size());
+}
+
+void hss::stop_auth_vector_thread()
+{
+  {
+    std::lock_guard<std::mutex> lock(auth_vector_mutex);
+    if (not auth_vector_running) {
+      return;
+    }
+    auth_vector_running = false;
+  }
+  auth_vector_cvar.notify_one();
+  wait_thread_finish();
+}
+
 void hss::gen_rand(uint8_t rand_[16])
 {
   for (int i = 0; i < 16; i++) {
@@ -603,7 +811,7 @@ void hss::gen_rand(uint8_t rand_[16])
 
 hss_ue_ctx_t* hss::get_ue_ctx(uint64_t imsi)
 {
-  std::map<uint64_t, std::unique_ptr<hss_ue_ctx_t> >::iterator ue_ctx_it = m_imsi_to_ue_ctx.find(imsi);
+  auto ue_ctx_it = m_imsi_to_ue_ctx.find(imsi);
   if (ue_ctx_it == m_imsi_to_ue_ctx.end()) {
     m_logger.info("User not found. IMSI: %015" PRIu64 "", imsi);
     return nullptr;
@@ -612,28 +820,137 @@ hss_ue_ctx_t* hss::get_ue_ctx(uint64_t imsi)
   return ue_ctx_it->second.get();
 }
 
-/* Helper functions*/
-std::vector<std::string> hss::split_string(const std::string& str, char delimiter)
+/* SQN journal */
+namespace {
+
+// One fixed-size record per SQN update. Records are written with a single write() to a file opened with O_APPEND, so
+// they never interleave, and the checksum discards a record torn by a crash.
+struct hss_sqn_record_t {
+  uint64_t imsi;
+  uint8_t  sqn[6];
+  uint8_t  reserved;
+  uint8_t  checksum;
+};
+static_assert(sizeof(hss_sqn_record_t) == 16, "Unexpected SQN journal record size");
+
+uint8_t sqn_record_checksum(const hss_sqn_record_t& record)
+{
+  const uint8_t* bytes = (const uint8_t*)&record;
+  uint8_t        sum   = 0x5a;
+  for (uint32_t i = 0; i < offsetof(hss_sqn_record_t, checksum); i++) {
+    sum = (uint8_t)((sum << 1) | (sum >> 7)) ^ bytes[i];
+  }
+  return sum;
+}
+
+} // namespace
+
+uint32_t hss::replay_sqn_journal(const std::string& journal_file)
+{
+  int fd = open(journal_file.c_str(), O_RDONLY);
+  if (fd < 0) {
+    return 0;
+  }
+  struct stat st = {};
+  if (fstat(fd, &st) < 0 || st.st_size < (off_t)sizeof(hss_sqn_record_t)) {
+    close(fd);
+    return 0;
+  }
+  void* data = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (data == MAP_FAILED) {
+    m_logger.error("Error mapping SQN journal %s: %s", journal_file.c_str(), strerror(errno));
+    return 0;
+  }
+
+  // A trailing partial record is the result of an interrupted write and is ignored
+  const hss_sqn_record_t* records     = (const hss_sqn_record_t*)data;
+  uint32_t                nof_records = st.st_size / sizeof(hss_sqn_record_t);
+  uint32_t                nof_applied = 0;
+  for (uint32_t i = 0; i < nof_records; i++) {
+    if (records[i].checksum != sqn_record_checksum(records[i])) {
+      m_logger.warning("Skipping corrupted SQN journal record %d", i);
+      continue;
+    }
+    auto ue_ctx_it = m_imsi_to_ue_ctx.find(records[i].imsi);
+    if (ue_ctx_it == m_imsi_to_ue_ctx.end()) {
+      m_logger.warning("Skipping SQN journal record of unknown IMSI: %015" PRIu64 "", records[i].imsi);
+      continue;
+    }
+    memcpy(ue_ctx_it->second->sqn, records[i].sqn, 6);
+    nof_applied++;
+  }
+
+  munmap(data, st.st_size);
+  return nof_applied;
+}
+
+bool hss::open_sqn_journal(const std::string& journal_file, bool truncate)
 {
-  std::vector<std::string> tokens;
-  std::string              token;
-  std::istringstream       tokenStream(str);
+  sqn_journal_fd = open(journal_file.c_str(), O_WRONLY | O_CREAT | O_APPEND | (truncate ? O_TRUNC : 0), 0644);
+  if (sqn_journal_fd < 0) {
+    m_logger.error("Error opening SQN journal %s: %s", journal_file.c_str(), strerror(errno));
+    return false;
+  }
+  m_logger.info("Opened SQN journal: %s", journal_file.c_str());
+  return true;
+}
 
-  while (std::getline(tokenStream, token, delimiter)) {
-    tokens.push_back(token);
+void hss::journal_sqn(const hss_ue_ctx_t* ue_ctx)
+{
+  if (sqn_journal_fd < 0) {
+    return;
+  }
+  hss_sqn_record_t record = {};
+  record.imsi             = ue_ctx->imsi;
+  memcpy(record.sqn, ue_ctx->sqn, 6);
+  record.checksum = sqn_record_checksum(record);
+  if (write(sqn_journal_fd, &record, sizeof(record)) != (ssize_t)sizeof(record)) {
+    m_logger.error("Error writing SQN journal. IMSI: %015" PRIu64 "", ue_ctx->imsi);
   }
-  return tokens;
 }
 
-void hss::get_uint_vec_from_hex_str(const std::string& key_str, uint8_t* key, uint len)
+/* Helper functions*/
+uint32_t hss::split_line(const char* line, const char* end, char delimiter, db_field_t* fields, uint32_t max_fields)
 {
-  const char* pos = key_str.c_str();
+  uint32_t nof_fields = 0;
+  while (nof_fields < max_fields) {
+    const char* next = (const char*)memchr(line, delimiter, end - line);
+    if (next == nullptr) {
+      next = end;
+    }
+    fields[nof_fields].str = line;
+    fields[nof_fields].len = next - line;
+    nof_fields++;
+    if (next == end) {
+      break;
+    }
+    line = next + 1;
+  }
+  return nof_fields;
+}
+
+static uint8_t hex_nibble(char c)
+{
+  if (c >= '0' && c <= '9') {
+    return c - '0';
+  }
+  if (c >= 'a' && c <= 'f') {
+    return c - 'a' + 10;
+  }
+  if (c >= 'A' && c <= 'F') {
+    return c - 'A' + 10;
+  }
+  return 0;
+}
 
+void hss::get_uint_vec_from_hex_str(const db_field_t& key_str, uint8_t* key, uint len)
+{
   for (uint count = 0; count < len; count++) {
-    sscanf(pos, "%2hhx", &key[count]);
-    pos += 2;
+    uint8_t hi = (2 * count < key_str.len) ? hex_nibble(key_str.str[2 * count]) : 0;
+    uint8_t lo = (2 * count + 1 < key_str.len) ? hex_nibble(key_str.str[2 * count + 1]) : 0;
+    key[count] = (hi << 4) | lo;
   }
-  return;
 }
 
 std::string hss::hex_string(uint8_t* hex, int size)
@@ -20,18 +20,21 @@
  */
 
 #include "srsepc/hdr/mme/mme.h"
+#include "srsran/common/int_helpers.h"
 #include <arpa/inet.h>
 #include <inttypes.h> // for printing uint64_t
 #include <netinet/sctp.h>
 #include <sys/socket.h>
+#include <sys/timerfd.h>
 #include <sys/types.h>
+#include <time.h>
 
 namespace srsepc {
 
 mme*            mme::m_instance    = NULL;
 pthread_mutex_t mme_instance_mutex = PTHREAD_MUTEX_INITIALIZER;
 
-mme::mme() : m_running(false), thread("MME")
+mme::mme() : m_running(false), m_epoll_fd(-1), m_timer_fd(-1), thread("MME")
 {
   return;
 }
@@ -67,49 +70,74 @@ int mme::init(mme_args_t* args)
   m_s1ap = s1ap::get_instance();
   if (m_s1ap->init(args->s1ap_args)) {
     m_s1ap_logger.error("Error initializing MME S1APP");
-    exit(-1);
+    return SRSRAN_ERROR;
   }
 
   /*Init GTP-C*/
   m_mme_gtpc = mme_gtpc::get_instance();
   if (!m_mme_gtpc->init()) {
     srsran::console("Error initializing GTP-C\n");
-    exit(-1);
+    m_s1ap->stop();
+    m_s1ap->cleanup();
+    return SRSRAN_ERROR;
+  }
+
+  /*Init event loop. S1-MME, S11 and the NAS timer fd are polled with epoll*/
+  m_epoll_fd = epoll_create1(0);
+  m_timer_fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK);
+  if (m_epoll_fd < 0 || m_timer_fd < 0 || add_epoll(m_s1ap->get_s1_mme(), m_epoll_fd) != SRSRAN_SUCCESS ||
+      add_epoll(m_mme_gtpc->get_s11(), m_epoll_fd) != SRSRAN_SUCCESS ||
+      add_epoll(m_timer_fd, m_epoll_fd) != SRSRAN_SUCCESS) {
+    srsran::console("Error initializing MME event loop\n");
+    if (m_timer_fd >= 0) {
+      close(m_timer_fd);
+    }
+    if (m_epoll_fd >= 0) {
+      close(m_epoll_fd);
+    }
+    m_s1ap->stop();
+    m_s1ap->cleanup();
+    return SRSRAN_ERROR;
+  }
+
+  /*Init workers*/
+  m_s1ap->set_nof_workers(args->nof_workers);
+  for (uint32_t i = 0; i < args->nof_workers; ++i) {
+    m_workers.emplace_back(new srsran::task_thread_pool(1));
+    m_workers.back()->push_task([i]() { s1ap::set_worker_idx(i); });
   }
 
   /*Log successful initialization*/
-  m_s1ap_logger.info("MME Initialized. MCC: 0x%x, MNC: 0x%x", args->s1ap_args.mcc, args->s1ap_args.mnc);
+  m_s1ap_logger.info("MME Initialized. MCC: 0x%x, MNC: 0x%x, Workers: %d",
+                     args->s1ap_args.mcc,
+                     args->s1ap_args.mnc,
+                     args->nof_workers);
   srsran::console("MME Initialized. MCC: 0x%x, MNC: 0x%x\n", args->s1ap_args.mcc, args->s1ap_args.mnc);
-  return 0;
+  return SRSRAN_SUCCESS;
 }
 
 void mme::stop()
 {
   if (m_running) {
-    m_s1ap->stop();
-    m_s1ap->cleanup();
     m_running = false;
     thread_cancel();
     wait_thread_finish();
+    for (auto& worker : m_workers) {
+      worker->stop();
+    }
+    m_workers.clear();
+    m_s1ap->stop();
+    m_s1ap->cleanup();
+    close(m_timer_fd);
+    close(m_epoll_fd);
   }
   return;
 }
 
 void mme::run_thread()
 {
-  srsran::unique_byte_buffer_t pdu = srsran::make_byte_buffer("mme::run_thread");
-  if (pdu == nullptr) {
-    m_s1ap_logger.error("Couldn't allocate PDU in %s().", __FUNCTION__);
-    return;
-  }
-  uint32_t                     sz  = SRSRAN_MAX_BUFFER_SIZE_BYTES - SRSRAN_BUFFER_HEADER_OFFSET;
-
-  struct sockaddr_in     enb_addr;
-  struct sctp_sndrcvinfo sri;
-  socklen_t              fromlen = sizeof(enb_addr);
-  bzero(&enb_addr, sizeof(enb_addr));
-  int rd_sz;
-  int msg_flags = 0;
+  const uint32_t     max_events = 32;
+  struct epoll_event events[max_events];
 
   // Mark the thread as running
   m_running = true;
@@ -119,120 +147,336 @@ void mme::run_thread()
   int s11   = m_mme_gtpc->get_s11();
 
   while (m_running) {
-    pdu->clear();
-    int max_fd = std::max(s1mme, s11);
-
-    FD_ZERO(&m_set);
-    FD_SET(s1mme, &m_set);
-    FD_SET(s11, &m_set);
-
-    // Add timers to select
-    for (std::vector<mme_timer_t>::iterator it = timers.begin(); it != timers.end(); ++it) {
-      FD_SET(it->fd, &m_set);
-      max_fd = std::max(max_fd, it->fd);
-      m_s1ap_logger.debug("Adding Timer fd %d to fd_set", it->fd);
-    }
-
     m_s1ap_logger.debug("Waiting for S1-MME or S11 Message");
-    int n = select(max_fd + 1, &m_set, NULL, NULL, NULL);
+    int n = epoll_wait(m_epoll_fd, events, max_events, -1);
     if (n == -1) {
-      m_s1ap_logger.error("Error from select");
-    } else if (n) {
-      // Handle S1-MME
-      if (FD_ISSET(s1mme, &m_set)) {
-        rd_sz = sctp_recvmsg(s1mme, pdu->msg, sz, (struct sockaddr*)&enb_addr, &fromlen, &sri, &msg_flags);
-        if (rd_sz == -1 && errno != EAGAIN) {
-          m_s1ap_logger.error("Error reading from SCTP socket: %s", strerror(errno));
-        } else if (rd_sz == -1 && errno == EAGAIN) {
-          m_s1ap_logger.debug("Socket timeout reached");
-        } else {
-          if (msg_flags & MSG_NOTIFICATION) {
-            // Received notification
-            union sctp_notification* notification = (union sctp_notification*)pdu->msg;
-            m_s1ap_logger.debug("SCTP Notification %d", notification->sn_header.sn_type);
-            if (notification->sn_header.sn_type == SCTP_SHUTDOWN_EVENT) {
-              m_s1ap_logger.info("SCTP Association Shutdown. Association: %d", sri.sinfo_assoc_id);
-              srsran::console("SCTP Association Shutdown. Association: %d\n", sri.sinfo_assoc_id);
-              m_s1ap->delete_enb_ctx(sri.sinfo_assoc_id);
+      if (errno != EINTR) {
+        m_s1ap_logger.error("Error from epoll_wait: %s", strerror(errno));
+      }
+      continue;
+    }
+    for (int i = 0; i < n; ++i) {
+      int fd = events[i].data.fd;
+      if (fd == s1mme) {
+        handle_s1mme_rx(s1mme);
+      } else if (fd == s11) {
+        handle_s11_rx(s11);
+      } else if (fd == m_timer_fd) {
+        handle_timer_fd();
+      }
+    }
+  }
+  return;
+}
+
+void mme::handle_s1mme_rx(int s1mme)
+{
+  srsran::unique_byte_buffer_t pdu = srsran::make_byte_buffer("mme::handle_s1mme_rx");
+  if (pdu == nullptr) {
+    m_s1ap_logger.error("Couldn't allocate PDU in %s().", __FUNCTION__);
+    return;
+  }
+  uint32_t sz = SRSRAN_MAX_BUFFER_SIZE_BYTES - SRSRAN_BUFFER_HEADER_OFFSET;
+
+  struct sockaddr_in     enb_addr  = {};
+  struct sctp_sndrcvinfo sri       = {};
+  socklen_t              fromlen   = sizeof(enb_addr);
+  int                    msg_flags = 0;
+
+  int rd_sz = sctp_recvmsg(s1mme, pdu->msg, sz, (struct sockaddr*)&enb_addr, &fromlen, &sri, &msg_flags);
+  if (rd_sz == -1 && errno != EAGAIN) {
+    m_s1ap_logger.error("Error reading from SCTP socket: %s", strerror(errno));
+  } else if (rd_sz == -1 && errno == EAGAIN) {
+    m_s1ap_logger.debug("Socket timeout reached");
+  } else {
+    if (msg_flags & MSG_NOTIFICATION) {
+      // Received notification
+      union sctp_notification* notification = (union sctp_notification*)pdu->msg;
+      m_s1ap_logger.debug("SCTP Notification %d", notification->sn_header.sn_type);
+      if (notification->sn_header.sn_type == SCTP_SHUTDOWN_EVENT) {
+        m_s1ap_logger.info("SCTP Association Shutdown. Association: %d", sri.sinfo_assoc_id);
+        srsran::console("SCTP Association Shutdown. Association: %d\n", sri.sinfo_assoc_id);
+        run_with_workers_paused([this, &sri]() { m_s1ap->delete_enb_ctx(sri.sinfo_assoc_id); });
+      }
+    } else {
+      // Received data
+      pdu->N_bytes = rd_sz;
+      m_s1ap_logger.info("Received S1AP msg. Size: %d", pdu->N_bytes);
+      if (m_workers.empty()) {
+        m_s1ap->handle_s1ap_rx_pdu(pdu.get(), &sri);
+      } else {
+        dispatch_s1ap_pdu(std::move(pdu), sri);
+      }
+    }
+  }
+}
+
+void mme::handle_s11_rx(int s11)
+{
+  srsran::unique_byte_buffer_t pdu = srsran::make_byte_buffer("mme::handle_s11_rx");
+  if (pdu == nullptr) {
+    m_s1ap_logger.error("Couldn't allocate PDU in %s().", __FUNCTION__);
+    return;
+  }
+  uint32_t sz = SRSRAN_MAX_BUFFER_SIZE_BYTES - SRSRAN_BUFFER_HEADER_OFFSET;
+
+  pdu->N_bytes = recvfrom(s11, pdu->msg, sz, 0, NULL, NULL);
+  if (m_workers.empty()) {
+    m_mme_gtpc->handle_s11_pdu(pdu.get());
+    return;
+  }
+
+  // S11 messages are processed by the worker of the UE they refer to
+  uint64_t imsi   = 0;
+  uint32_t worker = 0;
+  if (m_mme_gtpc->find_imsi_from_s11_pdu(pdu.get(), &imsi)) {
+    worker = get_ue_worker(imsi);
+  }
+  srsran::byte_buffer_t* pdu_ptr = pdu.release();
+  m_workers[worker]->push_task([this, pdu_ptr]() {
+    srsran::unique_byte_buffer_t s11_pdu(pdu_ptr);
+    m_mme_gtpc->handle_s11_pdu(s11_pdu.get());
+  });
+}
+
+/*
+ * Worker Handling
+ */
+void mme::dispatch_s1ap_pdu(srsran::unique_byte_buffer_t pdu, const struct sctp_sndrcvinfo& sri)
+{
+  // The PDU is decoded here to find the UE it refers to, and handed to its worker
+  s1ap_rx_task_t* rx_task = new s1ap_rx_task_t;
+  rx_task->pdu.reset(new s1ap_pdu_t);
+  rx_task->sri = sri;
+  if (!m_s1ap->unpack_s1ap_rx_pdu(pdu.get(), rx_task->pdu.get())) {
+    delete rx_task;
+    return;
+  }
+
+  uint32_t worker = 0;
+  if (!get_s1ap_pdu_worker(*rx_task->pdu, sri, &worker)) {
+    // Non UE-associated messages modify the eNB contexts shared by all workers
+    run_with_workers_paused([this, rx_task]() { m_s1ap->handle_s1ap_rx_pdu(*rx_task->pdu, &rx_task->sri); });
+    delete rx_task;
+    return;
+  }
+
+  m_workers[worker]->push_task([this, rx_task]() {
+    std::unique_ptr<s1ap_rx_task_t> task(rx_task);
+    m_s1ap->handle_s1ap_rx_pdu(*task->pdu, &task->sri);
+  });
+}
+
+bool mme::get_s1ap_pdu_worker(const s1ap_pdu_t& pdu, const struct sctp_sndrcvinfo& sri, uint32_t* worker)
+{
+  using init_msg_type_opts_t           = asn1::s1ap::s1ap_elem_procs_o::init_msg_c::types_opts;
+  using successful_outcome_type_opts_t = asn1::s1ap::s1ap_elem_procs_o::successful_outcome_c::types_opts;
+
+  uint32_t nof_workers    = m_workers.size();
+  uint32_t mme_ue_s1ap_id = 0;
+  switch (pdu.type().value) {
+    case s1ap_pdu_t::types_opts::init_msg: {
+      const asn1::s1ap::init_msg_s& msg = pdu.init_msg();
+      switch (msg.value.type().value) {
+        case init_msg_type_opts_t::init_ue_msg: {
+          const asn1::s1ap::init_ue_msg_s& init_ue = msg.value.init_ue_msg();
+          if (init_ue.protocol_ies.s_tmsi_present) {
+            // UEs known by their S-TMSI go to the worker that holds their context
+            uint32_t m_tmsi = 0;
+            srsran::uint8_to_uint32(init_ue.protocol_ies.s_tmsi.value.m_tmsi.data(), &m_tmsi);
+            uint64_t imsi = m_s1ap->find_imsi_from_m_tmsi(m_tmsi);
+            if (imsi != 0) {
+              *worker = get_ue_worker(imsi);
+              return true;
             }
-          } else {
-            // Received data
-            pdu->N_bytes = rd_sz;
-            m_s1ap_logger.info("Received S1AP msg. Size: %d", pdu->N_bytes);
-            m_s1ap->handle_s1ap_rx_pdu(pdu.get(), &sri);
           }
+          // New UEs are spread over the workers. The worker then allocates a MME-UE-S1AP-ID that maps back to it
+          uint32_t enb_ue_s1ap_id = init_ue.protocol_ies.enb_ue_s1ap_id.value.value;
+          *worker                 = ((uint32_t)sri.sinfo_assoc_id * 65599u + enb_ue_s1ap_id) % nof_workers;
+          return true;
         }
+        case init_msg_type_opts_t::ul_nas_transport:
+          mme_ue_s1ap_id = msg.value.ul_nas_transport().protocol_ies.mme_ue_s1ap_id.value.value;
+          break;
+        case init_msg_type_opts_t::ue_context_release_request:
+          mme_ue_s1ap_id = msg.value.ue_context_release_request().protocol_ies.mme_ue_s1ap_id.value.value;
+          break;
+        case init_msg_type_opts_t::ue_cap_info_ind:
+          mme_ue_s1ap_id = msg.value.ue_cap_info_ind().protocol_ies.mme_ue_s1ap_id.value.value;
+          break;
+        default:
+          return false;
       }
-      // Handle S11
-      if (FD_ISSET(s11, &m_set)) {
-        pdu->N_bytes = recvfrom(s11, pdu->msg, sz, 0, NULL, NULL);
-        m_mme_gtpc->handle_s11_pdu(pdu.get());
-      }
-      // Handle NAS Timers
-      for (std::vector<mme_timer_t>::iterator it = timers.begin(); it != timers.end();) {
-        if (FD_ISSET(it->fd, &m_set)) {
-          m_s1ap_logger.info("Timer expired");
-          uint64_t exp;
-          rd_sz = read(it->fd, &exp, sizeof(uint64_t));
-          m_s1ap->expire_nas_timer(it->type, it->imsi);
-          close(it->fd);
-          timers.erase(it);
-        } else {
-          ++it;
-        }
+      break;
+    }
+    case s1ap_pdu_t::types_opts::successful_outcome: {
+      const asn1::s1ap::successful_outcome_s& msg = pdu.successful_outcome();
+      switch (msg.value.type().value) {
+        case successful_outcome_type_opts_t::init_context_setup_resp:
+          mme_ue_s1ap_id = msg.value.init_context_setup_resp().protocol_ies.mme_ue_s1ap_id.value.value;
+          break;
+        case successful_outcome_type_opts_t::ue_context_release_complete:
+          mme_ue_s1ap_id = msg.value.ue_context_release_complete().protocol_ies.mme_ue_s1ap_id.value.value;
+          break;
+        default:
+          return false;
       }
-    } else {
-      m_s1ap_logger.debug("No data from select.");
+      break;
     }
+    default:
+      return false;
   }
-  return;
+  *worker = mme_ue_s1ap_id % nof_workers;
+  return true;
+}
+
+uint32_t mme::get_ue_worker(uint64_t imsi)
+{
+  // Connected UEs are served by the worker given by their MME-UE-S1AP-ID, idle UEs by their IMSI
+  uint32_t mme_ue_s1ap_id = m_s1ap->find_mme_ue_s1ap_id_from_imsi(imsi);
+  if (mme_ue_s1ap_id != 0) {
+    return mme_ue_s1ap_id % m_workers.size();
+  }
+  return imsi % m_workers.size();
+}
+
+void mme::run_with_workers_paused(const std::function<void()>& task)
+{
+  if (m_workers.empty()) {
+    task();
+    return;
+  }
+
+  // Each worker finishes its pending tasks and blocks until the task has been run
+  std::unique_lock<std::mutex> lock(m_pause_mutex);
+  m_resume_workers = false;
+  for (auto& worker : m_workers) {
+    worker->push_task([this]() {
+      std::unique_lock<std::mutex> worker_lock(m_pause_mutex);
+      m_nof_paused_workers++;
+      m_pause_cvar.notify_all();
+      m_pause_cvar.wait(worker_lock, [this]() { return m_resume_workers; });
+      m_nof_paused_workers--;
+      m_pause_cvar.notify_all();
+    });
+  }
+  m_pause_cvar.wait(lock, [this]() { return m_nof_paused_workers == m_workers.size(); });
+
+  task();
+
+  m_resume_workers = true;
+  m_pause_cvar.notify_all();
+  m_pause_cvar.wait(lock, [this]() { return m_nof_paused_workers == 0; });
 }
 
 /*
  * Timer Handling
  */
-bool mme::add_nas_timer(int timer_fd, nas_timer_type type, uint64_t imsi)
+static uint64_t nas_timer_key(nas_timer_type type, uint64_t imsi)
 {
-  m_s1ap_logger.debug("Adding NAS timer to MME. IMSI %" PRIu64 ", Type %d, Fd: %d", imsi, type, timer_fd);
+  return (imsi << 8u) | (uint64_t)type;
+}
 
-  mme_timer_t timer;
-  timer.fd   = timer_fd;
-  timer.type = type;
-  timer.imsi = imsi;
+static uint64_t monotonic_ms()
+{
+  struct timespec ts = {};
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000u + (uint64_t)ts.tv_nsec / 1000000u;
+}
 
-  timers.push_back(timer);
-  return true;
+void mme::arm_timer_fd(uint64_t deadline_ms)
+{
+  // One-shot, at an absolute time. A deadline that already passed fires at once
+  struct itimerspec ts = {};
+  ts.it_value.tv_sec   = deadline_ms / 1000u;
+  ts.it_value.tv_nsec  = (deadline_ms % 1000u) * 1000000u;
+  if (timerfd_settime(m_timer_fd, TFD_TIMER_ABSTIME, &ts, NULL) < 0) {
+    m_s1ap_logger.error("Error arming NAS timer fd: %s", strerror(errno));
+  }
 }
 
-bool mme::is_nas_timer_running(nas_timer_type type, uint64_t imsi)
+void mme::handle_timer_fd()
 {
-  std::vector<mme_timer_t>::iterator it;
-  for (it = timers.begin(); it != timers.end(); ++it) {
-    if (it->type == type && it->imsi == imsi) {
-      return true; // found timer
+  // Re-arming the fd from a worker resets its count, so the read may find nothing. The deadlines decide what expired
+  uint64_t exp = 0;
+  if (read(m_timer_fd, &exp, sizeof(exp)) < 0 && errno != EAGAIN) {
+    m_s1ap_logger.error("Error reading NAS timer fd: %s", strerror(errno));
+  }
+
+  // Expired timers are handled out of the lock, as the handlers may add new timers
+  std::vector<std::pair<enum nas_timer_type, uint64_t> > expired;
+  {
+    std::lock_guard<std::mutex> lock(m_timers_mutex);
+    uint64_t                    now = monotonic_ms();
+    while (not m_nas_timer_deadlines.empty() and m_nas_timer_deadlines.begin()->first <= now) {
+      uint64_t key = m_nas_timer_deadlines.begin()->second;
+      m_nas_timer_deadlines.erase(m_nas_timer_deadlines.begin());
+      m_nas_timers.erase(key);
+      expired.emplace_back((enum nas_timer_type)(key & 0xffu), key >> 8u);
     }
+    if (not m_nas_timer_deadlines.empty()) {
+      arm_timer_fd(m_nas_timer_deadlines.begin()->first);
+    }
+  }
+  for (const auto& timer : expired) {
+    handle_timer_expire(timer.first, timer.second);
   }
-  return false;
 }
 
-bool mme::remove_nas_timer(nas_timer_type type, uint64_t imsi)
+void mme::handle_timer_expire(enum nas_timer_type type, uint64_t imsi)
 {
-  std::vector<mme_timer_t>::iterator it;
-  for (it = timers.begin(); it != timers.end(); ++it) {
-    if (it->type == type && it->imsi == imsi) {
-      break; // found timer to remove
-    }
+  m_s1ap_logger.info("Timer expired. IMSI %" PRIu64 ", Type %d", imsi, type);
+  if (m_workers.empty()) {
+    m_s1ap->expire_nas_timer(type, imsi);
+    return;
   }
-  if (it == timers.end()) {
+  m_workers[get_ue_worker(imsi)]->push_task([this, type, imsi]() { m_s1ap->expire_nas_timer(type, imsi); });
+}
+
+bool mme::add_nas_timer(uint32_t timeout_ms, nas_timer_type type, uint64_t imsi)
+{
+  m_s1ap_logger.debug("Adding NAS timer to MME. IMSI %" PRIu64 ", Type %d, Timeout: %d ms", imsi, type, timeout_ms);
+
+  std::lock_guard<std::mutex> lock(m_timers_mutex);
+  uint64_t                    key      = nas_timer_key(type, imsi);
+  uint64_t                    deadline = monotonic_ms() + timeout_ms;
+  auto                        it       = m_nas_timers.find(key);
+  if (it != m_nas_timers.end()) {
+    // Restarting a running timer
+    m_nas_timer_deadlines.erase(std::make_pair(it->second, key));
+    it->second = deadline;
+  } else {
+    m_nas_timers.insert(std::make_pair(key, deadline));
+  }
+  m_nas_timer_deadlines.insert(std::make_pair(deadline, key));
+
+  // Only a new earliest deadline needs to wake up the event loop sooner
+  if (m_nas_timer_deadlines.begin()->second == key) {
+    arm_timer_fd(deadline);
+  }
+  return true;
+}
+
+bool mme::is_nas_timer_running(nas_timer_type type, uint64_t imsi)
+{
+  std::lock_guard<std::mutex> lock(m_timers_mutex);
+  return m_nas_timers.count(nas_timer_key(type, imsi)) > 0;
+}
+
+bool mme::remove_nas_timer(nas_timer_type type, uint64_t imsi)
+{
+  std::lock_guard<std::mutex> lock(m_timers_mutex);
+  uint64_t                    key = nas_timer_key(type, imsi);
+  auto                        it  = m_nas_timers.find(key);
+  if (it == m_nas_timers.end()) {
     m_s1ap_logger.warning("Could not find timer to remove. IMSI %" PRIu64 ", Type %d", imsi, type);
     return false;
   }
 
-  // removing timer
-  m_s1ap_logger.debug("Removing NAS timer from MME. IMSI %" PRIu64 ", Type %d, Fd: %d", imsi, type, it->fd);
-  FD_CLR(it->fd, &m_set);
-  close(it->fd);
-  timers.erase(it);
+  // removing timer. If it was the earliest one, the event loop wakes up once for nothing and re-arms the fd
+  m_s1ap_logger.debug("Removing NAS timer from MME. IMSI %" PRIu64 ", Type %d", imsi, type);
+  m_nas_timer_deadlines.erase(std::make_pair(it->second, key));
+  m_nas_timers.erase(it);
   return true;
 }
 
@@ -0,0 +1,231 @@
+/**
+ * Copyright 2013-2021 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "srsepc/hdr/mme/mme_ue_registry.h"
+#include "srsran/adt/pool/mem_pool.h"
+
+namespace srsepc {
+
+// NAS contexts are recycled through a pool, as UEs come and go at a high rate. They are created by all the MME workers
+static srsran::big_obj_pool<nas, true>* get_nas_ctx_pool()
+{
+  static srsran::big_obj_pool<nas, true> pool;
+  return &pool;
+}
+
+void* nas::operator new(size_t sz)
+{
+  return get_nas_ctx_pool()->allocate_node(sz);
+}
+
+void nas::operator delete(void* p)
+{
+  get_nas_ctx_pool()->deallocate_node(p);
+}
+
+void mme_ue_registry::reserve(uint32_t nof_ues)
+{
+  m_imsi_to_nas_ctx.reserve(nof_ues);
+  m_mme_ue_s1ap_id_to_nas_ctx.reserve(nof_ues);
+  m_mme_ue_s1ap_id_to_imsi.reserve(nof_ues);
+  m_imsi_to_mme_ue_s1ap_id.reserve(nof_ues);
+  m_tmsi_to_imsi.reserve(nof_ues);
+  m_imsi_to_tmsi.reserve(nof_ues);
+}
+
+void mme_ue_registry::clear()
+{
+  for (auto& enb : m_enb_assoc_to_ues) {
+    for (nas& ue : enb.second) {
+      ue.m_enb_list_assoc = -1;
+    }
+  }
+  m_enb_assoc_to_ues.clear();
+  m_imsi_to_nas_ctx.clear();
+  m_mme_ue_s1ap_id_to_nas_ctx.clear();
+  m_mme_ue_s1ap_id_to_imsi.clear();
+  m_imsi_to_mme_ue_s1ap_id.clear();
+  m_tmsi_to_imsi.clear();
+  m_imsi_to_tmsi.clear();
+}
+
+bool mme_ue_registry::add_imsi(nas* nas_ctx)
+{
+  return m_imsi_to_nas_ctx.insert(std::make_pair(nas_ctx->m_emm_ctx.imsi, nas_ctx)).second;
+}
+
+nas* mme_ue_registry::find_imsi(uint64_t imsi) const
+{
+  auto it = m_imsi_to_nas_ctx.find(imsi);
+  return it != m_imsi_to_nas_ctx.end() ? it->second : nullptr;
+}
+
+nas* mme_ue_registry::remove_imsi(uint64_t imsi)
+{
+  auto it = m_imsi_to_nas_ctx.find(imsi);
+  if (it == m_imsi_to_nas_ctx.end()) {
+    return nullptr;
+  }
+  nas* nas_ctx = it->second;
+  m_imsi_to_nas_ctx.erase(it);
+  return nas_ctx;
+}
+
+void mme_ue_registry::for_each_ue(const std::function<void(nas*)>& func)
+{
+  for (auto& ue : m_imsi_to_nas_ctx) {
+    func(ue.second);
+  }
+}
+
+bool mme_ue_registry::add_mme_ue_s1ap_id(nas* nas_ctx)
+{
+  uint32_t mme_ue_s1ap_id = nas_ctx->m_ecm_ctx.mme_ue_s1ap_id;
+  uint64_t imsi           = nas_ctx->m_emm_ctx.imsi;
+  if (not m_mme_ue_s1ap_id_to_nas_ctx.insert(std::make_pair(mme_ue_s1ap_id, nas_ctx)).second) {
+    return false;
+  }
+  // The IMSI is kept with the ID, as the context may have changed it by the time the ID is removed
+  m_mme_ue_s1ap_id_to_imsi[mme_ue_s1ap_id] = imsi;
+  m_imsi_to_mme_ue_s1ap_id[imsi]           = mme_ue_s1ap_id;
+  return true;
+}
+
+nas* mme_ue_registry::find_mme_ue_s1ap_id(uint32_t mme_ue_s1ap_id) const
+{
+  auto it = m_mme_ue_s1ap_id_to_nas_ctx.find(mme_ue_s1ap_id);
+  return it != m_mme_ue_s1ap_id_to_nas_ctx.end() ? it->second : nullptr;
+}
+
+bool mme_ue_registry::remove_mme_ue_s1ap_id(uint32_t mme_ue_s1ap_id)
+{
+  if (m_mme_ue_s1ap_id_to_nas_ctx.erase(mme_ue_s1ap_id) == 0) {
+    return false;
+  }
+  erase_mme_ue_s1ap_id(mme_ue_s1ap_id);
+  return true;
+}
+
+uint32_t mme_ue_registry::find_imsi_mme_ue_s1ap_id(uint64_t imsi) const
+{
+  auto it = m_imsi_to_mme_ue_s1ap_id.find(imsi);
+  return it != m_imsi_to_mme_ue_s1ap_id.end() ? it->second : 0;
+}
+
+void mme_ue_registry::erase_mme_ue_s1ap_id(uint32_t mme_ue_s1ap_id)
+{
+  auto it = m_mme_ue_s1ap_id_to_imsi.find(mme_ue_s1ap_id);
+  if (it == m_mme_ue_s1ap_id_to_imsi.end()) {
+    return;
+  }
+  // The IMSI may already have a newer ID
+  auto imsi_it = m_imsi_to_mme_ue_s1ap_id.find(it->second);
+  if (imsi_it != m_imsi_to_mme_ue_s1ap_id.end() and imsi_it->second == mme_ue_s1ap_id) {
+    m_imsi_to_mme_ue_s1ap_id.erase(imsi_it);
+  }
+  m_mme_ue_s1ap_id_to_imsi.erase(it);
+}
+
+void mme_ue_registry::add_m_tmsi(uint32_t m_tmsi, uint64_t imsi)
+{
+  // The previous M-TMSI of the UE is no longer valid
+  auto it = m_imsi_to_tmsi.find(imsi);
+  if (it != m_imsi_to_tmsi.end()) {
+    m_tmsi_to_imsi.erase(it->second);
+    it->second = m_tmsi;
+  } else {
+    m_imsi_to_tmsi.insert(std::make_pair(imsi, m_tmsi));
+  }
+  m_tmsi_to_imsi[m_tmsi] = imsi;
+}
+
+uint64_t mme_ue_registry::find_m_tmsi(uint32_t m_tmsi) const
+{
+  auto it = m_tmsi_to_imsi.find(m_tmsi);
+  return it != m_tmsi_to_imsi.end() ? it->second : 0;
+}
+
+void mme_ue_registry::add_enb(int32_t enb_assoc)
+{
+  m_enb_assoc_to_ues[enb_assoc];
+}
+
+void mme_ue_registry::remove_enb(int32_t enb_assoc)
+{
+  auto it = m_enb_assoc_to_ues.find(enb_assoc);
+  if (it == m_enb_assoc_to_ues.end()) {
+    return;
+  }
+  for (nas& ue : it->second) {
+    ue.m_enb_list_assoc = -1;
+  }
+  m_enb_assoc_to_ues.erase(it);
+}
+
+bool mme_ue_registry::add_ue_to_enb(int32_t enb_assoc, nas* nas_ctx)
+{
+  auto it = m_enb_assoc_to_ues.find(enb_assoc);
+  if (it == m_enb_assoc_to_ues.end()) {
+    return false;
+  }
+  if (nas_ctx->m_enb_list_assoc == enb_assoc) {
+    return false;
+  }
+  // A UE is connected through a single eNB
+  remove_ue_from_enb(nas_ctx);
+  it->second.push_front(nas_ctx);
+  nas_ctx->m_enb_list_assoc = enb_assoc;
+  return true;
+}
+
+void mme_ue_registry::remove_ue_from_enb(nas* nas_ctx)
+{
+  if (nas_ctx->m_enb_list_assoc < 0) {
+    return;
+  }
+  auto it = m_enb_assoc_to_ues.find(nas_ctx->m_enb_list_assoc);
+  if (it != m_enb_assoc_to_ues.end()) {
+    it->second.pop(nas_ctx);
+  }
+  nas_ctx->m_enb_list_assoc = -1;
+}
+
+uint32_t mme_ue_registry::release_enb_ues(int32_t enb_assoc, const std::function<void(nas*)>& func)
+{
+  auto it = m_enb_assoc_to_ues.find(enb_assoc);
+  if (it == m_enb_assoc_to_ues.end()) {
+    return 0;
+  }
+  uint32_t nof_ues = 0;
+  while (not it->second.empty()) {
+    nas* nas_ctx = &it->second.front();
+    it->second.pop_front();
+    nas_ctx->m_enb_list_assoc = -1;
+    if (m_mme_ue_s1ap_id_to_nas_ctx.erase(nas_ctx->m_ecm_ctx.mme_ue_s1ap_id) > 0) {
+      erase_mme_ue_s1ap_id(nas_ctx->m_ecm_ctx.mme_ue_s1ap_id);
+    }
+    func(nas_ctx);
+    nof_ues++;
+  }
+  return nof_ues;
+}
+
+} // namespace srsepc
@@ -26,7 +26,6 @@
 #include <cmath>
 #include <inttypes.h> // for printing uint64_t
 #include <netinet/sctp.h>
-#include <sys/timerfd.h>
 #include <time.h>
 
 namespace srsepc {
@@ -1971,24 +1970,7 @@ bool nas::start_t3413()
     return false;
   }
 
-  int fdt = timerfd_create(CLOCK_MONOTONIC, 0);
-  if (fdt < 0) {
-    m_logger.error("Error creating timer. %s", strerror(errno));
-    return false;
-  }
-  struct itimerspec t_value;
-  t_value.it_value.tv_sec     = m_t3413;
-  t_value.it_value.tv_nsec    = 0;
-  t_value.it_interval.tv_sec  = 0;
-  t_value.it_interval.tv_nsec = 0;
-
-  if (timerfd_settime(fdt, 0, &t_value, NULL) == -1) {
-    m_logger.error("Could not set timer");
-    close(fdt);
-    return false;
-  }
-
-  m_mme->add_nas_timer(fdt, T_3413, m_emm_ctx.imsi); // TODO timers without IMSI?
+  m_mme->add_nas_timer(m_t3413 * 1000, T_3413, m_emm_ctx.imsi); // TODO timers without IMSI?
   return true;
 }
 
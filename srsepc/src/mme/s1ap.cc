@@ -31,6 +31,12 @@ namespace srsepc {
 s1ap*           s1ap::m_instance    = NULL;
 pthread_mutex_t s1ap_instance_mutex = PTHREAD_MUTEX_INITIALIZER;
 
+/// Size of the arena used to unpack the received S1AP PDUs, allocations beyond it fall back to the heap
+static const size_t s1ap_rx_arena_size = 4096;
+
+/// Index of the MME worker running in this thread
+static thread_local uint32_t worker_idx = 0;
+
 s1ap::s1ap() : m_s1mme(-1), m_next_mme_ue_s1ap_id(1), m_mme_gtpc(NULL) {}
 
 s1ap::~s1ap()
@@ -106,13 +112,13 @@ void s1ap::stop()
     m_active_enbs.erase(enb_it++);
   }
 
-  std::map<uint64_t, nas*>::iterator ue_it = m_imsi_to_nas_ctx.begin();
-  while (ue_it != m_imsi_to_nas_ctx.end()) {
-    m_logger.info("Deleting UE EMM context. IMSI: %015" PRIu64 "", ue_it->first);
-    srsran::console("Deleting UE EMM context. IMSI: %015" PRIu64 "\n", ue_it->first);
-    delete ue_it->second;
-    m_imsi_to_nas_ctx.erase(ue_it++);
-  }
+  m_ue_registry.for_each_ue([this](nas* nas_ctx) {
+    m_logger.info("Deleting UE EMM context. IMSI: %015" PRIu64 "", nas_ctx->m_emm_ctx.imsi);
+    srsran::console("Deleting UE EMM context. IMSI: %015" PRIu64 "\n", nas_ctx->m_emm_ctx.imsi);
+    m_ue_registry.remove_ue_from_enb(nas_ctx);
+    delete nas_ctx;
+  });
+  m_ue_registry.clear();
 
   // Cleanup message handlers
   s1ap_mngmt_proc::cleanup();
@@ -133,7 +139,18 @@ int s1ap::get_s1_mme()
 
 uint32_t s1ap::get_next_mme_ue_s1ap_id()
 {
-  return m_next_mme_ue_s1ap_id++;
+  std::lock_guard<std::mutex> lock(m_ctx_mutex);
+  return m_next_mme_ue_s1ap_id++ * m_nof_workers + worker_idx;
+}
+
+void s1ap::set_nof_workers(uint32_t nof_workers)
+{
+  m_nof_workers = std::max(nof_workers, 1u);
+}
+
+void s1ap::set_worker_idx(uint32_t worker_idx_)
+{
+  worker_idx = worker_idx_;
 }
 
 int s1ap::enb_listen()
@@ -210,6 +227,7 @@ bool s1ap::s1ap_tx_pdu(const asn1::s1ap::s1ap_pdu_c& pdu, struct sctp_sndrcvinfo
   }
 
   if (m_pcap_enable) {
+    std::lock_guard<std::mutex> lock(m_pcap_mutex);
     m_pcap.write_s1ap(buf->msg, buf->N_bytes);
   }
 
@@ -217,20 +235,40 @@ bool s1ap::s1ap_tx_pdu(const asn1::s1ap::s1ap_pdu_c& pdu, struct sctp_sndrcvinfo
 }
 
 void s1ap::handle_s1ap_rx_pdu(srsran::byte_buffer_t* pdu, struct sctp_sndrcvinfo* enb_sri)
+{
+  // The PDU containers are allocated in a stack arena, declared before the PDU to outlive it
+  std::array<uint8_t, s1ap_rx_arena_size> arena_buffer;
+  srsran::linear_allocator                arena(arena_buffer.data(), arena_buffer.size());
+  s1ap_pdu_t                              rx_pdu;
+  bool                                    ret;
+  {
+    asn1::arena_scope scope(arena);
+    ret = unpack_s1ap_rx_pdu(pdu, &rx_pdu);
+  }
+  if (ret) {
+    handle_s1ap_rx_pdu(rx_pdu, enb_sri);
+  }
+}
+
+bool s1ap::unpack_s1ap_rx_pdu(srsran::byte_buffer_t* pdu, s1ap_pdu_t* rx_pdu)
 {
   // Save PCAP
   if (m_pcap_enable) {
+    std::lock_guard<std::mutex> lock(m_pcap_mutex);
     m_pcap.write_s1ap(pdu->msg, pdu->N_bytes);
   }
 
-  // Get PDU type
-  s1ap_pdu_t     rx_pdu;
   asn1::cbit_ref bref(pdu->msg, pdu->N_bytes);
-  if (rx_pdu.unpack(bref) != asn1::SRSASN_SUCCESS) {
+  if (rx_pdu->unpack(bref) != asn1::SRSASN_SUCCESS) {
     m_logger.error("Failed to unpack received PDU");
-    return;
+    return false;
   }
+  return true;
+}
 
+void s1ap::handle_s1ap_rx_pdu(const s1ap_pdu_t& rx_pdu, struct sctp_sndrcvinfo* enb_sri)
+{
+  // Get PDU type
   switch (rx_pdu.type().value) {
     case s1ap_pdu_t::types_opts::init_msg:
       m_logger.info("Received Initiating PDU");
@@ -301,12 +339,13 @@ void s1ap::handle_successful_outcome(const asn1::s1ap::successful_outcome_s& msg
 void s1ap::add_new_enb_ctx(const enb_ctx_t& enb_ctx, const struct sctp_sndrcvinfo* enb_sri)
 {
   m_logger.info("Adding new eNB context. eNB ID %d", enb_ctx.enb_id);
-  std::set<uint32_t> ue_set;
-  enb_ctx_t*         enb_ptr = new enb_ctx_t;
-  *enb_ptr                   = enb_ctx;
+  enb_ctx_t* enb_ptr = new enb_ctx_t;
+  *enb_ptr           = enb_ctx;
+
+  std::lock_guard<std::mutex> lock(m_ctx_mutex);
   m_active_enbs.insert(std::pair<uint16_t, enb_ctx_t*>(enb_ptr->enb_id, enb_ptr));
   m_sctp_to_enb_id.insert(std::pair<int32_t, uint16_t>(enb_sri->sinfo_assoc_id, enb_ptr->enb_id));
-  m_enb_assoc_to_ue_ids.insert(std::pair<int32_t, std::set<uint32_t> >(enb_sri->sinfo_assoc_id, ue_set));
+  m_ue_registry.add_enb(enb_sri->sinfo_assoc_id);
 }
 
 enb_ctx_t* s1ap::find_enb_ctx(uint16_t enb_id)
@@ -321,11 +360,15 @@ enb_ctx_t* s1ap::find_enb_ctx(uint16_t enb_id)
 
 void s1ap::delete_enb_ctx(int32_t assoc_id)
 {
-  std::map<int32_t, uint16_t>::iterator it_assoc = m_sctp_to_enb_id.find(assoc_id);
-  uint16_t                              enb_id   = it_assoc->second;
+  auto it_assoc = m_sctp_to_enb_id.find(assoc_id);
+  if (it_assoc == m_sctp_to_enb_id.end()) {
+    m_logger.error("Could not find eNB to delete. Association: %d", assoc_id);
+    return;
+  }
+  uint16_t enb_id = it_assoc->second;
 
   std::map<uint16_t, enb_ctx_t*>::iterator it_ctx = m_active_enbs.find(enb_id);
-  if (it_ctx == m_active_enbs.end() || it_assoc == m_sctp_to_enb_id.end()) {
+  if (it_ctx == m_active_enbs.end()) {
     m_logger.error("Could not find eNB to delete. Association: %d", assoc_id);
     return;
   }
@@ -337,117 +380,109 @@ void s1ap::delete_enb_ctx(int32_t assoc_id)
   release_ues_ecm_ctx_in_enb(assoc_id);
 
   // Delete eNB
+  std::lock_guard<std::mutex> lock(m_ctx_mutex);
   delete it_ctx->second;
   m_active_enbs.erase(it_ctx);
   m_sctp_to_enb_id.erase(it_assoc);
+  m_ue_registry.remove_enb(assoc_id);
   return;
 }
 
 // UE Context Management
 bool s1ap::add_nas_ctx_to_imsi_map(nas* nas_ctx)
 {
-  std::map<uint64_t, nas*>::iterator ctx_it = m_imsi_to_nas_ctx.find(nas_ctx->m_emm_ctx.imsi);
-  if (ctx_it != m_imsi_to_nas_ctx.end()) {
+  std::lock_guard<std::mutex> lock(m_ctx_mutex);
+  if (m_ue_registry.find_imsi(nas_ctx->m_emm_ctx.imsi) != nullptr) {
     m_logger.error("UE Context already exists. IMSI %015" PRIu64 "", nas_ctx->m_emm_ctx.imsi);
     return false;
   }
   if (nas_ctx->m_ecm_ctx.mme_ue_s1ap_id != 0) {
-    std::map<uint32_t, nas*>::iterator ctx_it2 = m_mme_ue_s1ap_id_to_nas_ctx.find(nas_ctx->m_ecm_ctx.mme_ue_s1ap_id);
-    if (ctx_it2 != m_mme_ue_s1ap_id_to_nas_ctx.end() && ctx_it2->second != nas_ctx) {
+    nas* nas_ctx2 = m_ue_registry.find_mme_ue_s1ap_id(nas_ctx->m_ecm_ctx.mme_ue_s1ap_id);
+    if (nas_ctx2 != nullptr && nas_ctx2 != nas_ctx) {
       m_logger.error("Context identified with IMSI does not match context identified by MME UE S1AP Id.");
       return false;
     }
   }
-  m_imsi_to_nas_ctx.insert(std::pair<uint64_t, nas*>(nas_ctx->m_emm_ctx.imsi, nas_ctx));
+  m_ue_registry.add_imsi(nas_ctx);
   m_logger.debug("Saved UE context corresponding to IMSI %015" PRIu64 "", nas_ctx->m_emm_ctx.imsi);
   return true;
 }
 
 bool s1ap::add_nas_ctx_to_mme_ue_s1ap_id_map(nas* nas_ctx)
 {
+  std::lock_guard<std::mutex> lock(m_ctx_mutex);
   if (nas_ctx->m_ecm_ctx.mme_ue_s1ap_id == 0) {
     m_logger.error("Could not add UE context to MME UE S1AP map. MME UE S1AP ID 0 is not valid.");
     return false;
   }
-  std::map<uint32_t, nas*>::iterator ctx_it = m_mme_ue_s1ap_id_to_nas_ctx.find(nas_ctx->m_ecm_ctx.mme_ue_s1ap_id);
-  if (ctx_it != m_mme_ue_s1ap_id_to_nas_ctx.end()) {
+  if (not m_ue_registry.add_mme_ue_s1ap_id(nas_ctx)) {
     m_logger.error("UE Context already exists. MME UE S1AP Id %015" PRIu64 "", nas_ctx->m_emm_ctx.imsi);
     return false;
   }
-  if (nas_ctx->m_emm_ctx.imsi != 0) {
-    std::map<uint32_t, nas*>::iterator ctx_it2 = m_mme_ue_s1ap_id_to_nas_ctx.find(nas_ctx->m_ecm_ctx.mme_ue_s1ap_id);
-    if (ctx_it2 != m_mme_ue_s1ap_id_to_nas_ctx.end() && ctx_it2->second != nas_ctx) {
-      m_logger.error("Context identified with MME UE S1AP Id does not match context identified by IMSI.");
-      return false;
-    }
-  }
-  m_mme_ue_s1ap_id_to_nas_ctx.insert(std::pair<uint32_t, nas*>(nas_ctx->m_ecm_ctx.mme_ue_s1ap_id, nas_ctx));
   m_logger.debug("Saved UE context corresponding to MME UE S1AP Id %d", nas_ctx->m_ecm_ctx.mme_ue_s1ap_id);
   return true;
 }
 
 bool s1ap::add_ue_to_enb_set(int32_t enb_assoc, uint32_t mme_ue_s1ap_id)
 {
-  std::map<int32_t, std::set<uint32_t> >::iterator ues_in_enb = m_enb_assoc_to_ue_ids.find(enb_assoc);
-  if (ues_in_enb == m_enb_assoc_to_ue_ids.end()) {
+  std::lock_guard<std::mutex> lock(m_ctx_mutex);
+  if (not m_ue_registry.has_enb(enb_assoc)) {
     m_logger.error("Could not find eNB from eNB SCTP association %d", enb_assoc);
     return false;
   }
-  std::set<uint32_t>::iterator ue_id = ues_in_enb->second.find(mme_ue_s1ap_id);
-  if (ue_id != ues_in_enb->second.end()) {
+  nas* nas_ctx = m_ue_registry.find_mme_ue_s1ap_id(mme_ue_s1ap_id);
+  if (nas_ctx == nullptr) {
+    m_logger.error("Could not find UE with MME UE S1AP Id %d", mme_ue_s1ap_id);
+    return false;
+  }
+  if (not m_ue_registry.add_ue_to_enb(enb_assoc, nas_ctx)) {
     m_logger.error("UE with MME UE S1AP Id already exists %d", mme_ue_s1ap_id);
     return false;
   }
-  ues_in_enb->second.insert(mme_ue_s1ap_id);
   m_logger.debug("Added UE with MME-UE S1AP Id %d to eNB with association %d", mme_ue_s1ap_id, enb_assoc);
   return true;
 }
 
 nas* s1ap::find_nas_ctx_from_mme_ue_s1ap_id(uint32_t mme_ue_s1ap_id)
 {
-  std::map<uint32_t, nas*>::iterator it = m_mme_ue_s1ap_id_to_nas_ctx.find(mme_ue_s1ap_id);
-  if (it == m_mme_ue_s1ap_id_to_nas_ctx.end()) {
-    return NULL;
-  } else {
-    return it->second;
-  }
+  std::lock_guard<std::mutex> lock(m_ctx_mutex);
+  return m_ue_registry.find_mme_ue_s1ap_id(mme_ue_s1ap_id);
 }
 
 nas* s1ap::find_nas_ctx_from_imsi(uint64_t imsi)
 {
-  std::map<uint64_t, nas*>::iterator it = m_imsi_to_nas_ctx.find(imsi);
-  if (it == m_imsi_to_nas_ctx.end()) {
-    return NULL;
-  } else {
-    return it->second;
-  }
+  std::lock_guard<std::mutex> lock(m_ctx_mutex);
+  return m_ue_registry.find_imsi(imsi);
+}
+
+uint32_t s1ap::find_mme_ue_s1ap_id_from_imsi(uint64_t imsi)
+{
+  // Called from the MME thread, so it only reads the registry. The NAS context belongs to the worker of the UE
+  std::lock_guard<std::mutex> lock(m_ctx_mutex);
+  return m_ue_registry.find_imsi_mme_ue_s1ap_id(imsi);
 }
 
 void s1ap::release_ues_ecm_ctx_in_enb(int32_t enb_assoc)
 {
   srsran::console("Releasing UEs context\n");
-  std::map<int32_t, std::set<uint32_t> >::iterator ues_in_enb = m_enb_assoc_to_ue_ids.find(enb_assoc);
-  std::set<uint32_t>::iterator                     ue_id      = ues_in_enb->second.begin();
-  if (ue_id == ues_in_enb->second.end()) {
-    srsran::console("No UEs to be released\n");
-  } else {
-    while (ue_id != ues_in_enb->second.end()) {
-      std::map<uint32_t, nas*>::iterator nas_ctx = m_mme_ue_s1ap_id_to_nas_ctx.find(*ue_id);
-      emm_ctx_t*                         emm_ctx = &nas_ctx->second->m_emm_ctx;
-      ecm_ctx_t*                         ecm_ctx = &nas_ctx->second->m_ecm_ctx;
-
-      m_logger.info(
-          "Releasing UE context. IMSI: %015" PRIu64 ", UE-MME S1AP Id: %d", emm_ctx->imsi, ecm_ctx->mme_ue_s1ap_id);
-      if (emm_ctx->state == EMM_STATE_REGISTERED) {
-        m_mme_gtpc->send_delete_session_request(emm_ctx->imsi);
-        emm_ctx->state = EMM_STATE_DEREGISTERED;
-      }
-      srsran::console("Releasing UE ECM context. UE-MME S1AP Id: %d\n", ecm_ctx->mme_ue_s1ap_id);
-      ecm_ctx->state          = ECM_STATE_IDLE;
-      ecm_ctx->mme_ue_s1ap_id = 0;
-      ecm_ctx->enb_ue_s1ap_id = 0;
-      ues_in_enb->second.erase(ue_id++);
+  std::lock_guard<std::mutex> lock(m_ctx_mutex);
+  uint32_t nof_ues = m_ue_registry.release_enb_ues(enb_assoc, [this](nas* nas_ctx) {
+    emm_ctx_t* emm_ctx = &nas_ctx->m_emm_ctx;
+    ecm_ctx_t* ecm_ctx = &nas_ctx->m_ecm_ctx;
+
+    m_logger.info(
+        "Releasing UE context. IMSI: %015" PRIu64 ", UE-MME S1AP Id: %d", emm_ctx->imsi, ecm_ctx->mme_ue_s1ap_id);
+    if (emm_ctx->state == EMM_STATE_REGISTERED) {
+      m_mme_gtpc->send_delete_session_request(emm_ctx->imsi);
+      emm_ctx->state = EMM_STATE_DEREGISTERED;
     }
+    srsran::console("Releasing UE ECM context. UE-MME S1AP Id: %d\n", ecm_ctx->mme_ue_s1ap_id);
+    ecm_ctx->state          = ECM_STATE_IDLE;
+    ecm_ctx->mme_ue_s1ap_id = 0;
+    ecm_ctx->enb_ue_s1ap_id = 0;
+  });
+  if (nof_ues == 0) {
+    srsran::console("No UEs to be released\n");
   }
 }
 
@@ -461,21 +496,15 @@ bool s1ap::release_ue_ecm_ctx(uint32_t mme_ue_s1ap_id)
   ecm_ctx_t* ecm_ctx = &nas_ctx->m_ecm_ctx;
 
   // Delete UE within eNB UE set
-  std::map<int32_t, uint16_t>::iterator it = m_sctp_to_enb_id.find(ecm_ctx->enb_sri.sinfo_assoc_id);
-  if (it == m_sctp_to_enb_id.end()) {
+  std::lock_guard<std::mutex> lock(m_ctx_mutex);
+  if (m_sctp_to_enb_id.find(ecm_ctx->enb_sri.sinfo_assoc_id) == m_sctp_to_enb_id.end()) {
     m_logger.error("Could not find eNB for UE release request.");
     return false;
   }
-  uint16_t                                         enb_id = it->second;
-  std::map<int32_t, std::set<uint32_t> >::iterator ue_set = m_enb_assoc_to_ue_ids.find(ecm_ctx->enb_sri.sinfo_assoc_id);
-  if (ue_set == m_enb_assoc_to_ue_ids.end()) {
-    m_logger.error("Could not find the eNB's UEs.");
-    return false;
-  }
-  ue_set->second.erase(mme_ue_s1ap_id);
+  m_ue_registry.remove_ue_from_enb(nas_ctx);
 
   // Release UE ECM context
-  m_mme_ue_s1ap_id_to_nas_ctx.erase(mme_ue_s1ap_id);
+  m_ue_registry.remove_mme_ue_s1ap_id(mme_ue_s1ap_id);
   ecm_ctx->state          = ECM_STATE_IDLE;
   ecm_ctx->mme_ue_s1ap_id = 0;
   ecm_ctx->enb_ue_s1ap_id = 0;
@@ -498,7 +527,11 @@ bool s1ap::delete_ue_ctx(uint64_t imsi)
   }
 
   // Delete UE context
-  m_imsi_to_nas_ctx.erase(imsi);
+  {
+    std::lock_guard<std::mutex> lock(m_ctx_mutex);
+    m_ue_registry.remove_ue_from_enb(nas_ctx);
+    m_ue_registry.remove_imsi(imsi);
+  }
   delete nas_ctx;
   m_logger.info("Deleted UE Context.");
   return true;
@@ -507,21 +540,22 @@ bool s1ap::delete_ue_ctx(uint64_t imsi)
 // UE Bearer Managment
 void s1ap::activate_eps_bearer(uint64_t imsi, uint8_t ebi)
 {
-  std::map<uint64_t, nas*>::iterator ue_ctx_it = m_imsi_to_nas_ctx.find(imsi);
-  if (ue_ctx_it == m_imsi_to_nas_ctx.end()) {
+  std::unique_lock<std::mutex> lock(m_ctx_mutex);
+  nas*                         nas_ctx = m_ue_registry.find_imsi(imsi);
+  if (nas_ctx == nullptr) {
     m_logger.error("Could not activate EPS bearer: Could not find UE context");
     return;
   }
   // Make sure NAS is active
-  uint32_t                           mme_ue_s1ap_id = ue_ctx_it->second->m_ecm_ctx.mme_ue_s1ap_id;
-  std::map<uint32_t, nas*>::iterator it             = m_mme_ue_s1ap_id_to_nas_ctx.find(mme_ue_s1ap_id);
-  if (it == m_mme_ue_s1ap_id_to_nas_ctx.end()) {
+  uint32_t mme_ue_s1ap_id = nas_ctx->m_ecm_ctx.mme_ue_s1ap_id;
+  if (m_ue_registry.find_mme_ue_s1ap_id(mme_ue_s1ap_id) == nullptr) {
     m_logger.error("Could not activate EPS bearer: ECM context seems to be missing");
     return;
   }
+  lock.unlock();
 
-  ecm_ctx_t* ecm_ctx = &ue_ctx_it->second->m_ecm_ctx;
-  esm_ctx_t* esm_ctx = &ue_ctx_it->second->m_esm_ctx[ebi];
+  ecm_ctx_t* ecm_ctx = &nas_ctx->m_ecm_ctx;
+  esm_ctx_t* esm_ctx = &nas_ctx->m_esm_ctx[ebi];
   if (esm_ctx->state != ERAB_CTX_SETUP) {
     m_logger.error(
         "Could not be activate EPS Bearer, bearer in wrong state: MME S1AP Id %d, EPS Bearer id %d, state %d",
@@ -544,20 +578,22 @@ void s1ap::activate_eps_bearer(uint64_t imsi, uint8_t ebi)
 
 uint32_t s1ap::allocate_m_tmsi(uint64_t imsi)
 {
+  std::lock_guard<std::mutex> lock(m_ctx_mutex);
   uint32_t m_tmsi = m_next_m_tmsi;
   m_next_m_tmsi   = (m_next_m_tmsi + 1) % UINT32_MAX;
 
-  m_tmsi_to_imsi.insert(std::pair<uint32_t, uint64_t>(m_tmsi, imsi));
+  m_ue_registry.add_m_tmsi(m_tmsi, imsi);
   m_logger.debug("Allocated M-TMSI 0x%x to IMSI %015" PRIu64 ",", m_tmsi, imsi);
   return m_tmsi;
 }
 
 uint64_t s1ap::find_imsi_from_m_tmsi(uint32_t m_tmsi)
 {
-  std::map<uint32_t, uint64_t>::iterator it = m_tmsi_to_imsi.find(m_tmsi);
-  if (it != m_tmsi_to_imsi.end()) {
-    m_logger.debug("Found IMSI %015" PRIu64 " from M-TMSI 0x%x", it->second, m_tmsi);
-    return it->second;
+  std::lock_guard<std::mutex> lock(m_ctx_mutex);
+  uint64_t                    imsi = m_ue_registry.find_m_tmsi(m_tmsi);
+  if (imsi != 0) {
+    m_logger.debug("Found IMSI %015" PRIu64 " from M-TMSI 0x%x", imsi, m_tmsi);
+    return imsi;
   } else {
     m_logger.debug("Could not find IMSI from M-TMSI 0x%x", m_tmsi);
     return 0;
@@ -0,0 +1,200 @@
+/**
+ * Copyright 2013-2021 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "srsepc/hdr/hss/hss.h"
+#include "srsran/common/security.h"
+#include "srsran/common/test_common.h"
+#include <boost/program_options.hpp>
+#include <chrono>
+#include <inttypes.h>
+#include <iostream>
+#include <unistd.h>
+
+namespace bpo = boost::program_options;
+
+struct hss_test_args_t {
+  uint32_t    nof_users;
+  uint32_t    nof_auths;
+  uint32_t    av_cache;
+  std::string db_file;
+};
+
+static const uint64_t base_imsi = 1010123456780000ULL;
+
+static void user_key(uint32_t idx, uint8_t* k, uint8_t* opc)
+{
+  for (uint32_t i = 0; i < 16; i++) {
+    k[i]   = (uint8_t)(idx >> (8 * (i % 4))) ^ (uint8_t)i;
+    opc[i] = (uint8_t)(0xa5 ^ i);
+  }
+}
+
+static int write_test_db(const hss_test_args_t& args)
+{
+  FILE* f = fopen(args.db_file.c_str(), "w");
+  TESTASSERT(f != nullptr);
+  fprintf(f, "# Name,Auth,IMSI,Key,OP_Type,OP/OPc,AMF,SQN,QCI,IP_alloc\n");
+  for (uint32_t u = 0; u < args.nof_users; u++) {
+    uint8_t k[16], opc[16];
+    user_key(u, k, opc);
+    fprintf(f, "ue%d,mil,%015" PRIu64 ",", u, base_imsi + u);
+    for (uint32_t i = 0; i < 16; i++) {
+      fprintf(f, "%02x", k[i]);
+    }
+    fprintf(f, ",opc,");
+    for (uint32_t i = 0; i < 16; i++) {
+      fprintf(f, "%02x", opc[i]);
+    }
+    fprintf(f, ",8000,000000001234,7,dynamic\n");
+  }
+  fclose(f);
+  unlink((args.db_file + ".sqn").c_str());
+  return SRSRAN_SUCCESS;
+}
+
+// Recover the SQN the HSS used from the AUTN (autn = sqn ^ ak |+| amf |+| mac)
+static uint64_t sqn_from_autn(uint32_t idx, uint8_t* rand, uint8_t* autn)
+{
+  uint8_t k[16], opc[16], res[8], ck[16], ik[16], ak[6];
+  user_key(idx, k, opc);
+  srsran::security_milenage_f2345(k, opc, rand, res, ck, ik, ak);
+  uint64_t sqn = 0;
+  for (uint32_t i = 0; i < 6; i++) {
+    sqn = (sqn << 8) | (autn[i] ^ ak[i]);
+  }
+  return sqn;
+}
+
+static int init_hss(const hss_test_args_t& args)
+{
+  srsepc::hss_args_t hss_args = {};
+  hss_args.db_file            = args.db_file;
+  hss_args.mcc                = 0xf001;
+  hss_args.mnc                = 0xff01;
+  hss_args.auth_vector_cache  = args.av_cache;
+  TESTASSERT(srsepc::hss::get_instance()->init(&hss_args) == 0);
+  return SRSRAN_SUCCESS;
+}
+
+// Returns the SQN of the next authentication vector of the first user
+static uint64_t next_sqn(srsepc::hss* hss)
+{
+  uint8_t k_asme[32], autn[16], rand[16], xres[16];
+  if (not hss->gen_auth_info_answer(base_imsi, k_asme, autn, rand, xres)) {
+    return 0;
+  }
+  return sqn_from_autn(0, rand, autn);
+}
+
+int test_lookup_and_auth_rate(const hss_test_args_t& args)
+{
+  TESTASSERT(write_test_db(args) == SRSRAN_SUCCESS);
+
+  auto t0 = std::chrono::steady_clock::now();
+  TESTASSERT(init_hss(args) == SRSRAN_SUCCESS);
+  auto         t1  = std::chrono::steady_clock::now();
+  srsepc::hss* hss = srsepc::hss::get_instance();
+
+  // TEST: subscribers are found by IMSI, unknown IMSIs are rejected
+  uint8_t k_asme[32], autn[16], rand[16], xres[16];
+  uint8_t qci = 0;
+  TESTASSERT(hss->gen_update_loc_answer(base_imsi + args.nof_users - 1, &qci));
+  TESTASSERT(qci == 7);
+  TESTASSERT(not hss->gen_auth_info_answer(base_imsi + args.nof_users, k_asme, autn, rand, xres));
+
+  auto t2 = std::chrono::steady_clock::now();
+  for (uint32_t i = 0; i < args.nof_auths; i++) {
+    TESTASSERT(hss->gen_auth_info_answer(base_imsi + (i % args.nof_users), k_asme, autn, rand, xres));
+  }
+  auto t3 = std::chrono::steady_clock::now();
+
+  printf("nof_users=%d; av_cache=%d; startup=%.1f ms; nof_auths=%d; %.0f auth vectors/s;\n",
+         args.nof_users,
+         args.av_cache,
+         std::chrono::duration<double, std::milli>(t1 - t0).count(),
+         args.nof_auths,
+         args.nof_auths / std::chrono::duration<double>(t3 - t2).count());
+
+  hss->stop();
+  srsepc::hss::cleanup();
+  return SRSRAN_SUCCESS;
+}
+
+int test_sqn_journal(const hss_test_args_t& args)
+{
+  TESTASSERT(write_test_db(args) == SRSRAN_SUCCESS);
+  TESTASSERT(init_hss(args) == SRSRAN_SUCCESS);
+  uint64_t last_sqn = next_sqn(srsepc::hss::get_instance());
+  TESTASSERT(last_sqn > 0x1234);
+
+  // TEST: after a crash the database was not written back, the SQNs are recovered from the journal
+  srsepc::hss::cleanup();
+  TESTASSERT(init_hss(args) == SRSRAN_SUCCESS);
+  uint64_t sqn = next_sqn(srsepc::hss::get_instance());
+  TESTASSERT(sqn > last_sqn);
+  last_sqn = sqn;
+
+  // TEST: a clean shutdown folds the journal into the database
+  srsepc::hss::get_instance()->stop();
+  srsepc::hss::cleanup();
+  TESTASSERT(init_hss(args) == SRSRAN_SUCCESS);
+  TESTASSERT(next_sqn(srsepc::hss::get_instance()) > last_sqn);
+
+  srsepc::hss::get_instance()->stop();
+  srsepc::hss::cleanup();
+  unlink(args.db_file.c_str());
+  unlink((args.db_file + ".sqn").c_str());
+  return SRSRAN_SUCCESS;
+}
+
+static void parse_args(hss_test_args_t* args, int argc, char* argv[])
+{
+  bpo::options_description options("Options");
+  // clang-format off
+  options.add_options()
+      ("help,h", "Produce help message")
+      ("nof_users", bpo::value<uint32_t>(&args->nof_users)->default_value(10000),                         "Number of users")
+      ("nof_auths", bpo::value<uint32_t>(&args->nof_auths)->default_value(20000),                         "Number of authentication vectors")
+      ("av_cache",  bpo::value<uint32_t>(&args->av_cache)->default_value(0),                              "Authentication vectors cached per user")
+      ("db_file",   bpo::value<std::string>(&args->db_file)->default_value("/tmp/hss_test_user_db.csv"), "User database file");
+  // clang-format on
+
+  bpo::variables_map vm;
+  bpo::store(bpo::command_line_parser(argc, argv).options(options).run(), vm);
+  bpo::notify(vm);
+  if (vm.count("help") > 0) {
+    std::cout << "Usage: " << argv[0] << " [OPTIONS]" << std::endl << options << std::endl;
+    exit(0);
+  }
+}
+
+int main(int argc, char* argv[])
+{
+  hss_test_args_t args = {};
+  parse_args(&args, argc, argv);
+
+  srslog::init();
+
+  TESTASSERT(test_lookup_and_auth_rate(args) == SRSRAN_SUCCESS);
+  TESTASSERT(test_sqn_journal(args) == SRSRAN_SUCCESS);
+  printf("Success\n");
+  return SRSRAN_SUCCESS;
+}
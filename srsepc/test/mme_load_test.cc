@@ -0,0 +1,1397 @@
+/**
+ * Copyright 2013-2021 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+/**
+ * S1AP load generator for srsEPC.
+ *
+ * Emulates a set of eNBs, each with its own SCTP association to the MME, and a population of UEs spread over them.
+ * Every UE runs a number of attach / release / service request / paging / detach cycles against a running srsEPC,
+ * using the NAS and S1AP codecs from lib. At the end, the number of procedures per second and the latency
+ * percentiles of each procedure are reported.
+ *
+ * Paging is triggered by sending a UDP datagram to the IP of an idle UE, so it requires the SGi interface of the
+ * SPGW to be reachable from the host running the test.
+ *
+ * With --in_process, the HSS and the MME are started inside the test instead, with --mme_workers S1AP/NAS worker
+ * threads, and the SPGW is replaced by a S11 responder that accepts every session. This measures the attach rate of
+ * the MME alone, without a running srsEPC, a TUN device or root privileges. Paging is not available in this mode.
+ */
+
+#include "srsepc/hdr/hss/hss.h"
+#include "srsepc/hdr/mme/mme.h"
+#include "srsran/asn1/gtpc.h"
+#include "srsran/asn1/liblte_mme.h"
+#include "srsran/asn1/s1ap.h"
+#include "srsran/common/bcd_helpers.h"
+#include "srsran/common/common.h"
+#include "srsran/common/int_helpers.h"
+#include "srsran/common/network_utils.h"
+#include "srsran/common/security.h"
+#include "srsran/config.h"
+#include <algorithm>
+#include <atomic>
+#include <boost/program_options.hpp>
+#include <chrono>
+#include <cinttypes>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <signal.h>
+#include <sys/epoll.h>
+#include <sys/un.h>
+#include <thread>
+#include <unistd.h>
+#include <unordered_map>
+#include <vector>
+
+using namespace asn1::s1ap;
+using namespace srsran;
+namespace bpo = boost::program_options;
+
+using load_clock = std::chrono::steady_clock;
+
+#define S1AP_PPID 18
+#define S1AP_PORT 36412
+
+/**********************************************************************
+ *  Program arguments processing
+ ***********************************************************************/
+struct load_args_t {
+  std::string mme_addr;
+  std::string enb_bind_addr;
+  uint32_t    enb_id;
+  uint32_t    nof_enbs;
+  uint32_t    nof_ues;
+  uint32_t    nof_cycles;
+  uint32_t    attach_rate;
+  uint32_t    timeout_ms;
+  bool        paging;
+  uint64_t    imsi;
+  uint8_t     k[16];
+  uint8_t     opc[16];
+  uint16_t    mcc;
+  uint16_t    mnc;
+  uint16_t    tac;
+  std::string k_str;
+  std::string opc_str;
+  std::string gen_db;
+  bool        in_process;
+  uint32_t    mme_workers;
+  std::string log_filename;
+  std::string log_level;
+};
+
+static bool hex_to_bytes(const std::string& str, uint8_t* bytes, uint32_t len)
+{
+  if (str.size() != 2 * len) {
+    return false;
+  }
+  for (uint32_t i = 0; i < len; i++) {
+    std::string byte_str = str.substr(2 * i, 2);
+    char*       end      = nullptr;
+    bytes[i]             = (uint8_t)strtoul(byte_str.c_str(), &end, 16);
+    if (*end != '\0') {
+      return false;
+    }
+  }
+  return true;
+}
+
+static bool parse_args(load_args_t* args, int argc, char* argv[])
+{
+  std::string imsi;
+  std::string mcc;
+  std::string mnc;
+  std::string tac;
+
+  bpo::options_description options("Options");
+  // clang-format off
+  options.add_options()
+      ("help,h", "Produce help message")
+      ("mme_addr",      bpo::value<std::string>(&args->mme_addr)->default_value("127.0.1.100"),     "IP address of the MME S1 interface")
+      ("enb_bind_addr", bpo::value<std::string>(&args->enb_bind_addr)->default_value("127.0.0.1"),  "Local address of the emulated eNBs, also advertised as S1-U address")
+      ("enb_id",        bpo::value<uint32_t>(&args->enb_id)->default_value(0x19B),                  "eNB ID of the first emulated eNB")
+      ("nof_enbs",      bpo::value<uint32_t>(&args->nof_enbs)->default_value(1),                    "Number of emulated eNBs")
+      ("nof_ues",       bpo::value<uint32_t>(&args->nof_ues)->default_value(100),                   "Number of emulated UEs")
+      ("nof_cycles",    bpo::value<uint32_t>(&args->nof_cycles)->default_value(1),                  "Number of attach/detach cycles run by every UE")
+      ("attach_rate",   bpo::value<uint32_t>(&args->attach_rate)->default_value(0),                 "Initial attaches started per second (0 starts all UEs at once)")
+      ("timeout",       bpo::value<uint32_t>(&args->timeout_ms)->default_value(10000),              "Procedure timeout in ms")
+      ("paging",        bpo::value<bool>(&args->paging)->default_value(false),                      "Page every UE once per cycle by sending downlink data to its IP")
+      ("imsi",          bpo::value<std::string>(&imsi)->default_value("001010000000001"),           "IMSI of the first UE, the following UEs use consecutive IMSIs")
+      ("k",             bpo::value<std::string>(&args->k_str)->default_value("00112233445566778899aabbccddeeff"),   "Milenage K shared by all UEs")
+      ("opc",           bpo::value<std::string>(&args->opc_str)->default_value("63bfa50ee6523365ff14c1f45f88737d"), "Milenage OPc shared by all UEs")
+      ("mcc",           bpo::value<std::string>(&mcc)->default_value("001"),                        "Mobile Country Code")
+      ("mnc",           bpo::value<std::string>(&mnc)->default_value("01"),                         "Mobile Network Code")
+      ("tac",           bpo::value<std::string>(&tac)->default_value("0x0007"),                     "Tracking Area Code")
+      ("gen_db",        bpo::value<std::string>(&args->gen_db)->default_value(""),                  "Write an HSS user database with the emulated UEs to this file and exit")
+      ("in_process",    bpo::value<bool>(&args->in_process)->default_value(false),                  "Run the HSS and the MME in this process, with a stub SPGW")
+      ("mme_workers",   bpo::value<uint32_t>(&args->mme_workers)->default_value(0),                 "Number of MME S1AP/NAS worker threads with --in_process")
+      ("log_filename",  bpo::value<std::string>(&args->log_filename)->default_value("/tmp/mme_load_test.log"), "Log filename")
+      ("log_level",     bpo::value<std::string>(&args->log_level)->default_value("warning"),        "Log level")
+      ;
+  // clang-format on
+
+  bpo::variables_map vm;
+  try {
+    bpo::store(bpo::command_line_parser(argc, argv).options(options).run(), vm);
+    bpo::notify(vm);
+  } catch (bpo::error& e) {
+    std::cerr << e.what() << std::endl;
+    return false;
+  }
+  if (vm.count("help")) {
+    std::cout << "Usage: " << argv[0] << " [OPTIONS]" << std::endl << options << std::endl;
+    exit(0);
+  }
+
+  args->imsi = strtoull(imsi.c_str(), nullptr, 10);
+  args->tac  = (uint16_t)strtoul(tac.c_str(), nullptr, 0);
+  if (imsi.size() != 15 or not string_to_mcc(mcc, &args->mcc) or not string_to_mnc(mnc, &args->mnc) or
+      not hex_to_bytes(args->k_str, args->k, 16) or not hex_to_bytes(args->opc_str, args->opc, 16)) {
+    std::cerr << "Invalid IMSI, MCC, MNC, K or OPc" << std::endl;
+    return false;
+  }
+  if (args->in_process and args->paging) {
+    std::cerr << "Paging requires a SPGW and can not be used with --in_process" << std::endl;
+    return false;
+  }
+  if (args->nof_enbs == 0 or args->nof_ues == 0) {
+    std::cerr << "At least one eNB and one UE are required" << std::endl;
+    return false;
+  }
+  return true;
+}
+
+/// Writes a Milenage user_db.csv entry for every emulated UE
+static bool write_user_db(const load_args_t& args, const std::string& filename)
+{
+  std::ofstream file(filename.c_str());
+  if (not file.is_open()) {
+    std::cerr << "Could not open " << filename << std::endl;
+    return false;
+  }
+  file << "# Generated by mme_load_test" << std::endl;
+  for (uint32_t i = 0; i < args.nof_ues; i++) {
+    char imsi[16];
+    snprintf(imsi, sizeof(imsi), "%015" PRIu64, args.imsi + i);
+    file << "load" << i << ",mil," << imsi << "," << args.k_str << ",opc," << args.opc_str
+         << ",8000,000000001234,7,dynamic" << std::endl;
+  }
+  return true;
+}
+
+/**********************************************************************
+ *  Statistics
+ ***********************************************************************/
+enum proc_t { PROC_ATTACH = 0, PROC_RELEASE, PROC_SERVICE_REQUEST, PROC_PAGING, PROC_DETACH, PROC_NOF };
+
+static const char* proc_names[PROC_NOF] = {"Attach", "Release", "Service Req", "Paging", "Detach"};
+
+struct proc_stats_t {
+  std::vector<uint32_t> latency_us;
+  uint32_t              nof_failures = 0;
+};
+
+static std::atomic<bool> running{true};
+
+static void sig_int_handler(int signo)
+{
+  running = false;
+}
+
+/**********************************************************************
+ *  Emulated eNBs and UEs
+ ***********************************************************************/
+struct emu_enb;
+
+enum class ue_state_t {
+  deregistered,
+  wait_auth_request,
+  wait_security_mode_command,
+  wait_attach_accept,
+  wait_emm_information,
+  wait_release_command,
+  idle,
+  wait_paging,
+  wait_service_setup,
+  wait_detach_release,
+  done
+};
+
+struct emu_ue {
+  uint32_t   idx        = 0;
+  uint64_t   imsi       = 0;
+  emu_enb*   enb        = nullptr;
+  ue_state_t state      = ue_state_t::deregistered;
+  uint32_t   nof_cycles = 0;
+
+  // Current procedure
+  proc_t                 proc = PROC_ATTACH;
+  load_clock::time_point proc_start;
+  load_clock::time_point last_paging_trigger;
+  bool                   sr_done     = false;
+  bool                   paging_done = false;
+
+  // S1AP context
+  bool     connected      = false;
+  uint32_t enb_ue_s1ap_id = 0;
+  uint32_t mme_ue_s1ap_id = 0;
+
+  // NAS context
+  uint8_t                               ksi      = 0;
+  uint32_t                              tx_count = 0;
+  uint8_t                               k_asme[32];
+  uint8_t                               k_nas_enc[32];
+  uint8_t                               k_nas_int[32];
+  CIPHERING_ALGORITHM_ID_ENUM           cipher_algo = CIPHERING_ALGORITHM_ID_EEA0;
+  INTEGRITY_ALGORITHM_ID_ENUM           integ_algo  = INTEGRITY_ALGORITHM_ID_EIA0;
+  LIBLTE_MME_EPS_MOBILE_ID_GUTI_STRUCT guti        = {};
+  uint32_t                              ip_addr     = 0;
+};
+
+struct emu_enb {
+  uint32_t                              enb_id = 0;
+  unique_socket                         socket;
+  sockaddr_in                           mme_addr      = {};
+  bool                                  s1_setup_done = false;
+  uint32_t                              next_ue_id    = 1;
+  std::unordered_map<uint32_t, emu_ue*> ues;
+};
+
+class mme_load_test
+{
+public:
+  explicit mme_load_test(const load_args_t& args_) : args(args_) {}
+  ~mme_load_test();
+
+  bool init();
+  void run();
+  void print_stats();
+
+private:
+  // S1AP
+  bool send_s1ap_pdu(emu_enb* enb, const s1ap_pdu_c& tx_pdu);
+  bool send_s1_setup_request(emu_enb* enb);
+  bool send_initial_ue_message(emu_ue* ue, const LIBLTE_BYTE_MSG_STRUCT& nas, bool has_tmsi);
+  bool send_ul_nas_transport(emu_ue* ue, const LIBLTE_BYTE_MSG_STRUCT& nas);
+  bool send_ue_context_release_request(emu_ue* ue);
+  bool send_ue_context_release_complete(emu_ue* ue);
+  bool send_initial_context_setup_response(emu_ue* ue);
+  void handle_enb_rx(emu_enb* enb);
+  void handle_s1ap_pdu(emu_enb* enb, const s1ap_pdu_c& pdu);
+  void handle_dl_nas_transport(emu_ue* ue, const dl_nas_transport_s& msg);
+  void handle_initial_context_setup_request(emu_ue* ue, const init_context_setup_request_s& msg);
+  void handle_ue_context_release_command(emu_ue* ue);
+  void handle_paging(const paging_s& msg);
+  emu_ue* find_ue(emu_enb* enb, uint32_t enb_ue_s1ap_id);
+
+  // NAS
+  void integrity_generate(emu_ue* ue, uint32_t count, uint8_t* msg, uint32_t msg_len, uint8_t* mac);
+  void cipher(emu_ue* ue, uint8_t direction, LIBLTE_BYTE_MSG_STRUCT* msg);
+  void apply_security(emu_ue* ue, uint8_t sec_hdr_type, LIBLTE_BYTE_MSG_STRUCT* msg);
+  void handle_authentication_request(emu_ue* ue, LIBLTE_BYTE_MSG_STRUCT* msg);
+  void handle_security_mode_command(emu_ue* ue, LIBLTE_BYTE_MSG_STRUCT* msg);
+  bool handle_attach_accept(emu_ue* ue, LIBLTE_BYTE_MSG_STRUCT* msg);
+
+  // Procedures
+  void connect_ue(emu_ue* ue);
+  void disconnect_ue(emu_ue* ue);
+  void start_attach(emu_ue* ue);
+  void start_release(emu_ue* ue);
+  void start_service_request(emu_ue* ue);
+  void start_paging(emu_ue* ue);
+  void start_detach(emu_ue* ue);
+  void send_paging_trigger(emu_ue* ue);
+  void complete_proc(emu_ue* ue);
+  void fail_proc(emu_ue* ue, const char* reason);
+  void next_cycle(emu_ue* ue);
+  void handle_tick();
+
+  load_args_t                           args;
+  srslog::basic_logger&                 logger = srslog::fetch_basic_logger("LOAD");
+  std::vector<std::unique_ptr<emu_enb>> enbs;
+  std::vector<emu_ue>                   ues;
+  std::unordered_map<uint32_t, emu_ue*> m_tmsi_to_ue;
+  int                                   epoll_fd    = -1;
+  int                                   paging_fd   = -1;
+  uint32_t                              nof_setup   = 0;
+  uint32_t                              nof_started = 0;
+  uint32_t                              nof_done    = 0;
+  load_clock::time_point                tstart;
+  load_clock::time_point                tend;
+  proc_stats_t                          stats[PROC_NOF];
+  uint8_t                               tx_buf[SRSRAN_MAX_BUFFER_SIZE_BYTES];
+  uint8_t                               rx_buf[SRSRAN_MAX_BUFFER_SIZE_BYTES];
+  LIBLTE_BYTE_MSG_STRUCT                nas_buf;
+  LIBLTE_BYTE_MSG_STRUCT                nas_tmp;
+};
+
+mme_load_test::~mme_load_test()
+{
+  if (epoll_fd >= 0) {
+    close(epoll_fd);
+  }
+  if (paging_fd >= 0) {
+    close(paging_fd);
+  }
+}
+
+bool mme_load_test::init()
+{
+  epoll_fd = epoll_create1(0);
+  if (epoll_fd < 0) {
+    perror("epoll_create1");
+    return false;
+  }
+  paging_fd = socket(AF_INET, SOCK_DGRAM, 0);
+  if (paging_fd < 0) {
+    perror("socket");
+    return false;
+  }
+
+  for (uint32_t i = 0; i < args.nof_enbs; i++) {
+    std::unique_ptr<emu_enb> enb(new emu_enb);
+    enb->enb_id = args.enb_id + i;
+    if (not net_utils::sctp_init_client(&enb->socket, net_utils::socket_type::seqpacket, args.enb_bind_addr.c_str())) {
+      return false;
+    }
+    if (not enb->socket.connect_to(args.mme_addr.c_str(), S1AP_PORT, &enb->mme_addr)) {
+      return false;
+    }
+    struct epoll_event event = {};
+    event.events             = EPOLLIN;
+    event.data.ptr           = enb.get();
+    if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, enb->socket.fd(), &event) < 0) {
+      perror("epoll_ctl");
+      return false;
+    }
+    enbs.push_back(std::move(enb));
+  }
+
+  ues.resize(args.nof_ues);
+  for (uint32_t i = 0; i < args.nof_ues; i++) {
+    ues[i].idx  = i;
+    ues[i].imsi = args.imsi + i;
+    ues[i].enb  = enbs[i % enbs.size()].get();
+  }
+
+  for (std::unique_ptr<emu_enb>& enb : enbs) {
+    if (not send_s1_setup_request(enb.get())) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void mme_load_test::run()
+{
+  const uint32_t     max_events = 64;
+  struct epoll_event events[max_events];
+
+  load_clock::time_point last_tick = load_clock::now();
+  while (running and nof_done < ues.size()) {
+    int nof_events = epoll_wait(epoll_fd, events, max_events, 10);
+    if (nof_events < 0 and errno != EINTR) {
+      perror("epoll_wait");
+      break;
+    }
+    for (int i = 0; i < nof_events; i++) {
+      handle_enb_rx((emu_enb*)events[i].data.ptr);
+    }
+    if (load_clock::now() - last_tick >= std::chrono::milliseconds(10)) {
+      last_tick = load_clock::now();
+      handle_tick();
+    }
+  }
+  tend = load_clock::now();
+}
+
+void mme_load_test::print_stats()
+{
+  double duration_s = std::chrono::duration_cast<std::chrono::microseconds>(tend - tstart).count() / 1e6;
+  if (nof_setup < enbs.size() or duration_s <= 0) {
+    printf("S1 Setup did not complete for all eNBs\n");
+    return;
+  }
+
+  printf("\n%d eNBs, %d UEs, %d cycles, %.3f s\n", (int)enbs.size(), (int)ues.size(), args.nof_cycles, duration_s);
+  printf("%-12s %8s %6s %10s %10s %10s %10s %10s\n", "Procedure", "Count", "Fail", "Proc/s", "p50 [ms]", "p90 [ms]",
+         "p99 [ms]", "max [ms]");
+  uint32_t nof_total = 0;
+  for (uint32_t p = 0; p < PROC_NOF; p++) {
+    std::vector<uint32_t>& lat = stats[p].latency_us;
+    if (lat.empty() and stats[p].nof_failures == 0) {
+      continue;
+    }
+    nof_total += lat.size();
+    std::sort(lat.begin(), lat.end());
+    auto percentile = [&lat](uint32_t pct) {
+      return lat.empty() ? 0.0 : lat[std::min<size_t>(lat.size() - 1, lat.size() * pct / 100)] / 1000.0;
+    };
+    printf("%-12s %8d %6d %10.1f %10.2f %10.2f %10.2f %10.2f\n",
+           proc_names[p],
+           (int)lat.size(),
+           stats[p].nof_failures,
+           lat.size() / duration_s,
+           percentile(50),
+           percentile(90),
+           percentile(99),
+           lat.empty() ? 0.0 : lat.back() / 1000.0);
+  }
+  printf("%-12s %8d %6s %10.1f\n", "Total", nof_total, "", nof_total / duration_s);
+}
+
+/**********************************************************************
+ *  S1AP
+ ***********************************************************************/
+bool mme_load_test::send_s1ap_pdu(emu_enb* enb, const s1ap_pdu_c& tx_pdu)
+{
+  asn1::bit_ref bref(tx_buf, sizeof(tx_buf));
+  if (tx_pdu.pack(bref) != asn1::SRSASN_SUCCESS) {
+    logger.error("Failed to pack S1AP PDU");
+    return false;
+  }
+  ssize_t n_sent = sctp_sendmsg(enb->socket.fd(),
+                                tx_buf,
+                                bref.distance_bytes(),
+                                (struct sockaddr*)&enb->mme_addr,
+                                sizeof(struct sockaddr_in),
+                                htonl(S1AP_PPID),
+                                0,
+                                0,
+                                0,
+                                0);
+  if (n_sent == -1) {
+    logger.error("Failed to send S1AP PDU on eNB 0x%x: %s", enb->enb_id, strerror(errno));
+    return false;
+  }
+  return true;
+}
+
+bool mme_load_test::send_s1_setup_request(emu_enb* enb)
+{
+  uint32_t plmn;
+  s1ap_mccmnc_to_plmn(args.mcc, args.mnc, &plmn);
+
+  s1ap_pdu_c pdu;
+  pdu.set_init_msg().load_info_obj(ASN1_S1AP_ID_S1_SETUP);
+  s1_setup_request_ies_container& container = pdu.init_msg().value.s1_setup_request().protocol_ies;
+  container.global_enb_id.value.plm_nid.from_number(plmn);
+  container.global_enb_id.value.enb_id.set_macro_enb_id().from_number(enb->enb_id);
+
+  container.supported_tas.value.resize(1);
+  container.supported_tas.value[0].tac.from_number(args.tac);
+  container.supported_tas.value[0].broadcast_plmns.resize(1);
+  container.supported_tas.value[0].broadcast_plmns[0].from_number(plmn);
+
+  container.default_paging_drx.value.value = paging_drx_opts::v128;
+  return send_s1ap_pdu(enb, pdu);
+}
+
+bool mme_load_test::send_initial_ue_message(emu_ue* ue, const LIBLTE_BYTE_MSG_STRUCT& nas, bool has_tmsi)
+{
+  uint32_t plmn;
+  s1ap_mccmnc_to_plmn(args.mcc, args.mnc, &plmn);
+
+  s1ap_pdu_c pdu;
+  pdu.set_init_msg().load_info_obj(ASN1_S1AP_ID_INIT_UE_MSG);
+  init_ue_msg_ies_container& container = pdu.init_msg().value.init_ue_msg().protocol_ies;
+  if (has_tmsi) {
+    container.s_tmsi_present = true;
+    uint32_to_uint8(ue->guti.m_tmsi, container.s_tmsi.value.m_tmsi.data());
+    container.s_tmsi.value.mmec[0] = ue->guti.mme_code;
+  }
+  container.enb_ue_s1ap_id.value = ue->enb_ue_s1ap_id;
+  container.nas_pdu.value.resize(nas.N_bytes);
+  memcpy(container.nas_pdu.value.data(), nas.msg, nas.N_bytes);
+  container.tai.value.plm_nid.from_number(plmn);
+  container.tai.value.tac.from_number(args.tac);
+  container.eutran_cgi.value.plm_nid.from_number(plmn);
+  container.eutran_cgi.value.cell_id.from_number((ue->enb->enb_id << 8u) | 1u);
+  container.rrc_establishment_cause.value =
+      ue->proc == PROC_PAGING ? rrc_establishment_cause_opts::mt_access : rrc_establishment_cause_opts::mo_sig;
+  return send_s1ap_pdu(ue->enb, pdu);
+}
+
+bool mme_load_test::send_ul_nas_transport(emu_ue* ue, const LIBLTE_BYTE_MSG_STRUCT& nas)
+{
+  uint32_t plmn;
+  s1ap_mccmnc_to_plmn(args.mcc, args.mnc, &plmn);
+
+  s1ap_pdu_c pdu;
+  pdu.set_init_msg().load_info_obj(ASN1_S1AP_ID_UL_NAS_TRANSPORT);
+  ul_nas_transport_ies_container& container = pdu.init_msg().value.ul_nas_transport().protocol_ies;
+  container.mme_ue_s1ap_id.value            = ue->mme_ue_s1ap_id;
+  container.enb_ue_s1ap_id.value            = ue->enb_ue_s1ap_id;
+  container.nas_pdu.value.resize(nas.N_bytes);
+  memcpy(container.nas_pdu.value.data(), nas.msg, nas.N_bytes);
+  container.eutran_cgi.value.plm_nid.from_number(plmn);
+  container.eutran_cgi.value.cell_id.from_number((ue->enb->enb_id << 8u) | 1u);
+  container.tai.value.plm_nid.from_number(plmn);
+  container.tai.value.tac.from_number(args.tac);
+  return send_s1ap_pdu(ue->enb, pdu);
+}
+
+bool mme_load_test::send_ue_context_release_request(emu_ue* ue)
+{
+  s1ap_pdu_c pdu;
+  pdu.set_init_msg().load_info_obj(ASN1_S1AP_ID_UE_CONTEXT_RELEASE_REQUEST);
+  ue_context_release_request_ies_container& container =
+      pdu.init_msg().value.ue_context_release_request().protocol_ies;
+  container.mme_ue_s1ap_id.value = ue->mme_ue_s1ap_id;
+  container.enb_ue_s1ap_id.value = ue->enb_ue_s1ap_id;
+  container.cause.value.set_radio_network().value = cause_radio_network_opts::user_inactivity;
+  return send_s1ap_pdu(ue->enb, pdu);
+}
+
+bool mme_load_test::send_ue_context_release_complete(emu_ue* ue)
+{
+  s1ap_pdu_c pdu;
+  pdu.set_successful_outcome().load_info_obj(ASN1_S1AP_ID_UE_CONTEXT_RELEASE);
+  auto& container                = pdu.successful_outcome().value.ue_context_release_complete().protocol_ies;
+  container.mme_ue_s1ap_id.value = ue->mme_ue_s1ap_id;
+  container.enb_ue_s1ap_id.value = ue->enb_ue_s1ap_id;
+  return send_s1ap_pdu(ue->enb, pdu);
+}
+
+bool mme_load_test::send_initial_context_setup_response(emu_ue* ue)
+{
+  s1ap_pdu_c pdu;
+  pdu.set_successful_outcome().load_info_obj(ASN1_S1AP_ID_INIT_CONTEXT_SETUP);
+  auto& container                = pdu.successful_outcome().value.init_context_setup_resp().protocol_ies;
+  container.mme_ue_s1ap_id.value = ue->mme_ue_s1ap_id;
+  container.enb_ue_s1ap_id.value = ue->enb_ue_s1ap_id;
+
+  container.erab_setup_list_ctxt_su_res.value.resize(1);
+  container.erab_setup_list_ctxt_su_res.value[0].load_info_obj(ASN1_S1AP_ID_ERAB_SETUP_ITEM_CTXT_SU_RES);
+  auto& item   = container.erab_setup_list_ctxt_su_res.value[0].value.erab_setup_item_ctxt_su_res();
+  item.erab_id = 5;
+  item.transport_layer_address.resize(32);
+  uint8_t addr[4] = {};
+  inet_pton(AF_INET, args.enb_bind_addr.c_str(), addr);
+  for (uint32_t j = 0; j < 4; ++j) {
+    item.transport_layer_address.data()[j] = addr[3 - j];
+  }
+  item.gtp_teid.from_number(ue->idx + 1);
+  return send_s1ap_pdu(ue->enb, pdu);
+}
+
+void mme_load_test::handle_enb_rx(emu_enb* enb)
+{
+  struct sctp_sndrcvinfo sri   = {};
+  int                    flags = 0;
+  ssize_t n = sctp_recvmsg(enb->socket.fd(), rx_buf, sizeof(rx_buf), nullptr, nullptr, &sri, &flags);
+  if (n <= 0) {
+    logger.error("Lost the SCTP association of eNB 0x%x", enb->enb_id);
+    running = false;
+    return;
+  }
+  if (flags & MSG_NOTIFICATION) {
+    union sctp_notification* notification = (union sctp_notification*)rx_buf;
+    if (notification->sn_header.sn_type == SCTP_SHUTDOWN_EVENT) {
+      logger.error("MME closed the SCTP association of eNB 0x%x", enb->enb_id);
+      running = false;
+    }
+    return;
+  }
+
+  s1ap_pdu_c     pdu;
+  asn1::cbit_ref bref(rx_buf, n);
+  if (pdu.unpack(bref) != asn1::SRSASN_SUCCESS) {
+    logger.error("Failed to unpack S1AP PDU");
+    return;
+  }
+  handle_s1ap_pdu(enb, pdu);
+}
+
+emu_ue* mme_load_test::find_ue(emu_enb* enb, uint32_t enb_ue_s1ap_id)
+{
+  auto it = enb->ues.find(enb_ue_s1ap_id);
+  if (it == enb->ues.end()) {
+    logger.warning("Unknown eNB-UE S1AP id %d in eNB 0x%x", enb_ue_s1ap_id, enb->enb_id);
+    return nullptr;
+  }
+  return it->second;
+}
+
+void mme_load_test::handle_s1ap_pdu(emu_enb* enb, const s1ap_pdu_c& pdu)
+{
+  emu_ue* ue = nullptr;
+  switch (pdu.type().value) {
+    case s1ap_pdu_c::types_opts::init_msg: {
+      const s1ap_elem_procs_o::init_msg_c& msg = pdu.init_msg().value;
+      switch (msg.type().value) {
+        case s1ap_elem_procs_o::init_msg_c::types_opts::dl_nas_transport:
+          ue = find_ue(enb, msg.dl_nas_transport().protocol_ies.enb_ue_s1ap_id.value.value);
+          if (ue != nullptr) {
+            handle_dl_nas_transport(ue, msg.dl_nas_transport());
+          }
+          break;
+        case s1ap_elem_procs_o::init_msg_c::types_opts::init_context_setup_request:
+          ue = find_ue(enb, msg.init_context_setup_request().protocol_ies.enb_ue_s1ap_id.value.value);
+          if (ue != nullptr) {
+            handle_initial_context_setup_request(ue, msg.init_context_setup_request());
+          }
+          break;
+        case s1ap_elem_procs_o::init_msg_c::types_opts::ue_context_release_cmd: {
+          const ue_s1ap_ids_c& ids = msg.ue_context_release_cmd().protocol_ies.ue_s1ap_ids.value;
+          if (ids.type().value == ue_s1ap_ids_c::types_opts::ue_s1ap_id_pair) {
+            ue = find_ue(enb, ids.ue_s1ap_id_pair().enb_ue_s1ap_id);
+          } else {
+            for (auto& it : enb->ues) {
+              if (it.second->mme_ue_s1ap_id == ids.mme_ue_s1ap_id()) {
+                ue = it.second;
+              }
+            }
+          }
+          if (ue != nullptr) {
+            handle_ue_context_release_command(ue);
+          }
+        } break;
+        case s1ap_elem_procs_o::init_msg_c::types_opts::paging:
+          handle_paging(msg.paging());
+          break;
+        default:
+          logger.info("Ignoring S1AP %s", msg.type().to_string());
+      }
+    } break;
+    case s1ap_pdu_c::types_opts::successful_outcome:
+      if (pdu.successful_outcome().value.type().value ==
+          s1ap_elem_procs_o::successful_outcome_c::types_opts::s1_setup_resp) {
+        enb->s1_setup_done = true;
+        if (++nof_setup == enbs.size()) {
+          printf("S1 Setup complete for %d eNBs, starting %d UEs\n", (int)enbs.size(), (int)ues.size());
+          tstart = load_clock::now();
+        }
+      }
+      break;
+    case s1ap_pdu_c::types_opts::unsuccessful_outcome:
+      if (pdu.unsuccessful_outcome().value.type().value ==
+          s1ap_elem_procs_o::unsuccessful_outcome_c::types_opts::s1_setup_fail) {
+        printf("S1 Setup rejected for eNB 0x%x\n", enb->enb_id);
+        running = false;
+      }
+      break;
+    default:
+      break;
+  }
+}
+
+void mme_load_test::handle_dl_nas_transport(emu_ue* ue, const dl_nas_transport_s& msg)
+{
+  ue->mme_ue_s1ap_id = msg.protocol_ies.mme_ue_s1ap_id.value.value;
+
+  const asn1::unbounded_octstring<true>& pdu = msg.protocol_ies.nas_pdu.value;
+  if (pdu.size() > sizeof(nas_buf.msg)) {
+    fail_proc(ue, "NAS PDU too large");
+    return;
+  }
+  memcpy(nas_buf.msg, pdu.data(), pdu.size());
+  nas_buf.N_bytes = pdu.size();
+
+  uint8_t pd, sec_hdr_type, msg_type;
+  liblte_mme_parse_msg_sec_header(&nas_buf, &pd, &sec_hdr_type);
+  if (sec_hdr_type == LIBLTE_MME_SECURITY_HDR_TYPE_INTEGRITY_AND_CIPHERED) {
+    cipher(ue, SECURITY_DIRECTION_DOWNLINK, &nas_buf);
+  }
+  liblte_mme_parse_msg_header(&nas_buf, &pd, &msg_type);
+
+  switch (msg_type) {
+    case LIBLTE_MME_MSG_TYPE_AUTHENTICATION_REQUEST:
+      if (ue->state == ue_state_t::wait_auth_request) {
+        handle_authentication_request(ue, &nas_buf);
+        return;
+      }
+      break;
+    case LIBLTE_MME_MSG_TYPE_SECURITY_MODE_COMMAND:
+      if (ue->state == ue_state_t::wait_security_mode_command) {
+        handle_security_mode_command(ue, &nas_buf);
+        return;
+      }
+      break;
+    case LIBLTE_MME_MSG_TYPE_EMM_INFORMATION:
+      if (ue->state == ue_state_t::wait_emm_information) {
+        complete_proc(ue);
+        start_release(ue);
+        return;
+      }
+      break;
+    case LIBLTE_MME_MSG_TYPE_ATTACH_REJECT:
+    case LIBLTE_MME_MSG_TYPE_AUTHENTICATION_REJECT:
+    case LIBLTE_MME_MSG_TYPE_SERVICE_REJECT:
+      fail_proc(ue, liblte_nas_msg_type_to_string(msg_type));
+      return;
+    default:
+      break;
+  }
+  logger.info("IMSI %015" PRIu64 " ignoring DL NAS %s", ue->imsi, liblte_nas_msg_type_to_string(msg_type));
+}
+
+void mme_load_test::handle_initial_context_setup_request(emu_ue* ue, const init_context_setup_request_s& msg)
+{
+  ue->mme_ue_s1ap_id = msg.protocol_ies.mme_ue_s1ap_id.value.value;
+
+  if (ue->state == ue_state_t::wait_attach_accept) {
+    const auto& erab_list = msg.protocol_ies.erab_to_be_setup_list_ctxt_su_req.value;
+    if (erab_list.size() == 0 or not erab_list[0].value.erab_to_be_setup_item_ctxt_su_req().nas_pdu_present) {
+      fail_proc(ue, "Initial Context Setup Request without Attach Accept");
+      return;
+    }
+    const asn1::unbounded_octstring<true>& pdu = erab_list[0].value.erab_to_be_setup_item_ctxt_su_req().nas_pdu;
+    if (pdu.size() > sizeof(nas_buf.msg)) {
+      fail_proc(ue, "NAS PDU too large");
+      return;
+    }
+    memcpy(nas_buf.msg, pdu.data(), pdu.size());
+    nas_buf.N_bytes = pdu.size();
+    if (not handle_attach_accept(ue, &nas_buf)) {
+      fail_proc(ue, "Invalid Attach Accept");
+    }
+  } else if (ue->state == ue_state_t::wait_service_setup) {
+    send_initial_context_setup_response(ue);
+    bool paged = ue->proc == PROC_PAGING;
+    complete_proc(ue);
+    if (paged) {
+      ue->paging_done = true;
+    } else {
+      ue->sr_done = true;
+    }
+    if (args.paging and not ue->paging_done) {
+      start_release(ue);
+    } else {
+      start_detach(ue);
+    }
+  } else {
+    fail_proc(ue, "Unexpected Initial Context Setup Request");
+  }
+}
+
+void mme_load_test::handle_ue_context_release_command(emu_ue* ue)
+{
+  send_ue_context_release_complete(ue);
+  disconnect_ue(ue);
+
+  if (ue->state == ue_state_t::wait_release_command) {
+    complete_proc(ue);
+    ue->state = ue_state_t::idle;
+    if (not ue->sr_done) {
+      start_service_request(ue);
+    } else {
+      start_paging(ue);
+    }
+  } else if (ue->state == ue_state_t::wait_detach_release) {
+    complete_proc(ue);
+    next_cycle(ue);
+  } else {
+    fail_proc(ue, "Unexpected UE Context Release Command");
+  }
+}
+
+void mme_load_test::handle_paging(const paging_s& msg)
+{
+  if (msg.protocol_ies.ue_paging_id.value.type().value != ue_paging_id_c::types_opts::s_tmsi) {
+    return;
+  }
+  auto it = m_tmsi_to_ue.find(msg.protocol_ies.ue_paging_id.value.s_tmsi().m_tmsi.to_number());
+  if (it == m_tmsi_to_ue.end()) {
+    return;
+  }
+  // The MME pages through every eNB, only answer the first one
+  emu_ue* ue = it->second;
+  if (ue->state == ue_state_t::wait_paging) {
+    start_service_request(ue);
+  }
+}
+
+/**********************************************************************
+ *  NAS
+ ***********************************************************************/
+void mme_load_test::integrity_generate(emu_ue* ue, uint32_t count, uint8_t* msg, uint32_t msg_len, uint8_t* mac)
+{
+  switch (ue->integ_algo) {
+    case INTEGRITY_ALGORITHM_ID_128_EIA1:
+      security_128_eia1(&ue->k_nas_int[16], count, 0, SECURITY_DIRECTION_UPLINK, msg, msg_len, mac);
+      break;
+    case INTEGRITY_ALGORITHM_ID_128_EIA2:
+      security_128_eia2(&ue->k_nas_int[16], count, 0, SECURITY_DIRECTION_UPLINK, msg, msg_len, mac);
+      break;
+    case INTEGRITY_ALGORITHM_ID_128_EIA3:
+      security_128_eia3(&ue->k_nas_int[16], count, 0, SECURITY_DIRECTION_UPLINK, msg, msg_len, mac);
+      break;
+    default:
+      break;
+  }
+}
+
+void mme_load_test::cipher(emu_ue* ue, uint8_t direction, LIBLTE_BYTE_MSG_STRUCT* msg)
+{
+  if (msg->N_bytes <= 6) {
+    return;
+  }
+  uint8_t* key = &ue->k_nas_enc[16];
+  uint32_t len = msg->N_bytes - 6;
+  switch (ue->cipher_algo) {
+    case CIPHERING_ALGORITHM_ID_128_EEA1:
+      security_128_eea1(key, msg->msg[5], 0, direction, &msg->msg[6], len, &nas_tmp.msg[6]);
+      break;
+    case CIPHERING_ALGORITHM_ID_128_EEA2:
+      security_128_eea2(key, msg->msg[5], 0, direction, &msg->msg[6], len, &nas_tmp.msg[6]);
+      break;
+    case CIPHERING_ALGORITHM_ID_128_EEA3:
+      security_128_eea3(key, msg->msg[5], 0, direction, &msg->msg[6], len, &nas_tmp.msg[6]);
+      break;
+    default:
+      return;
+  }
+  memcpy(&msg->msg[6], &nas_tmp.msg[6], len);
+}
+
+void mme_load_test::apply_security(emu_ue* ue, uint8_t sec_hdr_type, LIBLTE_BYTE_MSG_STRUCT* msg)
+{
+  if (sec_hdr_type == LIBLTE_MME_SECURITY_HDR_TYPE_INTEGRITY_AND_CIPHERED ||
+      sec_hdr_type == LIBLTE_MME_SECURITY_HDR_TYPE_INTEGRITY_AND_CIPHERED_WITH_NEW_EPS_SECURITY_CONTEXT) {
+    cipher(ue, SECURITY_DIRECTION_UPLINK, msg);
+  }
+  integrity_generate(ue, ue->tx_count, &msg->msg[5], msg->N_bytes - 5, &msg->msg[1]);
+  ue->tx_count++;
+}
+
+void mme_load_test::handle_authentication_request(emu_ue* ue, LIBLTE_BYTE_MSG_STRUCT* msg)
+{
+  LIBLTE_MME_AUTHENTICATION_REQUEST_MSG_STRUCT auth_req = {};
+  liblte_mme_unpack_authentication_request_msg(msg, &auth_req);
+  ue->ksi = auth_req.nas_ksi.nas_ksi;
+
+  // Milenage with the shared K/OPc. AUTN is not verified, the SQN is taken as sent by the HSS
+  uint8_t ck[16], ik[16], ak[6], sqn[6];
+  LIBLTE_MME_AUTHENTICATION_RESPONSE_MSG_STRUCT auth_resp = {};
+  security_milenage_f2345(args.k, args.opc, auth_req.rand, auth_resp.res, ck, ik, ak);
+  auth_resp.res_len = 8;
+  for (uint32_t i = 0; i < 6; i++) {
+    sqn[i] = auth_req.autn[i] ^ ak[i];
+  }
+  security_generate_k_asme(ck, ik, ak, sqn, args.mcc, args.mnc, ue->k_asme);
+
+  liblte_mme_pack_authentication_response_msg(&auth_resp, LIBLTE_MME_SECURITY_HDR_TYPE_PLAIN_NAS, 0, &nas_buf);
+  ue->state = ue_state_t::wait_security_mode_command;
+  send_ul_nas_transport(ue, nas_buf);
+}
+
+void mme_load_test::handle_security_mode_command(emu_ue* ue, LIBLTE_BYTE_MSG_STRUCT* msg)
+{
+  LIBLTE_MME_SECURITY_MODE_COMMAND_MSG_STRUCT sec_mode_cmd = {};
+  liblte_mme_unpack_security_mode_command_msg(msg, &sec_mode_cmd);
+  ue->cipher_algo = (CIPHERING_ALGORITHM_ID_ENUM)sec_mode_cmd.selected_nas_sec_algs.type_of_eea;
+  ue->integ_algo  = (INTEGRITY_ALGORITHM_ID_ENUM)sec_mode_cmd.selected_nas_sec_algs.type_of_eia;
+  security_generate_k_nas(ue->k_asme, ue->cipher_algo, ue->integ_algo, ue->k_nas_enc, ue->k_nas_int);
+
+  // The MME resets the NAS counts after a successful authentication
+  ue->tx_count = 0;
+
+  LIBLTE_MME_SECURITY_MODE_COMPLETE_MSG_STRUCT sec_mode_comp = {};
+  uint8_t sec_hdr_type = LIBLTE_MME_SECURITY_HDR_TYPE_INTEGRITY_AND_CIPHERED_WITH_NEW_EPS_SECURITY_CONTEXT;
+  liblte_mme_pack_security_mode_complete_msg(&sec_mode_comp, sec_hdr_type, ue->tx_count, &nas_buf);
+  apply_security(ue, sec_hdr_type, &nas_buf);
+  ue->state = ue_state_t::wait_attach_accept;
+  send_ul_nas_transport(ue, nas_buf);
+}
+
+bool mme_load_test::handle_attach_accept(emu_ue* ue, LIBLTE_BYTE_MSG_STRUCT* msg)
+{
+  uint8_t pd, sec_hdr_type;
+  liblte_mme_parse_msg_sec_header(msg, &pd, &sec_hdr_type);
+  if (sec_hdr_type == LIBLTE_MME_SECURITY_HDR_TYPE_INTEGRITY_AND_CIPHERED) {
+    cipher(ue, SECURITY_DIRECTION_DOWNLINK, msg);
+  }
+
+  LIBLTE_MME_ATTACH_ACCEPT_MSG_STRUCT attach_accept = {};
+  if (liblte_mme_unpack_attach_accept_msg(msg, &attach_accept) != LIBLTE_SUCCESS or not attach_accept.guti_present) {
+    return false;
+  }
+  LIBLTE_MME_ACTIVATE_DEFAULT_EPS_BEARER_CONTEXT_REQUEST_MSG_STRUCT act_def_eps_bearer_context_req = {};
+  if (liblte_mme_unpack_activate_default_eps_bearer_context_request_msg(&attach_accept.esm_msg,
+                                                                        &act_def_eps_bearer_context_req) !=
+      LIBLTE_SUCCESS) {
+    return false;
+  }
+
+  m_tmsi_to_ue.erase(ue->guti.m_tmsi);
+  ue->guti                      = attach_accept.guti.guti;
+  m_tmsi_to_ue[ue->guti.m_tmsi] = ue;
+  memcpy(&ue->ip_addr, act_def_eps_bearer_context_req.pdn_addr.addr, 4);
+
+  // The eNB answers the Initial Context Setup before relaying the Attach Complete
+  send_initial_context_setup_response(ue);
+
+  LIBLTE_MME_ATTACH_COMPLETE_MSG_STRUCT                            attach_complete                   = {};
+  LIBLTE_MME_ACTIVATE_DEFAULT_EPS_BEARER_CONTEXT_ACCEPT_MSG_STRUCT act_def_eps_bearer_context_accept = {};
+  act_def_eps_bearer_context_accept.eps_bearer_id       = act_def_eps_bearer_context_req.eps_bearer_id;
+  act_def_eps_bearer_context_accept.proc_transaction_id = act_def_eps_bearer_context_req.proc_transaction_id;
+  liblte_mme_pack_activate_default_eps_bearer_context_accept_msg(&act_def_eps_bearer_context_accept,
+                                                                 &attach_complete.esm_msg);
+  liblte_mme_pack_attach_complete_msg(
+      &attach_complete, LIBLTE_MME_SECURITY_HDR_TYPE_INTEGRITY_AND_CIPHERED, ue->tx_count, &nas_buf);
+  apply_security(ue, LIBLTE_MME_SECURITY_HDR_TYPE_INTEGRITY_AND_CIPHERED, &nas_buf);
+  ue->state = ue_state_t::wait_emm_information;
+  return send_ul_nas_transport(ue, nas_buf);
+}
+
+/**********************************************************************
+ *  Procedures
+ ***********************************************************************/
+void mme_load_test::connect_ue(emu_ue* ue)
+{
+  emu_enb* enb       = ue->enb;
+  ue->enb_ue_s1ap_id = enb->next_ue_id;
+  ue->mme_ue_s1ap_id = 0;
+  ue->connected      = true;
+  enb->next_ue_id    = (enb->next_ue_id + 1) % (1u << 24u);
+  enb->ues[ue->enb_ue_s1ap_id] = ue;
+}
+
+void mme_load_test::disconnect_ue(emu_ue* ue)
+{
+  if (ue->connected) {
+    ue->enb->ues.erase(ue->enb_ue_s1ap_id);
+    ue->connected = false;
+  }
+}
+
+void mme_load_test::start_attach(emu_ue* ue)
+{
+  ue->proc        = PROC_ATTACH;
+  ue->proc_start  = load_clock::now();
+  ue->sr_done     = false;
+  ue->paging_done = false;
+  connect_ue(ue);
+
+  LIBLTE_MME_ATTACH_REQUEST_MSG_STRUCT attach_req = {};
+  attach_req.eps_attach_type                      = LIBLTE_MME_EPS_ATTACH_TYPE_EPS_ATTACH;
+  for (uint32_t i = 0; i < 4; i++) {
+    attach_req.ue_network_cap.eea[i] = true;
+    attach_req.ue_network_cap.eia[i] = i > 0;
+  }
+  attach_req.eps_mobile_id.type_of_id = LIBLTE_MME_EPS_MOBILE_ID_TYPE_IMSI;
+  uint64_t imsi                       = ue->imsi;
+  for (int i = 14; i >= 0; i--) {
+    attach_req.eps_mobile_id.imsi[i] = imsi % 10;
+    imsi /= 10;
+  }
+  attach_req.nas_ksi.tsc_flag = LIBLTE_MME_TYPE_OF_SECURITY_CONTEXT_FLAG_NATIVE;
+  attach_req.nas_ksi.nas_ksi  = LIBLTE_MME_NAS_KEY_SET_IDENTIFIER_NO_KEY_AVAILABLE;
+
+  LIBLTE_MME_PDN_CONNECTIVITY_REQUEST_MSG_STRUCT pdn_con_req = {};
+  pdn_con_req.eps_bearer_id                                  = 0x00;
+  pdn_con_req.proc_transaction_id                            = 0x01;
+  pdn_con_req.request_type                                   = LIBLTE_MME_REQUEST_TYPE_INITIAL_REQUEST;
+  pdn_con_req.pdn_type                                       = LIBLTE_MME_PDN_TYPE_IPV4;
+  liblte_mme_pack_pdn_connectivity_request_msg(&pdn_con_req, &attach_req.esm_msg);
+  liblte_mme_pack_attach_request_msg(&attach_req, &nas_buf);
+
+  ue->state = ue_state_t::wait_auth_request;
+  send_initial_ue_message(ue, nas_buf, false);
+}
+
+void mme_load_test::start_release(emu_ue* ue)
+{
+  ue->proc       = PROC_RELEASE;
+  ue->proc_start = load_clock::now();
+  ue->state      = ue_state_t::wait_release_command;
+  send_ue_context_release_request(ue);
+}
+
+void mme_load_test::start_service_request(emu_ue* ue)
+{
+  if (ue->state == ue_state_t::idle) {
+    ue->proc       = PROC_SERVICE_REQUEST;
+    ue->proc_start = load_clock::now();
+  }
+  connect_ue(ue);
+
+  // Service Request with short MAC, see 24.301 section 8.2.25
+  nas_buf.msg[0] = (LIBLTE_MME_SECURITY_HDR_TYPE_SERVICE_REQUEST << 4u) | LIBLTE_MME_PD_EPS_MOBILITY_MANAGEMENT;
+  nas_buf.msg[1] = ((ue->ksi & 0x07u) << 5u) | (ue->tx_count & 0x1fu);
+  uint8_t mac[4] = {};
+  integrity_generate(ue, ue->tx_count, &nas_buf.msg[0], 2, mac);
+  nas_buf.msg[2]  = mac[2];
+  nas_buf.msg[3]  = mac[3];
+  nas_buf.N_bytes = 4;
+  ue->tx_count++;
+
+  ue->state = ue_state_t::wait_service_setup;
+  send_initial_ue_message(ue, nas_buf, true);
+}
+
+void mme_load_test::start_paging(emu_ue* ue)
+{
+  ue->proc       = PROC_PAGING;
+  ue->proc_start = load_clock::now();
+  ue->state      = ue_state_t::wait_paging;
+  send_paging_trigger(ue);
+}
+
+void mme_load_test::send_paging_trigger(emu_ue* ue)
+{
+  // Downlink data for an idle UE makes the SPGW send a Downlink Data Notification, and the MME page the UE
+  struct sockaddr_in addr = {};
+  addr.sin_family         = AF_INET;
+  addr.sin_port           = htons(9);
+  addr.sin_addr.s_addr    = ue->ip_addr;
+  uint8_t payload[8]      = {};
+  if (sendto(paging_fd, payload, sizeof(payload), 0, (struct sockaddr*)&addr, sizeof(addr)) < 0) {
+    logger.warning("Failed to send paging trigger to IMSI %015" PRIu64 ": %s", ue->imsi, strerror(errno));
+  }
+  ue->last_paging_trigger = load_clock::now();
+}
+
+void mme_load_test::start_detach(emu_ue* ue)
+{
+  ue->proc       = PROC_DETACH;
+  ue->proc_start = load_clock::now();
+
+  LIBLTE_MME_DETACH_REQUEST_MSG_STRUCT detach_req = {};
+  detach_req.detach_type.switch_off               = LIBLTE_MME_SO_FLAG_SWITCH_OFF;
+  detach_req.detach_type.type_of_detach           = LIBLTE_MME_TOD_UL_EPS_DETACH;
+  detach_req.nas_ksi.tsc_flag                     = LIBLTE_MME_TYPE_OF_SECURITY_CONTEXT_FLAG_NATIVE;
+  detach_req.nas_ksi.nas_ksi                      = ue->ksi;
+  detach_req.eps_mobile_id.type_of_id             = LIBLTE_MME_EPS_MOBILE_ID_TYPE_GUTI;
+  detach_req.eps_mobile_id.guti                   = ue->guti;
+  liblte_mme_pack_detach_request_msg(&detach_req, LIBLTE_MME_SECURITY_HDR_TYPE_INTEGRITY, ue->tx_count, &nas_buf);
+  apply_security(ue, LIBLTE_MME_SECURITY_HDR_TYPE_INTEGRITY, &nas_buf);
+
+  ue->state = ue_state_t::wait_detach_release;
+  send_ul_nas_transport(ue, nas_buf);
+}
+
+void mme_load_test::complete_proc(emu_ue* ue)
+{
+  auto latency = std::chrono::duration_cast<std::chrono::microseconds>(load_clock::now() - ue->proc_start);
+  stats[ue->proc].latency_us.push_back(latency.count());
+}
+
+void mme_load_test::fail_proc(emu_ue* ue, const char* reason)
+{
+  if (ue->state == ue_state_t::deregistered or ue->state == ue_state_t::idle or ue->state == ue_state_t::done) {
+    logger.warning("IMSI %015" PRIu64 " received %s without an ongoing procedure", ue->imsi, reason);
+    return;
+  }
+  logger.warning("IMSI %015" PRIu64 " %s failed: %s", ue->imsi, proc_names[ue->proc], reason);
+  stats[ue->proc].nof_failures++;
+  disconnect_ue(ue);
+  next_cycle(ue);
+}
+
+void mme_load_test::next_cycle(emu_ue* ue)
+{
+  ue->state = ue_state_t::deregistered;
+  if (++ue->nof_cycles < args.nof_cycles and running) {
+    start_attach(ue);
+  } else {
+    ue->state = ue_state_t::done;
+    nof_done++;
+  }
+}
+
+void mme_load_test::handle_tick()
+{
+  if (nof_setup < enbs.size()) {
+    return;
+  }
+  load_clock::time_point now = load_clock::now();
+
+  // Start new UEs, either all at once or at the configured attach rate
+  uint32_t nof_to_start = ues.size();
+  if (args.attach_rate > 0) {
+    uint64_t elapsed_ms = std::chrono::duration_cast<std::chrono::milliseconds>(now - tstart).count();
+    nof_to_start        = std::min<uint64_t>(ues.size(), 1 + elapsed_ms * args.attach_rate / 1000);
+  }
+  for (; nof_started < nof_to_start; nof_started++) {
+    start_attach(&ues[nof_started]);
+  }
+
+  // Procedure timeouts and paging trigger retransmissions
+  for (emu_ue& ue : ues) {
+    if (ue.state == ue_state_t::deregistered or ue.state == ue_state_t::idle or ue.state == ue_state_t::done) {
+      continue;
+    }
+    if (now - ue.proc_start > std::chrono::milliseconds(args.timeout_ms)) {
+      fail_proc(&ue, "timeout");
+    } else if (ue.state == ue_state_t::wait_paging and
+               now - ue.last_paging_trigger > std::chrono::milliseconds(500)) {
+      // The SPGW may still be releasing the S1-U bearer when the first packet arrives
+      send_paging_trigger(&ue);
+    }
+  }
+}
+
+/**********************************************************************
+ *  In-process EPC
+ ***********************************************************************/
+/// Stands in for the SPGW on S11. Every session is accepted and given an IP, but no S1-U or SGi tunnel is set up.
+class s11_responder
+{
+public:
+  ~s11_responder() { stop(); }
+
+  bool start();
+  void stop();
+
+private:
+  void run_thread();
+  void handle_pdu(const gtpc_pdu& pdu);
+  void send_pdu(const gtpc_pdu& pdu);
+
+  int                                    fd       = -1;
+  sockaddr_un                            mme_addr = {};
+  std::thread                            thread;
+  std::atomic<bool>                      running{false};
+  uint32_t                               next_teid = 1;
+  std::unordered_map<uint32_t, uint32_t> sgw_to_mme_teid;
+};
+
+bool s11_responder::start()
+{
+  // Same abstract socket names as mme_gtpc and spgw::gtpc
+  char mme_addr_name[]  = "@mme_s11";
+  char spgw_addr_name[] = "@spgw_s11";
+
+  fd = socket(AF_UNIX, SOCK_DGRAM, 0);
+  if (fd < 0) {
+    perror("socket");
+    return false;
+  }
+  sockaddr_un spgw_addr = {};
+  spgw_addr.sun_family  = AF_UNIX;
+  snprintf(spgw_addr.sun_path, sizeof(spgw_addr.sun_path), "%s", spgw_addr_name);
+  spgw_addr.sun_path[0] = '\0';
+  if (bind(fd, (const sockaddr*)&spgw_addr, sizeof(spgw_addr)) < 0) {
+    perror("bind");
+    return false;
+  }
+  mme_addr.sun_family = AF_UNIX;
+  snprintf(mme_addr.sun_path, sizeof(mme_addr.sun_path), "%s", mme_addr_name);
+  mme_addr.sun_path[0] = '\0';
+
+  // Wake up periodically to check whether the responder has been stopped
+  struct timeval timeout = {0, 100000};
+  setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+
+  running = true;
+  thread  = std::thread([this]() { run_thread(); });
+  return true;
+}
+
+void s11_responder::stop()
+{
+  running = false;
+  if (thread.joinable()) {
+    thread.join();
+  }
+  if (fd >= 0) {
+    close(fd);
+    fd = -1;
+  }
+}
+
+void s11_responder::run_thread()
+{
+  gtpc_pdu pdu;
+  while (running) {
+    ssize_t n = recv(fd, &pdu, sizeof(pdu), 0);
+    if (n == sizeof(pdu)) {
+      handle_pdu(pdu);
+    }
+  }
+}
+
+void s11_responder::send_pdu(const gtpc_pdu& pdu)
+{
+  if (sendto(fd, &pdu, sizeof(pdu), 0, (const sockaddr*)&mme_addr, sizeof(mme_addr)) < 0) {
+    perror("sendto");
+  }
+}
+
+void s11_responder::handle_pdu(const gtpc_pdu& pdu)
+{
+  gtpc_pdu resp = {};
+  switch (pdu.header.type) {
+    case GTPC_MSG_TYPE_CREATE_SESSION_REQUEST: {
+      const gtpc_create_session_request& cs_req  = pdu.choice.create_session_request;
+      uint32_t                           teid    = next_teid++;
+      gtpc_create_session_response&      cs_resp = resp.choice.create_session_response;
+      sgw_to_mme_teid[teid]                      = cs_req.sender_f_teid.teid;
+
+      resp.header.teid_present                                   = true;
+      resp.header.teid                                           = cs_req.sender_f_teid.teid;
+      resp.header.type                                           = GTPC_MSG_TYPE_CREATE_SESSION_RESPONSE;
+      cs_resp.cause.cause_value                                  = GTPC_CAUSE_VALUE_REQUEST_ACCEPTED;
+      cs_resp.sender_f_teid.ipv4_present                         = true;
+      cs_resp.sender_f_teid.teid                                 = teid;
+      cs_resp.eps_bearer_context_created.ebi                     = 5;
+      cs_resp.eps_bearer_context_created.cause.cause_value       = GTPC_CAUSE_VALUE_REQUEST_ACCEPTED;
+      cs_resp.eps_bearer_context_created.s1_u_sgw_f_teid_present = true;
+      cs_resp.eps_bearer_context_created.s1_u_sgw_f_teid.ipv4    = htonl(INADDR_LOOPBACK);
+      cs_resp.eps_bearer_context_created.s1_u_sgw_f_teid.teid    = teid;
+      cs_resp.paa_present                                        = true;
+      cs_resp.paa.pdn_type                                       = GTPC_PDN_TYPE_IPV4;
+      cs_resp.paa.ipv4_present                                   = true;
+      cs_resp.paa.ipv4                                           = htonl(0xAC100000 + teid); // 172.16.0.0/12
+      send_pdu(resp);
+      break;
+    }
+    case GTPC_MSG_TYPE_MODIFY_BEARER_REQUEST: {
+      auto it = sgw_to_mme_teid.find(pdu.header.teid);
+      if (it == sgw_to_mme_teid.end()) {
+        break;
+      }
+      const gtpc_modify_bearer_request& mb_req  = pdu.choice.modify_bearer_request;
+      gtpc_modify_bearer_response&      mb_resp = resp.choice.modify_bearer_response;
+
+      resp.header.teid_present                              = true;
+      resp.header.teid                                      = it->second;
+      resp.header.type                                      = GTPC_MSG_TYPE_MODIFY_BEARER_RESPONSE;
+      mb_resp.cause.cause_value                             = GTPC_CAUSE_VALUE_REQUEST_ACCEPTED;
+      mb_resp.eps_bearer_context_modified.ebi               = mb_req.eps_bearer_context_to_modify.ebi;
+      mb_resp.eps_bearer_context_modified.cause.cause_value = GTPC_CAUSE_VALUE_REQUEST_ACCEPTED;
+      send_pdu(resp);
+      break;
+    }
+    case GTPC_MSG_TYPE_DELETE_SESSION_REQUEST:
+      sgw_to_mme_teid.erase(pdu.header.teid);
+      break;
+    default:
+      // Release Access Bearers only touches the data plane, which is not emulated
+      break;
+  }
+}
+
+/// Starts the HSS and the MME as srsepc does, with the emulated UEs as subscribers
+static bool start_epc(const load_args_t& args, s11_responder* spgw)
+{
+  std::string db_file = args.gen_db.empty() ? "/tmp/mme_load_test_user_db.csv" : args.gen_db;
+  if (not write_user_db(args, db_file)) {
+    return false;
+  }
+
+  srsepc::hss_args_t hss_args = {};
+  hss_args.db_file            = db_file;
+  hss_args.mcc                = args.mcc;
+  hss_args.mnc                = args.mnc;
+  if (srsepc::hss::get_instance()->init(&hss_args) != SRSRAN_SUCCESS) {
+    printf("Error initializing HSS\n");
+    srsepc::hss::cleanup();
+    return false;
+  }
+
+  if (not spgw->start()) {
+    printf("Error binding the S11 interface of the SPGW, is another srsepc running?\n");
+    srsepc::hss::get_instance()->stop();
+    srsepc::hss::cleanup();
+    return false;
+  }
+
+  srsepc::mme_args_t mme_args        = {};
+  mme_args.nof_workers               = args.mme_workers;
+  mme_args.s1ap_args.mme_code        = 0x01;
+  mme_args.s1ap_args.mme_group       = 0x01;
+  mme_args.s1ap_args.tac             = args.tac;
+  mme_args.s1ap_args.mcc             = args.mcc;
+  mme_args.s1ap_args.mnc             = args.mnc;
+  mme_args.s1ap_args.paging_timer    = 2;
+  mme_args.s1ap_args.mme_bind_addr   = args.mme_addr;
+  mme_args.s1ap_args.mme_name        = "srsmme01";
+  mme_args.s1ap_args.dns_addr        = "8.8.8.8";
+  mme_args.s1ap_args.full_net_name   = "Software Radio Systems RAN";
+  mme_args.s1ap_args.short_net_name  = "srsRAN";
+  mme_args.s1ap_args.encryption_algo = CIPHERING_ALGORITHM_ID_EEA0;
+  mme_args.s1ap_args.integrity_algo  = INTEGRITY_ALGORITHM_ID_128_EIA1;
+  srsepc::mme* mme                   = srsepc::mme::get_instance();
+  if (mme->init(&mme_args) != SRSRAN_SUCCESS) {
+    printf("Error initializing MME\n");
+    srsepc::mme::cleanup();
+    spgw->stop();
+    srsepc::hss::get_instance()->stop();
+    srsepc::hss::cleanup();
+    return false;
+  }
+  mme->start();
+  return true;
+}
+
+static void stop_epc(s11_responder* spgw)
+{
+  srsepc::mme::get_instance()->stop();
+  srsepc::mme::cleanup();
+  spgw->stop();
+  srsepc::hss::get_instance()->stop();
+  srsepc::hss::cleanup();
+}
+
+int main(int argc, char* argv[])
+{
+  signal(SIGINT, sig_int_handler);
+  signal(SIGTERM, sig_int_handler);
+
+  load_args_t args = {};
+  if (not parse_args(&args, argc, argv)) {
+    return SRSRAN_ERROR;
+  }
+  if (not args.gen_db.empty() and not args.in_process) {
+    return write_user_db(args, args.gen_db) ? SRSRAN_SUCCESS : SRSRAN_ERROR;
+  }
+
+  srslog::basic_logger& logger =
+      srslog::fetch_basic_logger("LOAD", srslog::fetch_file_sink(args.log_filename), false);
+  logger.set_level(srslog::str_to_basic_level(args.log_level));
+  if (args.in_process) {
+    // The EPC layers log to the same file
+    srslog::set_default_sink(srslog::fetch_file_sink(args.log_filename));
+    for (const char* name : {"NAS", "S1AP", "MME GTPC", "HSS"}) {
+      srslog::fetch_basic_logger(name, false).set_level(srslog::str_to_basic_level(args.log_level));
+    }
+  }
+  srslog::init();
+
+  s11_responder spgw;
+  if (args.in_process) {
+    if (not start_epc(args, &spgw)) {
+      return SRSRAN_ERROR;
+    }
+    printf("In-process MME with %d worker threads\n", args.mme_workers);
+  }
+
+  int                            ret = SRSRAN_SUCCESS;
+  std::unique_ptr<mme_load_test> test(new mme_load_test(args));
+  if (test->init()) {
+    test->run();
+    test->print_stats();
+  } else {
+    printf("Failed to connect to the MME at %s\n", args.mme_addr.c_str());
+    ret = SRSRAN_ERROR;
+  }
+  test.reset();
+
+  if (args.in_process) {
+    stop_epc(&spgw);
+  }
+  srslog::flush();
+  return ret;
+}
@@ -0,0 +1,238 @@
+/**
+ * Copyright 2013-2021 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "srsepc/hdr/mme/mme_ue_registry.h"
+#include "srsran/common/test_common.h"
+#include <algorithm>
+#include <boost/program_options.hpp>
+#include <chrono>
+#include <iostream>
+
+namespace bpo = boost::program_options;
+
+namespace srsepc {
+
+struct registry_test_args_t {
+  uint32_t nof_ues;
+  uint32_t nof_enbs;
+};
+
+static const uint64_t base_imsi   = 1010123456780000ULL;
+static const uint32_t base_m_tmsi = 0x1000;
+
+using test_clock = std::chrono::steady_clock;
+
+static double ns_per_ue(test_clock::time_point t0, uint32_t nof_ues)
+{
+  return std::chrono::duration<double, std::nano>(test_clock::now() - t0).count() / nof_ues;
+}
+
+// Attaches UE i with MME-UE-S1AP-ID i + 1 and M-TMSI base_m_tmsi + i to eNB i % nof_enbs
+static int attach_ues(mme_ue_registry& registry, const registry_test_args_t& args)
+{
+  nas_init_t nas_args = {};
+  nas_if_t   itf      = {};
+
+  registry.reserve(args.nof_ues);
+  for (uint32_t e = 0; e < args.nof_enbs; e++) {
+    registry.add_enb(e);
+  }
+  for (uint32_t i = 0; i < args.nof_ues; i++) {
+    nas* nas_ctx                      = new nas(nas_args, itf);
+    nas_ctx->m_emm_ctx.imsi           = base_imsi + i;
+    nas_ctx->m_ecm_ctx.mme_ue_s1ap_id = i + 1;
+    TESTASSERT(registry.add_imsi(nas_ctx));
+    TESTASSERT(registry.add_mme_ue_s1ap_id(nas_ctx));
+    TESTASSERT(registry.add_ue_to_enb(i % args.nof_enbs, nas_ctx));
+    registry.add_m_tmsi(base_m_tmsi + i, base_imsi + i);
+  }
+  TESTASSERT(registry.nof_ues() == args.nof_ues);
+  return SRSRAN_SUCCESS;
+}
+
+static int detach_ues(mme_ue_registry& registry, const registry_test_args_t& args)
+{
+  for (uint32_t i = 0; i < args.nof_ues; i++) {
+    nas* ue = registry.remove_imsi(base_imsi + i);
+    TESTASSERT(ue != nullptr);
+    if (ue->m_ecm_ctx.mme_ue_s1ap_id != 0) {
+      TESTASSERT(registry.remove_mme_ue_s1ap_id(ue->m_ecm_ctx.mme_ue_s1ap_id));
+    }
+    registry.remove_ue_from_enb(ue);
+    delete ue;
+  }
+  TESTASSERT(registry.nof_ues() == 0);
+  TESTASSERT(registry.find_imsi_mme_ue_s1ap_id(base_imsi) == 0);
+  for (uint32_t e = 0; e < args.nof_enbs; e++) {
+    TESTASSERT(registry.release_enb_ues(e, [](nas*) {}) == 0);
+    registry.remove_enb(e);
+    TESTASSERT(not registry.has_enb(e));
+  }
+  return SRSRAN_SUCCESS;
+}
+
+int test_identities(const registry_test_args_t& args)
+{
+  mme_ue_registry registry;
+  TESTASSERT(attach_ues(registry, args) == SRSRAN_SUCCESS);
+
+  // TEST: every UE is found by IMSI, MME-UE-S1AP-ID and M-TMSI
+  for (uint32_t i = 0; i < args.nof_ues; i++) {
+    nas* nas_ctx = registry.find_imsi(base_imsi + i);
+    TESTASSERT(nas_ctx != nullptr);
+    TESTASSERT(registry.find_mme_ue_s1ap_id(i + 1) == nas_ctx);
+    TESTASSERT(registry.find_imsi_mme_ue_s1ap_id(base_imsi + i) == i + 1);
+    TESTASSERT(registry.find_m_tmsi(base_m_tmsi + i) == base_imsi + i);
+  }
+  TESTASSERT(registry.find_imsi(base_imsi + args.nof_ues) == nullptr);
+  TESTASSERT(registry.find_mme_ue_s1ap_id(args.nof_ues + 1) == nullptr);
+  TESTASSERT(registry.find_imsi_mme_ue_s1ap_id(base_imsi + args.nof_ues) == 0);
+  TESTASSERT(not registry.add_imsi(registry.find_imsi(base_imsi)));
+
+  // TEST: a new M-TMSI invalidates the previous one
+  registry.add_m_tmsi(base_m_tmsi + args.nof_ues, base_imsi);
+  TESTASSERT(registry.find_m_tmsi(base_m_tmsi) == 0);
+  TESTASSERT(registry.find_m_tmsi(base_m_tmsi + args.nof_ues) == base_imsi);
+
+  // TEST: the IMSI keeps its newest MME-UE-S1AP-ID when the previous one is removed, even if the context changed
+  nas* nas_ctx                      = registry.find_imsi(base_imsi);
+  nas_ctx->m_ecm_ctx.mme_ue_s1ap_id = args.nof_ues + 1;
+  TESTASSERT(registry.add_mme_ue_s1ap_id(nas_ctx));
+  nas_ctx->m_emm_ctx.imsi = 0;
+  TESTASSERT(registry.remove_mme_ue_s1ap_id(1));
+  TESTASSERT(registry.find_imsi_mme_ue_s1ap_id(0) == 0);
+  TESTASSERT(registry.find_imsi_mme_ue_s1ap_id(base_imsi) == args.nof_ues + 1);
+  nas_ctx->m_emm_ctx.imsi = base_imsi;
+
+  // TEST: a UE is only linked to one known eNB
+  TESTASSERT(not registry.add_ue_to_enb(0, nas_ctx));
+  TESTASSERT(registry.add_ue_to_enb(1, nas_ctx));
+  TESTASSERT(not registry.add_ue_to_enb(args.nof_enbs, nas_ctx));
+
+  TESTASSERT(detach_ues(registry, args) == SRSRAN_SUCCESS);
+  return SRSRAN_SUCCESS;
+}
+
+int test_enb_reset(const registry_test_args_t& args)
+{
+  mme_ue_registry registry;
+  TESTASSERT(attach_ues(registry, args) == SRSRAN_SUCCESS);
+
+  // TEST: resetting an eNB releases all its UEs at once, and only those
+  uint32_t nof_released = 0;
+  for (uint32_t e = 0; e < args.nof_enbs / 2; e++) {
+    nof_released += registry.release_enb_ues(e, [](nas* ue) { ue->m_ecm_ctx.mme_ue_s1ap_id = 0; });
+  }
+  uint32_t nof_expected = 0;
+  for (uint32_t i = 0; i < args.nof_ues; i++) {
+    nas* ue = registry.find_imsi(base_imsi + i);
+    TESTASSERT(ue != nullptr);
+    if (i % args.nof_enbs < args.nof_enbs / 2) {
+      nof_expected++;
+      TESTASSERT(ue->m_ecm_ctx.mme_ue_s1ap_id == 0);
+      TESTASSERT(ue->m_enb_list_assoc == -1);
+      TESTASSERT(registry.find_mme_ue_s1ap_id(i + 1) == nullptr);
+      TESTASSERT(registry.find_imsi_mme_ue_s1ap_id(base_imsi + i) == 0);
+    } else {
+      TESTASSERT(ue->m_enb_list_assoc == (int32_t)(i % args.nof_enbs));
+      TESTASSERT(registry.find_mme_ue_s1ap_id(i + 1) == ue);
+      TESTASSERT(registry.find_imsi_mme_ue_s1ap_id(base_imsi + i) == i + 1);
+    }
+  }
+  TESTASSERT(nof_released == nof_expected);
+  TESTASSERT(registry.release_enb_ues(0, [](nas*) {}) == 0);
+
+  TESTASSERT(detach_ues(registry, args) == SRSRAN_SUCCESS);
+  return SRSRAN_SUCCESS;
+}
+
+int test_cost_per_ue(const registry_test_args_t& args)
+{
+  mme_ue_registry registry;
+
+  test_clock::time_point t0 = test_clock::now();
+  TESTASSERT(attach_ues(registry, args) == SRSRAN_SUCCESS);
+  double add_ns = ns_per_ue(t0, args.nof_ues);
+
+  t0 = test_clock::now();
+  for (uint32_t i = 0; i < args.nof_ues; i++) {
+    TESTASSERT(registry.find_imsi(base_imsi + i) != nullptr);
+    TESTASSERT(registry.find_mme_ue_s1ap_id(i + 1) != nullptr);
+    TESTASSERT(registry.find_m_tmsi(base_m_tmsi + i) == base_imsi + i);
+  }
+  double find_ns = ns_per_ue(t0, args.nof_ues);
+
+  t0                    = test_clock::now();
+  uint32_t nof_released = registry.release_enb_ues(0, [](nas* ue) { ue->m_ecm_ctx.mme_ue_s1ap_id = 0; });
+  double   release_ns   = ns_per_ue(t0, std::max(nof_released, 1u));
+
+  t0 = test_clock::now();
+  TESTASSERT(detach_ues(registry, args) == SRSRAN_SUCCESS);
+  double remove_ns = ns_per_ue(t0, args.nof_ues);
+
+  printf("nof_ues=%d; nof_enbs=%d; add=%.0f ns/UE; find=%.0f ns/UE; enb release=%.0f ns/UE; remove=%.0f ns/UE;\n",
+         args.nof_ues,
+         args.nof_enbs,
+         add_ns,
+         find_ns,
+         release_ns,
+         remove_ns);
+  return SRSRAN_SUCCESS;
+}
+
+} // namespace srsepc
+
+static void parse_args(srsepc::registry_test_args_t* args, int argc, char* argv[])
+{
+  bpo::options_description options("Options");
+  // clang-format off
+  options.add_options()
+      ("help,h", "Produce help message")
+      ("nof_ues",  bpo::value<uint32_t>(&args->nof_ues)->default_value(10000), "Number of UEs")
+      ("nof_enbs", bpo::value<uint32_t>(&args->nof_enbs)->default_value(16),   "Number of eNBs");
+  // clang-format on
+
+  bpo::variables_map vm;
+  bpo::store(bpo::command_line_parser(argc, argv).options(options).run(), vm);
+  bpo::notify(vm);
+  if (vm.count("help") > 0) {
+    std::cout << "Usage: " << argv[0] << " [OPTIONS]" << std::endl << options << std::endl;
+    exit(0);
+  }
+}
+
+int main(int argc, char* argv[])
+{
+  srsepc::registry_test_args_t args = {};
+  parse_args(&args, argc, argv);
+  if (args.nof_enbs < 2 or args.nof_ues < args.nof_enbs) {
+    printf("At least two eNBs and one UE per eNB are required\n");
+    return SRSRAN_ERROR;
+  }
+
+  srslog::init();
+
+  TESTASSERT(srsepc::test_identities(args) == SRSRAN_SUCCESS);
+  TESTASSERT(srsepc::test_enb_reset(args) == SRSRAN_SUCCESS);
+  TESTASSERT(srsepc::test_cost_per_ue(args) == SRSRAN_SUCCESS);
+  printf("Success\n");
+  return SRSRAN_SUCCESS;
+}
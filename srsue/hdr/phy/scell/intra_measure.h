@@ -21,6 +21,7 @@
 #ifndef SRSUE_INTRA_MEASURE_H
 #define SRSUE_INTRA_MEASURE_H
 
+#include <atomic>
 #include <srsran/common/threads.h>
 #include <srsran/common/tti_sync_cv.h>
 #include <srsran/srsran.h>
@@ -132,6 +133,22 @@ public:
     state.wait_change(internal_state::measure);
   }
 
+  /**
+   * Get the duration of the last measurement cycle, from reading the buffer until the measurements are reported
+   * @return Duration in microseconds
+   */
+  uint64_t get_last_meas_cycle_us() const { return meas_cycle_last_us; }
+
+  /**
+   * Get the average duration of all the measurement cycles
+   * @return Duration in microseconds, 0 if no measurement has been performed yet
+   */
+  uint64_t get_avg_meas_cycle_us() const
+  {
+    uint32_t count = meas_cycle_count;
+    return count == 0 ? 0 : meas_cycle_total_us / count;
+  }
+
 private:
   class internal_state ///< Internal state class, provides thread safe state management
   {
@@ -216,9 +233,15 @@ private:
 
   cf_t* search_buffer = nullptr;
 
-  srsran_ringbuffer_t ring_buffer = {};
+  srsran_ringbuffer_spsc_t ring_buffer = {};
 
   srsran_refsignal_dl_sync_t refsignal_dl_sync = {};
+
+  ///< Measurement cycle timing statistics, written by the inner thread only
+  std::atomic<uint32_t> meas_cycle_count    = {0};
+  std::atomic<uint64_t> meas_cycle_last_us  = {0};
+  std::atomic<uint64_t> meas_cycle_total_us = {0};
+  uint64_t              meas_cycle_max_us   = 0;
 };
 
 } // namespace scell
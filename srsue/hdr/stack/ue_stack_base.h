@@ -42,6 +42,7 @@ typedef struct {
   pcap_args_t mac_pcap;
   pcap_args_t mac_nr_pcap;
   pcap_args_t nas_pcap;
+  uint32_t    max_file_size; // Capture files continue in <filename>.1, .2, ... beyond this size (MB)
 } pkt_trace_args_t;
 
 typedef struct {
@@ -41,7 +41,7 @@ intra_measure::intra_measure(srslog::basic_logger& logger) : scell(logger), logg
 
 intra_measure::~intra_measure()
 {
-  srsran_ringbuffer_free(&ring_buffer);
+  srsran_ringbuffer_spsc_free(&ring_buffer);
   scell.deinit();
   free(search_buffer);
 }
@@ -67,7 +67,7 @@ void intra_measure::init(uint32_t cc_idx_, phy_common* common, meas_itf* new_cel
 
   // Initialise buffer for the maximum number of PRB
   uint32_t max_required_bytes = (uint32_t)sizeof(cf_t) * intra_freq_meas_len_ms * SRSRAN_SF_LEN_PRB(SRSRAN_MAX_PRB);
-  if (srsran_ringbuffer_init(&ring_buffer, max_required_bytes)) {
+  if (srsran_ringbuffer_spsc_init(&ring_buffer, max_required_bytes)) {
     return;
   }
 
@@ -84,7 +84,7 @@ void intra_measure::stop()
   // Wait for the asynchronous thread to finish
   wait_thread_finish();
 
-  srsran_ringbuffer_stop(&ring_buffer);
+  srsran_ringbuffer_spsc_stop(&ring_buffer);
   srsran_refsignal_dl_sync_free(&refsignal_dl_sync);
 }
 
@@ -134,22 +134,22 @@ void intra_measure::write(uint32_t tti, cf_t* data, uint32_t nsamples)
       if (elapsed_tti >= intra_freq_meas_period_ms) {
         state.set_state(internal_state::receive);
         last_measure_tti = tti;
-        srsran_ringbuffer_reset(&ring_buffer);
+        srsran_ringbuffer_spsc_reset(&ring_buffer);
       }
       break;
     case internal_state::receive:
       // As nbytes might not match the sub-frame size, make sure that buffer does not overflow
-      nbytes = SRSRAN_MIN(srsran_ringbuffer_space(&ring_buffer), nbytes);
+      nbytes = SRSRAN_MIN(srsran_ringbuffer_spsc_space(&ring_buffer), nbytes);
 
       // Try writing in the buffer
-      if (srsran_ringbuffer_write(&ring_buffer, data, nbytes) < nbytes) {
+      if (srsran_ringbuffer_spsc_write(&ring_buffer, data, nbytes, 0) < nbytes) {
         Warning("INTRA: Error writing to ringbuffer (EARFCN=%d)", current_earfcn);
 
         // Transition to wait, so it can keep receiving without stopping the component operation
         state.set_state(internal_state::wait);
       } else {
         // As soon as there are enough samples in the buffer, transition to measure
-        if (srsran_ringbuffer_status(&ring_buffer) >= required_nbytes) {
+        if (srsran_ringbuffer_spsc_status(&ring_buffer) >= required_nbytes) {
           state.set_state(internal_state::measure);
         }
       }
@@ -160,6 +160,7 @@ void intra_measure::write(uint32_t tti, cf_t* data, uint32_t nsamples)
 void intra_measure::measure_proc()
 {
   std::set<uint32_t> cells_to_measure = {};
+  auto               t_start          = std::chrono::steady_clock::now();
 
   // Load cell list to measure
   active_pci_mutex.lock();
@@ -167,7 +168,8 @@ void intra_measure::measure_proc()
   active_pci_mutex.unlock();
 
   // Read data from buffer and find cells in it
-  srsran_ringbuffer_read(&ring_buffer, search_buffer, (int)intra_freq_meas_len_ms * current_sflen * sizeof(cf_t));
+  srsran_ringbuffer_spsc_read(
+      &ring_buffer, search_buffer, (int)(intra_freq_meas_len_ms * current_sflen * sizeof(cf_t)), -1);
 
   // Go to receive before finishing, so new samples can be enqueued before the thread finishes
   if (state.get_state() == internal_state::measure) {
@@ -188,7 +190,15 @@ void intra_measure::measure_proc()
 
   new_cell_itf->cell_meas_reset(cc_idx);
 
+  // Transform the search buffer only once, the correlation windows are shared by all the measured PCI
+  uint32_t nsamples = intra_freq_meas_len_ms * current_sflen;
+  srsran_refsignal_dl_sync_set_cell(&refsignal_dl_sync, serving_cell);
+  if (srsran_refsignal_dl_sync_load_buffer(&refsignal_dl_sync, search_buffer, nsamples) < SRSRAN_SUCCESS) {
+    Warning("INTRA: Error loading search buffer, cells will be correlated individually (EARFCN=%u)", current_earfcn);
+  }
+
   // Use Cell Reference signal to measure cells in the time domain for all known active PCI
+  uint32_t nof_measured = 0;
   for (const uint32_t& id : cells_to_measure) {
     // Do not measure serving cell here since it's measured by workers
     if (id == serving_cell.id) {
@@ -198,7 +208,8 @@ void intra_measure::measure_proc()
     cell.id            = id;
 
     srsran_refsignal_dl_sync_set_cell(&refsignal_dl_sync, cell);
-    srsran_refsignal_dl_sync_run(&refsignal_dl_sync, search_buffer, intra_freq_meas_len_ms * current_sflen);
+    srsran_refsignal_dl_sync_run(&refsignal_dl_sync, search_buffer, nsamples);
+    nof_measured++;
 
     if (refsignal_dl_sync.found) {
       phy_meas_t m = {};
@@ -220,10 +231,27 @@ void intra_measure::measure_proc()
     }
   }
 
+  // The search buffer content is overwritten in the next cycle
+  srsran_refsignal_dl_sync_unload_buffer(&refsignal_dl_sync);
+
   // Send measurements to RRC if any cell found
   if (not neighbour_cells.empty()) {
     new_cell_itf->new_cell_meas(cc_idx, neighbour_cells);
   }
+
+  // Report measurement cycle timing
+  uint64_t elapsed_us =
+      std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - t_start).count();
+  meas_cycle_count++;
+  meas_cycle_last_us = elapsed_us;
+  meas_cycle_max_us  = SRSRAN_MAX(meas_cycle_max_us, elapsed_us);
+  meas_cycle_total_us += elapsed_us;
+  Info("INTRA: Measured %u cells in %" PRIu64 " us (avg=%" PRIu64 " us, max=%" PRIu64 " us, EARFCN=%u)",
+       nof_measured,
+       elapsed_us,
+       meas_cycle_total_us / meas_cycle_count,
+       meas_cycle_max_us,
+       current_earfcn);
 }
 
 void intra_measure::run_thread()
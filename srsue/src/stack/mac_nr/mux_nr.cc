@@ -35,11 +35,6 @@ int32_t mux_nr::init(rlc_interface_mac* rlc_)
     return SRSRAN_ERROR;
   }
 
-  rlc_buff = srsran::make_byte_buffer();
-  if (rlc_buff == nullptr) {
-    return SRSRAN_ERROR;
-  }
-
   return SRSRAN_SUCCESS;
 }
 
@@ -90,37 +85,23 @@ srsran::unique_byte_buffer_t mux_nr::get_pdu(uint32_t max_pdu_len)
       // TODO: Add proper priority handling
       logger.debug("Adding SDUs for LCID=%d (max %d B)", lc.lcid, remaining_len);
       while (remaining_len >= MIN_RLC_PDU_LEN) {
-        // read RLC PDU
-        rlc_buff->clear();
-        uint8_t* rd = rlc_buff->msg;
-
         // Determine space for RLC
         remaining_len -= remaining_len >= srsran::mac_sch_subpdu_nr::MAC_SUBHEADER_LEN_THRESHOLD ? 3 : 2;
 
-        // Read PDU from RLC
-        int pdu_len = rlc->read_pdu(lc.lcid, rd, remaining_len);
-
-        if (pdu_len > remaining_len) {
-          logger.error("Can't add SDU of %d B. Available space %d B", pdu_len, remaining_len);
+        // Read PDU from RLC straight into the MAC PDU
+        int pdu_len = tx_pdu.add_sdu(lc.lcid, remaining_len, rlc);
+        if (pdu_len < 0) {
+          logger.error("Error packing MAC PDU");
+          break;
+        }
+        // Stop if RLC has nothing to tx
+        if (pdu_len == 0) {
           break;
-        } else {
-          // Add SDU if RLC has something to tx
-          if (pdu_len > 0) {
-            rlc_buff->N_bytes = pdu_len;
-            logger.debug(rlc_buff->msg, rlc_buff->N_bytes, "Read %d B from RLC", rlc_buff->N_bytes);
-
-            // add to MAC PDU and pack
-            if (tx_pdu.add_sdu(lc.lcid, rlc_buff->msg, rlc_buff->N_bytes) != SRSRAN_SUCCESS) {
-              logger.error("Error packing MAC PDU");
-              break;
-            }
-          } else {
-            break;
-          }
-
-          remaining_len -= pdu_len;
-          logger.debug("%d B remaining PDU", remaining_len);
         }
+        logger.debug("Read %d B from RLC", pdu_len);
+
+        remaining_len -= pdu_len;
+        logger.debug("%d B remaining PDU", remaining_len);
       }
     }
 
@@ -158,12 +158,14 @@ int ue_stack_lte::init(const stack_args_t& args_)
     }
   }
 
+  uint64_t rotate_bytes = (uint64_t)args.pkt_trace.max_file_size << 20U;
+
   // If mac and mac_nr pcap option is enabled and if the filenames are the same,
   // mac and mac_nr should write in the same PCAP file.
   if (args.pkt_trace.mac_pcap.enable && args.pkt_trace.mac_nr_pcap.enable &&
       args.pkt_trace.mac_pcap.filename == args.pkt_trace.mac_nr_pcap.filename) {
     stack_logger.info("Using same MAC PCAP file %s for LTE and NR", args.pkt_trace.mac_pcap.filename.c_str());
-    if (mac_pcap.open(args.pkt_trace.mac_pcap.filename.c_str()) == SRSRAN_SUCCESS) {
+    if (mac_pcap.open(args.pkt_trace.mac_pcap.filename.c_str(), 0, rotate_bytes) == SRSRAN_SUCCESS) {
       mac.start_pcap(&mac_pcap);
       mac_nr.start_pcap(&mac_pcap);
       stack_logger.info("Open mac pcap file %s", args.pkt_trace.mac_pcap.filename.c_str());
@@ -172,7 +174,7 @@ int ue_stack_lte::init(const stack_args_t& args_)
     }
   } else {
     if (args.pkt_trace.mac_pcap.enable) {
-      if (mac_pcap.open(args.pkt_trace.mac_pcap.filename.c_str()) == SRSRAN_SUCCESS) {
+      if (mac_pcap.open(args.pkt_trace.mac_pcap.filename.c_str(), 0, rotate_bytes) == SRSRAN_SUCCESS) {
         mac.start_pcap(&mac_pcap);
         stack_logger.info("Open mac pcap file %s", args.pkt_trace.mac_pcap.filename.c_str());
       } else {
@@ -181,7 +183,7 @@ int ue_stack_lte::init(const stack_args_t& args_)
     }
 
     if (args.pkt_trace.mac_nr_pcap.enable) {
-      if (mac_nr_pcap.open(args.pkt_trace.mac_nr_pcap.filename.c_str()) == SRSRAN_SUCCESS) {
+      if (mac_nr_pcap.open(args.pkt_trace.mac_nr_pcap.filename.c_str(), 0, rotate_bytes) == SRSRAN_SUCCESS) {
         mac_nr.start_pcap(&mac_nr_pcap);
         stack_logger.info("Open mac nr pcap file %s", args.pkt_trace.mac_nr_pcap.filename.c_str());
       } else {
@@ -191,7 +193,7 @@ int ue_stack_lte::init(const stack_args_t& args_)
   }
 
   if (args.pkt_trace.nas_pcap.enable) {
-    if (nas_pcap.open(args.pkt_trace.nas_pcap.filename.c_str()) == SRSRAN_SUCCESS) {
+    if (nas_pcap.open(args.pkt_trace.nas_pcap.filename.c_str(), 0, rotate_bytes) == SRSRAN_SUCCESS) {
       nas.start_pcap(&nas_pcap);
       stack_logger.info("Open nas pcap file %s", args.pkt_trace.nas_pcap.filename.c_str());
     } else {
@@ -659,6 +659,10 @@ int main(int argc, char** argv)
 
   ret = rrc.print_stats() ? SRSRAN_SUCCESS : SRSRAN_ERROR;
 
+  printf("Intra-frequency measurement cycle: last=%" PRIu64 " us; avg=%" PRIu64 " us;\n",
+         intra_measure.get_last_meas_cycle_us(),
+         intra_measure.get_avg_meas_cycle_us());
+
   if (radio) {
     radio->stop();
   }